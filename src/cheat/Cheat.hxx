@@ -40,6 +40,14 @@ class Cheat
 
     virtual void evaluate() = 0;
 
+    /**
+      The RAM location and value this cheat pokes once per frame, if it
+      is such a cheat.
+
+      @return  True if the cheat patches RAM, with address/value filled in
+    */
+    virtual bool ramPatch(uInt16& address, uInt8& value) const { return false; }
+
   protected:
     static uInt16 unhex(const string& hex)
     {
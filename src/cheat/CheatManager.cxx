@@ -17,6 +17,7 @@
 
 #include "OSystem.hxx"
 #include "Console.hxx"
+#include "System.hxx"
 #include "Cheat.hxx"
 #include "Settings.hxx"
 #include "CheetahCheat.hxx"
@@ -114,6 +115,37 @@ void CheatManager::addPerFrame(const string& name, const string& code, bool enab
     if(found)
       Vec::removeAt(myPerFrameList, i);
   }
+  compilePerFrame();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CheatManager::compilePerFrame()
+{
+  // Only RAM cheats are added to the per-frame list; if several of them
+  // patch the same address, the last one wins (as when poking in order)
+  std::map<uInt16, uInt8> patches;
+  for(const auto& cheat: myPerFrameList)
+  {
+    uInt16 address = 0;
+    uInt8 value = 0;
+    if(cheat->ramPatch(address, value))
+      patches[address] = value;
+  }
+
+  myPatchList.clear();
+  for(const auto& [address, value]: patches)
+    myPatchList.push_back({address, value});
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CheatManager::applyPerFrame()
+{
+  if(myPatchList.empty())
+    return;
+
+  System& system = myOSystem.console().system();
+  for(const auto& patch: myPatchList)
+    system.cpuPoke(patch.address, patch.value, Device::NONE);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -264,6 +296,7 @@ void CheatManager::saveCheatDatabase()
 void CheatManager::loadCheats(const string& md5sum)
 {
   myPerFrameList.clear();
+  myPatchList.clear();
   myCheatList.clear();
   myCurrentCheat = "";
 
@@ -316,6 +349,7 @@ void CheatManager::saveCheats(const string& md5sum)
   // Update the dirty flag
   myListIsDirty = myListIsDirty || changed;
   myPerFrameList.clear();
+  myPatchList.clear();
   myCheatList.clear();
 }
 
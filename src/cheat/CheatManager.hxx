@@ -94,10 +94,17 @@ class CheatManager
     const CheatList& list() { return myCheatList; }
 
     /**
-      Returns the per-frame cheatlist (needed to evaluate cheats each frame)
+      Returns the per-frame cheatlist
     */
     const CheatList& perFrame() { return myPerFrameList; }
 
+    /**
+      Apply all enabled per-frame cheats.  These are compiled into a list
+      of RAM patches whenever a cheat is enabled or disabled, so this only
+      has to write the values.
+    */
+    void applyPerFrame();
+
     /**
       Load all cheats (for all ROMs) from disk to internal database.
     */
@@ -141,12 +148,25 @@ class CheatManager
     */
     void parse(const string& cheats);
 
+    /**
+      Rebuild the RAM patch list from the per-frame cheatlist.
+    */
+    void compilePerFrame();
+
   private:
     OSystem& myOSystem;
 
     CheatList myCheatList;
     CheatList myPerFrameList;
 
+    // The per-frame cheats as (address, value) pairs, sorted by address
+    struct RamPatch
+    {
+      uInt16 address{0};
+      uInt8  value{0};
+    };
+    vector<RamPatch> myPatchList;
+
     std::map<string,string> myCheatMap;
     string myCheatFile;
 
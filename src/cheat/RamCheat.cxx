@@ -25,8 +25,8 @@
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 RamCheat::RamCheat(OSystem& os, const string& name, const string& code)
   : Cheat(os, name, code),
-    address{uInt16(unhex(myCode.substr(0, 2)))},
-    value{uInt8(unhex(myCode.substr(2, 2)))}
+    myAddress{uInt16(unhex(myCode.substr(0, 2)))},
+    myValue{uInt8(unhex(myCode.substr(2, 2)))}
 {
 }
 
@@ -55,5 +55,5 @@ bool RamCheat::disable()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void RamCheat::evaluate()
 {
-  myOSystem.console().system().poke(address, value);
+  myOSystem.console().system().poke(myAddress, myValue);
 }
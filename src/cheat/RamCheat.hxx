@@ -30,9 +30,15 @@ class RamCheat : public Cheat
     bool disable() override;
     void evaluate() override;
 
+    bool ramPatch(uInt16& address, uInt8& value) const override {
+      address = myAddress;
+      value = myValue;
+      return true;
+    }
+
   private:
-    uInt16 address{0};
-    uInt8  value{0};
+    uInt16 myAddress{0};
+    uInt8  myValue{0};
 
   private:
     // Following constructors and assignment operators not supported
@@ -0,0 +1,238 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "OSystem.hxx"
+#include "Console.hxx"
+#include "EventHandler.hxx"
+#include "FrameBuffer.hxx"
+#include "Settings.hxx"
+#include "AudioSettings.hxx"
+#include "EmulationTiming.hxx"
+#include "Logger.hxx"
+#include "AudioCalibration.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+AudioCalibration::AudioCalibration(OSystem& osystem)
+  : myOSystem{osystem}
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+AudioCalibration::~AudioCalibration()
+{
+  if(active())
+    myOSystem.timer().clear(myTimer);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioCalibration::toggle()
+{
+  if(active())
+  {
+    cancel();
+    myOSystem.frameBuffer().showTextMessage("Audio calibration cancelled");
+    return;
+  }
+
+  AudioSettings& audio = myOSystem.audioSettings();
+  if(!myOSystem.hasConsole() || !audio.enabled())
+  {
+    myOSystem.frameBuffer().showTextMessage("Audio calibration requires sound");
+    return;
+  }
+
+  // Remember the settings, and switch to custom settings with the same
+  // sample rate and quality
+  Settings& settings = myOSystem.settings();
+  myOldPreset = settings.getInt(AudioSettings::SETTING_PRESET);
+  myOldSampleRate = settings.getInt(AudioSettings::SETTING_SAMPLE_RATE);
+  myOldFragmentSize = settings.getInt(AudioSettings::SETTING_FRAGMENT_SIZE);
+  myOldBufferSize = settings.getInt(AudioSettings::SETTING_BUFFER_SIZE);
+  myOldHeadroom = settings.getInt(AudioSettings::SETTING_HEADROOM);
+  myOldResamplingQuality = settings.getInt(AudioSettings::SETTING_RESAMPLING_QUALITY);
+
+  const uInt32 sampleRate = audio.sampleRate();
+  const AudioSettings::ResamplingQuality quality = audio.resamplingQuality();
+
+  audio.setPreset(AudioSettings::Preset::custom);
+  audio.setSampleRate(sampleRate);
+  audio.setResamplingQuality(quality);
+
+  const EmulationTiming& timing = myOSystem.console().emulationTiming();
+  myFrameMs = 1000. * timing.cyclesPerFrame() / timing.cyclesPerSecond();
+
+  myCandidates.clear();
+  for(uInt32 fragmentSize: FRAGMENT_SIZES)
+    for(uInt32 headroom = 0; headroom <= AudioSettings::MAX_HEADROOM; ++headroom)
+      myCandidates.push_back({fragmentSize, headroom,
+        1000. * fragmentSize / sampleRate + headroomMs(headroom)});
+
+  std::stable_sort(myCandidates.begin(), myCandidates.end(),
+    [](const Candidate& a, const Candidate& b) { return a.latencyMs < b.latencyMs; });
+
+  myCandidate = 0;
+  myTimer = myOSystem.timer().setInterval([this]() { update(); }, UPDATE_INTERVAL);
+  startCandidate();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioCalibration::cancel(bool reinitialize)
+{
+  if(!active())
+    return;
+
+  myOSystem.timer().clear(myTimer);
+  myTimer = 0;
+  restoreSettings(reinitialize);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioCalibration::update()
+{
+  // The user must keep the ROM running
+  if(!myOSystem.hasConsole() ||
+     myOSystem.eventHandler().state() != EventHandlerState::EMULATION)
+  {
+    cancel();
+    Logger::info("Audio calibration cancelled");
+    return;
+  }
+
+  const uInt64 now = TimerManager::getTicks() / 1000;
+
+  if(myPhase == Phase::settle)
+  {
+    if(now < myPhaseEnd)
+      return;
+
+    // Ignore what happened while the queue was filled
+    myOSystem.sound().resetCallbackStats();
+    myPhase = Phase::measure;
+    myPhaseEnd = now + MEASURE_TIME;
+    return;
+  }
+
+  const Sound::CallbackStats stats = myOSystem.sound().callbackStats();
+  const Candidate& candidate = myCandidates[myCandidate];
+
+  if(failed(stats))
+  {
+    ostringstream buf;
+    buf << "Audio calibration: fragment size " << candidate.fragmentSize
+        << ", headroom " << candidate.headroom << " failed ("
+        << stats.underruns << " underruns, " << stats.overflows << " overflows, "
+        << std::fixed << std::setprecision(2) << stats.maxMs << " ms callback, "
+        << stats.maxIntervalMs << " ms interval)";
+    Logger::debug(buf.str());
+
+    if(++myCandidate < myCandidates.size())
+      startCandidate();
+    else
+      finish(false);
+  }
+  else if(now >= myPhaseEnd)
+  {
+    // No callback at all means the sound can't be measured
+    finish(stats.callbacks > 0);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioCalibration::startCandidate()
+{
+  const Candidate& candidate = myCandidates[myCandidate];
+  AudioSettings& audio = myOSystem.audioSettings();
+
+  audio.setFragmentSize(candidate.fragmentSize);
+  audio.setHeadroom(candidate.headroom);
+  // A little room beyond the headroom, so emulation speed jitter doesn't
+  // immediately overflow the queue
+  audio.setBufferSize(std::min<uInt32>(candidate.headroom + 1, AudioSettings::MAX_BUFFER_SIZE));
+
+  myOSystem.console().initializeAudio();
+
+  myPhase = Phase::settle;
+  myPhaseEnd = TimerManager::getTicks() / 1000 + SETTLE_TIME;
+
+  ostringstream buf;
+  buf << "Calibrating audio (" << (myCandidate + 1) << "/" << myCandidates.size()
+      << ", " << std::fixed << std::setprecision(0) << candidate.latencyMs << " ms)";
+  myOSystem.frameBuffer().showTextMessage(buf.str());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool AudioCalibration::failed(const Sound::CallbackStats& stats) const
+{
+  if(stats.underruns > 0 || stats.overflows > 0)
+    return true;
+
+  // A callback taking most of the fragment's time leaves no reserve
+  if(stats.maxMs > stats.periodMs / 2)
+    return true;
+
+  // A late callback must not outlast the audio queued in front of it
+  const double buffered = stats.periodMs + headroomMs(myCandidates[myCandidate].headroom);
+  return stats.maxIntervalMs > stats.periodMs + buffered;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioCalibration::finish(bool success)
+{
+  myOSystem.timer().clear(myTimer);
+  myTimer = 0;
+
+  if(!success)
+  {
+    restoreSettings(true);
+    myOSystem.frameBuffer().showTextMessage(
+      "Audio calibration failed, settings unchanged");
+    return;
+  }
+
+  // The candidate's settings are already applied and saved
+  const Candidate& candidate = myCandidates[myCandidate];
+
+  ostringstream buf;
+  buf << "Audio calibrated: fragment size " << candidate.fragmentSize
+      << ", headroom " << candidate.headroom << " (" << std::fixed
+      << std::setprecision(0) << candidate.latencyMs << " ms)";
+  Logger::info(buf.str());
+  myOSystem.frameBuffer().showTextMessage(buf.str());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioCalibration::restoreSettings(bool reinitialize)
+{
+  AudioSettings& audio = myOSystem.audioSettings();
+
+  audio.setSampleRate(myOldSampleRate);
+  audio.setFragmentSize(myOldFragmentSize);
+  audio.setBufferSize(myOldBufferSize);
+  audio.setHeadroom(myOldHeadroom);
+  audio.setResamplingQuality(AudioSettings::ResamplingQuality(myOldResamplingQuality));
+  audio.setPreset(AudioSettings::Preset(myOldPreset));
+
+  if(reinitialize && myOSystem.hasConsole())
+    myOSystem.console().initializeAudio();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double AudioCalibration::headroomMs(uInt32 headroom) const
+{
+  // The headroom is given in half frames
+  return headroom * myFrameMs / 2;
+}
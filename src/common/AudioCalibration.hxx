@@ -0,0 +1,130 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef AUDIO_CALIBRATION_HXX
+#define AUDIO_CALIBRATION_HXX
+
+class OSystem;
+
+#include "bspf.hxx"
+#include "Sound.hxx"
+#include "TimerManager.hxx"
+
+/**
+  Finds the lowest latency audio buffering which plays without glitches on
+  the current device, while the user keeps playing the running ROM.
+
+  Candidate fragment sizes and headrooms are tried in the order of their
+  latency (the sample rate and resampling quality are kept).  Each one is
+  applied, given some time to settle, and then observed for a few
+  seconds; it fails as soon as the sound reports an underrun or the audio
+  queue an overflow, if a callback takes more than half of a fragment's
+  play time, or if the callbacks arrive so late that the queued audio
+  can't bridge the gap.  The first candidate which passes is saved as
+  'custom' preset.  If none passes, or the calibration is interrupted
+  (by leaving emulation mode), the previous settings are restored.
+
+  The calibration is driven by the main thread timer.
+
+  @author  Stella Team
+*/
+class AudioCalibration
+{
+  public:
+    explicit AudioCalibration(OSystem& osystem);
+    ~AudioCalibration();
+
+    /**
+      Start calibrating with the running console, or cancel a running
+      calibration.
+    */
+    void toggle();
+
+    /**
+      Cancel a running calibration and restore the previous settings.
+
+      @param reinitialize  Apply the restored settings to the console
+    */
+    void cancel(bool reinitialize = true);
+
+    bool active() const { return myTimer != 0; }
+
+  private:
+    struct Candidate {
+      uInt32 fragmentSize{0};
+      uInt32 headroom{0};     // in half frames
+      double latencyMs{0.};
+    };
+
+    enum class Phase { settle, measure };
+
+    // Fragment sizes which are tried
+    static constexpr std::array<uInt32, 4> FRAGMENT_SIZES{128, 256, 512, 1024};
+    // Time for each candidate to fill the queue, and to prove itself
+    static constexpr uInt64 SETTLE_TIME = 1000;
+    static constexpr uInt64 MEASURE_TIME = 5000;
+    // Milliseconds between two checks
+    static constexpr uInt32 UPDATE_INTERVAL = 100;
+
+  private:
+    void update();
+
+    void startCandidate();
+
+    /**
+      Whether the candidate under test failed, judged by the statistics.
+    */
+    bool failed(const Sound::CallbackStats& stats) const;
+
+    void finish(bool success);
+
+    void restoreSettings(bool reinitialize);
+
+    double headroomMs(uInt32 headroom) const;
+
+  private:
+    OSystem& myOSystem;
+
+    vector<Candidate> myCandidates;
+    uInt32 myCandidate{0};
+
+    Phase myPhase{Phase::settle};
+    uInt64 myPhaseEnd{0};
+
+    TimerManager::TimerId myTimer{0};
+
+    // Duration of a frame of the running console
+    double myFrameMs{0.};
+
+    // The settings before calibration
+    int myOldPreset{0};
+    int myOldSampleRate{0};
+    int myOldFragmentSize{0};
+    int myOldBufferSize{0};
+    int myOldHeadroom{0};
+    int myOldResamplingQuality{0};
+
+  private:
+    // Following constructors and assignment operators not supported
+    AudioCalibration() = delete;
+    AudioCalibration(const AudioCalibration&) = delete;
+    AudioCalibration(AudioCalibration&&) = delete;
+    AudioCalibration& operator=(const AudioCalibration&) = delete;
+    AudioCalibration& operator=(AudioCalibration&&) = delete;
+};
+
+#endif // AUDIO_CALIBRATION_HXX
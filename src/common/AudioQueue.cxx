@@ -16,14 +16,13 @@
 //============================================================================
 
 #include "AudioQueue.hxx"
-
-using std::mutex;
-using std::lock_guard;
+#include "EventCounters.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 AudioQueue::AudioQueue(uInt32 fragmentSize, uInt32 capacity, bool isStereo)
   : myFragmentSize{fragmentSize},
     myIsStereo{isStereo},
+    myCapacity{capacity},
     myFragmentQueue{capacity},
     myAllFragments{capacity + 2}
 {
@@ -44,15 +43,15 @@ AudioQueue::AudioQueue(uInt32 fragmentSize, uInt32 capacity, bool isStereo)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 AudioQueue::capacity() const
 {
-  return uInt32(myFragmentQueue.size());
+  return myCapacity;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 AudioQueue::size() const
 {
-  lock_guard<mutex> guard(myMutex);
+  const uInt32 head = myHead.load(std::memory_order_acquire);
 
-  return mySize;
+  return distance(head, myTail.load(std::memory_order_acquire));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -68,10 +67,14 @@ uInt32 AudioQueue::fragmentSize() const
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Int16* AudioQueue::enqueue(Int16* fragment)
+size_t AudioQueue::memoryUsage() const
 {
-  lock_guard<mutex> guard(myMutex);
+  return size_t(myFragmentSize) * (myIsStereo ? 2 : 1) * (myCapacity + 2) * sizeof(Int16);
+}
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int16* AudioQueue::enqueue(Int16* fragment)
+{
   Int16* newFragment;
 
   if (!fragment) {
@@ -83,27 +86,37 @@ Int16* AudioQueue::enqueue(Int16* fragment)
     return newFragment;
   }
 
-  const uInt8 capacity = uInt8(myFragmentQueue.size());
-  const uInt8 fragmentIndex = (myNextFragment + mySize) % capacity;
-
-  newFragment = myFragmentQueue.at(fragmentIndex);
-  myFragmentQueue.at(fragmentIndex) = fragment;
+  const uInt32 tail = myTail.load(std::memory_order_relaxed);
 
-  if (mySize < capacity) ++mySize;
-  else {
-    myNextFragment = (myNextFragment + 1) % capacity;
+  // Acquire: the consumer is done with any slot it has released
+  if (distance(myHead.load(std::memory_order_acquire), tail) == myCapacity) {
+    // Full: drop this fragment and let the caller refill it
+    myOverflows.store(myOverflows.load(std::memory_order_relaxed) + 1,
+                      std::memory_order_relaxed);
+    EventCounters::count(EventCounters::Event::audioOverflow);
     if (!myIgnoreOverflows) myOverflowLogger.log();
+
+    return fragment;
   }
 
+  Int16*& slot = myFragmentQueue[queueIndex(tail)];
+
+  newFragment = slot;
+  slot = fragment;
+
+  // Release: publish the fragment to the consumer
+  myTail.store(nextPosition(tail), std::memory_order_release);
+
   return newFragment;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Int16* AudioQueue::dequeue(Int16* fragment)
 {
-  lock_guard<mutex> guard(myMutex);
+  const uInt32 head = myHead.load(std::memory_order_relaxed);
 
-  if (mySize == 0) return nullptr;
+  // Acquire: the fragment contents written by the producer are visible
+  if (head == myTail.load(std::memory_order_acquire)) return nullptr;
 
   if (!fragment) {
     if (!myFirstFragmentForDequeue) throw runtime_error("dequeue called empty");
@@ -112,11 +125,13 @@ Int16* AudioQueue::dequeue(Int16* fragment)
     myFirstFragmentForDequeue = nullptr;
   }
 
-  Int16* nextFragment = myFragmentQueue.at(myNextFragment);
-  myFragmentQueue.at(myNextFragment) = fragment;
+  Int16*& slot = myFragmentQueue[queueIndex(head)];
+  Int16* nextFragment = slot;
+
+  slot = fragment;
 
-  --mySize;
-  myNextFragment = (myNextFragment + 1) % myFragmentQueue.size();
+  // Release: hand the slot (now holding the returned fragment) back
+  myHead.store(nextPosition(head), std::memory_order_release);
 
   return nextFragment;
 }
@@ -124,8 +139,6 @@ Int16* AudioQueue::dequeue(Int16* fragment)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AudioQueue::closeSink(Int16* fragment)
 {
-  lock_guard<mutex> guard(myMutex);
-
   if (myFirstFragmentForDequeue && fragment)
     throw runtime_error("attempt to return unknown buffer on closeSink");
 
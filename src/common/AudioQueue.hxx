@@ -18,7 +18,7 @@
 #ifndef AUDIO_QUEUE_HXX
 #define AUDIO_QUEUE_HXX
 
-#include <mutex>
+#include <atomic>
 
 #include "bspf.hxx"
 #include "StaggeredLogger.hxx"
@@ -31,8 +31,12 @@
   queue and returns the used fragment in this process.
 
   The queue needs to be threadsafe as the (SDL) audio driver runs on a
-  separate thread. Samples are stored as signed 16 bit integers
-  (platform endian).
+  separate (realtime) thread. It is a wait-free single producer / single
+  consumer ring: the emulation core is the only caller of enqueue(), the
+  sound driver the only caller of dequeue() and closeSink(), and neither
+  side ever blocks the other. If the ring is full, enqueue() drops the
+  fragment passed in and hands it back for refilling. Samples are stored
+  as signed 16 bit integers (platform endian).
 */
 class AudioQueue
 {
@@ -67,6 +71,11 @@ class AudioQueue
      */
     uInt32 fragmentSize() const;
 
+    /**
+      The memory (in bytes) held by the fragments.
+     */
+    size_t memoryUsage() const;
+
     /**
       Enqueue a new fragment and get a new fragmen to fill.
 
@@ -96,6 +105,28 @@ class AudioQueue
      */
     void ignoreOverflows(bool shouldIgnoreOverflows);
 
+    /**
+      The number of fragments dropped because the queue was full.
+     */
+    uInt32 overflows() const { return myOverflows.load(std::memory_order_relaxed); }
+
+  private:
+
+    // Advance a ring position (see below)
+    uInt32 nextPosition(uInt32 position) const {
+      return position + 1 < 2 * myCapacity ? position + 1 : 0;
+    }
+
+    // Map a ring position to an index into the fragment queue
+    uInt32 queueIndex(uInt32 position) const {
+      return position < myCapacity ? position : position - myCapacity;
+    }
+
+    // The number of queued fragments between the two ring positions
+    uInt32 distance(uInt32 head, uInt32 tail) const {
+      return tail >= head ? tail - head : tail + 2 * myCapacity - head;
+    }
+
   private:
 
     // The size of an individual fragment (in stereo / mono samples)
@@ -104,7 +135,11 @@ class AudioQueue
     // Are we using stereo samples?
     bool myIsStereo{false};
 
-    // The fragment queue
+    // The number of fragments that can be queued
+    uInt32 myCapacity{0};
+
+    // The fragment queue. Slots between head and tail hold queued fragments,
+    // the other slots hold free fragments
     vector<Int16*> myFragmentQueue;
 
     // All fragments, including the two fragments that are in circulation.
@@ -113,14 +148,12 @@ class AudioQueue
     // We allocate a consecutive slice of memory for the fragments.
     unique_ptr<Int16[]> myFragmentBuffer;
 
-    // The nubmer if queued fragments
-    uInt32 mySize{0};
-
-    // The next fragment.
-    uInt32 myNextFragment{0};
-
-    // We need a mutex for thread safety.
-    mutable std::mutex myMutex;
+    // Ring positions count modulo twice the capacity, so that a full ring
+    // can be told apart from an empty one. The head (next fragment to play)
+    // is only written by the consumer, the tail (next slot to fill) only by
+    // the producer.
+    std::atomic<uInt32> myHead{0};
+    std::atomic<uInt32> myTail{0};
 
     // The first (empty) enqueue call returns this fragment.
     Int16* myFirstFragmentForEnqueue{nullptr};
@@ -128,7 +161,9 @@ class AudioQueue
     Int16* myFirstFragmentForDequeue{nullptr};
 
     // Log overflows?
-    bool myIgnoreOverflows{true};
+    std::atomic<bool> myIgnoreOverflows{true};
+    // Written by the producer only
+    std::atomic<uInt32> myOverflows{0};
 
     StaggeredLogger myOverflowLogger{"audio buffer overflow", Logger::Level::INFO};
 
@@ -36,7 +36,7 @@ namespace {
   {
     return (
       numericResamplingQuality >= static_cast<int>(AudioSettings::ResamplingQuality::nearestNeightbour) &&
-      numericResamplingQuality <= static_cast<int>(AudioSettings::ResamplingQuality::lanczos_3)
+      numericResamplingQuality <= static_cast<int>(AudioSettings::ResamplingQuality::blep)
     ) ? static_cast<AudioSettings::ResamplingQuality>(numericResamplingQuality) : AudioSettings::DEFAULT_RESAMPLING_QUALITY;
   }
 }
@@ -37,7 +37,8 @@ class AudioSettings
     enum class ResamplingQuality {
       nearestNeightbour   = 1,
       lanczos_2           = 2,
-      lanczos_3           = 3
+      lanczos_3           = 3,
+      blep                = 4
     };
 
     static constexpr const char* SETTING_PRESET              = "audio.preset";
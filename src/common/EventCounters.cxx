@@ -0,0 +1,126 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "EventCounters.hxx"
+
+std::atomic<bool> EventCounters::ourEnabled{false};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+EventCounters::Counts EventCounters::Counts::operator-(const Counts& other) const
+{
+  Counts result;
+  for(uInt32 i = 0; i < NUM_EVENTS; ++i)
+    result.count[i] = count[i] - other.count[i];
+
+  return result;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+EventCounters& EventCounters::instance()
+{
+  static EventCounters counters;
+
+  return counters;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EventCounters::setEnabled(bool enable)
+{
+  ourEnabled = enable;
+  reset();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EventCounters::reset()
+{
+  for(auto& total: myTotals)
+    total = 0;
+
+  myFrameStart = Counts();
+  myLastFrame = Counts();
+  myFrames = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+EventCounters::Counts EventCounters::totals() const
+{
+  Counts result;
+  for(uInt32 i = 0; i < NUM_EVENTS; ++i)
+    result.count[i] = myTotals[i].load(std::memory_order_relaxed);
+
+  return result;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EventCounters::endFrame()
+{
+  if(!enabled())
+    return;
+
+  const Counts now = totals();
+
+  myLastFrame = now - myFrameStart;
+  myFrameStart = now;
+  ++myFrames;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string EventCounters::eventName(Event event)
+{
+  switch(event)
+  {
+    case Event::bankSwitch:    return "bankswitch";
+    case Event::pageRemap:     return "page remap";
+    case Event::thumbCall:     return "ARM call";
+    case Event::armCycles:     return "ARM cycles";
+    case Event::delayPush:     return "TIA delay";
+    case Event::hmove:         return "HMOVE";
+    case Event::wsync:         return "WSYNC";
+    case Event::audioOverflow: return "audio over";
+    case Event::audioUnderrun: return "audio under";
+    case Event::rewindCapture: return "rewind";
+    case Event::cacheMiss:     return "cache miss";
+    default:                   return "?";
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string EventCounters::toString() const
+{
+  const Counts total = totals();
+  ostringstream buf;
+
+  buf << "Events over " << myFrames << " frames" << endl
+      << std::left << std::setw(12) << "event" << std::right
+      << std::setw(10) << "frame" << std::setw(12) << "per frame"
+      << std::setw(14) << "total" << endl;
+
+  for(uInt32 i = 0; i < NUM_EVENTS; ++i)
+  {
+    const auto event = static_cast<Event>(i);
+
+    buf << std::left << std::setw(12) << eventName(event) << std::right
+        << std::setw(10) << myLastFrame[event]
+        << std::setw(12) << std::fixed << std::setprecision(1)
+        << (myFrames ? double(total[event]) / myFrames : 0.)
+        << std::setw(14) << total[event];
+    if(i + 1 < NUM_EVENTS)
+      buf << endl;
+  }
+
+  return buf.str();
+}
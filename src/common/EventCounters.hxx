@@ -0,0 +1,145 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef EVENT_COUNTERS_HXX
+#define EVENT_COUNTERS_HXX
+
+#include <array>
+#include <atomic>
+
+#include "bspf.hxx"
+
+/**
+  Counts costly emulation events (bankswitches, page remaps, ARM calls,
+  TIA register delays, ...), to find out why a frame is slow where the
+  timing of FrameProfiler only tells that it is.
+
+  The counters are always compiled in.  While they are disabled, counting
+  an event costs a single flag check; enabled, it's a relaxed atomic add,
+  so events may be counted from any thread.  The counts of all consoles
+  running (e.g. in a ConsoleBatch) are added up.
+
+  The main thread calls endFrame() once per displayed frame, which makes
+  the counts of that frame available.  Headless users can also take a
+  snapshot of the totals before and after emulating, and subtract them.
+
+  @author Stella Team
+*/
+class EventCounters
+{
+  public:
+    enum class Event: uInt8 {
+      bankSwitch,     // Cartridge bank() calls
+      pageRemap,      // Pages remapped by System::setPageAccess
+      thumbCall,      // Runs of the Thumbulator
+      armCycles,      // ARM cycles of these runs (if cycle counting)
+      delayPush,      // Writes entering the TIA DelayQueue
+      hmove,          // HMOVE strobes
+      wsync,          // WSYNC halts of the CPU
+      audioOverflow,  // Fragments dropped by a full audio queue
+      audioUnderrun,  // Fragments missing in the sound callback
+      rewindCapture,  // States captured by the RewindManager
+      cacheMiss,      // Misses of the ROM image and metadata caches
+      numEvents
+    };
+    static constexpr uInt32 NUM_EVENTS = static_cast<uInt32>(Event::numEvents);
+
+    struct Counts {
+      std::array<uInt64, NUM_EVENTS> count{0};
+
+      uInt64 operator[](Event event) const {
+        return count[static_cast<uInt32>(event)];
+      }
+      Counts operator-(const Counts& other) const;
+    };
+
+  public:
+    static EventCounters& instance();
+
+    static bool enabled() { return ourEnabled.load(std::memory_order_relaxed); }
+
+    /**
+      Count the given number of events, if counting is enabled.
+    */
+    static void count(Event event, uInt64 n = 1) {
+      if(enabled()) instance().add(event, n);
+    }
+
+    /**
+      Enable or disable counting; both discard all counts.
+    */
+    void setEnabled(bool enable);
+
+    /**
+      Add events unconditionally (thread-safe).
+    */
+    void add(Event event, uInt64 n) {
+      myTotals[static_cast<uInt32>(event)].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    /**
+      A snapshot of the counts since counting was enabled (thread-safe).
+    */
+    Counts totals() const;
+
+    /**
+      Close the current frame.  Must be called from the main thread only,
+      as all methods below.
+    */
+    void endFrame();
+
+    /**
+      The counts of the last frame closed by endFrame().
+    */
+    const Counts& lastFrame() const { return myLastFrame; }
+
+    /**
+      The number of frames closed since counting was enabled.
+    */
+    uInt64 frames() const { return myFrames; }
+
+    static string eventName(Event event);
+
+    /**
+      A human-readable table of the counts of the last frame, the average
+      per frame and the totals.
+    */
+    string toString() const;
+
+  private:
+    EventCounters() = default;
+
+    void reset();
+
+  private:
+    static std::atomic<bool> ourEnabled;
+
+    std::array<std::atomic<uInt64>, NUM_EVENTS> myTotals{};
+
+    // The totals at the end of the previous frame
+    Counts myFrameStart;
+    Counts myLastFrame;
+    uInt64 myFrames{0};
+
+  private:
+    EventCounters(const EventCounters&) = delete;
+    EventCounters(EventCounters&&) = delete;
+    EventCounters& operator=(const EventCounters&) = delete;
+    EventCounters& operator=(EventCounters&&) = delete;
+};
+
+#endif // EVENT_COUNTERS_HXX
@@ -20,6 +20,7 @@
 #include "SDL_lib.hxx"
 #include "bspf.hxx"
 #include "Logger.hxx"
+#include "FrameProfiler.hxx"
 
 #include "Console.hxx"
 #include "OSystem.hxx"
@@ -536,6 +537,7 @@ int FBBackendSDL2::refreshRate() const
 void FBBackendSDL2::renderToScreen()
 {
   ASSERT_MAIN_THREAD;
+  FrameProfiler::Scope profilerScope(FrameProfiler::Stage::present);
 
   // Show all changes made to the renderer
   SDL_RenderPresent(myRenderer);
@@ -592,6 +594,7 @@ void FBBackendSDL2::clear()
 void FBBackendSDL2::detectFeatures()
 {
   myRenderTargetSupport = detectRenderTargetSupport();
+  mySoftwareRenderer = detectSoftwareRenderer();
 
   if(myRenderer && !myRenderTargetSupport)
     Logger::info("Render targets are not supported --- QIS not available");
@@ -626,6 +629,21 @@ bool FBBackendSDL2::detectRenderTargetSupport()
   return sdlError == 0;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FBBackendSDL2::detectSoftwareRenderer()
+{
+  ASSERT_MAIN_THREAD;
+
+  if(myRenderer == nullptr)
+    return false;
+
+  SDL_RendererInfo info;
+  if(SDL_GetRendererInfo(myRenderer, &info) != 0)
+    return false;
+
+  return (info.flags & SDL_RENDERER_SOFTWARE) || BSPF::equalsIgnoreCase(info.name, "software");
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FBBackendSDL2::determineDimensions()
 {
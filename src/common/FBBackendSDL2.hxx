@@ -62,6 +62,11 @@ class FBBackendSDL2 : public FBBackend
      */
     bool hasRenderTargetSupport() const { return myRenderTargetSupport; }
 
+    /**
+      Is the renderer a software (CPU only) renderer?
+     */
+    bool isSoftwareRenderer() const { return mySoftwareRenderer; }
+
     /**
       Transform from window to renderer coordinates, x direction
      */
@@ -247,6 +252,11 @@ class FBBackendSDL2 : public FBBackend
      */
     bool detectRenderTargetSupport();
 
+    /**
+      Detect if the renderer is a software renderer.
+     */
+    bool detectSoftwareRenderer();
+
     /**
       Determine window and renderer dimensions.
      */
@@ -273,6 +283,9 @@ class FBBackendSDL2 : public FBBackend
     // Does the renderer support render targets?
     bool myRenderTargetSupport{false};
 
+    // Does the renderer scale on the CPU?
+    bool mySoftwareRenderer{false};
+
     // Title of the main window/screen
     string myScreenTitle;
 
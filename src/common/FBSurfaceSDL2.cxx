@@ -18,6 +18,7 @@
 #include "FBSurfaceSDL2.hxx"
 
 #include "Logger.hxx"
+#include "FrameProfiler.hxx"
 #include "ThreadDebugging.hxx"
 #include "sdl_blitter/BlitterFactory.hxx"
 
@@ -80,6 +81,7 @@ void FBSurfaceSDL2::fillRect(uInt32 x, uInt32 y, uInt32 w, uInt32 h, ColorId col
   tmp.w = w;
   tmp.h = h;
   SDL_FillRect(mySurface, &tmp, myPalette[color]);
+  setDirty(x, y, w, h);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -174,7 +176,12 @@ bool FBSurfaceSDL2::render()
 
   if(myIsVisible && myBlitter)
   {
-    myBlitter->blit(*mySurface);
+    FrameProfiler::Scope profilerScope(FrameProfiler::Stage::blit);
+
+    // Only the area modified since the last call has to be uploaded
+    DirtyRegion dirty;
+    takeDirtyRegion(dirty);
+    ourUploadedBytes += myBlitter->blit(*mySurface, dirty);
 
     return true;
   }
@@ -187,6 +194,7 @@ void FBSurfaceSDL2::invalidate()
   ASSERT_MAIN_THREAD;
 
   SDL_FillRect(mySurface, nullptr, 0);
+  setDirty();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -203,6 +211,7 @@ void FBSurfaceSDL2::invalidateRect(uInt32 x, uInt32 y, uInt32 w, uInt32 h)
   // Note: Transparency has to be 0 to clear the rectangle foreground
   //  without affecting the background display.
   SDL_FillRect(mySurface, &tmp, 0);
+  setDirty(x, y, w, h);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -255,6 +264,7 @@ void FBSurfaceSDL2::createSurface(uInt32 width, uInt32 height,
   myIsStatic = data != nullptr;
   if(myIsStatic)
     SDL_memcpy(mySurface->pixels, data, mySurface->w * mySurface->h * 4);
+  setDirty();
 
   reload();
 }
@@ -270,8 +280,14 @@ void FBSurfaceSDL2::reinitializeBlitter(bool force)
         myBackend, scalingAlgorithm(myInterpolationMode));
 
   if (myBlitter)
+  {
     myBlitter->reinitialize(mySrcR, myDstR, myAttributes,
                             myIsStatic ? mySurface : nullptr);
+    myDrawsScanlines = myScanlineIntensity > 0 &&
+                       myBlitter->drawScanlines(myScanlineIntensity);
+  }
+  else
+    myDrawsScanlines = false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -288,3 +304,15 @@ void FBSurfaceSDL2::setScalingInterpolation(ScalingInterpolation interpolation)
   myInterpolationMode = interpolation;
   reload();
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FBSurfaceSDL2::setScanlines(uInt32 intensity)
+{
+  if (intensity == myScanlineIntensity) return;
+
+  if (myBlitter && myScanlineIntensity > 0 && intensity == 0)
+    myBlitter->drawScanlines(0);
+
+  myScanlineIntensity = intensity;
+  reinitializeBlitter();
+}
@@ -65,6 +65,9 @@ class FBSurfaceSDL2 : public FBSurface
 
     void setScalingInterpolation(ScalingInterpolation) override;
 
+    void setScanlines(uInt32 intensity) override;
+    bool drawsScanlines() const override { return myDrawsScanlines; }
+
   protected:
     void applyAttributes() override;
 
@@ -130,6 +133,10 @@ class FBSurfaceSDL2 : public FBSurface
     bool myIsVisible{true};
     bool myIsStatic{false};
 
+    // Scanline intensity, and whether the blitter draws them
+    uInt32 myScanlineIntensity{0};
+    bool myDrawsScanlines{false};
+
     Common::Rect mySrcGUIR, myDstGUIR;
 };
 
@@ -133,6 +133,10 @@ bool FilesystemNodeZIP::exists() const
   {
     // We need to inspect the actual path, not just the ZIP file itself
     myZipHandler->open(_zipFile);
+    if(myZipHandler->find(_virtualPath))
+      return true;
+
+    // Directories only exist as a prefix of the files they contain
     while(myZipHandler->hasNext())
       if(BSPF::startsWithIgnoreCase(myZipHandler->next(), _virtualPath))
         return true;
@@ -180,7 +184,7 @@ bool FilesystemNodeZIP::getChildren(AbstractFSList& myList, ListMode mode) const
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-size_t FilesystemNodeZIP::read(ByteBuffer& image) const
+bool FilesystemNodeZIP::selectFile() const
 {
   switch(_error)
   {
@@ -192,24 +196,25 @@ size_t FilesystemNodeZIP::read(ByteBuffer& image) const
 
   myZipHandler->open(_zipFile);
 
-  bool found = false;
-  while(myZipHandler->hasNext() && !found)
-    found = myZipHandler->next() == _virtualPath;
+  return myZipHandler->find(_virtualPath);
+}
 
-  return found ? myZipHandler->decompress(image) : 0;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t FilesystemNodeZIP::read(ByteBuffer& image) const
+{
+  return selectFile() ? myZipHandler->decompress(image) : 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 size_t FilesystemNodeZIP::read(stringstream& image) const
 {
-  // For now, we just read into a buffer and store in the stream
-  // TODO: maybe there's a more efficient way to do this?
-  ByteBuffer buffer;
-  size_t size = read(buffer);
-  if(size > 0)
-    image.write(reinterpret_cast<char*>(buffer.get()), size);
-
-  return size;
+  // Stream the data as it is decompressed, without an intermediate buffer
+  if(!selectFile())
+    return 0;
+
+  return myZipHandler->decompress([&image](const uInt8* data, size_t length) {
+    image.write(reinterpret_cast<const char*>(data), length);
+  });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
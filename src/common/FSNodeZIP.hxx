@@ -52,6 +52,9 @@ class FilesystemNodeZIP : public AbstractFSNode
     bool isFile() const      override { return _isFile;      }
     bool isReadable() const  override { return _realNode && _realNode->isReadable(); }
     bool isWritable() const  override { return false; }
+    bool getFileInfo(uInt64& size, uInt64& mtime) const override {
+      return _realNode && _realNode->getFileInfo(size, mtime);
+    }
 
     //////////////////////////////////////////////////////////
     // For now, ZIP files cannot be modified in any way
@@ -74,6 +77,10 @@ class FilesystemNodeZIP : public AbstractFSNode
     void setFlags(const string& zipfile, const string& virtualpath,
         const AbstractFSNodePtr& realnode);
 
+    // Open the archive and select the file this node refers to
+    // An exception is thrown if the node is in an error state
+    bool selectFile() const;
+
     friend ostream& operator<<(ostream& os, const FilesystemNodeZIP& node)
     {
       os << "_zipFile:     " << node._zipFile << endl
@@ -0,0 +1,219 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#if defined(PNG_SUPPORT)
+
+#include "Logger.hxx"
+#include "PNGLibrary.hxx"
+#include "FrameCapture.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+FrameCapture::~FrameCapture()
+{
+  stop();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FrameCapture::start(const string& path, Format format, float fps,
+                         const VariantList& comments)
+{
+  stop();
+
+  myPath = path;
+  myFormat = format;
+  myFps = fps;
+  myComments = comments;
+
+  if(myFormat == Format::y4m)
+  {
+    myStream.open(myPath + ".y4m", std::ios::binary | std::ios::trunc);
+    if(!myStream.is_open())
+      return false;
+
+    // The stream header is written along with the first frame
+    myStreamWidth = myStreamHeight = 0;
+  }
+
+  myFirstSlot = myNumQueued = 0;
+  myWritten = myDropped = 0;
+  myQuit = false;
+  myWorker = std::thread(&FrameCapture::workerMain, this);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 FrameCapture::stop()
+{
+  if(isActive())
+  {
+    {
+      std::lock_guard<std::mutex> lock(myMutex);
+      myQuit = true;
+    }
+    myCondition.notify_all();
+
+    // The worker writes all queued frames before it quits
+    myWorker.join();
+
+    if(myStream.is_open())
+      myStream.close();
+  }
+
+  return myWritten;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FrameCapture::addFrame(const uInt8* pixels, uInt32 width, uInt32 height,
+                            const PaletteArray& palette, uInt32 number)
+{
+  if(!isActive())
+    return false;
+
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    if(myNumQueued == NUM_SLOTS)
+    {
+      ++myDropped;
+      return false;
+    }
+
+    Frame& frame = mySlots[(myFirstSlot + myNumQueued) % NUM_SLOTS];
+    frame.pixels.assign(pixels, pixels + size_t(width) * height);
+    frame.palette = palette;
+    frame.width = width;
+    frame.height = height;
+    frame.number = number;
+
+    ++myNumQueued;
+  }
+  myCondition.notify_all();
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameCapture::workerMain()
+{
+  std::unique_lock<std::mutex> lock(myMutex);
+
+  while(true)
+  {
+    myCondition.wait(lock, [this]() { return myNumQueued > 0 || myQuit; });
+    if(myNumQueued == 0)
+      break;
+
+    // The slot isn't reused before it is released below
+    const Frame& frame = mySlots[myFirstSlot];
+    lock.unlock();
+
+    try
+    {
+      if(myFormat == Format::y4m)
+        writeY4M(frame);
+      else
+        writePNG(frame);
+      ++myWritten;
+    }
+    catch(const runtime_error& e)
+    {
+      Logger::error(e.what());
+    }
+
+    lock.lock();
+    myFirstSlot = (myFirstSlot + 1) % NUM_SLOTS;
+    --myNumQueued;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameCapture::writePNG(const Frame& frame)
+{
+  ostringstream filename;
+  filename << myPath << "_" << std::hex << std::setw(8) << std::setfill('0')
+           << frame.number << ".png";
+
+  // Double each pixel horizontally
+  const uInt32 width = frame.width * 2;
+  myRow.resize(size_t(width) * frame.height);
+  for(size_t i = 0; i < frame.pixels.size(); ++i)
+    myRow[i * 2] = myRow[i * 2 + 1] = frame.pixels[i];
+
+  PNGLibrary::saveImage(filename.str(), myRow.data(), width, frame.height,
+                        frame.palette, myComments);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameCapture::writeY4M(const Frame& frame)
+{
+  if(myStreamWidth == 0)
+  {
+    myStreamWidth = frame.width * 2;
+    myStreamHeight = frame.height;
+    myPlanes.resize(size_t(myStreamWidth) * myStreamHeight * 3);
+
+    // Full resolution chroma, so that no colors are mixed
+    myStream << "YUV4MPEG2 W" << myStreamWidth << " H" << myStreamHeight
+             << " F" << uInt32(myFps * 1000 + 0.5F) << ":1000 Ip A1:1 C444\n";
+  }
+
+  // Convert the palette to limited range BT.601 YCbCr; pixels outside of
+  // the frame (if its height changed) are black
+  std::array<uInt8, 256> py, pu, pv;
+  for(uInt32 i = 0; i < 256; ++i)
+  {
+    const int r = (frame.palette[i] >> 16) & 0xff,
+              g = (frame.palette[i] >> 8) & 0xff,
+              b = frame.palette[i] & 0xff;
+
+    py[i] = uInt8((( 66 * r + 129 * g +  25 * b + 128) >> 8) +  16);
+    pu[i] = uInt8(((-38 * r -  74 * g + 112 * b + 128) >> 8) + 128);
+    pv[i] = uInt8(((112 * r -  94 * g -  18 * b + 128) >> 8) + 128);
+  }
+
+  const size_t planeSize = size_t(myStreamWidth) * myStreamHeight;
+  uInt8* y = myPlanes.data();
+  uInt8* u = y + planeSize;
+  uInt8* v = u + planeSize;
+  const uInt32 height = std::min(frame.height, myStreamHeight),
+               width = std::min(frame.width, myStreamWidth / 2);
+
+  std::fill_n(y, planeSize, 16);
+  std::fill_n(u, planeSize * 2, 128);
+  for(uInt32 row = 0; row < height; ++row)
+  {
+    const uInt8* in = frame.pixels.data() + size_t(row) * frame.width;
+    const size_t out = size_t(row) * myStreamWidth;
+
+    for(uInt32 x = 0; x < width; ++x)
+    {
+      const uInt8 index = in[x];
+      y[out + x * 2] = y[out + x * 2 + 1] = py[index];
+      u[out + x * 2] = u[out + x * 2 + 1] = pu[index];
+      v[out + x * 2] = v[out + x * 2 + 1] = pv[index];
+    }
+  }
+
+  myStream << "FRAME\n";
+  myStream.write(reinterpret_cast<const char*>(myPlanes.data()), myPlanes.size());
+  if(!myStream)
+    throw runtime_error("ERROR: Couldn't write video capture file");
+}
+
+#endif  // PNG_SUPPORT
@@ -0,0 +1,148 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#if defined(PNG_SUPPORT)
+
+#ifndef FRAME_CAPTURE_HXX
+#define FRAME_CAPTURE_HXX
+
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include "bspf.hxx"
+#include "FrameBufferConstants.hxx"
+#include "Variant.hxx"
+
+/**
+  Records TIA frames on a worker thread, either as a sequence of PNG
+  images or as a single YUV4MPEG2 (Y4M) video stream.
+
+  addFrame() only copies the indexed TIA frame and its palette into one of
+  a fixed number of slots; conversion, encoding and file I/O all happen on
+  the worker thread.  If the worker falls behind and all slots are in use,
+  frames are dropped (and counted) instead of stalling the emulation.
+
+  @author  Stella Team
+*/
+class FrameCapture
+{
+  public:
+    enum class Format { png, y4m };
+
+    FrameCapture() = default;
+    ~FrameCapture();
+
+    /**
+      Start a new capture, finishing a running one first.
+
+      @param path      The output file name without extension; PNG images
+                       get the frame number appended
+      @param format    The output format
+      @param fps       The frame rate, stored in the Y4M stream header
+      @param comments  The text comments to add to PNG images
+
+      @return  False if the output file could not be created
+    */
+    bool start(const string& path, Format format, float fps,
+               const VariantList& comments = EmptyVarList);
+
+    /**
+      Finish the capture, waiting until all queued frames have been written.
+
+      @return  The number of frames written
+    */
+    uInt32 stop();
+
+    /**
+      Answer whether a capture is running.
+    */
+    bool isActive() const { return myWorker.joinable(); }
+
+    /**
+      Queue a frame for encoding.  Like in '1x' snapshots, each TIA pixel
+      becomes two pixels in the output.
+
+      @param pixels   The indexed TIA frame (one byte per pixel)
+      @param width    The width of the frame in TIA pixels
+      @param height   The height of the frame
+      @param palette  The RGB palette of the frame (0x00RRGGBB)
+      @param number   The number appended to the name of PNG images
+
+      @return  False if the frame was dropped
+    */
+    bool addFrame(const uInt8* pixels, uInt32 width, uInt32 height,
+                  const PaletteArray& palette, uInt32 number);
+
+    /**
+      Answer the number of frames dropped in the current/last capture.
+    */
+    uInt32 droppedFrames() const { return myDropped; }
+
+  private:
+    struct Frame {
+      ByteArray pixels;
+      PaletteArray palette;
+      uInt32 width{0}, height{0};
+      uInt32 number{0};
+    };
+
+    // The worker thread's main loop
+    void workerMain();
+
+    void writePNG(const Frame& frame);
+    void writeY4M(const Frame& frame);
+
+  private:
+    // Enough for a quarter of a second at 60 FPS
+    static constexpr uInt32 NUM_SLOTS = 16;
+
+    // Queued frames are mySlots[myFirstSlot] ... (wrapping around)
+    std::array<Frame, NUM_SLOTS> mySlots;
+    uInt32 myFirstSlot{0}, myNumQueued{0};
+    bool myQuit{false};
+
+    Format myFormat{Format::png};
+    string myPath;
+    VariantList myComments;
+    float myFps{60};
+
+    // The Y4M stream; its size is defined by the first frame
+    std::ofstream myStream;
+    uInt32 myStreamWidth{0}, myStreamHeight{0};
+    ByteArray myPlanes, myRow;
+
+    uInt32 myWritten{0};
+    uInt32 myDropped{0};
+
+    std::thread myWorker;
+    std::mutex myMutex;
+    std::condition_variable myCondition;
+
+  private:
+    // Following constructors and assignment operators not supported
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture(FrameCapture&&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+    FrameCapture& operator=(FrameCapture&&) = delete;
+};
+
+#endif
+
+#endif  // PNG_SUPPORT
@@ -0,0 +1,77 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <cmath>
+
+#include "FramePacer.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FramePacer::reset(double displayPeriod, double framePeriod)
+{
+  myError = myIntegral = 0.;
+  mySpeedFactor = 1.;
+  myNonBlockingFrames = 0;
+  myEnabled = false;
+
+  if(displayPeriod <= 0. || framePeriod <= 0.)
+    return;
+
+  // On e.g. 120 Hz displays, every second vblank is used
+  const double vblanks = std::max(std::round(framePeriod / displayPeriod), 1.);
+  if(std::abs(framePeriod / (vblanks * displayPeriod) - 1.) >= MAX_CORRECTION)
+    return;
+
+  myDisplayPeriod = displayPeriod;
+  // Leave some headroom for variations of the render time
+  myTargetTime = std::min(0.002, displayPeriod / 4);
+  myEnabled = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FramePacer::presented(double presentTime)
+{
+  if(!myEnabled)
+    return;
+
+  // Without feedback from the driver there is nothing to lock to
+  if(presentTime < MIN_BLOCKING_TIME)
+  {
+    if(++myNonBlockingFrames > MAX_NON_BLOCKING_FRAMES)
+    {
+      reset();
+      return;
+    }
+  }
+  else
+    myNonBlockingFrames = 0;
+
+  // A positive error means the frame was ready too early. The vblanks are
+  // periodic, so very early is the same as slightly too late.
+  double error = presentTime - myTargetTime;
+  if(error > myDisplayPeriod / 2)
+    error -= myDisplayPeriod;
+
+  myError += SMOOTHING * (error - myError);
+
+  // The integral term takes over the difference of display and frame rate
+  const double relativeError = myError / myDisplayPeriod;
+  myIntegral = BSPF::clamp(myIntegral + GAIN_I * relativeError,
+                           -MAX_CORRECTION, MAX_CORRECTION);
+
+  mySpeedFactor = 1. - BSPF::clamp(GAIN_P * relativeError + myIntegral,
+                                   -MAX_CORRECTION, MAX_CORRECTION);
+}
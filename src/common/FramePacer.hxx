@@ -0,0 +1,102 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef FRAME_PACER_HXX
+#define FRAME_PACER_HXX
+
+#include "bspf.hxx"
+
+/**
+  Locks the emulation to the display's vertical blank.
+
+  With vsync, presenting a frame blocks until the next vblank, so the time
+  spent in present tells how long before the vblank the frame was ready.
+  The pacer slightly speeds up or slows down the emulation (by at most
+  MAX_CORRECTION) until that time is just a small margin.  Frames are then
+  finished just in time for the vblank, which minimizes latency, and the
+  emulation runs at exactly the display rate, which avoids the frames
+  otherwise dropped or shown twice every few seconds.
+
+  This only works if the display refresh rate is close to a multiple of
+  the emulated frame rate, and the driver actually blocks in present.
+*/
+class FramePacer
+{
+  public:
+
+    FramePacer() = default;
+
+    /**
+      Restart pacing.  Pacing is disabled if any of the periods is zero, or
+      if the display period doesn't fit the frame period.
+
+      @param displayPeriod  Time between two vblanks, in seconds
+      @param framePeriod    Time between two emulated frames, in seconds
+    */
+    void reset(double displayPeriod = 0., double framePeriod = 0.);
+
+    /**
+      Feed back the time spent presenting a frame.
+
+      @param presentTime  Time spent in present, in seconds
+    */
+    void presented(double presentTime);
+
+    /**
+      The factor to apply to the emulation speed.
+    */
+    double speedFactor() const { return myEnabled ? mySpeedFactor : 1.; }
+
+    bool enabled() const { return myEnabled; }
+
+  private:
+
+    // Largest deviation from the nominal emulation speed
+    static constexpr double MAX_CORRECTION = 0.01;
+
+    // Proportional and integral gain, relative to the display period
+    static constexpr double GAIN_P = 0.02, GAIN_I = 0.0005;
+
+    // Smoothing of the measured present times
+    static constexpr double SMOOTHING = 0.2;
+
+    // Present times below this are considered as not waiting for vblank...
+    static constexpr double MIN_BLOCKING_TIME = 0.0001;
+    // ...and pacing gives up if it doesn't block for this many frames
+    static constexpr uInt32 MAX_NON_BLOCKING_FRAMES = 180;
+
+  private:
+
+    bool myEnabled{false};
+
+    double myDisplayPeriod{0.};
+    double myTargetTime{0.};
+
+    double myError{0.};
+    double myIntegral{0.};
+    double mySpeedFactor{1.};
+
+    uInt32 myNonBlockingFrames{0};
+
+  private:
+    FramePacer(const FramePacer&) = delete;
+    FramePacer(FramePacer&&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+    FramePacer& operator=(FramePacer&&) = delete;
+};
+
+#endif // FRAME_PACER_HXX
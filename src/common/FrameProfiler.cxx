@@ -0,0 +1,212 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include <algorithm>
+
+#include "json_lib.hxx"
+#include "Logger.hxx"
+#include "FrameProfiler.hxx"
+
+using json = nlohmann::json;
+
+std::atomic<bool> FrameProfiler::ourEnabled{false};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+FrameProfiler& FrameProfiler::instance()
+{
+  static FrameProfiler profiler;
+
+  return profiler;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameProfiler::setEnabled(bool enable)
+{
+  ourEnabled = enable;
+  reset();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameProfiler::reset()
+{
+  for(auto& pending: myPending)
+    pending = 0;
+
+  myWindowPos = myWindowFill = 0;
+  mySummaries.fill(Summary());
+  myFrames = 0;
+  myLastFrame = Clock::now();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameProfiler::add(Stage stage, Clock::duration time)
+{
+  myPending[static_cast<uInt32>(stage)].fetch_add(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(time).count(),
+    std::memory_order_relaxed);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameProfiler::skipFrame()
+{
+  for(auto& pending: myPending)
+    pending = 0;
+
+  myLastFrame = Clock::now();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameProfiler::endFrame()
+{
+  if(!enabled()) return;
+
+  const Clock::time_point now = Clock::now();
+  add(Stage::frame, now - myLastFrame);
+  myLastFrame = now;
+
+  std::array<uInt64, NUM_STAGES> times;
+  for(uInt32 i = 0; i < NUM_STAGES; ++i)
+    times[i] = myPending[i].exchange(0, std::memory_order_relaxed);
+
+  // The TIA and ARM are driven from within M6502::execute
+  uInt64& cpu = times[static_cast<uInt32>(Stage::cpu)];
+  const uInt64 nested = times[static_cast<uInt32>(Stage::tia)] +
+                        times[static_cast<uInt32>(Stage::thumb)];
+  cpu = cpu > nested ? cpu - nested : 0;
+
+  for(uInt32 i = 0; i < NUM_STAGES; ++i)
+    myWindow[i][myWindowPos] = static_cast<uInt32>(std::min<uInt64>(times[i], ~0U));
+
+  myWindowPos = (myWindowPos + 1) % WINDOW_SIZE;
+  myWindowFill = std::min(myWindowFill + 1, WINDOW_SIZE);
+  ++myFrames;
+
+  // Report frames which took much longer than usual
+  const double frameTime = times[static_cast<uInt32>(Stage::frame)] / 1e6;
+  const double median = summary(Stage::frame).p50;
+  if(median > 0 && frameTime > 2 * median)
+  {
+    ostringstream buf;
+    buf << "Frame " << myFrames << " took " << std::fixed << std::setprecision(2)
+        << frameTime << " ms:";
+    for(uInt32 i = 0; i < static_cast<uInt32>(Stage::frame); ++i)
+      buf << " " << stageName(static_cast<Stage>(i)) << " " << times[i] / 1e6;
+    Logger::debug(buf.str());
+  }
+
+  if(myFrames % SUMMARY_INTERVAL == 0)
+    updateSummaries();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameProfiler::updateSummaries()
+{
+  if(myWindowFill == 0) return;
+
+  std::array<uInt32, WINDOW_SIZE> sorted;
+  const auto begin = sorted.begin(), end = begin + myWindowFill;
+
+  for(uInt32 i = 0; i < NUM_STAGES; ++i)
+  {
+    std::copy_n(myWindow[i].begin(), myWindowFill, begin);
+
+    const auto p50 = begin + myWindowFill / 2,
+               p99 = begin + (myWindowFill * 99) / 100;
+    std::nth_element(begin, p50, end);
+    std::nth_element(p50, p99, end);
+
+    mySummaries[i].p50 = *p50 / 1e6;
+    mySummaries[i].p99 = *p99 / 1e6;
+    mySummaries[i].max = *std::max_element(p99, end) / 1e6;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string FrameProfiler::stageName(Stage stage)
+{
+  switch(stage)
+  {
+    case Stage::cpu:        return "M6502";
+    case Stage::tia:        return "TIA";
+    case Stage::thumb:      return "ARM";
+    case Stage::audio:      return "Audio";
+    case Stage::tiaSurface: return "TIASurface";
+    case Stage::blit:       return "Blit";
+    case Stage::present:    return "Present";
+    case Stage::oversleep:  return "Oversleep";
+    case Stage::frame:      return "Frame";
+    default:                return "";
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string FrameProfiler::toString()
+{
+  updateSummaries();
+
+  ostringstream buf;
+
+  buf << "Frame profile, last " << myWindowFill << " of " << myFrames
+      << " frames (ms):" << endl
+      << std::left << std::setw(12) << "stage" << std::right
+      << std::setw(8) << "p50" << std::setw(8) << "p99" << std::setw(8) << "max"
+      << endl << std::fixed << std::setprecision(2);
+
+  for(uInt32 i = 0; i < NUM_STAGES; ++i)
+  {
+    const Summary& s = mySummaries[i];
+
+    buf << std::left << std::setw(12) << stageName(static_cast<Stage>(i)) << std::right
+        << std::setw(8) << s.p50 << std::setw(8) << s.p99 << std::setw(8) << s.max
+        << endl;
+  }
+
+  return buf.str();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string FrameProfiler::toJson()
+{
+  updateSummaries();
+
+  json report = json::object();
+
+  report["frames"] = myFrames;
+  report["window"] = myWindowFill;
+
+  json stages = json::object();
+  for(uInt32 i = 0; i < NUM_STAGES; ++i)
+  {
+    const Summary& s = mySummaries[i];
+    json samples = json::array();
+
+    // Oldest frame first, in nanoseconds
+    for(uInt32 j = 0; j < myWindowFill; ++j)
+      samples.push_back(myWindow[i][(myWindowPos + WINDOW_SIZE - myWindowFill + j) % WINDOW_SIZE]);
+
+    stages[stageName(static_cast<Stage>(i))] = {
+      {"p50", s.p50},
+      {"p99", s.p99},
+      {"max", s.max},
+      {"samples", samples}
+    };
+  }
+  report["stages"] = stages;
+
+  return report.dump(2);
+}
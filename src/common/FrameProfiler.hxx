@@ -0,0 +1,188 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef FRAME_PROFILER_HXX
+#define FRAME_PROFILER_HXX
+
+#include <array>
+#include <atomic>
+#include <chrono>
+
+#include "bspf.hxx"
+
+/**
+  Measures the time spent in each stage of producing a frame, and keeps
+  rolling statistics (median, 99th percentile and maximum) over the last
+  frames.
+
+  The stages are timed with Scope objects, which may be used from any
+  thread (emulation worker, audio callback, main thread) and cost only a
+  flag check while profiling is disabled.  The time accumulated between
+  two calls of endFrame() (issued by the main thread once per displayed
+  frame) is attributed to that frame.  Emulation is interleaved with the
+  TIA and ARM, so the M6502 stage reports the CPU time *excluding* these.
+
+  @author Stella Team
+*/
+class FrameProfiler
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Stage : uInt8 {
+      cpu,        // M6502::execute, without TIA and ARM
+      tia,        // TIA::updateEmulation
+      thumb,      // Thumbulator
+      audio,      // Audio resampling
+      tiaSurface, // TIASurface::render, without blitting
+      blit,       // Texture upload and rendering of all surfaces
+      present,    // Presenting the frame on screen
+      oversleep,  // Main loop waking up after its deadline
+      frame,      // Wall time between two frames
+      numStages
+    };
+    static constexpr uInt32 NUM_STAGES = static_cast<uInt32>(Stage::numStages);
+
+    // Statistics of a stage over the rolling window, in milliseconds
+    struct Summary {
+      double p50{0.}, p99{0.}, max{0.};
+    };
+
+    /**
+      Adds the time from construction to destruction to the given stage.
+    */
+    class Scope
+    {
+      public:
+        explicit Scope(Stage stage)
+          : myStage{stage}, myActive{FrameProfiler::enabled()}
+        {
+          if(myActive) myStart = Clock::now();
+        }
+
+        ~Scope() { stop(); }
+
+        /**
+          End the measurement before the end of the scope.
+        */
+        void stop()
+        {
+          if(myActive) instance().add(myStage, Clock::now() - myStart);
+          myActive = false;
+        }
+
+      private:
+        Stage myStage;
+        bool myActive{false};
+        Clock::time_point myStart;
+
+      private:
+        Scope(const Scope&) = delete;
+        Scope(Scope&&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        Scope& operator=(Scope&&) = delete;
+    };
+
+  public:
+
+    static FrameProfiler& instance();
+
+    static bool enabled() { return ourEnabled.load(std::memory_order_relaxed); }
+
+    /**
+      Enable or disable profiling; both discard all collected data.
+    */
+    void setEnabled(bool enable);
+
+    /**
+      Add time to the stage of the current frame (thread-safe).
+    */
+    void add(Stage stage, Clock::duration time);
+
+    /**
+      Close the current frame and add its stage times to the statistics.
+      Must be called from the main thread only, as all methods below.
+    */
+    void endFrame();
+
+    /**
+      Discard the time collected for the current frame, and restart the
+      frame clock (e.g. when emulation resumes after a pause).
+    */
+    void skipFrame();
+
+    /**
+      The statistics of the stage, updated every few frames.
+    */
+    const Summary& summary(Stage stage) const {
+      return mySummaries[static_cast<uInt32>(stage)];
+    }
+
+    /**
+      The number of frames profiled since the profiler was enabled.
+    */
+    uInt64 frames() const { return myFrames; }
+
+    static string stageName(Stage stage);
+
+    /**
+      A human-readable table of the up-to-date statistics.
+    */
+    string toString();
+
+    /**
+      A machine-readable dump (JSON) of the up-to-date statistics, including
+      the stage times of all frames in the rolling window.
+    */
+    string toJson();
+
+  private:
+    FrameProfiler() = default;
+
+    void reset();
+
+    void updateSummaries();
+
+  private:
+    // Frames kept for the statistics (~10 seconds)
+    static constexpr uInt32 WINDOW_SIZE = 600;
+    // Frames between two updates of the summaries
+    static constexpr uInt32 SUMMARY_INTERVAL = 30;
+
+    static std::atomic<bool> ourEnabled;
+
+    // Time accumulated for the current frame, in nanoseconds
+    std::array<std::atomic<uInt64>, NUM_STAGES> myPending{};
+
+    // Stage times (in nanoseconds) of the last WINDOW_SIZE frames
+    std::array<std::array<uInt32, WINDOW_SIZE>, NUM_STAGES> myWindow{};
+    uInt32 myWindowPos{0}, myWindowFill{0};
+
+    std::array<Summary, NUM_STAGES> mySummaries{};
+
+    uInt64 myFrames{0};
+    Clock::time_point myLastFrame;
+
+  private:
+    FrameProfiler(const FrameProfiler&) = delete;
+    FrameProfiler(FrameProfiler&&) = delete;
+    FrameProfiler& operator=(const FrameProfiler&) = delete;
+    FrameProfiler& operator=(FrameProfiler&&) = delete;
+};
+
+#endif // FRAME_PROFILER_HXX
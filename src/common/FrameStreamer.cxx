@@ -0,0 +1,205 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "TIAConstants.hxx"
+#include "FrameStreamer.hxx"
+
+namespace {
+  constexpr std::array<uInt8, 4> MAGIC = { 'S', 'T', 'F', 'S' };
+
+  constexpr uInt32 WIDTH = TIAConstants::frameBufferWidth;
+
+  // Line number, encoding and the worst case (raw) pixels
+  constexpr size_t MAX_LINE_SIZE = 3 + WIDTH;
+
+  void putShort(vector<uInt8>& packet, uInt32 value)
+  {
+    packet.push_back(static_cast<uInt8>(value));
+    packet.push_back(static_cast<uInt8>(value >> 8));
+  }
+
+  void putInt(vector<uInt8>& packet, uInt32 value)
+  {
+    for(int i = 0; i < 4; ++i, value >>= 8)
+      packet.push_back(static_cast<uInt8>(value));
+  }
+
+  void startPacket(vector<uInt8>& packet, uInt8 type)
+  {
+    packet.assign(MAGIC.begin(), MAGIC.end());
+    packet.push_back(type);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string FrameStreamer::start(const string& target)
+{
+  const size_t colon = target.find_last_of(':');
+  if(colon == string::npos || colon == 0)
+    return "Stream target must be given as host:port";
+
+  const int port = BSPF::stringToInt(target.substr(colon + 1));
+  if(port <= 0 || port > 65535)
+    return "Invalid stream port";
+
+  // Any local port will do, the spectator only listens
+  if(!mySocket.open(0, target.substr(0, colon), uInt16(port)))
+    return "Stream: cannot resolve '" + target.substr(0, colon) + "'";
+
+  myLastFrame.assign(size_t(WIDTH) * TIAConstants::frameBufferHeight, 0);
+  myLastHeight = 0;
+  myFrame = 0;
+  myPacket.reserve(MAX_PACKET_SIZE);
+  myAudioPacket.reserve(MAX_PACKET_SIZE);
+
+  return EmptyString;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameStreamer::sendFrame(const uInt8* frame, uInt32 height,
+                              const PaletteArray& palette)
+{
+  if(!mySocket.isOpen())
+    return;
+
+  height = std::min(height, TIAConstants::frameBufferHeight);
+
+  // A new size invalidates everything the spectator has
+  const bool full = height != myLastHeight;
+  myLastHeight = height;
+
+  if(full || palette != myLastPalette || myFrame % REFRESH_FRAMES == 0)
+    sendPalette(palette);
+
+  startFramePacket(height);
+
+  const uInt32 refresh = myFrame % REFRESH_FRAMES;
+  for(uInt32 y = 0; y < height; ++y)
+  {
+    const uInt8* pixels = frame + y * WIDTH;
+    uInt8* last = myLastFrame.data() + y * WIDTH;
+
+    if(!full && y % REFRESH_FRAMES != refresh &&
+       std::equal(pixels, pixels + WIDTH, last))
+      continue;
+
+    std::copy_n(pixels, WIDTH, last);
+    addLine(y, pixels, height);
+  }
+
+  // Always sent, so the spectator knows when to present the frame
+  sendFramePacket(true);
+  ++myFrame;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameStreamer::consume(const Int16* fragment, uInt32 size, bool stereo)
+{
+  if(!mySocket.isOpen())
+    return;
+
+  const uInt32 channels = stereo ? 2 : 1;
+  constexpr size_t HEADER_SIZE = MAGIC.size() + 1 + 4 + 4 + 1 + 2;
+  const uInt32 maxSamples = uInt32((MAX_PACKET_SIZE - HEADER_SIZE) / (2 * channels));
+
+  // Large fragments are split
+  while(size > 0)
+  {
+    const uInt32 samples = std::min(size, maxSamples);
+
+    startPacket(myAudioPacket, uInt8(PacketType::Audio));
+    putInt(myAudioPacket, myAudioPackets++);
+    putInt(myAudioPacket, mySampleRate);
+    myAudioPacket.push_back(uInt8(channels));
+    putShort(myAudioPacket, samples);
+    for(uInt32 i = 0; i < samples * channels; ++i)
+      putShort(myAudioPacket, uInt16(fragment[i]));
+
+    mySocket.send(myAudioPacket.data(), myAudioPacket.size());
+
+    fragment += samples * channels;
+    size -= samples;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameStreamer::sendPalette(const PaletteArray& palette)
+{
+  myLastPalette = palette;
+
+  startPacket(myPacket, uInt8(PacketType::Palette));
+  for(const uInt32 rgb: palette)
+  {
+    myPacket.push_back(static_cast<uInt8>(rgb >> 16));
+    myPacket.push_back(static_cast<uInt8>(rgb >> 8));
+    myPacket.push_back(static_cast<uInt8>(rgb));
+  }
+  mySocket.send(myPacket.data(), myPacket.size());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameStreamer::addLine(uInt32 line, const uInt8* pixels, uInt32 height)
+{
+  if(myPacket.size() + MAX_LINE_SIZE > MAX_PACKET_SIZE)
+  {
+    sendFramePacket(false);
+    startFramePacket(height);
+  }
+
+  putShort(myPacket, line);
+
+  // Try run-length encoding first, and fall back to raw pixels as soon as
+  // that turns out to be shorter
+  const size_t start = myPacket.size();
+  myPacket.push_back(uInt8(Encoding::RLE));
+  for(uInt32 x = 0; x < WIDTH && myPacket.size() - start <= WIDTH; )
+  {
+    const uInt8 pixel = pixels[x];
+    uInt32 run = 0;
+    for(; x < WIDTH && pixels[x] == pixel && run < 255; ++x, ++run);
+
+    myPacket.push_back(uInt8(run));
+    myPacket.push_back(pixel);
+  }
+
+  if(myPacket.size() - start > WIDTH)
+  {
+    myPacket.resize(start);
+    myPacket.push_back(uInt8(Encoding::Raw));
+    myPacket.insert(myPacket.end(), pixels, pixels + WIDTH);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameStreamer::startFramePacket(uInt32 height)
+{
+  startPacket(myPacket, uInt8(PacketType::Frame));
+  putInt(myPacket, myFrame);
+  putShort(myPacket, height);
+  myPacket.push_back(0);  // flags
+
+  myPacketHeaderSize = myPacket.size();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameStreamer::sendFramePacket(bool last)
+{
+  if(last)
+    myPacket[myPacketHeaderSize - 1] |= 0x01;
+
+  mySocket.send(myPacket.data(), myPacket.size());
+}
@@ -0,0 +1,143 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef FRAME_STREAMER_HXX
+#define FRAME_STREAMER_HXX
+
+#include <atomic>
+
+#include "bspf.hxx"
+#include "Audio.hxx"
+#include "FrameBufferConstants.hxx"
+#include "UdpSocket.hxx"
+
+/**
+  Streams the emulation to a remote spectator over UDP: the indexed TIA
+  frames, the palette and the audio fragments, at a fraction of the
+  bandwidth and CPU a video codec would need.
+
+  Each frame is compared line by line with the previous one, and only the
+  changed lines are sent, each either raw or run-length encoded, whatever
+  is shorter.  As datagrams may get lost, a rotating subset of the lines
+  is resent every frame (so the complete picture is refreshed every
+  REFRESH_FRAMES frames), and the palette every REFRESH_FRAMES frames as
+  well.  Packets are self-contained, a lost one only delays the lines it
+  carried.
+
+  All packets start with the 4 byte magic "STFS" and a type byte;
+  integers are little endian:
+
+    Frame    (1): frame number (4), height (2), flags (1; bit 0 marks the
+                  last packet of the frame), followed by lines: line
+                  number (2), encoding (1; 0 = 160 raw pixels, 1 = pairs
+                  of count and pixel, summing up to 160 pixels)
+    Palette  (2): 256 RGB triplets for the TIA palette indices
+    Audio    (3): packet number (4), sample rate (4), channels (1),
+                  samples per channel (2), followed by the 16 bit samples
+                  (interleaved for stereo)
+
+  Frames are sent from the main thread, audio from the thread running the
+  emulation (the socket is only used for sending, which is safe).
+
+  @author  Stella Team
+*/
+class FrameStreamer : public AudioSink
+{
+  public:
+    FrameStreamer() = default;
+    ~FrameStreamer() override = default;
+
+    /**
+      Open a socket for streaming to the given spectator.
+
+      @param target  The spectator as host:port
+
+      @return  An error message, or an empty string on success
+    */
+    string start(const string& target);
+
+    /**
+      Send the changes of the given frame, and the palette if necessary.
+
+      @param frame    The frame (TIA palette indices, 160 pixels per line)
+      @param height   The number of lines of the frame
+      @param palette  The RGB palette (0x00RRGGBB)
+    */
+    void sendFrame(const uInt8* frame, uInt32 height, const PaletteArray& palette);
+
+    /**
+      The sample rate reported with the audio fragments.
+    */
+    void setSampleRate(uInt32 rate) { mySampleRate = rate; }
+
+    /**
+      Send an audio fragment (AudioSink method).
+    */
+    void consume(const Int16* fragment, uInt32 size, bool stereo) override;
+
+  private:
+    enum class PacketType: uInt8 { Frame = 1, Palette = 2, Audio = 3 };
+
+    enum class Encoding: uInt8 { Raw = 0, RLE = 1 };
+
+    // Keeps the datagrams below the usual MTU
+    static constexpr size_t MAX_PACKET_SIZE = 1400;
+
+    // Frames until every line (and the palette) has been resent
+    static constexpr uInt32 REFRESH_FRAMES = 30;
+
+  private:
+    void sendPalette(const PaletteArray& palette);
+
+    /**
+      Append the encoded line to the frame packet, sending the packet first
+      if it's full.
+    */
+    void addLine(uInt32 line, const uInt8* pixels, uInt32 height);
+
+    void startFramePacket(uInt32 height);
+    void sendFramePacket(bool last);
+
+  private:
+    UdpSocket mySocket;
+
+    uInt32 myFrame{0};
+
+    // The last frame sent, to find the changed lines
+    ByteArray myLastFrame;
+    uInt32 myLastHeight{0};
+
+    PaletteArray myLastPalette{0};
+
+    // The frame packet under construction
+    vector<uInt8> myPacket;
+    size_t myPacketHeaderSize{0};
+
+    // Audio is sent from the emulation thread
+    vector<uInt8> myAudioPacket;
+    uInt32 myAudioPackets{0};
+    std::atomic<uInt32> mySampleRate{0};
+
+  private:
+    // Following constructors and assignment operators not supported
+    FrameStreamer(const FrameStreamer&) = delete;
+    FrameStreamer(FrameStreamer&&) = delete;
+    FrameStreamer& operator=(const FrameStreamer&) = delete;
+    FrameStreamer& operator=(FrameStreamer&&) = delete;
+};
+
+#endif // FRAME_STREAMER_HXX
@@ -96,30 +96,46 @@ const json HighScoresManager::properties(const Properties& props) const
 
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-json HighScoresManager::properties(json& jprops) const
+bool HighScoresManager::enabled() const
+{
+  return definition().enabled;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const HighScoresManager::Definition& HighScoresManager::definition() const
 {
   Properties props;
+  const Properties* current = &props;
 
   if(myOSystem.hasConsole())
-  {
-    props = myOSystem.console().properties();
-  }
+    current = &myOSystem.console().properties();
   else
   {
     const string& md5 = myOSystem.launcher().selectedRomMD5();
     myOSystem.propSet().getMD5(md5, props);
   }
 
-  return jprops = properties(props);
-}
-
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool HighScoresManager::enabled() const
-{
-  json hsProp;
+  const string& property = current->get(PropType::Cart_Highscore);
+  if(!myDefinition.parsed || property != myDefinition.property)
+  {
+    myDefinition = Definition();
+    myDefinition.parsed = true;
+    myDefinition.property = property;
+    try
+    {
+      const json jprops = properties(*current);
 
-  return properties(hsProp).contains(SCORE_ADDRESSES);
+      parse(jprops, myDefinition.numVariations, myDefinition.info);
+      myDefinition.enabled = jprops.contains(SCORE_ADDRESSES);
+    }
+    catch(...)
+    {
+      // Invalid definitions are treated like missing ones
+      myDefinition.info = ScoresProps();
+      parse(json::array(), myDefinition.numVariations, myDefinition.info);
+    }
+  }
+  return myDefinition;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -133,8 +149,15 @@ uInt32 HighScoresManager::numVariations(const json& jprops) const
 bool HighScoresManager::get(const Properties& props, uInt32& numVariationsR,
                             ScoresProps& info) const
 {
-  json jprops = properties(props);
+  parse(properties(props), numVariationsR, info);
 
+  return enabled();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void HighScoresManager::parse(const json& jprops, uInt32& numVariationsR,
+                              ScoresProps& info) const
+{
   numVariationsR = numVariations(jprops);
 
   info.numDigits = numDigits(jprops);
@@ -152,8 +175,6 @@ bool HighScoresManager::get(const Properties& props, uInt32& numVariationsR,
   info.specialAddr = specialAddress(jprops);
 
   info.scoreAddr = getPropScoreAddr(jprops);
-
-  return enabled();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -278,31 +299,21 @@ uInt16 HighScoresManager::specialAddress(const json& jprops) const
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 HighScoresManager::numAddrBytes(Int32 digits, Int32 trailing) const
+uInt32 HighScoresManager::numAddrBytes(Int32 digits, Int32 trailing)
 {
   return (digits - trailing + 1) / 2;
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 HighScoresManager::numAddrBytes(const json& jprops) const
-{
-  return numAddrBytes(numDigits(jprops), trailingZeroes(jprops));
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Int32 HighScoresManager::numVariations() const
 {
-  json jprops;
-
-  return numVariations(properties(jprops));
+  return definition().numVariations;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 const string HighScoresManager::specialLabel() const
 {
-  json jprops;
-
-  return specialLabel(properties(jprops));
+  return definition().info.special;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -320,17 +331,17 @@ Int32 HighScoresManager::variation(uInt16 addr, bool varBCD, bool zeroBased,
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Int32 HighScoresManager::variation() const
 {
-  json jprops;
-  uInt16 addr = varAddress(properties(jprops));
+  const Definition& def = definition();
+  uInt16 addr = def.info.varsAddr;
 
   if(addr == DEFAULT_ADDRESS) {
-    if(numVariations() == 1)
+    if(def.numVariations == 1)
       return DEFAULT_VARIATION;
     else
       return NO_VALUE;
   }
 
-  return variation(addr, varBCD(jprops), varZeroBased(jprops), numVariations(jprops));
+  return variation(addr, def.info.varsBCD, def.info.varsZeroBased, def.numVariations);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -340,6 +351,25 @@ Int32 HighScoresManager::score(uInt32 numAddrBytes, uInt32 trailingZeroes,
   if (!myOSystem.hasConsole())
     return NO_VALUE;
 
+  return score(numAddrBytes, trailingZeroes, isBCD, scoreAddr,
+               [this](uInt16 addr) { return peek(addr); });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 HighScoresManager::score(const ScoresProps& info, const PeekFunc& peek)
+{
+  const uInt32 numBytes = numAddrBytes(info.numDigits, info.trailingZeroes);
+
+  if(uInt32(info.scoreAddr.size()) < numBytes)
+    return NO_VALUE;
+  return score(numBytes, info.trailingZeroes, info.scoreBCD, info.scoreAddr, peek);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 HighScoresManager::score(uInt32 numAddrBytes, uInt32 trailingZeroes,
+                               bool isBCD, const ScoreAddresses& scoreAddr,
+                               const PeekFunc& peek)
+{
   Int32 totalScore = 0;
 
   for (uInt32 b = 0; b < numAddrBytes; ++b)
@@ -369,13 +399,12 @@ Int32 HighScoresManager::score(uInt32 numAddrBytes, uInt32 trailingZeroes,
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Int32 HighScoresManager::score() const
 {
-  json jprops;
-  uInt32 numBytes = numAddrBytes(properties(jprops));
-  const ScoreAddresses scoreAddr = getPropScoreAddr(jprops);
+  const ScoresProps& info = definition().info;
+  uInt32 numBytes = numAddrBytes(info.numDigits, info.trailingZeroes);
 
-  if(uInt32(scoreAddr.size()) < numBytes)
+  if(uInt32(info.scoreAddr.size()) < numBytes)
     return NO_VALUE;
-  return score(numBytes, trailingZeroes(jprops), scoreBCD(jprops), scoreAddr);
+  return score(numBytes, info.trailingZeroes, info.scoreBCD, info.scoreAddr);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -385,10 +414,10 @@ const string HighScoresManager::formattedScore(Int32 score, Int32 width) const
     return "";
 
   ostringstream buf;
-  json jprops;
-  Int32 digits = numDigits(properties(jprops));
+  const ScoresProps& info = definition().info;
+  Int32 digits = info.numDigits;
 
-  if(scoreBCD(jprops))
+  if(info.scoreBCD)
   {
     if(width > digits)
       digits = width;
@@ -405,31 +434,28 @@ const string HighScoresManager::formattedScore(Int32 score, Int32 width) const
 
 string HighScoresManager::md5Props() const
 {
-  json jprops;
-  properties(jprops);
+  const Definition& def = definition();
+  const ScoresProps& info = def.info;
   ostringstream buf;
 
-  buf << varAddress(jprops) << numVariations() << varBCD(jprops)
-    << varZeroBased(jprops);
+  buf << info.varsAddr << Int32(def.numVariations) << info.varsBCD
+    << info.varsZeroBased;
 
-  uInt32 addrBytes = numAddrBytes(jprops);
-  HSM::ScoreAddresses addr = getPropScoreAddr(jprops);
+  uInt32 addrBytes = numAddrBytes(info.numDigits, info.trailingZeroes);
   for(uInt32 a = 0; a < addrBytes; ++a)
-    buf << addr[a];
-  buf << numDigits(jprops) << trailingZeroes(jprops) << scoreBCD(jprops)
-    << scoreInvert(jprops) << specialAddress(jprops) << specialBCD(jprops)
-    << specialZeroBased(jprops);
+    buf << info.scoreAddr[a];
+  buf << info.numDigits << info.trailingZeroes << info.scoreBCD
+    << info.scoreInvert << info.specialAddr << info.specialBCD
+    << info.specialZeroBased;
 
-  buf << specialAddress(jprops) << specialBCD(jprops) << specialZeroBased(jprops);
+  buf << info.specialAddr << info.specialBCD << info.specialZeroBased;
 
   return MD5::hash(buf.str());
 }
 
 bool HighScoresManager::scoreInvert() const
 {
-  json jprops;
-
-  return scoreInvert(properties(jprops));
+  return definition().info.scoreInvert;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -438,18 +464,18 @@ Int32 HighScoresManager::special() const
   if(!myOSystem.hasConsole())
     return NO_VALUE;
 
-  json jprops;
-  uInt16 addr = specialAddress(properties(jprops));
+  const ScoresProps& info = definition().info;
+  uInt16 addr = info.specialAddr;
 
   if (addr == DEFAULT_ADDRESS)
     return NO_VALUE;
 
   Int32 var = peek(addr);
 
-  if(specialBCD(jprops))
+  if(info.specialBCD)
     var = fromBCD(var);
 
-  var += specialZeroBased(jprops) ? 1 : 0;
+  var += info.specialZeroBased ? 1 : 0;
 
   return var;
 }
@@ -457,9 +483,7 @@ Int32 HighScoresManager::special() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 const string HighScoresManager::notes() const
 {
-  json jprops;
-
-  return notes(properties(jprops));
+  return definition().info.notes;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -555,7 +579,7 @@ uInt16 HighScoresManager::fromHexStr(const string& addr) const
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Int32 HighScoresManager::fromBCD(uInt8 bcd) const
+Int32 HighScoresManager::fromBCD(uInt8 bcd)
 {
   // verify if score is legit
   if ((bcd & 0xF0) >= 0xA0 || (bcd & 0xF) >= 0xA)
@@ -123,6 +123,18 @@ class HighScoresManager
     Int32 score(uInt32 numAddrBytes, uInt32 trailingZeroes, bool isBCD,
                 const HSM::ScoreAddresses& scoreAddr) const;
 
+    // Reads a byte of the emulated memory
+    using PeekFunc = std::function<Int16(uInt16)>;
+
+    /**
+      Calculate the score of the given definition, reading the memory
+      through the given function.  This allows scoring consoles other than
+      the current one (e.g. HeadlessConsole, see StateSearch).
+
+      @return The score or -1 if no valid data exists
+    */
+    static Int32 score(const HSM::ScoresProps& info, const PeekFunc& peek);
+
     // Convert the given value, using only the maximum bits required by maxVal
     //  and adjusted for BCD and zero based data
     Int32 convert(Int32 val, uInt32 maxVal, bool isBCD, bool zeroBased) const;
@@ -132,7 +144,7 @@ class HighScoresManager
 
       @return The number of score address bytes
     */
-    uInt32 numAddrBytes(Int32 digits, Int32 trailing) const;
+    static uInt32 numAddrBytes(Int32 digits, Int32 trailing);
 
     // Retrieve current values (using game's properties)
     Int32 numVariations() const;
@@ -212,12 +224,17 @@ class HighScoresManager
     bool specialZeroBased(const json& jprops) const;
     const string notes(const json& jprops) const;
 
-    // Calculate the number of bytes for one player's score from property parameters
-    uInt32 numAddrBytes(const json& jprops) const;
+    // Parse the highscore definition from properties
+    void parse(const json& jprops, uInt32& numVariations,
+               HSM::ScoresProps& info) const;
+
+    // Get the parsed highscore definition of the current game; the
+    // definition is only parsed again when the properties change
+    struct Definition;
+    const Definition& definition() const;
 
     // Get properties
     const json properties(const Properties& props) const;
-    json properties(json& jprops) const;
 
     // Get value from highscore properties for given key
     bool getPropBool(const json& jprops, const string& key,
@@ -231,7 +248,7 @@ class HighScoresManager
     const HSM::ScoreAddresses getPropScoreAddr(const json& jprops) const;
 
     uInt16 fromHexStr(const string& addr) const;
-    Int32 fromBCD(uInt8 bcd) const;
+    static Int32 fromBCD(uInt8 bcd);
     string hash(const HSM::ScoresData& data) const;
 
     /**
@@ -244,6 +261,9 @@ class HighScoresManager
     */
     bool load(const json& hsData, HSM::ScoresData& scores);
 
+    static Int32 score(uInt32 numAddrBytes, uInt32 trailingZeroes, bool isBCD,
+                       const HSM::ScoreAddresses& scoreAddr, const PeekFunc& peek);
+
     void clearHighScores(HSM::ScoresData& data);
 
   private:
@@ -253,6 +273,17 @@ class HighScoresManager
     shared_ptr<CompositeKeyValueRepositoryAtomic> myHighscoreRepository
       = make_shared<CompositeKeyValueRepositoryNoop>();
 
+    // A parsed highscore definition, so that polling the scores during
+    // emulation doesn't have to parse JSON
+    struct Definition {
+      bool parsed{false};
+      string property;  // the property it was parsed from
+      bool enabled{false};
+      uInt32 numVariations{HSM::DEFAULT_VARIATION};
+      HSM::ScoresProps info;
+    };
+    mutable Definition myDefinition;
+
   private:
     // Following constructors and assignment operators not supported
     HighScoresManager() = delete;
@@ -25,6 +25,14 @@ using json = nlohmann::json;
 void JoyMap::add(const Event::Type event, const JoyMapping& mapping)
 {
   myMap[mapping] = event;
+  setLookup(mapping, event);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void JoyMap::add(const JoyMappingList& mappings)
+{
+  for(const auto& [_mapping, _event]: mappings)
+    add(_event, _mapping);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -46,6 +54,7 @@ void JoyMap::add(const Event::Type event, const EventMode mode, const int button
 void JoyMap::erase(const JoyMapping& mapping)
 {
   myMap.erase(mapping);
+  setLookup(mapping, Event::NoType);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -65,20 +74,26 @@ void JoyMap::erase(const EventMode mode, const int button,
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Event::Type JoyMap::get(const JoyMapping& mapping) const
 {
-  auto find = myMap.find(mapping);
-  if(find != myMap.end())
-    return find->second;
+  const std::vector<Event::Type>& lookup = myLookup[size_t(mapping.mode)];
+  const auto find = [&](const JoyMapping& m) {
+    const int index = lookupIndex(m);
+    if(index >= 0)
+      return lookup.empty() ? Event::Type::NoType : lookup[index];
+
+    const auto it = myMap.find(m);
+    return it != myMap.end() ? it->second : Event::Type::NoType;
+  };
+
+  const Event::Type event = find(mapping);
+  if(event != Event::Type::NoType || mapping.button == JOY_CTRL_NONE)
+    return event;
 
   // try without button as modifier
   JoyMapping m = mapping;
 
   m.button = JOY_CTRL_NONE;
 
-  find = myMap.find(m);
-  if(find != myMap.end())
-    return find->second;
-
-  return Event::Type::NoType;
+  return find(m);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -95,6 +110,46 @@ Event::Type JoyMap::get(const EventMode mode, const int button,
   return get(JoyMapping(mode, button, hat, hdir));
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int JoyMap::lookupIndex(const JoyMapping& m)
+{
+  if(m.button < JOY_CTRL_NONE || m.button >= LOOKUP_BUTTONS)
+    return -1;
+
+  int control = -1;
+
+  if(m.hat == JOY_CTRL_NONE && m.hdir == JoyHatDir::CENTER)
+  {
+    if(m.axis == JoyAxis::NONE && m.adir == JoyDir::NONE)
+      control = 0;
+    else if(int(m.axis) >= 0 && int(m.axis) < LOOKUP_AXES)
+      control = 1 + int(m.axis) * 4 + int(m.adir) + 1;
+  }
+  else if(m.axis == JoyAxis::NONE && m.adir == JoyDir::NONE
+          && m.hat >= 0 && m.hat < LOOKUP_HATS)
+    control = 1 + LOOKUP_AXES * 4 + m.hat * 5 + int(m.hdir);
+
+  return control < 0 ? -1 : (m.button + 1) * LOOKUP_CONTROLS + control;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void JoyMap::setLookup(const JoyMapping& m, Event::Type event)
+{
+  const int index = lookupIndex(m);
+  if(index < 0)
+    return;
+
+  std::vector<Event::Type>& lookup = myLookup[size_t(m.mode)];
+
+  if(lookup.empty())
+  {
+    if(event == Event::Type::NoType)
+      return;
+    lookup.resize((LOOKUP_BUTTONS + 1) * LOOKUP_CONTROLS, Event::Type::NoType);
+  }
+  lookup[index] = event;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool JoyMap::check(const JoyMapping& mapping) const
 {
@@ -187,10 +242,27 @@ JoyMap::JoyMappingArray JoyMap::getEventMapping(const Event::Type event, const E
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-json JoyMap::saveMapping(const EventMode mode) const
+JoyMap::JoyMappingList JoyMap::getMappings() const
+{
+  JoyMappingList mappings;
+  mappings.reserve(myMap.size());
+
+  for(const auto& [_mapping, _event]: myMap)
+    if(_event != Event::NoType)
+      mappings.emplace_back(_mapping, _event);
+
+  return mappings;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+json JoyMap::saveMapping(const JoyMappingList& mappings, const EventMode mode)
 {
   using MapType = std::pair<JoyMapping, Event::Type>;
-  std::vector<MapType> sortedMap(myMap.begin(), myMap.end());
+  std::vector<MapType> sortedMap;
+
+  for(const auto& mapping: mappings)
+    if(mapping.first.mode == mode)
+      sortedMap.push_back(mapping);
 
   std::sort(sortedMap.begin(), sortedMap.end(),
             [](const MapType& a, const MapType& b)
@@ -243,7 +315,8 @@ json JoyMap::saveMapping(const EventMode mode) const
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-int JoyMap::loadMapping(const json& eventMappings, const EventMode mode)
+int JoyMap::parseMapping(const json& eventMappings, const EventMode mode,
+                         JoyMappingList& mappings)
 {
   int i = 0;
 
@@ -259,14 +332,9 @@ int JoyMap::loadMapping(const json& eventMappings, const EventMode mode)
       if(eventMapping.at("event").get<Event::Type>() == Event::NoType)
         continue;
 
-      add(
-        eventMapping.at("event").get<Event::Type>(),
-        mode,
-        button,
-        axis,
-        axisDirection,
-        hat,
-        hatDirection
+      mappings.emplace_back(
+        JoyMapping(mode, button, axis, axisDirection, hat, hatDirection),
+        eventMapping.at("event").get<Event::Type>()
       );
 
       i++;
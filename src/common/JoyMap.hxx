@@ -18,6 +18,7 @@
 #ifndef CONTROLLERMAP_HXX
 #define CONTROLLERMAP_HXX
 
+#include <array>
 #include <unordered_map>
 
 #include "Event.hxx"
@@ -75,6 +76,8 @@ class JoyMap
       }
     };
     using JoyMappingArray = std::vector<JoyMapping>;
+    // Mappings together with their events, in no particular order
+    using JoyMappingList = std::vector<std::pair<JoyMapping, Event::Type>>;
 
     JoyMap() = default;
 
@@ -86,6 +89,9 @@ class JoyMap
     void add(const Event::Type event, const EventMode mode, const int button,
              const int hat, const JoyHatDir hdir);
 
+    /** Add all given mappings */
+    void add(const JoyMappingList& mappings);
+
     /** Erase mapping */
     void erase(const JoyMapping& mapping);
     void erase(const EventMode mode, const int button,
@@ -111,8 +117,14 @@ class JoyMap
 
     JoyMappingArray getEventMapping(const Event::Type event, const EventMode mode) const;
 
-    nlohmann::json saveMapping(const EventMode mode) const;
-    int loadMapping(const nlohmann::json& eventMappings, const EventMode mode);
+    /** Get all mappings (of all modes) */
+    JoyMappingList getMappings() const;
+
+    /** Encode the given mode's mappings from the list */
+    static nlohmann::json saveMapping(const JoyMappingList& mappings, const EventMode mode);
+    /** Decode mappings of the given mode, and append them to the list */
+    static int parseMapping(const nlohmann::json& eventMappings, const EventMode mode,
+                            JoyMappingList& mappings);
 
     static nlohmann::json convertLegacyMapping(string list);
 
@@ -127,6 +139,11 @@ class JoyMap
   private:
     string getDesc(const Event::Type event, const JoyMapping& mapping) const;
 
+    /** Index of a mapping in its mode's lookup table, -1 if not stored there */
+    static int lookupIndex(const JoyMapping& m);
+    /** Update the lookup table for a mapping */
+    void setLookup(const JoyMapping& m, Event::Type event);
+
     struct JoyHash {
       size_t operator()(const JoyMapping& m)const {
         return std::hash<uInt64>()((uInt64(m.mode)) // 3 bits
@@ -142,6 +159,15 @@ class JoyMap
 
     std::unordered_map<JoyMapping, Event::Type, JoyHash> myMap;
 
+    // The mappings of the first LOOKUP_BUTTONS buttons, used alone or as a
+    // modifier of the first LOOKUP_AXES axes or LOOKUP_HATS hats, are copied
+    // into one flat table per mode, so that get() doesn't need to hash while
+    // handling events (the tables are only allocated for modes which have
+    // such mappings, all other mappings are only found in 'myMap')
+    static constexpr int LOOKUP_BUTTONS = 32, LOOKUP_AXES = 4, LOOKUP_HATS = 4;
+    static constexpr int LOOKUP_CONTROLS = 1 + LOOKUP_AXES * 4 + LOOKUP_HATS * 5;
+    std::array<std::vector<Event::Type>, size_t(EventMode::kNumModes)> myLookup;
+
     // Following constructors and assignment operators not supported
     JoyMap(const JoyMap&) = delete;
     JoyMap(JoyMap&&) = delete;
@@ -71,7 +71,10 @@ namespace {
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void KeyMap::add(const Event::Type event, const Mapping& mapping)
 {
-  myMap[convertMod(mapping)] = event;
+  const Mapping m = convertMod(mapping);
+
+  myMap[m] = event;
+  setLookup(m, event);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -83,7 +86,10 @@ void KeyMap::add(const Event::Type event, const EventMode mode, const int key, c
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void KeyMap::erase(const Mapping& mapping)
 {
-  myMap.erase(convertMod(mapping));
+  const Mapping m = convertMod(mapping);
+
+  myMap.erase(m);
+  setLookup(m, Event::NoType);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -96,22 +102,22 @@ void KeyMap::erase(const EventMode mode, const int key, const int mod)
 Event::Type KeyMap::get(const Mapping& mapping) const
 {
   Mapping m = convertMod(mapping);
+  const std::vector<Event::Type>& lookup = myLookup[size_t(m.mode)];
+
+  if(lookup.empty() || uInt32(m.key) >= KBDK_LAST)
+    return Event::Type::NoType;
 
   if(myModEnabled)
   {
-    auto find = myMap.find(m);
-    if(find != myMap.end())
-      return find->second;
+    const Event::Type event = lookup[lookupIndex(m)];
+    if(event != Event::Type::NoType)
+      return event;
   }
 
   // mapping not found, try without modifiers
   m.mod = StellaMod(0);
 
-  auto find = myMap.find(m);
-  if(find != myMap.end())
-    return find->second;
-
-  return Event::Type::NoType;
+  return lookup[lookupIndex(m)];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -335,6 +341,23 @@ void KeyMap::eraseEvent(const Event::Type event, const EventMode mode)
     else item++;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void KeyMap::setLookup(const Mapping& m, Event::Type event)
+{
+  if(uInt32(m.key) >= KBDK_LAST)
+    return;
+
+  std::vector<Event::Type>& lookup = myLookup[size_t(m.mode)];
+
+  if(lookup.empty())
+  {
+    if(event == Event::Type::NoType)
+      return;
+    lookup.resize(size_t(KBDK_LAST) << 4, Event::Type::NoType);
+  }
+  lookup[lookupIndex(m)] = event;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 KeyMap::Mapping KeyMap::convertMod(const Mapping& mapping) const
 {
@@ -18,6 +18,7 @@
 #ifndef KEYMAP_HXX
 #define KEYMAP_HXX
 
+#include <array>
 #include <unordered_map>
 #include "Event.hxx"
 #include "EventHandlerConstants.hxx"
@@ -106,6 +107,17 @@ class KeyMap
     //** Convert modifiers */
     Mapping convertMod(const Mapping& mapping) const;
 
+    /** Index of a converted mapping in its mode's lookup table */
+    static size_t lookupIndex(const Mapping& m) {
+      return (size_t(m.key) << 4)
+        | ((m.mod & KBDM_SHIFT) ? 1 : 0)
+        | ((m.mod & KBDM_ALT  ) ? 2 : 0)
+        | ((m.mod & KBDM_GUI  ) ? 4 : 0)
+        | ((m.mod & KBDM_CTRL ) ? 8 : 0);
+    }
+    /** Update the lookup table for a converted mapping */
+    void setLookup(const Mapping& m, Event::Type event);
+
     struct KeyHash {
       size_t operator()(const Mapping& m) const {
         return std::hash<uInt64>()((uInt64(m.mode))     // 3 bits
@@ -121,6 +133,11 @@ class KeyMap
 
     std::unordered_map<Mapping, Event::Type, KeyHash> myMap;
 
+    // A copy of the mappings as one flat table per mode, indexed by key and
+    // modifiers, so that get() doesn't need to hash while handling events
+    // (the tables are only allocated for modes which have mappings)
+    std::array<std::vector<Event::Type>, size_t(EventMode::kNumModes)> myLookup;
+
     // Indicates whether the key-combos tied to a modifier key are
     // being used or not (e.g. Ctrl by default is the fire button,
     // pressing it with a movement key could inadvertantly activate
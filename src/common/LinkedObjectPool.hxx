@@ -18,21 +18,28 @@
 #ifndef LINKED_OBJECT_POOL_HXX
 #define LINKED_OBJECT_POOL_HXX
 
-#include <list>
+#include <iterator>
+
 #include "bspf.hxx"
 
 /**
-  A fixed-size object-pool based doubly-linked list that makes use of
-  multiple STL lists, to reduce frequent (de)allocations.
+  A fixed-size object-pool based doubly-linked list, which never
+  (de)allocates nodes once it has been sized.
 
   This structure can be used as either a stack or queue, but also allows
   for removal at any location in the list.
 
-  There are two internal lists; one stores active nodes, and the other
-  stores pool nodes that have been 'deleted' from the active list (note
-  that no actual deletion takes place; nodes are simply moved from one list
-  to another).  Similarly, when a new node is added to the active list, it
-  is simply moved from the pool list to the active list.
+  All nodes live in one contiguous array of CAPACITY slots.  A ring of slot
+  indices defines the order of the list; the active nodes occupy a
+  contiguous range of the ring, the remaining entries are the pool of
+  unused slots.  Adding or removing nodes at either end of the list only
+  moves the bounds of that range, removing a node in the middle shifts
+  the (small) slot indices behind it, but never the nodes themselves.
+
+  Iterators address a node by its position in the list, so looking up a
+  node or the position of 'current' happens in constant time.  As with an
+  STL vector, removing a node invalidates the iterators to the nodes
+  behind it.
 
   In all cases, the variable 'myCurrent' is updated to point to the
   current node.
@@ -40,11 +47,6 @@
   NOTE: You must always call 'currentIsValid()' before calling 'current()',
         to make sure that the return value is a valid reference.
 
-        In the case of methods which wrap the C++ 'splice()' method, the
-        semantics of splice are followed wrt invalid/out-of-range/etc
-        iterators.  See the applicable C++ STL documentation for such
-        behaviour.
-
   @author Stephen Anthony
 */
 namespace Common {
@@ -53,8 +55,42 @@ template <typename T, uInt32 CAPACITY = 100>
 class LinkedObjectPool
 {
   public:
-    using iter = typename std::list<T>::iterator;
-    using const_iter = typename std::list<T>::const_iterator;
+    /**
+      Bidirectional iterator over the nodes of the active list.
+    */
+    class const_iter
+    {
+      public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iter() = default;
+        const_iter(const LinkedObjectPool* pool, uInt32 pos)
+          : myPool{pool}, myPos{pos} { }
+
+        reference operator*() const  { return myPool->node(myPos); }
+        pointer operator->() const   { return &myPool->node(myPos); }
+
+        const_iter& operator++()   { ++myPos; return *this; }
+        const_iter& operator--()   { --myPos; return *this; }
+        const_iter operator++(int) { const_iter i = *this; ++myPos; return i; }
+        const_iter operator--(int) { const_iter i = *this; --myPos; return i; }
+
+        bool operator==(const const_iter& i) const { return myPos == i.myPos; }
+        bool operator!=(const const_iter& i) const { return myPos != i.myPos; }
+
+        // Distance between two iterators, in constant time
+        difference_type operator-(const const_iter& i) const {
+          return difference_type(myPos) - difference_type(i.myPos);
+        }
+
+      private:
+        const LinkedObjectPool* myPool{nullptr};
+        uInt32 myPos{0};
+    };
 
     /*
       Create a pool of size CAPACITY; the active list starts out empty.
@@ -68,29 +104,26 @@ class LinkedObjectPool
 
       Make sure to call 'currentIsValid()' before accessing this method.
     */
-    T& current() const { return *myCurrent; }
+    T& current() { return mySlots[slot(myCurrent)]; }
+    const T& current() const { return mySlots[slot(myCurrent)]; }
 
     /**
-      Returns current's position in the list
-
-      SLOW, but only required for messages
+      Return an iterator to the node that the 'current' iterator points to.
     */
-    uInt32 currentIdx() const {
-      if(empty())
-        return 0;
-
-      iter it = myCurrent;
-      uInt32 idx = 1;
-
-      while(it-- != myList.begin()) ++idx;
-      return idx;
+    const_iter currentIter() const {
+      return const_iter(this, currentIsValid() ? myCurrent : mySize);
     }
 
+    /**
+      Returns current's position in the list (starting at 1)
+    */
+    uInt32 currentIdx() const { return currentIsValid() ? myCurrent + 1 : 0; }
+
     /**
       Does the 'current' iterator point to a valid node in the active list?
       This must be called before 'current()' is called.
     */
-    bool currentIsValid() const { return myCurrent != myList.end(); }
+    bool currentIsValid() const { return myCurrent < mySize; }
 
     /**
       Advance 'current' iterator to previous position in the active list.
@@ -98,7 +131,7 @@ class LinkedObjectPool
     */
     void moveToPrevious() {
       if(currentIsValid())
-        myCurrent = myCurrent == myList.begin() ? myList.end() : std::prev(myCurrent, 1);
+        myCurrent = myCurrent == 0 ? mySize : myCurrent - 1;
     }
 
     /**
@@ -107,7 +140,16 @@ class LinkedObjectPool
     */
     void moveToNext() {
       if(currentIsValid())
-        myCurrent = std::next(myCurrent, 1);
+        ++myCurrent;
+    }
+
+    /**
+      Move 'current' iterator to the given position in the active list
+      (starting at 0).  Invalid positions are ignored.
+    */
+    void moveTo(uInt32 pos) {
+      if(currentIsValid() && pos < mySize)
+        myCurrent = pos;
     }
 
     /**
@@ -115,7 +157,7 @@ class LinkedObjectPool
     */
     void moveToFirst() {
       if(currentIsValid())
-        myCurrent = myList.begin();
+        myCurrent = 0;
     }
 
     /**
@@ -123,48 +165,54 @@ class LinkedObjectPool
     */
     void moveToLast() {
       if(currentIsValid())
-        myCurrent = std::prev(myList.end(), 1);
+        myCurrent = mySize - 1;
     }
 
     /**
       Return an iterator to the first node in the active list.
     */
-    const_iter first() const { return myList.begin(); }
+    const_iter first() const { return const_iter(this, 0); }
 
     /**
       Return an iterator to the last node in the active list.
     */
-    const_iter last() const { return std::prev(myList.end(), 1); }
+    const_iter last() const { return const_iter(this, mySize - 1); }
+
+    /**
+      Return an iterator to the node at the given position (starting at 0).
+    */
+    const_iter at(uInt32 pos) const { return const_iter(this, pos); }
 
     /**
       Return an iterator to the previous node of 'i' in the active list.
     */
-    const_iter previous(const_iter i) const { return std::prev(i, 1); }
+    const_iter previous(const_iter i) const { return --i; }
 
     /**
       Return an iterator to the next node to 'current' in the active list.
     */
-    const_iter next(const_iter i) const { return std::next(i, 1); }
+    const_iter next(const_iter i) const { return ++i; }
 
     /**
       Canonical iterators from C++ STL.
     */
-    const_iter cbegin() const { return myList.cbegin(); }
-    const_iter cend() const   { return myList.cend();   }
+    const_iter cbegin() const { return const_iter(this, 0);      }
+    const_iter cend() const   { return const_iter(this, mySize); }
 
     /**
       Answer whether 'current' is at the specified iterator.
     */
-    bool atFirst() const { return myCurrent == first(); }
-    bool atLast() const  { return myCurrent == last();  }
+    bool atFirst() const { return currentIter() == first(); }
+    bool atLast() const  { return empty() || currentIter() == last(); }
 
     /**
       Add a new node at the beginning of the active list, and update 'current'
       to point to that node.
     */
     void addFirst() {
-      myList.splice(myList.begin(), myPool, myPool.begin());
-      myCurrent = myList.begin();
+      myHead = myHead == 0 ? myCapacity - 1 : myHead - 1;
+      ++mySize;
+      myCurrent = 0;
     }
 
     /**
@@ -172,8 +220,7 @@ class LinkedObjectPool
       to point to that node.
     */
     void addLast() {
-      myList.splice(myList.end(), myPool, myPool.begin());
-      myCurrent = std::prev(myList.end(), 1);
+      myCurrent = mySize++;
     }
 
     /**
@@ -181,10 +228,10 @@ class LinkedObjectPool
       happens to be the one removed.
     */
     void removeFirst() {
-      const_iter i = myList.cbegin();
-      myPool.splice(myPool.end(), myList, i);
-      if(myCurrent == i)  // did we just invalidate 'current'
-        moveToNext();     // if so, move to the next node
+      myHead = wrap(myHead + 1);
+      --mySize;
+      if(myCurrent > 0 && myCurrent <= mySize)
+        --myCurrent;      // 'current' either moved along or was the first node
     }
 
     /**
@@ -192,17 +239,16 @@ class LinkedObjectPool
       happens to be the one removed.
     */
     void removeLast() {
-      const_iter i = std::prev(myList.end(), 1);
-      myPool.splice(myPool.end(), myList, i);
-      if(myCurrent == i)  // did we just invalidate 'current'
-        moveToPrevious(); // if so, move to the previous node
+      if(myCurrent == mySize - 1)  // are we about to invalidate 'current'
+        moveToPrevious();           // if so, move to the previous node
+      --mySize;
     }
 
     /**
       Remove a single element from the active list at position of the iterator.
     */
     void remove(const_iter i) {
-      myPool.splice(myPool.end(), myList, i);
+      remove(uInt32(i - cbegin()));
     }
 
     /**
@@ -211,7 +257,15 @@ class LinkedObjectPool
       and so on).
     */
     void remove(uInt32 index) {
-      myPool.splice(myPool.end(), myList, std::next(myList.begin(), index));
+      // The slot of the removed node moves to the start of the pool
+      const uInt32 removed = slot(index);
+      for(uInt32 i = index + 1; i < mySize; ++i)
+        myRing[wrap(myHead + i - 1)] = slot(i);
+      myRing[wrap(myHead + mySize - 1)] = removed;
+
+      if(myCurrent > index && myCurrent < mySize)
+        --myCurrent;
+      --mySize;
     }
 
     /**
@@ -219,15 +273,25 @@ class LinkedObjectPool
       the 'current' node.
     */
     void removeToFirst() {
-      myPool.splice(myPool.end(), myList, myList.begin(), myCurrent);
+      if(currentIsValid())
+      {
+        myHead = wrap(myHead + myCurrent);
+        mySize -= myCurrent;
+        myCurrent = 0;
+      }
+      else
+        clear();
     }
 
     /**
       Remove range of elements from the node after 'current' to the end of the
-      active list.
+      active list.  An invalid 'current' removes all elements.
     */
     void removeToLast() {
-      myPool.splice(myPool.end(), myList, std::next(myCurrent, 1), myList.end());
+      if(currentIsValid())
+        mySize = myCurrent + 1;
+      else
+        clear();
     }
 
     /**
@@ -237,12 +301,13 @@ class LinkedObjectPool
     void resize(uInt32 capacity) {
       if(myCapacity != capacity)  // only resize when necessary
       {
-        myList.clear();  myPool.clear();
-        myCurrent = myList.end();
         myCapacity = capacity;
-
+        mySlots = std::vector<T>(myCapacity);
+        myRing.resize(myCapacity);
         for(uInt32 i = 0; i < myCapacity; ++i)
-          myPool.emplace_back(T());
+          myRing[i] = i;
+
+        myHead = mySize = myCurrent = 0;
       }
     }
 
@@ -250,27 +315,45 @@ class LinkedObjectPool
       Erase entire contents of active list.
     */
     void clear() {
-      myPool.splice(myPool.end(), myList, myList.begin(), myList.end());
-      myCurrent = myList.end();
+      mySize = myCurrent = 0;
     }
 
     uInt32 capacity() const { return myCapacity; }
 
-    uInt32 size() const { return uInt32(myList.size()); }
-    bool empty() const  { return size() == 0;           }
-    bool full() const   { return size() >= capacity();  }
+    uInt32 size() const { return mySize;           }
+    bool empty() const  { return size() == 0;       }
+    bool full() const   { return size() >= capacity(); }
 
     friend ostream& operator<<(ostream& os, const LinkedObjectPool<T>& p) {
-      for(const auto& i: p.myList)
-        os << i << (p.current() == i ? "* " : "  ");
+      for(auto it = p.cbegin(); it != p.cend(); ++it)
+        os << *it << (it == p.currentIter() ? "* " : "  ");
       return os;
     }
 
   private:
-    std::list<T> myList, myPool;
+    uInt32 wrap(uInt32 index) const {
+      return index < myCapacity ? index : index - myCapacity;
+    }
+
+    uInt32 slot(uInt32 pos) const { return myRing[wrap(myHead + pos)]; }
+
+    const T& node(uInt32 pos) const { return mySlots[slot(pos)]; }
+
+  private:
+    // The nodes, which are never moved once the pool has been sized
+    std::vector<T> mySlots;
+
+    // Slot indices in list order; the active list starts at 'myHead' and
+    // the pool follows it
+    std::vector<uInt32> myRing;
+    uInt32 myHead{0};
+
+    // Number of active nodes
+    uInt32 mySize{0};
 
-    // Current position in the active list (end() indicates an invalid position)
-    iter myCurrent{myList.end()};
+    // Position of 'current' in the active list (>= mySize indicates an
+    // invalid position)
+    uInt32 myCurrent{0};
 
     // Total capacity of the pool
     uInt32 myCapacity{0};
@@ -15,8 +15,16 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <chrono>
+
 #include "Logger.hxx"
 
+namespace {
+  // Producers do not take the mutex, so a notification may get lost
+  // between checking the queue and waiting; this bounds the delay then
+  constexpr std::chrono::milliseconds DRAIN_INTERVAL{50};
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Logger& Logger::instance()
 {
@@ -25,6 +33,26 @@ Logger& Logger::instance()
   return loggerInstance;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Logger::Logger()
+{
+  myHistory.reserve(myHistorySize);
+  myWorker = std::thread(&Logger::workerMain, this);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Logger::~Logger()
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myQuit = true;
+  }
+  myCondition.notify_all();
+
+  // The worker writes out whatever is still queued
+  myWorker.join();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Logger::log(const string& message, Level level)
 {
@@ -51,18 +79,132 @@ void Logger::debug(const string& message)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Logger::logMessage(const string& message, Level level)
 {
-  if(level == Logger::Level::ERR)
+  if(level != Logger::Level::ERR && level != Logger::Level::ALWAYS &&
+     static_cast<int>(level) > myLogLevel.load(std::memory_order_relaxed))
+    return;
+
+  // Errors always go to the console
+  Message* msg = new Message{Entry{message, level, std::time(nullptr)},
+    level == Logger::Level::ERR || myLogToConsole.load(std::memory_order_relaxed),
+    myQueue.load(std::memory_order_relaxed)};
+
+  while(!myQueue.compare_exchange_weak(msg->next, msg,
+                                       std::memory_order_release,
+                                       std::memory_order_relaxed));
+
+  myCondition.notify_one();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Logger::workerMain()
+{
+  std::unique_lock<std::mutex> lock(myMutex);
+
+  while(!myQuit)
   {
-    cout << message << endl << std::flush;
-    myLogMessages += message + "\n";
+    drain();
+
+    myCondition.wait_for(lock, DRAIN_INTERVAL, [this]() {
+      return myQuit || myQueue.load(std::memory_order_relaxed) != nullptr;
+    });
   }
-  else if(static_cast<int>(level) <= myLogLevel ||
-          level == Logger::Level::ALWAYS)
+
+  drain();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Logger::drain()
+{
+  Message* msg = myQueue.exchange(nullptr, std::memory_order_acquire);
+  if(!msg) return;
+
+  // The queue is a stack, restore the order in which messages arrived
+  Message* first = nullptr;
+  while(msg)
   {
-    if(myLogToConsole)
-      cout << message << endl << std::flush;
-    myLogMessages += message + "\n";
+    Message* next = msg->next;
+    msg->next = first;
+    first = msg;
+    msg = next;
   }
+
+  bool written = false;
+  while(first)
+  {
+    unique_ptr<Message> current{first};
+    first = current->next;
+
+    if(current->toConsole)
+    {
+      cout << current->entry.text << '\n';
+      written = true;
+    }
+
+    if(myHistory.size() < myHistorySize)
+      myHistory.push_back(std::move(current->entry));
+    else
+    {
+      myHistory[myHistoryStart] = std::move(current->entry);
+      myHistoryStart = (myHistoryStart + 1) % myHistorySize;
+    }
+  }
+
+  if(written)
+    cout << std::flush;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Logger::setHistorySize(size_t size)
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+
+  drain();
+
+  // Keep the newest messages, oldest first
+  vector<Entry> history;
+  const size_t kept = std::min(myHistory.size(), std::max<size_t>(size, 1));
+
+  history.reserve(std::max<size_t>(size, 1));
+  for(size_t i = myHistory.size() - kept; i < myHistory.size(); ++i)
+    history.push_back(std::move(myHistory[(myHistoryStart + i) % myHistory.size()]));
+
+  myHistory = std::move(history);
+  myHistoryStart = 0;
+  myHistorySize = std::max<size_t>(size, 1);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<Logger::Entry> Logger::logEntries()
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+
+  drain();
+
+  vector<Entry> entries;
+  entries.reserve(myHistory.size());
+  for(size_t i = 0; i < myHistory.size(); ++i)
+    entries.push_back(myHistory[(myHistoryStart + i) % myHistory.size()]);
+
+  return entries;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string Logger::logMessages()
+{
+  string messages;
+
+  for(const auto& entry: logEntries())
+    messages += entry.text + "\n";
+
+  return messages;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Logger::flush()
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+
+  drain();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -18,10 +18,21 @@
 #ifndef LOGGER_HXX
 #define LOGGER_HXX
 
+#include <atomic>
+#include <condition_variable>
+#include <ctime>
 #include <functional>
+#include <mutex>
+#include <thread>
 
 #include "bspf.hxx"
 
+/**
+  Messages are queued without taking any lock, so that logging never stalls
+  the calling thread (e.g. the emulation worker), and written to the console
+  by a background thread. Only the most recent messages are kept in memory,
+  in a ring of fixed size (see setHistorySize()).
+*/
 class Logger {
 
   public:
@@ -35,6 +46,16 @@ class Logger {
       MAX = DEBUG
     };
 
+    // A message kept in the history
+    struct Entry {
+      string text;
+      Level level{Level::ALWAYS};
+      std::time_t time{0};
+    };
+
+    // Default number of messages kept in the history
+    static constexpr size_t DEFAULT_HISTORY = 1000;
+
   public:
 
     static Logger& instance();
@@ -50,21 +71,70 @@ class Logger {
     void setLogParameters(int logLevel, bool logToConsole);
     void setLogParameters(Level logLevel, bool logToConsole);
 
-    const string& logMessages() const { return myLogMessages; }
+    /**
+      Set the number of messages kept in the history. If the history holds
+      more messages, the oldest ones are dropped.
+    */
+    void setHistorySize(size_t size);
+
+    /**
+      The messages in the history, oldest first. Queued messages are
+      written out first.
+    */
+    vector<Entry> logEntries();
+
+    /**
+      The text of the messages in the history, one per line.
+    */
+    string logMessages();
+
+    /**
+      Write out all queued messages, e.g. before printing to the console
+      directly.
+    */
+    void flush();
 
   protected:
-    Logger() = default;
+    Logger();
+    ~Logger();
+
+  private:
+    // A queued message; the queue is a stack linked through 'next'
+    struct Message {
+      Entry entry;
+      bool toConsole{false};
+      Message* next{nullptr};
+    };
 
   private:
-    int myLogLevel{static_cast<int>(Level::MAX)};
-    bool myLogToConsole{true};
+    std::atomic<int> myLogLevel{static_cast<int>(Level::MAX)};
+    std::atomic<bool> myLogToConsole{true};
 
-    // The list of log messages
-    string myLogMessages;
+    // The messages that have not been written out yet, newest first
+    std::atomic<Message*> myQueue{nullptr};
+
+    // The most recent messages; once full, this is a ring starting at
+    // myHistoryStart
+    vector<Entry> myHistory;
+    size_t myHistoryStart{0};
+    size_t myHistorySize{DEFAULT_HISTORY};
+
+    // Guards the history and the consumer side of the queue
+    std::mutex myMutex;
+    std::condition_variable myCondition;
+    bool myQuit{false};
+
+    std::thread myWorker;
 
   private:
     void logMessage(const string& message, Level level);
 
+    // The background thread's main loop
+    void workerMain();
+
+    // Write out all queued messages; myMutex must be held
+    void drain();
+
     Logger(const Logger&) = delete;
     Logger(Logger&&) = delete;
     Logger& operator=(const Logger&) = delete;
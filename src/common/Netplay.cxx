@@ -0,0 +1,468 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "OSystem.hxx"
+#include "Console.hxx"
+#include "EventHandler.hxx"
+#include "FrameBuffer.hxx"
+#include "Settings.hxx"
+#include "Serializer.hxx"
+#include "Random.hxx"
+#include "M6532.hxx"
+#include "TIA.hxx"
+#include "DispatchResult.hxx"
+#include "Logger.hxx"
+#include "Netplay.hxx"
+
+namespace {
+  constexpr std::array<uInt8, 4> MAGIC = { 'S', 'T', 'N', 'P' };
+
+  // Both peers start from the same power-on state
+  constexpr uInt32 SEED = 0x2600;
+
+  // A frame that never completes (e.g. no VSYNC at all) is cut short after
+  // this many timeslices
+  constexpr uInt32 MAX_SLICES_PER_FRAME = 10;
+
+  constexpr size_t MAX_PACKET_SIZE = 256;
+
+  // The joystick events of both ports, and the shared switches
+  constexpr std::array<std::array<Event::Type, 5>, 2> JOYSTICK_EVENTS = {{
+    { Event::LeftJoystickUp, Event::LeftJoystickDown, Event::LeftJoystickLeft,
+      Event::LeftJoystickRight, Event::LeftJoystickFire },
+    { Event::RightJoystickUp, Event::RightJoystickDown, Event::RightJoystickLeft,
+      Event::RightJoystickRight, Event::RightJoystickFire }
+  }};
+
+  void putInt(uInt8*& p, uInt32 value)
+  {
+    for(int i = 0; i < 4; ++i, value >>= 8)
+      *p++ = static_cast<uInt8>(value);
+  }
+
+  uInt32 getInt(const uInt8*& p)
+  {
+    uInt32 value = 0;
+    for(int i = 0; i < 4; ++i)
+      value |= uInt32(*p++) << (i * 8);
+
+    return value;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Netplay::Netplay(OSystem& osystem)
+  : myOSystem{osystem}
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string Netplay::start()
+{
+  const Settings& settings = myOSystem.settings();
+  const string peer = settings.getString("netplay");
+  const size_t colon = peer.find_last_of(':');
+
+  if(colon == string::npos || colon == 0)
+    return "Netplay peer must be given as host:port";
+
+  const int peerPort = BSPF::stringToInt(peer.substr(colon + 1));
+  const int port = settings.getInt("netplay.port");
+  if(peerPort <= 0 || peerPort > 65535 || port <= 0 || port > 65535)
+    return "Invalid netplay port";
+
+  myPlayer = settings.getInt("netplay.player") == 2 ? 1 : 0;
+  myDelay = BSPF::clamp(settings.getInt("netplay.delay"), 0, int(MAX_DELAY));
+  myMaxRollback = BSPF::clamp(settings.getInt("netplay.rollback"), 1, int(MAX_ROLLBACK));
+
+  if(!mySocket.open(uInt16(port), peer.substr(0, colon), uInt16(peerPort)))
+    return "Netplay: cannot open UDP port " + std::to_string(port) +
+           " or resolve '" + peer.substr(0, colon) + "'";
+
+  // The state before the current frame is needed as well
+  myStates.resize(myMaxRollback + 2);
+  myStateSizes.resize(myStates.size());
+
+  return EmptyString;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Netplay::runFrame()
+{
+  receive();
+
+  if(!mySynchronized)
+  {
+    sendHello();
+    return false;
+  }
+
+  // The peer's input can't be predicted any further; wait for it
+  if(myFrame >= myRemoteFrames + myMaxRollback)
+  {
+    sendInput();
+    return false;
+  }
+
+  myLocalInput[slot(myLocalFrames++)] = readLocalInput();
+  sendInput();
+
+  TIA& tia = myOSystem.console().tia();
+  bool ok = true;
+
+  // Neither rolled back frames nor saving/loading produces sound (see
+  // StateManager::runAhead)
+  tia.enableAudioOutput(false);
+
+  if(myMispredicted < myFrame)
+  {
+    ok = loadState(myMispredicted);
+    for(uInt32 frame = myMispredicted; ok && frame < myFrame; ++frame)
+      ok = (frame == myMispredicted || saveState(frame)) && emulateFrame(frame);
+
+    if(!ok)
+      Logger::error("Netplay: rollback failed, the peers are out of sync");
+  }
+  myMispredicted = ~0U;
+
+  ok = saveState(myFrame) && ok;
+
+  tia.enableAudioOutput(true);
+  ok = emulateFrame(myFrame++) && ok;
+
+  // Both sides see the other one behind by the latency; half of the
+  // difference of both views is how much this side is really ahead
+  const Int32 advantage = Int32(myFrame) - Int32(myPeerFrame);
+  myTimeScale = (advantage - myPeerAdvantage) / 2 >= 1 ? 1.02 : 1.;
+
+  return ok;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Netplay::synchronize()
+{
+  Console& console = myOSystem.console();
+
+  console.system().randGenerator().initSeed(SEED);
+  console.system().reset();
+
+  // There is no input for the frames before the first delayed one
+  myLocalInput.fill(0);
+  myRemoteInput.fill(0);
+  myUsedRemoteInput.fill(0);
+  myLocalFrames = myRemoteFrames = myDelay;
+
+  myFrame = myPeerAcked = myPeerFrame = 0;
+  myPeerAdvantage = 0;
+  myMispredicted = ~0U;
+  mySynchronized = true;
+
+  myOSystem.frameBuffer().showTextMessage("Netplay started as player " +
+                                          std::to_string(myPlayer + 1));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Netplay::Input Netplay::readLocalInput() const
+{
+  const Event& event = myOSystem.eventHandler().event();
+  Input input = 0;
+
+  // The local player always uses the controls of the left joystick
+  for(size_t i = 0; i < JOYSTICK_EVENTS[0].size(); ++i)
+    if(event.get(JOYSTICK_EVENTS[0][i]))
+      input |= 1 << i;
+  if(event.get(Event::ConsoleSelect))
+    input |= Select;
+  if(event.get(Event::ConsoleReset))
+    input |= Reset;
+
+  return input;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Netplay::emulateFrame(uInt32 frame)
+{
+  // Predict unknown input to be unchanged
+  const Input remote = frame < myRemoteFrames
+    ? myRemoteInput[slot(frame)] : myRemoteInput[slot(myRemoteFrames - 1)];
+  myUsedRemoteInput[slot(frame)] = remote;
+
+  std::array<Input, 2> input;
+  input[myPlayer] = myLocalInput[slot(frame)];
+  input[1 - myPlayer] = remote;
+
+  // Temporarily replace the local input by the input of both players
+  Event& event = myOSystem.eventHandler().event();
+  std::array<std::array<Int32, 5>, 2> joysticks;
+  const Int32 select = event.get(Event::ConsoleSelect),
+              reset = event.get(Event::ConsoleReset);
+
+  for(size_t port = 0; port < 2; ++port)
+    for(size_t i = 0; i < JOYSTICK_EVENTS[port].size(); ++i)
+    {
+      joysticks[port][i] = event.get(JOYSTICK_EVENTS[port][i]);
+      event.set(JOYSTICK_EVENTS[port][i], (input[port] >> i) & 1);
+    }
+  event.set(Event::ConsoleSelect, ((input[0] | input[1]) & Select) != 0);
+  event.set(Event::ConsoleReset, ((input[0] | input[1]) & Reset) != 0);
+
+  Console& console = myOSystem.console();
+  TIA& tia = console.tia();
+  console.riot().update();
+
+  DispatchResult result;
+  bool ok = true;
+  const uInt32 framesBefore = tia.framesSinceLastRender();
+
+  for(uInt32 i = 0; ok && i < MAX_SLICES_PER_FRAME &&
+      tia.framesSinceLastRender() == framesBefore; ++i)
+  {
+    tia.update(result);
+    // Breakpoints can't be handled here, as the peer can't wait for them
+    ok = result.getStatus() == DispatchResult::Status::ok;
+  }
+
+  for(size_t port = 0; port < 2; ++port)
+    for(size_t i = 0; i < JOYSTICK_EVENTS[port].size(); ++i)
+      event.set(JOYSTICK_EVENTS[port][i], joysticks[port][i]);
+  event.set(Event::ConsoleSelect, select);
+  event.set(Event::ConsoleReset, reset);
+
+  return ok;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Netplay::saveState(uInt32 frame)
+{
+  const Console& console = myOSystem.console();
+  const size_t index = frame % myStates.size();
+  vector<uInt8>& buffer = myStates[index];
+
+  for(int attempt = 0; attempt < 2; ++attempt)
+  {
+    if(!buffer.empty())
+    {
+      Serializer out(buffer.data(), buffer.size());
+      if(console.save(out))
+      {
+        myStateSizes[index] = out.size();
+        return true;
+      }
+    }
+
+    // The buffer is missing or too small, so determine the required size
+    Serializer probe;
+    if(!console.save(probe))
+      break;
+
+    buffer.resize(probe.size() + probe.size() / 4);
+  }
+
+  return false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Netplay::loadState(uInt32 frame)
+{
+  const size_t index = frame % myStates.size();
+  Serializer in(myStates[index].data(), myStateSizes[index]);
+
+  return myOSystem.console().load(in);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Netplay::receive()
+{
+  std::array<uInt8, MAX_PACKET_SIZE> packet;
+  size_t size;
+
+  while((size = mySocket.receive(packet.data(), packet.size())) > 0)
+  {
+    if(size <= MAGIC.size() ||
+       !std::equal(MAGIC.begin(), MAGIC.end(), packet.begin()))
+      continue;
+
+    const uInt8* data = packet.data() + MAGIC.size() + 1;
+    size -= MAGIC.size() + 1;
+
+    switch(PacketType(packet[MAGIC.size()]))
+    {
+      case PacketType::Hello:
+        handleHello(data, size);
+        break;
+
+      case PacketType::Input:
+        handleInput(data, size);
+        break;
+
+      default:
+        break;
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Netplay::sendHello()
+{
+  // player, delay, ready, MD5
+  std::array<uInt8, MAX_PACKET_SIZE> packet;
+  uInt8* p = std::copy(MAGIC.begin(), MAGIC.end(), packet.begin());
+  const string& md5 = myOSystem.console().properties().get(PropType::Cart_MD5);
+
+  *p++ = uInt8(PacketType::Hello);
+  *p++ = uInt8(myPlayer);
+  *p++ = uInt8(myDelay);
+  *p++ = myPeerSeen;
+  p = std::copy_n(md5.begin(), std::min<size_t>(md5.size(), 32), p);
+
+  mySocket.send(packet.data(), p - packet.data());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Netplay::handleHello(const uInt8* data, size_t size)
+{
+  if(size < 3)
+    return;
+
+  const uInt32 player = data[0], delay = data[1];
+  const bool ready = data[2] != 0;
+  const string md5(reinterpret_cast<const char*>(data + 3), size - 3);
+
+  if(md5 != myOSystem.console().properties().get(PropType::Cart_MD5) ||
+     player == myPlayer || delay != myDelay)
+  {
+    if(!myPeerSeen)
+      myOSystem.frameBuffer().showTextMessage(
+        "Netplay: the peer uses another ROM, player or delay");
+    return;
+  }
+
+  myPeerSeen = true;
+  if(ready && !mySynchronized)
+    synchronize();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Netplay::sendInput()
+{
+  // first frame, count, acked, current frame, advantage, inputs
+  std::array<uInt8, MAX_PACKET_SIZE> packet;
+  uInt8* p = std::copy(MAGIC.begin(), MAGIC.end(), packet.begin());
+
+  // Everything the peer hasn't acknowledged yet is sent again
+  const uInt32 first = std::max(myPeerAcked, myLocalFrames > HISTORY ? myLocalFrames - HISTORY : 0);
+  const uInt32 count = std::min(myLocalFrames - first, MAX_INPUTS_PER_PACKET);
+
+  *p++ = uInt8(PacketType::Input);
+  putInt(p, first);
+  *p++ = uInt8(count);
+  putInt(p, myRemoteFrames);
+  putInt(p, myFrame);
+  *p++ = uInt8(BSPF::clamp(Int32(myFrame) - Int32(myPeerFrame), -128, 127));
+  for(uInt32 i = 0; i < count; ++i)
+    *p++ = myLocalInput[slot(first + i)];
+
+  mySocket.send(packet.data(), p - packet.data());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Netplay::handleInput(const uInt8* data, size_t size)
+{
+  if(size < 14)
+    return;
+
+  // The peer has started already, so our 'ready' hello got through
+  if(!mySynchronized)
+  {
+    if(!myPeerSeen)
+      return;
+    synchronize();
+  }
+
+  const uInt32 first = getInt(data);
+  const uInt32 count = *data++;
+  const uInt32 acked = getInt(data);
+  const uInt32 frame = getInt(data);
+  const Int32 advantage = Int8(*data++);
+
+  if(size < 14 + count)
+    return;
+
+  myPeerAcked = std::max(myPeerAcked, acked);
+  if(frame >= myPeerFrame)
+  {
+    myPeerFrame = frame;
+    myPeerAdvantage = advantage;
+  }
+
+  // Only take over input which continues the known input
+  if(first > myRemoteFrames)
+    return;
+
+  for(uInt32 i = myRemoteFrames - first; i < count; ++i, ++myRemoteFrames)
+  {
+    const Input input = data[i];
+
+    myRemoteInput[slot(myRemoteFrames)] = input;
+    if(myRemoteFrames < myFrame && input != myUsedRemoteInput[slot(myRemoteFrames)])
+      myMispredicted = std::min(myMispredicted, myRemoteFrames);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Netplay::allowsEvent(Event::Type event)
+{
+  switch(event)
+  {
+    // These would change the state on this side only
+    case Event::ConsoleColor:
+    case Event::ConsoleBlackWhite:
+    case Event::ConsoleColorToggle:
+    case Event::Console7800Pause:
+    case Event::ConsoleLeftDiffA:
+    case Event::ConsoleLeftDiffB:
+    case Event::ConsoleLeftDiffToggle:
+    case Event::ConsoleRightDiffA:
+    case Event::ConsoleRightDiffB:
+    case Event::ConsoleRightDiffToggle:
+    case Event::ReloadConsole:
+    case Event::Fry:
+    case Event::LoadState:
+    case Event::LoadAllStates:
+    case Event::ToggleTimeMachine:
+    case Event::TimeMachineMode:
+    case Event::Rewind1Menu:
+    case Event::Rewind10Menu:
+    case Event::RewindAllMenu:
+    case Event::Unwind1Menu:
+    case Event::Unwind10Menu:
+    case Event::UnwindAllMenu:
+    case Event::RewindPause:
+    case Event::UnwindPause:
+    // The peer can't wait for these
+    case Event::TogglePauseMode:
+    case Event::StartPauseMode:
+    case Event::DebuggerMode:
+    case Event::ToggleTurbo:
+    case Event::DecreaseSpeed:
+    case Event::IncreaseSpeed:
+      return false;
+
+    default:
+      return true;
+  }
+}
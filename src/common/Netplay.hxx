@@ -0,0 +1,179 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef NETPLAY_HXX
+#define NETPLAY_HXX
+
+class OSystem;
+class Console;
+
+#include "bspf.hxx"
+#include "Event.hxx"
+#include "UdpSocket.hxx"
+
+/**
+  Two player rollback netplay over UDP.
+
+  Both peers run the same ROM from the same (seeded) power-on state, and
+  emulate frame by frame on the main thread.  The local input of a frame
+  is sent to the peer right away, and applied 'netplay.delay' frames
+  later.  Where the peer's input hasn't arrived yet, it is predicted to be
+  unchanged.  Once it arrives and differs from the prediction, the state
+  of the first mispredicted frame is restored, and all frames since are
+  emulated again (silently and without rendering).  To keep this bounded,
+  the emulation stalls if the peer falls behind by more than
+  'netplay.rollback' frames.
+
+  The states of the recent frames are kept in fixed size buffers, which
+  are saved and loaded without stream overhead (like run-ahead does).
+
+  Only the joysticks and the Select and Reset switches are exchanged;
+  everything else which changes the emulation state locally (state loading,
+  rewind, other switches, speed, ...) is blocked while netplay is active.
+
+  @author  Stella Team
+*/
+class Netplay
+{
+  public:
+    explicit Netplay(OSystem& osystem);
+
+    /**
+      Open the socket and start looking for the peer, using the settings
+      'netplay' (peer host:port), 'netplay.port', 'netplay.player',
+      'netplay.delay' and 'netplay.rollback'.
+
+      @return  An error message, or an empty string on success
+    */
+    string start();
+
+    /**
+      Exchange input with the peer and, unless stalled, emulate the next
+      frame (after re-emulating mispredicted ones).
+
+      @return  True if a new frame is pending for rendering
+    */
+    bool runFrame();
+
+    /**
+      Factor for the frame time; slightly above 1 while this side is ahead
+      of the peer, so the peers converge without stalling.
+    */
+    double timeScale() const { return myTimeScale; }
+
+    /**
+      Whether the given event may be handled while netplay is active.
+    */
+    static bool allowsEvent(Event::Type event);
+
+  private:
+    // The joystick and switch bits of a player's input
+    using Input = uInt8;
+
+    enum InputBit: uInt8 {
+      Up = 1 << 0, Down = 1 << 1, Left = 1 << 2, Right = 1 << 3,
+      Fire = 1 << 4, Select = 1 << 5, Reset = 1 << 6
+    };
+
+    enum class PacketType: uInt8 { Hello = 1, Input = 2 };
+
+    // Number of frames whose input is remembered; must exceed the maximum
+    // rollback plus delay, and the frames of input sent per packet
+    static constexpr uInt32 HISTORY = 128;
+    static constexpr uInt32 MAX_INPUTS_PER_PACKET = 64;
+
+    static constexpr uInt32 MAX_ROLLBACK = 30;
+    static constexpr uInt32 MAX_DELAY = 10;
+
+  private:
+    void receive();
+    void handleHello(const uInt8* data, size_t size);
+    void handleInput(const uInt8* data, size_t size);
+
+    void sendHello();
+    void sendInput();
+
+    /**
+      Put both consoles into the same power-on state.
+    */
+    void synchronize();
+
+    Input readLocalInput() const;
+
+    /**
+      Emulate the given frame with the (confirmed or predicted) input of
+      both players.
+    */
+    bool emulateFrame(uInt32 frame);
+
+    bool saveState(uInt32 frame);
+    bool loadState(uInt32 frame);
+
+    uInt32 slot(uInt32 frame) const { return frame % HISTORY; }
+
+  private:
+    OSystem& myOSystem;
+
+    UdpSocket mySocket;
+
+    // Local player (0 = left, 1 = right joystick)
+    uInt32 myPlayer{0};
+    uInt32 myDelay{2};
+    uInt32 myMaxRollback{8};
+
+    // Handshake
+    bool myPeerSeen{false};
+    bool mySynchronized{false};
+
+    // The next frame to emulate
+    uInt32 myFrame{0};
+
+    // Inputs per frame (indexed by slot()), and the number of frames for
+    // which they are known
+    std::array<Input, HISTORY> myLocalInput{0};
+    std::array<Input, HISTORY> myRemoteInput{0};
+    uInt32 myLocalFrames{0};
+    uInt32 myRemoteFrames{0};
+
+    // The remote input which the emulation of a frame was based on
+    std::array<Input, HISTORY> myUsedRemoteInput{0};
+
+    // Earliest emulated frame whose remote input was mispredicted
+    uInt32 myMispredicted{~0U};
+
+    // Number of our inputs the peer has received, its current frame, and
+    // how far it considers itself ahead of us
+    uInt32 myPeerAcked{0};
+    uInt32 myPeerFrame{0};
+    Int32 myPeerAdvantage{0};
+
+    double myTimeScale{1.};
+
+    // States of the frames which can be rolled back to
+    vector<vector<uInt8>> myStates;
+    vector<size_t> myStateSizes;
+
+  private:
+    // Following constructors and assignment operators not supported
+    Netplay() = delete;
+    Netplay(const Netplay&) = delete;
+    Netplay(Netplay&&) = delete;
+    Netplay& operator=(const Netplay&) = delete;
+    Netplay& operator=(Netplay&&) = delete;
+};
+
+#endif // NETPLAY_HXX
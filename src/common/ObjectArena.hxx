@@ -0,0 +1,111 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef OBJECT_ARENA_HXX
+#define OBJECT_ARENA_HXX
+
+#include <memory>
+#include <new>
+#include <stdexcept>
+
+#include "bspf.hxx"
+
+/**
+  A fixed size block of memory from which a group of objects with the same
+  lifetime is created, like the components of a console.  The objects end
+  up next to each other in memory, and releasing them costs a single
+  deallocation instead of one per object.
+
+  Objects are handed out as unique pointers whose deleter only runs the
+  destructor; the memory itself is released with the arena.  Therefore the
+  arena must outlive all of its objects (i.e. be declared before the
+  pointers when used as member).
+
+  @author  Stella Team
+*/
+namespace Common {
+
+class ObjectArena
+{
+  public:
+    struct Deleter {
+      template<typename T>
+      void operator()(T* object) const { object->~T(); }
+    };
+
+    template<typename T>
+    using Ptr = std::unique_ptr<T, Deleter>;
+
+  public:
+    /**
+      Create an arena with room for the given number of bytes.
+    */
+    explicit ObjectArena(size_t capacity)
+      : myMemory{make_unique<uInt8[]>(capacity)},
+        myCapacity{capacity}
+    {
+    }
+
+    /**
+      The capacity required to create one object of each of the given
+      types, regardless of the order of creation.
+    */
+    template<typename... T>
+    static constexpr size_t capacityFor() {
+      return ((sizeof(T) + alignof(T) - 1) + ...);
+    }
+
+    /**
+      Construct an object in the arena.
+
+      @throw runtime_error  If the arena has no room left
+    */
+    template<typename T, typename... Args>
+    Ptr<T> create(Args&&... args)
+    {
+      static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                    "Object alignment exceeds the arena's alignment");
+
+      void* memory = myMemory.get() + myUsed;
+      size_t space = myCapacity - myUsed;
+
+      if(!std::align(alignof(T), sizeof(T), memory, space))
+        throw std::runtime_error("Object arena exhausted");
+
+      T* object = new(memory) T(std::forward<Args>(args)...);
+      myUsed = myCapacity - space + sizeof(T);
+
+      return Ptr<T>(object);
+    }
+
+  private:
+    std::unique_ptr<uInt8[]> myMemory;
+    size_t myCapacity{0};
+    size_t myUsed{0};
+
+  private:
+    // Following constructors and assignment operators not supported
+    ObjectArena() = delete;
+    ObjectArena(const ObjectArena&) = delete;
+    ObjectArena(ObjectArena&&) = delete;
+    ObjectArena& operator=(const ObjectArena&) = delete;
+    ObjectArena& operator=(ObjectArena&&) = delete;
+};
+
+} // namespace Common
+
+#endif // OBJECT_ARENA_HXX
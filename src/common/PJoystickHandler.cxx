@@ -63,7 +63,10 @@ PhysicalJoystickHandler::PhysicalJoystickHandler(
       continue;
     }
 
-    myDatabase.emplace(mapping.at("name").get<string>(), StickInfo(mapping));
+    JoyMap::JoyMappingList stickMapping;
+    PhysicalJoystick::parseMap(mapping, stickMapping);
+
+    myDatabase.emplace(mapping.at("name").get<string>(), StickInfo(std::move(stickMapping)));
   }
 }
 
@@ -170,7 +173,7 @@ void PhysicalJoystickHandler::addToDatabase(const PhysicalJoystickPtr& stick)
   }
   else // adding for the first time
   {
-    StickInfo info("", stick);
+    StickInfo info({}, stick);
     myDatabase.emplace(stick->name, info);
     setStickDefaultMapping(stick->ID, Event::NoType, EventMode::kEmulationMode);
     setStickDefaultMapping(stick->ID, Event::NoType, EventMode::kMenuMode);
@@ -621,11 +624,8 @@ void PhysicalJoystickHandler::saveMapping()
   json mapping = json::array();
 
   for(const auto& [_name, _info]: myDatabase)
-  {
-    json map = _info.joy ? _info.joy->getMap() : _info.mapping;
-
-    if (!map.is_null()) mapping.emplace_back(map);
-  }
+    mapping.emplace_back(PhysicalJoystick::saveMap(_name,
+      _info.joy ? _info.joy->getMap() : _info.mapping));
 
   myOSystem.settings().setValue("joymap", mapping.dump(2));
 }
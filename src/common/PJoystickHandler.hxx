@@ -47,16 +47,18 @@ using PhysicalJoystickPtr = shared_ptr<PhysicalJoystick>;
 class PhysicalJoystickHandler
 {
   private:
+    // The mappings are kept decoded, so that (re)connecting a stick doesn't
+    // have to parse JSON; they are only encoded again when saved
     struct StickInfo
     {
-      explicit StickInfo(nlohmann::json map, PhysicalJoystickPtr stick = nullptr)
-        : mapping(map), joy{std::move(stick)} {}
+      explicit StickInfo(JoyMap::JoyMappingList map, PhysicalJoystickPtr stick = nullptr)
+        : mapping{std::move(map)}, joy{std::move(stick)} {}
 
-      nlohmann::json mapping;
+      JoyMap::JoyMappingList mapping;
       PhysicalJoystickPtr joy;
 
       friend ostream& operator<<(ostream& os, const StickInfo& si) {
-        os << "  joy: " << si.joy << endl << "  map: " << si.mapping;
+        os << "  joy: " << si.joy << endl << "  map: " << si.mapping.size() << " mappings";
         return os;
       }
     };
@@ -27,6 +27,7 @@
 #include "Props.hxx"
 #include "Settings.hxx"
 #include "TIASurface.hxx"
+#include "TIA.hxx"
 #include "Version.hxx"
 #include "PNGLibrary.hxx"
 #include "Rect.hxx"
@@ -37,8 +38,30 @@ PNGLibrary::PNGLibrary(OSystem& osystem)
 {
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+PNGLibrary::~PNGLibrary()
+{
+  {
+    std::lock_guard<std::mutex> lock(mySaveMutex);
+    mySaveQuit = true;
+  }
+  mySaveCondition.notify_one();
+
+  if(mySaveThread.joinable())
+    mySaveThread.join();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void PNGLibrary::loadImage(const string& filename, FBSurface& surface)
+{
+  decodeImage(filename, ReadInfo);
+
+  // Load image into the surface, setting the correct dimensions
+  loadImage(ReadInfo, surface);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGLibrary::decodeImage(const string& filename, ImageData& image)
 {
   png_structp png_ptr = nullptr;
   png_infop info_ptr = nullptr;
@@ -101,22 +124,20 @@ void PNGLibrary::loadImage(const string& filename, FBSurface& surface)
   }
 
   // Create/initialize storage area for the current image
-  if(!allocateStorage(iwidth, iheight))
+  if(!allocateStorage(image, iwidth, iheight))
     loadImageERROR("Not enough memory to read PNG file");
 
   // The PNG read function expects an array of rows, not a single 1-D array
-  for(uInt32 irow = 0, offset = 0; irow < ReadInfo.height; ++irow, offset += ReadInfo.pitch)
-    ReadInfo.row_pointers[irow] = static_cast<png_bytep>(ReadInfo.buffer.data() + offset);
+  vector<png_bytep> row_pointers(image.height);
+  for(uInt32 irow = 0, offset = 0; irow < image.height; ++irow, offset += image.pitch)
+    row_pointers[irow] = static_cast<png_bytep>(image.buffer.data() + offset);
 
   // Read the entire image in one go
-  png_read_image(png_ptr, ReadInfo.row_pointers.data());
+  png_read_image(png_ptr, row_pointers.data());
 
   // We're finished reading
   png_read_end(png_ptr, info_ptr);
 
-  // Load image into the surface, setting the correct dimensions
-  loadImagetoSurface(surface);
-
   // Cleanup
   if(png_ptr)
     png_destroy_read_struct(&png_ptr, info_ptr ? &info_ptr : nullptr, nullptr);
@@ -125,10 +146,120 @@ void PNGLibrary::loadImage(const string& filename, FBSurface& surface)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void PNGLibrary::saveImage(const string& filename, const VariantList& comments)
 {
-  std::ofstream out(filename, std::ios_base::binary);
-  if(!out.is_open())
-    throw runtime_error("ERROR: Couldn't create snapshot file");
+  SaveJob job;
+  job.filename = filename;
+  job.comments = comments;
+  readImage(job);
+
+  saveImage(job);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGLibrary::saveImage(const string& filename, const FBSurface& surface,
+                           const Common::Rect& rect, const VariantList& comments)
+{
+  SaveJob job;
+  job.filename = filename;
+  job.comments = comments;
+  readImage(job, surface, rect);
+
+  saveImage(job);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGLibrary::saveImageAsync(const string& filename, const VariantList& comments,
+                                const SaveCallback& callback)
+{
+  SaveJob job;
+  job.filename = filename;
+  job.comments = comments;
+  readImage(job);
+
+  saveImageAsync(job, callback);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGLibrary::saveImageAsync(const string& filename, const FBSurface& surface,
+                                const Common::Rect& rect, const VariantList& comments,
+                                const SaveCallback& callback)
+{
+  SaveJob job;
+  job.filename = filename;
+  job.comments = comments;
+  readImage(job, surface, rect);
+
+  saveImageAsync(job, callback);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGLibrary::saveImageAsync(SaveJob& job, const SaveCallback& callback)
+{
+  job.callback = callback;
+  myPendingFiles.insert(job.filename);
+
+  std::lock_guard<std::mutex> lock(mySaveMutex);
+
+  if(!mySaveThread.joinable())
+    mySaveThread = std::thread([this] { saveThreadMain(); });
+
+  mySaveJobs.push_back(std::move(job));
+  mySaveCondition.notify_one();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGLibrary::update()
+{
+  std::deque<SaveJob> saved;
+  {
+    std::lock_guard<std::mutex> lock(mySaveMutex);
+    if(mySavedJobs.empty())
+      return;
+    saved.swap(mySavedJobs);
+  }
+
+  for(const auto& job: saved)
+  {
+    myPendingFiles.erase(job.filename);
+    if(job.callback)
+      job.callback(job.error);
+  }
+}
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGLibrary::saveThreadMain()
+{
+  std::unique_lock<std::mutex> lock(mySaveMutex);
+
+  // Pending images are still saved when quitting
+  for(;;)
+  {
+    mySaveCondition.wait(lock, [this] { return mySaveQuit || !mySaveJobs.empty(); });
+    if(mySaveJobs.empty())
+      break;
+
+    SaveJob job = std::move(mySaveJobs.front());
+    mySaveJobs.pop_front();
+    lock.unlock();
+
+    try
+    {
+      saveImage(job);
+    }
+    catch(const runtime_error& e)
+    {
+      job.error = e.what();
+    }
+    // The pixels aren't needed anymore
+    vector<png_byte>().swap(job.buffer);
+
+    lock.lock();
+    mySavedJobs.push_back(std::move(job));
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGLibrary::readImage(SaveJob& job) const
+{
   const FrameBuffer& fb = myOSystem.frameBuffer();
 
   const Common::Rect& rectUnscaled = fb.imageRect();
@@ -137,48 +268,44 @@ void PNGLibrary::saveImage(const string& filename, const VariantList& comments)
     fb.scaleX(rectUnscaled.w()), fb.scaleY(rectUnscaled.h())
   );
 
-  png_uint_32 width = rect.w(), height = rect.h();
+  job.width = rect.w();  job.height = rect.h();
 
   // Get framebuffer pixel data (we get ABGR format)
-  vector<png_byte> buffer(width * height * 4);
-  fb.readPixels(buffer.data(), width*4, rect);
-
-  // Set up pointers into "buffer" byte array
-  vector<png_bytep> rows(height);
-  for(png_uint_32 k = 0; k < height; ++k)
-    rows[k] = static_cast<png_bytep>(buffer.data() + k*width*4);
-
-  // And save the image
-  saveImageToDisk(out, rows, width, height, comments);
+  job.buffer.resize(size_t(job.width) * job.height * 4);
+  fb.readPixels(job.buffer.data(), job.width*4, rect);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void PNGLibrary::saveImage(const string& filename, const FBSurface& surface,
-                           const Common::Rect& rect, const VariantList& comments)
+void PNGLibrary::readImage(SaveJob& job, const FBSurface& surface,
+                           const Common::Rect& rect)
 {
-  std::ofstream out(filename, std::ios_base::binary);
-  if(!out.is_open())
-    throw runtime_error("ERROR: Couldn't create snapshot file");
-
   // Do we want the entire surface or just a section?
-  png_uint_32 width = rect.w(), height = rect.h();
+  job.width = rect.w();  job.height = rect.h();
   if(rect.empty())
   {
-    width = surface.width();
-    height = surface.height();
+    job.width = surface.width();
+    job.height = surface.height();
   }
 
   // Get the surface pixel data (we get ABGR format)
-  vector<png_byte> buffer(width * height * 4);
-  surface.readPixels(buffer.data(), width, rect);
+  job.buffer.resize(size_t(job.width) * job.height * 4);
+  surface.readPixels(job.buffer.data(), job.width, rect);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGLibrary::saveImage(const SaveJob& job)
+{
+  std::ofstream out(job.filename, std::ios_base::binary);
+  if(!out.is_open())
+    throw runtime_error("ERROR: Couldn't create snapshot file");
 
   // Set up pointers into "buffer" byte array
-  vector<png_bytep> rows(height);
-  for(png_uint_32 k = 0; k < height; ++k)
-    rows[k] = static_cast<png_bytep>(buffer.data() + k*width*4);
+  vector<png_bytep> rows(job.height);
+  for(png_uint_32 k = 0; k < job.height; ++k)
+    rows[k] = const_cast<png_bytep>(job.buffer.data() + size_t(k)*job.width*4);
 
   // And save the image
-  saveImageToDisk(out, rows, width, height, comments);
+  saveImageToDisk(out, rows, job.width, job.height, job.comments);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -243,11 +370,87 @@ void PNGLibrary::saveImageToDisk(std::ofstream& out, const vector<png_bytep>& ro
     png_destroy_write_struct(&png_ptr, &info_ptr);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGLibrary::saveImage(const string& filename, const uInt8* pixels,
+                           png_uint_32 width, png_uint_32 height,
+                           const PaletteArray& palette, const VariantList& comments)
+{
+  std::ofstream out(filename, std::ios_base::binary);
+  if(!out.is_open())
+    throw runtime_error("ERROR: Couldn't create snapshot file");
+
+  png_structp png_ptr = nullptr;
+  png_infop info_ptr = nullptr;
+
+  auto saveImageERROR = [&](const char* s) {
+    if(png_ptr)
+      png_destroy_write_struct(&png_ptr, &info_ptr);
+    if(s)
+      throw runtime_error(s);
+  };
+
+  // Create the PNG saving context structure
+  png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr,
+                 png_user_error, png_user_warn);
+  if(png_ptr == nullptr)
+    saveImageERROR("Couldn't allocate memory for PNG file");
+
+  info_ptr = png_create_info_struct(png_ptr);
+  if(info_ptr == nullptr)
+    saveImageERROR("Couldn't create image information for PNG file");
+
+  // Set up the output control
+  png_set_write_fn(png_ptr, &out, png_write_data, png_io_flush);
+
+  // Write PNG header info, using the palette directly
+  png_set_IHDR(png_ptr, info_ptr, width, height, 8,
+      PNG_COLOR_TYPE_PALETTE, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
+      PNG_FILTER_TYPE_DEFAULT);
+
+  std::array<png_color, kColor> colors;
+  for(size_t i = 0; i < colors.size(); ++i)
+  {
+    colors[i].red   = (palette[i] >> 16) & 0xff;
+    colors[i].green = (palette[i] >> 8) & 0xff;
+    colors[i].blue  = palette[i] & 0xff;
+  }
+  png_set_PLTE(png_ptr, info_ptr, colors.data(), int(colors.size()));
+
+  // Write comments
+  writeComments(png_ptr, info_ptr, comments);
+
+  // Write the file header information.  REQUIRED
+  png_write_info(png_ptr, info_ptr);
+
+  // Write the entire image in one go
+  vector<png_bytep> rows(height);
+  for(png_uint_32 k = 0; k < height; ++k)
+    rows[k] = const_cast<png_bytep>(pixels + size_t(k) * width);
+  png_write_image(png_ptr, rows.data());
+
+  // We're finished writing
+  png_write_end(png_ptr, info_ptr);
+
+  // Cleanup
+  saveImageERROR(nullptr);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void PNGLibrary::updateTime(uInt64 time)
 {
   if(++mySnapCounter % mySnapInterval == 0)
-    takeSnapshot(uInt32(time) >> 10);  // not quite milliseconds, but close enough
+  {
+    const uInt32 number = uInt32(time) >> 10;  // not quite milliseconds, but close enough
+
+    if(myCapture.isActive() && myOSystem.hasConsole())
+    {
+      TIA& tia = myOSystem.console().tia();
+      myCapture.addFrame(tia.frameBuffer(), tia.width(), tia.height(),
+                         myOSystem.frameBuffer().tiaSurface().rgbPalette(), number);
+    }
+    else
+      takeSnapshot(number);
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -255,27 +458,56 @@ void PNGLibrary::toggleContinuousSnapshots(bool perFrame)
 {
   if(mySnapInterval == 0)
   {
+    if(!myOSystem.hasConsole())
+      return;
+
     ostringstream buf;
     uInt32 interval = myOSystem.settings().getInt("ssinterval");
+    const bool video = myOSystem.settings().getString("ssformat") == "y4m";
     if(perFrame)
     {
-      buf << "Enabling snapshots every frame";
+      buf << "Enabling " << (video ? "video capture" : "snapshots")
+          << " every frame";
       interval = 1;
     }
     else
     {
-      buf << "Enabling snapshots in " << interval << " second intervals";
+      buf << "Enabling " << (video ? "video capture" : "snapshots") << " in "
+          << interval << " second intervals";
       interval *= uInt32(myOSystem.frameRate());
     }
+
+    // Pixel-exact images and videos are encoded in the background
+    if(video || myOSystem.settings().getBool("ss1x"))
+    {
+      if(!myCapture.start(snapshotPath(),
+                          video ? FrameCapture::Format::y4m : FrameCapture::Format::png,
+                          myOSystem.frameRate() / interval, snapshotComments()))
+      {
+        myOSystem.frameBuffer().showTextMessage("ERROR: Couldn't create video capture file");
+        return;
+      }
+    }
     myOSystem.frameBuffer().showTextMessage(buf.str());
     setContinuousSnapInterval(interval);
   }
   else
   {
     ostringstream buf;
-    buf << "Disabling snapshots, generated "
-      << (mySnapCounter / mySnapInterval)
-      << " files";
+    if(myCapture.isActive())
+    {
+      const bool video = myOSystem.settings().getString("ssformat") == "y4m";
+      const uInt32 written = myCapture.stop();
+
+      buf << "Disabling " << (video ? "video capture" : "snapshots")
+          << ", generated " << written << (video ? " frames" : " files");
+      if(myCapture.droppedFrames())
+        buf << " (" << myCapture.droppedFrames() << " dropped)";
+    }
+    else
+      buf << "Disabling snapshots, generated "
+        << (mySnapCounter / mySnapInterval)
+        << " files";
     myOSystem.frameBuffer().showTextMessage(buf.str());
     setContinuousSnapInterval(0);
   }
@@ -284,6 +516,9 @@ void PNGLibrary::toggleContinuousSnapshots(bool perFrame)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void PNGLibrary::setContinuousSnapInterval(uInt32 interval)
 {
+  if(interval == 0)
+    myCapture.stop();
+
   mySnapInterval = interval;
   mySnapCounter = 0;
 }
@@ -296,10 +531,7 @@ void PNGLibrary::takeSnapshot(uInt32 number)
 
   // Figure out the correct snapshot name
   string filename;
-  string sspath = myOSystem.snapshotSaveDir().getPath() +
-      (myOSystem.settings().getString("snapname") != "int" ?
-          myOSystem.romFile().getNameWithExt("")
-        : myOSystem.console().properties().get(PropType::Cart_Name));
+  const string& sspath = snapshotPath();
 
   // Check whether we want multiple snapshots created
   if(number > 0)
@@ -311,19 +543,20 @@ void PNGLibrary::takeSnapshot(uInt32 number)
   }
   else if(!myOSystem.settings().getBool("sssingle"))
   {
-    // Determine if the file already exists, checking each successive filename
-    // until one doesn't exist
+    // Determine if the file already exists (or is still being saved),
+    // checking each successive filename until one doesn't exist
     filename = sspath + ".png";
-    FilesystemNode node(filename);
-    if(node.exists())
+    const auto exists = [this](const string& name) {
+      return myPendingFiles.count(name) || FilesystemNode(name).exists();
+    };
+    if(exists(filename))
     {
       ostringstream buf;
       for(uInt32 i = 1; ;++i)
       {
         buf.str("");
         buf << sspath << "_" << i << ".png";
-        FilesystemNode next(buf.str());
-        if(!next.exists())
+        if(!exists(buf.str()))
           break;
       }
       filename = buf.str();
@@ -333,32 +566,18 @@ void PNGLibrary::takeSnapshot(uInt32 number)
     filename = sspath + ".png";
 
   // Some text fields to add to the PNG snapshot
-  VariantList comments;
-  ostringstream version;
-  version << "Stella " << STELLA_VERSION << " (Build " << STELLA_BUILD << ") ["
-          << BSPF::ARCH << "]";
-  VarList::push_back(comments, "Software", version.str());
-  const string& name = (myOSystem.settings().getString("snapname") == "int")
-      ? myOSystem.console().properties().get(PropType::Cart_Name)
-      : myOSystem.romFile().getName();
-  VarList::push_back(comments, "ROM Name", name);
-  VarList::push_back(comments, "ROM MD5", myOSystem.console().properties().get(PropType::Cart_MD5));
-  VarList::push_back(comments, "TV Effects", myOSystem.frameBuffer().tiaSurface().effectsInfo());
+  const VariantList& comments = snapshotComments();
 
-  // Now create a PNG snapshot
-  string message = "Snapshot saved";
+  // Now create a PNG snapshot; only the pixels are read here, encoding
+  // is done in the background
+  const auto saved = [this](const string& error) {
+    myOSystem.frameBuffer().showTextMessage(error.empty() ? "Snapshot saved" : error);
+  };
   if(myOSystem.settings().getBool("ss1x"))
   {
-    try
-    {
-      Common::Rect rect;
-      const FBSurface& surface = myOSystem.frameBuffer().tiaSurface().baseSurface(rect);
-      myOSystem.png().saveImage(filename, surface, rect, comments);
-    }
-    catch(const runtime_error& e)
-    {
-      message = e.what();
-    }
+    Common::Rect rect;
+    const FBSurface& surface = myOSystem.frameBuffer().tiaSurface().baseSurface(rect);
+    saveImageAsync(filename, surface, rect, comments, saved);
   }
   else
   {
@@ -366,45 +585,60 @@ void PNGLibrary::takeSnapshot(uInt32 number)
     myOSystem.frameBuffer().enableMessages(false);
     myOSystem.frameBuffer().tiaSurface().renderForSnapshot();
 
-    try
-    {
-      myOSystem.png().saveImage(filename, comments);
-    }
-    catch(const runtime_error& e)
-    {
-      message = e.what();
-    }
+    saveImageAsync(filename, comments, saved);
 
     // Re-enable old messages
     myOSystem.frameBuffer().enableMessages(true);
   }
-  myOSystem.frameBuffer().showTextMessage(message);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool PNGLibrary::allocateStorage(png_uint_32 w, png_uint_32 h)
+string PNGLibrary::snapshotPath() const
+{
+  return myOSystem.snapshotSaveDir().getPath() +
+      (myOSystem.settings().getString("snapname") != "int" ?
+          myOSystem.romFile().getNameWithExt("")
+        : myOSystem.console().properties().get(PropType::Cart_Name));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+VariantList PNGLibrary::snapshotComments() const
+{
+  VariantList comments;
+  ostringstream version;
+  version << "Stella " << STELLA_VERSION << " (Build " << STELLA_BUILD << ") ["
+          << BSPF::ARCH << "]";
+  VarList::push_back(comments, "Software", version.str());
+  const string& name = (myOSystem.settings().getString("snapname") == "int")
+      ? myOSystem.console().properties().get(PropType::Cart_Name)
+      : myOSystem.romFile().getName();
+  VarList::push_back(comments, "ROM Name", name);
+  VarList::push_back(comments, "ROM MD5", myOSystem.console().properties().get(PropType::Cart_MD5));
+  VarList::push_back(comments, "TV Effects", myOSystem.frameBuffer().tiaSurface().effectsInfo());
+
+  return comments;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool PNGLibrary::allocateStorage(ImageData& image, png_uint_32 w, png_uint_32 h)
 {
   // Create space for the entire image (3 bytes per pixel in RGB format)
   size_t req_buffer_size = w * h * 3;
-  if(req_buffer_size > ReadInfo.buffer.size())
-    ReadInfo.buffer.resize(req_buffer_size);
-
-  size_t req_row_size = h;
-  if(req_row_size > ReadInfo.row_pointers.size())
-    ReadInfo.row_pointers.resize(req_row_size);
+  if(req_buffer_size > image.buffer.size())
+    image.buffer.resize(req_buffer_size);
 
-  ReadInfo.width  = w;
-  ReadInfo.height = h;
-  ReadInfo.pitch  = w * 3;
+  image.width  = w;
+  image.height = h;
+  image.pitch  = w * 3;
 
   return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void PNGLibrary::loadImagetoSurface(FBSurface& surface)
+void PNGLibrary::loadImage(const ImageData& image, FBSurface& surface)
 {
   // First determine if we need to resize the surface
-  uInt32 iw = ReadInfo.width, ih = ReadInfo.height;
+  uInt32 iw = image.width, ih = image.height;
   if(iw > surface.width() || ih > surface.height())
     surface.resize(iw, ih);
 
@@ -416,17 +650,18 @@ void PNGLibrary::loadImagetoSurface(FBSurface& surface)
   // Convert RGB triples into pixels and store in the surface
   uInt32 *s_buf, s_pitch;
   surface.basePtr(s_buf, s_pitch);
-  const uInt8* i_buf = ReadInfo.buffer.data();
-  const uInt32 i_pitch = ReadInfo.pitch;
+  const uInt8* i_buf = image.buffer.data();
+  const uInt32 i_pitch = image.pitch;
 
   const FrameBuffer& fb = myOSystem.frameBuffer();
   for(uInt32 irow = 0; irow < ih; ++irow, i_buf += i_pitch, s_buf += s_pitch)
   {
     const uInt8* i_ptr = i_buf;
     uInt32* s_ptr = s_buf;
-    for(uInt32 icol = 0; icol < ReadInfo.width; ++icol, i_ptr += 3)
+    for(uInt32 icol = 0; icol < image.width; ++icol, i_ptr += 3)
       *s_ptr++ = fb.mapRGB(*i_ptr, *(i_ptr+1), *(i_ptr+2));
   }
+  surface.setDirty(0, ih);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -481,6 +716,6 @@ void PNGLibrary::png_user_error(png_structp ctx, png_const_charp str)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-PNGLibrary::ReadInfoType PNGLibrary::ReadInfo;
+PNGLibrary::ImageData PNGLibrary::ReadInfo;
 
 #endif  // PNG_SUPPORT
@@ -21,6 +21,12 @@
 #define PNGLIBRARY_HXX
 
 #include <png.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
 
 class OSystem;
 class FrameBuffer;
@@ -28,6 +34,8 @@ class FBSurface;
 class Properties;
 
 #include "bspf.hxx"
+#include "FrameBufferConstants.hxx"
+#include "FrameCapture.hxx"
 
 /**
   This class implements a thin wrapper around the libpng library, and
@@ -40,6 +48,21 @@ class PNGLibrary
 {
   public:
     explicit PNGLibrary(OSystem& osystem);
+    ~PNGLibrary();
+
+    /**
+      Called on the main thread once an asynchronous save has finished,
+      with an empty string on success, otherwise with the error message.
+    */
+    using SaveCallback = std::function<void(const string& error)>;
+
+    /**
+      A decoded image, in RGB format (3 bytes per pixel).
+    */
+    struct ImageData {
+      vector<png_byte> buffer;
+      png_uint_32 width{0}, height{0}, pitch{0};
+    };
 
     /**
       Read a PNG image from the specified file into a FBSurface structure,
@@ -54,6 +77,28 @@ class PNGLibrary
     */
     void loadImage(const string& filename, FBSurface& surface);
 
+    /**
+      Load an image previously decoded by decodeImage() into a FBSurface
+      structure.
+
+      @param image    The decoded image data
+      @param surface  The FBSurface into which to place the image data
+    */
+    void loadImage(const ImageData& image, FBSurface& surface);
+
+    /**
+      Decode a PNG image from the specified file.  Unlike loadImage(), this
+      doesn't access any shared state, and may be called from any thread.
+
+      @param filename  The filename to load the PNG image
+      @param image     The decoded image data
+
+      @post  On success, 'image' contains the image data, otherwise a
+             runtime_error is thrown containing a more detailed
+             error message.
+    */
+    static void decodeImage(const string& filename, ImageData& image);
+
     /**
       Save the current FrameBuffer image to a PNG file.  Note that in most
       cases this will be a TIA image, but it could actually be used for
@@ -85,6 +130,48 @@ class PNGLibrary
                    const Common::Rect& rect = Common::EmptyRect,
                    const VariantList& comments = EmptyVarList);
 
+    /**
+      Like the saveImage() methods above, but only the pixel data is read
+      synchronously; the image is encoded and written to disk in the
+      background.  The callback is called from update().
+
+      @param filename  The filename to save the PNG image
+      @param comments  The text comments to add to the PNG image
+      @param callback  Called once the image has been saved (optional)
+    */
+    void saveImageAsync(const string& filename, const VariantList& comments,
+                        const SaveCallback& callback = nullptr);
+    void saveImageAsync(const string& filename, const FBSurface& surface,
+                        const Common::Rect& rect, const VariantList& comments,
+                        const SaveCallback& callback = nullptr);
+
+    /**
+      Call the callbacks of all asynchronous saves finished since the last
+      call.  This must be called regularly from the main thread.
+    */
+    void update();
+
+    /**
+      Save an indexed image to a PNG file, using a palette.  Unlike the other
+      saveImage() methods, this doesn't access any shared state, and may be
+      called from any thread.
+
+      @param filename  The filename to save the PNG image
+      @param pixels    The palette indices of the pixels, row by row
+      @param width     The width of the image
+      @param height    The height of the image
+      @param palette   The RGB palette (0x00RRGGBB)
+      @param comments  The text comments to add to the PNG image
+
+      @post  On success, the PNG file has been saved to 'filename',
+             otherwise a runtime_error is thrown containing a
+             more detailed error message.
+    */
+    static void saveImage(const string& filename, const uInt8* pixels,
+                          png_uint_32 width, png_uint_32 height,
+                          const PaletteArray& palette,
+                          const VariantList& comments = EmptyVarList);
+
     /**
       Called at regular intervals, and used to determine whether a
       continuous snapshot is due to be taken.
@@ -134,28 +221,74 @@ class PNGLibrary
     uInt32 mySnapInterval{0};
     uInt32 mySnapCounter{0};
 
-    // The following data remains between invocations of allocateStorage,
-    // and is only changed when absolutely necessary.
-    struct ReadInfoType {
+    // Encodes continuous snapshots in the background (pixel-exact images
+    // and videos only)
+    FrameCapture myCapture;
+
+    // An image waiting to be saved, in ABGR format
+    struct SaveJob {
+      string filename;
       vector<png_byte> buffer;
-      vector<png_bytep> row_pointers;
-      png_uint_32 width{0}, height{0}, pitch{0};
+      png_uint_32 width{0}, height{0};
+      VariantList comments;
+      SaveCallback callback;
+      string error;
     };
-    static ReadInfoType ReadInfo;
+
+    // Encodes the images of saveImageAsync(); started on first use
+    std::thread mySaveThread;
+    std::mutex mySaveMutex;
+    std::condition_variable mySaveCondition;
+    std::deque<SaveJob> mySaveJobs;
+    // Finished jobs, waiting for their callbacks to be called by update()
+    std::deque<SaveJob> mySavedJobs;
+    bool mySaveQuit{false};
+
+    // The files of unfinished jobs; only accessed from the main thread
+    std::unordered_set<string> myPendingFiles;
+
+    // The following data remains between invocations of allocateStorage,
+    // and is only changed when absolutely necessary.
+    static ImageData ReadInfo;
 
     /**
       Allocate memory for PNG read operations.  This is used to provide a
       basic memory manager, so that we don't constantly allocate and deallocate
       memory for each image loaded.
 
-      The method fills the 'ReadInfo' struct with valid memory locations
+      The method fills the 'image' struct with valid memory locations
       dependent on the given dimensions.  If memory has been previously
       allocated and it can accommodate the given dimensions, it is used directly.
 
+      @param image   The image data to (re)allocate
       @param iwidth  The width of the PNG image
       @param iheight The height of the PNG image
     */
-    bool allocateStorage(png_uint_32 iwidth, png_uint_32 iheight);
+    static bool allocateStorage(ImageData& image, png_uint_32 iwidth,
+                                png_uint_32 iheight);
+
+    /**
+      Read the pixels of the current FrameBuffer image or the given surface
+      into the job.
+    */
+    void readImage(SaveJob& job) const;
+    static void readImage(SaveJob& job, const FBSurface& surface,
+                          const Common::Rect& rect);
+
+    /**
+      Save the pixels of the job to a PNG file.
+    */
+    static void saveImage(const SaveJob& job);
+
+    /**
+      Queue the job for saving in the background.
+    */
+    void saveImageAsync(SaveJob& job, const SaveCallback& callback);
+
+    /**
+      Save the queued jobs until destruction.
+    */
+    void saveThreadMain();
 
     /** The actual method which saves a PNG image.
 
@@ -165,23 +298,25 @@ class PNGLibrary
       @param height   The height of the PNG image
       @param comments The text comments to add to the PNG image
     */
-    void saveImageToDisk(std::ofstream& out, const vector<png_bytep>& rows,
-                         png_uint_32 width, png_uint_32 height,
-                         const VariantList& comments);
+    static void saveImageToDisk(std::ofstream& out, const vector<png_bytep>& rows,
+                                png_uint_32 width, png_uint_32 height,
+                                const VariantList& comments);
 
     /**
-      Load the PNG data from 'ReadInfo' into the FBSurface.  The surface
-      is resized as necessary to accommodate the data.
+      Write PNG tEXt chunks to the image.
+    */
+    static void writeComments(png_structp png_ptr, png_infop info_ptr,
+                              const VariantList& comments);
 
-      @param surface  The FBSurface into which to place the PNG data
+    /**
+      Answer the path and name of snapshots, without extension.
     */
-    void loadImagetoSurface(FBSurface& surface);
+    string snapshotPath() const;
 
     /**
-      Write PNG tEXt chunks to the image.
+      Answer the text comments added to snapshots.
     */
-    void writeComments(png_structp png_ptr, png_infop info_ptr,
-                       const VariantList& comments);
+    VariantList snapshotComments() const;
 
     /** PNG library callback functions */
     static void png_read_data(png_structp ctx, png_bytep area, png_size_t size);
@@ -341,6 +341,24 @@ void PaletteHandler::setPalette()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 PaletteArray PaletteHandler::adjustedPalette(const PaletteArray& palette)
 {
+  const std::array<float, 5> adjustments = {
+    myHue, mySaturation, myContrast, myBrightness, myGamma
+  };
+  string key(reinterpret_cast<const char*>(adjustments.data()),
+             adjustments.size() * sizeof(float));
+  key.append(reinterpret_cast<const char*>(palette.data()),
+             palette.size() * sizeof(uInt32));
+
+  for(auto it = myPaletteCache.begin(); it != myPaletteCache.end(); ++it)
+  {
+    if(it->key == key)
+    {
+      // Keep the most recently used palettes at the front
+      std::rotate(myPaletteCache.begin(), it, it + 1);
+      return myPaletteCache.front().palette;
+    }
+  }
+
   PaletteArray destPalette;
   // Constants for saturation and gray scale calculation
   constexpr float PR = .2989F;
@@ -391,6 +409,11 @@ PaletteArray PaletteHandler::adjustedPalette(const PaletteArray& palette)
 
     destPalette[i + 1] = (lum << 16) + (lum << 8) + lum;
   }
+
+  if(myPaletteCache.size() == PALETTE_CACHE_SIZE)
+    myPaletteCache.pop_back();
+  myPaletteCache.push_front(CachedPalette{std::move(key), destPalette});
+
   return destPalette;
 }
 
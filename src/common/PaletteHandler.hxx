@@ -18,6 +18,8 @@
 #ifndef PALETTE_HANDLER_HXX
 #define PALETTE_HANDLER_HXX
 
+#include <deque>
+
 #include "bspf.hxx"
 #include "OSystem.hxx"
 #include "ConsoleTiming.hxx"
@@ -212,6 +214,7 @@ class PaletteHandler
 
     /**
       Create new palette by applying palette adjustments on given palette.
+      Recently adjusted palettes are reused.
 
       @param source  The palette which should be adjusted
 
@@ -303,6 +306,15 @@ class PaletteHandler
     // successfully loaded
     bool myUserPaletteDefined{false};
 
+    // The most recently adjusted palettes, keyed by source palette and
+    // adjustments, so that switching ROMs doesn't calculate them again
+    static constexpr size_t PALETTE_CACHE_SIZE = 8;
+    struct CachedPalette {
+      string key;
+      PaletteArray palette;
+    };
+    std::deque<CachedPalette> myPaletteCache;
+
     // Table of RGB values for NTSC, PAL and SECAM
     static const PaletteArray ourNTSCPalette;
     static const PaletteArray ourPALPalette;
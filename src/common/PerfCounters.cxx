@@ -0,0 +1,135 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#if defined(__linux__)
+  #include <cstring>
+  #include <linux/perf_event.h>
+  #include <sys/ioctl.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+#include "PerfCounters.hxx"
+
+#if defined(__linux__)
+namespace {
+  int openCounter(uInt32 type, uInt64 config)
+  {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    // User space only; counting the kernel requires privileges
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    // Calling thread, any CPU, no group
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+}
+#endif
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+PerfCounters::PerfCounters()
+{
+  myFds.fill(-1);
+
+#if defined(__linux__)
+  myFds[static_cast<uInt32>(Counter::instructions)] =
+    openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+  myFds[static_cast<uInt32>(Counter::cycles)] =
+    openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+  myFds[static_cast<uInt32>(Counter::branchMisses)] =
+    openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+  myFds[static_cast<uInt32>(Counter::cacheMisses)] =
+    openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+PerfCounters::~PerfCounters()
+{
+#if defined(__linux__)
+  for(int fd: myFds)
+    if(fd >= 0) close(fd);
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool PerfCounters::available() const
+{
+  return std::any_of(myFds.begin(), myFds.end(), [](int fd) { return fd >= 0; });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PerfCounters::start()
+{
+#if defined(__linux__)
+  for(int fd: myFds)
+    if(fd >= 0)
+    {
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+PerfCounters::Values PerfCounters::stop()
+{
+  Values values;
+
+#if defined(__linux__)
+  for(int fd: myFds)
+    if(fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+  for(uInt32 i = 0; i < NUM_COUNTERS; ++i)
+  {
+    if(myFds[i] < 0)
+      continue;
+
+    // value, time enabled, time running
+    std::array<uInt64, 3> data{0};
+    if(read(myFds[i], data.data(), sizeof(data)) != sizeof(data) || data[2] == 0)
+      continue;
+
+    // Extrapolate if the counter had to share the PMU with others
+    values.count[i] = data[2] < data[1]
+      ? uInt64(double(data[0]) * data[1] / data[2])
+      : data[0];
+    values.available[i] = true;
+  }
+#endif
+
+  return values;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string PerfCounters::name(Counter counter)
+{
+  switch(counter)
+  {
+    case Counter::instructions: return "instructions";
+    case Counter::cycles:       return "cpuCycles";
+    case Counter::branchMisses: return "branchMisses";
+    case Counter::cacheMisses:  return "cacheMisses";
+    default:                    return "";
+  }
+}
@@ -0,0 +1,97 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef PERF_COUNTERS_HXX
+#define PERF_COUNTERS_HXX
+
+#include "bspf.hxx"
+
+/**
+  Counts hardware events (retired instructions, CPU cycles, branch and
+  cache misses) of the calling thread between start() and stop(), for
+  benchmarks which need more than the wall time.
+
+  The counters are implemented with perf_event_open on Linux.  Events
+  which can't be counted (other platforms, no PMU in a virtual machine,
+  restrictive 'perf_event_paranoid' settings) are reported as not
+  available.  The counts are scaled if the kernel multiplexed the
+  counters.
+
+  @author  Stella Team
+*/
+class PerfCounters
+{
+  public:
+    enum class Counter: uInt8 {
+      instructions, cycles, branchMisses, cacheMisses, numCounters
+    };
+    static constexpr uInt32 NUM_COUNTERS = static_cast<uInt32>(Counter::numCounters);
+
+    struct Values {
+      std::array<uInt64, NUM_COUNTERS> count{0};
+      std::array<bool, NUM_COUNTERS> available{false};
+
+      uInt64 operator[](Counter counter) const {
+        return count[static_cast<uInt32>(counter)];
+      }
+      bool has(Counter counter) const {
+        return available[static_cast<uInt32>(counter)];
+      }
+    };
+
+  public:
+    /**
+      Open the counters for the calling thread (they are not started yet).
+    */
+    PerfCounters();
+    ~PerfCounters();
+
+    /**
+      Whether any of the counters can be used.
+    */
+    bool available() const;
+
+    /**
+      Reset and start counting.
+    */
+    void start();
+
+    /**
+      Stop counting.
+
+      @return  The counts since start()
+    */
+    Values stop();
+
+    /**
+      Name of the counter in reports.
+    */
+    static string name(Counter counter);
+
+  private:
+    // File descriptors of the counters, -1 if not available
+    std::array<int, NUM_COUNTERS> myFds;
+
+  private:
+    // Following constructors and assignment operators not supported
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters(PerfCounters&&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+    PerfCounters& operator=(PerfCounters&&) = delete;
+};
+
+#endif // PERF_COUNTERS_HXX
@@ -15,6 +15,8 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <cmath>
+
 #include "PhosphorHandler.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -27,23 +29,106 @@ bool PhosphorHandler::initialize(bool enable, int blend)
   if(blend >= 0 && blend <= 100)
     myPhosphorPercent = blend / 100.F;
 
-  // Used to calculate an averaged color for the 'phosphor' effect
-  auto getPhosphor = [&] (const uInt8 c1, uInt8 c2) -> uInt8 {
-    // Use maximum of current and decayed previous values
-    c2 = static_cast<uInt8>(c2 * myPhosphorPercent);
-    if(c1 > c2)  return c1; // raise (assumed immediate)
-    else         return c2; // decay
-  };
-
-  // Precalculate the average colors for the 'phosphor' effect
+  // The blend works on fixed point values, so that it maps to plain
+  // multiplies and shifts (and vectorizes)
   if(myUsePhosphor)
+    ourPhosphorFactor = static_cast<uInt32>(std::lround(myPhosphorPercent * 256));
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PhosphorHandler::blend(const uInt32* current, uInt32* previous,
+                            uInt32* out, uInt32 count)
+{
+  const uInt16 factor = static_cast<uInt16>(ourPhosphorFactor);
+  uInt32 i = 0;
+
+  for(; i + BLOCK <= count; i += BLOCK)
+    blendBlock(current + i, previous + i, out + i, factor);
+
+  if(i == count)
+    return;
+
+  // Pass the remaining pixels through a padded block
+  std::array<uInt32, BLOCK> c{}, p{};
+  std::copy_n(current + i, count - i, c.begin());
+  std::copy_n(previous + i, count - i, p.begin());
+
+  blendBlock(c.data(), p.data(), p.data(), factor);
+
+  std::copy_n(p.begin(), count - i, previous + i);
+  std::copy_n(p.begin(), count - i, out + i);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PhosphorHandler::average(const uInt32* a, const uInt32* b, uInt32* out,
+                              uInt32 count)
+{
+  uInt32 i = 0;
+
+  for(; i + BLOCK <= count; i += BLOCK)
+    averageBlock(a + i, b + i, out + i);
+
+  if(i == count)
+    return;
+
+  // Pass the remaining pixels through a padded block
+  std::array<uInt32, BLOCK> ca{}, cb{};
+  std::copy_n(a + i, count - i, ca.begin());
+  std::copy_n(b + i, count - i, cb.begin());
+
+  averageBlock(ca.data(), cb.data(), ca.data());
+
+  std::copy_n(ca.begin(), count - i, out + i);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void PhosphorHandler::blendBlock(const uInt32* current, uInt32* previous,
+                                        uInt32* out, uInt16 factor)
+{
+  // All channels are treated alike, so the pixels are processed as a plain
+  // array of bytes. Working on local copies of fixed size lets the compiler
+  // vectorize without having to care about aliasing.
+  std::array<uInt8, BLOCK * 4> c, p;
+  std::memcpy(c.data(), current, BLOCK * 4);
+  std::memcpy(p.data(), previous, BLOCK * 4);
+
+  for(uInt32 i = 0; i < BLOCK * 4; ++i)
   {
-    for(int c = 255; c >= 0; --c)
-      for(int p = 255; p >= 0; --p)
-        ourPhosphorLUT[c][p] = getPhosphor(uInt8(c), uInt8(p));
+    // Use maximum of current and decayed previous values
+    p[i] = std::max(c[i], static_cast<uInt8>((p[i] * factor) >> 8));
   }
-  return true;
+
+  std::array<uInt32, BLOCK> result;
+  std::memcpy(result.data(), p.data(), BLOCK * 4);
+
+  for(uInt32 i = 0; i < BLOCK; ++i)
+    result[i] &= 0x00FFFFFF;
+
+  std::memcpy(previous, result.data(), BLOCK * 4);
+  std::memcpy(out, result.data(), BLOCK * 4);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void PhosphorHandler::averageBlock(const uInt32* a, const uInt32* b,
+                                          uInt32* out)
+{
+  std::array<uInt8, BLOCK * 4> ca, cb;
+  std::memcpy(ca.data(), a, BLOCK * 4);
+  std::memcpy(cb.data(), b, BLOCK * 4);
+
+  for(uInt32 i = 0; i < BLOCK * 4; ++i)
+    ca[i] = static_cast<uInt8>((ca[i] + cb[i]) >> 1);
+
+  std::array<uInt32, BLOCK> result;
+  std::memcpy(result.data(), ca.data(), BLOCK * 4);
+
+  for(uInt32 i = 0; i < BLOCK; ++i)
+    result[i] &= 0x00FFFFFF;
+
+  std::memcpy(out, result.data(), BLOCK * 4);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-PhosphorHandler::PhosphorLUT PhosphorHandler::ourPhosphorLUT;
+uInt32 PhosphorHandler::ourPhosphorFactor = 154;
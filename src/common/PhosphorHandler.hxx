@@ -31,26 +31,37 @@ class PhosphorHandler
     bool phosphorEnabled() const { return myUsePhosphor; }
 
     /**
-      Used to calculate an averaged color pixel for the 'phosphor' effect.
+      Blend a row of pixels for the 'phosphor' effect: each channel is the
+      maximum of its current value and its decayed previous value. The
+      result is written to both 'out' (which may equal 'current') and
+      'previous', which then holds the history for the next frame.
 
-      @param c  RGB Color 1 (current frame)
-      @param p  RGB Color 2 (previous frame)
+      @param current   RGB colors of the current frame
+      @param previous  RGB colors displayed in the previous frame
+      @param out       The blended RGB colors
+      @param count     Number of pixels
+    */
+    static void blend(const uInt32* current, uInt32* previous, uInt32* out,
+                      uInt32 count);
+
+    /**
+      Mix two rows of pixels 50:50.
 
-      @return  Averaged value of the two RGB colors
+      @param a, b   The RGB colors to mix
+      @param out    The averaged RGB colors (may equal a or b)
+      @param count  Number of pixels
     */
-    static constexpr uInt32 getPixel(const uInt32 c, const uInt32 p)
-    {
-      // Mix current calculated frame with previous displayed frame
-      const uInt8 rc = static_cast<uInt8>(c >> 16),
-                  gc = static_cast<uInt8>(c >> 8),
-                  bc = static_cast<uInt8>(c),
-                  rp = static_cast<uInt8>(p >> 16),
-                  gp = static_cast<uInt8>(p >> 8),
-                  bp = static_cast<uInt8>(p);
-
-      return (ourPhosphorLUT[rc][rp] << 16) | (ourPhosphorLUT[gc][gp] << 8) |
-              ourPhosphorLUT[bc][bp];
-    }
+    static void average(const uInt32* a, const uInt32* b, uInt32* out,
+                        uInt32 count);
+
+  private:
+    // Pixels processed at once by blend() and average()
+    static constexpr uInt32 BLOCK = 4;
+
+    // Process exactly BLOCK pixels
+    static void blendBlock(const uInt32* current, uInt32* previous,
+                           uInt32* out, uInt16 factor);
+    static void averageBlock(const uInt32* a, const uInt32* b, uInt32* out);
 
   private:
     // Use phosphor effect
@@ -59,9 +70,8 @@ class PhosphorHandler
     // Amount to blend when using phosphor effect
     float myPhosphorPercent{0.60F};
 
-    // Precalculated averaged phosphor colors
-    using PhosphorLUT = BSPF::array2D<uInt8, kColor, kColor>;
-    static PhosphorLUT ourPhosphorLUT;
+    // The decay of the previous frame, in 1/256
+    static uInt32 ourPhosphorFactor;
 
   private:
     PhosphorHandler(const PhosphorHandler&) = delete;
@@ -63,7 +63,7 @@ void PhysicalJoystick::initialize(int index, const string& desc,
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-json PhysicalJoystick::getMap() const
+json PhysicalJoystick::saveMap(const string& name, const JoyMap::JoyMappingList& mappings)
 {
   json mapping = json::object();
 
@@ -72,13 +72,13 @@ json PhysicalJoystick::getMap() const
   for (auto& mode: {
     EventMode::kMenuMode, EventMode::kJoystickMode, EventMode::kPaddlesMode, EventMode::kKeyboardMode, EventMode::kCommonMode
   })
-    mapping[jsonName(mode)] = joyMap.saveMapping(mode);
+    mapping[jsonName(mode)] = JoyMap::saveMapping(mappings, mode);
 
   return mapping;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool PhysicalJoystick::setMap(const json& map)
+bool PhysicalJoystick::parseMap(const json& map, JoyMap::JoyMappingList& mappings)
 {
   int i = 0;
 
@@ -86,7 +86,7 @@ bool PhysicalJoystick::setMap(const json& map)
     if (entry.key() == "name") continue;
 
     try {
-      joyMap.loadMapping(entry.value(), eventModeFromJsonName(entry.key()));
+      JoyMap::parseMapping(entry.value(), eventModeFromJsonName(entry.key()), mappings);
     } catch (const json::exception&) {
       Logger::error("ignoring invalid json mapping for " + entry.key());
     }
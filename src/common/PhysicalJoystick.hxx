@@ -45,8 +45,13 @@ class PhysicalJoystick
   public:
     PhysicalJoystick() = default;
 
-    nlohmann::json getMap() const;
-    bool setMap(const nlohmann::json& map);
+    /** The stick's mappings, resp. add the given ones */
+    JoyMap::JoyMappingList getMap() const { return joyMap.getMappings(); }
+    void setMap(const JoyMap::JoyMappingList& mappings) { joyMap.add(mappings); }
+
+    /** Convert mappings from and to their JSON form, as saved in settings */
+    static bool parseMap(const nlohmann::json& map, JoyMap::JoyMappingList& mappings);
+    static nlohmann::json saveMap(const string& name, const JoyMap::JoyMappingList& mappings);
 
     static nlohmann::json convertLegacyMapping(const string& mapping, const string& name);
 
@@ -0,0 +1,55 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include <algorithm>
+#include <thread>
+
+#include "PreciseSleep.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+PreciseSleep::Clock::duration PreciseSleep::waitUntil(Clock::time_point deadline)
+{
+  Clock::time_point now = Clock::now();
+
+  if(!mySpinning)
+  {
+    std::this_thread::sleep_until(deadline);
+    now = Clock::now();
+
+    return now > deadline ? now - deadline : Clock::duration::zero();
+  }
+
+  const Clock::time_point wakeup = deadline - myMargin;
+  if(wakeup > now)
+  {
+    std::this_thread::sleep_until(wakeup);
+    now = Clock::now();
+
+    const Clock::duration late = now - wakeup;
+    myMargin = std::clamp(std::max(late + MARGIN_RESERVE, myMargin - myMargin / 64),
+                          MIN_MARGIN, MAX_MARGIN);
+  }
+
+  while(now < deadline)
+  {
+    std::this_thread::yield();
+    now = Clock::now();
+  }
+
+  return now - deadline;
+}
@@ -0,0 +1,74 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef PRECISE_SLEEP_HXX
+#define PRECISE_SLEEP_HXX
+
+#include <chrono>
+
+#include "bspf.hxx"
+
+/**
+  Waits for a deadline more precisely than std::this_thread::sleep_until(),
+  which may return up to a timer tick of the OS (1 to 15 ms) late.  It
+  sleeps until shortly before the deadline, and yields the CPU in a loop
+  for the rest.  The margin left for this adapts to how late the previous
+  sleeps returned: it grows at once, and shrinks slowly.
+
+  @author  Stella Team
+*/
+class PreciseSleep
+{
+  public:
+    using Clock = std::chrono::high_resolution_clock;
+
+    PreciseSleep() = default;
+
+    /**
+      Enable or disable spinning before the deadline; without it, the
+      wait is a plain sleep.
+    */
+    void setSpinning(bool enable) { mySpinning = enable; }
+
+    /**
+      Wait until the given deadline.
+
+      @return  How late the wait returned
+    */
+    Clock::duration waitUntil(Clock::time_point deadline);
+
+  private:
+    // The margin stays within these limits; above the maximum, spinning
+    // would cost more CPU time than it is worth
+    static constexpr Clock::duration MIN_MARGIN = std::chrono::microseconds(500);
+    static constexpr Clock::duration MAX_MARGIN = std::chrono::milliseconds(4);
+    // Added to the measured lateness, to cover its jitter
+    static constexpr Clock::duration MARGIN_RESERVE = std::chrono::microseconds(250);
+
+    bool mySpinning{true};
+    Clock::duration myMargin{std::chrono::milliseconds(2)};
+
+  private:
+    // Following constructors and assignment operators not supported
+    PreciseSleep(const PreciseSleep&) = delete;
+    PreciseSleep(PreciseSleep&&) = delete;
+    PreciseSleep& operator=(const PreciseSleep&) = delete;
+    PreciseSleep& operator=(PreciseSleep&&) = delete;
+};
+
+#endif // PRECISE_SLEEP_HXX
@@ -16,6 +16,9 @@
 //============================================================================
 
 #include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
 
 #include "OSystem.hxx"
 #include "Console.hxx"
@@ -23,9 +26,104 @@
 #include "StateManager.hxx"
 #include "TIA.hxx"
 #include "EventHandler.hxx"
+#include "TraceRecorder.hxx"
+#include "EventCounters.hxx"
+#include "Logger.hxx"
 
 #include "RewindManager.hxx"
 
+namespace {
+  // Differences are stored as a sequence of (unchanged count, changed count,
+  // changed bytes) records; counts are stored as 7-bit varints.
+  // Unchanged runs shorter than this are merged into the surrounding
+  // changed run, as the record overhead would outweigh the savings.
+  constexpr size_t MIN_UNCHANGED_RUN = 4;
+
+  // Error of the leaves not used by any state
+  constexpr double UNUSED_ERROR = -std::numeric_limits<double>::infinity();
+
+  inline uInt64 getWord(const uInt8* p)
+  {
+    uInt64 word;
+    std::memcpy(&word, p, sizeof(word));
+    return word;
+  }
+
+  void putCount(ByteArray& out, size_t count)
+  {
+    while(count >= 0x80)
+    {
+      out.push_back(static_cast<uInt8>(count | 0x80));
+      count >>= 7;
+    }
+    out.push_back(static_cast<uInt8>(count));
+  }
+
+  size_t getCount(const uInt8*& in)
+  {
+    size_t count = 0;
+    int shift = 0;
+
+    do {
+      count |= size_t(*in & 0x7f) << shift;
+      shift += 7;
+    } while(*in++ & 0x80);
+
+    return count;
+  }
+
+  void encodeDelta(const uInt8* base, const uInt8* data, size_t size,
+                   ByteArray& out)
+  {
+    out.clear();
+
+    size_t i = 0;
+    while(i < size)
+    {
+      const size_t unchangedStart = i;
+      // Most of a state is unchanged, so skip those parts a word at a time
+      while(i + sizeof(uInt64) <= size && getWord(data + i) == getWord(base + i))
+        i += sizeof(uInt64);
+      while(i < size && data[i] == base[i]) ++i;
+
+      const size_t changedStart = i;
+      while(i < size)
+      {
+        if(data[i] != base[i]) { ++i; continue; }
+
+        size_t j = i;
+        while(j < size && j - i < MIN_UNCHANGED_RUN && data[j] == base[j]) ++j;
+        if(j == size || j - i >= MIN_UNCHANGED_RUN) break;
+
+        i = j;
+      }
+
+      putCount(out, changedStart - unchangedStart);
+      putCount(out, i - changedStart);
+      out.insert(out.end(), data + changedStart, data + i);
+    }
+  }
+
+  void decodeDelta(const uInt8* base, const ByteArray& delta, uInt8* out)
+  {
+    const uInt8* in = delta.data();
+    const uInt8* end = in + delta.size();
+    size_t i = 0;
+
+    while(in < end)
+    {
+      const size_t unchanged = getCount(in);
+      std::copy_n(base + i, unchanged, out + i);
+      i += unchanged;
+
+      const size_t changed = getCount(in);
+      std::copy_n(in, changed, out + i);
+      in += changed;
+      i += changed;
+    }
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 RewindManager::RewindManager(OSystem& system, StateManager& statemgr)
   : myOSystem{system},
@@ -37,6 +135,8 @@ RewindManager::RewindManager(OSystem& system, StateManager& statemgr)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void RewindManager::setup()
 {
+  finishPendingState();
+
   myLastTimeMachineAdd = false;
 
   const string& prefix = myOSystem.settings().getBool("dev.settings") ? "dev." : "plr.";
@@ -51,6 +151,10 @@ void RewindManager::setup()
   myUncompressed = std::min<uInt32>(
       myOSystem.settings().getInt(prefix + "tm.uncompressed"), MAX_BUF_SIZE);
 
+  myMemoryBudget = uInt64(std::max(
+      myOSystem.settings().getInt(prefix + "tm.memory"), 0)) << 20;
+  setupArchive(myMemoryBudget != 0 && myOSystem.settings().getBool(prefix + "tm.archive"));
+
   myInterval = INTERVAL_CYCLES[0];
   for(int i = 0; i < NUM_INTERVALS; ++i)
     if(INT_SETTINGS[i] == myOSystem.settings().getString(prefix + "tm.interval"))
@@ -93,11 +197,41 @@ void RewindManager::setup()
     else
       maxFactor = myFactor;
   }
+
+  // The errors depend on the factor
+  rebuildErrorTree();
+
+  // The budget may have been lowered
+  enforceMemoryBudget();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RewindManager::~RewindManager()
+{
+  if(myWorker.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lock(myMutex);
+      myQuit = true;
+    }
+    myCondition.notify_all();
+
+    myWorker.join();
+  }
+
+  // The archive is useless without the states referring to it
+  if(myArchive.is_open())
+  {
+    myArchive.close();
+    std::remove(myArchivePath.c_str());
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool RewindManager::addState(const string& message, bool timeMachine)
 {
+  finishPendingState();
+
   // only check for Time Machine states, ignore for debugger
   if(timeMachine && myStateList.currentIsValid())
   {
@@ -118,7 +252,47 @@ bool RewindManager::addState(const string& message, bool timeMachine)
       return false;
   }
 
+  // Taking the snapshot is all that has to happen on this thread
+  TraceRecorder::Scope traceScope("RewindCapture", "rewind");
+  uInt32 size = serializeCurrentState();
+  traceScope.setArg("bytes", size);
+  if(size == 0)
+    return false;
+
+  EventCounters::count(EventCounters::Event::rewindCapture);
+
+  const uInt64 cycles = myOSystem.console().tia().cycles();
+  const uInt32 height = myOSystem.console().tia().height();
+
+  // Debugger states are usually accessed right away, so only defer
+  // the Time Machine's periodic states
+  if(!timeMachine)
+  {
+    insertState(size, message, cycles, timeMachine, height);
+    return true;
+  }
+
+  if(!myWorker.joinable())
+    myWorker = std::thread(&RewindManager::workerMain, this);
+
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    myPendingState = PendingState{size, message, cycles, timeMachine, height};
+    myHasPendingState = true;
+  }
+  myCondition.notify_all();
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::insertState(uInt32 size, const string& message,
+                                uInt64 cycles, bool timeMachine, uInt32 height)
+{
   // Remove all future states
+  releaseStates(myStateList.currentIsValid()
+                ? myStateList.next(myStateList.currentIter()) : myStateList.cbegin());
   myStateList.removeToLast();
 
   // Make sure we never run out of space
@@ -128,46 +302,413 @@ bool RewindManager::addState(const string& message, bool timeMachine)
   // Add new state at the end of the list (queue adds at end)
   // This updates the 'current' iterator inside the list
   myStateList.addLast();
+  storeLastState(myStateBuffer.data(), size);
+  createThumbnail(myStateBuffer.data(), size, height);
+
   RewindState& state = myStateList.current();
-  Serializer& s = state.data;
+  state.message = message;
+  state.cycles = cycles;
+  addLastError();
+  myLastTimeMachineAdd = timeMachine;
+
+  enforceMemoryBudget();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::workerMain()
+{
+  if(TraceRecorder::enabled()) TraceRecorder::instance().setThreadName("Rewind");
+
+  std::unique_lock<std::mutex> lock(myMutex);
 
-  s.rewind();  // rewind Serializer internal buffers
-  if(myStateManager.saveState(s) && myOSystem.console().tia().saveDisplay(s))
+  for(;;)
   {
-    state.message = message;
-    state.cycles = myOSystem.console().tia().cycles();
-    myLastTimeMachineAdd = timeMachine;
-    return true;
+    myCondition.wait(lock, [this]() { return myQuit || myHasPendingState; });
+    if(myQuit)
+      return;
+
+    const PendingState state = myPendingState;
+
+    // Nobody touches the state list while a state is pending, so it can
+    // be modified without holding the lock
+    lock.unlock();
+    {
+      TraceRecorder::Scope traceScope("RewindInsert", "rewind");
+      insertState(state.size, state.message, state.cycles, state.timeMachine,
+                  state.height);
+    }
+    lock.lock();
+
+    myHasPendingState = false;
+    myCondition.notify_all();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::finishPendingState() const
+{
+  if(!myWorker.joinable())
+    return;
+
+  std::unique_lock<std::mutex> lock(myMutex);
+  myCondition.wait(lock, [this]() { return !myHasPendingState; });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 RewindManager::serializeCurrentState()
+{
+  for(int attempt = 0; attempt < 2; ++attempt)
+  {
+    if(!myStateBuffer.empty())
+    {
+      Serializer s(myStateBuffer.data(), myStateBuffer.size());
+
+      if(myStateManager.saveState(s) && myOSystem.console().tia().saveDisplay(s))
+        return uInt32(s.size());
+    }
+
+    // The buffer is missing or too small; determine the required size
+    // using a stream, and leave some headroom for growing states
+    Serializer probe;
+    if(!(myStateManager.saveState(probe) &&
+         myOSystem.console().tia().saveDisplay(probe)))
+      return 0;
+
+    myStateBuffer.resize(probe.size() + probe.size() / 4);
+  }
+
+  return 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::storeLastState(const uInt8* data, uInt32 size)
+{
+  const auto last = myStateList.last();
+  RewindState& state = myStateList.current();
+
+  state.size = size;
+  state.archiveSize = 0;
+  state.lastUse = ++myUseCount;
+  myMemoryUsed -= state.data.capacity();
+
+  // Find the keyframe this state would be based on
+  uInt32 distance = 0;
+  auto base = last;
+  while(base != myStateList.first() && distance < KEYFRAME_INTERVAL)
+  {
+    base = myStateList.previous(base);
+    ++distance;
+
+    if(base->keyframe) break;
+  }
+
+  if(base != last && base->keyframe && distance < KEYFRAME_INTERVAL &&
+     base->size == size)
+  {
+    encodeDelta(stateData(*base).data(), data, size, state.data);
+
+    // Only keep the difference if it actually saves a significant amount
+    // of memory; otherwise this state makes for a better keyframe
+    if(state.data.size() < size / 2)
+    {
+      // The node may have held a keyframe before
+      if(state.data.capacity() > state.data.size() * 2)
+        state.data.shrink_to_fit();
+
+      state.keyframe = false;
+      myMemoryUsed += state.data.capacity();
+      return;
+    }
+  }
+
+  state.data.assign(data, data + size);
+  state.keyframe = true;
+  myMemoryUsed += state.data.capacity();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::createThumbnail(const uInt8* data, uInt32 size, uInt32 height)
+{
+  RewindState& state = myStateList.current();
+  const uInt8* frame = TIA::savedFrame(data, size);
+  const uInt32 rows = std::min(height, TIAConstants::frameBufferHeight) / THUMBNAIL_SCALE;
+
+  myMemoryUsed -= state.thumbnail.capacity();
+  state.thumbnail.clear();
+  state.thumbnailHeight = rows;
+
+  // Sample every THUMBNAIL_SCALE-th pixel of every THUMBNAIL_SCALE-th line,
+  // and store each row as runs of (count, color)
+  for(uInt32 row = 0; row < rows; ++row)
+  {
+    const uInt8* line = frame + row * THUMBNAIL_SCALE * TIAConstants::H_PIXEL;
+
+    for(uInt32 x = 0; x < THUMBNAIL_W; )
+    {
+      const uInt8 color = line[x * THUMBNAIL_SCALE];
+      uInt32 count = 1;
+
+      while(x + count < THUMBNAIL_W && line[(x + count) * THUMBNAIL_SCALE] == color)
+        ++count;
+      state.thumbnail.push_back(uInt8(count));
+      state.thumbnail.push_back(color);
+      x += count;
+    }
+  }
+  if(state.thumbnail.capacity() > state.thumbnail.size() * 2)
+    state.thumbnail.shrink_to_fit();
+  myMemoryUsed += state.thumbnail.capacity();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::decodeState(Common::LinkedObjectPool<RewindState>::const_iter it,
+                                ByteArray& buffer)
+{
+  buffer.resize(it->size);
+
+  if(it->keyframe)
+  {
+    std::copy_n(stateData(*it).data(), it->size, buffer.data());
+    return;
+  }
+
+  auto base = it;
+  while(!base->keyframe) base = myStateList.previous(base);
+
+  decodeDelta(stateData(*base).data(), stateData(*it), buffer.data());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::removeState(Common::LinkedObjectPool<RewindState>::const_iter it)
+{
+  const uInt32 pos = uInt32(it - myStateList.cbegin());
+  const uInt32 leaf = it->leaf;
+  auto next = myStateList.next(it);
+
+  if(it->keyframe && next != myStateList.cend() && !next->keyframe)
+  {
+    // The successor becomes the new keyframe...
+    decodeState(next, myTempBuffer);
+    myMemoryUsed -= next->data.capacity();
+    next->data.swap(myTempBuffer);
+    myMemoryUsed += next->data.capacity();
+    next->keyframe = true;
+    next->archiveSize = 0;
+
+    // ...and all states that depended on the removed keyframe are
+    // re-encoded against it
+    for(auto dep = myStateList.next(next);
+        dep != myStateList.cend() && !dep->keyframe; dep = myStateList.next(dep))
+    {
+      myTempBuffer.resize(dep->size);
+      decodeDelta(it->data.data(), stateData(*dep), myTempBuffer.data());
+      myMemoryUsed -= dep->data.capacity();
+      dep->archiveSize = 0;
+
+      if(dep->size == next->size)
+      {
+        encodeDelta(next->data.data(), myTempBuffer.data(), dep->size, dep->data);
+        if(dep->data.capacity() > dep->data.size() * 2)
+          dep->data.shrink_to_fit();
+      }
+      else
+      {
+        dep->data.swap(myTempBuffer);
+        dep->keyframe = true;
+      }
+      myMemoryUsed += dep->data.capacity();
+    }
+  }
+
+  // Free the data of the removed node, so that the memory used is
+  // determined by the states in the list only
+  myMemoryUsed -= it->data.capacity() + it->thumbnail.capacity();
+  ByteArray().swap(it->data);
+  ByteArray().swap(it->thumbnail);
+  it->archiveSize = 0;
+
+  myStateList.remove(it);
+
+  // All following states moved one position ahead, and the neighbours of
+  // the removed state got a new predecessor resp. successor
+  setErrorLeaf(leaf, UNUSED_ERROR, false);
+  addError(1, 0, myErrorLeaves, leaf + 1, myErrorLeaves, myLogFactor);
+  if(pos > 0)
+    updateError(pos - 1);
+  updateError(pos);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::enforceMemoryBudget()
+{
+  if(myMemoryBudget == 0 || myMemoryUsed <= myMemoryBudget)
+    return;
+
+  if(myArchive.is_open())
+  {
+    // Move the data of the least recently used states into the archive
+    std::vector<const RewindState*> resident;
+    for(auto it = myStateList.cbegin(); it != myStateList.cend(); ++it)
+      if(!it->data.empty() && it != myStateList.currentIter())
+        resident.push_back(&*it);
+
+    std::sort(resident.begin(), resident.end(),
+        [](const RewindState* a, const RewindState* b) { return a->lastUse < b->lastUse; });
+
+    for(const RewindState* state: resident)
+      if(myMemoryUsed <= myMemoryBudget || !archiveState(*state))
+        break;
+
+    if(myMemoryUsed <= myMemoryBudget)
+      return;
+  }
+
+  // The current (last) state is never removed by compression
+  while(myMemoryUsed > myMemoryBudget && myStateList.size() > 1)
+    compressStates();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const ByteArray& RewindManager::stateData(const RewindState& state)
+{
+  state.lastUse = ++myUseCount;
+
+  if(state.data.empty() && state.archiveSize != 0)
+  {
+    // Page the data back in; the copy in the archive stays valid until the
+    // data is modified
+    state.data.resize(state.archiveSize);
+    myArchive.seekg(state.archiveOffset);
+    myArchive.read(reinterpret_cast<char*>(state.data.data()), state.archiveSize);
+    if(!myArchive)
+    {
+      myArchive.clear();
+      Logger::error("ERROR: Time Machine archive could not be read");
+    }
+    myMemoryUsed += state.data.capacity();
+  }
+
+  return state.data;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindManager::archiveState(const RewindState& state)
+{
+  if(state.archiveSize == 0)
+  {
+    myArchive.seekp(myArchiveEnd);
+    myArchive.write(reinterpret_cast<const char*>(state.data.data()), state.data.size());
+    if(!myArchive)
+    {
+      myArchive.clear();
+      return false;
+    }
+    state.archiveOffset = myArchiveEnd;
+    state.archiveSize = uInt32(state.data.size());
+    myArchiveEnd += state.archiveSize;
+  }
+
+  myMemoryUsed -= state.data.capacity();
+  ByteArray().swap(state.data);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::setupArchive(bool enable)
+{
+  if(enable == myArchive.is_open())
+    return;
+
+  if(enable)
+  {
+    myArchivePath = myOSystem.stateDir().getPath() + ARCHIVE_FILE;
+    myArchive.open(myArchivePath,
+        std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!myArchive)
+    {
+      myArchive.clear();
+      Logger::error("ERROR: Time Machine archive '" + myArchivePath +
+                    "' could not be created");
+    }
+    myArchiveEnd = 0;
+  }
+  else
+  {
+    // All data has to be kept in RAM again
+    for(auto it = myStateList.cbegin(); it != myStateList.cend(); ++it)
+    {
+      stateData(*it);
+      it->archiveSize = 0;
+    }
+    myArchive.close();
+    std::remove(myArchivePath.c_str());
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::releaseStates(Common::LinkedObjectPool<RewindState>::const_iter it)
+{
+  for(; it != myStateList.cend(); ++it)
+  {
+    setErrorLeaf(it->leaf, UNUSED_ERROR, false);
+    myMemoryUsed -= it->data.capacity() + it->thumbnail.capacity();
+    ByteArray().swap(it->data);
+    ByteArray().swap(it->thumbnail);
+    it->archiveSize = 0;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::resize(uInt32 size)
+{
+  finishPendingState();
+
+  if(size != myStateList.capacity())
+  {
+    // Resizing drops all states, including their data
+    myStateList.resize(size);
+    myMemoryUsed = 0;
+    myArchiveEnd = 0;
+    rebuildErrorTree();
   }
-  return false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::clear()
+{
+  finishPendingState();
+
+  releaseStates(myStateList.cbegin());
+  myStateList.clear();
+  myArchiveEnd = 0;
+  rebuildErrorTree();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 RewindManager::rewindStates(uInt32 numStates)
 {
+  finishPendingState();
+
   uInt64 startCycles = myOSystem.console().tia().cycles();
-  uInt32 i;
+  uInt32 i = 0;
   string message;
 
-  for(i = 0; i < numStates; ++i)
+  if(numStates > 0 && !atFirst())
   {
-    if(!atFirst())
+    // The first step doesn't move when the last state was added
+    // automatically, because that already happened one interval before
+    if(myLastTimeMachineAdd)
     {
-      if(!myLastTimeMachineAdd)
-        // Set internal current iterator to previous state (back in time),
-        // since we will now process this state...
-        myStateList.moveToPrevious();
-      else
-        // ...except when the last state was added automatically,
-        // because that already happened one interval before
-        myLastTimeMachineAdd = false;
-
-      RewindState& state = myStateList.current();
-      Serializer& s = state.data;
-      s.rewind();  // rewind Serializer internal buffers
+      myLastTimeMachineAdd = false;
+      ++i;
     }
-    else
-      break;
+    // Set internal current iterator to previous states (back in time),
+    // since we will now process this state
+    const uInt32 pos = myStateList.currentIdx() - 1;
+    const uInt32 moves = std::min(numStates - i, pos);
+    myStateList.moveTo(pos - moves);
+    i += moves;
   }
 
   if(i)
@@ -185,24 +726,19 @@ uInt32 RewindManager::rewindStates(uInt32 numStates)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 RewindManager::unwindStates(uInt32 numStates)
 {
+  finishPendingState();
+
   uInt64 startCycles = myOSystem.console().tia().cycles();
-  uInt32 i;
+  uInt32 i = 0;
   string message;
 
-  for(i = 0; i < numStates; ++i)
+  if(!atLast() && myStateList.currentIsValid())
   {
-    if(!atLast())
-    {
-      // Set internal current iterator to nextCycles state (forward in time),
-      // since we will now process this state
-      myStateList.moveToNext();
-
-      RewindState& state = myStateList.current();
-      Serializer& s = state.data;
-      s.rewind();  // rewind Serializer internal buffers
-    }
-    else
-      break;
+    // Set internal current iterator to next states (forward in time),
+    // since we will now process this state
+    const uInt32 pos = myStateList.currentIdx() - 1;
+    i = std::min(numStates, myStateList.size() - 1 - pos);
+    myStateList.moveTo(pos + i);
   }
 
   if(i)
@@ -229,6 +765,8 @@ uInt32 RewindManager::windStates(uInt32 numStates, bool unwind)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string RewindManager::saveAllStates()
 {
+  finishPendingState();
+
   if (getLastIdx() == 0)
     return "Nothing to save";
 
@@ -239,9 +777,10 @@ string RewindManager::saveAllStates()
       << myOSystem.console().properties().get(PropType::Cart_Name)
       << ".sta";
 
-    Serializer out(buf.str(), Serializer::Mode::ReadWriteTrunc);
-    if (!out)
-      return "Can't save to all states file";
+    // The states are collected in memory, the file is compressed and
+    // written in the background
+    const string filename = buf.str();
+    Serializer out;
 
     uInt32 curIdx = getCurrentIdx();
     rewindStates(MAX_BUF_SIZE);
@@ -255,18 +794,11 @@ string RewindManager::saveAllStates()
     for (uInt32 i = 0; i < numStates; ++i)
     {
       RewindState& state = myStateList.current();
-      Serializer& s = state.data;
-      uInt32 stateSize = uInt32(s.size());
-      unique_ptr<uInt8[]> buffer = make_unique<uInt8[]>(stateSize);
 
-      out.putInt(stateSize);
-
-      // Rewind Serializer internal buffers
-      s.rewind();
-
-      // Save state
-      s.getByteArray(buffer.get(), stateSize);
-      out.putByteArray(buffer.get(), stateSize);
+      // Save decoded state
+      decodeState(myStateList.currentIter(), myStateBuffer);
+      out.putInt(state.size);
+      out.putByteArray(myStateBuffer.data(), state.size);
       out.putString(state.message);
       out.putLong(state.cycles);
 
@@ -275,6 +807,11 @@ string RewindManager::saveAllStates()
     // restore old state position
     rewindStates(numStates - curIdx);
 
+    ByteArray data;
+    if(!StateManager::copyData(out, data))
+      return "Error saving all states";
+    myStateManager.stateFile().write(filename, std::move(data));
+
     buf.str("");
     buf << "Saved " << numStates << " states";
     return buf.str();
@@ -288,6 +825,8 @@ string RewindManager::saveAllStates()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string RewindManager::loadAllStates()
 {
+  finishPendingState();
+
   try
   {
     ostringstream buf;
@@ -295,10 +834,11 @@ string RewindManager::loadAllStates()
       << myOSystem.console().properties().get(PropType::Cart_Name)
       << ".sta";
 
-    // Make sure the file can be opened for reading
-    Serializer in(buf.str(), Serializer::Mode::ReadOnly);
-    if (!in)
+    // Make sure the file can be read (and decompressed)
+    ByteArray data;
+    if(!myStateManager.stateFile().read(buf.str(), data))
       return "Can't load from all states file";
+    Serializer in(static_cast<const uInt8*>(data.data()), data.size());
 
     clear();
     uInt32 numStates;
@@ -316,22 +856,23 @@ string RewindManager::loadAllStates()
         compressStates();
 
       uInt32 stateSize = in.getInt();
-      unique_ptr<uInt8[]> buffer = make_unique<uInt8[]>(stateSize);
+      myTempBuffer.resize(stateSize);
+      in.getByteArray(myTempBuffer.data(), stateSize);
 
       // Add new state at the end of the list (queue adds at end)
       // This updates the 'current' iterator inside the list
       myStateList.addLast();
-      RewindState& state = myStateList.current();
-      Serializer& s = state.data;
-
-      // Rewind Serializer internal buffers
-      s.rewind();
+      storeLastState(myTempBuffer.data(), stateSize);
+      createThumbnail(myTempBuffer.data(), stateSize,
+                      myOSystem.console().tia().height());
 
       // Fill new state with saved values
-      in.getByteArray(buffer.get(), stateSize);
-      s.putByteArray(buffer.get(), stateSize);
+      RewindState& state = myStateList.current();
       state.message = in.getString();
       state.cycles = in.getLong();
+      addLastError();
+
+      enforceMemoryBudget();
     }
 
     // initialize current state (parameters ignored)
@@ -350,43 +891,179 @@ string RewindManager::loadAllStates()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void RewindManager::compressStates()
 {
-  double expectedCycles = myInterval * myFactor * (1 + myFactor);
-  double maxError = 1.5;
-  uInt32 idx = myStateList.size() - 2;
+  // The expected distance between the neighbours of the state at position
+  // 'pos' grows by 'myFactor' per state towards the beginning of the list;
+  // this is applied to the last but one compressed state:
+  //   error = expectedCycles * myFactor^(last + 1 - pos) / (next - prev)
+  // The tree stores log(1 / (next - prev)) - pos * log(myFactor), so the
+  // state with the largest error is the one with the largest value.
+  const uInt32 compressed = mySize - myUncompressed;
+  const uInt32 size = myStateList.size();
   // in case maxError is <= 1.5 remove first state by default:
   Common::LinkedObjectPool<RewindState>::const_iter removeIter = myStateList.first();
-  /*if(myUncompressed < mySize)
-    //  if compression is enabled, the first but one state is removed by default:
-    removeIter++;*/
 
-  // iterate from last but one to first but one
-  for(auto it = myStateList.previous(myStateList.last()); it != myStateList.first(); --it)
+  // only the first but one to last but one states are compressed
+  if(size > 2 && compressed > 1)
   {
-    if(idx < mySize - myUncompressed)
-    {
-      expectedCycles *= myFactor;
+    const uInt32 last = std::min(size - 2, compressed - 1);
+    const auto [value, leaf] = maxError(1, 0, myErrorLeaves,
+        myStateList.at(1)->leaf, myStateList.at(last)->leaf + 1);
+    const double expectedCycles = myInterval * myFactor * (1 + myFactor);
+
+    if(std::log(expectedCycles) + (last + 1) * myLogFactor + value > std::log(1.5))
+      removeIter = myStateList.at(errorPosition(leaf));
+  }
+  removeState(removeIter);
+}
 
-      uInt64 prevCycles = myStateList.previous(it)->cycles;
-      uInt64 nextCycles = myStateList.next(it)->cycles;
-      double error = expectedCycles / (nextCycles - prevCycles);
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::rebuildErrorTree()
+{
+  // Leave room for as many additions as there are states before rebuilding
+  myErrorLeaves = 1;
+  while(myErrorLeaves < 2 * std::max(myStateList.capacity(), 1U))
+    myErrorLeaves <<= 1;
+
+  myErrorTree.assign(2 * size_t(myErrorLeaves), ErrorNode{UNUSED_ERROR, 0, 0, 0});
+  for(uInt32 i = 0; i < myErrorLeaves; ++i)
+    myErrorTree[myErrorLeaves + i].leaf = i;
+  for(uInt32 node = myErrorLeaves - 1; node > 0; --node)
+    updateErrorNode(node);
+  myLogFactor = std::log(myFactor);
+
+  myNextLeaf = 0;
+  for(auto it = myStateList.cbegin(); it != myStateList.cend(); ++it)
+  {
+    it->leaf = myNextLeaf++;
+    setErrorLeaf(it->leaf, UNUSED_ERROR, true);
+  }
+  for(uInt32 pos = 0; pos < myStateList.size(); ++pos)
+    updateError(pos);
+}
 
-      if(error > maxError)
-      {
-        maxError = error;
-        removeIter = it;
-      }
-    }
-    --idx;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::addLastError()
+{
+  if(myNextLeaf == myErrorLeaves)
+  {
+    // Compact the leaves of the states still in the list
+    rebuildErrorTree();
+    return;
+  }
+
+  const auto last = myStateList.last();
+  last->leaf = myNextLeaf++;
+  setErrorLeaf(last->leaf, UNUSED_ERROR, true);
+  // The previous last state has a successor now
+  if(myStateList.size() > 1)
+    updateError(myStateList.size() - 2);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::updateError(uInt32 pos)
+{
+  if(pos == 0 || pos + 1 >= myStateList.size())
+    return;
+
+  const auto it = myStateList.at(pos);
+  const uInt64 prevCycles = myStateList.previous(it)->cycles;
+  const uInt64 nextCycles = myStateList.next(it)->cycles;
+
+  setErrorLeaf(it->leaf, -std::log(double(nextCycles - prevCycles)) - pos * myLogFactor,
+               true);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::setErrorLeaf(uInt32 leaf, double error, bool used)
+{
+  uInt32 node = myErrorLeaves + leaf;
+
+  // The pending changes of the ancestors also apply to the new error
+  for(uInt32 i = node / 2; i > 0; i /= 2)
+    error -= myErrorTree[i].add;
+
+  myErrorTree[node].max = used ? error : UNUSED_ERROR;
+  myErrorTree[node].add = 0;
+  myErrorTree[node].count = used ? 1 : 0;
+
+  for(node /= 2; node > 0; node /= 2)
+    updateErrorNode(node);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::addError(uInt32 node, uInt32 lo, uInt32 hi,
+                             uInt32 from, uInt32 to, double delta)
+{
+  if(to <= lo || hi <= from)
+    return;
+
+  ErrorNode& n = myErrorTree[node];
+  if(from <= lo && hi <= to)
+  {
+    n.max += delta;
+    n.add += delta;
+    return;
   }
-   myStateList.remove(removeIter); // remove
+
+  const uInt32 mid = (lo + hi) / 2;
+  addError(node * 2, lo, mid, from, to, delta);
+  addError(node * 2 + 1, mid, hi, from, to, delta);
+  updateErrorNode(node);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::pair<double, uInt32> RewindManager::maxError(uInt32 node, uInt32 lo, uInt32 hi,
+                                                  uInt32 from, uInt32 to) const
+{
+  if(to <= lo || hi <= from)
+    return { UNUSED_ERROR, 0 };
+
+  const ErrorNode& n = myErrorTree[node];
+  if(from <= lo && hi <= to)
+    return { n.max, n.leaf };
+
+  const uInt32 mid = (lo + hi) / 2;
+  const auto left = maxError(node * 2, lo, mid, from, to);
+  const auto right = maxError(node * 2 + 1, mid, hi, from, to);
+  // On equal errors, the later state is removed
+  const auto& m = right.first >= left.first ? right : left;
+
+  return { m.first + n.add, m.second };
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 RewindManager::errorPosition(uInt32 leaf) const
+{
+  // Count the used leaves before the given one
+  uInt32 pos = 0;
+  for(uInt32 node = myErrorLeaves + leaf; node > 1; node /= 2)
+    if(node & 1)
+      pos += myErrorTree[node - 1].count;
+
+  return pos;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::updateErrorNode(uInt32 node)
+{
+  ErrorNode& n = myErrorTree[node];
+  const ErrorNode& left = myErrorTree[node * 2];
+  const ErrorNode& right = myErrorTree[node * 2 + 1];
+  const ErrorNode& m = right.max >= left.max ? right : left;
+
+  n.max = m.max + n.add;
+  n.leaf = m.leaf;
+  n.count = left.count + right.count;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string RewindManager::loadState(Int64 startCycles, uInt32 numStates)
 {
   RewindState& state = myStateList.current();
-  Serializer& s = state.data;
 
+  decodeState(myStateList.currentIter(), myStateBuffer);
+
+  Serializer s(static_cast<const uInt8*>(myStateBuffer.data()), state.size);
   myStateManager.loadState(s);
   myOSystem.console().tia().loadDisplay(s);
 
@@ -443,12 +1120,16 @@ string RewindManager::getUnitString(Int64 cycles)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt64 RewindManager::getFirstCycles() const
 {
+  finishPendingState();
+
   return !myStateList.empty() ? myStateList.first()->cycles : 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt64 RewindManager::getCurrentCycles() const
 {
+  finishPendingState();
+
   if(myStateList.currentIsValid())
     return myStateList.current().cycles;
   else
@@ -458,12 +1139,64 @@ uInt64 RewindManager::getCurrentCycles() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt64 RewindManager::getLastCycles() const
 {
+  finishPendingState();
+
   return !myStateList.empty() ? myStateList.last()->cycles : 0;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const ByteArray& RewindManager::getThumbnail(uInt32 idx, uInt32& height) const
+{
+  static const ByteArray NO_THUMBNAIL;
+
+  finishPendingState();
+
+  if(idx >= myStateList.size())
+  {
+    height = 0;
+    return NO_THUMBNAIL;
+  }
+
+  const auto it = myStateList.at(idx);
+  height = it->thumbnailHeight;
+  return it->thumbnail;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 RewindManager::visitStates(const std::function<void()>& visit)
+{
+  finishPendingState();
+
+  // The states are loaded over the current one, keep it
+  Serializer current;
+  if(myStateList.empty() || !myStateManager.saveState(current))
+    return 0;
+
+  uInt32 count = 0;
+  for(uInt32 i = 0; i < myStateList.size(); ++i)
+  {
+    const auto it = myStateList.at(i);
+
+    decodeState(it, myTempBuffer);
+    Serializer s(static_cast<const uInt8*>(myTempBuffer.data()), it->size);
+    if(myStateManager.loadState(s))
+    {
+      visit();
+      ++count;
+    }
+  }
+
+  current.rewind();
+  myStateManager.loadState(current);
+
+  return count;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 IntArray RewindManager::cyclesList() const
 {
+  finishPendingState();
+
   IntArray arr;
 
   uInt64 firstCycle = getFirstCycles();
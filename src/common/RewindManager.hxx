@@ -21,7 +21,13 @@
 class OSystem;
 class StateManager;
 
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <fstream>
+
 #include "LinkedObjectPool.hxx"
+#include "TIAConstants.hxx"
 #include "bspf.hxx"
 
 /**
@@ -38,8 +44,23 @@ class StateManager;
   to the end of the list (aka, all future states) are removed, and the internal
   iterator moves to the insertion point of the data (the end of the list).
 
-  If the list is full, states are either removed at the beginning (compression
-  off) or at selective positions (compression on).
+  If the list is full, or the states use more memory than the configured
+  budget, states are either removed at the beginning (compression off) or at
+  selective positions (compression on).
+
+  Optionally, states exceeding the memory budget are not removed, but moved
+  into an archive file instead. Only the data of recently used states is
+  kept in RAM; the data of the other states is read back from the file
+  (and thus from the OS file cache in most cases) when it is accessed.
+
+  States added by the Time Machine are only serialized on the calling thread;
+  encoding, compression and insertion into the list happen on a worker thread.
+  All methods that access the list wait until a pending state has been added.
+
+  To save memory, only every KEYFRAME_INTERVAL-th state is stored in full
+  ('keyframe'); all other states only store the runs of bytes that differ
+  from the preceding keyframe. When a keyframe is removed, the following
+  state is promoted to a keyframe and its dependents are re-encoded.
 
   @author  Stephen Anthony
 */
@@ -47,9 +68,17 @@ class RewindManager
 {
   public:
     RewindManager(OSystem& system, StateManager& statemgr);
+    ~RewindManager();
 
   public:
     static constexpr uInt32 MAX_BUF_SIZE = 1000;
+    // maximum number of states between two keyframes
+    static constexpr uInt32 KEYFRAME_INTERVAL = 16;
+    // name of the archive file in the state directory
+    static constexpr char ARCHIVE_FILE[] = "timemachine.tma";
+    // thumbnails sample every n-th pixel and line of a frame
+    static constexpr uInt32 THUMBNAIL_SCALE = 4;
+    static constexpr uInt32 THUMBNAIL_W = TIAConstants::H_PIXEL / THUMBNAIL_SCALE;
     static constexpr int NUM_INTERVALS = 7;
     // cycle values for the intervals
     const std::array<uInt32, NUM_INTERVALS> INTERVAL_CYCLES = {
@@ -140,32 +169,64 @@ class RewindManager
     string saveAllStates();
     string loadAllStates();
 
-    bool atFirst() const { return myStateList.atFirst(); }
-    bool atLast() const  { return myStateList.atLast();  }
-    void resize(uInt32 size) { myStateList.resize(size); }
-    void clear() {
-      myStateList.clear();
-    }
+    bool atFirst() const { finishPendingState(); return myStateList.atFirst(); }
+    bool atLast() const  { finishPendingState(); return myStateList.atLast();  }
+    void resize(uInt32 size);
+    void clear();
 
     /**
       Convert the cycles into a unit string.
     */
     string getUnitString(Int64 cycles);
 
-    uInt32 getCurrentIdx() { return myStateList.currentIdx(); }
-    uInt32 getLastIdx() { return myStateList.size(); }
+    uInt32 getCurrentIdx() { finishPendingState(); return myStateList.currentIdx(); }
+    uInt32 getLastIdx() { finishPendingState(); return myStateList.size(); }
 
     uInt64 getFirstCycles() const;
     uInt64 getCurrentCycles() const;
     uInt64 getLastCycles() const;
     uInt64 getInterval() const { return myInterval; }
 
+    /**
+      Answer the memory (in bytes) used by the stored states, and the
+      budget they must fit into (0 = no limit).
+    */
+    uInt64 getMemoryUsed() const { finishPendingState(); return myMemoryUsed; }
+    uInt64 getMemoryBudget() const { return myMemoryBudget; }
+
+    /**
+      Answer whether states are archived, and the size of the archive file.
+    */
+    bool isArchiving() const { return myArchive.is_open(); }
+    uInt64 getArchiveSize() const { finishPendingState(); return myArchiveEnd; }
+
     /**
       Get a collection of cycle timestamps, offset from the first one in
       the list.  This also determines the number of states in the list.
     */
     IntArray cyclesList() const;
 
+    /**
+      Get the thumbnail of the state at the given index (starting at 0),
+      as rows of THUMBNAIL_W pixels.  Each row consists of runs of
+      (count, color) pairs.
+
+      @param idx     The index of the state
+      @param height  Receives the number of rows
+
+      @return  The runs, valid until the list changes
+    */
+    const ByteArray& getThumbnail(uInt32 idx, uInt32& height) const;
+
+    /**
+      Load each state in turn, oldest first, and call 'visit' while it is
+      loaded (e.g. to inspect its RAM).  The current emulation state is
+      restored afterwards.
+
+      @return  The number of states visited
+    */
+    uInt32 visitStates(const std::function<void()>& visit);
+
   private:
     OSystem& myOSystem;
     StateManager& myStateManager;
@@ -175,10 +236,29 @@ class RewindManager
     uInt32 myInterval{0};
     uInt64 myHorizon{0};
     double myFactor{0.0};
+    uInt64 myMemoryBudget{0};
+    // Size of the encoded data of all states in the list
+    uInt64 myMemoryUsed{0};
     bool   myLastTimeMachineAdd{false};
 
     struct RewindState {
-      Serializer data;  // actual save state
+      // Actual save state; either the full state (keyframe) or the
+      // difference to the preceding keyframe. Both are re-encoded in place
+      // when a keyframe is removed, hence mutable.
+      mutable ByteArray data;
+      mutable bool keyframe{true};
+      // Position and size of a copy of 'data' in the archive (size 0 = no
+      // copy); 'data' is empty while the state only lives in the archive
+      mutable uInt64 archiveOffset{0};
+      mutable uInt32 archiveSize{0};
+      // For keeping recently used data in RAM
+      mutable uInt64 lastUse{0};
+      // Leaf of the state in the error tree
+      mutable uInt32 leaf{0};
+      // Low resolution, run-length encoded copy of the state's last frame
+      mutable ByteArray thumbnail;
+      uInt32 thumbnailHeight{0};
+      uInt32 size{0};   // size of the decoded state
       string message;   // describes save state origin
       uInt64 cycles{0}; // cycles since emulation started
 
@@ -198,11 +278,168 @@ class RewindManager
     // frequent (de)-allocations)
     Common::LinkedObjectPool<RewindState> myStateList;
 
+    // Max-tree over the (logarithmic) compression errors of the states,
+    // indexed by leaves which are handed out in list order.  Removing a
+    // state moves all following states one position ahead, which is
+    // applied lazily to the whole range of their leaves.
+    struct ErrorNode {
+      double max{0};    // maximum error in the subtree (including 'add')
+      double add{0};    // pending change of all errors in the subtree
+      uInt32 leaf{0};   // leaf of the maximum error
+      uInt32 count{0};  // number of leaves used by states in the list
+    };
+    std::vector<ErrorNode> myErrorTree;
+    uInt32 myErrorLeaves{0};
+    uInt32 myNextLeaf{0};
+    double myLogFactor{0.0};
+
+    // Scratch buffers for (de)serialization of the full states
+    ByteArray myStateBuffer, myTempBuffer;
+
+    // Optional file storing the data of the states exceeding the budget
+    std::fstream myArchive;
+    string myArchivePath;
+    uInt64 myArchiveEnd{0};
+    uInt64 myUseCount{0};
+
+    // A state that has been serialized to myStateBuffer, but not yet added
+    struct PendingState {
+      uInt32 size{0};
+      string message;
+      uInt64 cycles{0};
+      bool timeMachine{false};
+      uInt32 height{0};  // of the frame, for the thumbnail
+    };
+    PendingState myPendingState;
+    bool myHasPendingState{false};
+    bool myQuit{false};
+
+    std::thread myWorker;
+    mutable std::mutex myMutex;
+    mutable std::condition_variable myCondition;
+
+    /**
+      Add the state in myStateBuffer to the end of the list.
+    */
+    void insertState(uInt32 size, const string& message, uInt64 cycles,
+                     bool timeMachine, uInt32 height);
+
+    /**
+      Create the thumbnail of the current state from its (decoded) data.
+    */
+    void createThumbnail(const uInt8* data, uInt32 size, uInt32 height);
+
+    /**
+      The worker thread's main loop
+    */
+    void workerMain();
+
+    /**
+      Wait until the worker has added the pending state (if any).
+    */
+    void finishPendingState() const;
+
     /**
       Remove a save state from the list
     */
     void compressStates();
 
+    /**
+      Assign leaves to all states in the list, and recalculate their errors.
+    */
+    void rebuildErrorTree();
+
+    /**
+      Enter the state just added at the end of the list into the error tree.
+    */
+    void addLastError();
+
+    /**
+      Recalculate the error of the state at the given position in the list;
+      the first and the last state have none.
+    */
+    void updateError(uInt32 pos);
+
+    /**
+      Set the error of a leaf, or mark it as unused.
+    */
+    void setErrorLeaf(uInt32 leaf, double error, bool used);
+
+    /**
+      Add 'delta' to the errors of the leaves in [from, to).
+    */
+    void addError(uInt32 node, uInt32 lo, uInt32 hi,
+                  uInt32 from, uInt32 to, double delta);
+
+    /**
+      Find the maximum error of the leaves in [from, to).
+
+      @return  The error and its leaf
+    */
+    std::pair<double, uInt32> maxError(uInt32 node, uInt32 lo, uInt32 hi,
+                                       uInt32 from, uInt32 to) const;
+
+    /**
+      Answer the position in the list of the state using the given leaf.
+    */
+    uInt32 errorPosition(uInt32 leaf) const;
+
+    void updateErrorNode(uInt32 node);
+
+    /**
+      Remove the given state, promoting its successor to a keyframe if
+      necessary.
+    */
+    void removeState(Common::LinkedObjectPool<RewindState>::const_iter it);
+
+    /**
+      Remove states until the remaining ones fit into the memory budget
+    */
+    void enforceMemoryBudget();
+
+    /**
+      Free the data of all states from the given one to the end of the list,
+      which are about to be removed from the list
+    */
+    void releaseStates(Common::LinkedObjectPool<RewindState>::const_iter it);
+
+    /**
+      Answer the data of the given state, reading it from the archive if
+      it has been moved there.
+    */
+    const ByteArray& stateData(const RewindState& state);
+
+    /**
+      Move the data of the given state into the archive.
+
+      @return  False if the data could not be written
+    */
+    bool archiveState(const RewindState& state);
+
+    /**
+      Create or remove the archive file.
+    */
+    void setupArchive(bool enable);
+
+    /**
+      Serialize the current emulation state into myStateBuffer.
+
+      @return  The size of the serialized state (0 on failure)
+    */
+    uInt32 serializeCurrentState();
+
+    /**
+      Encode a full state and store it in the last node of the list, either
+      as keyframe or as difference to the preceding keyframe.
+    */
+    void storeLastState(const uInt8* data, uInt32 size);
+
+    /**
+      Decode the given state into 'buffer'.
+    */
+    void decodeState(Common::LinkedObjectPool<RewindState>::const_iter it,
+                     ByteArray& buffer);
+
     /**
       Load the current state and get the message string for the rewind/unwind
 
@@ -0,0 +1,118 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include "FSNode.hxx"
+#include "Logger.hxx"
+#include "repository/KeyValueRepository.hxx"
+#include "json_lib.hxx"
+#include "EventCounters.hxx"
+#include "RomMetadataCache.hxx"
+
+using nlohmann::json;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomMetadataCache::RomMetadataCache(shared_ptr<KeyValueRepositoryAtomic> repository)
+  : myRepository{repository}
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RomMetadataCache::get(const FilesystemNode& node, Metadata& metadata) const
+{
+  uInt64 size = 0, mtime = 0;
+
+  if(!node.getFileInfo(size, mtime))
+  {
+    EventCounters::count(EventCounters::Event::cacheMiss);
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(myMutex);
+
+  if(load(node.getPath(), size, mtime, metadata))
+    return true;
+
+  EventCounters::count(EventCounters::Event::cacheMiss);
+  return false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomMetadataCache::update(const FilesystemNode& node, const Metadata& metadata)
+{
+  uInt64 size = 0, mtime = 0;
+
+  if(!node.getFileInfo(size, mtime))
+    return;
+
+  std::lock_guard<std::mutex> lock(myMutex);
+
+  // Merge with the information already cached for this version of the file
+  Metadata merged;
+  load(node.getPath(), size, mtime, merged);
+
+  const auto MERGE = [](string& to, const string& from) {
+    if(!from.empty()) to = from;
+  };
+  MERGE(merged.md5, metadata.md5);
+  MERGE(merged.type, metadata.type);
+  MERGE(merged.leftController, metadata.leftController);
+  MERGE(merged.rightController, metadata.rightController);
+  MERGE(merged.layout, metadata.layout);
+
+  const json entry = {
+    { "size", size },
+    { "mtime", mtime },
+    { "md5", merged.md5 },
+    { "type", merged.type },
+    { "left", merged.leftController },
+    { "right", merged.rightController },
+    { "layout", merged.layout }
+  };
+  myRepository->save(node.getPath(), entry.dump());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RomMetadataCache::load(const string& path, uInt64 size, uInt64 mtime,
+                            Metadata& metadata) const
+{
+  Variant value;
+
+  if(!myRepository->get(path, value))
+    return false;
+
+  try
+  {
+    const json entry = json::parse(value.toString());
+
+    // The file was modified since the information was cached
+    if(entry.at("size").get<uInt64>() != size || entry.at("mtime").get<uInt64>() != mtime)
+      return false;
+
+    metadata.md5             = entry.at("md5").get<string>();
+    metadata.type            = entry.at("type").get<string>();
+    metadata.leftController  = entry.at("left").get<string>();
+    metadata.rightController = entry.at("right").get<string>();
+    metadata.layout          = entry.at("layout").get<string>();
+    return true;
+  }
+  catch(const json::exception& err)
+  {
+    Logger::debug("RomMetadataCache: invalid entry for " + path + ": " + err.what());
+    return false;
+  }
+}
@@ -0,0 +1,96 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef ROM_METADATA_CACHE_HXX
+#define ROM_METADATA_CACHE_HXX
+
+#include <mutex>
+
+#include "bspf.hxx"
+
+class FilesystemNode;
+class KeyValueRepositoryAtomic;
+
+/**
+  Persistent cache of information derived from ROM files, which would
+  otherwise require reading and analyzing the complete file every time
+  (e.g. whenever a ROM is selected in the launcher).
+
+  Entries are keyed by the full path of the file, and are only valid as
+  long as its size and modification time are unchanged.  Files whose size
+  and modification time cannot be determined are never cached.
+
+  The cache may be used from several threads at once.
+
+  @author  Stella Team
+*/
+class RomMetadataCache
+{
+  public:
+    struct Metadata {
+      string md5;
+      // The autodetected bankswitch type (name)
+      string type;
+      // The autodetected controllers (names) for the left and right jack
+      string leftController, rightController;
+      // The autodetected frame layout ("NTSC" or "PAL")
+      string layout;
+    };
+
+  public:
+    explicit RomMetadataCache(shared_ptr<KeyValueRepositoryAtomic> repository);
+
+    /**
+      Get the cached information for the given file.
+
+      @param node      The ROM file
+      @param metadata  Receives the cached information
+
+      @return  True if a valid entry exists, false otherwise
+    */
+    bool get(const FilesystemNode& node, Metadata& metadata) const;
+
+    /**
+      Update the cached information for the given file.  Empty members
+      of 'metadata' don't overwrite information cached before.
+
+      @param node      The ROM file
+      @param metadata  The new information
+    */
+    void update(const FilesystemNode& node, const Metadata& metadata);
+
+  private:
+    bool load(const string& path, uInt64 size, uInt64 mtime,
+              Metadata& metadata) const;
+
+  private:
+    shared_ptr<KeyValueRepositoryAtomic> myRepository;
+
+    // Serializes access to the repository
+    mutable std::mutex myMutex;
+
+  private:
+    // Following constructors and assignment operators not supported
+    RomMetadataCache() = delete;
+    RomMetadataCache(const RomMetadataCache&) = delete;
+    RomMetadataCache(RomMetadataCache&&) = delete;
+    RomMetadataCache& operator=(const RomMetadataCache&) = delete;
+    RomMetadataCache& operator=(RomMetadataCache&&) = delete;
+};
+
+#endif
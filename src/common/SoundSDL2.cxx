@@ -17,9 +17,15 @@
 
 #ifdef SOUND_SUPPORT
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <xmmintrin.h>
+  #define SOUND_SDL2_SSE
+#endif
+
 #include <sstream>
 #include <cassert>
 #include <cmath>
+#include <chrono>
 
 #include "SDL_lib.hxx"
 #include "Logger.hxx"
@@ -34,7 +40,12 @@
 #include "AudioSettings.hxx"
 #include "audio/SimpleResampler.hxx"
 #include "audio/LanczosResampler.hxx"
+#include "audio/BlepResampler.hxx"
 #include "StaggeredLogger.hxx"
+#include "FrameProfiler.hxx"
+#include "EventCounters.hxx"
+#include "TraceRecorder.hxx"
+#include "ThreadControl.hxx"
 
 #include "ThreadDebugging.hxx"
 
@@ -120,6 +131,8 @@ bool SoundSDL2::openDevice()
   myDeviceId = BSPF::clamp(myAudioSettings.device(), 0U, uInt32(myDevices.size() - 1));
   const char* device = myDeviceId ? myDevices.at(myDeviceId).first.c_str() : nullptr;
 
+  // The device comes with a new callback thread
+  myThreadConfigured = false;
   myDevice = SDL_OpenAudioDevice(device, 0, &desired, &myHardwareSpec,
                                  SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
 
@@ -175,6 +188,10 @@ void SoundSDL2::open(shared_ptr<AudioQueue> audioQueue,
   myUnderrun = true;
   myCurrentFragment = nullptr;
 
+  resetCallbackStats();
+  myOSystem.timer().clear(myUnderrunTimer);
+  myUnderrunTimer = myOSystem.timer().setInterval([this]() { reportUnderruns(); }, 100);
+
   // Adjust volume to that defined in settings
   setVolume(myAudioSettings.volume());
 
@@ -198,6 +215,22 @@ void SoundSDL2::close()
 
   mute(true);
 
+  myOSystem.timer().clear(myUnderrunTimer);
+  myUnderrunTimer = 0;
+  reportUnderruns();
+
+  const CallbackStats stats = callbackStats();
+  if (stats.callbacks > 0)
+  {
+    ostringstream buf;
+    buf << "Audio callback: " << std::fixed << std::setprecision(3)
+        << stats.averageMs << " ms average, " << stats.maxMs << " ms maximum, "
+        << stats.periodMs << " ms per fragment, " << stats.maxIntervalMs
+        << " ms maximum interval; " << stats.underruns << " underruns, "
+        << stats.overflows << " overflows";
+    Logger::debug(buf.str());
+  }
+
   if (myAudioQueue) myAudioQueue->closeSink(myCurrentFragment);
   myAudioQueue.reset();
   myCurrentFragment = nullptr;
@@ -326,6 +359,9 @@ string SoundSDL2::about() const
     case AudioSettings::ResamplingQuality::lanczos_3:
       buf << "Quality 3, Lanczos (a = 3)" << endl;
       break;
+    case AudioSettings::ResamplingQuality::blep:
+      buf << "Quality 4, band-limited steps" << endl;
+      break;
   }
   buf << "    Headroom:      " << std::fixed << std::setprecision(1)
       << (0.5 * myAudioSettings.headroom()) << " frames" << endl
@@ -337,10 +373,103 @@ string SoundSDL2::about() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void SoundSDL2::processFragment(float* stream, uInt32 length)
 {
+  FrameProfiler::Scope profilerScope(FrameProfiler::Stage::audio);
+
+  updateRateAdjustment();
   myResampler->fillFragment(stream, length);
 
-  for (uInt32 i = 0; i < length; ++i)
-    stream[i] *= myVolumeFactor;
+  // A local copy, as the compiler can't know that 'stream' doesn't alias it
+  const float volume = myVolumeFactor;
+  uInt32 i = 0;
+
+#ifdef SOUND_SDL2_SSE
+  const __m128 factor = _mm_set1_ps(volume);
+  for (; i + 4 <= length; i += 4)
+    _mm_storeu_ps(stream + i, _mm_mul_ps(_mm_loadu_ps(stream + i), factor));
+#endif
+
+  for (; i < length; ++i)
+    stream[i] *= volume;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundSDL2::recordCallback(uInt64 start, uInt64 nanoseconds)
+{
+  if (myLastCallbackStart != 0 &&
+      start - myLastCallbackStart > myCallbackMaxInterval.load(std::memory_order_relaxed))
+    myCallbackMaxInterval.store(start - myLastCallbackStart, std::memory_order_relaxed);
+  myLastCallbackStart = start;
+
+  myCallbackCount.store(myCallbackCount.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_relaxed);
+  myCallbackTime.store(myCallbackTime.load(std::memory_order_relaxed) + nanoseconds,
+                       std::memory_order_relaxed);
+  if (nanoseconds > myCallbackMaxTime.load(std::memory_order_relaxed))
+    myCallbackMaxTime.store(nanoseconds, std::memory_order_relaxed);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundSDL2::resetCallbackStats()
+{
+  if(!myIsInitializedFlag) return;
+
+  // Keep the callback thread from updating the statistics meanwhile
+  SDL_LockAudioDevice(myDevice);
+  myCallbackCount = myCallbackTime = myCallbackMaxTime = myCallbackMaxInterval = 0;
+  myLastCallbackStart = 0;
+  myUnderruns = myReportedUnderruns = 0;
+  SDL_UnlockAudioDevice(myDevice);
+
+  myOverflowBase = myAudioQueue ? myAudioQueue->overflows() : 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundSDL2::reportUnderruns()
+{
+  const uInt32 underruns = myUnderruns.load(std::memory_order_relaxed);
+
+  for (; myReportedUnderruns < underruns; ++myReportedUnderruns)
+    myUnderrunLogger.log();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SoundSDL2::CallbackStats SoundSDL2::callbackStats() const
+{
+  CallbackStats stats;
+
+  stats.callbacks = myCallbackCount.load(std::memory_order_relaxed);
+  if (stats.callbacks > 0)
+    stats.averageMs = myCallbackTime.load(std::memory_order_relaxed) / 1e6 / stats.callbacks;
+  stats.maxMs = myCallbackMaxTime.load(std::memory_order_relaxed) / 1e6;
+  stats.maxIntervalMs = myCallbackMaxInterval.load(std::memory_order_relaxed) / 1e6;
+  if (myHardwareSpec.freq > 0)
+    stats.periodMs = 1000. * myHardwareSpec.samples / myHardwareSpec.freq;
+  stats.underruns = myUnderruns.load(std::memory_order_relaxed);
+  if (myAudioQueue)
+    stats.overflows = myAudioQueue->overflows() - myOverflowBase;
+
+  return stats;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundSDL2::updateRateAdjustment()
+{
+  const double target = myEmulationTiming->prebufferFragmentCount();
+
+  // Playback restarts only after the queue has been refilled to the target
+  if (myUnderrun) {
+    myAverageQueueFill = target;
+    myResampler->setRateAdjustment(1.);
+    return;
+  }
+
+  myAverageQueueFill += (myAudioQueue->size() - myAverageQueueFill) * QUEUE_FILL_SMOOTHING;
+
+  // Consume faster if the queue is fuller than the target, slower if it drains
+  const double deviation =
+    std::clamp((myAverageQueueFill - target) / std::max(target, 1.), -1., 1.);
+
+  myResampler->setRateAdjustment(1. + deviation * MAX_RATE_DEVIATION);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -353,7 +482,15 @@ void SoundSDL2::initResampler()
       nextFragment = myAudioQueue->size() >= myEmulationTiming->prebufferFragmentCount() ?
           myAudioQueue->dequeue(myCurrentFragment) : nullptr;
     else
+    {
       nextFragment = myAudioQueue->dequeue(myCurrentFragment);
+      if (!nextFragment)
+      {
+        myUnderruns.store(myUnderruns.load(std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
+        EventCounters::count(EventCounters::Event::audioUnderrun);
+      }
+    }
 
     myUnderrun = nextFragment == nullptr;
     if (nextFragment) myCurrentFragment = nextFragment;
@@ -379,6 +516,10 @@ void SoundSDL2::initResampler()
       myResampler = make_unique<LanczosResampler>(formatFrom, formatTo, nextFragmentCallback, 3);
       break;
 
+    case AudioSettings::ResamplingQuality::blep:
+      myResampler = make_unique<BlepResampler>(formatFrom, formatTo, nextFragmentCallback);
+      break;
+
     default:
       throw runtime_error("invalid resampling quality");
   }
@@ -389,8 +530,26 @@ void SoundSDL2::callback(void* udata, uInt8* stream, int len)
 {
   SoundSDL2* self = static_cast<SoundSDL2*>(udata);
 
+  if (!self->myThreadConfigured.exchange(true))
+  {
+    ThreadControl::apply(ThreadControl::Thread::audio);
+    if (TraceRecorder::enabled()) TraceRecorder::instance().setThreadName("Audio");
+  }
+
+  TraceRecorder::Scope traceScope("AudioCallback", "audio");
+  traceScope.setArg("samples", len >> 2);
+
   if (self->myAudioQueue)
+  {
+    using std::chrono::steady_clock, std::chrono::nanoseconds, std::chrono::duration_cast;
+    const uInt64 start =
+      duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+
     self->processFragment(reinterpret_cast<float*>(stream), len >> 2);
+
+    self->recordCallback(start,
+      duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count() - start);
+  }
   else
     SDL_memset(stream, 0, len);
 }
@@ -26,10 +26,14 @@ class EmulationTiming;
 class AudioSettings;
 class Resampler;
 
+#include <atomic>
+
 #include "SDL_lib.hxx"
 
 #include "bspf.hxx"
 #include "Sound.hxx"
+#include "StaggeredLogger.hxx"
+#include "TimerManager.hxx"
 
 /**
   This class implements the sound API for SDL.
@@ -107,6 +111,16 @@ class SoundSDL2 : public Sound
     */
     string about() const override;
 
+    /**
+      Timing of the audio callback since the sound was last opened.
+    */
+    CallbackStats callbackStats() const override;
+
+    /**
+      Restart collecting the callback statistics.
+    */
+    void resetCallbackStats() override;
+
   protected:
     /**
       This method is called to query the audio devices.
@@ -135,6 +149,25 @@ class SoundSDL2 : public Sound
 
     void initResampler();
 
+    /**
+      Dynamic rate control: adjust the resampling ratio slightly in order to keep
+      the audio queue filled around the prebuffer level. This compensates for the
+      small mismatch between emulated and actual refresh or sample rate, which
+      otherwise leads to alternating underruns and dropped fragments.
+    */
+    void updateRateAdjustment();
+
+    /**
+      Called from the callback thread; lock and allocation free.
+    */
+    void recordCallback(uInt64 start, uInt64 nanoseconds);
+
+    /**
+      Pass the underruns counted by the callback thread to the logger
+      (called periodically on the main thread).
+    */
+    void reportUnderruns();
+
   private:
     // Indicates if the sound device was successfully initialized
     bool myIsInitializedFlag{false};
@@ -157,8 +190,36 @@ class SoundSDL2 : public Sound
     Int16* myCurrentFragment{nullptr};
     bool myUnderrun{false};
 
+    // Smoothed audio queue fill level used for dynamic rate control
+    double myAverageQueueFill{0.};
+
+    // The maximum deviation from the nominal resampling ratio
+    static constexpr double MAX_RATE_DEVIATION = 0.005;
+    // The weight of each new fill level sample in myAverageQueueFill
+    static constexpr double QUEUE_FILL_SMOOTHING = 0.05;
+
     unique_ptr<Resampler> myResampler;
 
+    // Whether the callback thread has been set up (pinned, prioritized and
+    // named in the trace)
+    std::atomic<bool> myThreadConfigured{false};
+
+    // Callback statistics; written by the callback thread only, so they are
+    // updated without read-modify-write operations
+    std::atomic<uInt64> myCallbackCount{0};
+    std::atomic<uInt64> myCallbackTime{0};     // in nanoseconds
+    std::atomic<uInt64> myCallbackMaxTime{0};  // in nanoseconds
+    std::atomic<uInt64> myCallbackMaxInterval{0};  // in nanoseconds
+    uInt64 myLastCallbackStart{0};
+    std::atomic<uInt32> myUnderruns{0};
+    // The audio queue's overflow count when the statistics were reset
+    uInt32 myOverflowBase{0};
+
+    // Underruns are logged from the main thread, as logging locks and allocates
+    StaggeredLogger myUnderrunLogger{"audio buffer underrun", Logger::Level::INFO};
+    uInt32 myReportedUnderruns{0};
+    TimerManager::TimerId myUnderrunTimer{0};
+
     AudioSettings& myAudioSettings;
 
     string myAboutString;
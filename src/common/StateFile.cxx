@@ -0,0 +1,156 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <fstream>
+
+#if defined(ZIP_SUPPORT)
+  #include <zlib.h>
+#endif
+
+#include "Logger.hxx"
+#include "StateFile.hxx"
+
+namespace {
+  constexpr std::array<uInt8, 4> MAGIC = { 'S', 'T', 'Z', '1' };
+  constexpr size_t HEADER_SIZE = MAGIC.size() + sizeof(uInt32);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateFile::~StateFile()
+{
+  if(myWriter.joinable())
+  {
+    // Pending files are still written
+    {
+      std::lock_guard<std::mutex> lock(myMutex);
+      myQuit = true;
+    }
+    myCondition.notify_all();
+
+    myWriter.join();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateFile::write(const string& filename, ByteArray data)
+{
+  if(!myWriter.joinable())
+    myWriter = std::thread(&StateFile::writerMain, this);
+
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myQueue.push_back(PendingFile{filename, std::move(data)});
+  }
+  myCondition.notify_all();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateFile::read(const string& filename, ByteArray& data)
+{
+  finish();
+
+  std::ifstream in(filename, std::ios::binary | std::ios::ate);
+  if(!in)
+    return false;
+
+  const size_t size = size_t(in.tellg());
+  ByteArray file(size);
+  in.seekg(0);
+  if(!in.read(reinterpret_cast<char*>(file.data()), size))
+    return false;
+
+  if(size < HEADER_SIZE || !std::equal(MAGIC.begin(), MAGIC.end(), file.begin()))
+  {
+    // An old, uncompressed state
+    data.swap(file);
+    return true;
+  }
+
+#if defined(ZIP_SUPPORT)
+  uLongf length = file[4] | (file[5] << 8) | (file[6] << 16) | (uLongf(file[7]) << 24);
+  data.resize(length);
+
+  return uncompress(data.data(), &length, file.data() + HEADER_SIZE,
+                    uLong(size - HEADER_SIZE)) == Z_OK && length == data.size();
+#else
+  Logger::error("ERROR: Compressed state file '" + filename + "' not supported");
+  return false;
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateFile::finish()
+{
+  if(!myWriter.joinable())
+    return;
+
+  std::unique_lock<std::mutex> lock(myMutex);
+  myCondition.wait(lock, [this]() { return myQueue.empty() && !myWriting; });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateFile::writerMain()
+{
+  std::unique_lock<std::mutex> lock(myMutex);
+
+  for(;;)
+  {
+    myCondition.wait(lock, [this]() { return myQuit || !myQueue.empty(); });
+    if(myQueue.empty())
+      return;  // quit, after all files have been written
+
+    const PendingFile file = std::move(myQueue.front());
+    myQueue.pop_front();
+    myWriting = true;
+
+    lock.unlock();
+    if(!writeFile(file.filename, file.data))
+      Logger::error("ERROR: Couldn't write state file '" + file.filename + "'");
+    lock.lock();
+
+    myWriting = false;
+    myCondition.notify_all();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateFile::writeFile(const string& filename, const ByteArray& data)
+{
+  std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+  if(!out)
+    return false;
+
+#if defined(ZIP_SUPPORT)
+  uLongf length = compressBound(uLong(data.size()));
+  ByteArray file(HEADER_SIZE + length);
+
+  if(compress2(file.data() + HEADER_SIZE, &length, data.data(), uLong(data.size()),
+               Z_DEFAULT_COMPRESSION) != Z_OK)
+    return false;
+
+  const uInt32 size = uInt32(data.size());
+  std::copy(MAGIC.begin(), MAGIC.end(), file.begin());
+  for(int i = 0; i < 4; ++i)
+    file[MAGIC.size() + i] = uInt8(size >> (i * 8));
+
+  out.write(reinterpret_cast<const char*>(file.data()), HEADER_SIZE + length);
+#else
+  out.write(reinterpret_cast<const char*>(data.data()), data.size());
+#endif
+
+  return bool(out);
+}
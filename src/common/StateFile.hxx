@@ -0,0 +1,90 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef STATE_FILE_HXX
+#define STATE_FILE_HXX
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "bspf.hxx"
+
+/**
+  Reads and writes save state files.
+
+  Files are written (if zlib is available) as a compressed container: the
+  magic bytes 'STZ1', the uncompressed size (32-bit, little endian) and
+  the zlib stream of the data.  Files without the magic bytes are old,
+  uncompressed states, and are read as is.
+
+  Compressing and writing happens on a background thread, so that saving
+  a state doesn't stall the emulation.  Reading waits until all pending
+  files have been written.
+*/
+class StateFile
+{
+  public:
+    StateFile() = default;
+    ~StateFile();
+
+    /**
+      Queue the data to be written to the given file.  Errors are logged,
+      since they happen after this method has returned.
+    */
+    void write(const string& filename, ByteArray data);
+
+    /**
+      Read the (decompressed) data of the given file.
+
+      @return  False if the file could not be read or decompressed
+    */
+    bool read(const string& filename, ByteArray& data);
+
+    /**
+      Wait until all queued files have been written.
+    */
+    void finish();
+
+  private:
+    void writerMain();
+
+    static bool writeFile(const string& filename, const ByteArray& data);
+
+  private:
+    struct PendingFile {
+      string filename;
+      ByteArray data;
+    };
+    std::deque<PendingFile> myQueue;
+    bool myWriting{false};
+    bool myQuit{false};
+
+    std::thread myWriter;
+    std::mutex myMutex;
+    std::condition_variable myCondition;
+
+  private:
+    // Following constructors and assignment operators not supported
+    StateFile(const StateFile&) = delete;
+    StateFile(StateFile&&) = delete;
+    StateFile& operator=(const StateFile&) = delete;
+    StateFile& operator=(StateFile&&) = delete;
+};
+
+#endif // STATE_FILE_HXX
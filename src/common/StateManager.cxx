@@ -24,11 +24,12 @@
 #include "System.hxx"
 #include "Serializable.hxx"
 #include "RewindManager.hxx"
+#include "TIA.hxx"
+#include "DispatchResult.hxx"
+#include "EventHandler.hxx"
 
 #include "StateManager.hxx"
 
-// #define MOVIE_HEADER "03030000movie"
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 StateManager::StateManager(OSystem& osystem)
   : myOSystem{osystem}
@@ -42,94 +43,49 @@ StateManager::~StateManager()
 {
 }
 
-#if 0
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StateManager::toggleRecordMode()
 {
-  if(myActiveMode != kMovieRecordMode)  // Turn on movie record mode
+  if(myActiveMode != Mode::MovieRecord)  // Turn on movie record mode
   {
-    myActiveMode = kOffMode;
-
-    string moviefile = /*myOSystem.baseDir() +*/ "test.inp";
-    if(myMovieWriter.isOpen())
-      myMovieWriter.close();
-    if(!myMovieWriter.open(moviefile))
-      return false;
-
-    // Prepend the ROM md5 so this state file only works with that ROM
-    myMovieWriter.putString(myOSystem.console().properties().get(Cartridge_MD5));
-
-    if(!myOSystem.console().save(myMovieWriter))
-      return false;
+    const Console& console = myOSystem.console();
+    const string moviefile = myOSystem.stateDir().getPath() +
+        console.properties().get(PropType::Cart_Name) + ".stm";
 
     // Save controller types for this ROM
     // We need to check this, since some controllers save more state than
-    // normal, and those states files wouldn't be compatible with normal
+    // normal, and those movies wouldn't be compatible with normal
     // controllers.
-    myMovieWriter.putString(
-      myOSystem.console().controller(Controller::Jack::Left).name());
-    myMovieWriter.putString(
-      myOSystem.console().controller(Controller::Jack::Right).name());
-
-    // If we get this far, we're really in movie record mode
-    myActiveMode = kMovieRecordMode;
+    const InputMovie::Info info{
+      console.properties().get(PropType::Cart_MD5),
+      console.leftController().name(),
+      console.rightController().name()
+    };
+
+    if(myMovie.record(moviefile, info,
+        [&console](Serializer& out) { return console.save(out); },
+        console.system().cycles()))
+    {
+      myActiveMode = Mode::MovieRecord;
+      myOSystem.frameBuffer().showTextMessage("Movie recording started");
+    }
+    else
+      myOSystem.frameBuffer().showTextMessage("Can't write movie file");
   }
   else  // Turn off movie record mode
   {
-    myActiveMode = kOffMode;
-    myMovieWriter.close();
-    return false;
-  }
-
-  return myActiveMode == kMovieRecordMode;
-////////////////////////////////////////////////////////
-// FIXME - For now, I'm going to use this to activate movie playback
-  // Close the writer, since we're about to re-open in read mode
-  myMovieWriter.close();
-
-  if(myActiveMode != kMoviePlaybackMode)  // Turn on movie playback mode
-  {
-    myActiveMode = kOffMode;
-
-    string moviefile = /*myOSystem.baseDir() + */ "test.inp";
-    if(myMovieReader.isOpen())
-      myMovieReader.close();
-    if(!myMovieReader.open(moviefile))
-      return false;
-
-    // Check the ROM md5
-    if(myMovieReader.getString() !=
-       myOSystem.console().properties().get(Cartridge_MD5))
-      return false;
-
-    if(!myOSystem.console().load(myMovieReader))
-      return false;
-
-    // Check controller types
-    const string& left  = myMovieReader.getString();
-    const string& right = myMovieReader.getString();
-
-    if(left != myOSystem.console().controller(Controller::Jack::Left).name() ||
-       right != myOSystem.console().controller(Controller::Jack::Right).name())
-      return false;
-
-    // If we get this far, we're really in movie record mode
-    myActiveMode = kMoviePlaybackMode;
-  }
-  else  // Turn off movie playback mode
-  {
-    myActiveMode = kOffMode;
-    myMovieReader.close();
-    return false;
+    myMovie.close();
+    myActiveMode = defaultMode();
+    myOSystem.frameBuffer().showTextMessage("Movie recording stopped");
   }
 }
-#endif
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StateManager::toggleTimeMachine()
 {
   bool devSettings = myOSystem.settings().getBool("dev.settings");
 
+  myMovie.close();
   myActiveMode = myActiveMode == Mode::TimeMachine ? Mode::Off : Mode::TimeMachine;
   if(myActiveMode == Mode::TimeMachine)
     myOSystem.frameBuffer().showTextMessage("Time Machine enabled");
@@ -179,19 +135,11 @@ void StateManager::update()
       myRewindManager->addState("Time Machine", true);
       break;
 
-#if 0
     case Mode::MovieRecord:
-      myOSystem.console().controller(Controller::Jack::Left).save(myMovieWriter);
-      myOSystem.console().controller(Controller::Jack::Right).save(myMovieWriter);
-      myOSystem.console().switches().save(myMovieWriter);
+      myMovie.addPoll(myOSystem.console().system().cycles(),
+                      myOSystem.eventHandler().event());
       break;
 
-    case Mode::MoviePlayback:
-      myOSystem.console().controller(Controller::Jack::Left).load(myMovieReader);
-      myOSystem.console().controller(Controller::Jack::Right).load(myMovieReader);
-      myOSystem.console().switches().load(myMovieReader);
-      break;
-#endif
     default:
       break;
   }
@@ -204,20 +152,25 @@ void StateManager::loadState(int slot)
   {
     if(slot < 0) slot = myCurrentSlot;
 
+    // A movie can't follow a jump to another state
+    if(myActiveMode == Mode::MovieRecord)
+      toggleRecordMode();
+
     ostringstream buf;
     buf << myOSystem.stateDir()
         << myOSystem.console().properties().get(PropType::Cart_Name)
         << ".st" << slot;
 
-    // Make sure the file can be opened in read-only mode
-    Serializer in(buf.str(), Serializer::Mode::ReadOnly);
-    if(!in)
+    // Make sure the file can be read (and decompressed)
+    ByteArray data;
+    if(!myStateFile.read(buf.str(), data))
     {
       buf.str("");
       buf << "Can't open/load from state file " << slot;
       myOSystem.frameBuffer().showTextMessage(buf.str());
       return;
     }
+    Serializer in(static_cast<const uInt8*>(data.data()), data.size());
 
     // First test if we have a valid header
     // If so, do a complete state load using the Console
@@ -255,15 +208,10 @@ void StateManager::saveState(int slot)
         << myOSystem.console().properties().get(PropType::Cart_Name)
         << ".st" << slot;
 
-    // Make sure the file can be opened for writing
-    Serializer out(buf.str());
-    if(!out)
-    {
-      buf.str("");
-      buf << "Can't open/save to state file " << slot;
-      myOSystem.frameBuffer().showTextMessage(buf.str());
-      return;
-    }
+    // The state is serialized into memory, the file is compressed and
+    // written in the background
+    const string filename = buf.str();
+    Serializer out;
 
     try
     {
@@ -273,6 +221,7 @@ void StateManager::saveState(int slot)
     }
     catch(...)
     {
+      buf.str("");
       buf << "Error saving state " << slot;
       myOSystem.frameBuffer().showTextMessage(buf.str());
       return;
@@ -280,8 +229,11 @@ void StateManager::saveState(int slot)
 
     // Do a complete state save using the Console
     buf.str("");
-    if(myOSystem.console().save(out))
+    ByteArray data;
+    if(myOSystem.console().save(out) && copyData(out, data))
     {
+      myStateFile.write(filename, std::move(data));
+
       buf << "State " << slot << " saved";
       if(myOSystem.settings().getBool("autoslot"))
       {
@@ -296,6 +248,23 @@ void StateManager::saveState(int slot)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::copyData(Serializer& in, ByteArray& data)
+{
+  try
+  {
+    data.resize(in.size());
+    in.rewind();
+    in.getByteArray(data.data(), data.size());
+  }
+  catch(...)
+  {
+    cerr << "ERROR: StateManager::copyData(Serializer&)" << endl;
+    return false;
+  }
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StateManager::changeState(int direction)
 {
@@ -375,28 +344,93 @@ bool StateManager::saveState(Serializer& out)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void StateManager::reset()
+bool StateManager::runAhead(uInt32 frames)
 {
-  myRewindManager->clear();
-  myActiveMode = myOSystem.settings().getBool(
-    myOSystem.settings().getBool("dev.settings") ? "dev.timemachine" : "plr.timemachine") ? Mode::TimeMachine : Mode::Off;
+  // A frame that never completes (e.g. no VSYNC at all) is cut short after
+  // this many timeslices
+  constexpr uInt32 MAX_SLICES_PER_FRAME = 10;
 
-#if 0
-  myCurrentSlot = 0;
+  if(!myOSystem.hasConsole() || frames == 0)
+    return true;
 
-  switch(myActiveMode)
+  Console& console = myOSystem.console();
+  TIA& tia = console.tia();
+
+  // Silence audio before saving, so the sample log for rewind playback is
+  // neither consumed by the save nor replayed by the load
+  tia.enableAudioOutput(false);
+
+  size_t size = 0;
+  for(int attempt = 0; attempt < 2 && size == 0; ++attempt)
   {
-    case kMovieRecordMode:
-      myMovieWriter.close();
-      break;
+    if(!myRunAheadBuffer.empty())
+    {
+      Serializer out(myRunAheadBuffer.data(), myRunAheadBuffer.size());
+      if(console.save(out))
+        size = out.size();
+    }
 
-    case kMoviePlaybackMode:
-      myMovieReader.close();
-      break;
+    if(size == 0)
+    {
+      // The buffer is missing or too small, so determine the required size
+      Serializer probe;
+      if(!console.save(probe))
+        break;
 
-    default:
-      break;
+      myRunAheadBuffer.resize(probe.size() + probe.size() / 4);
+    }
   }
-  myActiveMode = kOffMode;
-#endif
+
+  bool restored = false;
+  if(size > 0)
+  {
+    DispatchResult result;
+    bool ok = true;
+
+    for(uInt32 frame = 0; ok && frame < frames; ++frame)
+    {
+      const uInt32 framesBefore = tia.framesSinceLastRender();
+
+      for(uInt32 i = 0; ok && i < MAX_SLICES_PER_FRAME &&
+          tia.framesSinceLastRender() == framesBefore; ++i)
+      {
+        tia.update(result);
+
+        // Breakpoints etc. are left to the real emulation
+        ok = result.getStatus() == DispatchResult::Status::ok;
+      }
+    }
+
+    Serializer in(myRunAheadBuffer.data(), size);
+    restored = console.load(in);
+  }
+
+  tia.enableAudioOutput(true);
+
+  return restored;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::reset()
+{
+  myRewindManager->clear();
+  myMovie.close();
+  myActiveMode = defaultMode();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::setRewindMode(Mode mode)
+{
+  // Any other mode ends a movie recording, which would miss polls otherwise
+  if(mode != Mode::MovieRecord)
+    myMovie.close();
+  myActiveMode = mode;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateManager::Mode StateManager::defaultMode() const
+{
+  return myOSystem.settings().getBool(
+    myOSystem.settings().getBool("dev.settings") ? "dev.timemachine" : "plr.timemachine")
+    ? Mode::TimeMachine : Mode::Off;
 }
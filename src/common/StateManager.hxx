@@ -24,6 +24,8 @@ class OSystem;
 class RewindManager;
 
 #include "Serializer.hxx"
+#include "InputMovie.hxx"
+#include "StateFile.hxx"
 
 /**
   This class provides an interface to all things related to emulation state.
@@ -54,12 +56,11 @@ class StateManager
     */
     Mode mode() const { return myActiveMode; }
 
-#if 0
     /**
-      Toggle movie recording mode (FIXME - currently disabled)
+      Toggle input movie recording; the movie is written to the state
+      directory and can be played back with '-headless -movie'.
     */
     void toggleRecordMode();
-#endif
 
     /**
       Toggle state rewind recording mode; this uses the RewindManager
@@ -71,7 +72,7 @@ class StateManager
       Sets state rewind recording mode; this uses the RewindManager
       for its functionality.
     */
-    void setRewindMode(Mode mode) { myActiveMode = mode; }
+    void setRewindMode(Mode mode);
 
     /**
       Optionally adds one extra state when entering the Time Machine dialog;
@@ -145,6 +146,25 @@ class StateManager
     */
     bool saveState(Serializer& out);
 
+    /**
+      Copy everything written to the given (in-memory) Serializer, e.g. to
+      pass it to the state file writer.
+
+      @return  False on any read errors, else true
+    */
+    static bool copyData(Serializer& in, ByteArray& data);
+
+    /**
+      Run-ahead: emulate the given number of frames with the current input,
+      so that the most recent of them is picked up for display, and return
+      to the current state afterwards. Audio output is suppressed for the
+      frames run ahead.
+
+      @param frames  The number of frames to run ahead
+      @return  True if the state could be restored
+    */
+    bool runAhead(uInt32 frames);
+
     /**
       Resets manager to defaults.
     */
@@ -160,6 +180,17 @@ class StateManager
     */
     RewindManager& rewindManager() const { return *myRewindManager; }
 
+    /**
+      The reader/writer of the (compressed) state files.
+    */
+    StateFile& stateFile() { return myStateFile; }
+
+  private:
+    /**
+      The mode selected by the user's Time Machine setting.
+    */
+    Mode defaultMode() const;
+
   private:
     // The parent OSystem object
     OSystem& myOSystem;
@@ -170,16 +201,18 @@ class StateManager
     // Whether the manager is in record or playback mode
     Mode myActiveMode{Mode::Off};
 
-    // MD5 of the currently active ROM (either in movie or rewind mode)
-    string myMD5;
-
-    // Serializer classes used to save/load the eventstream
-    Serializer myMovieWriter;
-    Serializer myMovieReader;
+    // The input movie being recorded
+    InputMovie myMovie;
 
     // Stored savestates to be later rewound
     unique_ptr<RewindManager> myRewindManager;
 
+    // Holds the current state while running ahead
+    ByteArray myRunAheadBuffer;
+
+    // Writes the state files in the background
+    StateFile myStateFile;
+
   private:
     // Following constructors and assignment operators not supported
     StateManager() = delete;
@@ -0,0 +1,93 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include "StorageWorker.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StorageWorker& StorageWorker::instance()
+{
+  static StorageWorker worker;
+  return worker;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StorageWorker::~StorageWorker()
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myQuit = true;
+  }
+  myJobQueued.notify_one();
+
+  if(myThread.joinable())
+    myThread.join();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StorageWorker::enqueue(const string& file, const Job& job)
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    if(!myThread.joinable())
+      myThread = std::thread(&StorageWorker::threadMain, this);
+
+    const auto queued = std::find_if(myJobs.begin(), myJobs.end(),
+        [&file](const auto& entry) { return entry.first == file; });
+    if(queued != myJobs.end())
+      queued->second = job;
+    else
+      myJobs.emplace_back(file, job);
+  }
+  myJobQueued.notify_one();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StorageWorker::flush()
+{
+  std::unique_lock<std::mutex> lock(myMutex);
+
+  myJobDone.wait(lock, [this]() { return myJobs.empty() && !myBusy; });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StorageWorker::threadMain()
+{
+  std::unique_lock<std::mutex> lock(myMutex);
+
+  for(;;)
+  {
+    myJobQueued.wait(lock, [this]() { return myQuit || !myJobs.empty(); });
+
+    // Finish the queued jobs before quitting, they hold unsaved data
+    if(myJobs.empty())
+      break;
+
+    const Job job = std::move(myJobs.front().second);
+    myJobs.pop_front();
+    myBusy = true;
+
+    lock.unlock();
+    try { job(); }
+    catch(...) { }
+    lock.lock();
+
+    myBusy = false;
+    myJobDone.notify_all();
+  }
+}
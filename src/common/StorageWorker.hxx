@@ -0,0 +1,96 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef STORAGE_WORKER_HXX
+#define STORAGE_WORKER_HXX
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "bspf.hxx"
+
+/**
+  A background thread which writes persistent cartridge and controller
+  data (Harmony flash, SaveKey/AtariVox EEPROM), so that the emulation
+  thread never waits for the storage.
+
+  Jobs are executed one at a time in the order they were queued.  A job
+  which is still queued is replaced by a newer one for the same file, as
+  that writes more recent data anyway.  As jobs run concurrently to the
+  emulation, they must either capture the data they write, or take a
+  snapshot of it under a lock.
+
+  @author  Stella Team
+*/
+class StorageWorker
+{
+  public:
+    using Job = std::function<void()>;
+
+    /**
+      The shared worker; its thread is started with the first job.
+    */
+    static StorageWorker& instance();
+
+    /**
+      Executes the remaining jobs, and stops the thread.
+    */
+    ~StorageWorker();
+
+    /**
+      Queue a job which writes the given file.
+    */
+    void enqueue(const string& file, const Job& job);
+
+    /**
+      Wait until all jobs queued so far have been executed.  Must not be
+      called from within a job.
+    */
+    void flush();
+
+  private:
+    StorageWorker() = default;
+
+    void threadMain();
+
+  private:
+    std::thread myThread;
+
+    std::mutex myMutex;
+    std::condition_variable myJobQueued;
+    std::condition_variable myJobDone;
+
+    // Pending jobs, with the file they write
+    std::deque<std::pair<string, Job>> myJobs;
+
+    // A job has been taken from the queue, but not finished yet
+    bool myBusy{false};
+    bool myQuit{false};
+
+  private:
+    // Following constructors and assignment operators not supported
+    StorageWorker(const StorageWorker&) = delete;
+    StorageWorker(StorageWorker&&) = delete;
+    StorageWorker& operator=(const StorageWorker&) = delete;
+    StorageWorker& operator=(StorageWorker&&) = delete;
+};
+
+#endif // STORAGE_WORKER_HXX
@@ -0,0 +1,223 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include <algorithm>
+#include <set>
+
+#if defined(BSPF_WINDOWS)
+  #include <windows.h>
+#elif defined(__APPLE__)
+  #include <pthread.h>
+#elif defined(__linux__)
+  #include <fstream>
+  #include <sched.h>
+  #include <sys/resource.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+#include "Settings.hxx"
+#include "ThreadControl.hxx"
+
+std::array<ThreadControl::Config, ThreadControl::NUM_THREADS> ThreadControl::ourConfig;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThreadControl::loadSettings(const Settings& settings)
+{
+  ourConfig.fill(Config());
+
+  const bool highPriority = settings.getBool("highpriority");
+  ourConfig[static_cast<uInt32>(Thread::main)].highPriority = highPriority;
+  ourConfig[static_cast<uInt32>(Thread::emulation)].highPriority = highPriority;
+
+  string affinity = BSPF::trim(settings.getString("affinity"));
+  BSPF::toLowerCase(affinity);
+
+  if(affinity == "off")
+    return;
+
+  if(affinity == "auto" || affinity == "")
+  {
+    // Leave the threads to the OS, unless we got a share of the CPUs
+    bool restricted = false;
+    const vector<Int32> cores = physicalCores(restricted);
+
+    if(restricted && cores.size() >= 2)
+    {
+      ourConfig[static_cast<uInt32>(Thread::emulation)].core = cores[0];
+      ourConfig[static_cast<uInt32>(Thread::audio)].core = cores[1];
+    }
+    return;
+  }
+
+  istringstream buf(affinity);
+  string core;
+  for(uInt32 i = 0; i < NUM_THREADS && std::getline(buf, core, ','); ++i)
+  {
+    core = BSPF::trim(core);
+    if(core != "*" && core != "")
+      ourConfig[i].core = std::max(BSPF::stringToInt(core, ANY_CORE), ANY_CORE);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThreadControl::setConfig(Thread thread, const Config& config)
+{
+  ourConfig[static_cast<uInt32>(thread)] = config;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ThreadControl::Config ThreadControl::config(Thread thread)
+{
+  return ourConfig[static_cast<uInt32>(thread)];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ThreadControl::apply(Thread thread)
+{
+  const Config& config = ourConfig[static_cast<uInt32>(thread)];
+  bool ok = true;
+
+  if(config.core != ANY_CORE)
+    ok = setAffinity(config.core) && ok;
+  if(config.highPriority)
+    ok = raisePriority() && ok;
+
+  return ok;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ThreadControl::setAffinity(Int32 core)
+{
+#if defined(BSPF_WINDOWS)
+  if(core < 0 || core >= Int32(sizeof(DWORD_PTR) * 8))
+    return false;
+
+  return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << core) != 0;
+#elif defined(__linux__)
+  if(core < 0 || core >= CPU_SETSIZE)
+    return false;
+
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(core, &set);
+
+  // 0 is the calling thread
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+  return false;
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ThreadControl::raisePriority()
+{
+#if defined(BSPF_WINDOWS)
+  return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_ABOVE_NORMAL) != 0;
+#elif defined(__APPLE__)
+  return pthread_set_qos_class_self_np(QOS_CLASS_USER_INTERACTIVE, 0) == 0;
+#elif defined(__linux__)
+  // Only affects this thread; fails unless the user may lower nice values
+  // (RLIMIT_NICE or CAP_SYS_NICE)
+  return setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), -5) == 0;
+#else
+  return false;
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<Int32> ThreadControl::physicalCores(bool& restricted)
+{
+  vector<Int32> cores;
+  restricted = false;
+
+#if defined(BSPF_WINDOWS)
+  DWORD_PTR processMask = 0, systemMask = 0;
+  if(!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+    return cores;
+  restricted = processMask != systemMask;
+
+  DWORD length = 0;
+  GetLogicalProcessorInformation(nullptr, &length);
+  vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(
+    length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+
+  if(!info.empty() && GetLogicalProcessorInformation(info.data(), &length))
+  {
+    // The first allowed logical CPU of each core
+    for(const auto& entry: info)
+    {
+      const DWORD_PTR mask = entry.ProcessorMask & processMask;
+      if(entry.Relationship == RelationProcessorCore && mask)
+      {
+        Int32 cpu = 0;
+        while(!(mask & (DWORD_PTR(1) << cpu)))
+          ++cpu;
+        cores.push_back(cpu);
+      }
+    }
+  }
+  else
+    for(Int32 cpu = 0; cpu < Int32(sizeof(DWORD_PTR) * 8); ++cpu)
+      if(processMask & (DWORD_PTR(1) << cpu))
+        cores.push_back(cpu);
+
+  std::sort(cores.begin(), cores.end());
+#elif defined(__linux__)
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if(sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+    return cores;
+  restricted = CPU_COUNT(&allowed) < sysconf(_SC_NPROCESSORS_ONLN);
+
+  const auto topology = [](Int32 cpu, const char* name) {
+    std::ifstream in("/sys/devices/system/cpu/cpu" + std::to_string(cpu) +
+                     "/topology/" + name);
+    Int32 id = -1;
+    in >> id;
+    return id;
+  };
+
+  // Hyper-threads share the package and core id
+  std::set<std::pair<Int32, Int32>> seen;
+  for(Int32 cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+  {
+    if(!CPU_ISSET(cpu, &allowed))
+      continue;
+
+    const Int32 core = topology(cpu, "core_id");
+    if(core < 0 || seen.emplace(topology(cpu, "physical_package_id"), core).second)
+      cores.push_back(cpu);
+  }
+#endif
+
+  return cores;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string ThreadControl::threadName(Thread thread)
+{
+  switch(thread)
+  {
+    case Thread::main:      return "main";
+    case Thread::emulation: return "emulation";
+    case Thread::audio:     return "audio";
+    case Thread::timer:     return "timer";
+    default:                return "";
+  }
+}
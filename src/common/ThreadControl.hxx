@@ -0,0 +1,116 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef THREAD_CONTROL_HXX
+#define THREAD_CONTROL_HXX
+
+class Settings;
+
+#include "bspf.hxx"
+
+/**
+  Pins Stella's threads to CPU cores and raises their scheduling priority,
+  as configured per thread.  Each thread applies its configuration itself
+  when it starts, so the configuration must be set up before.
+
+  The configuration is read from the settings 'affinity' and
+  'highpriority', or set directly by embedders.  By default ('auto'),
+  threads are only pinned if the process has been restricted to a subset
+  of the CPUs (e.g. with taskset or a cgroup, on hosts running several
+  instances).  Then the emulation thread and the audio callback are put
+  on different physical cores of that subset, and the other threads are
+  left to the OS.
+
+  Pinning is supported on Linux and Windows (up to 64 CPUs); elsewhere
+  apply() only changes the priority.
+
+  @author  Stella Team
+*/
+class ThreadControl
+{
+  public:
+    enum class Thread: uInt8 {
+      main,       // event handling, rendering, main loop
+      emulation,  // EmulationWorker
+      audio,      // the audio callback
+      timer,      // TimerManager
+      numThreads
+    };
+    static constexpr uInt32 NUM_THREADS = static_cast<uInt32>(Thread::numThreads);
+
+    // The core of a thread which is not pinned
+    static constexpr Int32 ANY_CORE = -1;
+
+    struct Config {
+      Int32 core{ANY_CORE};       // logical CPU number
+      bool highPriority{false};
+    };
+
+  public:
+    /**
+      Set up the configuration of all threads from the settings:
+      'affinity' is 'auto', 'off' or a list of cores for the main,
+      emulation, audio and timer thread (e.g. '0,2,3,*', with '*' for
+      any core); 'highpriority' raises the main and emulation thread.
+    */
+    static void loadSettings(const Settings& settings);
+
+    static void setConfig(Thread thread, const Config& config);
+    static Config config(Thread thread);
+
+    /**
+      Apply the configuration of the given thread to the calling thread.
+
+      @return  False if pinning or raising the priority failed
+    */
+    static bool apply(Thread thread);
+
+    /**
+      Pin the calling thread to the given logical CPU.
+    */
+    static bool setAffinity(Int32 core);
+
+    /**
+      Raise the scheduling priority of the calling thread, as far as this
+      is possible without special privileges.
+    */
+    static bool raisePriority();
+
+    /**
+      One logical CPU per physical core, out of the CPUs the process may
+      run on, in ascending order.
+
+      @param restricted  Set if the process may not run on all CPUs
+    */
+    static vector<Int32> physicalCores(bool& restricted);
+
+    static string threadName(Thread thread);
+
+  private:
+    static std::array<Config, NUM_THREADS> ourConfig;
+
+  private:
+    // Following constructors and assignment operators not supported
+    ThreadControl() = delete;
+    ThreadControl(const ThreadControl&) = delete;
+    ThreadControl(ThreadControl&&) = delete;
+    ThreadControl& operator=(const ThreadControl&) = delete;
+    ThreadControl& operator=(ThreadControl&&) = delete;
+};
+
+#endif // THREAD_CONTROL_HXX
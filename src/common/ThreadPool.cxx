@@ -0,0 +1,116 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "ThreadPool.hxx"
+
+namespace Common {
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ThreadPool::ThreadPool(uInt32 workers)
+{
+  myWorkers.reserve(workers);
+
+  for(uInt32 i = 0; i < workers; ++i)
+    myWorkers.emplace_back(&ThreadPool::workerMain, this);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myQuit = true;
+  }
+  myBatchStarted.notify_all();
+
+  for(auto& worker: myWorkers)
+    worker.join();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThreadPool::run(uInt32 count, const Task& task)
+{
+  if(myWorkers.empty() || count <= 1)
+  {
+    for(uInt32 i = 0; i < count; ++i)
+      task(i);
+
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(myMutex);
+
+  // A worker that woke up too late for the previous batch may still be
+  // looking for tasks; wait for it before replacing the batch
+  myBatchDone.wait(lock, [this] { return myBusyWorkers == 0; });
+
+  myTask = &task;
+  myTaskCount = count;
+  myNextTask = 0;
+  myPendingTasks = count;
+  ++myBatch;
+
+  lock.unlock();
+  myBatchStarted.notify_all();
+
+  work();
+
+  lock.lock();
+  myBatchDone.wait(lock, [this] { return myPendingTasks == 0; });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThreadPool::workerMain()
+{
+  uInt64 batch = 0;
+
+  for(;;)
+  {
+    std::unique_lock<std::mutex> lock(myMutex);
+    myBatchStarted.wait(lock, [&] { return myQuit || myBatch != batch; });
+
+    if(myQuit) return;
+
+    batch = myBatch;
+    ++myBusyWorkers;
+    lock.unlock();
+
+    work();
+
+    lock.lock();
+    if(--myBusyWorkers == 0) myBatchDone.notify_all();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThreadPool::work()
+{
+  uInt32 i;
+
+  while((i = myNextTask++) < myTaskCount)
+  {
+    (*myTask)(i);
+
+    if(--myPendingTasks == 0)
+    {
+      std::lock_guard<std::mutex> lock(myMutex);
+      myBatchDone.notify_all();
+    }
+  }
+}
+
+}  // End of namespace Common
@@ -0,0 +1,103 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef THREAD_POOL_HXX
+#define THREAD_POOL_HXX
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "bspf.hxx"
+
+/**
+  A fixed set of worker threads that stay alive for the lifetime of the
+  pool and execute batches of independent tasks.
+
+  run() distributes the tasks of a batch over the workers and the calling
+  thread. Tasks are handed out one at a time from a shared counter, so
+  faster threads automatically pick up more of them. Only one batch is
+  processed at a time, and run() must not be called from within a task.
+
+  @author Stella Team
+*/
+namespace Common {
+
+class ThreadPool
+{
+  public:
+    using Task = std::function<void(uInt32)>;
+
+    /**
+      Create a pool with the given number of worker threads, in addition to
+      the thread calling run(). With no workers, run() executes all tasks
+      on the calling thread.
+    */
+    explicit ThreadPool(uInt32 workers);
+    ~ThreadPool();
+
+    /**
+      Execute task(0) ... task(count - 1), and return once all of them have
+      finished.
+    */
+    void run(uInt32 count, const Task& task);
+
+    /**
+      The number of threads that work on a batch, including the caller.
+    */
+    uInt32 threads() const { return uInt32(myWorkers.size()) + 1; }
+
+  private:
+    void workerMain();
+
+    // Execute tasks of the current batch until none are left
+    void work();
+
+  private:
+    vector<std::thread> myWorkers;
+
+    std::mutex myMutex;
+    std::condition_variable myBatchStarted;
+    std::condition_variable myBatchDone;
+
+    // The current batch; only changed while no worker is inside work()
+    const Task* myTask{nullptr};
+    uInt32 myTaskCount{0};
+    uInt64 myBatch{0};
+
+    std::atomic<uInt32> myNextTask{0};
+    std::atomic<uInt32> myPendingTasks{0};
+
+    // Workers currently inside work(), guarded by myMutex
+    uInt32 myBusyWorkers{0};
+
+    bool myQuit{false};
+
+  private:
+    // Following constructors and assignment operators not supported
+    ThreadPool() = delete;
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+};
+
+}  // End of namespace Common
+
+#endif // THREAD_POOL_HXX
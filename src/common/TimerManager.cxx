@@ -17,11 +17,13 @@
 
 #include <cassert>
 #include "TimerManager.hxx"
+#include "ThreadControl.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-TimerManager::TimerManager()
+TimerManager::TimerManager(bool useThread)
   : nextId{no_timer + 1},
-    queue()
+    epoch{Clock::now()},
+    threaded{useThread}
 {
 }
 
@@ -42,7 +44,7 @@ TimerManager::~TimerManager()
     // allowing any deallocations to happen
     worker.join();
 
-    // Note that any timers still in the queue
+    // Note that any timers still in the wheel
     // will be destructed properly but they
     // will not be invoked
   }
@@ -57,20 +59,25 @@ TimerManager::TimerId TimerManager::addTimer(
   ScopedLock lock(sync);
 
   // Lazily start thread when first timer is requested
-  if (!worker.joinable())
+  if (threaded && !worker.joinable())
     worker = std::thread(&TimerManager::timerThreadWorker, this);
 
+  // Without any timers, the wheel can simply skip the elapsed time
+  const Tick now = currentTime();
+  if (active.empty())
+    currentTick = std::max(currentTick, now);
+
   // Assign an ID and insert it into function storage
   auto id = nextId++;
-  auto iter = active.emplace(id, Timer(id, Clock::now() + Duration(msDelay),
-      Duration(msPeriod), func));
+  auto iter = active.emplace(id, Timer(id,
+      std::max(now + msDelay, currentTick + 1), msPeriod, func));
+  Timer& timer = iter.first->second;
 
-  // Insert a reference to the Timer into ordering queue
-  Queue::iterator place = queue.emplace(iter.first->second);
+  schedule(timer);
 
-  // We need to notify the timer thread only if we inserted
-  // this timer into the front of the timer queue
-  bool needNotify = (place == queue.begin());
+  // We need to notify the timer thread only if this timer
+  // expires before the thread would wake up anyway
+  bool needNotify = threaded && timer.expires < wakeTick;
 
   lock.unlock();
 
@@ -85,15 +92,34 @@ bool TimerManager::clear(TimerId id)
 {
   ScopedLock lock(sync);
   auto i = active.find(id);
-  return destroy_impl(lock, i, true);
+  return destroy_impl(lock, i);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TimerManager::clear()
 {
   ScopedLock lock(sync);
-  while (!active.empty())
-    destroy_impl(lock, active.begin(), queue.size() == 1);
+
+  // Waiting for a running callback releases the lock, so the map
+  // must be searched again for each timer
+  std::vector<TimerId> ids;
+  ids.reserve(active.size());
+  for (const auto& i: active)
+    ids.push_back(i.first);
+
+  for (auto id: ids)
+    destroy_impl(lock, active.find(id));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TimerManager::update()
+{
+  if (threaded)
+    return;
+
+  ScopedLock lock(sync);
+  advance(currentTime());
+  fireDue(lock);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -120,77 +146,196 @@ TimerManager& TimerManager::global()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TimerManager::timerThreadWorker()
 {
+  ThreadControl::apply(ThreadControl::Thread::timer);
+
   ScopedLock lock(sync);
 
   while (!done)
   {
-    if (queue.empty())
+    advance(currentTime());
+    fireDue(lock);
+    if (done)
+      break;
+
+    // Wait until the next timer is ready or a timer creation notifies
+    wakeTick = nextEvent();
+    if (wakeTick == NO_TICK)
+      wakeUp.wait(lock);
+    else
+      wakeUp.wait_until(lock, epoch + Duration(wakeTick));
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TimerManager::link(Timer** list, Timer& timer)
+{
+  timer.list = list;
+  timer.prev = nullptr;
+  timer.next = *list;
+  if (*list)
+    (*list)->prev = &timer;
+  *list = &timer;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TimerManager::unlink(Timer& timer)
+{
+  if (!timer.list)
+    return;
+
+  if (timer.prev)
+    timer.prev->next = timer.next;
+  else
+    *timer.list = timer.next;
+  if (timer.next)
+    timer.next->prev = timer.prev;
+
+  timer.list = nullptr;
+  timer.prev = timer.next = nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TimerManager::schedule(Timer& timer)
+{
+  const Tick expires = timer.expires;
+
+  if (expires <= currentTick)
+  {
+    link(&due, timer);
+    return;
+  }
+
+  // The level is given by the highest slot bits in which the expiry time
+  // differs from the current time
+  const Tick diff = expires ^ currentTick;
+  for (uInt32 level = 0; level < LEVELS; ++level)
+  {
+    const uInt32 shift = SLOT_BITS * level;
+    if ((diff >> (shift + SLOT_BITS)) == 0)
     {
-      // Wait for done or work
-      wakeUp.wait(lock, [this] { return done || !queue.empty(); });
-      continue;
+      link(&wheel[level][(expires >> shift) & (SLOTS - 1)], timer);
+      return;
     }
+  }
+  link(&overflow, timer);
+}
 
-    auto queueHead = queue.begin();
-    Timer& timer = *queueHead;
-    auto now = Clock::now();
-    if (now >= timer.next)
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TimerManager::advance(Tick now)
+{
+  const auto reschedule = [this](Timer*& list) {
+    Timer* timer = list;
+    list = nullptr;
+    while (timer)
     {
-      queue.erase(queueHead);
+      Timer* next = timer->next;
+      timer->list = nullptr;
+      schedule(*timer);
+      timer = next;
+    }
+  };
 
-      // Mark it as running to handle racing destroy
-      timer.running = true;
+  // Jump from event to event instead of stepping through each tick
+  for (Tick tick = nextEvent(); tick <= now; tick = nextEvent())
+  {
+    currentTick = tick;
 
-      // Call the handler outside the lock
-      lock.unlock();
-      timer.handler();
-      lock.lock();
+    // At the start of a slot range, its timers are distributed to the
+    // lower levels (or become due)
+    for (uInt32 level = 1; level < LEVELS; ++level)
+    {
+      const uInt32 shift = SLOT_BITS * level;
+      if (tick & ((Tick(1) << shift) - 1))
+        break;
+      reschedule(wheel[level][(tick >> shift) & (SLOTS - 1)]);
+    }
+    if ((tick & ((Tick(1) << (SLOT_BITS * LEVELS)) - 1)) == 0)
+      reschedule(overflow);
+
+    reschedule(wheel[0][tick & (SLOTS - 1)]);
+  }
+  currentTick = std::max(currentTick, now);
+}
 
-      if (timer.running)
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TimerManager::fireDue(ScopedLock& lock)
+{
+  assert(lock.owns_lock());
+
+  while (due)
+  {
+    Timer& timer = *due;
+    unlink(timer);
+
+    // Mark it as running to handle racing destroy
+    timer.running = true;
+    dispatcher = std::this_thread::get_id();
+
+    // Call the handler outside the lock
+    lock.unlock();
+    timer.handler();
+    lock.lock();
+
+    if (timer.running)
+    {
+      timer.running = false;
+
+      // If it is periodic, schedule a new one; a late timer does not
+      // fire again until the next batch
+      if (timer.period > 0)
       {
-        timer.running = false;
-
-        // If it is periodic, schedule a new one
-        if (timer.period.count() > 0)
-        {
-          timer.next = timer.next + timer.period;
-          queue.emplace(timer);
-        }
-        else
-        {
-          // Not rescheduling, destruct it
-          active.erase(timer.id);
-        }
+        timer.expires = std::max(timer.expires + timer.period, currentTick + 1);
+        schedule(timer);
       }
       else
       {
-        // timer.running changed!
-        //
-        // Running was set to false, destroy was called
-        // for this Timer while the callback was in progress
-        // (this thread was not holding the lock during the callback)
-        // The thread trying to destroy this timer is waiting on
-        // a condition variable, so notify it
-        timer.waitCond->notify_all();
-
-        // The clearTimer call expects us to remove the instance
-        // when it detects that it is racing with its callback
+        // Not rescheduling, destruct it
         active.erase(timer.id);
       }
     }
     else
     {
-      // Wait until the timer is ready or a timer creation notifies
-      Timestamp next = timer.next;
-      wakeUp.wait_until(lock, next);
+      // timer.running changed!
+      //
+      // Running was set to false, destroy was called
+      // for this Timer while the callback was in progress
+      // (this thread was not holding the lock during the callback)
+      // The thread trying to destroy this timer is waiting on
+      // a condition variable, so notify it
+      timer.waitCond->notify_all();
+
+      // The clearTimer call expects us to remove the instance
+      // when it detects that it is racing with its callback
+      active.erase(timer.id);
     }
   }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-// NOTE: if notify is true, returns with lock unlocked
-bool TimerManager::destroy_impl(ScopedLock& lock, TimerMap::iterator i,
-                                bool notify)
+TimerManager::Tick TimerManager::nextEvent() const
+{
+  // A timer in a lower level always expires before any slot of a higher
+  // level has to be cascaded
+  for (uInt32 level = 0; level < LEVELS; ++level)
+  {
+    const uInt32 shift = SLOT_BITS * level;
+    const Tick base = (currentTick >> (shift + SLOT_BITS)) << (shift + SLOT_BITS);
+
+    for (Tick slot = ((currentTick >> shift) & (SLOTS - 1)) + 1; slot < SLOTS; ++slot)
+      if (wheel[level][slot])
+        return base | (slot << shift);
+  }
+  if (overflow)
+  {
+    const uInt32 shift = SLOT_BITS * LEVELS;
+    return ((currentTick >> shift) + 1) << shift;
+  }
+
+  return NO_TICK;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TimerManager::destroy_impl(ScopedLock& lock, TimerMap::iterator i)
 {
   assert(lock.owns_lock());
 
@@ -201,26 +346,21 @@ bool TimerManager::destroy_impl(ScopedLock& lock, TimerMap::iterator i,
   if (timer.running)
   {
     // A callback is in progress for this Timer,
-    // so flag it for deletion in the worker
+    // so flag it for deletion in the dispatching thread
     timer.running = false;
 
     // Assign a condition variable to this timer
     timer.waitCond.reset(new ConditionVar);
 
     // Block until the callback is finished
-    if (std::this_thread::get_id() != worker.get_id())
+    if (std::this_thread::get_id() != dispatcher)
       timer.waitCond->wait(lock);
   }
   else
   {
-    queue.erase(timer);
+    // No need to wake up the worker, it will find nothing to do
+    unlink(timer);
     active.erase(i);
-
-    if (notify)
-    {
-      lock.unlock();
-      wakeUp.notify_all();
-    }
   }
 
   return true;
@@ -233,7 +373,7 @@ bool TimerManager::destroy_impl(ScopedLock& lock, TimerMap::iterator i,
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TimerManager::Timer::Timer(Timer&& r) noexcept
   : id(r.id),
-    next(r.next),
+    expires(r.expires),
     period(r.period),
     handler(std::move(r.handler)),
     running(r.running)
@@ -241,10 +381,10 @@ TimerManager::Timer::Timer(Timer&& r) noexcept
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-TimerManager::Timer::Timer(TimerId tid, Timestamp tnext, Duration tperiod,
+TimerManager::Timer::Timer(TimerId tid, Tick texpires, Tick tperiod,
                            const TFunction& func) noexcept
   : id(tid),
-    next(tnext),
+    expires(texpires),
     period(tperiod),
     handler(func)
 {
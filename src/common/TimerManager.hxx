@@ -22,7 +22,6 @@
 #include <functional>
 #include <chrono>
 #include <unordered_map>
-#include <set>
 #include <cstdint>
 #include <thread>
 #include <mutex>
@@ -32,7 +31,16 @@
 
 /**
   This class provides a portable periodic/one-shot timer infrastructure
-  using worker threads and generic C++11 code.
+  using generic C++11 code.
+
+  Timers are kept in a hierarchical timer wheel with millisecond
+  resolution, so adding and cancelling a timer takes constant time,
+  independent of the number of active timers.  All timers which are due
+  are fired in one batch.
+
+  The callbacks are either run by a worker thread, or by the thread which
+  regularly calls update() (e.g. the main loop), which avoids waking up
+  another thread for each timer.
 
   @author  Doug Gale (doug65536)
            From "Code Review"
@@ -52,8 +60,14 @@ class TimerManager
     // Values that are a large-range millisecond count
     using millisec = uInt64;
 
-    // Constructor does not start worker until there is a Timer.
-    explicit TimerManager();
+    /**
+      Create a new timer manager.
+
+      @param useThread  If true, the callbacks are run by a worker thread,
+                        which is not started until there is a Timer.
+                        Otherwise the owner must call update() regularly.
+    */
+    explicit TimerManager(bool useThread = true);
 
     // Destructor is thread safe, even if a timer callback is running.
     // All callbacks are guaranteed to have returned before this
@@ -61,7 +75,7 @@ class TimerManager
     ~TimerManager();
 
     /**
-      Create a new timer using milliseconds, and add it to the internal queue.
+      Create a new timer using milliseconds, and add it to the timer wheel.
 
       @param msDelay  Callback starts firing this many milliseconds from now
       @param msPeriod If non-zero, callback is fired again after this period
@@ -112,6 +126,13 @@ class TimerManager
     */
     void clear();
 
+    /**
+      Fire all timers which are due.  This must be called regularly when
+      the manager was created without a worker thread, and does nothing
+      otherwise.  The callbacks are run by the calling thread.
+    */
+    void update();
+
     // Peek at current state
     std::size_t size() const noexcept;
     bool empty() const noexcept;
@@ -144,45 +165,73 @@ class TimerManager
     using Timestamp = std::chrono::time_point<Clock>;
     using Duration = std::chrono::milliseconds;
 
+    // Wheel ticks are milliseconds since the manager was created
+    using Tick = uInt64;
+
+    // Each wheel level has 64 slots, each covering 64 times the range
+    // of a slot in the level below (1 ms, 64 ms, 4.1 s and 4.4 min);
+    // timers further away wait in an overflow list
+    static constexpr uInt32 SLOT_BITS = 6;
+    static constexpr uInt32 SLOTS = 1 << SLOT_BITS;
+    static constexpr uInt32 LEVELS = 4;
+    static constexpr Tick NO_TICK = ~Tick(0);
+
     struct Timer
     {
       explicit Timer(TimerId tid = 0) : id(tid) { }
       Timer(Timer&& r) noexcept;
       Timer& operator=(Timer&& r) noexcept;
 
-      Timer(TimerId id, Timestamp next, Duration period, const TFunction& func) noexcept;
+      Timer(TimerId id, Tick expires, Tick period, const TFunction& func) noexcept;
 
       // Never called
       Timer(Timer const& r) = delete;
       Timer& operator=(Timer const& r) = delete;
 
       TimerId id{0};
-      Timestamp next;
-      Duration period;
+      Tick expires{0};
+      Tick period{0};
       TFunction handler;
 
+      // Links of the intrusive list the timer is currently in (a wheel
+      // slot, the overflow or the due list), nullptr if in none
+      Timer** list{nullptr};
+      Timer* prev{nullptr};
+      Timer* next{nullptr};
+
       // You must be holding the 'sync' lock to assign waitCond
       std::unique_ptr<ConditionVar> waitCond;
 
       bool running{false};
     };
 
-    // Comparison functor to sort the timer "queue" by Timer::next
-    struct NextActiveComparator
-    {
-      bool operator()(Timer const& a, Timer const& b) const noexcept
-      {
-        return a.next < b.next;
-      }
-    };
-
-    // Queue is a set of references to Timer objects, sorted by next
-    using QueueValue = std::reference_wrapper<Timer>;
-    using Queue = std::multiset<QueueValue, NextActiveComparator>;
+    // The Timer objects are physically stored in this map; its nodes
+    // never move, so the wheel can link them directly
     using TimerMap = std::unordered_map<TimerId, Timer>;
 
     void timerThreadWorker();
-    bool destroy_impl(ScopedLock& lock, TimerMap::iterator i, bool notify);
+    bool destroy_impl(ScopedLock& lock, TimerMap::iterator i);
+
+    // Intrusive list handling; all of these take constant time
+    static void link(Timer** list, Timer& timer);
+    static void unlink(Timer& timer);
+
+    // Put the timer into the wheel slot matching its expiry time
+    void schedule(Timer& timer);
+
+    // Move all timers expiring until 'now' into the due list
+    void advance(Tick now);
+
+    // Run the callbacks of all timers in the due list
+    void fireDue(ScopedLock& lock);
+
+    // The next tick at which a timer expires or a slot must be cascaded
+    // into a lower level, NO_TICK if there are no timers
+    Tick nextEvent() const;
+
+    Tick currentTime() const {
+      return std::chrono::duration_cast<Duration>(Clock::now() - epoch).count();
+    }
 
     // Inexhaustible source of unique IDs
     TimerId nextId;
@@ -190,16 +239,27 @@ class TimerManager
     // The Timer objects are physically stored in this map
     TimerMap active;
 
-    // The ordering queue holds references to items in 'active'
-    Queue queue;
+    // The wheel holds links to items in 'active'
+    Timer* wheel[LEVELS][SLOTS]{};
+    Timer* overflow{nullptr};
+    Timer* due{nullptr};
+
+    // The origin of the wheel ticks and the last tick processed
+    const Timestamp epoch;
+    Tick currentTick{0};
+
+    // The tick until which the worker thread waits
+    Tick wakeTick{NO_TICK};
 
     // One worker thread for an unlimited number of timers is acceptable
     // Lazily started when first timer is started
     // TODO: Implement auto-stopping the timer thread when it is idle for
     // a configurable period.
+    const bool threaded{true};
     mutable Lock sync;
     ConditionVar wakeUp;
     std::thread worker;
+    std::thread::id dispatcher;
     bool done{false};
 
     // Valid IDs are guaranteed not to be this value
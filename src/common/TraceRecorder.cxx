@@ -0,0 +1,138 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include "json_lib.hxx"
+#include "TraceRecorder.hxx"
+
+using json = nlohmann::json;
+
+std::atomic<bool> TraceRecorder::ourEnabled{false};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TraceRecorder& TraceRecorder::instance()
+{
+  static TraceRecorder recorder;
+
+  return recorder;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TraceRecorder::start()
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+
+  myEvents.clear();
+  myDroppedEvents = 0;
+  myThreadIds.clear();
+  myThreadNames.clear();
+  myStart = Clock::now();
+
+  ourEnabled = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TraceRecorder::stop()
+{
+  ourEnabled = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 TraceRecorder::threadId()
+{
+  const auto it = myThreadIds.find(std::this_thread::get_id());
+  if(it != myThreadIds.end())
+    return it->second;
+
+  const uInt32 id = uInt32(myThreadIds.size()) + 1;
+  myThreadIds.emplace(std::this_thread::get_id(), id);
+
+  return id;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TraceRecorder::setThreadName(const string& name)
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+
+  myThreadNames[threadId()] = name;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TraceRecorder::add(const char* name, const char* category,
+                        Clock::time_point start, Clock::time_point end,
+                        const char* argName, uInt64 arg)
+{
+  using std::chrono::duration_cast;
+  using std::chrono::nanoseconds;
+
+  std::lock_guard<std::mutex> lock(myMutex);
+
+  if(!enabled() || start < myStart) return;
+
+  if(myEvents.size() >= MAX_EVENTS)
+  {
+    ++myDroppedEvents;
+    return;
+  }
+
+  Event event;
+  event.name = name;
+  event.category = category;
+  event.argName = argName;
+  event.arg = arg;
+  event.start = duration_cast<nanoseconds>(start - myStart).count();
+  event.duration = duration_cast<nanoseconds>(end - start).count();
+  event.thread = threadId();
+
+  myEvents.push_back(event);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string TraceRecorder::toJson()
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+
+  json events = json::array();
+
+  for(const auto& [id, name]: myThreadNames)
+    events.push_back({
+      {"ph", "M"}, {"name", "thread_name"}, {"pid", 1}, {"tid", id},
+      {"args", {{"name", name}}}
+    });
+
+  for(const Event& event: myEvents)
+  {
+    // Timestamps are in microseconds
+    json entry = {
+      {"ph", "X"}, {"name", event.name}, {"cat", event.category},
+      {"pid", 1}, {"tid", event.thread},
+      {"ts", event.start / 1000.0}, {"dur", event.duration / 1000.0}
+    };
+    if(event.argName)
+      entry["args"] = {{event.argName, event.arg}};
+
+    events.push_back(entry);
+  }
+
+  json trace = json::object();
+  trace["traceEvents"] = events;
+  trace["displayTimeUnit"] = "ms";
+  trace["otherData"] = {{"droppedEvents", myDroppedEvents}};
+
+  return trace.dump();
+}
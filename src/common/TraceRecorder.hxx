@@ -0,0 +1,159 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef TRACE_RECORDER_HXX
+#define TRACE_RECORDER_HXX
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "bspf.hxx"
+
+/**
+  Records a timeline of events from all threads (emulation worker, main
+  loop, audio callback, rewind worker) and exports it in the Chrome
+  trace event format, which can be viewed with chrome://tracing or
+  Perfetto (ui.perfetto.dev).
+
+  Events are recorded with Scope objects, which cost only a flag check
+  while recording is disabled.  The number of recorded events is capped,
+  later events are counted but dropped.
+
+  @author Stella Team
+*/
+class TraceRecorder
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+      Records a complete event ('X') from construction to destruction.
+      'name' and 'category' must be string literals.
+    */
+    class Scope
+    {
+      public:
+        Scope(const char* name, const char* category)
+          : myName{name}, myCategory{category}, myActive{TraceRecorder::enabled()}
+        {
+          if(myActive) myStart = Clock::now();
+        }
+
+        ~Scope()
+        {
+          if(myActive)
+            instance().add(myName, myCategory, myStart, Clock::now(), myArgName, myArg);
+        }
+
+        /**
+          Attach a numeric argument (shown in the event details); 'name'
+          must be a string literal.
+        */
+        void setArg(const char* name, uInt64 value) { myArgName = name;  myArg = value; }
+
+      private:
+        const char* myName{nullptr};
+        const char* myCategory{nullptr};
+        const char* myArgName{nullptr};
+        uInt64 myArg{0};
+        bool myActive{false};
+        Clock::time_point myStart;
+
+      private:
+        Scope(const Scope&) = delete;
+        Scope(Scope&&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        Scope& operator=(Scope&&) = delete;
+    };
+
+  public:
+
+    static TraceRecorder& instance();
+
+    static bool enabled() { return ourEnabled.load(std::memory_order_relaxed); }
+
+    /**
+      Discard all events and start recording.
+    */
+    void start();
+
+    /**
+      Stop recording; the recorded events are kept until the next start().
+    */
+    void stop();
+
+    /**
+      Name the calling thread in the trace.
+    */
+    void setThreadName(const string& name);
+
+    /**
+      Record a complete event (thread-safe).
+    */
+    void add(const char* name, const char* category,
+             Clock::time_point start, Clock::time_point end,
+             const char* argName = nullptr, uInt64 arg = 0);
+
+    /**
+      The recorded events as Chrome trace event JSON.
+    */
+    string toJson();
+
+  private:
+    TraceRecorder() = default;
+
+    // Must be called with the mutex locked
+    uInt32 threadId();
+
+  private:
+    struct Event {
+      const char* name{nullptr};
+      const char* category{nullptr};
+      const char* argName{nullptr};
+      uInt64 arg{0};
+      uInt64 start{0}, duration{0};  // in nanoseconds since start()
+      uInt32 thread{0};
+    };
+
+    // Limits the memory used by a trace (~50 MB, several hours of emulation)
+    static constexpr size_t MAX_EVENTS = 1000000;
+
+    static std::atomic<bool> ourEnabled;
+
+    std::mutex myMutex;
+
+    vector<Event> myEvents;
+    uInt64 myDroppedEvents{0};
+
+    Clock::time_point myStart;
+
+    // Small consecutive ids for the threads, and their names
+    std::map<std::thread::id, uInt32> myThreadIds;
+    std::map<uInt32, string> myThreadNames;
+
+  private:
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder(TraceRecorder&&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(TraceRecorder&&) = delete;
+};
+
+#endif // TRACE_RECORDER_HXX
@@ -0,0 +1,132 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+#ifndef TRIPLE_BUFFER_HXX
+#define TRIPLE_BUFFER_HXX
+
+#include <atomic>
+#include "bspf.hxx"
+
+/**
+  A lock-free exchange of complete buffers between a single producer and a
+  single consumer thread.
+
+  The producer fills the write buffer and publishes it; the consumer picks
+  up the most recently published buffer whenever it is ready to do so.
+  Neither side ever waits for the other: a producer that publishes faster
+  than the consumer acquires simply recycles the unclaimed buffer, and a
+  consumer that finds nothing new keeps its current buffer.
+
+  @author Stella Team
+*/
+namespace Common {
+
+template <typename T>
+class TripleBuffer
+{
+  public:
+    TripleBuffer() = default;
+
+    /**
+      The buffer the producer is currently filling.
+    */
+    T& writeBuffer() { return myBuffers[myWriteIndex]; }
+
+    /**
+      Producer: make the write buffer the most recent complete buffer and
+      continue with a free one.
+    */
+    void publish() {
+      myWriteIndex = myReadyIndex.exchange(myWriteIndex | FRESH) & INDEX_MASK;
+    }
+
+    /**
+      Consumer: switch to the most recently published buffer.
+
+      @return  True if a buffer was published since the last acquire
+    */
+    bool acquire() {
+      if(!(myReadyIndex.load() & FRESH)) return false;
+
+      myReadIndex = myReadyIndex.exchange(myReadIndex) & INDEX_MASK;
+      return true;
+    }
+
+    /**
+      The buffer the consumer currently owns.
+    */
+    T& readBuffer() { return myBuffers[myReadIndex]; }
+    const T& readBuffer() const { return myBuffers[myReadIndex]; }
+
+    /**
+      The most recently published buffer, whether or not it has been
+      acquired. Only valid while neither side is active (e.g. for
+      serialization).
+    */
+    const T& latestBuffer() const {
+      const uInt8 ready = myReadyIndex.load();
+      return myBuffers[(ready & FRESH) ? (ready & INDEX_MASK) : myReadIndex];
+    }
+
+    /**
+      Like latestBuffer(), but marks the buffer as published and distinct
+      from the read buffer (copying the read buffer if necessary), so that
+      its contents can be restored independently. Only valid while neither
+      side is active.
+    */
+    T& restoreLatestBuffer() {
+      const uInt8 ready = myReadyIndex.load() & INDEX_MASK;
+
+      if(!(myReadyIndex.load() & FRESH)) myBuffers[ready] = myBuffers[myReadIndex];
+      myReadyIndex = ready | FRESH;
+
+      return myBuffers[ready];
+    }
+
+    /**
+      Reset all buffers to the given value and forget any published buffer.
+      Only valid while neither side is active.
+    */
+    void reset(const T& value) {
+      myBuffers.fill(value);
+      myWriteIndex = 0;
+      myReadIndex = 1;
+      myReadyIndex = 2;
+    }
+
+  private:
+    static constexpr uInt8 INDEX_MASK = 0x03, FRESH = 0x04;
+
+    std::array<T, 3> myBuffers;
+
+    // Owned by the producer and the consumer, respectively
+    uInt8 myWriteIndex{0};
+    uInt8 myReadIndex{1};
+
+    // The buffer in between, plus a flag marking it as not yet acquired
+    std::atomic<uInt8> myReadyIndex{2};
+
+  private:
+    // Following constructors and assignment operators not supported
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer(TripleBuffer&&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(TripleBuffer&&) = delete;
+};
+
+}  // Namespace Common
+
+#endif
@@ -0,0 +1,170 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#if defined(BSPF_WINDOWS)
+  #include <winsock2.h>
+  #include <ws2tcpip.h>
+  #ifdef _MSC_VER
+    #pragma comment(lib, "ws2_32.lib")
+  #endif
+  using socklen_t = int;
+#else
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <netdb.h>
+  #include <netinet/in.h>
+  #include <sys/socket.h>
+#endif
+
+#include <cstring>
+
+#include "UdpSocket.hxx"
+
+#if defined(BSPF_WINDOWS)
+namespace {
+  constexpr uintptr_t NO_SOCKET = ~uintptr_t(0);
+}
+#else
+namespace {
+  constexpr int NO_SOCKET = -1;
+}
+#endif
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+UdpSocket::~UdpSocket()
+{
+  close();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool UdpSocket::open(uInt16 port, const string& peerHost, uInt16 peerPort)
+{
+  close();
+
+#if defined(BSPF_WINDOWS)
+  WSADATA wsaData;
+  if(WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+    return false;
+  myWinsockStarted = true;
+#endif
+
+  // Resolve the peer first, there is no point in opening a socket otherwise
+  addrinfo hints, *result = nullptr;
+  std::memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_DGRAM;
+
+  if(getaddrinfo(peerHost.c_str(), nullptr, &hints, &result) != 0 || !result)
+  {
+    close();
+    return false;
+  }
+  myPeerAddress = reinterpret_cast<sockaddr_in*>(result->ai_addr)->sin_addr.s_addr;
+  myPeerPort = htons(peerPort);
+  freeaddrinfo(result);
+
+  const auto s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  if(s == NO_SOCKET)
+  {
+    close();
+    return false;
+  }
+  mySocket = s;
+
+  sockaddr_in local;
+  std::memset(&local, 0, sizeof(local));
+  local.sin_family = AF_INET;
+  local.sin_addr.s_addr = htonl(INADDR_ANY);
+  local.sin_port = htons(port);
+
+  bool ok = bind(mySocket, reinterpret_cast<sockaddr*>(&local), sizeof(local)) == 0;
+
+#if defined(BSPF_WINDOWS)
+  u_long nonBlocking = 1;
+  ok = ok && ioctlsocket(mySocket, FIONBIO, &nonBlocking) == 0;
+#else
+  ok = ok && fcntl(mySocket, F_SETFL, fcntl(mySocket, F_GETFL, 0) | O_NONBLOCK) == 0;
+#endif
+
+  if(!ok)
+    close();
+
+  return ok;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void UdpSocket::close()
+{
+#if defined(BSPF_WINDOWS)
+  if(mySocket != NO_SOCKET)
+    closesocket(mySocket);
+  if(myWinsockStarted)
+    WSACleanup();
+  myWinsockStarted = false;
+#else
+  if(mySocket != NO_SOCKET)
+    ::close(mySocket);
+#endif
+
+  mySocket = NO_SOCKET;
+  myPeerAddress = 0;
+  myPeerPort = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool UdpSocket::isOpen() const
+{
+  return mySocket != NO_SOCKET;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool UdpSocket::send(const uInt8* data, size_t size)
+{
+  if(!isOpen())
+    return false;
+
+  sockaddr_in peer;
+  std::memset(&peer, 0, sizeof(peer));
+  peer.sin_family = AF_INET;
+  peer.sin_addr.s_addr = myPeerAddress;
+  peer.sin_port = myPeerPort;
+
+  return sendto(mySocket, reinterpret_cast<const char*>(data), int(size), 0,
+                reinterpret_cast<sockaddr*>(&peer), sizeof(peer)) == int(size);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t UdpSocket::receive(uInt8* data, size_t capacity)
+{
+  if(!isOpen())
+    return 0;
+
+  for(;;)
+  {
+    sockaddr_in from;
+    socklen_t fromSize = sizeof(from);
+
+    const auto size = recvfrom(mySocket, reinterpret_cast<char*>(data), int(capacity), 0,
+                               reinterpret_cast<sockaddr*>(&from), &fromSize);
+    // Nothing pending (or an error, which is treated the same for UDP)
+    if(size <= 0)
+      return 0;
+
+    if(from.sin_addr.s_addr == myPeerAddress && from.sin_port == myPeerPort)
+      return size_t(size);
+  }
+}
@@ -0,0 +1,80 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef UDP_SOCKET_HXX
+#define UDP_SOCKET_HXX
+
+#include "bspf.hxx"
+
+/**
+  A minimal non-blocking UDP socket which exchanges datagrams with a
+  single peer (IPv4 only).  Datagrams from other addresses are dropped.
+*/
+class UdpSocket
+{
+  public:
+    UdpSocket() = default;
+    ~UdpSocket();
+
+    /**
+      Bind the socket to the given local port, and resolve the peer.
+
+      @param port      The local port
+      @param peerHost  Host name or address of the peer
+      @param peerPort  The peer's port
+
+      @return  False if the socket couldn't be created or the peer resolved
+    */
+    bool open(uInt16 port, const string& peerHost, uInt16 peerPort);
+
+    void close();
+
+    bool isOpen() const;
+
+    /**
+      Send a datagram to the peer.
+    */
+    bool send(const uInt8* data, size_t size);
+
+    /**
+      Receive a pending datagram from the peer, without blocking.
+
+      @return  The size of the datagram, or 0 if none is pending
+    */
+    size_t receive(uInt8* data, size_t capacity);
+
+  private:
+  #if defined(BSPF_WINDOWS)
+    uintptr_t mySocket{~uintptr_t(0)};
+    bool myWinsockStarted{false};
+  #else
+    int mySocket{-1};
+  #endif
+
+    // The peer's address and port, in network byte order
+    uInt32 myPeerAddress{0};
+    uInt16 myPeerPort{0};
+
+  private:
+    // Following constructors and assignment operators not supported
+    UdpSocket(const UdpSocket&) = delete;
+    UdpSocket(UdpSocket&&) = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+    UdpSocket& operator=(UdpSocket&&) = delete;
+};
+
+#endif // UDP_SOCKET_HXX
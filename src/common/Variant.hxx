@@ -18,6 +18,11 @@
 #ifndef VARIANT_HXX
 #define VARIANT_HXX
 
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+
 #include "Rect.hxx"
 #include "bspf.hxx"
 
@@ -27,6 +32,9 @@
   converts to other types as required.  Eventually, this class may be
   extended to use templates and become a more full-featured variant type.
 
+  The numeric and boolean interpretations are parsed once, whenever a value
+  is assigned, so that converting a variant is as cheap as reading a field.
+
   @author  Stephen Anthony
 */
 class Variant
@@ -35,44 +43,58 @@ class Variant
     // Underlying data store is (currently) always a string
     string data;
 
-    // Use singleton so we use only one ostringstream object
-    static ostringstream& buf() {
-      static ostringstream buf;
-      return buf;
+    // Pre-parsed numeric and boolean values of 'data'
+    Int32 dataInt{0};
+    float dataFloat{0.F};
+    bool dataBool{false};
+
+    // Parse the numeric values with the same semantics as extracting them
+    // from an istringstream: leading whitespace is skipped, parsing stops at
+    // the first invalid character, and out-of-range integers are clamped
+    void parse() {
+      const long long i = std::strtoll(data.c_str(), nullptr, 10);
+      dataInt = Int32(BSPF::clamp<long long>(i,
+          std::numeric_limits<Int32>::min(), std::numeric_limits<Int32>::max()));
+      dataFloat = std::strtof(data.c_str(), nullptr);
+      if(!std::isfinite(dataFloat))  // 'inf' and 'nan' aren't numbers for streams
+        dataFloat = 0.F;
+      dataBool = data == "1" || data == "true";
+    }
+
+    // Format floating point values the same way an ostream does by default
+    static string format(double d) {
+      std::array<char, 32> buf;
+      std::snprintf(buf.data(), buf.size(), "%g", d);
+      return buf.data();
+    }
+
+    template<typename T>
+    static string format(const T& t) {
+      ostringstream buf;
+      buf << t;
+      return buf.str();
     }
 
   public:
     Variant() { }  // NOLINT
 
-    Variant(const string& s) : data{s} { }
-    Variant(const char* s) : data{s} { }
+    Variant(const string& s) : data{s} { parse(); }
+    Variant(const char* s) : data{s} { parse(); }
 
-    Variant(Int32 i)  { buf().str(""); buf() << i; data = buf().str(); }
-    Variant(uInt32 i) { buf().str(""); buf() << i; data = buf().str(); }
-    Variant(float f)  { buf().str(""); buf() << f; data = buf().str(); }
-    Variant(double d) { buf().str(""); buf() << d; data = buf().str(); }
-    Variant(bool b)   { buf().str(""); buf() << b; data = buf().str(); }
-    Variant(const Common::Size& s) { buf().str(""); buf() << s; data = buf().str(); }
-    Variant(const Common::Point& s) { buf().str(""); buf() << s; data = buf().str(); }
+    Variant(Int32 i)  : data{std::to_string(i)} { parse(); }
+    Variant(uInt32 i) : data{std::to_string(i)} { parse(); }
+    Variant(float f)  : data{format(double(f))} { parse(); }
+    Variant(double d) : data{format(d)} { parse(); }
+    Variant(bool b)   : data{b ? "1" : "0"} { parse(); }
+    Variant(const Common::Size& s) : data{format(s)} { parse(); }
+    Variant(const Common::Point& s) : data{format(s)} { parse(); }
 
     // Conversion methods
     const string& toString() const { return data; }
     const char* toCString() const { return data.c_str(); }
-    Int32 toInt() const {
-      istringstream ss(data);
-      Int32 parsed;
-      ss >> parsed;
-
-      return parsed;
-    }
-    float toFloat() const {
-      istringstream ss(data);
-      float parsed;
-      ss >> parsed;
-
-      return parsed;
-    }
-    bool toBool() const         { return data == "1" || data == "true"; }
+    Int32 toInt() const { return dataInt; }
+    float toFloat() const { return dataFloat; }
+    bool toBool() const         { return dataBool; }
     Common::Size toSize() const { return Common::Size(data); }
     Common::Point toPoint() const { return Common::Point(data); }
 
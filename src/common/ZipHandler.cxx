@@ -25,6 +25,13 @@
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void ZipHandler::open(const string& filename)
 {
+  // The requested file is already open; its handle and index can be reused
+  if(myZip && myZip->myFilename == filename)
+  {
+    reset();
+    return;
+  }
+
   // Close already open file (if any) and add to cache
   addToCache();
 
@@ -34,12 +41,15 @@ void ZipHandler::open(const string& filename)
   ZipFilePtr ptr = findCached(filename);
   if(ptr)
   {
-    // Only a previously used entry will exist in the cache, so we know it's valid
-    myZip = std::move(ptr);
-
-    // Was already initialized; we just need to re-open it
-    if(!myZip->open())
+    // Only a previously used entry will exist in the cache, so we know it's
+    // valid; we just need to re-open it
+    const uInt64 length = ptr->myLength;
+    if(!ptr->open())
       throw runtime_error(errorMessage(ZipError::FILE_ERROR));
+
+    // The file has changed since it was indexed, so the index is stale
+    if(ptr->myLength != length)
+      ptr->initialize();
   }
   else
   {
@@ -51,22 +61,10 @@ void ZipHandler::open(const string& filename)
     // Open the file and initialize it
     if(!ptr->open())
       throw runtime_error(errorMessage(ZipError::FILE_ERROR));
-    try
-    {
-      ptr->initialize();
-    }
-    catch(...)
-    {
-      throw;
-    }
-
-    myZip = std::move(ptr);
 
-    // Count ROM files (we do it here so it will be cached)
-    while(hasNext())
-      if(Bankswitch::isValidRomName(next()))
-        myZip->myRomfiles++;
+    ptr->initialize();
   }
+  myZip = std::move(ptr);
 
   reset();  // Reset iterator to beginning for subsequent use
 }
@@ -76,13 +74,16 @@ void ZipHandler::reset()
 {
   // Reset the position and go from there
   if(myZip)
-    myZip->myCdPos = 0;
+  {
+    myZip->myEntryPos = 0;
+    myZip->myHeader = nullptr;
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool ZipHandler::hasNext() const
 {
-  return myZip && (myZip->myCdPos < myZip->myEcd.cdSize);
+  return myZip && (myZip->myEntryPos < myZip->myEntries.size());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -90,28 +91,41 @@ const string& ZipHandler::next()
 {
   if(hasNext())
   {
-    const ZipHeader* header = myZip->nextFile();
-    if(!header || header->uncompressedLength == 0)
-      return next();
-    else
-      return header->filename;
+    myZip->myHeader = &myZip->myEntries[myZip->myEntryPos++];
+    return myZip->myHeader->filename;
   }
   return EmptyString;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ZipHandler::find(const string& filename)
+{
+  if(myZip)
+  {
+    const auto it = myZip->myEntryIndex.find(filename);
+    if(it != myZip->myEntryIndex.end())
+    {
+      myZip->myHeader = &myZip->myEntries[it->second];
+      myZip->myEntryPos = it->second + 1;
+      return true;
+    }
+  }
+  return false;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt64 ZipHandler::decompress(ByteBuffer& image)
 {
-  if(myZip && myZip->myHeader.uncompressedLength > 0)
+  if(myZip && myZip->myHeader)
   {
-    uInt64 length = myZip->myHeader.uncompressedLength;
+    uInt64 length = myZip->myHeader->uncompressedLength;
     image = make_unique<uInt8[]>(length);
     if(image == nullptr)
       throw runtime_error(errorMessage(ZipError::OUT_OF_MEMORY));
 
     try
     {
-      myZip->decompress(image, length);
+      myZip->decompress(image.get(), length, nullptr);
       return length;
     }
     catch(const ZipError& err)
@@ -123,6 +137,27 @@ uInt64 ZipHandler::decompress(ByteBuffer& image)
     throw runtime_error("Invalid ZIP archive");
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 ZipHandler::decompress(const Consumer& consumer)
+{
+  if(myZip && myZip->myHeader && consumer)
+  {
+    ByteBuffer chunk = make_unique<uInt8[]>(DECOMPRESS_BUFSIZE);
+
+    try
+    {
+      myZip->decompress(chunk.get(), DECOMPRESS_BUFSIZE, consumer);
+      return myZip->myHeader->uncompressedLength;
+    }
+    catch(const ZipError& err)
+    {
+      throw runtime_error(errorMessage(err));
+    }
+  }
+  else
+    throw runtime_error("Invalid ZIP archive");
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string ZipHandler::errorMessage(ZipError err)
 {
@@ -196,9 +231,10 @@ void ZipHandler::addToCache()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 ZipHandler::ZipFile::ZipFile(const string& filename)
   : myFilename(filename),
-    myBuffer(make_unique<uInt8[]>(DECOMPRESS_BUFSIZE))
+    myBuffer(make_unique<uInt8[]>(DECOMPRESS_BUFSIZE + 1))
 {
-  std::fill(myBuffer.get(), myBuffer.get() + DECOMPRESS_BUFSIZE, 0);
+  // One more byte for the dummy byte zlib may read after the compressed data
+  std::fill(myBuffer.get(), myBuffer.get() + DECOMPRESS_BUFSIZE + 1, 0);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -221,33 +257,29 @@ bool ZipHandler::ZipFile::open()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void ZipHandler::ZipFile::initialize()
 {
-  try
-  {
-    // Read ecd data
-    readEcd();
+  // Read ecd data
+  readEcd();
 
-    // Verify that we can work with this zipfile (no disk spanning allowed)
-    if(myEcd.diskNumber != myEcd.cdStartDiskNumber ||
-       myEcd.cdDiskEntries != myEcd.cdTotalEntries)
-      throw runtime_error(errorMessage(ZipError::UNSUPPORTED));
+  // Verify that we can work with this zipfile (no disk spanning allowed)
+  if(myEcd.diskNumber != myEcd.cdStartDiskNumber ||
+     myEcd.cdDiskEntries != myEcd.cdTotalEntries)
+    throw runtime_error(errorMessage(ZipError::UNSUPPORTED));
 
-    // Allocate memory for the central directory
-    myCd = make_unique<uInt8[]>(myEcd.cdSize + 1);
-    if(myCd == nullptr)
-      throw runtime_error(errorMessage(ZipError::OUT_OF_MEMORY));
+  // Allocate memory for the central directory
+  ByteBuffer cd = make_unique<uInt8[]>(myEcd.cdSize + 1);
+  if(cd == nullptr)
+    throw runtime_error(errorMessage(ZipError::OUT_OF_MEMORY));
 
-    // Read the central directory
-    uInt64 read_length = 0;
-    bool success = readStream(myCd, myEcd.cdStartDiskOffset, myEcd.cdSize, read_length);
-    if(!success)
-      throw runtime_error(errorMessage(ZipError::FILE_ERROR));
-    else if(read_length != myEcd.cdSize)
-      throw runtime_error(errorMessage(ZipError::FILE_TRUNCATED));
-  }
-  catch(...)
-  {
-    throw;
-  }
+  // Read the central directory
+  uInt64 read_length = 0;
+  bool success = readStream(cd.get(), myEcd.cdStartDiskOffset, myEcd.cdSize, read_length);
+  if(!success)
+    throw runtime_error(errorMessage(ZipError::FILE_ERROR));
+  else if(read_length != myEcd.cdSize)
+    throw runtime_error(errorMessage(ZipError::FILE_TRUNCATED));
+
+  // Index all entries, so the raw data isn't needed anymore
+  parseCd(cd);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -278,7 +310,7 @@ void ZipHandler::ZipFile::readEcd()
       throw runtime_error(errorMessage(ZipError::OUT_OF_MEMORY));
 
     // Read in one buffers' worth of data
-    bool success = readStream(buffer, myLength - buflen, buflen, read_length);
+    bool success = readStream(buffer.get(), myLength - buflen, buflen, read_length);
     if(!success || read_length != buflen)
       throw runtime_error(errorMessage(ZipError::FILE_ERROR));
 
@@ -315,13 +347,13 @@ void ZipHandler::ZipFile::readEcd()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool ZipHandler::ZipFile::readStream(ByteBuffer& out, uInt64 offset,
+bool ZipHandler::ZipFile::readStream(uInt8* out, uInt64 offset,
                                      uInt64 length, uInt64& actual)
 {
   try
   {
     myStream.seekg(offset);
-    myStream.read(reinterpret_cast<char*>(out.get()), length);
+    myStream.read(reinterpret_cast<char*>(out), length);
 
     actual = myStream.gcount();
     return true;
@@ -333,40 +365,64 @@ bool ZipHandler::ZipFile::readStream(ByteBuffer& out, uInt64 offset,
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-const ZipHandler::ZipHeader* ZipHandler::ZipFile::nextFile()
+void ZipHandler::ZipFile::parseCd(const ByteBuffer& cd)
 {
-  // Make sure we have enough data
-  // If we're at or past the end, we're done
-  CentralDirEntryReader const reader(myCd.get() + myCdPos);
-  if(!reader.signatureCorrect() || ((myCdPos + reader.totalLength()) > myEcd.cdSize))
-    return nullptr;
-
-  // Extract file header info
-  myHeader.versionCreated     = reader.versionCreated();
-  myHeader.versionNeeded      = reader.versionNeeded();
-  myHeader.bitFlag            = reader.generalFlag();
-  myHeader.compression        = reader.compressionMethod();
-  myHeader.crc                = reader.crc32();
-  myHeader.compressedLength   = reader.compressedSize();
-  myHeader.uncompressedLength = reader.uncompressedSize();
-  myHeader.startDiskNumber    = reader.startDisk();
-  myHeader.localHeaderOffset  = reader.headerOffset();
-  myHeader.filename           = reader.filename();
-
-  // Advance the position
-  myCdPos += reader.totalLength();
-  return &myHeader;
+  myEntries.clear();
+  myEntries.reserve(myEcd.cdTotalEntries);
+  myEntryIndex.clear();
+  myEntryIndex.reserve(myEcd.cdTotalEntries);
+  myRomfiles = 0;
+  myEntryPos = 0;
+  myHeader = nullptr;
+
+  uInt64 pos = 0;
+  while(pos + CentralDirEntryReader::minimumLength() <= myEcd.cdSize)
+  {
+    // Make sure we have enough data
+    // If we're at or past the end, we're done
+    CentralDirEntryReader const reader(cd.get() + pos);
+    if(!reader.signatureCorrect() || ((pos + reader.totalLength()) > myEcd.cdSize))
+      break;
+
+    // Advance the position
+    pos += reader.totalLength();
+
+    // Directories (and other empty entries) are never returned
+    if(reader.uncompressedSize() == 0)
+      continue;
+
+    // Extract file header info
+    ZipHeader header;
+    header.versionCreated     = reader.versionCreated();
+    header.versionNeeded      = reader.versionNeeded();
+    header.bitFlag            = reader.generalFlag();
+    header.compression        = reader.compressionMethod();
+    header.crc                = reader.crc32();
+    header.compressedLength   = reader.compressedSize();
+    header.uncompressedLength = reader.uncompressedSize();
+    header.startDiskNumber    = reader.startDisk();
+    header.localHeaderOffset  = reader.headerOffset();
+    header.filename           = reader.filename();
+
+    // In case of duplicate names, the first entry wins
+    myEntryIndex.emplace(header.filename, myEntries.size());
+    if(Bankswitch::isValidRomName(header.filename))
+      myRomfiles++;
+
+    myEntries.push_back(std::move(header));
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void ZipHandler::ZipFile::decompress(ByteBuffer& out, uInt64 length)
+void ZipHandler::ZipFile::decompress(uInt8* out, uInt64 length,
+                                     const Consumer& consumer)
 {
   // If we don't have enough buffer, error
-  if(length < myHeader.uncompressedLength)
+  if(!consumer && length < myHeader->uncompressedLength)
     throw runtime_error(errorMessage(ZipError::BUFFER_TOO_SMALL));
 
   // Make sure the info in the header aligns with what we know
-  if(myHeader.startDiskNumber != myEcd.diskNumber)
+  if(myHeader->startDiskNumber != myEcd.diskNumber)
     throw runtime_error(errorMessage(ZipError::UNSUPPORTED));
 
   try
@@ -375,14 +431,14 @@ void ZipHandler::ZipFile::decompress(ByteBuffer& out, uInt64 length)
     uInt64 offset = getCompressedDataOffset();
 
     // Handle compression types
-    switch(myHeader.compression)
+    switch(myHeader->compression)
     {
       case 0:
-        decompressDataType0(offset, out, length);
+        decompressDataType0(offset, out, length, consumer);
         break;
 
       case 8:
-        decompressDataType8(offset, out, length);
+        decompressDataType8(offset, out, length, consumer);
         break;
 
       case 14:
@@ -403,15 +459,15 @@ void ZipHandler::ZipFile::decompress(ByteBuffer& out, uInt64 length)
 uInt64 ZipHandler::ZipFile::getCompressedDataOffset()
 {
   // Don't support a number of features
-  GeneralFlagReader const flags(myHeader.bitFlag);
-  if(myHeader.startDiskNumber != myEcd.diskNumber ||
-     myHeader.versionNeeded > 63 || flags.patchData() ||
+  GeneralFlagReader const flags(myHeader->bitFlag);
+  if(myHeader->startDiskNumber != myEcd.diskNumber ||
+     myHeader->versionNeeded > 63 || flags.patchData() ||
      flags.encrypted() || flags.strongEncryption())
     throw runtime_error(errorMessage(ZipError::UNSUPPORTED));
 
   // Read the fixed-sized part of the local file header
   uInt64 read_length = 0;
-  bool success = readStream(myBuffer, myHeader.localHeaderOffset, 0x1e, read_length);
+  bool success = readStream(myBuffer.get(), myHeader->localHeaderOffset, 0x1e, read_length);
   if(!success)
     throw runtime_error(errorMessage(ZipError::FILE_ERROR));
   else if(read_length != LocalFileHeaderReader::minimumLength())
@@ -422,36 +478,46 @@ uInt64 ZipHandler::ZipFile::getCompressedDataOffset()
   if(!reader.signatureCorrect())
     throw runtime_error(errorMessage(ZipError::BAD_SIGNATURE));
 
-  return myHeader.localHeaderOffset + reader.totalLength();
+  return myHeader->localHeaderOffset + reader.totalLength();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void ZipHandler::ZipFile::decompressDataType0(
-    uInt64 offset, ByteBuffer& out, uInt64 length)
+    uInt64 offset, uInt8* out, uInt64 length, const Consumer& consumer)
 {
-  // The data is uncompressed; just read it
-  uInt64 read_length = 0;
-  bool success = readStream(out, offset, myHeader.compressedLength, read_length);
-  if(!success)
-    throw runtime_error(errorMessage(ZipError::FILE_ERROR));
-  else if(read_length != myHeader.compressedLength)
-    throw runtime_error(errorMessage(ZipError::FILE_TRUNCATED));
+  // The data is uncompressed; just read it (in pieces, when streaming)
+  uInt64 remaining = myHeader->compressedLength;
+  while(remaining > 0)
+  {
+    const uInt64 chunk = consumer ? std::min(remaining, length) : remaining;
+    uInt64 read_length = 0;
+    bool success = readStream(out, offset, chunk, read_length);
+    if(!success)
+      throw runtime_error(errorMessage(ZipError::FILE_ERROR));
+    else if(read_length != chunk)
+      throw runtime_error(errorMessage(ZipError::FILE_TRUNCATED));
+
+    if(consumer)
+      consumer(out, size_t(chunk));
+    offset += chunk;
+    remaining -= chunk;
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void ZipHandler::ZipFile::decompressDataType8(
-    uInt64 offset, ByteBuffer& out, uInt64 length)
+    uInt64 offset, uInt8* out, uInt64 length, const Consumer& consumer)
 {
-  uInt64 input_remaining = myHeader.compressedLength;
+  uInt64 input_remaining = myHeader->compressedLength;
 
   // Reset the stream
-	z_stream stream;
-	stream.zalloc = Z_NULL;
-	stream.zfree = Z_NULL;
-	stream.opaque = Z_NULL;
-	stream.avail_in = 0;
-	stream.next_out = reinterpret_cast<Bytef *>(out.get());
-	stream.avail_out = uInt32(length); // TODO - use zip64
+  z_stream stream;
+  stream.zalloc = Z_NULL;
+  stream.zfree = Z_NULL;
+  stream.opaque = Z_NULL;
+  stream.avail_in = 0;
+  stream.next_out = reinterpret_cast<Bytef *>(out);
+  stream.avail_out = uInt32(length); // TODO - use zip64
 
   // Initialize the decompressor
   int zerr = inflateInit2(&stream, -MAX_WBITS);
@@ -461,43 +527,73 @@ void ZipHandler::ZipFile::decompressDataType8(
   // Loop until we're done
   for(;;)
   {
-    // Read in the next chunk of data
-    uInt64 read_length = 0;
-    bool success = readStream(myBuffer, offset,
-          std::min(input_remaining, uInt64(sizeof(myBuffer.get()))), read_length);
-    if(!success)
+    // Read in the next chunk of data, unless the previous one hasn't been
+    // completely consumed yet (when streaming into a small target buffer)
+    if(stream.avail_in == 0)
     {
-      inflateEnd(&stream);
-      throw runtime_error(errorMessage(ZipError::FILE_ERROR));
+      uInt64 read_length = 0;
+      bool success = readStream(myBuffer.get(), offset,
+            std::min(input_remaining, uInt64(DECOMPRESS_BUFSIZE)), read_length);
+      if(!success)
+      {
+        inflateEnd(&stream);
+        throw runtime_error(errorMessage(ZipError::FILE_ERROR));
+      }
+      offset += read_length;
+
+      // If we read nothing, but still have data left, the file is truncated
+      if(read_length == 0 && input_remaining > 0)
+      {
+        inflateEnd(&stream);
+        throw runtime_error(errorMessage(ZipError::FILE_TRUNCATED));
+      }
+
+      // Fill out the input data
+      stream.next_in = myBuffer.get();
+      stream.avail_in = uInt32(read_length); // TODO - use zip64
+      input_remaining -= read_length;
+
+      // Add a dummy byte at end of compressed data (the buffer has room
+      // for it, even after a full chunk)
+      if(input_remaining == 0)
+      {
+        myBuffer[read_length] = 0;
+        stream.avail_in++;
+      }
     }
-    offset += read_length;
 
-    // If we read nothing, but still have data left, the file is truncated
-    if(read_length == 0 && input_remaining > 0)
+    // Now inflate
+    zerr = inflate(&stream, Z_NO_FLUSH);
+    if(zerr != Z_OK && zerr != Z_STREAM_END)
     {
       inflateEnd(&stream);
-      throw runtime_error(errorMessage(ZipError::FILE_TRUNCATED));
+      throw runtime_error(errorMessage(ZipError::DECOMPRESS_ERROR));
     }
 
-    // Fill out the input data
-    stream.next_in = myBuffer.get();
-    stream.avail_in = uInt32(read_length); // TODO - use zip64
-    input_remaining -= read_length;
-
-    // Add a dummy byte at end of compressed data
-    if(input_remaining == 0)
-      stream.avail_in++;
+    // Hand a full target buffer (or the rest of the data) to the consumer
+    if(consumer && (stream.avail_out == 0 || zerr == Z_STREAM_END))
+    {
+      const size_t produced = size_t(length - stream.avail_out);
+      if(produced > 0)
+      {
+        try
+        {
+          consumer(out, produced);
+        }
+        catch(...)
+        {
+          inflateEnd(&stream);
+          throw;
+        }
+      }
+      stream.next_out = reinterpret_cast<Bytef *>(out);
+      stream.avail_out = uInt32(length);
+    }
 
-    // Now inflate
-    zerr = inflate(&stream, Z_NO_FLUSH);
     if(zerr == Z_STREAM_END)
       break;
-    else if(zerr != Z_OK)
-    {
-      inflateEnd(&stream);
-      throw runtime_error(errorMessage(ZipError::DECOMPRESS_ERROR));
-    }
   }
+  const uInt64 total = stream.total_out;
 
   // Finish decompression
   zerr = inflateEnd(&stream);
@@ -505,7 +601,7 @@ void ZipHandler::ZipFile::decompressDataType8(
     throw runtime_error(errorMessage(ZipError::DECOMPRESS_ERROR));
 
   // If anything looks funny, report an error
-  if(stream.avail_out > 0 || input_remaining > 0)
+  if(total != myHeader->uncompressedLength || input_remaining > 0)
     throw runtime_error(errorMessage(ZipError::DECOMPRESS_ERROR));
 }
 
@@ -20,6 +20,9 @@
 #ifndef ZIP_HANDLER_HXX
 #define ZIP_HANDLER_HXX
 
+#include <functional>
+#include <unordered_map>
+
 #include "bspf.hxx"
 
 /**
@@ -35,6 +38,8 @@ class ZipHandler
     ZipHandler() = default;
 
     // Open ZIP file for processing
+    // Re-opening the current file is cheap, since both its handle and its
+    // parsed central directory are kept
     // An exception will be thrown on any errors
     void open(const string& filename);
 
@@ -43,10 +48,22 @@ class ZipHandler
     bool hasNext() const;  // Answer whether there are more files present
     const string& next();  // Get next file
 
+    // Select the file with the given name (as returned by 'next()'), without
+    // iterating over the archive; answer whether it was found
+    bool find(const string& filename);
+
+    // Receives consecutive chunks of decompressed data
+    using Consumer = std::function<void(const uInt8* data, size_t length)>;
+
     // Decompress the currently selected file and return its length
     // An exception will be thrown on any errors
     uInt64 decompress(ByteBuffer& image);
 
+    // Decompress the currently selected file incrementally, passing the data
+    // to 'consumer' as it becomes available, and return its length
+    // An exception will be thrown on any errors
+    uInt64 decompress(const Consumer& consumer);
+
     // Answer the number of ROM files (with a valid extension) found
     uInt16 romFiles() const { return myZip ? myZip->myRomfiles : 0; }
 
@@ -104,9 +121,10 @@ class ZipHandler
 
       ZipEcd  myEcd;          // end of central directory
 
-      ByteBuffer myCd;        // central directory raw data
-      uInt64    myCdPos{0};   // position in central directory
-      ZipHeader myHeader;     // current file header
+      vector<ZipHeader> myEntries;  // parsed central directory (files only)
+      std::unordered_map<string, size_t> myEntryIndex;  // filename -> entry
+      size_t myEntryPos{0};         // position of iterator in entries
+      const ZipHeader* myHeader{nullptr};  // current file header
 
       ByteBuffer myBuffer;    // buffer for decompression
 
@@ -116,9 +134,12 @@ class ZipHandler
       /** Open the file and set up the internal stream buffer*/
       bool open();
 
-      /** Read the ZIP contents from the internal stream buffer */
+      /** Read and index the central directory from the internal stream buffer */
       void initialize();
 
+      /** Parse the raw central directory data into the entry index */
+      void parseCd(const ByteBuffer& cd);
+
       /** Close previously opened internal stream buffer */
       void close();
 
@@ -126,22 +147,25 @@ class ZipHandler
       void readEcd();
 
       /** Read data from stream */
-      bool readStream(ByteBuffer& out, uInt64 offset, uInt64 length, uInt64& actual);
-
-      /** Return the next entry in the ZIP file */
-      const ZipHeader* nextFile();
+      bool readStream(uInt8* out, uInt64 offset, uInt64 length, uInt64& actual);
 
-      /** Decompress the most recently found file in the ZIP into target buffer */
-      void decompress(ByteBuffer& out, uInt64 length);
+      /**
+        Decompress the most recently found file in the ZIP into target buffer.
+        Without a consumer, the buffer must be able to hold the whole file;
+        otherwise it is handed to the consumer (and reused) whenever full.
+      */
+      void decompress(uInt8* out, uInt64 length, const Consumer& consumer);
 
       /** Return the offset of the compressed data */
       uInt64 getCompressedDataOffset();
 
       /** Decompress type 0 data (which is uncompressed) */
-      void decompressDataType0(uInt64 offset, ByteBuffer& out, uInt64 length);
+      void decompressDataType0(uInt64 offset, uInt8* out, uInt64 length,
+                               const Consumer& consumer);
 
       /** Decompress type 8 data (which is deflated) */
-      void decompressDataType8(uInt64 offset, ByteBuffer& out, uInt64 length);
+      void decompressDataType8(uInt64 offset, uInt8* out, uInt64 length,
+                               const Consumer& consumer);
     };
     using ZipFilePtr = unique_ptr<ZipFile>;
 
@@ -0,0 +1,433 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <chrono>
+
+#include "AudioBenchmark.hxx"
+#include "Audio.hxx"
+#include "AudioQueue.hxx"
+#include "DispatchResult.hxx"
+#include "EmulationTiming.hxx"
+#include "FSNode.hxx"
+#include "HeadlessConsole.hxx"
+#include "LanczosResampler.hxx"
+#include "BlepResampler.hxx"
+#include "Logger.hxx"
+#include "SimpleResampler.hxx"
+#include "TIAConstants.hxx"
+#include "json_lib.hxx"
+
+using namespace std::chrono;
+using json = nlohmann::json;
+
+namespace {
+  constexpr uInt32 RUNTIME_DEFAULT = 10;
+
+  // Audio registers are sampled after every scanline while recording
+  constexpr uInt32 RECORD_CYCLES = 76;
+
+  // The trace is replayed in chunks of this many CPU cycles; after each
+  // chunk the resampler drains what the sound driver would have played
+  constexpr uInt32 REPLAY_CYCLES = 32 * 76;
+
+  // Two samples are generated per scanline of 228 color clocks
+  constexpr uInt32 CLOCKS_PER_SAMPLE = 114;
+}
+
+#ifdef AUDIO_BENCHMARK_ALLOCATIONS
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+  std::atomic<uInt64> ourAllocations{0};
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void* operator new(std::size_t size)
+{
+  ourAllocations.fetch_add(1, std::memory_order_relaxed);
+
+  void* ptr = std::malloc(size > 0 ? size : 1);
+  if (!ptr) throw std::bad_alloc();
+
+  return ptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+#endif
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+AudioBenchmark::AudioBenchmark(int argc, char* argv[])
+{
+  for (int i = 2; i < argc; i++) {
+    string arg = argv[i];
+
+    if (arg == "-json") {
+      myJsonOutput = true;
+
+      continue;
+    }
+    else if (arg == "-stereo") {
+      myStereo = true;
+
+      continue;
+    }
+    else if (arg == "-rates" && i + 1 < argc) {
+      mySampleRates = parseList(argv[++i]);
+
+      continue;
+    }
+    else if (arg == "-fragments" && i + 1 < argc) {
+      myFragmentSizes = parseList(argv[++i]);
+
+      continue;
+    }
+
+    size_t splitPoint = arg.find_first_of(':');
+    uInt32 runtime = RUNTIME_DEFAULT;
+
+    if (splitPoint != string::npos) {
+      int value = BSPF::stringToInt(arg.substr(splitPoint + 1, string::npos));
+      if (value > 0) runtime = value;
+    }
+
+    myRoms.emplace_back(arg.substr(0, splitPoint), runtime);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool AudioBenchmark::run()
+{
+  // Underruns are counted, not logged; also keeps the JSON report parseable
+  Logger::instance().setLogParameters(Logger::Level::ERR, false);
+
+  if (mySampleRates.empty() || myFragmentSizes.empty())
+    throw runtime_error("no sample rates or fragment sizes given");
+
+  constexpr std::array<AudioSettings::ResamplingQuality, 4> qualities = {
+    AudioSettings::ResamplingQuality::nearestNeightbour,
+    AudioSettings::ResamplingQuality::lanczos_2,
+    AudioSettings::ResamplingQuality::lanczos_3,
+    AudioSettings::ResamplingQuality::blep
+  };
+
+  bool ok = true;
+  json report = json::array();
+
+  for (const auto& [romFile, runtime] : myRoms) {
+    json entry = json::object();
+    entry["rom"] = romFile;
+    entry["runtime"] = runtime;
+
+    if (!myJsonOutput)
+      cout << endl << "recording " << romFile << " for " << runtime << " seconds..." << endl;
+
+    Trace trace;
+    try {
+      trace = record(romFile, runtime);
+    }
+    catch (const runtime_error& e) {
+      if (!myJsonOutput) cout << "ERROR: " << e.what() << endl;
+
+      entry["ok"] = false;
+      entry["error"] = e.what();
+      report.push_back(entry);
+      ok = false;
+
+      continue;
+    }
+
+    if (!myJsonOutput)
+      cout << trace.writes.size() << " audio register writes, "
+           << (trace.frameLayout == FrameLayout::pal ? "PAL" : "NTSC") << endl;
+
+    json results = json::array();
+
+    for (uInt32 sampleRate : mySampleRates)
+      for (uInt32 fragmentSize : myFragmentSizes)
+        for (auto quality : qualities) {
+          Result result = replay(trace, Configuration{sampleRate, fragmentSize, quality});
+
+          if (!myJsonOutput) {
+            printResult(result);
+            continue;
+          }
+
+          json r = json::object();
+          r["sampleRate"] = sampleRate;
+          r["fragmentSize"] = fragmentSize;
+          r["resampling"] = qualityName(quality);
+          r["inputSamples"] = result.inputSamples;
+          r["outputSamples"] = result.outputSamples;
+          r["tiaNsPerSample"] = 1e9 * result.tiaTime / std::max<uInt64>(result.inputSamples, 1);
+          r["resamplerNsPerSample"] =
+            1e9 * result.resamplerTime / std::max<uInt64>(result.outputSamples, 1);
+          r["underruns"] = result.underruns;
+        #ifdef AUDIO_BENCHMARK_ALLOCATIONS
+          r["allocations"] = result.allocations;
+        #endif
+          results.push_back(r);
+        }
+
+    entry["ok"] = true;
+    entry["layout"] = trace.frameLayout == FrameLayout::pal ? "PAL" : "NTSC";
+    entry["writes"] = trace.writes.size();
+    entry["results"] = results;
+    report.push_back(entry);
+  }
+
+  if (myJsonOutput) cout << report.dump(2) << endl;
+
+  return ok;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+AudioBenchmark::Trace AudioBenchmark::record(const string& romFile, uInt32 runtime) const
+{
+  HeadlessConsole console{FilesystemNode(romFile)};
+  TIA& tia(console.tia());
+
+  Trace trace;
+  trace.frameLayout = console.frameLayout();
+  trace.consoleTiming = console.timing();
+
+  const uInt64 cyclesTarget =
+    uInt64(runtime) * EmulationTiming(trace.frameLayout, trace.consoleTiming).cyclesPerSecond();
+
+  // The audio channels power up with all registers cleared
+  std::array<uInt8, AUDV1 - AUDC0 + 1> registers{0};
+
+  DispatchResult dispatchResult;
+  dispatchResult.setOk(0);
+
+  while (trace.cycles < cyclesTarget) {
+    tia.update(dispatchResult, RECORD_CYCLES);
+
+    if (dispatchResult.getStatus() != DispatchResult::Status::ok)
+      throw runtime_error("emulation failed after " + std::to_string(trace.cycles) + " cycles");
+
+    trace.cycles += dispatchResult.getCycles();
+
+    // Writes are timestamped with the end of the scanline they happened in
+    for (uInt8 reg = AUDC0; reg <= AUDV1; ++reg) {
+      const uInt8 value = tia.registerValue(reg);
+
+      if (value == registers[reg - AUDC0]) continue;
+
+      registers[reg - AUDC0] = value;
+      trace.writes.push_back(TraceEntry{trace.cycles, reg, value});
+    }
+
+    if (tia.newFramePending()) tia.renderToFrameBuffer();
+  }
+
+  return trace;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+AudioBenchmark::Result AudioBenchmark::replay(const Trace& trace,
+                                              const Configuration& config) const
+{
+  Result result;
+  result.config = config;
+
+  // Size everything as Console and SoundSDL2 would for this configuration
+  EmulationTiming timing(trace.frameLayout, trace.consoleTiming);
+  timing
+    .updatePlaybackRate(config.sampleRate)
+    .updatePlaybackPeriod(config.fragmentSize);
+
+  auto queue = make_shared<AudioQueue>(
+    timing.audioFragmentSize(), timing.audioQueueCapacity(), myStereo);
+
+  Audio audio;
+  audio.setAudioQueue(queue);
+
+  Int16* currentFragment = nullptr;
+  bool underrun = true;
+
+  Resampler::NextFragmentCallback nextFragmentCallback = [&] () -> Int16* {
+    Int16* nextFragment = nullptr;
+
+    if (underrun)
+      nextFragment = queue->size() >= timing.prebufferFragmentCount() ?
+          queue->dequeue(currentFragment) : nullptr;
+    else
+      nextFragment = queue->dequeue(currentFragment);
+
+    if (!nextFragment && !underrun) ++result.underruns;
+
+    underrun = nextFragment == nullptr;
+    if (nextFragment) currentFragment = nextFragment;
+
+    return nextFragment;
+  };
+
+  // The sound driver always opens a stereo device
+  Resampler::Format formatFrom(timing.audioSampleRate(), timing.audioFragmentSize(), myStereo);
+  Resampler::Format formatTo(config.sampleRate, config.fragmentSize, true);
+
+  unique_ptr<Resampler> resampler;
+  switch (config.quality) {
+    case AudioSettings::ResamplingQuality::nearestNeightbour:
+      resampler = make_unique<SimpleResampler>(formatFrom, formatTo, nextFragmentCallback);
+      break;
+
+    case AudioSettings::ResamplingQuality::lanczos_2:
+      resampler = make_unique<LanczosResampler>(formatFrom, formatTo, nextFragmentCallback, 2);
+      break;
+
+    case AudioSettings::ResamplingQuality::lanczos_3:
+      resampler = make_unique<LanczosResampler>(formatFrom, formatTo, nextFragmentCallback, 3);
+      break;
+
+    case AudioSettings::ResamplingQuality::blep:
+      resampler = make_unique<BlepResampler>(formatFrom, formatTo, nextFragmentCallback);
+      break;
+
+    default:
+      throw runtime_error("invalid resampling quality");
+  }
+
+  vector<float> output(2 * config.fragmentSize);
+
+  // Output lags behind by the fragments the driver waits for before playback
+  const uInt64 latency = uInt64(timing.prebufferFragmentCount()) * timing.audioFragmentSize();
+  const uInt64 sampleRateFrom = timing.audioSampleRate();
+
+  auto write = [&audio] (const TraceEntry& entry) {
+    AudioChannel& channel = (entry.reg - AUDC0) % 2 ? audio.channel1() : audio.channel0();
+
+    switch (entry.reg) {
+      case AUDC0: case AUDC1: channel.audc(entry.value); break;
+      case AUDF0: case AUDF1: channel.audf(entry.value); break;
+      default:                channel.audv(entry.value); break;
+    }
+  };
+
+#ifdef AUDIO_BENCHMARK_ALLOCATIONS
+  const uInt64 allocations = ourAllocations.load();
+#endif
+
+  auto nextWrite = trace.writes.cbegin();
+  uInt64 clocks = 0;
+
+  for (uInt64 cycle = 0; cycle < trace.cycles; ) {
+    const uInt64 chunkEnd = std::min(cycle + REPLAY_CYCLES, trace.cycles);
+
+    time_point<high_resolution_clock> tp = high_resolution_clock::now();
+
+    for (; cycle < chunkEnd; ++cycle) {
+      while (nextWrite != trace.writes.cend() && nextWrite->cycle <= cycle)
+        write(*nextWrite++);
+
+      audio.tick();
+      audio.tick();
+      audio.tick();
+    }
+
+    result.tiaTime +=
+      duration_cast<duration<double>>(high_resolution_clock::now() - tp).count();
+
+    clocks = 3 * cycle;
+    const uInt64 inputSamples = clocks / CLOCKS_PER_SAMPLE;
+    if (inputSamples <= latency) continue;
+
+    tp = high_resolution_clock::now();
+
+    while ((result.outputSamples + config.fragmentSize) * sampleRateFrom <=
+           (inputSamples - latency) * config.sampleRate) {
+      resampler->fillFragment(output.data(), uInt32(output.size()));
+      result.outputSamples += config.fragmentSize;
+    }
+
+    result.resamplerTime +=
+      duration_cast<duration<double>>(high_resolution_clock::now() - tp).count();
+  }
+
+  result.inputSamples = clocks / CLOCKS_PER_SAMPLE;
+
+#ifdef AUDIO_BENCHMARK_ALLOCATIONS
+  result.allocations = ourAllocations.load() - allocations;
+#endif
+
+  return result;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioBenchmark::printResult(const Result& result) const
+{
+  const Configuration& config(result.config);
+
+  cout << std::setw(6) << config.sampleRate << " Hz, fragment " << std::setw(4)
+       << config.fragmentSize << ", " << std::left << std::setw(9)
+       << qualityName(config.quality) << std::right << ": "
+       << std::fixed << std::setprecision(1)
+       << "TIA " << 1e9 * result.tiaTime / std::max<uInt64>(result.inputSamples, 1)
+       << " ns/sample, resampler "
+       << 1e9 * result.resamplerTime / std::max<uInt64>(result.outputSamples, 1)
+       << " ns/sample, " << result.underruns << " underruns";
+#ifdef AUDIO_BENCHMARK_ALLOCATIONS
+  cout << ", " << result.allocations << " allocations";
+#endif
+  cout << endl;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<uInt32> AudioBenchmark::parseList(const string& list)
+{
+  vector<uInt32> values;
+  std::istringstream buf(list);
+  string item;
+
+  while (std::getline(buf, item, ','))
+  {
+    int value = BSPF::stringToInt(item);
+    if (value > 0) values.push_back(value);
+  }
+
+  return values;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const char* AudioBenchmark::qualityName(AudioSettings::ResamplingQuality quality)
+{
+  switch (quality) {
+    case AudioSettings::ResamplingQuality::lanczos_2:
+      return "lanczos_2";
+
+    case AudioSettings::ResamplingQuality::lanczos_3:
+      return "lanczos_3";
+
+    case AudioSettings::ResamplingQuality::blep:
+      return "blep";
+
+    default:
+      return "nearest";
+  }
+}
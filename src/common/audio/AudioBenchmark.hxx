@@ -0,0 +1,127 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef AUDIO_BENCHMARK_HXX
+#define AUDIO_BENCHMARK_HXX
+
+#include "bspf.hxx"
+#include "AudioSettings.hxx"
+#include "FrameLayout.hxx"
+#include "ConsoleTiming.hxx"
+
+/**
+  Measures the cost of the audio pipeline in isolation: the TIA audio
+  circuit (Audio::tick and addSample), the AudioQueue, and the high pass
+  and resampling stage that the sound driver runs.
+
+  Usage: stella -benchaudio [-json] [-stereo] [-rates <r>,...]
+                            [-fragments <f>,...] rom[:seconds] ...
+
+  For each ROM the audio registers are recorded while the ROM runs
+  headless for the given amount of emulated time. The recorded trace is
+  then replayed through a standalone Audio instance, an AudioQueue sized
+  as the emulation core would size it, and each resampler, for every
+  combination of output sample rate and output fragment size. The time
+  spent in the TIA stage is reported per generated sample, the time spent
+  in the resampler per output sample. If Stella was built with
+  AUDIO_BENCHMARK_ALLOCATIONS defined, the heap allocations during replay
+  are counted as well.
+
+  With '-stereo' the TIA generates separate samples for both channels, as
+  with 'audio.stereo'. With '-json' a machine-readable report is written
+  to stdout.
+*/
+class AudioBenchmark
+{
+  public:
+
+    AudioBenchmark(int argc, char* argv[]);
+
+    bool run();
+
+  private:
+
+    // A single write to one of the audio registers
+    struct TraceEntry {
+      uInt64 cycle{0};
+      uInt8 reg{0};
+      uInt8 value{0};
+    };
+
+    struct Trace {
+      // The TIA sample rate depends on the timing of the ROM
+      FrameLayout frameLayout{FrameLayout::ntsc};
+      ConsoleTiming consoleTiming{ConsoleTiming::ntsc};
+      uInt64 cycles{0};
+      vector<TraceEntry> writes;
+    };
+
+    struct Configuration {
+      uInt32 sampleRate{0};
+      uInt32 fragmentSize{0};
+      AudioSettings::ResamplingQuality quality{AudioSettings::ResamplingQuality::nearestNeightbour};
+    };
+
+    struct Result {
+      Configuration config;
+      uInt64 inputSamples{0};
+      uInt64 outputSamples{0};
+      double tiaTime{0};
+      double resamplerTime{0};
+      uInt64 allocations{0};
+      uInt32 underruns{0};
+    };
+
+  private:
+
+    /**
+      Run the ROM headless and record all changes to the audio registers.
+      Throws a runtime_error if the ROM cannot be loaded or emulation fails.
+    */
+    Trace record(const string& romFile, uInt32 runtime) const;
+
+    /**
+      Replay a trace through the audio pipeline, configured as given.
+    */
+    Result replay(const Trace& trace, const Configuration& config) const;
+
+    void printResult(const Result& result) const;
+
+    static vector<uInt32> parseList(const string& list);
+
+    static const char* qualityName(AudioSettings::ResamplingQuality quality);
+
+  private:
+
+    vector<std::pair<string, uInt32>> myRoms;
+
+    vector<uInt32> mySampleRates{44100, 48000};
+    vector<uInt32> myFragmentSizes{512, 1024};
+
+    bool myStereo{false};
+    bool myJsonOutput{false};
+
+  private:
+    // Following constructors and assignment operators not supported
+    AudioBenchmark() = delete;
+    AudioBenchmark(const AudioBenchmark&) = delete;
+    AudioBenchmark(AudioBenchmark&&) = delete;
+    AudioBenchmark& operator=(const AudioBenchmark&) = delete;
+    AudioBenchmark& operator=(AudioBenchmark&&) = delete;
+};
+
+#endif // AUDIO_BENCHMARK_HXX
@@ -0,0 +1,192 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <cmath>
+
+#include "BlepResampler.hxx"
+
+namespace {
+
+  // Same headroom as LanczosResampler, both overshoot at steps
+  constexpr float CLIPPING_FACTOR = 0.75;
+  constexpr float HIGH_PASS_CUT_OFF = 10;
+
+  // Cut-off of the impulse in units of the output sample rate, a little
+  // below the Nyquist frequency
+  constexpr double CUT_OFF = 0.45;
+
+  double sinc(double x)
+  {
+    return x == 0 ? 1 : sin(BSPF::PI_d * x) / BSPF::PI_d / x;
+  }
+
+  double blackman(double x, double width)
+  {
+    const double phase = 2 * BSPF::PI_d * (x / width + 0.5);
+
+    return 0.42 - 0.5 * cos(phase) + 0.08 * cos(2 * phase);
+  }
+
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+BlepResampler::BlepResampler(
+  Resampler::Format formatFrom,
+  Resampler::Format formatTo,
+  const Resampler::NextFragmentCallback& nextFragmentCallback)
+:
+  Resampler(formatFrom, formatTo, nextFragmentCallback),
+  // The high pass runs on the output
+  myHighPassL{HIGH_PASS_CUT_OFF, float(formatTo.sampleRate)},
+  myHighPassR{HIGH_PASS_CUT_OFF, float(formatTo.sampleRate)}
+{
+  precomputeKernels();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BlepResampler::precomputeKernels()
+{
+  // Kernel i is the windowed sinc impulse for a step i / KERNEL_PHASES
+  // output samples after the first tap, delayed by half the kernel size.
+  // Every kernel is normalized to a sum of one, so that the running sum
+  // reaches the exact value of the step.
+  for (uInt32 i = 0; i < KERNEL_PHASES; ++i) {
+    float* kernel = myKernels.data() + i * KERNEL_SIZE;
+    double sum = 0;
+
+    for (uInt32 j = 0; j < KERNEL_SIZE; ++j) {
+      const double x = double(j) - double(KERNEL_SIZE / 2) - double(i) / KERNEL_PHASES;
+      const double value = sinc(2 * CUT_OFF * x) * blackman(x, KERNEL_SIZE);
+
+      kernel[j] = float(value);
+      sum += value;
+    }
+
+    for (uInt32 j = 0; j < KERNEL_SIZE; ++j)
+      kernel[j] = float(kernel[j] / sum);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BlepResampler::fillFragment(float* fragment, uInt32 length)
+{
+  if (myIsUnderrun) {
+    Int16* nextFragment = myNextFragmentCallback();
+
+    if (nextFragment) {
+      myCurrentFragment = nextFragment;
+      myFragmentIndex = 0;
+      myIsUnderrun = false;
+    }
+  }
+
+  if (!myCurrentFragment) {
+    std::fill_n(fragment, length, 0.F);
+    return;
+  }
+
+  const uInt32 outputSamples = myFormatTo.stereo ? (length >> 1) : length;
+
+  const uInt64 timeStep = this->timeStep();
+
+  for (uInt32 i = 0; i < outputSamples; ++i) {
+    // Place all input samples that can contribute to this output sample
+    while (myTimeIndex < KERNEL_SIZE * timeStep)
+      feedSample();
+
+    if (myFormatFrom.stereo) {
+      float sampleL = nextOutput(myChannelL, myHighPassL);
+      float sampleR = nextOutput(myChannelR, myHighPassR);
+
+      if (myFormatTo.stereo) {
+        fragment[2*i] = sampleL;
+        fragment[2*i + 1] = sampleR;
+      }
+      else
+        fragment[i] = (sampleL + sampleR) / 2.F;
+    } else {
+      float sample = nextOutput(myChannelL, myHighPassL);
+
+      if (myFormatTo.stereo)
+        fragment[2*i] = fragment[2*i + 1] = sample;
+      else
+        fragment[i] = sample;
+    }
+
+    myBufferIndex = (myBufferIndex + 1) % BUFFER_SIZE;
+    myTimeIndex -= timeStep;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BlepResampler::feedSample()
+{
+  const uInt64 timeStep = this->timeStep();
+  const uInt32 position = static_cast<uInt32>(myTimeIndex / timeStep);
+  const uInt32 phase = static_cast<uInt32>((myTimeIndex % timeStep) * KERNEL_PHASES / timeStep);
+
+  if (myFormatFrom.stereo) {
+    addStep(myChannelL, toFloat(myCurrentFragment[2*myFragmentIndex]), position, phase);
+    addStep(myChannelR, toFloat(myCurrentFragment[2*myFragmentIndex + 1]), position, phase);
+  }
+  else
+    addStep(myChannelL, toFloat(myCurrentFragment[myFragmentIndex]), position, phase);
+
+  myTimeIndex += samplePeriod();
+
+  ++myFragmentIndex;
+
+  if (myFragmentIndex >= myFormatFrom.fragmentSize) {
+    myFragmentIndex %= myFormatFrom.fragmentSize;
+
+    Int16* nextFragment = myNextFragmentCallback();
+    if (nextFragment) {
+      myCurrentFragment = nextFragment;
+      myIsUnderrun = false;
+    } else {
+      myIsUnderrun = true;
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void BlepResampler::addStep(Channel& channel, float value,
+                                   uInt32 position, uInt32 phase)
+{
+  // Most input samples repeat the previous one
+  if (value == channel.lastValue) return;
+
+  const float delta = (value - channel.lastValue) * CLIPPING_FACTOR;
+  const float* kernel = myKernels.data() + phase * KERNEL_SIZE;
+  const uInt32 start = myBufferIndex + position;
+
+  for (uInt32 i = 0; i < KERNEL_SIZE; ++i)
+    channel.impulses[(start + i) % BUFFER_SIZE] += delta * kernel[i];
+
+  channel.lastValue = value;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline float BlepResampler::nextOutput(Channel& channel, HighPass& highPass)
+{
+  float& impulse = channel.impulses[myBufferIndex];
+
+  channel.sum += impulse;
+  impulse = 0.F;
+
+  return highPass.apply(channel.sum);
+}
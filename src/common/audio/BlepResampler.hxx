@@ -0,0 +1,106 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef BLEP_RESAMPLER_HXX
+#define BLEP_RESAMPLER_HXX
+
+#include "bspf.hxx"
+#include "Resampler.hxx"
+#include "HighPass.hxx"
+
+/**
+  Band-limited step synthesis. The TIA output is a step function, so
+  instead of filtering every input sample (as LanczosResampler does),
+  only the changes between consecutive input samples are placed as
+  band-limited steps on the output time line. The output is the running
+  sum of these steps, high pass filtered in the same pass. The cost
+  scales with the number of transitions rather than the number of input
+  samples, and transitions keep their exact timing.
+
+  @author  Stella Team
+*/
+class BlepResampler : public Resampler
+{
+  public:
+    BlepResampler(
+      Resampler::Format formatFrom,
+      Resampler::Format formatTo,
+      const Resampler::NextFragmentCallback& nextFragmentCallback
+    );
+
+    void fillFragment(float* fragment, uInt32 length) override;
+
+  public:
+    // Taps of the band-limited impulse
+    static constexpr uInt32 KERNEL_SIZE = 16;
+
+    // Number of precomputed fractional positions of a step
+    static constexpr uInt32 KERNEL_PHASES = 64;
+
+    // Ring buffer for the pending impulses, holds at least two kernels
+    static constexpr uInt32 BUFFER_SIZE = 64;
+
+  private:
+    // Transitions and their band-limited impulses for one channel
+    struct Channel {
+      std::array<float, BUFFER_SIZE> impulses{};
+      float lastValue{0.F};
+      float sum{0.F};
+    };
+
+  private:
+    void precomputeKernels();
+
+    /**
+      Place the next input sample on the time line and advance to the
+      next one.
+    */
+    void feedSample();
+
+    void addStep(Channel& channel, float value, uInt32 position, uInt32 phase);
+
+    float nextOutput(Channel& channel, HighPass& highPass);
+
+  private:
+    std::array<float, KERNEL_PHASES * KERNEL_SIZE> myKernels;
+
+    Channel myChannelL;
+    Channel myChannelR;
+
+    HighPass myHighPassL;
+    HighPass myHighPassR;
+
+    // Index of the impulses that contribute to the next output sample
+    uInt32 myBufferIndex{0};
+
+    // Time of the next input sample relative to the next output sample,
+    // in units of 1 / (TIME_SUBDIVISION * formatFrom.sampleRate * formatTo.sampleRate)
+    uInt64 myTimeIndex{0};
+
+    Int16* myCurrentFragment{nullptr};
+    uInt32 myFragmentIndex{0};
+    bool myIsUnderrun{true};
+
+  private:
+    BlepResampler() = delete;
+    BlepResampler(const BlepResampler&) = delete;
+    BlepResampler(BlepResampler&&) = delete;
+    BlepResampler& operator=(const BlepResampler&) = delete;
+    BlepResampler& operator=(BlepResampler&&) = delete;
+};
+
+#endif // BLEP_RESAMPLER_HXX
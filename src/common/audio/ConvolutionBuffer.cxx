@@ -19,27 +19,33 @@
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 ConvolutionBuffer::ConvolutionBuffer(uInt32 size)
-  : myData{make_unique<float[]>(size)},
+  : myData{make_unique<float[]>(size + paddedSize(size))},
     mySize{size}
 {
-  std::fill_n(myData.get(), mySize, 0.F);
+  std::fill_n(myData.get(), mySize + paddedSize(mySize), 0.F);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void ConvolutionBuffer::shift(float nextValue)
 {
-  myData[myFirstIndex] = nextValue;
-  myFirstIndex = (myFirstIndex + 1) % mySize;
+  myData[myFirstIndex] = myData[myFirstIndex + mySize] = nextValue;
+  if (++myFirstIndex == mySize) myFirstIndex = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-float ConvolutionBuffer::convoluteWith(float* kernel) const
+float ConvolutionBuffer::convoluteWith(const float* kernel) const
 {
-  float result = 0.F;
+  const float* data = myData.get() + myFirstIndex;
+  const uInt32 size = paddedSize(mySize);
 
-  for (uInt32 i = 0; i < mySize; ++i) {
-    result += kernel[i] * myData[(myFirstIndex + i) % mySize];
-  }
+  // Independent partial sums, one per lane; the padding beyond mySize is
+  // multiplied by zero kernel values
+  static_assert(LANES == 4, "reduction below assumes four lanes");
+  float sum[LANES] = { 0.F };
 
-  return result;
+  for (uInt32 i = 0; i < size; i += LANES)
+    for (uInt32 lane = 0; lane < LANES; ++lane)
+      sum[lane] += kernel[i + lane] * data[i + lane];
+
+  return (sum[0] + sum[1]) + (sum[2] + sum[3]);
 }
@@ -20,18 +20,41 @@
 
 #include "bspf.hxx"
 
+/**
+  A sliding window over the last 'size' samples that can be convoluted with
+  a kernel.
+
+  The samples are stored twice in a row, so the window always occupies a
+  contiguous range of memory, and the dot product runs over blocks of
+  LANES values. This lets the compiler map the convolution to SSE / NEON
+  without any platform specific code. Kernels passed to 'convoluteWith'
+  must therefore be 'paddedSize(size)' values long, with the values beyond
+  'size' set to zero.
+*/
 class ConvolutionBuffer
 {
+  public:
+
+    static constexpr uInt32 LANES = 4;
+
   public:
 
     explicit ConvolutionBuffer(uInt32 size);
 
     void shift(float nextValue);
 
-    float convoluteWith(float* kernel) const;
+    float convoluteWith(const float* kernel) const;
+
+    /**
+      The kernel size rounded up to a multiple of LANES.
+     */
+    static constexpr uInt32 paddedSize(uInt32 size) {
+      return (size + LANES - 1) / LANES * LANES;
+    }
 
   private:
 
+    // Two copies of the window plus padding, see above
     unique_ptr<float[]> myData;
 
     uInt32 myFirstIndex{0};
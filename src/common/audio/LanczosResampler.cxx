@@ -23,6 +23,9 @@ namespace {
 
   constexpr float CLIPPING_FACTOR = 0.75;
   constexpr float HIGH_PASS_CUT_OFF = 10;
+  // Minimum number of kernel phases; with dynamic rate control the phase is
+  // rounded to the nearest precomputed one
+  constexpr uInt32 MIN_KERNEL_COUNT = 512;
 
   uInt32 reducedDenominator(uInt32 n, uInt32 d)
   {
@@ -37,6 +40,14 @@ namespace {
     return d;
   }
 
+  uInt32 kernelCount(uInt32 sampleRateFrom, uInt32 sampleRateTo)
+  {
+    const uInt32 count = reducedDenominator(sampleRateFrom, sampleRateTo);
+
+    // Stay a multiple of the exact count, so nominal phases hit precomputed kernels
+    return count * ((MIN_KERNEL_COUNT + count - 1) / count);
+  }
+
   float sinc(float x)
   {
     // We calculate the sinc with double precision in order to compensate for precision loss
@@ -68,15 +79,21 @@ LanczosResampler::LanczosResampler(
   //
   // formatFrom.sampleRate / formatTo.sampleRate = M / N
   //
-  // -> we find N from fully reducing the fraction.
-  myPrecomputedKernelCount{reducedDenominator(formatFrom.sampleRate, formatTo.sampleRate)},
+  // -> we find N from fully reducing the fraction. As dynamic rate control shifts
+  // the phases slightly, N is then raised to a multiple that provides at least
+  // MIN_KERNEL_COUNT evenly spaced phases.
+  myPrecomputedKernelCount{kernelCount(formatFrom.sampleRate, formatTo.sampleRate)},
   myKernelSize{2 * kernelParameter},
+  myKernelStride{ConvolutionBuffer::paddedSize(myKernelSize)},
   myKernelParameter{kernelParameter},
   myHighPassL{HIGH_PASS_CUT_OFF, float(formatFrom.sampleRate)},
   myHighPassR{HIGH_PASS_CUT_OFF, float(formatFrom.sampleRate)},
   myHighPass{HIGH_PASS_CUT_OFF, float(formatFrom.sampleRate)}
 {
-  myPrecomputedKernels = make_unique<float[]>(myPrecomputedKernelCount * myKernelSize);
+  // Each kernel is padded with zeroes to a multiple of the convolution
+  // buffer's block size
+  myPrecomputedKernels = make_unique<float[]>(myPrecomputedKernelCount * myKernelStride);
+  std::fill_n(myPrecomputedKernels.get(), myPrecomputedKernelCount * myKernelStride, 0.F);
 
   if (myFormatFrom.stereo)
   {
@@ -92,33 +109,20 @@ LanczosResampler::LanczosResampler(
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void LanczosResampler::precomputeKernels()
 {
-  // timeIndex = time * formatFrom.sampleRate * formatTo.sampleRAte
-  uInt32 timeIndex = 0;
-
   for (uInt32 i = 0; i < myPrecomputedKernelCount; ++i) {
-    float* kernel = myPrecomputedKernels.get() + myKernelSize * i;
-    // The kernel is normalized such to be evaluate on time * formatFrom.sampleRate
+    float* kernel = myPrecomputedKernels.get() + myKernelStride * i;
+    // The kernel is normalized such to be evaluate on time * formatFrom.sampleRate.
+    // By construction, we limit the argument during kernel evaluation to 0 .. 1, which
+    // corresponds to 0 .. 1 / formatFrom.sampleRate for time; kernel i handles the
+    // phase i / myPrecomputedKernelCount.
     float center =
-      static_cast<float>(timeIndex) / static_cast<float>(myFormatTo.sampleRate);
+      static_cast<float>(i) / static_cast<float>(myPrecomputedKernelCount);
 
     for (uInt32 j = 0; j < 2 * myKernelParameter; ++j) {
       kernel[j] = lanczosKernel(
           center - static_cast<float>(j) + static_cast<float>(myKernelParameter) - 1.F, myKernelParameter
         ) * CLIPPING_FACTOR;
     }
-
-    // Next step: time += 1 / formatTo.sampleRate
-    //
-    // By construction, we limit the argument during kernel evaluation to 0 .. 1, which
-    // corresponds to 0 .. 1 / formatFrom.sampleRate for time. To implement this, we decompose
-    // time as follows:
-    //
-    // time = N / formatFrom.sampleRate + delta
-    // timeIndex = N * formatTo.sampleRate + delta * formatTo.sampleRate * formatFrom.sampleRate
-    //
-    // with N integral and delta < 0. From this, it follows that we replace
-    // time with delta, i.e. take the modulus of timeIndex.
-    timeIndex = (timeIndex + myFormatFrom.sampleRate) % myFormatTo.sampleRate;
   }
 }
 
@@ -142,9 +146,13 @@ void LanczosResampler::fillFragment(float* fragment, uInt32 length)
 
   const uInt32 outputSamples = myFormatTo.stereo ? (length >> 1) : length;
 
+  const uInt64 timeStep = this->timeStep(), samplePeriod = this->samplePeriod();
+
+  // myTimeIndex = time * myFormatTo.sampleRate * TIME_SUBDIVISION, with time modulo
+  // 1 / myFormatFrom.sampleRate
   for (uInt32 i = 0; i < outputSamples; ++i) {
-    float* kernel = myPrecomputedKernels.get() + (myCurrentKernelIndex * myKernelSize);
-    myCurrentKernelIndex = (myCurrentKernelIndex + 1) % myPrecomputedKernelCount;
+    const uInt64 kernelIndex = myTimeIndex * myPrecomputedKernelCount / samplePeriod;
+    const float* kernel = myPrecomputedKernels.get() + (kernelIndex * myKernelStride);
 
     if (myFormatFrom.stereo) {
       float sampleL = myBufferL->convoluteWith(kernel);
@@ -165,12 +173,12 @@ void LanczosResampler::fillFragment(float* fragment, uInt32 length)
         fragment[i] = sample;
     }
 
-    myTimeIndex += myFormatFrom.sampleRate;
+    myTimeIndex += timeStep;
 
-    uInt32 samplesToShift = myTimeIndex / myFormatTo.sampleRate;
+    const uInt32 samplesToShift = static_cast<uInt32>(myTimeIndex / samplePeriod);
     if (samplesToShift == 0) continue;
 
-    myTimeIndex %= myFormatTo.sampleRate;
+    myTimeIndex %= samplePeriod;
     shiftSamples(samplesToShift);
   }
 }
@@ -180,11 +188,11 @@ inline void LanczosResampler::shiftSamples(uInt32 samplesToShift)
 {
   while (samplesToShift-- > 0) {
     if (myFormatFrom.stereo) {
-      myBufferL->shift(myHighPassL.apply(myCurrentFragment[2*myFragmentIndex] / static_cast<float>(0x7fff)));
-      myBufferR->shift(myHighPassR.apply(myCurrentFragment[2*myFragmentIndex + 1] / static_cast<float>(0x7fff)));
+      myBufferL->shift(myHighPassL.apply(toFloat(myCurrentFragment[2*myFragmentIndex])));
+      myBufferR->shift(myHighPassR.apply(toFloat(myCurrentFragment[2*myFragmentIndex + 1])));
     }
     else
-      myBuffer->shift(myHighPass.apply(myCurrentFragment[myFragmentIndex] / static_cast<float>(0x7fff)));
+      myBuffer->shift(myHighPass.apply(toFloat(myCurrentFragment[myFragmentIndex])));
 
     ++myFragmentIndex;
 
@@ -196,7 +204,6 @@ inline void LanczosResampler::shiftSamples(uInt32 samplesToShift)
         myCurrentFragment = nextFragment;
         myIsUnderrun = false;
       } else {
-        myUnderrunLogger.log();
         myIsUnderrun = true;
       }
     }
@@ -45,7 +45,7 @@ class LanczosResampler : public Resampler
 
     uInt32 myPrecomputedKernelCount{0};
     uInt32 myKernelSize{0};
-    uInt32 myCurrentKernelIndex{0};
+    uInt32 myKernelStride{0};
     unique_ptr<float[]> myPrecomputedKernels;
 
     uInt32 myKernelParameter{0};
@@ -62,7 +62,7 @@ class LanczosResampler : public Resampler
     HighPass myHighPassR;
     HighPass myHighPass;
 
-    uInt32 myTimeIndex{0};
+    uInt64 myTimeIndex{0};
 };
 
 #endif // LANCZOS_RESAMPLER_HXX
@@ -18,10 +18,10 @@
 #ifndef RESAMPLER_HXX
 #define RESAMPLER_HXX
 
+#include <cmath>
 #include <functional>
 
 #include "bspf.hxx"
-#include "StaggeredLogger.hxx"
 
 class Resampler {
   public:
@@ -54,13 +54,40 @@ class Resampler {
               const NextFragmentCallback& nextFragmentCallback)
       : myFormatFrom{formatFrom},
         myFormatTo{formatTo},
-        myNextFragmentCallback{nextFragmentCallback},
-        myUnderrunLogger{"audio buffer underrun", Logger::Level::INFO} { }
+        myNextFragmentCallback{nextFragmentCallback} { }
 
     virtual void fillFragment(float* fragment, uInt32 length) = 0;
 
+    /**
+      Scale the rate at which input samples are consumed. A factor slightly above
+      1 drains the input faster (at a slightly raised pitch), a factor below 1
+      drains it slower. This is used for dynamic rate control.
+     */
+    void setRateAdjustment(double adjustment) { myRateAdjustment = adjustment; }
+
     virtual ~Resampler() = default;
 
+  protected:
+
+    // Time is measured in fractions of 1 / (TIME_SUBDIVISION * myFormatTo.sampleRate)
+    static constexpr uInt64 TIME_SUBDIVISION = 1024;
+
+    // The time that passes per output sample
+    uInt64 timeStep() const {
+      return static_cast<uInt64>(
+        std::round(myFormatFrom.sampleRate * TIME_SUBDIVISION * myRateAdjustment));
+    }
+
+    // The time that passes per input sample
+    uInt64 samplePeriod() const {
+      return myFormatTo.sampleRate * TIME_SUBDIVISION;
+    }
+
+    // Convert an input sample to the [-1, 1] range of the output
+    static float toFloat(Int16 sample) {
+      return static_cast<float>(sample) * (1.F / static_cast<float>(0x7fff));
+    }
+
   protected:
 
     Format myFormatFrom;
@@ -68,7 +95,7 @@ class Resampler {
 
     NextFragmentCallback myNextFragmentCallback;
 
-    StaggeredLogger myUnderrunLogger;
+    double myRateAdjustment{1.};
 
   private:
 
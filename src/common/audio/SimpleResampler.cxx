@@ -45,12 +45,14 @@ void SimpleResampler::fillFragment(float* fragment, uInt32 length)
   }
 
   const uInt32 outputSamples = myFormatTo.stereo ? (length >> 1) : length;
+  const uInt64 timeStep = this->timeStep(), samplePeriod = this->samplePeriod();
 
-  // For the following math, remember that myTimeIndex = time * myFormatFrom.sampleRate * myFormatTo.sampleRate
+  // For the following math, remember that
+  // myTimeIndex = time * myFormatTo.sampleRate * TIME_SUBDIVISION
   for (uInt32 i = 0; i < outputSamples; ++i) {
     if (myFormatFrom.stereo) {
-      float sampleL = static_cast<float>(myCurrentFragment[2*myFragmentIndex]) / static_cast<float>(0x7fff);
-      float sampleR = static_cast<float>(myCurrentFragment[2*myFragmentIndex + 1]) / static_cast<float>(0x7fff);
+      float sampleL = toFloat(myCurrentFragment[2*myFragmentIndex]);
+      float sampleR = toFloat(myCurrentFragment[2*myFragmentIndex + 1]);
 
       if (myFormatTo.stereo) {
         fragment[2*i] = sampleL;
@@ -59,7 +61,7 @@ void SimpleResampler::fillFragment(float* fragment, uInt32 length)
       else
         fragment[i] = (sampleL + sampleR) / 2.F;
     } else {
-      float sample = static_cast<float>(myCurrentFragment[myFragmentIndex] / static_cast<float>(0x7fff));
+      float sample = toFloat(myCurrentFragment[myFragmentIndex]);
 
       if (myFormatTo.stereo)
         fragment[2*i] = fragment[2*i + 1] = sample;
@@ -67,14 +69,14 @@ void SimpleResampler::fillFragment(float* fragment, uInt32 length)
         fragment[i] = sample;
     }
 
-    // time += 1 / myFormatTo.sampleRate
-    myTimeIndex += myFormatFrom.sampleRate;
+    // time += 1 / myFormatTo.sampleRate (scaled by the rate adjustment)
+    myTimeIndex += timeStep;
 
     // time >= 1 / myFormatFrom.sampleRate
-    if (myTimeIndex >= myFormatTo.sampleRate) {
+    if (myTimeIndex >= samplePeriod) {
       // myFragmentIndex += time * myFormatFrom.sampleRate
-      myFragmentIndex += myTimeIndex / myFormatTo.sampleRate;
-      myTimeIndex %= myFormatTo.sampleRate;
+      myFragmentIndex += static_cast<uInt32>(myTimeIndex / samplePeriod);
+      myTimeIndex %= samplePeriod;
     }
 
     if (myFragmentIndex >= myFormatFrom.fragmentSize) {
@@ -84,7 +86,6 @@ void SimpleResampler::fillFragment(float* fragment, uInt32 length)
       if (nextFragment)
         myCurrentFragment = nextFragment;
       else {
-        myUnderrunLogger.log();
         myIsUnderrun = true;
       }
     }
@@ -1,9 +1,11 @@
 MODULE := src/common/audio
 
 MODULE_OBJS := \
+	src/common/audio/AudioBenchmark.o \
 	src/common/audio/SimpleResampler.o \
 	src/common/audio/ConvolutionBuffer.o \
 	src/common/audio/LanczosResampler.o \
+	src/common/audio/BlepResampler.o \
 	src/common/audio/HighPass.o
 
 MODULE_DIRS += \
@@ -344,10 +344,8 @@ namespace BSPF
 
   // C++11 way to get local time
   // Equivalent to the C-style localtime() function, but is thread-safe
-  inline std::tm localTime()
+  inline std::tm localTime(std::time_t currtime = std::time(nullptr))
   {
-    std::time_t currtime;
-    std::time(&currtime);
     std::tm tm_snapshot;
   #if (defined BSPF_WINDOWS || defined __WIN32__) && (!defined __GNUG__ || defined __MINGW32__)
     localtime_s(&tm_snapshot, &currtime);
@@ -346,6 +346,7 @@ NLOHMANN_JSON_SERIALIZE_ENUM(Event::Type, {
   {Event::VolumeDecrease, "VolumeDecrease"},
   {Event::VolumeIncrease, "VolumeIncrease"},
   {Event::SoundToggle, "SoundToggle"},
+  {Event::CalibrateAudio, "CalibrateAudio"},
   {Event::ToggleP0Collision, "ToggleP0Collision"},
   {Event::ToggleP0Bit, "ToggleP0Bit"},
   {Event::ToggleP1Collision, "ToggleP1Collision"},
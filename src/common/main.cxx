@@ -33,11 +33,18 @@
 #include "System.hxx"
 #include "TIASurface.hxx"
 #include "ProfilingRunner.hxx"
+#include "HeadlessRunner.hxx"
+#include "ReplayBenchmark.hxx"
+#include "MicroBenchmark.hxx"
+#include "RegisterTraceBenchmark.hxx"
+#include "audio/AudioBenchmark.hxx"
+#include "tv_filters/NTSCBenchmark.hxx"
 
 #include "ThreadDebugging.hxx"
 
 #ifdef DEBUGGER_SUPPORT
   #include "Debugger.hxx"
+  #include "CpuTrace.hxx"
 #endif
 
 #ifdef CHEATCODE_SUPPORT
@@ -74,6 +81,12 @@ void checkForCustomBaseDir(Settings::Options& options);
 */
 bool isProfilingRun(int ac, char* av[]);
 
+/**
+  Checks whether the commandline contains an argument corresponding to
+  starting a headless emulation run.
+*/
+bool isHeadlessRun(int ac, char* av[]);
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void parseCommandLine(int ac, char* av[],
     Settings::Options& globalOpts, Settings::Options& localOpts)
@@ -153,6 +166,57 @@ bool isProfilingRun(int ac, char* av[]) {
   return string(av[1]) == "-profile";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool isHeadlessRun(int ac, char* av[]) {
+  if (ac <= 1) return false;
+
+  return string(av[1]) == "-headless";
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool isAudioBenchmarkRun(int ac, char* av[]) {
+  if (ac <= 1) return false;
+
+  return string(av[1]) == "-benchaudio";
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool isNTSCBenchmarkRun(int ac, char* av[]) {
+  if (ac <= 1) return false;
+
+  return string(av[1]) == "-benchntsc";
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool isReplayBenchmarkRun(int ac, char* av[]) {
+  if (ac <= 1) return false;
+
+  return string(av[1]) == "-benchreplay";
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool isMicroBenchmarkRun(int ac, char* av[]) {
+  if (ac <= 1) return false;
+
+  return string(av[1]) == "-benchmicro";
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool isRegisterTraceRun(int ac, char* av[]) {
+  if (ac <= 1) return false;
+
+  return string(av[1]) == "-regtrace";
+}
+
+#ifdef DEBUGGER_SUPPORT
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool isTraceConversion(int ac, char* av[]) {
+  if (ac <= 2) return false;
+
+  return string(av[1]) == "-tracetotext";
+}
+#endif
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 #if defined(BSPF_MACOS)
 int stellaMain(int ac, char* av[])
@@ -178,6 +242,117 @@ int main(int ac, char* av[])
     }
   }
 
+  if (isHeadlessRun(ac, av)) {
+    try
+    {
+      HeadlessRunner runner(ac, av);
+
+      return runner.run() ? 0 : 1;
+    }
+    catch(const runtime_error& e)
+    {
+      cerr << e.what() << endl;
+      return 1;
+    }
+  }
+
+  if (isAudioBenchmarkRun(ac, av)) {
+    AudioBenchmark benchmark(ac, av);
+
+    try
+    {
+      return benchmark.run() ? 0 : 1;
+    }
+    catch(const runtime_error& e)
+    {
+      cerr << e.what() << endl;
+      return 1;
+    }
+  }
+
+  if (isNTSCBenchmarkRun(ac, av)) {
+    try
+    {
+      NTSCBenchmark benchmark(ac, av);
+
+      return benchmark.run() ? 0 : 1;
+    }
+    catch(const runtime_error& e)
+    {
+      cerr << e.what() << endl;
+      return 1;
+    }
+  }
+
+  if (isReplayBenchmarkRun(ac, av)) {
+    try
+    {
+      ReplayBenchmark benchmark(ac, av);
+
+      return benchmark.run() ? 0 : 1;
+    }
+    catch(const runtime_error& e)
+    {
+      cerr << e.what() << endl;
+      return 1;
+    }
+  }
+
+  if (isMicroBenchmarkRun(ac, av)) {
+    try
+    {
+      MicroBenchmark benchmark(ac, av);
+
+      return benchmark.run() ? 0 : 1;
+    }
+    catch(const runtime_error& e)
+    {
+      cerr << e.what() << endl;
+      return 1;
+    }
+  }
+
+  if (isRegisterTraceRun(ac, av)) {
+    try
+    {
+      RegisterTraceBenchmark benchmark(ac, av);
+
+      return benchmark.run() ? 0 : 1;
+    }
+    catch(const runtime_error& e)
+    {
+      cerr << e.what() << endl;
+      return 1;
+    }
+  }
+
+#ifdef DEBUGGER_SUPPORT
+  // Convert a trace recorded by the debugger's 'cpuTrace' command:
+  //   stella -tracetotext <trace file> [<text file>]
+  if (isTraceConversion(ac, av)) {
+    try
+    {
+      if(ac > 3)
+      {
+        std::ofstream out(av[3]);
+        if(!out)
+          throw runtime_error(string("Unable to create ") + av[3]);
+
+        CpuTrace::convertToText(av[2], out);
+      }
+      else
+        CpuTrace::convertToText(av[2], cout);
+
+      return 0;
+    }
+    catch(const runtime_error& e)
+    {
+      cerr << e.what() << endl;
+      return 1;
+    }
+  }
+#endif
+
   unique_ptr<OSystem> theOSystem;
 
   auto Cleanup = [&theOSystem]() {
@@ -188,6 +363,7 @@ int main(int ac, char* av[])
       theOSystem.reset();     // Force delete of object
     }
     MediaFactory::cleanUp();  // Finish any remaining cleanup
+    Logger::instance().flush();
 
     return 0;
   };
@@ -220,6 +396,7 @@ int main(int ac, char* av[])
   if(localOpts["listrominfo"].toBool())
   {
     Logger::debug("Showing output from 'listrominfo' ...");
+    Logger::instance().flush();
     theOSystem->propSet().print();
     return Cleanup();
   }
@@ -234,6 +411,7 @@ int main(int ac, char* av[])
   else if(localOpts["help"].toBool())
   {
     Logger::debug("Displaying usage");
+    Logger::instance().flush();  // Keep the order of the console output
     theOSystem->settings().usage();
     return Cleanup();
   }
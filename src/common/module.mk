@@ -1,13 +1,18 @@
 MODULE := src/common
 
 MODULE_OBJS := \
+	src/common/AudioCalibration.o \
 	src/common/AudioQueue.o \
 	src/common/AudioSettings.o \
 	src/common/Base.o \
+	src/common/EventCounters.o \
 	src/common/EventHandlerSDL2.o \
 	src/common/FBBackendSDL2.o \
 	src/common/FBSurfaceSDL2.o \
 	src/common/FpsMeter.o \
+	src/common/FramePacer.o \
+	src/common/FrameProfiler.o \
+	src/common/FrameStreamer.o \
 	src/common/FSNodeZIP.o \
 	src/common/HighScoresManager.o \
 	src/common/JoyMap.o \
@@ -15,26 +20,39 @@ MODULE_OBJS := \
 	src/common/Logger.o \
 	src/common/main.o \
 	src/common/MouseControl.o \
+	src/common/Netplay.o \
 	src/common/PaletteHandler.o \
+	src/common/PerfCounters.o \
 	src/common/PhosphorHandler.o \
 	src/common/PhysicalJoystick.o \
 	src/common/PJoystickHandler.o \
 	src/common/PKeyboardHandler.o \
 	src/common/PNGLibrary.o \
+	src/common/PreciseSleep.o \
 	src/common/RewindManager.o \
+	src/common/RomMetadataCache.o \
 	src/common/SoundSDL2.o \
 	src/common/StaggeredLogger.o \
+	src/common/StateFile.o \
 	src/common/StateManager.o \
+	src/common/StorageWorker.o \
+	src/common/ThreadControl.o \
 	src/common/ThreadDebugging.o \
+	src/common/ThreadPool.o \
 	src/common/TimerManager.o \
+	src/common/FrameCapture.o \
+	src/common/TraceRecorder.o \
+	src/common/UdpSocket.o \
 	src/common/VideoModeHandler.o \
 	src/common/ZipHandler.o \
 	src/common/sdl_blitter/BilinearBlitter.o \
 	src/common/sdl_blitter/QisBlitter.o \
+	src/common/sdl_blitter/SoftwareBlitter.o \
 	src/common/sdl_blitter/BlitterFactory.o \
 	src/common/repository/KeyValueRepositoryPropertyFile.o \
 	src/common/repository/KeyValueRepositoryJsonFile.o \
 	src/common/repository/KeyValueRepositoryConfigfile.o \
+	src/common/repository/KeyValueRepositoryWriteBehind.o \
 	src/common/repository/CompositeKVRJsonAdapter.o \
 	src/common/repository/CompositeKeyValueRepository.o
 
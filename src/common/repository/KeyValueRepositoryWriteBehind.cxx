@@ -0,0 +1,156 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include "repository/KeyValueRepositoryWriteBehind.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+KeyValueRepositoryWriteBehind::KeyValueRepositoryWriteBehind(
+  shared_ptr<KeyValueRepositoryAtomic> repository, TimerManager::millisec delay
+)
+  : myRepository{std::move(repository)},
+    myDelay{delay}
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+KeyValueRepositoryWriteBehind::~KeyValueRepositoryWriteBehind()
+{
+  // Wait for a running flush, then write the remaining changes
+  myTimer->clear();
+  flush();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::map<string, Variant> KeyValueRepositoryWriteBehind::load()
+{
+  std::map<string, Variant> values;
+  {
+    std::lock_guard<std::mutex> lock(myRepositoryMutex);
+    values = myRepository->load();
+  }
+
+  std::lock_guard<std::mutex> lock(myMutex);
+  for(const auto& key: myRemoved)
+    values.erase(key);
+  for(const auto& pair: mySaved)
+    values[pair.first] = pair.second;
+
+  return values;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool KeyValueRepositoryWriteBehind::has(const string& key)
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    if(mySaved.find(key) != mySaved.end()) return true;
+    if(myRemoved.find(key) != myRemoved.end()) return false;
+  }
+
+  std::lock_guard<std::mutex> lock(myRepositoryMutex);
+  return myRepository->has(key);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool KeyValueRepositoryWriteBehind::get(const string& key, Variant& value)
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    const auto it = mySaved.find(key);
+    if(it != mySaved.end())
+    {
+      value = it->second;
+      return true;
+    }
+    if(myRemoved.find(key) != myRemoved.end()) return false;
+  }
+
+  std::lock_guard<std::mutex> lock(myRepositoryMutex);
+  return myRepository->get(key, value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool KeyValueRepositoryWriteBehind::save(const std::map<string, Variant>& values)
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+
+  for(const auto& pair: values)
+  {
+    mySaved[pair.first] = pair.second;
+    myRemoved.erase(pair.first);
+  }
+  schedule();
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool KeyValueRepositoryWriteBehind::save(const string& key, const Variant& value)
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+
+  mySaved[key] = value;
+  myRemoved.erase(key);
+  schedule();
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void KeyValueRepositoryWriteBehind::remove(const string& key)
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+
+  mySaved.erase(key);
+  myRemoved.insert(key);
+  schedule();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void KeyValueRepositoryWriteBehind::flush()
+{
+  // The repository lock is taken first, so that reads don't miss changes
+  // which are no longer pending but not written yet
+  std::lock_guard<std::mutex> repositoryLock(myRepositoryMutex);
+
+  std::map<string, Variant> saved;
+  std::set<string> removed;
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    saved.swap(mySaved);
+    removed.swap(myRemoved);
+    myFlushPending = false;
+  }
+
+  for(const auto& key: removed)
+    myRepository->remove(key);
+  if(!saved.empty())
+    myRepository->save(saved);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void KeyValueRepositoryWriteBehind::schedule()
+{
+  if(!myFlushPending)
+  {
+    myFlushPending = true;
+    myTimer->setTimeout([this]() { flush(); }, myDelay);
+  }
+}
@@ -0,0 +1,97 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef KEY_VALUE_REPOSITORY_WRITE_BEHIND_HXX
+#define KEY_VALUE_REPOSITORY_WRITE_BEHIND_HXX
+
+#include <mutex>
+#include <set>
+
+#include "TimerManager.hxx"
+#include "repository/KeyValueRepository.hxx"
+
+/**
+  Collects the changes to another repository and writes them in the
+  background, shortly after the first change. Several changes to the same
+  key are written only once. Reads see the pending changes, and all of
+  them are written when the repository is destroyed.
+*/
+class KeyValueRepositoryWriteBehind : public KeyValueRepositoryAtomic
+{
+  public:
+    // Delay (in ms) between the first change and writing the changes
+    static constexpr TimerManager::millisec DEFAULT_DELAY = 500;
+
+  public:
+
+    explicit KeyValueRepositoryWriteBehind(
+      shared_ptr<KeyValueRepositoryAtomic> repository,
+      TimerManager::millisec delay = DEFAULT_DELAY
+    );
+
+    ~KeyValueRepositoryWriteBehind() override;
+
+    std::map<string, Variant> load() override;
+
+    bool has(const string& key) override;
+
+    bool get(const string& key, Variant& value) override;
+
+    bool save(const std::map<string, Variant>& values) override;
+
+    bool save(const string& key, const Variant& value) override;
+
+    void remove(const string& key) override;
+
+    /**
+      Write all pending changes now.
+    */
+    void flush();
+
+  private:
+
+    // Schedule writing the changes; you must be holding 'myMutex'
+    void schedule();
+
+  private:
+
+    shared_ptr<KeyValueRepositoryAtomic> myRepository;
+    TimerManager::millisec myDelay{DEFAULT_DELAY};
+
+    // The changes not yet written; a key is in at most one of them
+    std::map<string, Variant> mySaved;
+    std::set<string> myRemoved;
+    bool myFlushPending{false};
+
+    // Guards the pending changes
+    std::mutex myMutex;
+
+    // Serializes the access to the other repository
+    std::mutex myRepositoryMutex;
+
+    unique_ptr<TimerManager> myTimer{make_unique<TimerManager>()};
+
+  private:
+
+    KeyValueRepositoryWriteBehind(const KeyValueRepositoryWriteBehind&) = delete;
+    KeyValueRepositoryWriteBehind(KeyValueRepositoryWriteBehind&&) = delete;
+    KeyValueRepositoryWriteBehind& operator=(const KeyValueRepositoryWriteBehind&) = delete;
+    KeyValueRepositoryWriteBehind& operator=(KeyValueRepositoryWriteBehind&&) = delete;
+};
+
+#endif // KEY_VALUE_REPOSITORY_WRITE_BEHIND_HXX
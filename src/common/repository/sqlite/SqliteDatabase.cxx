@@ -71,6 +71,11 @@ void SqliteDatabase::initialize()
 
   exec("PRAGMA journal_mode=WAL");
 
+  // With WAL, commits don't have to be synced to disk to keep the database
+  // consistent; only the checkpoints are. This makes the many small writes
+  // of the settings much cheaper.
+  exec("PRAGMA synchronous=NORMAL");
+
   switch (sqlite3_wal_checkpoint_v2(myHandle, nullptr, SQLITE_CHECKPOINT_TRUNCATE, nullptr, nullptr)) {
     case SQLITE_OK:
     case SQLITE_BUSY:
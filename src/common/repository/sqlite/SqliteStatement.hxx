@@ -77,10 +77,14 @@ template<class T, class ...Ts>
 SqliteStatement::SqliteStatement(sqlite3* handle, const string& sql, T arg1, Ts... args)
   : myHandle{handle}
 {
-  char buffer[512];
-
-  if (snprintf(buffer, 512, sql.c_str(), arg1, args...) >= 512)
-    throw runtime_error("SQL statement too long");
+  // Table and column names may be long, so the buffer is sized to fit
+  const int size = snprintf(nullptr, 0, sql.c_str(), arg1, args...);
+  if (size < 0)
+    throw runtime_error("invalid SQL statement");
+
+  string buffer(size_t(size) + 1, '\0');
+  snprintf(&buffer[0], buffer.size(), sql.c_str(), arg1, args...);
+  buffer.resize(size);
 
   initialize(buffer);
 }
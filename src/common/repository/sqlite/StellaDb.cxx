@@ -64,6 +64,10 @@ void StellaDb::initialize()
     highscoreRepository->initialize();
     myHighscoreRepository = std::move(highscoreRepository);
 
+    auto romCacheRepository = make_unique<KeyValueRepositorySqlite>(*myDb, "rom_cache", "path", "metadata");
+    romCacheRepository->initialize();
+    myRomCacheRepository = std::move(romCacheRepository);
+
     myPropertyRepository = make_unique<CompositeKVRJsonAdapter>(*myPropertyRepositoryHost);
 
     if (myDb->getUserVersion() == 0) {
@@ -78,6 +82,7 @@ void StellaDb::initialize()
     mySettingsRepository = make_unique<KeyValueRepositoryNoop>();
     myPropertyRepository = make_unique<CompositeKeyValueRepositoryNoop>();
     myHighscoreRepository = make_unique<CompositeKeyValueRepositoryNoop>();
+    myRomCacheRepository = make_unique<KeyValueRepositoryNoop>();
 
     myDb.reset();
     myPropertyRepositoryHost.reset();
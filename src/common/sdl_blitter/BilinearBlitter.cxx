@@ -49,6 +49,13 @@ void BilinearBlitter::reinitialize(
     myStaticData == staticData
    );
 
+   if(srcRect.x != mySrcRect.x || srcRect.y != mySrcRect.y ||
+      srcRect.w != mySrcRect.w || srcRect.h != mySrcRect.h)
+   {
+     myDirtyRegion.setAll();
+     mySecondaryDirtyRegion.setAll();
+   }
+
    myStaticData = staticData;
    mySrcRect = srcRect;
    myAttributes = attributes;
@@ -79,21 +86,31 @@ void BilinearBlitter::free()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void BilinearBlitter::blit(SDL_Surface& surface)
+uInt32 BilinearBlitter::blit(SDL_Surface& surface, const FBSurface::DirtyRegion& dirty)
 {
   ASSERT_MAIN_THREAD;
 
   recreateTexturesIfNecessary();
 
   SDL_Texture* texture = myTexture;
+  uInt32 uploaded = 0;
 
   if(myStaticData == nullptr) {
-    SDL_UpdateTexture(myTexture, &mySrcRect, surface.pixels, surface.pitch);
+    // The textures are used alternately, so each one has to catch up on
+    // all rows changed since it was last updated
+    myDirtyRegion.add(dirty);
+    mySecondaryDirtyRegion.add(dirty);
+
+    uploaded = updateTexture(myTexture, myDirtyRegion, mySrcRect, surface);
+
     myTexture = mySecondaryTexture;
     mySecondaryTexture = texture;
+    std::swap(myDirtyRegion, mySecondaryDirtyRegion);
   }
 
   SDL_RenderCopy(myFB.renderer(), texture, &mySrcRect, &myDstRect);
+
+  return uploaded;
 }
 
 
@@ -116,6 +133,8 @@ void BilinearBlitter::recreateTexturesIfNecessary()
 
   myTexture = SDL_CreateTexture(myFB.renderer(), myFB.pixelFormat().format,
       texAccess, mySrcRect.w, mySrcRect.h);
+  myDirtyRegion.setAll();
+  mySecondaryDirtyRegion.setAll();
 
   if (myStaticData == nullptr) {
     mySecondaryTexture = SDL_CreateTexture(myFB.renderer(), myFB.pixelFormat().format,
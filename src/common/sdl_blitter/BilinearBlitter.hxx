@@ -38,13 +38,14 @@ class BilinearBlitter : public Blitter {
       SDL_Surface* staticData = nullptr
     ) override;
 
-    virtual void blit(SDL_Surface& surface) override;
+    virtual uInt32 blit(SDL_Surface& surface, const FBSurface::DirtyRegion& dirty) override;
 
   private:
     FBBackendSDL2& myFB;
 
     SDL_Texture* myTexture{nullptr};
     SDL_Texture* mySecondaryTexture{nullptr};
+    FBSurface::DirtyRegion myDirtyRegion, mySecondaryDirtyRegion;
     SDL_Rect mySrcRect{0, 0, 0, 0}, myDstRect{0, 0, 0, 0};
     FBSurface::Attributes myAttributes;
 
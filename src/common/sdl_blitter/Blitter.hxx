@@ -35,7 +35,53 @@ class Blitter {
       SDL_Surface* staticData = nullptr
     ) = 0;
 
-    virtual void blit(SDL_Surface& surface) = 0;
+    /**
+      Draw the surface, uploading the area 'dirty' that changed since the
+      last call.  Returns the number of bytes uploaded.
+    */
+    virtual uInt32 blit(SDL_Surface& surface, const FBSurface::DirtyRegion& dirty) = 0;
+
+    /**
+      Darken every second scanline of the scaled image by 'intensity'
+      percent (0 = off).  Returns false if the blitter can't do this, and
+      the scanlines have to be drawn separately.
+    */
+    virtual bool drawScanlines(uInt32 intensity) { return false; }
+
+  protected:
+
+    /**
+      Upload the out of date area of 'texture' from 'surface', and mark the
+      texture as current.  Returns the number of bytes uploaded.
+    */
+    static uInt32 updateTexture(SDL_Texture* texture, FBSurface::DirtyRegion& dirty,
+                                const SDL_Rect& srcRect, const SDL_Surface& surface)
+    {
+      const uInt32 bpp = surface.format->BytesPerPixel;
+      uInt32 uploaded = 0;
+
+      for(uInt32 i = 0; i < dirty.count; ++i)
+      {
+        const FBSurface::DirtyRegion::Rect& d = dirty.rects[i];
+        const uInt32 right = std::min(d.right, static_cast<uInt32>(srcRect.w)),
+                     bottom = std::min(d.bottom, static_cast<uInt32>(srcRect.h));
+
+        if(d.left >= right || d.top >= bottom)
+          continue;
+
+        const SDL_Rect r{srcRect.x + static_cast<int>(d.left),
+                         srcRect.y + static_cast<int>(d.top),
+                         static_cast<int>(right - d.left), static_cast<int>(bottom - d.top)};
+        SDL_UpdateTexture(texture, &r,
+            static_cast<const uInt8*>(surface.pixels) + d.top * surface.pitch + d.left * bpp,
+            surface.pitch);
+
+        uploaded += r.w * r.h * bpp;
+      }
+      dirty.clear();
+
+      return uploaded;
+    }
 
   protected:
 
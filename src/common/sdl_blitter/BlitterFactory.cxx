@@ -20,6 +20,7 @@
 #include "SDL_lib.hxx"
 #include "BilinearBlitter.hxx"
 #include "QisBlitter.hxx"
+#include "SoftwareBlitter.hxx"
 
 unique_ptr<Blitter>
 BlitterFactory::createBlitter(FBBackendSDL2& fb, ScalingAlgorithm scaling)
@@ -28,6 +29,10 @@ BlitterFactory::createBlitter(FBBackendSDL2& fb, ScalingAlgorithm scaling)
     throw runtime_error("BlitterFactory requires an initialized framebuffer!");
   }
 
+  // Software renderers can't interpolate, and scale slowly on their own
+  if (scaling != ScalingAlgorithm::nearestNeighbour && SoftwareBlitter::isSupported(fb))
+    return make_unique<SoftwareBlitter>(fb, scaling == ScalingAlgorithm::quasiInteger);
+
   switch (scaling) {
     case ScalingAlgorithm::nearestNeighbour:
       return make_unique<BilinearBlitter>(fb, false);
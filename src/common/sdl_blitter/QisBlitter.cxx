@@ -56,6 +56,13 @@ void QisBlitter::reinitialize(
     myStaticData == staticData
    );
 
+   if(srcRect.x != mySrcRect.x || srcRect.y != mySrcRect.y ||
+      srcRect.w != mySrcRect.w || srcRect.h != mySrcRect.h)
+   {
+     mySrcDirtyRegion.setAll();
+     mySecondarySrcDirtyRegion.setAll();
+   }
+
    myStaticData = staticData;
    mySrcRect = srcRect;
    myAttributes = attributes;
@@ -88,16 +95,22 @@ void QisBlitter::free()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void QisBlitter::blit(SDL_Surface& surface)
+uInt32 QisBlitter::blit(SDL_Surface& surface, const FBSurface::DirtyRegion& dirty)
 {
   ASSERT_MAIN_THREAD;
 
   recreateTexturesIfNecessary();
 
   SDL_Texture* intermediateTexture = myIntermediateTexture;
+  uInt32 uploaded = 0;
 
   if(myStaticData == nullptr) {
-    SDL_UpdateTexture(mySrcTexture, &mySrcRect, surface.pixels, surface.pitch);
+    // The source textures are used alternately, so each one has to catch
+    // up on everything changed since it was last updated
+    mySrcDirtyRegion.add(dirty);
+    mySecondarySrcDirtyRegion.add(dirty);
+
+    uploaded = updateTexture(mySrcTexture, mySrcDirtyRegion, mySrcRect, surface);
 
     blitToIntermediate();
 
@@ -107,9 +120,12 @@ void QisBlitter::blit(SDL_Surface& surface)
     SDL_Texture* temporary = mySrcTexture;
     mySrcTexture = mySecondarySrcTexture;
     mySecondarySrcTexture = temporary;
+    std::swap(mySrcDirtyRegion, mySecondarySrcDirtyRegion);
   }
 
   SDL_RenderCopy(myFB.renderer(), intermediateTexture, &myIntermediateRect, &myDstRect);
+
+  return uploaded;
 }
 
 
@@ -156,6 +172,8 @@ void QisBlitter::recreateTexturesIfNecessary()
 
   mySrcTexture = SDL_CreateTexture(myFB.renderer(), myFB.pixelFormat().format,
     texAccess, mySrcRect.w, mySrcRect.h);
+  mySrcDirtyRegion.setAll();
+  mySecondarySrcDirtyRegion.setAll();
 
   if (myStaticData == nullptr) {
     mySecondarySrcTexture = SDL_CreateTexture(myFB.renderer(), myFB.pixelFormat().format,
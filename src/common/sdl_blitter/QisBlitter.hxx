@@ -40,7 +40,7 @@ class QisBlitter : public Blitter {
       SDL_Surface* staticData = nullptr
     ) override;
 
-    virtual void blit(SDL_Surface& surface) override;
+    virtual uInt32 blit(SDL_Surface& surface, const FBSurface::DirtyRegion& dirty) override;
 
   private:
 
@@ -48,6 +48,7 @@ class QisBlitter : public Blitter {
 
     SDL_Texture* mySrcTexture{nullptr};
     SDL_Texture* mySecondarySrcTexture{nullptr};
+    FBSurface::DirtyRegion mySrcDirtyRegion, mySecondarySrcDirtyRegion;
     SDL_Texture* myIntermediateTexture{nullptr};
     SDL_Texture* mySecondaryIntermedateTexture{nullptr};
 
@@ -0,0 +1,354 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define SOFTWARE_BLITTER_SSE2
+#endif
+
+#include "FBBackendSDL2.hxx"
+#include "ThreadDebugging.hxx"
+#include "SoftwareBlitter.hxx"
+
+namespace {
+  // Mix two pixels, all four channels at once: (a * (256 - w) + b * w) / 256
+  inline uInt32 blend(uInt32 a, uInt32 b, uInt32 w)
+  {
+    const uInt32 iw = 256 - w;
+    const uInt32 rb = (((a & 0x00FF00FF) * iw + (b & 0x00FF00FF) * w) >> 8) & 0x00FF00FF;
+    const uInt32 ag = (((a >> 8) & 0x00FF00FF) * iw + ((b >> 8) & 0x00FF00FF) * w) & 0xFF00FF00;
+
+    return rb | ag;
+  }
+
+  // Mix two rows of pixels
+  void blendRows(uInt32* dst, const uInt32* a, const uInt32* b, uInt32 w, uInt32 count)
+  {
+    uInt32 i = 0;
+
+  #ifdef SOFTWARE_BLITTER_SSE2
+    // Same calculation as above, four pixels (16 channels) at once
+    const __m128i zero = _mm_setzero_si128(),
+                  wa = _mm_set1_epi16(static_cast<short>(256 - w)),
+                  wb = _mm_set1_epi16(static_cast<short>(w));
+
+    for(; i + 4 <= count; i += 4)
+    {
+      const __m128i pa = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                    pb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+      const __m128i lo = _mm_add_epi16(
+                           _mm_mullo_epi16(_mm_unpacklo_epi8(pa, zero), wa),
+                           _mm_mullo_epi16(_mm_unpacklo_epi8(pb, zero), wb)),
+                    hi = _mm_add_epi16(
+                           _mm_mullo_epi16(_mm_unpackhi_epi8(pa, zero), wa),
+                           _mm_mullo_epi16(_mm_unpackhi_epi8(pb, zero), wb));
+
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+        _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8)));
+    }
+  #endif
+
+    for(; i < count; ++i)
+      dst[i] = blend(a[i], b[i], w);
+  }
+
+  // Scale the brightness of a row of pixels by b / 256
+  void darkenRow(uInt32* row, uInt32 b, uInt32 count)
+  {
+    uInt32 i = 0;
+
+  #ifdef SOFTWARE_BLITTER_SSE2
+    const __m128i zero = _mm_setzero_si128(),
+                  wb = _mm_set1_epi16(static_cast<short>(b));
+
+    for(; i + 4 <= count; i += 4)
+    {
+      const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+      const __m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(p, zero), wb),
+                    hi = _mm_mullo_epi16(_mm_unpackhi_epi8(p, zero), wb);
+
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(row + i),
+        _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8)));
+    }
+  #endif
+
+    for(; i < count; ++i)
+      row[i] = blend(row[i], 0, 256 - b);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SoftwareBlitter::SoftwareBlitter(FBBackendSDL2& fb, bool quasiInteger)
+  : myFB{fb},
+    myQuasiInteger{quasiInteger}
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SoftwareBlitter::~SoftwareBlitter()
+{
+  free();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool SoftwareBlitter::isSupported(FBBackendSDL2& fb)
+{
+  if (!fb.isInitialized()) throw runtime_error("framebuffer not initialized");
+
+  return fb.isSoftwareRenderer() && fb.pixelFormat().BytesPerPixel == 4;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoftwareBlitter::reinitialize(
+  SDL_Rect srcRect,
+  SDL_Rect destRect,
+  FBSurface::Attributes attributes,
+  SDL_Surface* staticData
+)
+{
+  myRecreateTextures = myRecreateTextures || !(
+    mySrcRect.w == srcRect.w &&
+    mySrcRect.h == srcRect.h &&
+    myDstRect.w == myFB.scaleX(destRect.w) &&
+    myDstRect.h == myFB.scaleY(destRect.h) &&
+    attributes == myAttributes &&
+    myStaticData == staticData
+   );
+
+   if(srcRect.x != mySrcRect.x || srcRect.y != mySrcRect.y ||
+      srcRect.w != mySrcRect.w || srcRect.h != mySrcRect.h)
+     myDirtyRegion.setAll();
+
+   myStaticData = staticData;
+   mySrcRect = srcRect;
+   myAttributes = attributes;
+
+   myDstRect.x = myFB.scaleX(destRect.x);
+   myDstRect.y = myFB.scaleY(destRect.y);
+   myDstRect.w = myFB.scaleX(destRect.w);
+   myDstRect.h = myFB.scaleY(destRect.h);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoftwareBlitter::free()
+{
+  if (!myTexturesAreAllocated) {
+    return;
+  }
+
+  ASSERT_MAIN_THREAD;
+
+  if (myTexture) {
+    SDL_DestroyTexture(myTexture);
+    myTexture = nullptr;
+  }
+
+  myTexturesAreAllocated = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 SoftwareBlitter::blit(SDL_Surface& surface, const FBSurface::DirtyRegion& dirty)
+{
+  ASSERT_MAIN_THREAD;
+
+  recreateTexturesIfNecessary();
+
+  if (!myTexture) return 0;
+
+  uInt32 uploaded = 0;
+
+  if(myStaticData == nullptr) {
+    myDirtyRegion.add(dirty);
+
+    // Rows are scaled as a whole, so only the changed rows matter
+    uInt32 top = ~0U, bottom = 0;
+    for(uInt32 i = 0; i < myDirtyRegion.count; ++i)
+    {
+      top = std::min(top, myDirtyRegion.rects[i].top);
+      bottom = std::max(bottom, myDirtyRegion.rects[i].bottom);
+    }
+    bottom = std::min(bottom, static_cast<uInt32>(mySrcRect.h));
+    myDirtyRegion.clear();
+
+    if(top < bottom)
+      uploaded = scale(surface, top, bottom);
+  }
+
+  SDL_RenderCopy(myFB.renderer(), myTexture, nullptr, &myDstRect);
+
+  return uploaded;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool SoftwareBlitter::drawScanlines(uInt32 intensity)
+{
+  if (intensity != myScanlineIntensity) {
+    myScanlineIntensity = intensity;
+    myRecreateTextures = true;
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoftwareBlitter::calculateTaps(vector<Tap>& taps, uInt32 srcSize, uInt32 dstSize) const
+{
+  // With a factor of 1, this is plain bilinear filtering
+  const uInt32 factor = myQuasiInteger ? std::max(dstSize / srcSize, 1U) : 1;
+  const uInt32 size = srcSize * factor;
+
+  taps.resize(dstSize);
+  for(uInt32 i = 0; i < dstSize; ++i)
+  {
+    const double pos = BSPF::clamp((i + 0.5) * size / dstSize - 0.5,
+                                   0.0, static_cast<double>(size - 1));
+    const uInt32 pos0 = static_cast<uInt32>(pos),
+                 pos1 = std::min(pos0 + 1, size - 1);
+    const uInt32 weight = static_cast<uInt32>((pos - pos0) * 256 + 0.5);
+    Tap& tap = taps[i];
+
+    tap.index0 = pos0 / factor;
+    tap.index1 = pos1 / factor;
+    tap.weight = weight;
+
+    if(weight >= 256)
+      tap.index0 = tap.index1;
+    if(tap.index0 == tap.index1)
+      tap.weight = 0;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoftwareBlitter::calculateRowBrightness()
+{
+  myRowBrightness.assign(myDstRect.h, 256);
+
+  if (myScanlineIntensity == 0)
+    return;
+
+  // Same alpha as the overlay surface would use
+  const uInt32 alpha = uInt8(std::min(myScanlineIntensity, 100U) * 2.55);
+  vector<Tap> taps;
+
+  calculateTaps(taps, mySrcRect.h * 2, myDstRect.h);
+  for(size_t i = 0; i < taps.size(); ++i)
+  {
+    // Odd overlay rows are the dark ones
+    const Tap& tap = taps[i];
+    const uInt32 coverage = (tap.index0 & 1) * (256 - tap.weight) + (tap.index1 & 1) * tap.weight;
+
+    myRowBrightness[i] = 256 - (coverage * alpha + 127) / 255;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 SoftwareBlitter::scale(const SDL_Surface& surface, uInt32 top, uInt32 bottom)
+{
+  const uInt32 dstW = static_cast<uInt32>(myDstRect.w),
+               dstH = static_cast<uInt32>(myDstRect.h);
+
+  // Scale the changed rows horizontally
+  for(uInt32 y = top; y < bottom; ++y)
+  {
+    const uInt32* src = reinterpret_cast<const uInt32*>(
+      static_cast<const uInt8*>(surface.pixels) + (mySrcRect.y + y) * surface.pitch) + mySrcRect.x;
+    uInt32* dst = myScaledRows.data() + y * dstW;
+
+    for(const Tap& tap: myColumnTaps)
+      *dst++ = tap.weight ? blend(src[tap.index0], src[tap.index1], tap.weight)
+                          : src[tap.index0];
+  }
+
+  // Then mix the destination rows depending on them
+  uInt32 first = dstH, last = 0;
+  for(uInt32 y = 0; y < dstH; ++y)
+  {
+    const Tap& tap = myRowTaps[y];
+    if(tap.index1 < top || tap.index0 >= bottom)
+      continue;
+
+    const uInt32* row0 = myScaledRows.data() + tap.index0 * dstW;
+    uInt32* dst = myScaled.data() + y * dstW;
+
+    if(tap.weight)
+      blendRows(dst, row0, myScaledRows.data() + tap.index1 * dstW, tap.weight, dstW);
+    else
+      std::copy_n(row0, dstW, dst);
+
+    if(myRowBrightness[y] < 256)
+      darkenRow(dst, myRowBrightness[y], dstW);
+
+    first = std::min(first, y);
+    last = y;
+  }
+
+  if(first > last)
+    return 0;
+
+  const SDL_Rect r{0, static_cast<int>(first), myDstRect.w, static_cast<int>(last - first + 1)};
+  SDL_UpdateTexture(myTexture, &r, myScaled.data() + first * dstW, dstW * 4);
+
+  return r.w * r.h * 4;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoftwareBlitter::recreateTexturesIfNecessary()
+{
+  if (myTexturesAreAllocated && !myRecreateTextures) {
+    return;
+  }
+
+  ASSERT_MAIN_THREAD;
+
+  if (myTexturesAreAllocated) {
+    free();
+  }
+
+  myRecreateTextures = false;
+  myTexturesAreAllocated = true;
+
+  if (mySrcRect.w <= 0 || mySrcRect.h <= 0 || myDstRect.w <= 0 || myDstRect.h <= 0)
+    return;
+
+  calculateTaps(myColumnTaps, mySrcRect.w, myDstRect.w);
+  calculateTaps(myRowTaps, mySrcRect.h, myDstRect.h);
+  calculateRowBrightness();
+  myScaledRows.assign(size_t(mySrcRect.h) * myDstRect.w, 0);
+  myScaled.assign(size_t(myDstRect.h) * myDstRect.w, 0);
+
+  // The texture has the final size already, so the renderer doesn't scale
+  SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "0");
+
+  SDL_TextureAccess texAccess = myStaticData == nullptr ? SDL_TEXTUREACCESS_STREAMING : SDL_TEXTUREACCESS_STATIC;
+
+  myTexture = SDL_CreateTexture(myFB.renderer(), myFB.pixelFormat().format,
+      texAccess, myDstRect.w, myDstRect.h);
+  myDirtyRegion.setAll();
+
+  if (!myTexture)
+    return;
+
+  if (myStaticData != nullptr)
+    scale(*myStaticData, 0, mySrcRect.h);
+
+  if (myAttributes.blending) {
+    uInt8 blendAlpha = uInt8(myAttributes.blendalpha * 2.55);
+
+    SDL_SetTextureBlendMode(myTexture, SDL_BLENDMODE_BLEND);
+    SDL_SetTextureAlphaMod(myTexture, blendAlpha);
+  }
+}
@@ -0,0 +1,129 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef SOFTWARE_BLITTER_HXX
+#define SOFTWARE_BLITTER_HXX
+
+class FBBackendSDL2;
+
+#include "Blitter.hxx"
+#include "SDL_lib.hxx"
+
+/**
+  Blitter for renderers without GPU support (e.g. SDL's "software"
+  renderer).  These scale textures on the CPU with a generic (and slow)
+  nearest neighbour path and ignore the scale quality hint, so bilinear
+  and QIS scaling are done here instead: the surface is scaled to the
+  final size by precalculated per row/column filter taps and uploaded
+  into a texture which the renderer only has to copy.
+
+  Only 32 bit surfaces are supported.
+*/
+class SoftwareBlitter : public Blitter {
+
+  public:
+
+    SoftwareBlitter(FBBackendSDL2& fb, bool quasiInteger);
+
+    static bool isSupported(FBBackendSDL2& fb);
+
+    ~SoftwareBlitter() override;
+
+    virtual void reinitialize(
+      SDL_Rect srcRect,
+      SDL_Rect destRect,
+      FBSurface::Attributes attributes,
+      SDL_Surface* staticData = nullptr
+    ) override;
+
+    virtual uInt32 blit(SDL_Surface& surface, const FBSurface::DirtyRegion& dirty) override;
+
+    virtual bool drawScanlines(uInt32 intensity) override;
+
+  private:
+
+    // Every destination pixel is a mix of (up to) two source pixels
+    struct Tap {
+      uInt32 index0{0}, index1{0};
+      uInt32 weight{0};  // weight of index1, 0..255
+    };
+
+  private:
+
+    FBBackendSDL2& myFB;
+
+    SDL_Texture* myTexture{nullptr};
+    FBSurface::DirtyRegion myDirtyRegion;
+    SDL_Rect mySrcRect{0, 0, 0, 0}, myDstRect{0, 0, 0, 0};
+    FBSurface::Attributes myAttributes;
+
+    bool myQuasiInteger{false};
+    bool myTexturesAreAllocated{false};
+    bool myRecreateTextures{false};
+
+    SDL_Surface* myStaticData{nullptr};
+
+    // Filter taps for each destination column and row
+    vector<Tap> myColumnTaps, myRowTaps;
+
+    // Scanline intensity (percent), and the resulting brightness of each
+    // destination row (0..256, 256 = unchanged)
+    uInt32 myScanlineIntensity{0};
+    vector<uInt32> myRowBrightness;
+
+    // Source rows scaled horizontally, and the final image
+    vector<uInt32> myScaledRows, myScaled;
+
+  private:
+
+    void free();
+
+    void recreateTexturesIfNecessary();
+
+    /**
+      Calculate the filter taps for scaling 'srcSize' pixels to 'dstSize'
+      pixels.  For QIS, the source is (virtually) scaled by the largest
+      integer factor which fits first, which leaves only the pixels at the
+      source pixel borders interpolated.
+    */
+    void calculateTaps(vector<Tap>& taps, uInt32 srcSize, uInt32 dstSize) const;
+
+    /**
+      Calculate the brightness of each destination row from the scanline
+      intensity.  This mirrors a scanline overlay of twice the source
+      height, with every second row black, scaled like the source.
+    */
+    void calculateRowBrightness();
+
+    /**
+      Scale the source rows in [top, bottom) and update the texture.
+      Returns the number of bytes uploaded.
+    */
+    uInt32 scale(const SDL_Surface& surface, uInt32 top, uInt32 bottom);
+
+  private:
+
+    SoftwareBlitter(const SoftwareBlitter&) = delete;
+
+    SoftwareBlitter(SoftwareBlitter&&) = delete;
+
+    SoftwareBlitter& operator=(const SoftwareBlitter&) = delete;
+
+    SoftwareBlitter& operator=(SoftwareBlitter&&) = delete;
+};
+
+#endif // SOFTWARE_BLITTER_HXX
@@ -15,6 +15,7 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <numeric>
 #include <thread>
 #include "AtariNTSC.hxx"
 #include "PhosphorHandler.hxx"
@@ -31,10 +32,20 @@
   #endif
 #endif
 
+std::mutex AtariNTSC::ourSharedKernelsMutex;
+std::map<string, std::weak_ptr<const AtariNTSC::ColorTable>> AtariNTSC::ourSharedKernels;
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AtariNTSC::initialize(const Setup& setup)
 {
-  init(myImpl, setup);
+  // Only sharpness, resolution and bleed change the filter kernel
+  const bool filters = !myFiltersValid ||
+    setup.sharpness != mySetup.sharpness ||
+    setup.resolution != mySetup.resolution || setup.bleed != mySetup.bleed;
+
+  init(myImpl, setup, filters);
+  mySetup = setup;
+  myFiltersValid = true;
   generateKernels();
 }
 
@@ -54,29 +65,95 @@ void AtariNTSC::setPalette(const PaletteArray& palette)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AtariNTSC::generateKernels()
 {
-  const uInt8* ptr = myRGBPalette.data();
-  for(size_t entry = 0; entry < myRGBPalette.size() / 3; ++entry)
+  string key(reinterpret_cast<const char*>(&mySetup), sizeof(mySetup));
+  key.append(reinterpret_cast<const char*>(myRGBPalette.data()), myRGBPalette.size());
+
+  for(auto it = myKernelCache.begin(); it != myKernelCache.end(); ++it)
+  {
+    if(it->first == key)
+    {
+      myColorTable = it->second;
+
+      // Keep the most recently used kernels at the front
+      std::rotate(myKernelCache.begin(), it, it + 1);
+      return;
+    }
+  }
+
+  shared_ptr<const ColorTable> colorTable;
   {
-    float r = (*ptr++) / 255.F * rgb_unit + rgb_offset,
-          g = (*ptr++) / 255.F * rgb_unit + rgb_offset,
-          b = (*ptr++) / 255.F * rgb_unit + rgb_offset;
-    float y, i, q;  RGB_TO_YIQ( r, g, b, y, i, q );
+    std::lock_guard<std::mutex> lock(ourSharedKernelsMutex);
+
+    const auto it = ourSharedKernels.find(key);
+    if(it != ourSharedKernels.end())
+      colorTable = it->second.lock();
+  }
 
-    // Generate kernel
-    int ir, ig, ib;  YIQ_TO_RGB( y, i, q, myImpl.to_rgb.data(), ir, ig, ib );
-    uInt32 rgb = PACK_RGB( ir, ig, ib );
+  if(!colorTable)
+  {
+    auto generated = make_shared<ColorTable>();
 
-    uInt32* kernel = myColorTable[entry].data();
-    genKernel(myImpl, y, i, q, kernel);
+    // The kernels of the palette entries are independent of each other, so
+    // they are generated in parallel when rendering uses several threads
+    constexpr uInt32 ENTRIES_PER_TASK = 16;
+    const auto generate = [this, &generated](uInt32 task) {
+      const uInt32 first = task * ENTRIES_PER_TASK;
+      const uInt8* ptr = myRGBPalette.data() + first * 3;
 
-    for ( uInt32 c = 0; c < rgb_kernel_size / 2; ++c )
+      for(uInt32 entry = first; entry < first + ENTRIES_PER_TASK; ++entry)
+      {
+        float r = (*ptr++) / 255.F * rgb_unit + rgb_offset,
+              g = (*ptr++) / 255.F * rgb_unit + rgb_offset,
+              b = (*ptr++) / 255.F * rgb_unit + rgb_offset;
+        float y, i, q;  RGB_TO_YIQ( r, g, b, y, i, q );
+
+        // Generate kernel
+        int ir, ig, ib;  YIQ_TO_RGB( y, i, q, myImpl.to_rgb.data(), ir, ig, ib );
+        uInt32 rgb = PACK_RGB( ir, ig, ib );
+
+        uInt32* kernel = (*generated)[entry].data();
+        genKernel(myImpl, y, i, q, kernel);
+
+        for ( uInt32 c = 0; c < rgb_kernel_size / 2; ++c )
+        {
+          uInt32 error = rgb -
+              kernel [c    ] - kernel [(c+10)%14+14] -
+              kernel [c + 7] - kernel [c + 3    +14];
+          kernel [c + 3 + 14] += error;
+        }
+      }
+    };
+    constexpr uInt32 tasks = palette_size / ENTRIES_PER_TASK;
+    if(myThreadPool)
+      myThreadPool->run(tasks, generate);
+    else
+      for(uInt32 task = 0; task < tasks; ++task)
+        generate(task);
+
+    std::lock_guard<std::mutex> lock(ourSharedKernelsMutex);
+
+    // Drop the entries of kernels which are no longer in use
+    for(auto it = ourSharedKernels.begin(); it != ourSharedKernels.end(); )
+      if(it->second.expired())
+        it = ourSharedKernels.erase(it);
+      else
+        ++it;
+
+    // Another instance may have generated the same kernels meanwhile
+    auto& shared = ourSharedKernels[key];
+    colorTable = shared.lock();
+    if(!colorTable)
     {
-      uInt32 error = rgb -
-          kernel [c    ] - kernel [(c+10)%14+14] -
-          kernel [c + 7] - kernel [c + 3    +14];
-      kernel [c + 3 + 14] += error;
+      colorTable = std::move(generated);
+      shared = colorTable;
     }
   }
+
+  myColorTable = colorTable;
+
+  if(myKernelCache.size() == KERNEL_CACHE_SIZE)
+    myKernelCache.pop_back();
+  myKernelCache.emplace_front(std::move(key), std::move(colorTable));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -84,59 +161,84 @@ void AtariNTSC::enableThreading(bool enable)
 {
   uInt32 systemThreads = enable ? std::thread::hardware_concurrency() : 0;
   if(systemThreads <= 1)
-  {
-    myWorkerThreads = 0;
-    myTotalThreads  = 1;
-  }
+    setRenderThreads(1);
   else
-  {
-    systemThreads = std::max<uInt32>(1, std::min<uInt32>(4, systemThreads - 1));
+    setRenderThreads(std::max<uInt32>(1, std::min<uInt32>(4, systemThreads - 1)));
+}
 
-    myWorkerThreads = systemThreads - 1;
-    myTotalThreads  = systemThreads;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AtariNTSC::setRenderThreads(uInt32 threads)
+{
+  const uInt32 current = myThreadPool ? myThreadPool->threads() : 1;
+  if(threads == current)
+    return;
 
-    myThreads = make_unique<std::thread[]>(myWorkerThreads);  // NOLINT
-  }
+  // The pool stays alive between frames; it is only replaced here
+  myThreadPool = threads > 1 ? make_unique<Common::ThreadPool>(threads - 1) : nullptr;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AtariNTSC::render(const uInt8* atari_in, const uInt32 in_width, const uInt32 in_height,
   void* rgb_out, const uInt32 out_pitch, uInt32* rgb_in)
 {
-  // Spawn the threads...
-  for(uInt32 i = 0; i < myWorkerThreads; ++i)
-  {
-    myThreads[i] = std::thread([=] {
+  auto renderRows = [&](uInt32 yStart, uInt32 yEnd) {
     rgb_in == nullptr ?
-      renderThread(atari_in, in_width, in_height, myTotalThreads, i+1, rgb_out, out_pitch) :
-      renderWithPhosphorThread(atari_in, in_width, in_height, myTotalThreads, i+1, rgb_in, rgb_out, out_pitch);
-    });
+      renderThread(atari_in, in_width, yStart, yEnd, rgb_out, out_pitch) :
+      renderWithPhosphorThread(atari_in, in_width, yStart, yEnd, rgb_in, rgb_out, out_pitch);
+  };
+
+  if(!myThreadPool)
+  {
+    renderRows(0, in_height);
+    return;
   }
-  // Make the main thread busy too
-  rgb_in == nullptr ?
-    renderThread(atari_in, in_width, in_height, myTotalThreads, 0, rgb_out, out_pitch) :
-    renderWithPhosphorThread(atari_in, in_width, in_height, myTotalThreads, 0, rgb_in, rgb_out, out_pitch);
-  // ...and make them join again
-  for(uInt32 i = 0; i < myWorkerThreads; ++i)
-    myThreads[i].join();
-
-  // Copy phosphor values into out buffer
+
+  // Stripes start on a row whose offset into the output (and phosphor)
+  // buffer is a multiple of the cache line size, so that no two threads
+  // ever write to the same cache line
+  uInt32 alignRows = CACHE_LINE_SIZE / std::gcd(out_pitch, CACHE_LINE_SIZE);
   if(rgb_in != nullptr)
-    memcpy(rgb_out, rgb_in, in_height * out_pitch);
+    alignRows = std::lcm(alignRows,
+      CACHE_LINE_SIZE / std::gcd(outWidth(in_width) * 4, CACHE_LINE_SIZE));
+
+  const uInt32 stripes = myThreadPool->threads() * STRIPES_PER_THREAD;
+  uInt32 stripeRows = (in_height + stripes - 1) / stripes;
+  stripeRows = (stripeRows + alignRows - 1) / alignRows * alignRows;
+
+  myThreadPool->run((in_height + stripeRows - 1) / stripeRows, [&](uInt32 stripe) {
+    renderRows(stripe * stripeRows, std::min(in_height, (stripe + 1) * stripeRows));
+  });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void AtariNTSC::rgbOut4(const uInt32* k0, const uInt32* k1,
+  const uInt32* k2, const uInt32* k3, uInt32* restrict rgb_out)
+{
+  // Fixed length loops over independent lanes, which the compiler maps
+  // to SSE / NEON
+  std::array<uInt32, 4> raw;
+
+  for(uInt32 i = 0; i < 4; ++i)
+    raw[i] = k0[i] + k1[i] + k2[i] + k3[i];
+
+  for(uInt32 i = 0; i < 4; ++i)
+  {
+    ATARI_NTSC_CLAMP(raw[i], 0);
+    rgb_out[i] = (raw[i]>>5 & 0x00FF0000)|(raw[i]>>3 & 0x0000FF00)|(raw[i]>>1 & 0x000000FF);
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AtariNTSC::renderThread(const uInt8* atari_in, const uInt32 in_width,
-  const uInt32 in_height, const uInt32 numThreads, const uInt32 threadNum,
-  void* rgb_out, const uInt32 out_pitch)
+  const uInt32 yStart, const uInt32 yEnd, void* rgb_out, const uInt32 out_pitch)
 {
-  // Adapt parameters to thread number
-  const uInt32 yStart = in_height * threadNum / numThreads;
-  const uInt32 yEnd = in_height * (threadNum + 1) / numThreads;
+  // Adapt parameters to the rows rendered
   atari_in += in_width * yStart;
   rgb_out  = static_cast<char*>(rgb_out) + out_pitch * yStart;
 
   uInt32 const chunk_count = (in_width - 1) / PIXEL_in_chunk;
+  // Used by the ATARI_NTSC_* macros
+  const ColorTable& colorTable = *myColorTable;
 
   for(uInt32 y = yStart; y < yEnd; ++y)
   {
@@ -151,17 +253,14 @@ void AtariNTSC::renderThread(const uInt8* atari_in, const uInt32 in_width,
 
     for(uInt32 n = chunk_count; n; --n)
     {
-      // order of input and output pixels must not be altered
+      // order of input and output pixels must not be altered;
+      // this is ATARI_NTSC_RGB_OUT_8888 for output pixels 0 - 3 and 4 - 6
       ATARI_NTSC_COLOR_IN(0, line_in[0])
-      ATARI_NTSC_RGB_OUT_8888(0, line_out[0])
-      ATARI_NTSC_RGB_OUT_8888(1, line_out[1])
-      ATARI_NTSC_RGB_OUT_8888(2, line_out[2])
-      ATARI_NTSC_RGB_OUT_8888(3, line_out[3])
+      rgbOut4(kernel0, kernel1 + 17, kernelx0 + 7, kernelx1 + 24, line_out);
 
+      // the fourth pixel written here is overwritten by the next chunk
       ATARI_NTSC_COLOR_IN(1, line_in[1])
-      ATARI_NTSC_RGB_OUT_8888(4, line_out[4])
-      ATARI_NTSC_RGB_OUT_8888(5, line_out[5])
-      ATARI_NTSC_RGB_OUT_8888(6, line_out[6])
+      rgbOut4(kernel0 + 4, kernel1 + 14, kernelx0 + 11, kernelx1 + 21, line_out + 4);
 
       line_in += 2;
       line_out += 7;
@@ -201,18 +300,17 @@ void AtariNTSC::renderThread(const uInt8* atari_in, const uInt32 in_width,
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AtariNTSC::renderWithPhosphorThread(const uInt8* atari_in, const uInt32 in_width,
-  const uInt32 in_height, const uInt32 numThreads, const uInt32 threadNum,
-  uInt32* rgb_in, void* rgb_out, const uInt32 out_pitch)
+  const uInt32 yStart, const uInt32 yEnd, uInt32* rgb_in, void* rgb_out, const uInt32 out_pitch)
 {
-  // Adapt parameters to thread number
-  const uInt32 yStart = in_height * threadNum / numThreads;
-  const uInt32 yEnd = in_height * (threadNum + 1) / numThreads;
+  // Adapt parameters to the rows rendered
   uInt32 bufofs = AtariNTSC::outWidth(in_width) * yStart;
   uInt32* out = static_cast<uInt32*>(rgb_out);
   atari_in += in_width * yStart;
   rgb_out = static_cast<char*>(rgb_out) + out_pitch * yStart;
 
   uInt32 const chunk_count = (in_width - 1) / PIXEL_in_chunk;
+  // Used by the ATARI_NTSC_* macros
+  const ColorTable& colorTable = *myColorTable;
 
   for(uInt32 y = yStart; y < yEnd; ++y)
   {
@@ -227,17 +325,14 @@ void AtariNTSC::renderWithPhosphorThread(const uInt8* atari_in, const uInt32 in_
 
     for(uInt32 n = chunk_count; n; --n)
     {
-      // order of input and output pixels must not be altered
+      // order of input and output pixels must not be altered;
+      // this is ATARI_NTSC_RGB_OUT_8888 for output pixels 0 - 3 and 4 - 6
       ATARI_NTSC_COLOR_IN(0, line_in[0])
-      ATARI_NTSC_RGB_OUT_8888(0, line_out[0])
-      ATARI_NTSC_RGB_OUT_8888(1, line_out[1])
-      ATARI_NTSC_RGB_OUT_8888(2, line_out[2])
-      ATARI_NTSC_RGB_OUT_8888(3, line_out[3])
+      rgbOut4(kernel0, kernel1 + 17, kernelx0 + 7, kernelx1 + 24, line_out);
 
+      // the fourth pixel written here is overwritten by the next chunk
       ATARI_NTSC_COLOR_IN(1, line_in[1])
-      ATARI_NTSC_RGB_OUT_8888(4, line_out[4])
-      ATARI_NTSC_RGB_OUT_8888(5, line_out[5])
-      ATARI_NTSC_RGB_OUT_8888(6, line_out[6])
+      rgbOut4(kernel0 + 4, kernel1 + 14, kernelx0 + 11, kernelx1 + 21, line_out + 4);
 
       line_in += 2;
       line_out += 7;
@@ -270,46 +365,10 @@ void AtariNTSC::renderWithPhosphorThread(const uInt8* atari_in, const uInt32 in_
     ATARI_NTSC_RGB_OUT_8888(6, line_out[6])
 #endif
 
-    // Do phosphor mode (blend the resulting frames)
-    // Note: The unrolled code assumed that AtariNTSC::outWidth(kTIAW) == outPitch == 565
-    // Now this got changed to 568 so the final 5 calculations got removed.
-    for (uInt32 x = AtariNTSC::outWidth(in_width) / 8; x; --x)
-    {
-      // Store back into displayed frame buffer (for next frame)
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-    }
-    // finish final 565 % 8 = 5 pixels
-    /*rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-    ++bufofs;
-    rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-    ++bufofs;
-    rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-    ++bufofs;
-    rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-    ++bufofs;
-    rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-    ++bufofs;*/
-#if 0
-    rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-    ++bufofs;
-    rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-    ++bufofs;
-#endif
+    // Do phosphor mode (blend the resulting frames), and store back into
+    // the displayed frame buffer (for next frame)
+    PhosphorHandler::blend(out + bufofs, rgb_in + bufofs, out + bufofs, outWidth(in_width));
+    bufofs += outWidth(in_width);
 
     atari_in += in_width;
     rgb_out = static_cast<char*>(rgb_out) + out_pitch;
@@ -317,7 +376,7 @@ void AtariNTSC::renderWithPhosphorThread(const uInt8* atari_in, const uInt32 in_
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void AtariNTSC::init(init_t& impl, const Setup& setup)
+void AtariNTSC::init(init_t& impl, const Setup& setup, bool filters)
 {
   impl.artifacts = setup.artifacts;
   if ( impl.artifacts > 0 )
@@ -329,7 +388,8 @@ void AtariNTSC::init(init_t& impl, const Setup& setup)
     impl.fringing *= fringing_max - fringing_mid;
   impl.fringing = impl.fringing * fringing_mid + fringing_mid;
 
-  initFilters(impl, setup);
+  if(filters)
+    initFilters(impl, setup);
 
   /* setup decoder matricies */
   {
@@ -465,7 +525,7 @@ void AtariNTSC::initFilters(init_t& impl, const Setup& setup)
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // Generate pixel at all burst phases and column alignments
-void AtariNTSC::genKernel(init_t& impl, float y, float i, float q, uInt32* out)
+void AtariNTSC::genKernel(const init_t& impl, float y, float i, float q, uInt32* out)
 {
   /* generate for each scanline burst phase */
   float const* to_rgb = impl.to_rgb.data();
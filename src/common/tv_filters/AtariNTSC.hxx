@@ -41,9 +41,12 @@
 #define ATARI_NTSC_HXX
 
 #include <cmath>
-#include <thread>
+#include <deque>
+#include <map>
+#include <mutex>
 
 #include "FrameBufferConstants.hxx"
+#include "ThreadPool.hxx"
 #include "bspf.hxx"
 
 class AtariNTSC
@@ -82,6 +85,9 @@ class AtariNTSC
     // Set up threading
     void enableThreading(bool enable);
 
+    // Render with the given number of threads (including the caller)
+    void setRenderThreads(uInt32 threads);
+
     // Filters one or more rows of pixels. Input pixels are 8-bit Atari
     // palette colors.
     //  In_row_width is the number of pixels to get to the next input row.
@@ -97,16 +103,28 @@ class AtariNTSC
     }
 
   private:
-    // Generate kernels from raw RGB palette
+    // Generate kernels from raw RGB palette, or reuse the ones generated
+    // before for the same setup and palette (by this or any other instance)
     void generateKernels();
 
-    // Threaded rendering
+    // Generate four consecutive output pixels (ATARI_NTSC_RGB_OUT_8888);
+    // each pixel sums one entry from each kernel, advancing by one entry
+    // per pixel. Four pixels are always written, even where only three
+    // are needed.
+    static void rgbOut4(const uInt32* k0, const uInt32* k1, const uInt32* k2,
+                        const uInt32* k3, uInt32* rgb_out);
+
+    // Threaded rendering of the rows yStart ... yEnd - 1
     void renderThread(const uInt8* atari_in, const uInt32 in_width,
-      const uInt32 in_height, const uInt32 numThreads, const uInt32 threadNum, void* rgb_out, const uInt32 out_pitch);
+      const uInt32 yStart, const uInt32 yEnd, void* rgb_out, const uInt32 out_pitch);
     void renderWithPhosphorThread(const uInt8* atari_in, const uInt32 in_width,
-      const uInt32 in_height, const uInt32 numThreads, const uInt32 threadNum, uInt32* rgb_in, void* rgb_out, const uInt32 out_pitch);
+      const uInt32 yStart, const uInt32 yEnd, uInt32* rgb_in, void* rgb_out, const uInt32 out_pitch);
 
   private:
+    // Each frame is split into this many stripes per thread, and the
+    // stripe boundaries are aligned to cache lines in the output
+    static constexpr uInt32 STRIPES_PER_THREAD = 4, CACHE_LINE_SIZE = 64;
+
     static constexpr Int32
       PIXEL_in_chunk  = 2,   // number of input pixels read per chunk
       PIXEL_out_chunk = 7,   // number of output pixels generated per chunk
@@ -145,13 +163,31 @@ class AtariNTSC
       luma_cutoff   = 0.20F
     ;
 
+    using ColorTable = BSPF::array2D<uInt32, palette_size, entry_size>;
+
     std::array<uInt8, palette_size*3> myRGBPalette;
-    BSPF::array2D<uInt32, palette_size, entry_size> myColorTable;
+    // The kernels are immutable once generated, and shared by all instances
+    // using the same setup and palette; blank until the first generation
+    shared_ptr<const ColorTable> myColorTable{make_shared<const ColorTable>()};
+
+    // The setup the kernels were generated with
+    Setup mySetup;
+
+    // Indicates that the filter kernel in 'myImpl' matches 'mySetup'
+    bool myFiltersValid{false};
+
+    // The most recently used kernels, keyed by setup and palette, are kept
+    // alive, so that switching between ROMs or presets doesn't generate them
+    // again
+    static constexpr size_t KERNEL_CACHE_SIZE = 8;
+    std::deque<std::pair<string, shared_ptr<const ColorTable>>> myKernelCache;
+
+    // All kernels in use by any instance in the process, by the same key
+    static std::mutex ourSharedKernelsMutex;
+    static std::map<string, std::weak_ptr<const ColorTable>> ourSharedKernels;
 
-    // Rendering threads
-    unique_ptr<std::thread[]> myThreads;  // NOLINT
-    // Number of rendering and total threads
-    uInt32 myWorkerThreads{0}, myTotalThreads{0};
+    // Rendering threads; none when rendering single threaded
+    unique_ptr<Common::ThreadPool> myThreadPool;
 
     struct init_t
     {
@@ -177,18 +213,21 @@ class AtariNTSC
 
     static const std::array<float, 6> default_decoder;
 
-    void init(init_t& impl, const Setup& setup);
+    // Initialize the decoder; the filter kernel is only calculated when
+    // 'filters' is set, since adjusting artifacts or fringing doesn't
+    // change it
+    void init(init_t& impl, const Setup& setup, bool filters = true);
     void initFilters(init_t& impl, const Setup& setup);
     // Generate pixel at all burst phases and column alignments
-    void genKernel(init_t& impl, float y, float i, float q, uInt32* out);
+    void genKernel(const init_t& impl, float y, float i, float q, uInt32* out);
 
     // Begins outputting row and starts two pixels. First pixel will be cut
     // off a bit.  Use atari_ntsc_black for unused pixels.
     #define ATARI_NTSC_BEGIN_ROW( pixel0, pixel1 ) \
       unsigned const atari_ntsc_pixel0_ = (pixel0);\
-      uInt32 const* kernel0  = myColorTable[atari_ntsc_pixel0_].data();\
+      uInt32 const* kernel0  = colorTable[atari_ntsc_pixel0_].data();\
       unsigned const atari_ntsc_pixel1_ = (pixel1);\
-      uInt32 const* kernel1  = myColorTable[atari_ntsc_pixel1_].data();\
+      uInt32 const* kernel1  = colorTable[atari_ntsc_pixel1_].data();\
       uInt32 const* kernelx0;\
       uInt32 const* kernelx1 = kernel0
 
@@ -196,7 +235,7 @@ class AtariNTSC
     #define ATARI_NTSC_COLOR_IN( index, color ) {\
       uintptr_t color_;\
       kernelx##index = kernel##index;\
-      kernel##index = (color_ = (color), myColorTable[color_].data());\
+      kernel##index = (color_ = (color), colorTable[color_].data());\
     }
 
     // Generates output in the specified 32-bit format.
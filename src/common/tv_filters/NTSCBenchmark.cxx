@@ -0,0 +1,208 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <chrono>
+#include <thread>
+
+#include "NTSCBenchmark.hxx"
+#include "FSNode.hxx"
+#include "HeadlessConsole.hxx"
+#include "Logger.hxx"
+#include "PhosphorHandler.hxx"
+#include "json_lib.hxx"
+
+using namespace std::chrono;
+using json = nlohmann::json;
+
+namespace {
+  // Every captured frame is rendered this many times per thread count
+  constexpr uInt32 PASSES = 5;
+
+  constexpr uInt32 CACHE_LINE_SIZE = 64;
+
+  // Align a buffer to a cache line, as a display surface would be
+  uInt32* allocateAligned(vector<uInt32>& buffer, size_t size)
+  {
+    buffer.assign(size + CACHE_LINE_SIZE / sizeof(uInt32), 0);
+
+    void* ptr = buffer.data();
+    size_t space = buffer.size() * sizeof(uInt32);
+
+    return static_cast<uInt32*>(std::align(CACHE_LINE_SIZE, size * sizeof(uInt32), ptr, space));
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+NTSCBenchmark::NTSCBenchmark(int argc, char* argv[])
+{
+  for (int i = 2; i < argc; i++) {
+    string arg = argv[i];
+
+    if (arg == "-json")
+      myJsonOutput = true;
+    else if (arg == "-phosphor")
+      myPhosphor = true;
+    else if (arg == "-frames" && i + 1 < argc)
+      myFrameCount = std::max(BSPF::stringToInt(argv[++i]), 1);
+    else if (arg == "-threads" && i + 1 < argc) {
+      std::istringstream buf(argv[++i]);
+      string item;
+
+      myThreads.clear();
+      while (std::getline(buf, item, ',')) {
+        int threads = BSPF::stringToInt(item);
+        if (threads > 0) myThreads.push_back(threads);
+      }
+    }
+    else if (arg == "-preset" && i + 1 < argc) {
+      myPresetName = argv[++i];
+
+      if (myPresetName == "composite")   mySetup = &AtariNTSC::TV_Composite;
+      else if (myPresetName == "svideo") mySetup = &AtariNTSC::TV_SVideo;
+      else if (myPresetName == "rgb")    mySetup = &AtariNTSC::TV_RGB;
+      else if (myPresetName == "bad")    mySetup = &AtariNTSC::TV_Bad;
+      else throw runtime_error("invalid preset '" + myPresetName + "'");
+    }
+    else
+      myRomFile = arg;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool NTSCBenchmark::run()
+{
+  if (myRomFile.empty()) throw runtime_error("no ROM given");
+  if (myThreads.empty()) throw runtime_error("no thread counts given");
+
+  Logger::instance().setLogParameters(Logger::Level::ERR, false);
+
+  if (!myJsonOutput)
+    cout << "capturing " << myFrameCount << " frames from " << myRomFile << "..." << endl;
+
+  capture();
+
+  // Any palette will do, the filter cost does not depend on it
+  PaletteArray palette;
+  for (uInt32 i = 0; i < palette.size(); ++i)
+    palette[i] = ((i * 0x1f) & 0xff) << 16 | ((i * 0x3b) & 0xff) << 8 | (i & 0xff);
+
+  AtariNTSC ntsc;
+  ntsc.initialize(*mySetup);
+  ntsc.setPalette(palette);
+
+  PhosphorHandler phosphor;
+  phosphor.initialize(myPhosphor, 50);
+
+  const size_t outputSize = size_t(AtariNTSC::outWidth(myWidth)) * myHeight;
+  myOutput = allocateAligned(myOutputBuffer, outputSize);
+  myPrevious = allocateAligned(myPhosphorBuffer, outputSize);
+
+  vector<Result> results;
+  for (uInt32 threads : myThreads)
+    results.push_back(measure(ntsc, threads));
+
+  const double base = results.front().realtime / results.front().frames;
+
+  if (!myJsonOutput) {
+    cout << myWidth << "x" << myHeight << " input, preset " << myPresetName
+         << (myPhosphor ? " with phosphor" : "") << ", "
+         << std::thread::hardware_concurrency() << " hardware threads" << endl;
+
+    for (const auto& result : results) {
+      const double frameTime = result.realtime / result.frames;
+
+      cout << std::setw(2) << result.threads << " thread(s): " << std::fixed
+           << std::setprecision(3) << 1000 * frameTime << " ms/frame, "
+           << std::setprecision(2) << base / frameTime << "x" << endl;
+    }
+
+    return true;
+  }
+
+  json runs = json::array();
+  for (const auto& result : results) {
+    const double frameTime = result.realtime / result.frames;
+
+    runs.push_back({
+      {"threads", result.threads},
+      {"frames", result.frames},
+      {"wallTime", result.realtime},
+      {"frameTime", frameTime},
+      {"speedup", base / frameTime}
+    });
+  }
+
+  json report = {
+    {"rom", myRomFile},
+    {"preset", myPresetName},
+    {"phosphor", myPhosphor},
+    {"width", myWidth},
+    {"height", myHeight},
+    {"hardwareThreads", std::thread::hardware_concurrency()},
+    {"runs", runs}
+  };
+
+  cout << report.dump(2) << endl;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void NTSCBenchmark::capture()
+{
+  HeadlessConsole console{FilesystemNode(myRomFile)};
+
+  myWidth = console.tia().width();
+  myHeight = console.tia().height();
+
+  myFrames.clear();
+  while (myFrames.size() < myFrameCount) {
+    if (!console.emulateFrame())
+      throw runtime_error("emulation failed after " + std::to_string(myFrames.size()) + " frames");
+
+    const uInt8* frame = console.frameBuffer();
+    myFrames.emplace_back(frame, frame + myWidth * myHeight);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+NTSCBenchmark::Result NTSCBenchmark::measure(AtariNTSC& ntsc, uInt32 threads)
+{
+  Result result;
+  result.threads = threads;
+
+  ntsc.setRenderThreads(threads);
+
+  const uInt32 pitch = AtariNTSC::outWidth(myWidth) * sizeof(uInt32);
+  auto render = [&] (const ByteArray& frame) {
+    ntsc.render(frame.data(), myWidth, myHeight, myOutput, pitch,
+                myPhosphor ? myPrevious : nullptr);
+  };
+
+  // Warm up the threads and caches
+  for (const auto& frame : myFrames) render(frame);
+
+  time_point<high_resolution_clock> tp = high_resolution_clock::now();
+
+  for (uInt32 pass = 0; pass < PASSES; ++pass)
+    for (const auto& frame : myFrames) render(frame);
+
+  result.realtime = duration_cast<duration<double>>(high_resolution_clock::now() - tp).count();
+  result.frames = PASSES * uInt32(myFrames.size());
+
+  return result;
+}
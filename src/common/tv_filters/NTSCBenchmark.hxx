@@ -0,0 +1,93 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef NTSC_BENCHMARK_HXX
+#define NTSC_BENCHMARK_HXX
+
+#include "bspf.hxx"
+#include "AtariNTSC.hxx"
+
+/**
+  Measures the frame time of the Blargg NTSC filter for a range of render
+  thread counts.
+
+  Usage: stella -benchntsc [-json] [-phosphor] [-preset <name>]
+                           [-threads <n>,...] [-frames <n>] rom
+
+  The ROM runs headless to capture a number of frames, which are then
+  rendered through AtariNTSC over and over again, once for each thread
+  count. The preset is one of 'composite' (default), 'svideo', 'rgb' and
+  'bad'; with '-phosphor' the phosphor blending pass is included. With
+  '-json' a machine-readable report is written to stdout.
+*/
+class NTSCBenchmark
+{
+  public:
+
+    NTSCBenchmark(int argc, char* argv[]);
+
+    bool run();
+
+  private:
+
+    struct Result {
+      uInt32 threads{0};
+      uInt32 frames{0};
+      double realtime{0};
+    };
+
+  private:
+
+    /**
+      Capture frames from the ROM. Throws a runtime_error if the ROM
+      cannot be loaded or emulation fails.
+    */
+    void capture();
+
+    Result measure(AtariNTSC& ntsc, uInt32 threads);
+
+  private:
+
+    string myRomFile;
+
+    vector<uInt32> myThreads{1, 2, 3, 4};
+    uInt32 myFrameCount{60};
+    const AtariNTSC::Setup* mySetup{&AtariNTSC::TV_Composite};
+    string myPresetName{"composite"};
+
+    bool myPhosphor{false};
+    bool myJsonOutput{false};
+
+    // The captured frames (TIA palette indices)
+    uInt32 myWidth{0}, myHeight{0};
+    vector<ByteArray> myFrames;
+
+    // Output and phosphor buffer, aligned to a cache line
+    vector<uInt32> myOutputBuffer, myPhosphorBuffer;
+    uInt32* myOutput{nullptr};
+    uInt32* myPrevious{nullptr};
+
+  private:
+    // Following constructors and assignment operators not supported
+    NTSCBenchmark() = delete;
+    NTSCBenchmark(const NTSCBenchmark&) = delete;
+    NTSCBenchmark(NTSCBenchmark&&) = delete;
+    NTSCBenchmark& operator=(const NTSCBenchmark&) = delete;
+    NTSCBenchmark& operator=(NTSCBenchmark&&) = delete;
+};
+
+#endif // NTSC_BENCHMARK_HXX
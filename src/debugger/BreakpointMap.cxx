@@ -24,7 +24,9 @@ void BreakpointMap::add(const Breakpoint& breakpoint, const uInt32 flags)
   Breakpoint bp = convertBreakpoint(breakpoint);
 
   myInitialized = true;
-  myMap[bp] = flags;
+  // An equal breakpoint (e.g. for any bank) keeps its key
+  const auto it = myMap.insert_or_assign(bp, flags).first;
+  setBits(it->first);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -44,6 +46,7 @@ void BreakpointMap::erase(const Breakpoint& breakpoint)
 
     myMap.erase(bp13);
   }
+  updateBits();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -77,7 +80,7 @@ uInt32 BreakpointMap::get(uInt16 addr, uInt8 bank) const
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool BreakpointMap::check(const Breakpoint& breakpoint) const
+bool BreakpointMap::checkMap(const Breakpoint& breakpoint) const
 {
   // 16 bit breakpoint
   auto find = myMap.find(breakpoint);
@@ -91,12 +94,6 @@ bool BreakpointMap::check(const Breakpoint& breakpoint) const
   return (find != myMap.end());
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool BreakpointMap::check(const uInt16 addr, const uInt8 bank) const
-{
-  return check(Breakpoint(addr, bank));
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 BreakpointMap::BreakpointList BreakpointMap::getBreakpoints() const
 {
@@ -109,6 +106,29 @@ BreakpointMap::BreakpointList BreakpointMap::getBreakpoints() const
   return map;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BreakpointMap::setBits(const Breakpoint& breakpoint)
+{
+  if(breakpoint.bank == ANY_BANK)
+    myAnyBankBits.set(breakpoint.addr);
+  else
+  {
+    if(breakpoint.bank >= myBankBits.size())
+      myBankBits.resize(breakpoint.bank + 1);
+    myBankBits[breakpoint.bank].set(breakpoint.addr & ADDRESS_MASK);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BreakpointMap::updateBits()
+{
+  myAnyBankBits.reset();
+  myBankBits.clear();
+
+  for(const auto& item: myMap)
+    setBits(item.first);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 BreakpointMap::Breakpoint BreakpointMap::convertBreakpoint(const Breakpoint& breakpoint)
 {
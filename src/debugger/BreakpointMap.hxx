@@ -18,6 +18,7 @@
 #ifndef BREAKPOINT_HXX
 #define BREAKPOINT_HXX
 
+#include <bitset>
 #include <unordered_map>
 
 #include "bspf.hxx"
@@ -79,19 +80,38 @@ class BreakpointMap
     uInt32 get(uInt16 addr, uInt8 bank) const;
 
     /** Check if a breakpoint exists */
-    bool check(const Breakpoint& breakpoint) const;
-    bool check(const uInt16 addr, const uInt8 bank) const;
+    bool check(const Breakpoint& breakpoint) const {
+      return check(breakpoint.addr, breakpoint.bank);
+    }
+    bool check(const uInt16 addr, const uInt8 bank) const {
+      // Called for every instruction, so the bitmaps are used if possible
+      if(bank == ANY_BANK)
+        return checkMap(Breakpoint(addr, bank));
+
+      const uInt16 addr13 = addr & ADDRESS_MASK;
+      return myAnyBankBits[addr] || myAnyBankBits[addr13] ||
+             (bank < myBankBits.size() && myBankBits[bank][addr13]);
+    }
 
     /** Returns a sorted list of breakpoints */
     BreakpointList getBreakpoints() const;
 
     /** clear all breakpoints */
-    void clear() { myMap.clear(); }
+    void clear() { myMap.clear(); updateBits(); }
     size_t size() const { return myMap.size(); }
 
   private:
     Breakpoint convertBreakpoint(const Breakpoint& breakpoint);
 
+    /** Check if a breakpoint exists, using the map only */
+    bool checkMap(const Breakpoint& breakpoint) const;
+
+    /** Set the bits for the given breakpoint of the map */
+    void setBits(const Breakpoint& breakpoint);
+
+    /** Recreate the bitmaps from the map */
+    void updateBits();
+
     struct BreakpointHash {
       size_t operator()(const Breakpoint& bp) const {
         return std::hash<uInt64>()(
@@ -103,6 +123,12 @@ class BreakpointMap
     std::unordered_map<Breakpoint, uInt32, BreakpointHash> myMap;
     bool myInitialized{false};
 
+    // The addresses of all breakpoints of the map, for checking them with a
+    // single bit test: the 16 bit addresses of the breakpoints valid in any
+    // bank, and the 13 bit addresses of the others, per bank
+    std::bitset<0x10000> myAnyBankBits;
+    vector<std::bitset<ADDRESS_MASK + 1>> myBankBits;
+
     // Following constructors and assignment operators not supported
     BreakpointMap(const BreakpointMap&) = delete;
     BreakpointMap(BreakpointMap&&) = delete;
@@ -60,6 +60,7 @@ CartDebug::CartDebug(Debugger& dbg, Console& console, const OSystem& osystem)
       return BSPF::compareIgnoreCase(a, b) < 0;
   };
   mySystemAddresses = LabelToAddr(sysCmp);
+  myUserLabelAt.assign(0x10000, nullptr);
 
   // Add Zero-page RAM addresses
   for(uInt16 i = 0x80; i <= 0xFF; ++i)
@@ -97,24 +98,35 @@ CartDebug::CartDebug(Debugger& dbg, Console& console, const OSystem& osystem)
   for(uInt16 addr = 0x00; addr <= 0x0F; ++addr)
   {
     if(ourTIAMnemonicR[addr])
+    {
       mySystemAddresses.emplace(ourTIAMnemonicR[addr], addr);
+      mySystemCompletions.add(ourTIAMnemonicR[addr]);
+    }
     myReserved.TIARead[addr] = false;
   }
   for(uInt16 addr = 0x00; addr <= 0x3F; ++addr)
   {
     if(ourTIAMnemonicW[addr])
+    {
       mySystemAddresses.emplace(ourTIAMnemonicW[addr], addr);
+      mySystemCompletions.add(ourTIAMnemonicW[addr]);
+    }
     myReserved.TIAWrite[addr] = false;
   }
   for(uInt16 addr = 0x280; addr <= 0x297; ++addr)
   {
     if(ourIOMnemonic[addr-0x280])
+    {
       mySystemAddresses.emplace(ourIOMnemonic[addr-0x280], addr);
+      mySystemCompletions.add(ourIOMnemonic[addr-0x280]);
+    }
     myReserved.IOReadWrite[addr-0x280] = false;
   }
   for(uInt16 addr = 0x80; addr <= 0xFF; ++addr)
   {
     mySystemAddresses.emplace(ourZPMnemonic[addr-0x80], addr);
+    if(ourZPMnemonic[addr-0x80])
+      mySystemCompletions.add(ourZPMnemonic[addr-0x80]);
     myReserved.ZPRAM[addr-0x80] = false;
   }
 
@@ -282,6 +294,11 @@ bool CartDebug::disassemble(int bank, uInt16 PC, bool force)
                  (force || bankChanged || !pcfound || pagedirty);
   if(changed)
   {
+    // A forced disassembly may be due to changes which the cached
+    // disassemblies don't account for (e.g. the hex display format)
+    if(force)
+      myDisassemblyCache.clear();
+
     // Are we disassembling from ROM or ZP RAM?
     BankInfo& info = myBankInfo[bank];
       //(PC & 0x1000) ? myBankInfo[getBank(PC)] :
@@ -316,12 +333,12 @@ bool CartDebug::disassemble(int bank, uInt16 PC, bool force)
 
     // Always attempt to resolve code sections unless it's been
     // specifically disabled
-    bool found = fillDisassemblyList(info, PC);
+    bool found = fillDisassemblyList(bank, PC);
     if(!found && DiStella::settings.resolveCode)
     {
       // Temporarily turn off code resolution
       DiStella::settings.resolveCode = false;
-      fillDisassemblyList(info, PC);
+      fillDisassemblyList(bank, PC);
       DiStella::settings.resolveCode = true;
     }
   }
@@ -330,39 +347,125 @@ bool CartDebug::disassemble(int bank, uInt16 PC, bool force)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDebug::fillDisassemblyList(BankInfo& info, uInt16 search)
+bool CartDebug::fillDisassemblyList(int bank, uInt16 search)
 {
+  BankInfo& info = myBankInfo[bank];
+
   // An empty address list means that DiStella can't do a disassembly
   if(info.addressList.size() == 0)
     return false;
 
-  myDisassembly.list.clear();
-  myDisassembly.fieldwidth = 24 + myLabelLength;
-  DiStella distella(*this, myDisassembly.list, info, DiStella::settings,
-                    myDisLabels, myDisDirectives, myReserved);
+  // The address range DiStella will work on (see its constructor)
+  const uInt16 pc = info.addressList.front();
+  uInt16 start = 0x80, size = 0x80;  // ZP RAM
+  if(pc & 0x1000)
+  {
+    size = uInt16(info.size);
+    start = info.offset ? info.offset : pc - (pc % size);
+  }
+
+  if(myDisassemblyCache.size() != myBankInfo.size())
+    myDisassemblyCache.assign(myBankInfo.size(), DisassemblyCache());
+  DisassemblyCache& cache = myDisassemblyCache[bank];
+  const uInt64 key = disassemblyKey(info, start, size);
 
-  // Parts of the disassembly will be accessed later in different ways
-  // We place those parts in separate maps, to speed up access
-  bool found = false;
-  myAddrToLineList.clear();
-  myAddrToLineIsROM = info.offset & 0x1000;
-  for(uInt32 i = 0; i < myDisassembly.list.size(); ++i)
+  if(cache.valid && cache.key == key)
+  {
+    // Nothing has changed since the bank was last disassembled; only
+    // repeat the changes DiStella made then
+    info = cache.info;
+    myDisassembly = cache.disassembly;
+    myAddrToLineList = cache.addrToLineList;
+    myDisLabels = cache.labels;
+    myDisDirectives = cache.directives;
+    for(const auto& [addr, flags]: cache.accessFlags)
+      myDebugger.setAccessFlags(addr, flags);
+  }
+  else
   {
-    const DisassemblyTag& tag = myDisassembly.list[i];
-    const uInt16 address = tag.address & 0xFFF;
+    // Remember the access flags, to find the ones DiStella adds
+    vector<Device::AccessFlags> flags(size);
+    for(uInt16 i = 0; i < size; ++i)
+      flags[i] = myDebugger.getAccessFlags(start + i);
+
+    myDisassembly.list.clear();
+    myDisassembly.fieldwidth = 24 + myLabelLength;
+    DiStella distella(*this, myDisassembly.list, info, DiStella::settings,
+                      myDisLabels, myDisDirectives, myReserved);
 
-    // Exclude 'Device::ROW|NONE'; they don't have a valid address
-    if(tag.type != Device::ROW && tag.type != Device::NONE)
+    // Parts of the disassembly will be accessed later in different ways
+    // We place those parts in separate maps, to speed up access
+    myAddrToLineList.clear();
+    for(uInt32 i = 0; i < myDisassembly.list.size(); ++i)
     {
-      // Create a mapping from addresses to line numbers
-      myAddrToLineList.emplace(address, i);
+      const DisassemblyTag& tag = myDisassembly.list[i];
 
-      // Did we find the search value?
-      if(address == (search & 0xFFF))
-        found = true;
+      // Exclude 'Device::ROW|NONE'; they don't have a valid address
+      if(tag.type != Device::ROW && tag.type != Device::NONE)
+        // Create a mapping from addresses to line numbers
+        myAddrToLineList.emplace(tag.address & 0xFFF, i);
     }
+
+    cache.valid = true;
+    cache.key = key;
+    cache.info = info;
+    cache.disassembly = myDisassembly;
+    cache.addrToLineList = myAddrToLineList;
+    cache.labels = myDisLabels;
+    cache.directives = myDisDirectives;
+    cache.accessFlags.clear();
+    for(uInt16 i = 0; i < size; ++i)
+    {
+      const Device::AccessFlags newFlags = myDebugger.getAccessFlags(start + i);
+      if(newFlags != flags[i])
+        cache.accessFlags.emplace_back(start + i, newFlags);
+    }
+  }
+  myAddrToLineIsROM = info.offset & 0x1000;
+
+  // Did we find the search value?
+  return myAddrToLineList.find(search & 0xFFF) != myAddrToLineList.end();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 CartDebug::disassemblyKey(const BankInfo& info, uInt16 start,
+                                 uInt16 size) const
+{
+  // FNV-1a
+  uInt64 key = 0xcbf29ce484222325ULL;
+  const auto add = [&key](uInt32 value) {
+    key = (key ^ value) * 0x100000001b3ULL;
+  };
+
+  add(info.offset);
+  add(uInt32(info.size));
+  for(const auto addr: info.addressList)
+    add(addr);
+  for(const auto& tag: info.directiveList)
+  {
+    add(uInt32(tag.type));
+    add(tag.start);
+    add(tag.end);
+  }
+
+  const DiStella::Settings& settings = DiStella::settings;
+  add(uInt32(settings.gfxFormat));
+  add(settings.resolveCode | settings.showAddresses << 1 | settings.aFlag << 2 |
+      settings.fFlag << 3 | settings.rFlag << 4 | settings.bFlag << 5);
+  add(settings.bytesWidth);
+  add(myLabelLength);
+  add(uInt32(myConsole.timing()));
+
+  // The content of the bank (plus the break vector) and its access flags
+  for(uInt32 addr = start; addr < uInt32(start + size); ++addr)
+  {
+    add(myDebugger.peek(addr));
+    add(myDebugger.getAccessFlags(addr));
   }
-  return found;
+  if(settings.bFlag)
+    add(myDebugger.dpeek(0xfffe));
+
+  return key;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -578,12 +681,18 @@ bool CartDebug::addLabel(const string& label, uInt16 address)
     case AddrType::IO:
       return false;
     default:
+    {
       removeLabel(label);
       myUserAddresses.emplace(label, address);
-      myUserLabels.emplace(address, label);
+      myUserCompletions.add(label);
+      const auto [iter, added] = myUserLabels.emplace(address, label);
+      if(added)
+        myUserLabelAt[address] = &iter->second;
       myLabelLength = std::max(myLabelLength, uInt16(label.size()));
       mySystem.setDirtyPage(address);
+      myDisassemblyCache.clear();
       return true;
+    }
   }
 }
 
@@ -597,11 +706,16 @@ bool CartDebug::removeLabel(const string& label)
     // Erase the address assigned to the label
     const auto& iter2 = myUserLabels.find(iter->second);
     if(iter2 != myUserLabels.end())
+    {
+      myUserLabelAt[iter2->first] = nullptr;
       myUserLabels.erase(iter2);
+    }
 
     // Erase the label itself
     mySystem.setDirtyPage(iter->second);
+    myUserCompletions.remove(iter->first);
     myUserAddresses.erase(iter);
+    myDisassemblyCache.clear();
 
     return true;
   }
@@ -667,15 +781,14 @@ bool CartDebug::getLabel(ostream& buf, uInt16 addr, bool isRead,
     {
       // RAM can use user-defined labels; otherwise we default to
       // standard mnemonics
-      AddrToLabel::const_iterator iter;
       uInt16 a = addr & 0xFF, offset = addr & 0xFF00;
       bool found = false;
 
       // Search for nearest label
       for(uInt16 i = a; i >= 0x80; --i)
-        if((iter = myUserLabels.find(i)) != myUserLabels.end())
+        if(myUserLabelAt[i])
         {
-          buf << iter->second;
+          buf << *myUserLabelAt[i];
           if(a != i)
             buf << "+$" << Base::HEX1 << (a - i);
           found = true;
@@ -694,13 +807,11 @@ bool CartDebug::getLabel(ostream& buf, uInt16 addr, bool isRead,
       // These addresses can never be in the system labels list
       if(isRam) // cartridge RAM
       {
-        AddrToLabel::const_iterator iter;
-
         // Search for nearest label
         for(uInt16 i = addr; i >= (addr & 0xf000); --i)
-          if((iter = myUserLabels.find(i)) != myUserLabels.end())
+          if(myUserLabelAt[i])
           {
-            buf << iter->second;
+            buf << *myUserLabelAt[i];
             if(addr != i)
               buf << "+$" << Base::HEX1 << (addr - i);
             return true;
@@ -708,10 +819,9 @@ bool CartDebug::getLabel(ostream& buf, uInt16 addr, bool isRead,
       }
       else
       {
-        const auto& iter = myUserLabels.find(addr);
-        if(iter != myUserLabels.end())
+        if(myUserLabelAt[addr])
         {
-          buf << iter->second;
+          buf << *myUserLabelAt[addr];
           return true;
         }
       }
@@ -831,6 +941,9 @@ string CartDebug::loadSymbolFile()
 
   myUserAddresses.clear();
   myUserLabels.clear();
+  myUserLabelAt.assign(0x10000, nullptr);
+  myUserCompletions.clear();
+  myDisassemblyCache.clear();
 
   stringstream in;
   try
@@ -859,8 +972,8 @@ string CartDebug::loadSymbolFile()
       // For now, we simply ignore constants completely
       //const auto& iter = myUserCLabels.find(value);
       //if(iter == myUserCLabels.end() || !BSPF::equalsIgnoreCase(label, iter->second))
-      const auto& iter = myUserLabels.find(value);
-      if (iter == myUserLabels.end() || !BSPF::equalsIgnoreCase(label, iter->second))
+      const string* userLabel = myUserLabelAt[value & 0xFFFF];
+      if (!userLabel || !BSPF::equalsIgnoreCase(label, *userLabel))
       {
         // Check for period, and strip leading number
         string::size_type pos = label.find_first_of('.', 0);
@@ -1303,7 +1416,7 @@ string CartDebug::saveDisassembly(string path)
       bool stackUsed = (mySystem.getAccessFlags(addr|0x100) & (Device::DATA | Device::WRITE));
 
       if (myReserved.ZPRAM[addr - 0x80] &&
-          myUserLabels.find(addr) == myUserLabels.end()) {
+          !myUserLabelAt[addr]) {
         if (addLine)
           out << "\n";
         out << ALIGN(16) << ourZPMnemonic[addr - 0x80] << "= $"
@@ -1491,27 +1604,9 @@ string CartDebug::clearConfig(int bank)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartDebug::getCompletions(const char* in, StringList& completions) const
 {
-  // First scan system equates
-  for(uInt16 addr = 0x00; addr <= 0x0F; ++addr)
-    if(ourTIAMnemonicR[addr] && BSPF::matchesIgnoreCase(ourTIAMnemonicR[addr], in))
-      completions.push_back(ourTIAMnemonicR[addr]);
-  for(uInt16 addr = 0x00; addr <= 0x3F; ++addr)
-    if(ourTIAMnemonicW[addr] && BSPF::matchesIgnoreCase(ourTIAMnemonicW[addr], in))
-      completions.push_back(ourTIAMnemonicW[addr]);
-  for(uInt16 addr = 0; addr <= 0x297-0x280; ++addr)
-    if(ourIOMnemonic[addr] && BSPF::matchesIgnoreCase(ourIOMnemonic[addr], in))
-      completions.push_back(ourIOMnemonic[addr]);
-  for(uInt16 addr = 0; addr <= 0x7F; ++addr)
-    if(ourZPMnemonic[addr] && BSPF::matchesIgnoreCase(ourZPMnemonic[addr], in))
-      completions.push_back(ourZPMnemonic[addr]);
-
-  // Now scan user-defined labels
-  for(const auto& iter: myUserAddresses)
-  {
-    const char* l = iter.first.c_str();
-    if(BSPF::matchesCamelCase(l, in))
-      completions.push_back(l);
-  }
+  // First scan system equates, then user-defined labels
+  mySystemCompletions.getCompletions(in, completions);
+  myUserCompletions.getCompletions(in, completions);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
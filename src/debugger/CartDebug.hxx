@@ -32,6 +32,7 @@ using CartMethod = int (CartDebug::*)();
 #include "bspf.hxx"
 #include "DebuggerSystem.hxx"
 #include "Device.hxx"
+#include "CompletionTrie.hxx"
 
 class CartState : public DebuggerState
 {
@@ -318,9 +319,15 @@ class CartDebug : public DebuggerSystem
     */
     bool disassemble(int bank, uInt16 PC, bool force = false);
 
-    // Actually call DiStella to fill the DisassemblyList structure
+    // Actually call DiStella to fill the DisassemblyList structure,
+    // unless the bank's previous disassembly can be reused
     // Return whether the search address was actually in the list
-    bool fillDisassemblyList(BankInfo& bankinfo, uInt16 search);
+    bool fillDisassemblyList(int bank, uInt16 search);
+
+    // Create a fingerprint of everything DiStella depends on when
+    // disassembling the given bank (except for the labels, whose
+    // changes clear the cache instead)
+    uInt64 disassemblyKey(const BankInfo& info, uInt16 start, uInt16 size) const;
 
     // Analyze of bank of ROM, generating a list of Distella directives
     // based on its disassembly
@@ -350,12 +357,31 @@ class CartDebug : public DebuggerSystem
     std::map<uInt16, int> myAddrToLineList;
     bool myAddrToLineIsROM{true};
 
+    // The last disassembly of each bank, and the state of the bank it was
+    // created from; switching back to an unchanged bank (e.g. when stepping
+    // through a bankswitching ROM) doesn't need to run DiStella again
+    struct DisassemblyCache {
+      bool valid{false};
+      uInt64 key{0};
+      BankInfo info;
+      Disassembly disassembly;
+      std::map<uInt16, int> addrToLineList;
+      AddrTypeArray labels, directives;
+      // The access flags which DiStella added to the bank
+      vector<std::pair<uInt16, Device::AccessFlags>> accessFlags;
+    };
+    vector<DisassemblyCache> myDisassemblyCache;
+
     // Mappings from label to address (and vice versa) for items
     // defined by the user (either through a DASM symbol file or manually
     // from the commandline in the debugger)
     AddrToLabel myUserLabels;
     LabelToAddr myUserAddresses;
 
+    // The labels of myUserLabels, indexed by address (nullptr = no label),
+    // for the frequent lookups while formatting the disassembly
+    vector<const string*> myUserLabelAt;
+
     // Mappings from label to address (and vice versa) for constants
     // defined through a DASM lst file
     // AddrToLabel myUserCLabels;
@@ -368,6 +394,10 @@ class CartDebug : public DebuggerSystem
     // handled differently
     LabelToAddr mySystemAddresses;
 
+    // The labels for tab-completion
+    CompletionTrie mySystemCompletions{CompletionTrie::Match::IgnoreCase};
+    CompletionTrie myUserCompletions{CompletionTrie::Match::CamelCase};
+
     // The maximum length of all labels currently defined
     uInt16 myLabelLength{8};  // longest pre-defined label
 
@@ -0,0 +1,376 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "Debugger.hxx"
+#include "DebuggerExpressions.hxx"
+#include "CompiledExpression.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Expression::compile(CompiledExpression& code) const
+{
+  // Expressions without their own code are evaluated through the tree
+  code.emit(CompiledExpression::Op::Eval, 0, this);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CompiledExpression::CompiledExpression(Expression* expression)
+  : myExpression{expression}
+{
+  myExpression->compile(*this);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 CompiledExpression::evaluate() const
+{
+  const Instruction* code = myCode.data();
+  const size_t size = myCode.size();
+  // The top of the stack is kept in 'top', the rest below 'sp'
+  Int32* sp = myStack.data();
+  Int32 top = 0;
+
+  for(size_t pc = 0; pc < size; ++pc)
+  {
+    const Instruction& i = code[pc];
+
+    switch(i.op)
+    {
+      case Op::Const:
+        *sp++ = top;
+        top = i.value;
+        break;
+
+      case Op::Eval:
+        *sp++ = top;
+        top = i.expression->evaluate();
+        break;
+
+      case Op::CpuMethod:
+        *sp++ = top;
+        top = static_cast<const CpuMethodExpression*>(i.expression)->
+            CpuMethodExpression::evaluate();
+        break;
+
+      case Op::CartMethod:
+        *sp++ = top;
+        top = static_cast<const CartMethodExpression*>(i.expression)->
+            CartMethodExpression::evaluate();
+        break;
+
+      case Op::RiotMethod:
+        *sp++ = top;
+        top = static_cast<const RiotMethodExpression*>(i.expression)->
+            RiotMethodExpression::evaluate();
+        break;
+
+      case Op::TiaMethod:
+        *sp++ = top;
+        top = static_cast<const TiaMethodExpression*>(i.expression)->
+            TiaMethodExpression::evaluate();
+        break;
+
+      case Op::ByteDeref:
+        top = Debugger::debugger().peek(top);
+        break;
+
+      case Op::WordDeref:
+        top = Debugger::debugger().dpeekAsInt(top);
+        break;
+
+      case Op::Negate:         top = -top;               break;
+      case Op::BinNot:         top = ~top;               break;
+      case Op::LogNot:         top = !top;               break;
+      case Op::HiByte:         top = 0xff & (top >> 8);  break;
+      case Op::LoByte:         top = 0xff & top;         break;
+      case Op::Bool:           top = top != 0;           break;
+
+      case Op::Plus:           top = *--sp + top;        break;
+      case Op::Minus:          top = *--sp - top;        break;
+      case Op::Mult:           top = *--sp * top;        break;
+      case Op::BinAnd:         top = *--sp & top;        break;
+      case Op::BinOr:          top = *--sp | top;        break;
+      case Op::BinXor:         top = *--sp ^ top;        break;
+      case Op::ShiftLeft:      top = *--sp << top;       break;
+      case Op::ShiftRight:     top = *--sp >> top;       break;
+      case Op::Equals:         top = *--sp == top;       break;
+      case Op::NotEquals:      top = *--sp != top;       break;
+      case Op::Less:           top = *--sp < top;        break;
+      case Op::LessEquals:     top = *--sp <= top;       break;
+      case Op::Greater:        top = *--sp > top;        break;
+      case Op::GreaterEquals:  top = *--sp >= top;       break;
+
+      case Op::Div:
+      case Op::Mod:
+        top = apply(i.op, *--sp, top);
+        break;
+
+      case Op::PlusImm:           top += i.value;           break;
+      case Op::MinusImm:          top -= i.value;           break;
+      case Op::MultImm:           top *= i.value;           break;
+      case Op::BinAndImm:         top &= i.value;           break;
+      case Op::BinOrImm:          top |= i.value;           break;
+      case Op::BinXorImm:         top ^= i.value;           break;
+      case Op::ShiftLeftImm:      top <<= i.value;          break;
+      case Op::ShiftRightImm:     top >>= i.value;          break;
+      case Op::EqualsImm:         top = top == i.value;     break;
+      case Op::NotEqualsImm:      top = top != i.value;     break;
+      case Op::LessImm:           top = top < i.value;      break;
+      case Op::LessEqualsImm:     top = top <= i.value;     break;
+      case Op::GreaterImm:        top = top > i.value;      break;
+      case Op::GreaterEqualsImm:  top = top >= i.value;     break;
+
+      case Op::DivImm:
+        top = apply(Op::Div, top, i.value);
+        break;
+
+      case Op::ModImm:
+        top = apply(Op::Mod, top, i.value);
+        break;
+
+      case Op::JumpIfFalse:
+        if(top == 0)
+          pc = i.value - 1;  // leave 0 as the result
+        else
+          top = *--sp;
+        break;
+
+      case Op::JumpIfTrue:
+        if(top != 0)
+        {
+          top = 1;
+          pc = i.value - 1;
+        }
+        else
+          top = *--sp;
+        break;
+    }
+  }
+
+  return top;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompiledExpression::emit(Op op, Int32 value, const Expression* expression)
+{
+  myCode.push_back({op, value, expression});
+  myRequiredPC = -1;
+
+  switch(op)
+  {
+    case Op::Const:
+    case Op::Eval:
+    case Op::CpuMethod:
+    case Op::CartMethod:
+    case Op::RiotMethod:
+    case Op::TiaMethod:
+      // The stack holds all but the top entry, plus the initial one
+      ++myDepth;
+      if(myDepth > myStack.size())
+        myStack.resize(myDepth);
+      break;
+
+    case Op::ByteDeref:
+    case Op::WordDeref:
+    case Op::Negate:
+    case Op::BinNot:
+    case Op::LogNot:
+    case Op::HiByte:
+    case Op::LoByte:
+    case Op::Bool:
+      break;
+
+    default:  // binary operators and jumps consume an operand
+      if(op < Op::PlusImm || op > Op::GreaterEqualsImm)
+        --myDepth;
+      break;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompiledExpression::emitUnary(Op op, const Expression& operand)
+{
+  const size_t start = myCode.size();
+  operand.compile(*this);
+  applyUnary(op, start);
+
+  myRequiredPC = -1;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompiledExpression::emitBinary(Op op, const Expression& lhs, const Expression& rhs)
+{
+  const size_t start = myCode.size();
+  lhs.compile(*this);
+  const size_t middle = myCode.size();
+  rhs.compile(*this);
+
+  // Move a constant to the right-hand side, if the operands may be swapped
+  Op swappedOp = op;
+  if(middle == start + 1 && myCode[start].op == Op::Const &&
+     myCode.size() == middle + 1 && swapOperands(swappedOp))
+  {
+    std::swap(myCode[start], myCode[middle]);
+    op = swappedOp;
+  }
+
+  myRequiredPC = -1;
+  if(isConst(middle))
+  {
+    const Int32 value = myCode[middle].value;
+    myCode.pop_back();
+    --myDepth;
+
+    if(isConst(start))
+      myCode[start].value = apply(op, myCode[start].value, value);
+    else
+    {
+      emit(immediate(op), value);
+
+      // Remember if this is a comparison of the PC with a constant
+      if(op == Op::Equals && middle == start + 1 && isPC(myCode[start]) &&
+         value >= 0 && value <= 0xffff)
+        myRequiredPC = value;
+    }
+  }
+  else
+    emit(op);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompiledExpression::emitLogical(bool isAnd, const Expression& lhs,
+                                     const Expression& rhs)
+{
+  const size_t start = myCode.size();
+  lhs.compile(*this);
+  const Int32 lhsPC = myRequiredPC;
+
+  if(isConst(start))
+  {
+    // The result is either known already, or that of the right-hand side
+    const bool value = myCode[start].value != 0;
+    if(value != isAnd)
+    {
+      myCode[start].value = value;
+      myRequiredPC = -1;
+    }
+    else
+    {
+      myCode.pop_back();
+      --myDepth;
+      rhs.compile(*this);
+      const Int32 rhsPC = myRequiredPC;
+      applyUnary(Op::Bool, start);
+      myRequiredPC = rhsPC;
+    }
+    return;
+  }
+
+  const size_t jump = myCode.size();
+  emit(isAnd ? Op::JumpIfFalse : Op::JumpIfTrue);
+  rhs.compile(*this);
+  const Int32 rhsPC = myRequiredPC;
+  applyUnary(Op::Bool, jump + 1);
+  myCode[jump].value = Int32(myCode.size());
+
+  // A conjunction can only be true where both sides can be true, while
+  // a disjunction may be true wherever either side can be true
+  if(isAnd)
+    myRequiredPC = lhsPC >= 0 ? lhsPC : rhsPC;
+  else
+    myRequiredPC = lhsPC == rhsPC ? lhsPC : -1;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompiledExpression::applyUnary(Op op, size_t start)
+{
+  // Dereferences may not be folded, since memory changes
+  if(isConst(start) && op != Op::ByteDeref && op != Op::WordDeref)
+    myCode[start].value = apply(op, myCode[start].value);
+  else if(op != Op::Bool || !isBoolean(myCode.back().op))
+    emit(op);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CompiledExpression::isPC(const Instruction& instruction)
+{
+  return instruction.op == Op::CpuMethod &&
+    static_cast<const CpuMethodExpression*>(instruction.expression)->method() ==
+      &CpuDebug::pc;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CompiledExpression::swapOperands(Op& op)
+{
+  switch(op)
+  {
+    case Op::Plus:
+    case Op::Mult:
+    case Op::BinAnd:
+    case Op::BinOr:
+    case Op::BinXor:
+    case Op::Equals:
+    case Op::NotEquals:
+      return true;
+
+    case Op::Less:           op = Op::Greater;        return true;
+    case Op::LessEquals:     op = Op::GreaterEquals;  return true;
+    case Op::Greater:        op = Op::Less;           return true;
+    case Op::GreaterEquals:  op = Op::LessEquals;     return true;
+
+    default:
+      return false;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 CompiledExpression::apply(Op op, Int32 value)
+{
+  switch(op)
+  {
+    case Op::Negate:  return -value;
+    case Op::BinNot:  return ~value;
+    case Op::LogNot:  return !value;
+    case Op::HiByte:  return 0xff & (value >> 8);
+    case Op::LoByte:  return 0xff & value;
+    case Op::Bool:    return value != 0;
+    default:          return value;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 CompiledExpression::apply(Op op, Int32 lhs, Int32 rhs)
+{
+  switch(op)
+  {
+    case Op::Plus:          return lhs + rhs;
+    case Op::Minus:         return lhs - rhs;
+    case Op::Mult:          return lhs * rhs;
+    case Op::Div:           return rhs == 0 ? 0 : lhs / rhs;
+    case Op::Mod:           return rhs == 0 ? 0 : lhs % rhs;
+    case Op::BinAnd:        return lhs & rhs;
+    case Op::BinOr:         return lhs | rhs;
+    case Op::BinXor:        return lhs ^ rhs;
+    case Op::ShiftLeft:     return lhs << rhs;
+    case Op::ShiftRight:    return lhs >> rhs;
+    case Op::Equals:        return lhs == rhs;
+    case Op::NotEquals:     return lhs != rhs;
+    case Op::Less:          return lhs < rhs;
+    case Op::LessEquals:    return lhs <= rhs;
+    case Op::Greater:       return lhs > rhs;
+    case Op::GreaterEquals: return lhs >= rhs;
+    default:                return 0;
+  }
+}
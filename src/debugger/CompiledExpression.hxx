@@ -0,0 +1,143 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef COMPILED_EXPRESSION_HXX
+#define COMPILED_EXPRESSION_HXX
+
+#include "bspf.hxx"
+#include "Expression.hxx"
+
+/**
+  An expression tree compiled into code for a simple stack machine, which
+  is evaluated in a single loop instead of by walking the tree through
+  virtual calls.  This is used for the conditions which are checked after
+  every instruction (conditional breaks, save states and traps).
+
+  Operations on constants are folded at compile time, and the logical
+  operators skip their right-hand side like the tree does.  Leaves whose
+  value depends on state that may change after compiling (user functions
+  and equates) are still evaluated through their tree.
+
+  @author  Stella Team
+*/
+class CompiledExpression
+{
+  public:
+    enum class Op : uInt8 {
+      Const, Eval, ByteDeref, WordDeref,
+      // Call the method of a CpuMethodExpression, etc. directly
+      CpuMethod, CartMethod, RiotMethod, TiaMethod,
+      // Unary operators
+      Negate, BinNot, LogNot, HiByte, LoByte, Bool,
+      // Binary operators
+      Plus, Minus, Mult, Div, Mod, BinAnd, BinOr, BinXor,
+      ShiftLeft, ShiftRight, Equals, NotEquals,
+      Less, LessEquals, Greater, GreaterEquals,
+      // Binary operators with a constant right-hand side, in the same order
+      PlusImm, MinusImm, MultImm, DivImm, ModImm, BinAndImm, BinOrImm, BinXorImm,
+      ShiftLeftImm, ShiftRightImm, EqualsImm, NotEqualsImm,
+      LessImm, LessEqualsImm, GreaterImm, GreaterEqualsImm,
+      // Jump past the right-hand side of a logical and/or
+      JumpIfFalse, JumpIfTrue
+    };
+
+  public:
+    /**
+      Compile the given expression, and take ownership of it.
+    */
+    explicit CompiledExpression(Expression* expression);
+    CompiledExpression(CompiledExpression&&) = default;
+    CompiledExpression& operator=(CompiledExpression&&) = default;
+
+    /**
+      Evaluate the expression; the result is the same as the one of
+      Expression::evaluate().
+    */
+    Int32 evaluate() const;
+
+    /**
+      Answer the PC at which the expression can only be true (because it
+      has the form 'pc == <constant> && ...'), or -1 if there is none.
+    */
+    Int32 requiredPC() const { return myRequiredPC; }
+
+    /**
+      Methods used by Expression::compile() to generate the code.
+    */
+    void emit(Op op, Int32 value = 0, const Expression* expression = nullptr);
+    void emitUnary(Op op, const Expression& operand);
+    void emitBinary(Op op, const Expression& lhs, const Expression& rhs);
+    void emitLogical(bool isAnd, const Expression& lhs, const Expression& rhs);
+
+  private:
+    struct Instruction {
+      Op op{Op::Const};
+      Int32 value{0};  // The constant, or the target of a jump
+      const Expression* expression{nullptr};  // Evaluated by Op::Eval etc.
+    };
+
+    // Answer whether the code starting at 'start' is a single constant
+    bool isConst(size_t start) const {
+      return myCode.size() == start + 1 && myCode[start].op == Op::Const;
+    }
+
+    // The variant of the binary operator with a constant right-hand side
+    static Op immediate(Op op) {
+      return Op(uInt8(op) - uInt8(Op::Plus) + uInt8(Op::PlusImm));
+    }
+
+    // Answer whether the operator always results in 0 or 1
+    static bool isBoolean(Op op) {
+      return op == Op::LogNot || op == Op::Bool ||
+             (op >= Op::Equals && op <= Op::GreaterEquals) ||
+             (op >= Op::EqualsImm && op <= Op::GreaterEqualsImm);
+    }
+
+    // Apply the unary operator to the code starting at 'start'
+    void applyUnary(Op op, size_t start);
+
+    // Answer whether the instruction reads the PC
+    static bool isPC(const Instruction& instruction);
+
+    // Get the operator for swapped operands, if they may be swapped
+    static bool swapOperands(Op& op);
+
+    // Apply the given unary or binary operator
+    static Int32 apply(Op op, Int32 value);
+    static Int32 apply(Op op, Int32 lhs, Int32 rhs);
+
+  private:
+    unique_ptr<Expression> myExpression;
+
+    vector<Instruction> myCode;
+
+    // The evaluation stack, sized for the deepest nesting of the code
+    mutable vector<Int32> myStack;
+    // The depth of the stack at the end of the code emitted so far
+    uInt32 myDepth{0};
+
+    // The PC required by the expression compiled last (-1 if none)
+    Int32 myRequiredPC{-1};
+
+  private:
+    // Following constructors and assignment operators not supported
+    CompiledExpression() = delete;
+    CompiledExpression(const CompiledExpression&) = delete;
+    CompiledExpression& operator=(const CompiledExpression&) = delete;
+};
+
+#endif
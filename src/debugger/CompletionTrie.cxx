@@ -0,0 +1,138 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <cstring>
+
+#include "CompletionTrie.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompletionTrie::add(const string& label)
+{
+  std::vector<uInt32> path{0};
+
+  for(char c: label)
+  {
+    Int32 next = child(path.back(), c);
+    if(next < 0)
+    {
+      next = Int32(myNodes.size());
+      myNodes[path.back()].children.emplace_back(fold(c), uInt32(next));
+      myNodes.emplace_back();
+    }
+    path.push_back(uInt32(next));
+  }
+  myNodes[path.back()].labels.push_back(label);
+
+  // Update the masks along the path, backwards
+  uInt64 mask = 0;
+  for(size_t i = label.size(); i > 0; --i)
+  {
+    mask |= charBit(label[i - 1]);
+    myNodes[path[i]].mask |= mask;
+  }
+  myNodes[0].mask |= mask;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompletionTrie::remove(const string& label)
+{
+  uInt32 node = 0;
+
+  for(char c: label)
+  {
+    const Int32 next = child(node, c);
+    if(next < 0)
+      return;
+    node = uInt32(next);
+  }
+
+  // The masks are kept, they only have to include all remaining labels
+  StringList& labels = myNodes[node].labels;
+  const auto it = std::find(labels.begin(), labels.end(), label);
+  if(it != labels.end())
+    labels.erase(it);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompletionTrie::clear()
+{
+  myNodes.clear();
+  myNodes.emplace_back();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompletionTrie::getCompletions(const char* in, StringList& list) const
+{
+  const size_t len = std::strlen(in);
+
+  // The characters still to be found after each matched one
+  std::vector<uInt64> remaining(len + 1, 0);
+  for(size_t i = len; i > 0; --i)
+    remaining[i - 1] = remaining[i] | charBit(in[i - 1]);
+
+  if(len == 0)
+    collect(0, in, list);
+  else
+  {
+    // The first character must match
+    const Int32 first = child(0, in[0]);
+    if(first >= 0 && (remaining[0] & ~myNodes[first].mask) == 0)
+      search(uInt32(first), in, 1, remaining, list);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 CompletionTrie::child(uInt32 node, char c) const
+{
+  c = fold(c);
+  for(const auto& [edge, next]: myNodes[node].children)
+    if(edge == c)
+      return Int32(next);
+
+  return -1;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompletionTrie::collect(uInt32 node, const char* in, StringList& list) const
+{
+  const Node& n = myNodes[node];
+
+  for(const auto& label: n.labels)
+    if(myMatch == Match::IgnoreCase ? BSPF::matchesIgnoreCase(label, in)
+                                    : BSPF::matchesCamelCase(label, in))
+      list.push_back(label);
+
+  for(const auto& edge: n.children)
+    collect(edge.second, in, list);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompletionTrie::search(uInt32 node, const char* in, size_t matched,
+                            const std::vector<uInt64>& remaining,
+                            StringList& list) const
+{
+  // All characters found (in order), the whole subtree is a candidate
+  if(matched + 1 == remaining.size())
+  {
+    collect(node, in, list);
+    return;
+  }
+
+  for(const auto& [edge, next]: myNodes[node].children)
+    if((remaining[matched] & ~myNodes[next].mask) == 0)
+      search(next, in, matched + (edge == fold(in[matched]) ? 1 : 0), remaining, list);
+}
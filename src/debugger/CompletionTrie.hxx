@@ -0,0 +1,94 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef COMPLETION_TRIE_HXX
+#define COMPLETION_TRIE_HXX
+
+#include "bspf.hxx"
+
+/**
+  A case insensitive prefix trie of labels, used for tab completion.
+
+  Completions are matched fuzzily (see BSPF::matchesIgnoreCase() and
+  BSPF::matchesCamelCase()): the first character must match, and the other
+  characters must appear in order.  Each node therefore knows which
+  characters appear in its subtree, so that subtrees which can't contain
+  the remaining characters are skipped.  Once all characters have been
+  found, the labels of the subtree are only checked by the exact matcher.
+*/
+class CompletionTrie
+{
+  public:
+    enum class Match { IgnoreCase, CamelCase };
+
+    explicit CompletionTrie(Match match) : myMatch{match} { clear(); }
+
+    /**
+      Add a label; labels may be added more than once.
+    */
+    void add(const string& label);
+
+    /**
+      Remove (one instance of) the given label.
+    */
+    void remove(const string& label);
+
+    /**
+      Remove all labels.
+    */
+    void clear();
+
+    /**
+      Add all labels matching 'in' to the list.
+    */
+    void getCompletions(const char* in, StringList& list) const;
+
+  private:
+    struct Node {
+      // Characters (see charBit()) of the labels through this node,
+      // starting with the node's own
+      uInt64 mask{0};
+      // Case folded character of the edges and the child nodes
+      std::vector<std::pair<char, uInt32>> children;
+      // Labels ending at this node
+      StringList labels;
+    };
+
+    static char fold(char c) { return char(std::tolower(uInt8(c))); }
+    static uInt64 charBit(char c) { return uInt64(1) << (fold(c) & 63); }
+
+    Int32 child(uInt32 node, char c) const;
+    void collect(uInt32 node, const char* in, StringList& list) const;
+    void search(uInt32 node, const char* in, size_t matched,
+                const std::vector<uInt64>& remaining, StringList& list) const;
+
+  private:
+    Match myMatch;
+
+    // Node 0 is the root
+    std::vector<Node> myNodes;
+
+  private:
+    // Following constructors and assignment operators not supported
+    CompletionTrie() = delete;
+    CompletionTrie(const CompletionTrie&) = delete;
+    CompletionTrie(CompletionTrie&&) = delete;
+    CompletionTrie& operator=(const CompletionTrie&) = delete;
+    CompletionTrie& operator=(CompletionTrie&&) = delete;
+};
+
+#endif
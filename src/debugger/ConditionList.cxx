@@ -0,0 +1,111 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "Vec.hxx"
+#include "ConditionList.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 ConditionList::add(Expression* expression, const string& name)
+{
+  myConditions.emplace_back(expression);
+  myNames.push_back(name);
+
+  updateIndex();
+
+  return uInt32(myConditions.size() - 1);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ConditionList::remove(uInt32 idx)
+{
+  if(idx >= myConditions.size())
+    return false;
+
+  Vec::removeAt(myConditions, idx);
+  Vec::removeAt(myNames, idx);
+
+  updateIndex();
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConditionList::clear()
+{
+  myConditions.clear();
+  myNames.clear();
+
+  updateIndex();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 ConditionList::evaluate() const
+{
+  for(Int32 i = Int32(myConditions.size()) - 1; i >= 0; --i)
+    if(myConditions[i].evaluate())
+      return i;
+
+  return -1;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 ConditionList::evaluate(uInt16 pc) const
+{
+  static const vector<uInt32> None;
+
+  const vector<uInt32>& indexed = !myIndexedPCs.empty() && myIndexedPCs[pc]
+    ? myIndexed.find(pc)->second : None;
+
+  // Merge both lists, starting with the highest index
+  auto i = myUnindexed.crbegin(), j = indexed.crbegin();
+  while(i != myUnindexed.crend() || j != indexed.crend())
+  {
+    uInt32 idx;
+    if(j == indexed.crend() || (i != myUnindexed.crend() && *i > *j))
+      idx = *i++;
+    else
+      idx = *j++;
+
+    if(myConditions[idx].evaluate())
+      return Int32(idx);
+  }
+
+  return -1;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConditionList::updateIndex()
+{
+  myIndexed.clear();
+  myIndexedPCs.clear();
+  myUnindexed.clear();
+
+  for(uInt32 idx = 0; idx < myConditions.size(); ++idx)
+  {
+    const Int32 pc = myConditions[idx].requiredPC();
+
+    if(pc >= 0)
+    {
+      if(myIndexedPCs.empty())
+        myIndexedPCs.resize(0x10000);
+      myIndexedPCs[pc] = true;
+      myIndexed[uInt16(pc)].push_back(idx);
+    }
+    else
+      myUnindexed.push_back(idx);
+  }
+}
@@ -0,0 +1,100 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef CONDITION_LIST_HXX
+#define CONDITION_LIST_HXX
+
+#include <unordered_map>
+
+#include "bspf.hxx"
+#include "CompiledExpression.hxx"
+
+/**
+  A list of named conditions (conditional breaks, save states or traps),
+  as checked by the CPU.
+
+  Conditions which can only be true at a certain PC (e.g. 'pc == $f123 &&
+  a == 5') are additionally kept in a table indexed by that PC, so that
+  evaluate(pc) only has to check them when the PC matches.
+
+  @author  Stella Team
+*/
+class ConditionList
+{
+  public:
+    ConditionList() = default;
+
+    /**
+      Add a new condition, and take ownership of its expression.
+
+      @return  The index of the condition
+    */
+    uInt32 add(Expression* expression, const string& name);
+
+    /**
+      Remove the condition with the given index; the indices of all
+      following conditions are decreased.
+    */
+    bool remove(uInt32 idx);
+
+    void clear();
+
+    bool empty() const { return myConditions.empty(); }
+    size_t size() const { return myConditions.size(); }
+
+    /**
+      The names of the conditions, in the order of their indices.
+    */
+    const StringList& names() const { return myNames; }
+
+    /**
+      Answer the highest index of all conditions which are true, or -1
+      if none is true.
+    */
+    Int32 evaluate() const;
+
+    /**
+      Like evaluate(), but only check the conditions which may be true at
+      the given PC.
+    */
+    Int32 evaluate(uInt16 pc) const;
+
+  private:
+    // Recreate the indices of the conditions, after a change of the list
+    void updateIndex();
+
+  private:
+    vector<CompiledExpression> myConditions;
+    StringList myNames;
+
+    // The indices of the conditions which can only be true at a certain PC,
+    // in ascending order
+    std::unordered_map<uInt16, vector<uInt32>> myIndexed;
+    // Whether there are any conditions in myIndexed for a PC (high speed lookup)
+    vector<bool> myIndexedPCs;
+    // The indices of all other conditions, in ascending order
+    vector<uInt32> myUnindexed;
+
+  private:
+    // Following constructors and assignment operators not supported
+    ConditionList(const ConditionList&) = delete;
+    ConditionList(ConditionList&&) = delete;
+    ConditionList& operator=(const ConditionList&) = delete;
+    ConditionList& operator=(ConditionList&&) = delete;
+};
+
+#endif
@@ -0,0 +1,147 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <algorithm>
+
+#include "CpuProfiler.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CpuProfiler::CpuProfiler(Mode mode, uInt16 banks)
+  : myMode{mode}
+{
+  myCounters.resize(mode == Mode::Fast ? 0x10000 : (uInt32(banks) + 1) << 12);
+  myFrames.emplace_back();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<CpuProfiler::Spot> CpuProfiler::hotSpots(uInt32 max) const
+{
+  vector<Spot> spots;
+
+  for(uInt32 i = 0; i < myCounters.size(); ++i)
+  {
+    const Counter& counter = myCounters[i];
+    if(counter.count == 0)
+      continue;
+
+    Spot spot;
+    if(myMode == Mode::Full && i >= 0x1000)
+      spot.bank = uInt16((i >> 12) - 1);
+    spot.addr = counter.pc;
+    spot.cycles = counter.cycles;
+    spot.count = counter.count;
+    spots.push_back(spot);
+  }
+
+  const auto hotter = [](const Spot& a, const Spot& b) {
+    return a.cycles > b.cycles;
+  };
+  if(spots.size() > max)
+  {
+    std::partial_sort(spots.begin(), spots.begin() + max, spots.end(), hotter);
+    spots.resize(max);
+  }
+  else
+    std::sort(spots.begin(), spots.end(), hotter);
+
+  return spots;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::map<uInt16, uInt64> CpuProfiler::bankCycles() const
+{
+  std::map<uInt16, uInt64> banks;
+
+  if(myMode == Mode::Fast)
+  {
+    if(myTotalCycles)
+      banks[NO_BANK] = myTotalCycles;
+    return banks;
+  }
+
+  for(uInt32 i = 0; i < myCounters.size(); ++i)
+    if(myCounters[i].cycles)
+      banks[i < 0x1000 ? NO_BANK : uInt16((i >> 12) - 1)] += myCounters[i].cycles;
+
+  return banks;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 CpuProfiler::saveFoldedStacks(ostream& out, const FrameName& name) const
+{
+  if(myMode == Mode::Fast)
+    return 0;
+
+  // Build each frame's name once, parents are always created before
+  // their children
+  StringList paths(myFrames.size());
+  paths[0] = "all";
+
+  uInt32 stacks = 0;
+  for(uInt32 i = 0; i < myFrames.size(); ++i)
+  {
+    const Frame& frame = myFrames[i];
+
+    if(i > 0)
+      paths[i] = paths[frame.parent] + ";" +
+                 name(uInt16(frame.location >> 16), uInt16(frame.location));
+    if(frame.cycles)
+    {
+      out << paths[i] << " " << frame.cycles << "\n";
+      ++stacks;
+    }
+  }
+
+  return stacks;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CpuProfiler::call(uInt32 location)
+{
+  if(myFrames[myFrame].depth == MAX_DEPTH)
+  {
+    ++myOverflow;
+    return;
+  }
+
+  const auto key = std::make_pair(myFrame, location);
+  const auto it = myFrameIndex.find(key);
+
+  if(it != myFrameIndex.end())
+    myFrame = it->second;
+  else
+  {
+    Frame frame;
+    frame.parent = myFrame;
+    frame.location = location;
+    frame.depth = myFrames[myFrame].depth + 1;
+
+    const uInt32 index = uInt32(myFrames.size());
+    myFrames.push_back(frame);
+    myFrameIndex.emplace(key, index);
+    myFrame = index;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CpuProfiler::ret()
+{
+  if(myOverflow)
+    --myOverflow;
+  else
+    myFrame = myFrames[myFrame].parent;  // the root is its own parent
+}
@@ -0,0 +1,205 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef CPU_PROFILER_HXX
+#define CPU_PROFILER_HXX
+
+#include <functional>
+#include <map>
+
+#include "bspf.hxx"
+
+/**
+  Counts the CPU cycles spent by the instructions at each address, for
+  finding the hot spots of a program.  Every executed instruction adds
+  its cycles to a counter, no samples or traces are taken.
+
+  In 'Fast' mode, the counters are indexed by the address only, which is
+  cheap enough to profile at full emulation speed.  In 'Full' mode, they
+  are also separated by bank, and the cycles are additionally summed for
+  each call stack (built from JSR/RTS and BRK/RTI), which can be exported
+  in the 'folded stacks' format used for flame graphs.
+
+  Code manipulating the stack itself (e.g. calling by pushing an address
+  and RTS) can confuse the call stacks, but not the counters.
+
+  @author  Stella Team
+*/
+class CpuProfiler
+{
+  public:
+    enum class Mode { Fast, Full };
+
+    // The bank reported for code outside of the cartridge (e.g. in RAM)
+    // and in 'Fast' mode
+    static constexpr uInt16 NO_BANK = 0xFFFF;
+
+    struct Spot {
+      uInt16 bank{NO_BANK};
+      uInt16 addr{0};
+      uInt64 cycles{0};
+      uInt64 count{0};   // number of times the instruction was executed
+    };
+
+    // Names a stack frame for 'saveFoldedStacks'
+    using FrameName = std::function<string(uInt16 bank, uInt16 addr)>;
+
+  public:
+    CpuProfiler(Mode mode, uInt16 banks);
+
+    Mode mode() const { return myMode; }
+
+    /**
+      Whether record() needs to be given the bank of the instruction.
+    */
+    bool needsBank() const { return myMode == Mode::Full; }
+
+    /**
+      Count the instruction just executed.
+
+      @param pc      The address of the instruction
+      @param bank    The bank of the instruction (only used in 'Full' mode)
+      @param opcode  The opcode of the instruction
+      @param cycles  The CPU cycles taken by the instruction
+    */
+    void record(uInt16 pc, uInt16 bank, uInt8 opcode, uInt8 cycles)
+    {
+      if(myMode == Mode::Fast)
+        count(myCounters[pc], pc, cycles);
+      else
+      {
+        const uInt32 index = (pc & 0x1000) ? (uInt32(bank) + 1) << 12 | (pc & 0x0FFF)
+                                           : pc & 0x0FFF;
+        if(index >= myCounters.size())
+          myCounters.resize((index | 0x0FFF) + 1);
+
+        count(myCounters[index], pc, cycles);
+        recordStack(pc, bank, opcode, cycles);
+      }
+      myTotalCycles += cycles;
+    }
+
+    /**
+      The total number of cycles recorded.
+    */
+    uInt64 totalCycles() const { return myTotalCycles; }
+
+    /**
+      The instructions which took the most cycles, in descending order.
+
+      @param max  The maximum number of spots to return
+    */
+    vector<Spot> hotSpots(uInt32 max) const;
+
+    /**
+      The cycles spent in each bank ('Full' mode only, else all cycles
+      are reported for NO_BANK).
+    */
+    std::map<uInt16, uInt64> bankCycles() const;
+
+    /**
+      Write the cycles of each call stack in 'folded stacks' format, one
+      line "frame;frame;...;frame cycles" per stack ('Full' mode only).
+
+      @param out   The stream to write to
+      @param name  Names the frames (the targets of the calls)
+      @return  The number of stacks written
+    */
+    uInt32 saveFoldedStacks(ostream& out, const FrameName& name) const;
+
+  private:
+    struct Counter {
+      uInt64 cycles{0};
+      uInt32 count{0};
+      uInt16 pc{0};      // the last address counted (in 'Full' mode, the
+                         // counters don't separate mirrors)
+    };
+
+    // A node of the tree of call stacks, identified by its index
+    struct Frame {
+      uInt32 parent{0};
+      uInt32 location{0};  // bank << 16 | address of the called code
+      uInt32 depth{0};
+      uInt64 cycles{0};
+    };
+
+    static void count(Counter& counter, uInt16 pc, uInt8 cycles)
+    {
+      counter.cycles += cycles;
+      ++counter.count;
+      counter.pc = pc;
+    }
+
+    void recordStack(uInt16 pc, uInt16 bank, uInt8 opcode, uInt8 cycles)
+    {
+      // The target of a call is only known by the following instruction
+      if(myPendingCall)
+      {
+        myPendingCall = false;
+        call(uInt32(bank) << 16 | pc);
+      }
+      myFrames[myFrame].cycles += cycles;
+
+      switch(opcode)
+      {
+        case 0x20:  // JSR
+        case 0x00:  // BRK
+          myPendingCall = true;
+          break;
+
+        case 0x60:  // RTS
+        case 0x40:  // RTI
+          ret();
+          break;
+
+        default:
+          break;
+      }
+    }
+
+    void call(uInt32 location);
+    void ret();
+
+  private:
+    // Deeper stacks are folded into their parent
+    static constexpr uInt32 MAX_DEPTH = 64;
+
+    Mode myMode{Mode::Fast};
+
+    // 'Fast': one counter per address
+    // 'Full': 4K counters for non-cartridge code, followed by 4K per bank
+    vector<Counter> myCounters;
+    uInt64 myTotalCycles{0};
+
+    // The tree of call stacks (the root is frame 0), and the frame index
+    // of each (parent, location) pair
+    vector<Frame> myFrames;
+    std::map<std::pair<uInt32, uInt32>, uInt32> myFrameIndex;
+    uInt32 myFrame{0};
+    uInt32 myOverflow{0};   // calls not pushed because of MAX_DEPTH
+    bool myPendingCall{false};
+
+  private:
+    // Following constructors and assignment operators not supported
+    CpuProfiler() = delete;
+    CpuProfiler(const CpuProfiler&) = delete;
+    CpuProfiler(CpuProfiler&&) = delete;
+    CpuProfiler& operator=(const CpuProfiler&) = delete;
+    CpuProfiler& operator=(CpuProfiler&&) = delete;
+};
+
+#endif
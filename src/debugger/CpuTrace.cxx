@@ -0,0 +1,209 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+
+#if defined(ZIP_SUPPORT)
+  #include <zlib.h>
+#endif
+
+#include "CpuTrace.hxx"
+
+namespace {
+  constexpr std::array<uInt8, 4> MAGIC = { 'S', 'T', 'C', 'T' };
+  constexpr uInt16 VERSION = 1;
+
+  // The trace files are written through zlib if possible, else uncompressed
+#if defined(ZIP_SUPPORT)
+  void* openFile(const string& filename, bool write) {
+    // Level 1 keeps up with the emulation and still compresses very well
+    return gzopen(filename.c_str(), write ? "wb1" : "rb");
+  }
+  bool writeFile(void* file, const void* data, size_t size) {
+    return gzwrite(static_cast<gzFile>(file), data, uInt32(size)) == int(size);
+  }
+  size_t readFile(void* file, void* data, size_t size) {
+    const int read = gzread(static_cast<gzFile>(file), data, uInt32(size));
+    return read > 0 ? size_t(read) : 0;
+  }
+  void closeFile(void* file) {
+    gzclose(static_cast<gzFile>(file));
+  }
+#else
+  void* openFile(const string& filename, bool write) {
+    return std::fopen(filename.c_str(), write ? "wb" : "rb");
+  }
+  bool writeFile(void* file, const void* data, size_t size) {
+    return std::fwrite(data, 1, size, static_cast<FILE*>(file)) == size;
+  }
+  size_t readFile(void* file, void* data, size_t size) {
+    return std::fread(data, 1, size, static_cast<FILE*>(file));
+  }
+  void closeFile(void* file) {
+    std::fclose(static_cast<FILE*>(file));
+  }
+#endif
+
+  std::array<uInt8, 8> header() {
+    constexpr uInt16 size = sizeof(CpuTrace::Record);
+
+    return { MAGIC[0], MAGIC[1], MAGIC[2], MAGIC[3],
+             uInt8(VERSION), uInt8(VERSION >> 8), uInt8(size), uInt8(size >> 8) };
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CpuTrace::~CpuTrace()
+{
+  stop();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CpuTrace::start(const string& filename)
+{
+  stop();
+
+  myFile = openFile(filename, true);
+  if(myFile == nullptr)
+    return false;
+
+  const auto head = header();
+  if(!writeFile(myFile, head.data(), head.size()))
+  {
+    closeFile(myFile);
+    myFile = nullptr;
+    return false;
+  }
+
+  myHead = myTail = 0;
+  myCachedTail = myStalls = 0;
+  myQuit = false;
+  myThread = std::thread([this] { writerMain(); });
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CpuTrace::stop()
+{
+  if(!myThread.joinable())
+    return;
+
+  myQuit = true;
+  myThread.join();
+
+  closeFile(myFile);
+  myFile = nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CpuTrace::writerMain()
+{
+  bool ok = true;
+
+  for(;;)
+  {
+    // Check for the quit request first, so that the final records are
+    // still written
+    const bool quit = myQuit;
+    const uInt64 head = myHead.load(std::memory_order_acquire);
+    uInt64 tail = myTail.load(std::memory_order_relaxed);
+
+    if(head == tail)
+    {
+      if(quit)
+        break;
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      continue;
+    }
+
+    while(tail != head)
+    {
+      // Write the records up to the end of the ring in one go
+      const uInt64 start = tail & (CAPACITY - 1);
+      const uInt64 count = std::min(head - tail, CAPACITY - start);
+
+      // After a write error, the records are only consumed
+      if(ok)
+        ok = writeFile(myFile, &myRing[start], count * sizeof(Record));
+
+      tail += count;
+      myTail.store(tail, std::memory_order_release);
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 CpuTrace::convertToText(const string& filename, ostream& out)
+{
+  void* file = openFile(filename, false);
+  if(file == nullptr)
+    throw runtime_error("Unable to open " + filename);
+
+  std::array<uInt8, 8> head;
+  if(readFile(file, head.data(), head.size()) != head.size() || head != header())
+  {
+    closeFile(file);
+    throw runtime_error(filename + " is not a CPU trace of this version");
+  }
+
+  out << "       cycles  frame line  bank     pc op  a  x  y sp flags     read      write\n";
+
+  // Matches the flag display of the debugger's CPU widget
+  static constexpr char FLAGS[] = "NV-BDIZC";
+
+  std::array<Record, 1024> records;
+  uInt64 count = 0;
+  size_t read = 0;
+
+  while((read = readFile(file, records.data(), sizeof(records)) / sizeof(Record)) > 0)
+  {
+    for(size_t i = 0; i < read; ++i)
+    {
+      const Record& r = records[i];
+      string flags = "nv-bdizc";
+
+      for(int bit = 0; bit < 8; ++bit)
+        if(r.ps & (0x80 >> bit))
+          flags[bit] = FLAGS[bit];
+
+      out << std::dec << std::setfill(' ')
+          << std::setw(13) << r.cycles << ' ' << std::setw(6) << r.frame
+          << ' ' << std::setw(4) << r.scanline << ' ' << std::setw(5) << r.bank
+          << std::hex << std::setfill('0')
+          << "  $" << std::setw(4) << r.pc << ' ' << std::setw(2) << int(r.opcode)
+          << ' ' << std::setw(2) << int(r.a) << ' ' << std::setw(2) << int(r.x)
+          << ' ' << std::setw(2) << int(r.y) << ' ' << std::setw(2) << int(r.sp)
+          << ' ' << flags;
+
+      if(r.flags & HasRead)
+        out << "  $" << std::setw(4) << r.readAddress << '=' << std::setw(2) << int(r.readValue);
+      else if(r.flags & HasWrite)
+        out << "          ";
+      if(r.flags & HasWrite)
+        out << "  $" << std::setw(4) << r.writeAddress << '=' << std::setw(2) << int(r.writeValue);
+      out << '\n';
+    }
+    count += read;
+  }
+  closeFile(file);
+
+  return count;
+}
@@ -0,0 +1,150 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef CPU_TRACE_HXX
+#define CPU_TRACE_HXX
+
+#include <atomic>
+#include <thread>
+
+#include "bspf.hxx"
+
+/**
+  Records a trace of every instruction executed by the CPU into a file,
+  for long sessions at full emulation speed.
+
+  The CPU fills one fixed-size binary record per instruction directly in
+  a lock-free single-producer/single-consumer ring buffer. A background
+  thread drains the ring and writes the records to a file, compressed in
+  gzip format if zlib is available. The producer only has to wait when
+  the writer falls behind a full ring, so the trace never loses records.
+
+  The file starts with a header of eight bytes ('S', 'T', 'C', 'T', the
+  format version and the record size as 16 bit values), followed by the
+  records in native byte order. 'convertToText' turns a trace back into
+  one human-readable line per instruction.
+
+  @author  Stella Team
+*/
+class CpuTrace
+{
+  public:
+    struct Record {
+      uInt64 cycles{0};       // system cycles at the start of the instruction
+      uInt32 frame{0};
+      uInt16 pc{0};
+      uInt16 bank{0};
+      uInt16 scanline{0};
+      uInt16 readAddress{0};  // last data read of the instruction
+      uInt16 writeAddress{0}; // last write of the instruction
+      uInt8 a{0}, x{0}, y{0}, sp{0}, ps{0};
+      uInt8 opcode{0};
+      uInt8 readValue{0};
+      uInt8 writeValue{0};
+      uInt8 flags{0};         // see HasRead and HasWrite
+      uInt8 icycles{0};       // CPU cycles taken by the instruction
+    };
+    static_assert(sizeof(Record) == 32, "trace records must have a fixed size");
+
+    static constexpr uInt8 HasRead = 0x01, HasWrite = 0x02;
+
+  public:
+    CpuTrace() = default;
+    ~CpuTrace();
+
+    /**
+      Open the given file and start the writer thread.
+
+      @return  False if the file couldn't be created
+    */
+    bool start(const string& filename);
+
+    /**
+      Write all pending records, and close the file.
+    */
+    void stop();
+
+    bool isActive() const { return myThread.joinable(); }
+
+    /**
+      The number of records traced so far, and how often the CPU had to
+      wait for the writer.
+    */
+    uInt64 records() const { return myHead.load(std::memory_order_relaxed); }
+    uInt64 stalls() const { return myStalls; }
+
+    /**
+      Answer the ring slot for the next record. It is only published to
+      the writer by the next call of 'end'.
+    */
+    Record& begin() {
+      const uInt64 head = myHead.load(std::memory_order_relaxed);
+
+      if(head - myCachedTail == CAPACITY)
+      {
+        myCachedTail = myTail.load(std::memory_order_acquire);
+        while(head - myCachedTail == CAPACITY)
+        {
+          ++myStalls;
+          std::this_thread::yield();
+          myCachedTail = myTail.load(std::memory_order_acquire);
+        }
+      }
+      return myRing[head & (CAPACITY - 1)];
+    }
+
+    void end() {
+      myHead.store(myHead.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_release);
+    }
+
+    /**
+      Convert the binary trace in the given file into text, one line per
+      instruction.
+
+      @return  The number of converted records
+    */
+    static uInt64 convertToText(const string& filename, ostream& out);
+
+  private:
+    void writerMain();
+
+  private:
+    // The size of the ring, in records (2 MB)
+    static constexpr uInt64 CAPACITY = 1 << 16;
+
+    std::array<Record, CAPACITY> myRing;
+
+    // Total number of records published by the CPU, resp. written to the file
+    std::atomic<uInt64> myHead{0}, myTail{0};
+    // The producer's last view of myTail, to avoid polling the atomic
+    uInt64 myCachedTail{0};
+    uInt64 myStalls{0};
+
+    void* myFile{nullptr};
+    std::thread myThread;
+    std::atomic<bool> myQuit{false};
+
+  private:
+    // Following constructors and assignment operators not supported
+    CpuTrace(const CpuTrace&) = delete;
+    CpuTrace(CpuTrace&&) = delete;
+    CpuTrace& operator=(const CpuTrace&) = delete;
+    CpuTrace& operator=(CpuTrace&&) = delete;
+};
+
+#endif
@@ -30,6 +30,7 @@
 #include "DebuggerParser.hxx"
 #include "StateManager.hxx"
 #include "RewindManager.hxx"
+#include "ReverseStepper.hxx"
 
 #include "Console.hxx"
 #include "System.hxx"
@@ -75,6 +76,8 @@ Debugger::Debugger(OSystem& osystem, Console& console)
   myRiotDebug = make_unique<RiotDebug>(*this, myConsole);
   myTiaDebug  = make_unique<TIADebug>(*this, myConsole);
 
+  myReverseStepper = make_unique<ReverseStepper>(osystem, *this);
+
   // Allow access to this object from any class
   // Technically this violates pure OO programming, but since I know
   // there will only be ever one instance of debugger in Stella,
@@ -242,6 +245,8 @@ void Debugger::reset()
   unlockSystem();
   mySystem.reset();
   lockSystem();
+
+  myReverseStepper->checkpoint();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -289,6 +294,10 @@ void Debugger::loadState(int state)
   unlockSystem();
   myOSystem.state().loadState(state);
   lockSystem();
+
+  // The loaded state has a different history
+  myReverseStepper->clear();
+  myReverseStepper->checkpoint();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -301,13 +310,19 @@ void Debugger::loadAllStates()
   unlockSystem();
   myOSystem.state().rewindManager().loadAllStates();
   lockSystem();
+
+  myReverseStepper->clear();
+  myReverseStepper->checkpoint();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int Debugger::step(bool save)
 {
   if(save)
+  {
     saveOldState();
+    myReverseStepper->checkpoint();
+  }
 
   uInt64 startCycle = mySystem.cycles();
 
@@ -336,6 +351,7 @@ int Debugger::trace()
   if(mySystem.peek(myCpuDebug->pc()) == 32)
   {
     saveOldState();
+    myReverseStepper->checkpoint();
 
     uInt64 startCycle = mySystem.cycles();
     int targetPC = myCpuDebug->pc() + 3; // return address
@@ -406,12 +422,14 @@ void Debugger::addReadTrap(uInt16 t)
 {
   readTraps().initialize();
   readTraps().add(t);
+  updatePageTraps(t);
 }
 
 void Debugger::addWriteTrap(uInt16 t)
 {
   writeTraps().initialize();
   writeTraps().add(t);
+  updatePageTraps(t);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -426,12 +444,14 @@ void Debugger::removeReadTrap(uInt16 t)
 {
   readTraps().initialize();
   readTraps().remove(t);
+  updatePageTraps(t);
 }
 
 void Debugger::removeWriteTrap(uInt16 t)
 {
   writeTraps().initialize();
   writeTraps().remove(t);
+  updatePageTraps(t);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -441,6 +461,26 @@ void Debugger::removeTrap(uInt16 t)
   removeWriteTrap(t);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Debugger::updatePageTraps(uInt16 t)
+{
+  // The system's pages cover the 8K address space, so a page is trapped
+  // whenever any address of it or one of its mirrors is
+  const uInt16 page = t & (System::ADDRESS_MASK & ~System::PAGE_MASK);
+  uInt8 traps = 0;
+
+  for(uInt32 mirror = 0; mirror < 0x10000; mirror += System::ADDRESS_MASK + 1)
+    for(uInt16 offset = 0; offset < System::PAGE_SIZE; ++offset)
+    {
+      const uInt16 addr = mirror | page | offset;
+
+      if(readTraps().isSet(addr))  traps |= System::PageReadTrap;
+      if(writeTraps().isSet(addr)) traps |= System::PageWriteTrap;
+    }
+
+  mySystem.setPageTraps(page, traps);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Debugger::readTrap(uInt16 t)
 {
@@ -622,6 +662,22 @@ uInt32 Debugger::getBaseAddress(uInt32 addr, bool read)
   return 0;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Debugger::runUntilBreak(uInt64 cycles)
+{
+  DispatchResult dispatchResult;
+
+  myReverseStepper->checkpoint();
+
+  unlockSystem();
+  mySystem.m6502().execute(cycles, dispatchResult);
+  myOSystem.console().tia().flushLineCache();
+  lockSystem();
+
+  // One-shot breakpoints stop without setting a result
+  return dispatchResult.getStatus() != DispatchResult::Status::ok;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Debugger::nextScanline(int lines)
 {
@@ -629,6 +685,7 @@ void Debugger::nextScanline(int lines)
   buf << "scanline + " << lines;
 
   saveOldState();
+  myReverseStepper->checkpoint();
 
   unlockSystem();
   while(lines)
@@ -649,6 +706,7 @@ void Debugger::nextFrame(int frames)
   buf << "frame + " << frames;
 
   saveOldState();
+  myReverseStepper->checkpoint();
 
   unlockSystem();
   DispatchResult dispatchResult;
@@ -686,6 +744,11 @@ uInt16 Debugger::windStates(uInt16 numStates, bool unwind, string& message)
 
   lockSystem();
 
+  // Rewind states may be from before entering the debugger, or have been
+  // replaced since
+  myReverseStepper->clear();
+  myReverseStepper->checkpoint();
+
   updateRewindbuttons(r);
   return winds;
 }
@@ -702,6 +765,64 @@ uInt16 Debugger::unwindStates(const uInt16 numStates, string& message)
   return windStates(numStates, true, message);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Debugger::moveBack(const std::function<bool(string&)>& move, string& message)
+{
+  saveOldState();
+
+  const uInt64 startCycles = mySystem.cycles();
+
+  // Loading the checkpoints could initiate a bankswitch, so we allow it temporarily
+  unlockSystem();
+  const bool moved = move(message);
+  myOSystem.console().tia().flushLineCache();
+  lockSystem();
+
+  if(moved)
+  {
+    ostringstream buf;
+    buf << "moved back " << (startCycles - mySystem.cycles()) << " cycles";
+    if(!message.empty())
+      buf << " (" << message << ")";
+    message = buf.str();
+  }
+  return moved;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Debugger::stepBack(uInt32 instructions, string& message)
+{
+  return moveBack([&](string& msg) {
+    return myReverseStepper->stepBack(instructions, msg);
+  }, message);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Debugger::scanlineBack(uInt32 lines, string& message)
+{
+  return moveBack([&](string& msg) {
+    return myReverseStepper->cyclesBack(uInt64(lines) * 76, msg);
+  }, message);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Debugger::frameBack(uInt32 frames, string& message)
+{
+  const uInt64 frameCycles = myConsole.emulationTiming().cyclesPerFrame();
+
+  return moveBack([&](string& msg) {
+    return myReverseStepper->cyclesBack(frames * frameCycles, msg);
+  }, message);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Debugger::runBack(string& message)
+{
+  return moveBack([&](string& msg) {
+    return myReverseStepper->runBack(msg);
+  }, message);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Debugger::clearAllBreakPoints()
 {
@@ -713,6 +834,7 @@ void Debugger::clearAllTraps()
 {
   readTraps().clearAll();
   writeTraps().clearAll();
+  mySystem.clearPageTraps();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -762,6 +884,10 @@ void Debugger::setStartState()
   // Lock the bus each time the debugger is entered, so we don't disturb anything
   lockSystem();
 
+  // Moving back is possible from here on (and to the rewind states before)
+  myReverseStepper->clear();
+  myReverseStepper->checkpoint();
+
   // Save initial state and add it to the rewind list (except when in currently rewinding)
   RewindManager& r = myOSystem.state().rewindManager();
   // avoid invalidating future states when entering the debugger e.g. during rewind
@@ -780,6 +906,7 @@ void Debugger::setQuitState()
 {
   myDialog->saveConfig();
   saveOldState();
+  myReverseStepper->clear();
 
   // Bus must be unlocked for normal operation when leaving debugger mode
   unlockSystem();
@@ -40,6 +40,7 @@ class RiotDebug;
 class TIADebug;
 class DebuggerParser;
 class RewindManager;
+class ReverseStepper;
 
 #include <map>
 
@@ -150,6 +151,11 @@ class Debugger : public DialogContainer
     */
     TIADebug& tiaDebug() const { return *myTiaDebug; }
 
+    /**
+      The checkpoints for moving the emulation back
+    */
+    const ReverseStepper& reverseStepper() const { return *myReverseStepper; }
+
     const GUI::Font& lfont() const      { return myDialog->lfont();     }
     const GUI::Font& nlfont() const     { return myDialog->nfont();     }
     DebuggerParser& parser() const      { return *myParser;             }
@@ -310,11 +316,34 @@ class Debugger : public DialogContainer
 
     int step(bool save = true);
     int trace();
+
+    /**
+      Run the emulation for the given number of cycles, stopping early at
+      any breakpoint or trap. Apart from these checks, the CPU runs at
+      full speed.
+
+      @return  True if the emulation was stopped early
+    */
+    bool runUntilBreak(uInt64 cycles);
     void nextScanline(int lines);
     void nextFrame(int frames);
     uInt16 rewindStates(const uInt16 numStates, string& message);
     uInt16 unwindStates(const uInt16 numStates, string& message);
 
+    /**
+      Move the emulation back by the given number of instructions,
+      scanlines or frames, or to the last breakpoint or trap hit (see
+      ReverseStepper).  Unlike rewinding, this is not limited to the
+      rewind states.
+
+      @param message  Set to the result
+      @return  True if the emulation was moved back
+    */
+    bool stepBack(uInt32 instructions, string& message);
+    bool scanlineBack(uInt32 lines, string& message);
+    bool frameBack(uInt32 frames, string& message);
+    bool runBack(string& message);
+
     void clearAllBreakPoints();
 
     void addReadTrap(uInt16 t);
@@ -326,6 +355,8 @@ class Debugger : public DialogContainer
     bool readTrap(uInt16 t);
     bool writeTrap(uInt16 t);
     void clearAllTraps();
+    // Mark the system page containing the given address as trapped or not
+    void updatePageTraps(uInt16 t);
     void log(const string& triggerMsg);
 
     // Set a bunch of RAM locations at once
@@ -348,6 +379,7 @@ class Debugger : public DialogContainer
     unique_ptr<CpuDebug>       myCpuDebug;
     unique_ptr<RiotDebug>      myRiotDebug;
     unique_ptr<TIADebug>       myTiaDebug;
+    unique_ptr<ReverseStepper> myReverseStepper;
 
     static Debugger* myStaticDebugger;
 
@@ -376,6 +408,8 @@ class Debugger : public DialogContainer
     uInt16 windStates(uInt16 numStates, bool unwind, string& message);
     // update the rewind/unwind button state
     void updateRewindbuttons(const RewindManager& r);
+    // move back using the given ReverseStepper method
+    bool moveBack(const std::function<bool(string&)>& move, string& message);
 
     // Following constructors and assignment operators not supported
     Debugger() = delete;
@@ -28,6 +28,9 @@
 #include "DebuggerParser.hxx"
 #include "YaccParser.hxx"
 #include "M6502.hxx"
+#include "CartARM.hxx"
+#include "Console.hxx"
+#include "EmulationTiming.hxx"
 #include "Expression.hxx"
 #include "FSNode.hxx"
 #include "OSystem.hxx"
@@ -37,9 +40,12 @@
 #include "PromptWidget.hxx"
 #include "RomWidget.hxx"
 #include "ProgressDialog.hxx"
+#include "RewindManager.hxx"
+#include "StateManager.hxx"
 #include "BrowserDialog.hxx"
 #include "FrameBuffer.hxx"
 #include "TimerManager.hxx"
+#include "EventCounters.hxx"
 #include "Vec.hxx"
 
 #include "Base.hxx"
@@ -107,59 +113,116 @@ string DebuggerParser::run(const string& command)
 
   string verb;
   getArgs(command, verb);
-  commandResult.str("");
 
+  return runCommand(findCommand(verb));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int DebuggerParser::findCommand(const string& verb)
+{
   for(int i = 0; i < int(commands.size()); ++i)
-  {
     if(BSPF::equalsIgnoreCase(verb, commands[i].cmdString))
-    {
-      if(validateArgs(i))
-      {
-        myCommand = i;
-        if(commands[i].refreshRequired)
-          debugger.baseDialog()->saveConfig();
-        commands[i].executor(this);
-      }
+      return i;
 
-      if(commands[i].refreshRequired)
-        debugger.baseDialog()->loadConfig();
+  return -1;
+}
 
-      return commandResult.str();
-    }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string DebuggerParser::runCommand(int cmd)
+{
+  commandResult.str("");
+  checkPendingWrites();
+
+  if(cmd < 0)
+    return commandResult.str() + red("No such command (try \"help\")");
+
+  if(validateArgs(cmd))
+  {
+    myCommand = cmd;
+    if(commands[cmd].refreshRequired)
+      debugger.baseDialog()->saveConfig();
+    commands[cmd].executor(this);
   }
 
-  return red("No such command (try \"help\")");
+  if(commands[cmd].refreshRequired)
+    debugger.baseDialog()->loadConfig();
+
+  return commandResult.str();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string DebuggerParser::exec(const FilesystemNode& file, StringList* history)
 {
-  if(file.exists())
-  {
-    stringstream in;
-    try        { file.read(in); }
-    catch(...) { return red("script file \'" + file.getShortPath() + "\' not found"); }
+  // Scripts are kept by shared pointer, since a nested 'exec' of the same
+  // (meanwhile modified) file may replace the cache entry we're running
+  const shared_ptr<const Script> script = loadScript(file);
+  if(!script)
+    return red("script file \'" + file.getShortPath() + "\' not found");
 
-    ostringstream buf;
-    int count = 0;
-    string command;
-    while( !in.eof() )
-    {
-      if(!getline(in, command))
-        break;
+  ostringstream buf;
+  int count = 0;
+  for(const auto& line: script->lines)
+  {
+    // Only the argument values must be evaluated again, since they
+    // depend on the current machine state and defined labels
+    argStrings = line.argStrings;
+    evaluateArgs();
+    runCommand(line.cmd);
+    if (history != nullptr)
+      history->push_back(line.command);
+    count++;
+  }
+  buf << "\nExecuted " << count << " command" << (count != 1 ? "s" : "") << " from \""
+      << file.getShortPath() << "\"";
 
-      run(command);
-      if (history != nullptr)
-        history->push_back(command);
-      count++;
-    }
-    buf << "\nExecuted " << count << " command" << (count != 1 ? "s" : "") << " from \""
-        << file.getShortPath() << "\"";
+  return buf.str();
+}
 
-    return buf.str();
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+shared_ptr<const DebuggerParser::Script>
+DebuggerParser::loadScript(const FilesystemNode& file)
+{
+  if(!file.exists())
+    return nullptr;
+
+  // A script being saved in the background must be complete before reading it
+  waitForPendingWrites();
+
+  uInt64 size = 0, mtime = 0;
+  const bool haveInfo = file.getFileInfo(size, mtime);
+
+  const auto cached = myScriptCache.find(file.getPath());
+  if(haveInfo && cached != myScriptCache.end() &&
+     cached->second->size == size && cached->second->mtime == mtime)
+    return cached->second;
+
+  stringstream in;
+  try        { file.read(in); }
+  catch(...) { return nullptr; }
+
+  auto script = make_shared<Script>();
+  script->size = size;
+  script->mtime = mtime;
+
+  string command, verb;
+  while( !in.eof() )
+  {
+    if(!getline(in, command))
+      break;
+
+    ScriptLine line;
+    line.command = command;
+    tokenize(command, verb, line.argStrings);
+    line.cmd = findCommand(verb);
+    script->lines.push_back(std::move(line));
   }
+
+  if(haveInfo)
+    myScriptCache[file.getPath()] = script;
   else
-    return red("script file \'" + file.getShortPath() + "\' not found");
+    myScriptCache.erase(file.getPath());
+
+  return script;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -331,14 +394,23 @@ string DebuggerParser::showWatches()
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool DebuggerParser::getArgs(const string& command, string& verb)
+{
+  tokenize(command, verb, argStrings);
+  evaluateArgs();
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DebuggerParser::tokenize(const string& command, string& verb,
+                              StringList& tokens)
 {
   ParseState state = ParseState::IN_COMMAND;
   uInt32 i = 0, length = uInt32(command.length());
   string curArg = "";
   verb = "";
 
-  argStrings.clear();
-  args.clear();
+  tokens.clear();
 
   // cerr << "Parsing \"" << command << "\"" << ", length = " << command.length() << endl;
 
@@ -366,7 +438,7 @@ bool DebuggerParser::getArgs(const string& command, string& verb)
       case ParseState::IN_BRACE:
         if(c == '}') {
           state = ParseState::IN_SPACE;
-          argStrings.push_back(curArg);
+          tokens.push_back(curArg);
           //  cerr << "{" << curArg << "}" << endl;
           curArg = "";
         } else {
@@ -376,7 +448,7 @@ bool DebuggerParser::getArgs(const string& command, string& verb)
       case ParseState::IN_ARG:
         if(c == ' ') {
           state = ParseState::IN_SPACE;
-          argStrings.push_back(curArg);
+          tokens.push_back(curArg);
           curArg = "";
         } else {
           curArg += c;
@@ -388,8 +460,13 @@ bool DebuggerParser::getArgs(const string& command, string& verb)
 
   // Take care of the last argument, if there is one
   if(curArg != "")
-    argStrings.push_back(curArg);
+    tokens.push_back(curArg);
+}
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DebuggerParser::evaluateArgs()
+{
+  args.clear();
   argCount = uInt32(argStrings.size());
 
   for(uInt32 arg = 0; arg < argCount; ++arg)
@@ -402,8 +479,6 @@ bool DebuggerParser::getArgs(const string& command, string& verb)
     else
       args.push_back(-1);
   }
-
-  return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -689,15 +764,7 @@ string DebuggerParser::saveScriptFile(string file)
     file = debugger.myOSystem.userDir().getPath() + file;
 
   FilesystemNode node(file);
-
-  try
-  {
-    node.write(out);
-  }
-  catch(...)
-  {
-    return "Unable to save script to " + node.getShortPath();
-  }
+  writeInBackground(node, out.str(), "Unable to save script to " + node.getShortPath());
 
   return "saved " + node.getShortPath() + " OK";
 }
@@ -706,17 +773,64 @@ string DebuggerParser::saveScriptFile(string file)
 void DebuggerParser::saveDump(const FilesystemNode& node, const stringstream& out,
                               ostringstream& result)
 {
-  try
+  writeInBackground(node, out.str(), "Unable to append dump to file " + node.getShortPath());
+  result << " to file " << node.getShortPath();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DebuggerParser::writeInBackground(const FilesystemNode& node, string contents,
+                                       const string& errorMsg)
+{
+  const string path = node.getPath();
+
+  // Writes to the same file must be done in order
+  for(auto& write: myPendingWrites)
+    if(write.path == path)
+      write.done.wait();
+  myScriptCache.erase(path);
+
+  PendingWrite write;
+  write.path = path;
+  write.errorMsg = errorMsg;
+  write.done = std::async(std::launch::async,
+      [node, contents = std::move(contents)]()
   {
-    node.write(out);
-    result << " to file " << node.getShortPath();
-  }
-  catch(...)
+    try
+    {
+      node.write(stringstream(contents));
+      return true;
+    }
+    catch(...)
+    {
+      return false;
+    }
+  });
+  myPendingWrites.push_back(std::move(write));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DebuggerParser::checkPendingWrites()
+{
+  for(auto it = myPendingWrites.begin(); it != myPendingWrites.end(); )
   {
-    result.str(red("Unable to append dump to file " + node.getShortPath()));
+    if(it->done.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
+      if(!it->done.get())
+        commandResult << red(it->errorMsg) << endl;
+      it = myPendingWrites.erase(it);
+    }
+    else
+      ++it;
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DebuggerParser::waitForPendingWrites()
+{
+  for(auto& write: myPendingWrites)
+    write.done.wait();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void DebuggerParser::executeDirective(Device::AccessType type)
 {
@@ -1025,6 +1139,36 @@ void DebuggerParser::executeColorTest()
                 << inverse("        ");
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "cpuTrace"
+void DebuggerParser::executeCpuTrace()
+{
+  M6502& cpu = debugger.m6502();
+  const CpuTrace* trace = cpu.cpuTrace();
+
+  if(trace && !argCount)
+  {
+    const uInt64 records = trace->records(), stalls = trace->stalls();
+
+    cpu.stopCpuTrace();
+    commandResult << "CPU trace stopped, " << std::dec << records << " instructions";
+    if(stalls)
+      commandResult << " (emulation waited " << stalls << " times for the writer)";
+    return;
+  }
+
+  ostringstream path;
+  if(argCount)
+    path << argStrings[0];
+  else
+    path << debugger.myOSystem.userDir() << cartName() << ".trace";
+
+  if(cpu.startCpuTrace(path.str()))
+    commandResult << "CPU trace started to " << path.str();
+  else
+    commandResult << red("unable to create trace file " + path.str());
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "d"
 void DebuggerParser::executeD()
@@ -1295,6 +1439,27 @@ void DebuggerParser::executeDump()
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "events"
+void DebuggerParser::executeEvents()
+{
+  EventCounters& counters = EventCounters::instance();
+  string what = argCount ? argStrings[0] : "";
+  BSPF::toLowerCase(what);
+
+  if(what == "on" || what == "off" || what == "reset")
+  {
+    counters.setEnabled(what == "on" || (what == "reset" && EventCounters::enabled()));
+    commandResult << "event counters " << (EventCounters::enabled() ? "enabled" : "disabled");
+  }
+  else if(what != "")
+    outputCommandError("invalid argument", myCommand);
+  else if(!EventCounters::enabled())
+    commandResult << "event counters disabled, use 'events on'";
+  else
+    commandResult << counters.toString();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "exec"
 void DebuggerParser::executeExec()
@@ -1345,6 +1510,20 @@ void DebuggerParser::executeFrame()
   commandResult << "advanced " << dec << count << " frame(s)";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "frameBack"
+void DebuggerParser::executeFrameBack()
+{
+  int count = 1;
+  if(argCount != 0) count = std::max(args[0], 1);
+
+  string message;
+  if(debugger.frameBack(count, message))
+    commandResult << message;
+  else
+    commandResult << red(message);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "function"
 void DebuggerParser::executeFunction()
@@ -1694,6 +1873,13 @@ void DebuggerParser::executeLogBreaks()
   commandResult << "logBreaks " << (enable ? "enabled" : "disabled");
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "memUsage"
+void DebuggerParser::executeMemUsage()
+{
+  commandResult << debugger.myOSystem.memoryUsage().toString();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "n"
 void DebuggerParser::executeN()
@@ -1739,6 +1925,223 @@ void DebuggerParser::executePrint()
   commandResult << eval();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "profile"
+void DebuggerParser::executeProfile()
+{
+  M6502& cpu = debugger.m6502();
+  const CpuProfiler* profiler = cpu.cpuProfiler();
+  string what = argCount ? argStrings[0] : "";
+  BSPF::toLowerCase(what);
+
+  if(what == "arm")
+  {
+    profileArm();
+    return;
+  }
+  if(what == "" || what == "fast" || what == "full")
+  {
+    if(what == "" && cpu.isProfiling())
+    {
+      cpu.stopCpuProfile();
+      commandResult << "profile stopped, " << std::dec << profiler->totalCycles()
+                    << " cycles recorded";
+    }
+    else
+    {
+      cpu.startCpuProfile(what == "fast" ? CpuProfiler::Mode::Fast
+                                         : CpuProfiler::Mode::Full);
+      commandResult << "profile started (" << (what == "fast" ? "fast" : "full")
+                    << " mode)";
+    }
+    return;
+  }
+
+  if(!profiler)
+  {
+    commandResult << red("no profile recorded");
+    return;
+  }
+  if(profiler->totalCycles() == 0)
+  {
+    commandResult << "no cycles recorded";
+    return;
+  }
+
+  const auto percent = [&](uInt64 cycles) {
+    ostringstream buf;
+    buf << std::fixed << std::setprecision(1)
+        << (cycles * 100.0 / profiler->totalCycles()) << "%";
+    return buf.str();
+  };
+
+  if(what == "hot")
+  {
+    const uInt32 max = argCount > 1 && args[1] > 0 ? args[1] : 20;
+
+    commandResult << "  cycles       %      count  address";
+    for(const auto& spot: profiler->hotSpots(max))
+    {
+      commandResult << endl << std::dec << setw(8) << setfill(' ') << right << spot.cycles
+                    << "  " << setw(6) << percent(spot.cycles)
+                    << "  " << setw(9) << spot.count << "  ";
+      commandResult << profileLocation(spot.bank, spot.addr);
+    }
+  }
+  else if(what == "banks")
+  {
+    commandResult << "  cycles       %  bank";
+    for(const auto& [bank, cycles]: profiler->bankCycles())
+    {
+      commandResult << endl << std::dec << setw(8) << setfill(' ') << right << cycles
+                    << "  " << setw(6) << percent(cycles) << "  ";
+      if(bank == CpuProfiler::NO_BANK)
+        commandResult << (profiler->mode() == CpuProfiler::Mode::Fast ? "(all)" : "(RAM)");
+      else
+        commandResult << bank;
+    }
+  }
+  else if(what == "save")
+  {
+    if(profiler->mode() != CpuProfiler::Mode::Full)
+    {
+      commandResult << red("call stacks are only recorded in full mode");
+      return;
+    }
+
+    stringstream out;
+    const uInt32 stacks = profiler->saveFoldedStacks(out,
+        [this](uInt16 bank, uInt16 addr) { return profileLocation(bank, addr); });
+
+    string file = argCount > 1 ? argStrings[1]
+                               : debugger.myOSystem.userDir().getPath() + cartName() + ".folded";
+    if(file.find_first_of(FilesystemNode::PATH_SEPARATOR) == string::npos)
+      file = debugger.myOSystem.userDir().getPath() + file;
+
+    FilesystemNode node(file);
+    writeInBackground(node, out.str(), "Unable to save profile to " + node.getShortPath());
+    commandResult << "saved " << std::dec << stacks << " call stacks to "
+                  << node.getShortPath();
+  }
+  else
+    outputCommandError("invalid argument", myCommand);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string DebuggerParser::profileLocation(uInt16 bank, uInt16 addr) const
+{
+  ostringstream buf;
+
+  buf << debugger.cartDebug().getLabel(addr, true, 4);
+  if(bank != CpuProfiler::NO_BANK)
+    buf << " (bank " << std::dec << bank << ")";
+
+  return buf.str();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DebuggerParser::profileArm()
+{
+  CartridgeARM* cart = debugger.myOSystem.console().cartridge().arm();
+  if(!cart)
+  {
+    commandResult << red("not an ARM cartridge");
+    return;
+  }
+
+  const ThumbProfiler* profiler = cart->armProfiler();
+  string what = argCount > 1 ? argStrings[1] : "";
+  BSPF::toLowerCase(what);
+
+  if(what == "")
+  {
+    if(cart->isArmProfiling())
+    {
+      cart->stopArmProfile();
+      commandResult << "ARM profile stopped, " << std::dec << profiler->totalCycles()
+                    << " cycles in " << profiler->frames() << " frames recorded";
+    }
+    else
+    {
+      cart->startArmProfile();
+      commandResult << "ARM profile started";
+    }
+    return;
+  }
+
+  if(!profiler)
+  {
+    commandResult << red("no ARM profile recorded");
+    return;
+  }
+  if(profiler->totalCycles() == 0)
+  {
+    commandResult << "no ARM cycles recorded";
+    return;
+  }
+
+  const uInt32 max = argCount > 2 && args[2] > 0 ? args[2] : 20;
+  const auto location = [](uInt32 addr) {
+    return addr == ThumbProfiler::NO_FUNCTION
+      ? string("(none)") : Common::Base::toString(addr, Common::Base::Fmt::_16_8);
+  };
+  const auto percent = [](uInt64 cycles, uInt64 total) {
+    ostringstream buf;
+    buf << std::fixed << std::setprecision(1) << (cycles * 100.0 / total) << "%";
+    return buf.str();
+  };
+  const auto listFunctions = [&](const vector<ThumbProfiler::Function>& functions,
+                                 uInt64 total) {
+    commandResult << "  cycles       %      calls  function";
+    for(uInt32 i = 0; i < functions.size() && i < max; ++i)
+    {
+      const ThumbProfiler::Function& func = functions[i];
+      commandResult << endl << std::dec << setw(8) << setfill(' ') << right << func.cycles
+                    << "  " << setw(6) << percent(func.cycles, total)
+                    << "  " << setw(9) << func.calls << "  " << location(func.addr);
+    }
+  };
+
+  if(what == "hot")
+  {
+    commandResult << "  cycles       %      count  address";
+    for(const auto& spot: profiler->hotSpots(max))
+      commandResult << endl << std::dec << setw(8) << setfill(' ') << right << spot.cycles
+                    << "  " << setw(6) << percent(spot.cycles, profiler->totalCycles())
+                    << "  " << setw(9) << spot.count << "  " << location(spot.addr);
+  }
+  else if(what == "funcs")
+    listFunctions(profiler->functions(max), profiler->totalCycles());
+  else if(what == "frame")
+  {
+    if(profiler->frames() == 0)
+    {
+      commandResult << "no frame finished yet";
+      return;
+    }
+    commandResult << "last frame " << std::dec << profiler->lastFrameCycles()
+                  << " cycles, peak " << profiler->peakFrameCycles() << " cycles" << endl;
+    listFunctions(profiler->lastFrame(), profiler->lastFrameCycles());
+  }
+  else if(what == "save")
+  {
+    stringstream out;
+    const uInt32 functions = profiler->save(out);
+
+    string file = argCount > 2 ? argStrings[2]
+                               : debugger.myOSystem.userDir().getPath() + cartName() + ".armprofile";
+    if(file.find_first_of(FilesystemNode::PATH_SEPARATOR) == string::npos)
+      file = debugger.myOSystem.userDir().getPath() + file;
+
+    FilesystemNode node(file);
+    writeInBackground(node, out.str(), "Unable to save ARM profile to " + node.getShortPath());
+    commandResult << "saved " << std::dec << functions << " ARM functions to "
+                  << node.getShortPath();
+  }
+  else
+    outputCommandError("invalid argument", myCommand);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "ram"
 void DebuggerParser::executeRam()
@@ -1749,6 +2152,111 @@ void DebuggerParser::executeRam()
     commandResult << debugger.setRAM(args);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "ramsearch"
+void DebuggerParser::executeRamSearch()
+{
+  using Compare = RamSearch::Compare;
+
+  string what = argCount ? argStrings[0] : "";
+  BSPF::toLowerCase(what);
+
+  ByteArray ram;
+  RamSearch::snapshot(debugger.myConsole, ram);
+
+  if(what == "" || what == "start")
+  {
+    myRamSearch.start(ram);
+    commandResult << "search started, " << std::dec << myRamSearch.count()
+                  << " locations";
+    return;
+  }
+  if(what == "list")
+  {
+    commandResult << ramSearchResults(argCount > 1 && args[1] > 0 ? args[1] : ~0U);
+    return;
+  }
+  if(what == "up" || what == "down")
+  {
+    // Find counters in the rewind states: locations whose value has
+    // changed, but only ever increased resp. decreased
+    const Compare compare = what == "up" ? Compare::NotDecreased : Compare::NotIncreased;
+    ByteArray first, state;
+    bool started = false;
+
+    const uInt32 states = debugger.myOSystem.state().rewindManager().visitStates(
+      [&]() {
+        RamSearch::snapshot(debugger.myConsole, state);
+        if(!started)
+        {
+          myRamSearch.start(state);
+          first = state;
+          started = true;
+        }
+        else
+          myRamSearch.filter(state, compare);
+      });
+    if(!states)
+    {
+      commandResult << red("no rewind states");
+      return;
+    }
+    myRamSearch.filter(ram, compare);
+    myRamSearch.filter(ram, Compare::Changed, 0, first);
+
+    commandResult << std::dec << states << " states searched, "
+                  << ramSearchResults(16);
+    return;
+  }
+
+  if(!myRamSearch.active())
+    myRamSearch.start(ram);
+
+  static const std::map<string, Compare> VALUE_COMPARES = {
+    { "eq", Compare::Equal }, { "ne", Compare::NotEqual },
+    { "gt", Compare::Greater }, { "lt", Compare::Less },
+    { "add", Compare::ChangedBy }, { "sub", Compare::ChangedBy }
+  };
+  static const std::map<string, Compare> COMPARES = {
+    { "changed", Compare::Changed }, { "same", Compare::Unchanged },
+    { "inc", Compare::Increased }, { "dec", Compare::Decreased }
+  };
+
+  if(const auto it = VALUE_COMPARES.find(what); it != VALUE_COMPARES.end())
+  {
+    if(argCount < 2)
+    {
+      outputCommandError("missing value", myCommand);
+      return;
+    }
+    myRamSearch.filter(ram, it->second, what == "sub" ? -args[1] : args[1]);
+  }
+  else if(const auto it2 = COMPARES.find(what); it2 != COMPARES.end())
+    myRamSearch.filter(ram, it2->second);
+  else
+  {
+    outputCommandError("invalid argument", myCommand);
+    return;
+  }
+
+  commandResult << ramSearchResults(16);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string DebuggerParser::ramSearchResults(uInt32 max)
+{
+  ostringstream buf;
+
+  buf << std::dec << myRamSearch.count() << " candidates";
+  for(const Int32 index: myRamSearch.candidates(max))
+    buf << endl << "  " << RamSearch::location(index) << " = $"
+        << Base::HEX2 << int(myRamSearch.previous(index));
+  if(myRamSearch.count() > max)
+    buf << endl << "  ...";
+
+  return buf.str();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "reset"
 void DebuggerParser::executeReset()
@@ -1818,6 +2326,17 @@ void DebuggerParser::executeRun()
   commandResult << "_EXIT_DEBUGGER";  // See PromptWidget for more info
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "runBack"
+void DebuggerParser::executeRunBack()
+{
+  string message;
+  if(debugger.runBack(message))
+    commandResult << message;
+  else
+    commandResult << red(message);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "runTo"
 void DebuggerParser::executeRunTo()
@@ -1871,42 +2390,57 @@ void DebuggerParser::executeRunTo()
 // "runToPc"
 void DebuggerParser::executeRunToPc()
 {
-  const CartDebug& cartdbg = debugger.cartDebug();
-  const CartDebug::DisassemblyList& list = cartdbg.disassembly().list;
+  const uInt16 pc = args[0];
 
   debugger.saveOldState();
 
-  uInt32 count = 0;
-  bool done = false;
-  // Create a progress dialog box to show the progress searching through the
-  // disassembly, since this may be a time-consuming operation
-  ostringstream buf;
-  ProgressDialog progress(debugger.baseDialog(), debugger.lfont());
+  // The PC must be reached by at least one instruction
+  uInt64 startCycle = debugger.mySystem.cycles();
+  debugger.step(false);
+  bool done = debugger.cpuDebug().pc() == pc;
 
-  buf << "        runTo PC running" << progress.ELLIPSIS << "        ";
-  progress.setMessage(buf.str());
-  progress.setRange(0, 100000, 5);
-  progress.open();
-
-  do {
-    debugger.step(false);
-
-    // Update romlist to point to current PC
-    int pcline = cartdbg.addressToLine(debugger.cpuDebug().pc());
-    done = (pcline >= 0) && (list[pcline].address == args[0]);
-    progress.incProgress();
-    ++count;
-  } while(!done && !progress.isCancelled());
-  progress.close();
+  if(!done)
+  {
+    // Create a progress dialog box to show the progress, since this may be
+    // a time-consuming operation
+    ostringstream buf;
+    ProgressDialog progress(debugger.baseDialog(), debugger.lfont());
+
+    buf << "        runTo PC running" << progress.ELLIPSIS << "        ";
+    progress.setMessage(buf.str());
+    progress.setRange(0, 60, 5);
+    progress.open();
+
+    // Instead of stepping (and checking) each instruction, let the CPU
+    // stop at a temporary breakpoint on the PC, or at any other one
+    const bool temporary = !debugger.checkBreakPoint(pc, BreakpointMap::ANY_BANK);
+    if(temporary)
+      debugger.setBreakPoint(pc, BreakpointMap::ANY_BANK, BreakpointMap::ONE_SHOT);
+
+    // Run one frame at a time and update the progress in between
+    const uInt32 frameCycles = debugger.myOSystem.console().emulationTiming().cyclesPerFrame();
+    bool stopped = false;
+    do {
+      stopped = debugger.runUntilBreak(frameCycles);
+      progress.incProgress();
+    } while(!stopped && !progress.isCancelled());
+    progress.close();
+
+    if(temporary)
+      debugger.clearBreakPoint(pc, BreakpointMap::ANY_BANK);
+
+    done = debugger.cpuDebug().pc() == pc;
+  }
 
   if(done)
     commandResult
-      << "Set PC to $" << Base::HEX4 << args[0] << " in "
-      << dec << count << " instructions";
+      << "Set PC to $" << Base::HEX4 << pc << " in "
+      << dec << (debugger.mySystem.cycles() - startCycle) << " cycles";
   else
     commandResult
-      << "PC $" << Base::HEX4 << args[0] << " not reached or found in "
-      << dec << count << " instructions";
+      << "PC $" << Base::HEX4 << pc << " not reached, stopped at $"
+      << Base::HEX4 << debugger.cpuDebug().pc() << " after "
+      << dec << (debugger.mySystem.cycles() - startCycle) << " cycles";
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -2120,6 +2654,20 @@ void DebuggerParser::executeScanLine()
   commandResult << "advanced " << dec << count << " scanLine(s)";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "scanLineBack"
+void DebuggerParser::executeScanLineBack()
+{
+  int count = 1;
+  if(argCount != 0) count = std::max(args[0], 1);
+
+  string message;
+  if(debugger.scanlineBack(count, message))
+    commandResult << message;
+  else
+    commandResult << red(message);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "step"
 void DebuggerParser::executeStep()
@@ -2128,6 +2676,20 @@ void DebuggerParser::executeStep()
     << "executed " << dec << debugger.step() << " cycles";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "stepBack"
+void DebuggerParser::executeStepBack()
+{
+  int count = 1;
+  if(argCount != 0) count = std::max(args[0], 1);
+
+  string message;
+  if(debugger.stepBack(count, message))
+    commandResult << message;
+  else
+    commandResult << red(message);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "stepWhile"
 void DebuggerParser::executeStepWhile()
@@ -2713,6 +3275,19 @@ DebuggerParser::CommandArray DebuggerParser::commands = { {
     std::mem_fn(&DebuggerParser::executeColorTest)
   },
 
+  {
+    "cpuTrace",
+    "Start/stop binary trace of all instructions [to file xx]",
+    "Toggles the trace, which records (cycles, frame, scanline, bank, PC,\n"
+    "registers, last data read and write) for every instruction\n"
+    "Example: cpuTrace, cpuTrace game.trace\n"
+    "NOTE: traces to user dir by default, convert with 'stella -tracetotext'",
+    false,
+    false,
+    { Parameters::ARG_FILE, Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeCpuTrace)
+  },
+
   {
     "d",
     "Decimal Flag: set (0 or 1), or toggle (no arg)",
@@ -2829,6 +3404,19 @@ DebuggerParser::CommandArray DebuggerParser::commands = { {
     std::mem_fn(&DebuggerParser::executeDump)
   },
 
+  {
+    "events",
+    "Show/enable/disable/reset event counters",
+    "Counts costly emulation events (bankswitches, ARM calls, HMOVEs, ...)\n"
+    "per frame. 'on' and 'off' enable and disable counting, 'reset'\n"
+    "restarts it\n"
+    "Example: events, events on, events reset",
+    false,
+    false,
+    { Parameters::ARG_LABEL, Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeEvents)
+  },
+
   {
     "exec",
     "Execute script file <xx> [prefix]",
@@ -2859,6 +3447,17 @@ DebuggerParser::CommandArray DebuggerParser::commands = { {
     std::mem_fn(&DebuggerParser::executeFrame)
   },
 
+  {
+    "frameBack",
+    "Move emulation back by <xx> frames (default=1)",
+    "Replays the emulation from an earlier checkpoint\n"
+    "Example: frameBack, frameBack 10",
+    false,
+    true,
+    { Parameters::ARG_WORD, Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeFrameBack)
+  },
+
   {
     "function",
     "Define function name xx for expression yy",
@@ -3090,6 +3689,16 @@ DebuggerParser::CommandArray DebuggerParser::commands = { {
     std::mem_fn(&DebuggerParser::executeLogBreaks)
   },
 
+  {
+    "memUsage",
+    "Show memory used by the console and frontend",
+    "Example: memUsage (no parameters)",
+    false,
+    false,
+    { Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeMemUsage)
+  },
+
   {
     "n",
     "Negative Flag: set (0 or 1), or toggle (no arg)",
@@ -3151,6 +3760,25 @@ DebuggerParser::CommandArray DebuggerParser::commands = { {
     std::mem_fn(&DebuggerParser::executePrint)
   },
 
+  {
+    "profile",
+    "Start/stop cycle profile, or show/save results",
+    "Counts the cycles of all instructions, per address (fast) or per bank\n"
+    "and call stack (full, default). 'hot [xx]' lists the xx (default 20)\n"
+    "slowest addresses, 'banks' the cycles per bank, 'save [file]' writes\n"
+    "the call stacks for flame graphs\n"
+    "'arm' profiles the ARM code of the cart instead, with 'hot [xx]',\n"
+    "'funcs [xx]' (cycles per BL target), 'frame [xx]' (functions of the\n"
+    "last frame) and 'save [file]'\n"
+    "Example: profile, profile fast, profile hot 10, profile save,\n"
+    "  profile arm, profile arm frame\n"
+    "NOTE: saves to user dir by default",
+    false,
+    false,
+    { Parameters::ARG_LABEL, Parameters::ARG_MULTI_BYTE },
+    std::mem_fn(&DebuggerParser::executeProfile)
+  },
+
   {
     "ram",
     "Show ZP RAM, or set address xx to yy1 [yy2 ...]",
@@ -3161,6 +3789,21 @@ DebuggerParser::CommandArray DebuggerParser::commands = { {
     std::mem_fn(&DebuggerParser::executeRam)
   },
 
+  {
+    "ramsearch",
+    "Search RIOT and cart RAM for changing values",
+    "Without argument (or 'start'), starts a new search. Then narrows the\n"
+    "candidates down by comparing the current RAM with a value ('eq', 'ne',\n"
+    "'gt', 'lt' xx) or with the previous search ('changed', 'same', 'inc',\n"
+    "'dec', 'add' xx, 'sub' xx). 'up'/'down' find counters in the rewind\n"
+    "states, which only increased/decreased. 'list [xx]' shows candidates\n"
+    "Example: ramsearch, ramsearch eq 3, ramsearch dec, ramsearch up",
+    false,
+    false,
+    { Parameters::ARG_LABEL, Parameters::ARG_MULTI_BYTE },
+    std::mem_fn(&DebuggerParser::executeRamSearch)
+  },
+
   {
     "reset",
     "Reset system to power-on state",
@@ -3222,6 +3865,17 @@ DebuggerParser::CommandArray DebuggerParser::commands = { {
     std::mem_fn(&DebuggerParser::executeRun)
   },
 
+  {
+    "runBack",
+    "Move emulation back to the last breakpoint/trap hit",
+    "Searches the history backwards for where the emulation would have stopped\n"
+    "Example: runBack",
+    false,
+    true,
+    { Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeRunBack)
+  },
+
   {
     "runTo",
     "Run until string xx in disassembly",
@@ -3369,6 +4023,16 @@ DebuggerParser::CommandArray DebuggerParser::commands = { {
     std::mem_fn(&DebuggerParser::executeScanLine)
   },
 
+  {
+    "scanLineBack",
+    "Move emulation back by <xx> scanlines (default=1)",
+    "Example: scanLineBack, scanLineBack 10",
+    false,
+    true,
+    { Parameters::ARG_WORD, Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeScanLineBack)
+  },
+
   {
     "step",
     "Single step CPU [with count xx]",
@@ -3379,6 +4043,16 @@ DebuggerParser::CommandArray DebuggerParser::commands = { {
     std::mem_fn(&DebuggerParser::executeStep)
   },
 
+  {
+    "stepBack",
+    "Single step CPU back [with count xx]",
+    "Example: stepBack, stepBack 10",
+    false,
+    true,
+    { Parameters::ARG_WORD, Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeStepBack)
+  },
+
   {
     "stepWhile",
     "Single step CPU while <condition> is true",
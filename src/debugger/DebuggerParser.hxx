@@ -19,6 +19,8 @@
 #define DEBUGGER_PARSER_HXX
 
 #include <functional>
+#include <future>
+#include <map>
 #include <set>
 
 class Debugger;
@@ -28,6 +30,7 @@ struct Command;
 
 #include "bspf.hxx"
 #include "Device.hxx"
+#include "RamSearch.hxx"
 
 class DebuggerParser
 {
@@ -60,14 +63,54 @@ class DebuggerParser
       return "\177" + msg;
     }
 
+  private:
+    // A script line, already split into the command and its arguments
+    struct ScriptLine {
+      string command;         // the original line, for the prompt history
+      int cmd{-1};            // index into 'commands', -1 if not found
+      StringList argStrings;  // the (not yet evaluated) arguments
+    };
+    struct Script {
+      uInt64 size{0};
+      uInt64 mtime{0};
+      vector<ScriptLine> lines;
+    };
+
+    // A file write running on a background thread
+    struct PendingWrite {
+      string path;
+      string errorMsg;
+      std::future<bool> done;
+    };
+
   private:
     bool getArgs(const string& command, string& verb);
+    static void tokenize(const string& command, string& verb, StringList& tokens);
+    void evaluateArgs();
+    static int findCommand(const string& verb);
+    string runCommand(int cmd);
     bool validateArgs(int cmd);
     string eval();
+
+    /** Load the given script, reusing the cached lines if it is unchanged */
+    shared_ptr<const Script> loadScript(const FilesystemNode& file);
+
     string saveScriptFile(string file);
     void saveDump(const FilesystemNode& node, const stringstream& out,
                   ostringstream& result);
+
+    /**
+      Write 'contents' to 'node' on a background thread.  Should this fail,
+      'errorMsg' is reported with the output of a following command.
+    */
+    void writeInBackground(const FilesystemNode& node, string contents,
+                           const string& errorMsg);
+    void checkPendingWrites();
+    void waitForPendingWrites();
     const string& cartName() const;
+    string profileLocation(uInt16 bank, uInt16 addr) const;
+    void profileArm();
+    string ramSearchResults(uInt32 max);
 
   private:
     // Constants for argument processing
@@ -101,7 +144,7 @@ class DebuggerParser
       std::array<Parameters, 10> parms;
       std::function<void (DebuggerParser*)> executor;
     };
-    using CommandArray = std::array<Command, 103>;
+    using CommandArray = std::array<Command, 112>;
     static CommandArray commands;
 
     struct Trap
@@ -135,8 +178,19 @@ class DebuggerParser
     uInt32 execDepth{0};
     string execPrefix;
 
+    // Parsed script files, keyed by their path (and checked by size and
+    // modification time), so that e.g. 'autoexec' scripts are only parsed once
+    std::map<string, shared_ptr<const Script>> myScriptCache;
+
+    // Background file writes not yet checked for errors; a future returned
+    // by std::async waits for its write to finish when destroyed
+    vector<PendingWrite> myPendingWrites;
+
     StringList myWatches;
 
+    // The state of the 'ramsearch' command
+    RamSearch myRamSearch;
+
     // Keep track of traps (read and/or write)
     vector<unique_ptr<Trap>> myTraps;
     void listTraps(bool listCond);
@@ -168,6 +222,7 @@ class DebuggerParser
     void executeCode();
     void executeCol();
     void executeColorTest();
+    void executeCpuTrace();
     void executeD();
     void executeData();
     void executeDebugColors();
@@ -179,9 +234,11 @@ class DebuggerParser
     void executeDelWatch();
     void executeDisAsm();
     void executeDump();
+    void executeEvents();
     void executeExec();
     void executeExitRom();
     void executeFrame();
+    void executeFrameBack();
     void executeFunction();
     void executeGfx();
     void executeHelp();
@@ -205,19 +262,23 @@ class DebuggerParser
     void executeLoadConfig();
     void executeLoadState();
     void executeLogBreaks();
+    void executeMemUsage();
     void executeN();
     void executePalette();
     void executePc();
     void executePCol();
     void executePGfx();
     void executePrint();
+    void executeProfile();
     void executeRam();
+    void executeRamSearch();
     void executeReset();
     void executeRewind();
     void executeRiot();
     void executeRom();
     void executeRow();
     void executeRun();
+    void executeRunBack();
     void executeRunTo();
     void executeRunToPc();
     void executeS();
@@ -232,7 +293,9 @@ class DebuggerParser
     void executeSaveState();
     void executeSaveStateIf();
     void executeScanLine();
+    void executeScanLineBack();
     void executeStep();
+    void executeStepBack();
     void executeStepWhile();
     void executeTia();
     void executeTrace();
@@ -72,7 +72,7 @@ DiStella::DiStella(const CartDebug& dbg, CartDebug::DisassemblyList& list,
   disasm(myOffset, 2);
 
   // Add reserved line equates
-  ostringstream reservedLabel;
+  LineBuffer reservedLabel;
   for (int k = 0; k <= myAppData.end; k++) {
     if ((myLabels[k] & (Device::REFERENCED | Device::VALID_ENTRY)) == Device::REFERENCED) {
       // If we have a piece of code referenced somewhere else, but cannot
@@ -81,8 +81,8 @@ DiStella::DiStella(const CartDebug& dbg, CartDebug::DisassemblyList& list,
       //
       // However, we only do this for labels pointing to ROM (above $1000)
       if (myDbg.addressType(k + myOffset) == CartDebug::AddrType::ROM) {
-        reservedLabel.str("");
-        reservedLabel << "L" << Base::HEX4 << (k + myOffset);
+        reservedLabel.clear();
+        reservedLabel << "L" << hex4(k + myOffset);
         myReserved.Label.emplace(k + myOffset, reservedLabel.str());
       }
     }
@@ -109,11 +109,11 @@ void DiStella::disasm(uInt32 distart, int pass)
   Int32 cycles = 0;
   AddressingMode addrMode;
   AddressType labelFound = AddressType::INVALID;
-  stringstream nextLine, nextLineBytes;
+  LineBuffer nextLine, nextLineBytes;
 
   mySegType = Device::NONE; // create extra lines between code and data
 
-  myDisasmBuf.str("");
+  myDisasmBuf.clear();
 
   /* pc=myAppData.start; */
   myPC = distart - myOffset;
@@ -201,9 +201,9 @@ void DiStella::disasm(uInt32 distart, int pass)
 
       if(pass == 3) {
         if(checkBit(myPC, Device::REFERENCED))
-          myDisasmBuf << Base::HEX4 << myPC + myOffset << "'L" << Base::HEX4 << myPC + myOffset << "'";
+          myDisasmBuf << hex4(myPC + myOffset) << "'L" << hex4(myPC + myOffset) << "'";
         else
-          myDisasmBuf << Base::HEX4 << myPC + myOffset << "'     '";
+          myDisasmBuf << hex4(myPC + myOffset) << "'     '";
       }
       ++myPC;
 
@@ -223,15 +223,15 @@ void DiStella::disasm(uInt32 distart, int pass)
             Uint8 nextOpcode = Debugger::debugger().peek(myPC + myOffset);
 
             cycles += int(ourLookup[opcode].cycles) - int(ourLookup[nextOpcode].cycles);
-            nextLine << ".byte   $" << Base::HEX2 << int(opcode) << " ;";
+            nextLine << ".byte   $" << hex2(opcode) << " ;";
             nextLine << ourLookup[opcode].mnemonic;
 
             myDisasmBuf << nextLine.str() << "'" << ";"
-              << std::dec << int(ourLookup[opcode].cycles) << "-"
-              << std::dec << int(ourLookup[nextOpcode].cycles) << " "
-              << "'= " << std::setw(3) << std::setfill(' ') << std::dec << cycles;
+              << dec(ourLookup[opcode].cycles) << "-"
+              << dec(ourLookup[nextOpcode].cycles) << " "
+              << "'= " << dec(cycles, 3);
 
-            nextLine.str("");
+            nextLine.clear();
             cycles = 0;
             addEntry(Device::CODE); // add the new found CODE entry
           }
@@ -248,12 +248,12 @@ void DiStella::disasm(uInt32 distart, int pass)
       // Undefined opcodes start with a '.'
       // These are undefined wrt DASM
       if(ourLookup[opcode].mnemonic[0] == '.' && pass == 3) {
-        nextLine << ".byte   $" << Base::HEX2 << int(opcode) << " ;";
+        nextLine << ".byte   $" << hex2(opcode) << " ;";
       }
 
       if(pass == 3) {
         nextLine << ourLookup[opcode].mnemonic;
-        nextLineBytes << Base::HEX2 << int(opcode) << " ";
+        nextLineBytes << hex2(opcode) << " ";
       }
 
       // Add operand(s) for PC values outside the app data range
@@ -270,21 +270,21 @@ void DiStella::disasm(uInt32 distart, int pass)
               /* Line information is already printed; append .byte since last
                  instruction will put recompilable object larger that original
                  binary file */
-              myDisasmBuf << ".byte $" << Base::HEX2 << int(opcode) << "              $"
-                << Base::HEX4 << myPC + myOffset << "'"
-                << Base::HEX2 << int(opcode);
+              myDisasmBuf << ".byte $" << hex2(opcode) << "              $"
+                << hex4(myPC + myOffset) << "'"
+                << hex2(opcode);
               addEntry(Device::DATA);
 
               if(myPC == myAppData.end) {
                 if(checkBit(myPC, Device::REFERENCED))
-                  myDisasmBuf << Base::HEX4 << myPC + myOffset << "'L" << Base::HEX4 << myPC + myOffset << "'";
+                  myDisasmBuf << hex4(myPC + myOffset) << "'L" << hex4(myPC + myOffset) << "'";
                 else
-                  myDisasmBuf << Base::HEX4 << myPC + myOffset << "'     '";
+                  myDisasmBuf << hex4(myPC + myOffset) << "'     '";
 
                 opcode = Debugger::debugger().peek(myPC + myOffset);  ++myPC;
-                myDisasmBuf << ".byte $" << Base::HEX2 << int(opcode) << "              $"
-                  << Base::HEX4 << myPC + myOffset << "'"
-                  << Base::HEX2 << int(opcode);
+                myDisasmBuf << ".byte $" << hex2(opcode) << "              $"
+                  << hex4(myPC + myOffset) << "'"
+                  << hex2(opcode);
                 addEntry(Device::DATA);
               }
             }
@@ -301,10 +301,10 @@ void DiStella::disasm(uInt32 distart, int pass)
             if(pass == 3) {
               /* Line information is already printed, but we can remove the
                   Instruction (i.e. BMI) by simply clearing the buffer to print */
-              myDisasmBuf << ".byte $" << Base::HEX2 << int(opcode);
+              myDisasmBuf << ".byte $" << hex2(opcode);
               addEntry(Device::ROW);
-              nextLine.str("");
-              nextLineBytes.str("");
+              nextLine.clear();
+              nextLineBytes.clear();
             }
             ++myPC;
             myPCEnd = myAppData.end + myOffset;
@@ -339,22 +339,22 @@ void DiStella::disasm(uInt32 distart, int pass)
 
             if(labelFound == AddressType::ROM) {
               LABEL_A12_HIGH(ad);
-              nextLineBytes << Base::HEX2 << int(ad & 0xff) << " " << Base::HEX2 << int(ad >> 8);
+              nextLineBytes << hex2(ad & 0xff) << " " << hex2(ad >> 8);
             }
             else if(labelFound == AddressType::ROM_MIRROR) {
               if(mySettings.rFlag) {
                 int tmp = (ad & myAppData.end) + myOffset;
                 LABEL_A12_HIGH(tmp);
-                nextLineBytes << Base::HEX2 << int(tmp & 0xff) << " " << Base::HEX2 << int(tmp >> 8);
+                nextLineBytes << hex2(tmp & 0xff) << " " << hex2(tmp >> 8);
               }
               else {
-                nextLine << "$" << Base::HEX4 << ad;
-                nextLineBytes << Base::HEX2 << int(ad & 0xff) << " " << Base::HEX2 << int(ad >> 8);
+                nextLine << "$" << hex4(ad);
+                nextLineBytes << hex2(ad & 0xff) << " " << hex2(ad >> 8);
               }
             }
             else {
               LABEL_A12_LOW(ad);
-              nextLineBytes << Base::HEX2 << int(ad & 0xff) << " " << Base::HEX2 << int(ad >> 8);
+              nextLineBytes << hex2(ad & 0xff) << " " << hex2(ad >> 8);
             }
           }
           break;
@@ -367,7 +367,7 @@ void DiStella::disasm(uInt32 distart, int pass)
           if(pass == 3) {
             nextLine << "     ";
             LABEL_A12_LOW(int(d1));
-            nextLineBytes << Base::HEX2 << int(d1);
+            nextLineBytes << hex2(d1);
           }
           break;
         }
@@ -376,8 +376,8 @@ void DiStella::disasm(uInt32 distart, int pass)
         {
           d1 = Debugger::debugger().peek(myPC + myOffset);  ++myPC;
           if(pass == 3) {
-            nextLine << "     #$" << Base::HEX2 << int(d1) << " ";
-            nextLineBytes << Base::HEX2 << int(d1);
+            nextLine << "     #$" << hex2(d1) << " ";
+            nextLineBytes << hex2(d1);
           }
           break;
         }
@@ -402,24 +402,24 @@ void DiStella::disasm(uInt32 distart, int pass)
             if(labelFound == AddressType::ROM) {
               LABEL_A12_HIGH(ad);
               nextLine << ",x";
-              nextLineBytes << Base::HEX2 << int(ad & 0xff) << " " << Base::HEX2 << int(ad >> 8);
+              nextLineBytes << hex2(ad & 0xff) << " " << hex2(ad >> 8);
             }
             else if(labelFound == AddressType::ROM_MIRROR) {
               if(mySettings.rFlag) {
                 int tmp = (ad & myAppData.end) + myOffset;
                 LABEL_A12_HIGH(tmp);
                 nextLine << ",x";
-                nextLineBytes << Base::HEX2 << int(tmp & 0xff) << " " << Base::HEX2 << int(tmp >> 8);
+                nextLineBytes << hex2(tmp & 0xff) << " " << hex2(tmp >> 8);
               }
               else {
-                nextLine << "$" << Base::HEX4 << ad << ",x";
-                nextLineBytes << Base::HEX2 << int(ad & 0xff) << " " << Base::HEX2 << int(ad >> 8);
+                nextLine << "$" << hex4(ad) << ",x";
+                nextLineBytes << hex2(ad & 0xff) << " " << hex2(ad >> 8);
               }
             }
             else {
               LABEL_A12_LOW(ad);
               nextLine << ",x";
-              nextLineBytes << Base::HEX2 << int(ad & 0xff) << " " << Base::HEX2 << int(ad >> 8);
+              nextLineBytes << hex2(ad & 0xff) << " " << hex2(ad >> 8);
             }
           }
           break;
@@ -445,24 +445,24 @@ void DiStella::disasm(uInt32 distart, int pass)
             if(labelFound == AddressType::ROM) {
               LABEL_A12_HIGH(ad);
               nextLine << ",y";
-              nextLineBytes << Base::HEX2 << int(ad & 0xff) << " " << Base::HEX2 << int(ad >> 8);
+              nextLineBytes << hex2(ad & 0xff) << " " << hex2(ad >> 8);
             }
             else if(labelFound == AddressType::ROM_MIRROR) {
               if(mySettings.rFlag) {
                 int tmp = (ad & myAppData.end) + myOffset;
                 LABEL_A12_HIGH(tmp);
                 nextLine << ",y";
-                nextLineBytes << Base::HEX2 << int(tmp & 0xff) << " " << Base::HEX2 << int(tmp >> 8);
+                nextLineBytes << hex2(tmp & 0xff) << " " << hex2(tmp >> 8);
               }
               else {
-                nextLine << "$" << Base::HEX4 << ad << ",y";
-                nextLineBytes << Base::HEX2 << int(ad & 0xff) << " " << Base::HEX2 << int(ad >> 8);
+                nextLine << "$" << hex4(ad) << ",y";
+                nextLineBytes << hex2(ad & 0xff) << " " << hex2(ad >> 8);
               }
             }
             else {
               LABEL_A12_LOW(ad);
               nextLine << ",y";
-              nextLineBytes << Base::HEX2 << int(ad & 0xff) << " " << Base::HEX2 << int(ad >> 8);
+              nextLineBytes << hex2(ad & 0xff) << " " << hex2(ad >> 8);
             }
           }
           break;
@@ -476,7 +476,7 @@ void DiStella::disasm(uInt32 distart, int pass)
             nextLine << "     (";
             LABEL_A12_LOW(d1);
             nextLine << ",x)";
-            nextLineBytes << Base::HEX2 << int(d1);
+            nextLineBytes << hex2(d1);
           }
           break;
         }
@@ -489,7 +489,7 @@ void DiStella::disasm(uInt32 distart, int pass)
             nextLine << "     (";
             LABEL_A12_LOW(d1);
             nextLine << "),y";
-            nextLineBytes << Base::HEX2 << int(d1);
+            nextLineBytes << hex2(d1);
           }
           break;
         }
@@ -503,7 +503,7 @@ void DiStella::disasm(uInt32 distart, int pass)
             LABEL_A12_LOW(d1);
             nextLine << ",x";
           }
-          nextLineBytes << Base::HEX2 << int(d1);
+          nextLineBytes << hex2(d1);
           break;
         }
 
@@ -516,7 +516,7 @@ void DiStella::disasm(uInt32 distart, int pass)
             LABEL_A12_LOW(d1);
             nextLine << ",y";
           }
-          nextLineBytes << Base::HEX2 << int(d1);
+          nextLineBytes << hex2(d1);
           break;
         }
 
@@ -535,9 +535,9 @@ void DiStella::disasm(uInt32 distart, int pass)
               LABEL_A12_HIGH(ad);
             }
             else
-              nextLine << "     $" << Base::HEX4 << ad;
+              nextLine << "     $" << hex4(ad);
 
-            nextLineBytes << Base::HEX2 << int(d1);
+            nextLineBytes << hex2(d1);
           }
           break;
         }
@@ -581,7 +581,7 @@ void DiStella::disasm(uInt32 distart, int pass)
             nextLine << ")";
           }
 
-          nextLineBytes << Base::HEX2 << int(ad & 0xff) << " " << Base::HEX2 << int(ad >> 8);
+          nextLineBytes << hex2(ad & 0xff) << " " << hex2(ad >> 8);
           break;
         }
 
@@ -593,14 +593,14 @@ void DiStella::disasm(uInt32 distart, int pass)
         cycles += int(ourLookup[opcode].cycles);
         // A complete line of disassembly (text, cycle count, and bytes)
         myDisasmBuf << nextLine.str() << "'"
-          << ";" << std::dec << int(ourLookup[opcode].cycles)
+          << ";" << dec(ourLookup[opcode].cycles)
           << (addrMode == AddressingMode::RELATIVE ? (ad & 0xf00) != ((myPC + myOffset) & 0xf00) ? "/3!" : "/3 " : "   ");
         if((opcode == 0x40 || opcode == 0x60 || opcode == 0x4c || opcode == 0x00 // code block end
            || checkBit(myPC, Device::REFERENCED)                              // referenced address
            || (ourLookup[opcode].rw_mode == RWMode::WRITE && d1 == WSYNC))       // strobe WSYNC
            && cycles > 0) {
          // output cycles for previous code block
-          myDisasmBuf << "'= " << std::setw(3) << std::setfill(' ') << std::dec << cycles;
+          myDisasmBuf << "'= " << dec(cycles, 3);
           cycles = 0;
         }
         else {
@@ -615,8 +615,8 @@ void DiStella::disasm(uInt32 distart, int pass)
           mySegType = Device::NONE; // prevent extra lines if data follows
         }
 
-        nextLine.str("");
-        nextLineBytes.str("");
+        nextLine.clear();
+        nextLineBytes.clear();
       }
     } // CODE
   } /* while loop */
@@ -1013,29 +1013,30 @@ bool DiStella::check_range(uInt16 beg, uInt16 end) const
 void DiStella::addEntry(Device::AccessType type)
 {
   CartDebug::DisassemblyTag tag;
+  const string& line = myDisasmBuf.str();
 
   // Type
   tag.type = type;
 
   // Address
-  myDisasmBuf.seekg(0, std::ios::beg);
-  if (myDisasmBuf.peek() == ' ')
+  if (line.empty() || line[0] == ' ')
     tag.address = 0;
   else
-    myDisasmBuf >> std::setw(4) >> std::hex >> tag.address;
+    tag.address = parseHex(line, 0);
 
   // Only include addresses within the requested range
   if (tag.address < myAppData.start)
     goto DONE_WITH_ADD;
 
   // Label (a user-defined label always overrides any auto-generated one)
-  myDisasmBuf.seekg(5, std::ios::beg);
   if (tag.address) {
     tag.label = myDbg.getLabel(tag.address, true);
     tag.hllabel = true;
     if (tag.label == EmptyString) {
-      if (myDisasmBuf.peek() != ' ')
-        getline(myDisasmBuf, tag.label, '\'');
+      if (line.size() > 5 && line[5] != ' ') {
+        size_t pos = 5;
+        tag.label = nextField(line, pos);
+      }
       else if (mySettings.showAddresses && tag.type == Device::CODE) {
         // Have addresses indented, to differentiate from actual labels
         tag.label = " " + Base::toString(tag.address, Base::Fmt::_16_4);
@@ -1047,51 +1048,120 @@ void DiStella::addEntry(Device::AccessType type)
   // Disassembly
   // Up to this point the field sizes are fixed, until we get to
   // variable length labels, cycle counts, etc
-  myDisasmBuf.seekg(11, std::ios::beg);
-  switch (tag.type) {
-    case Device::CODE:
-      getline(myDisasmBuf, tag.disasm, '\'');
-      getline(myDisasmBuf, tag.ccount, '\'');
-      getline(myDisasmBuf, tag.ctotal, '\'');
-      getline(myDisasmBuf, tag.bytes);
-
-      // Make note of when we override CODE sections from the debugger
-      // It could mean that the code hasn't been accessed up to this point,
-      // but it could also indicate that code will *never* be accessed
-      // Since it is impossible to tell the difference, marking the address
-      // in the disassembly at least tells the user about it
-      if (!(Debugger::debugger().getAccessFlags(tag.address) & Device::CODE)
-          && myOffset != 0) {
-        tag.ccount += " *";
-        Debugger::debugger().setAccessFlags(tag.address, Device::TCODE);
-      }
-      break;
-
-    case Device::GFX:
-    case Device::PGFX:
-    case Device::COL:
-    case Device::PCOL:
-    case Device::BCOL:
-    case Device::DATA:
-    case Device::AUD:
-      getline(myDisasmBuf, tag.disasm, '\'');
-      getline(myDisasmBuf, tag.bytes);
-      break;
-
-    case Device::ROW:
-      getline(myDisasmBuf, tag.disasm);
-      break;
-
-    case Device::NONE:
-    default:  // should never happen
-      tag.disasm = " ";
-      break;
+  {
+    size_t pos = 11;
+    switch (tag.type) {
+      case Device::CODE:
+        tag.disasm = nextField(line, pos);
+        tag.ccount = nextField(line, pos);
+        tag.ctotal = nextField(line, pos);
+        tag.bytes = nextField(line, pos, false);
+
+        // Make note of when we override CODE sections from the debugger
+        // It could mean that the code hasn't been accessed up to this point,
+        // but it could also indicate that code will *never* be accessed
+        // Since it is impossible to tell the difference, marking the address
+        // in the disassembly at least tells the user about it
+        if (!(Debugger::debugger().getAccessFlags(tag.address) & Device::CODE)
+            && myOffset != 0) {
+          tag.ccount += " *";
+          Debugger::debugger().setAccessFlags(tag.address, Device::TCODE);
+        }
+        break;
+
+      case Device::GFX:
+      case Device::PGFX:
+      case Device::COL:
+      case Device::PCOL:
+      case Device::BCOL:
+      case Device::DATA:
+      case Device::AUD:
+        tag.disasm = nextField(line, pos);
+        tag.bytes = nextField(line, pos, false);
+        break;
+
+      case Device::ROW:
+        tag.disasm = nextField(line, pos, false);
+        break;
+
+      case Device::NONE:
+      default:  // should never happen
+        tag.disasm = " ";
+        break;
+    }
   }
-  myList.push_back(tag);
+  myList.push_back(std::move(tag));
 
 DONE_WITH_ADD:
   myDisasmBuf.clear();
-  myDisasmBuf.str("");
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt16 DiStella::parseHex(const string& line, size_t pos)
+{
+  uInt16 value = 0;
+  for (; pos < line.size(); ++pos) {
+    const char c = line[pos];
+    if (c >= '0' && c <= '9')       value = (value << 4) | (c - '0');
+    else if (c >= 'A' && c <= 'F')  value = (value << 4) | (c - 'A' + 10);
+    else if (c >= 'a' && c <= 'f')  value = (value << 4) | (c - 'a' + 10);
+    else break;
+  }
+  return value;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string DiStella::nextField(const string& line, size_t& pos, bool delimited)
+{
+  if (pos >= line.size())
+    return EmptyString;
+
+  size_t end = delimited ? line.find('\'', pos) : string::npos;
+  if (end == string::npos)
+    end = line.size();
+
+  string field = line.substr(pos, end - pos);
+  pos = end + 1;
+  return field;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+DiStella::LineBuffer& DiStella::LineBuffer::operator<<(const Hex& h)
+{
+  static constexpr char UPPER[] = "0123456789ABCDEF";
+  static constexpr char LOWER[] = "0123456789abcdef";
+  const char* digits = Base::hexUppercase() ? UPPER : LOWER;
+
+  // Like the stream manipulators, output more digits if the value needs them
+  uInt32 count = h.digits;
+  while (count < 8 && (h.value >> (count * 4)))
+    ++count;
+
+  for (Int32 shift = (count - 1) * 4; shift >= 0; shift -= 4)
+    myText += digits[(h.value >> shift) & 0xF];
+
+  return *this;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+DiStella::LineBuffer& DiStella::LineBuffer::operator<<(const Dec& d)
+{
+  char text[12];
+  uInt32 value = d.value < 0 ? -d.value : d.value;
+  uInt32 len = 0;
+
+  do {
+    text[sizeof(text) - 1 - len++] = '0' + value % 10;
+    value /= 10;
+  } while (value);
+  if (d.value < 0)
+    text[sizeof(text) - 1 - len++] = '-';
+
+  if (len < d.width)
+    spaces(d.width - len);
+  myText.append(text + sizeof(text) - len, len);
+
+  return *this;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1109,17 +1179,17 @@ void DiStella::outputGraphics()
   mySegType = Device::GFX;
 
   if (checkBit(myPC, Device::REFERENCED))
-    myDisasmBuf << Base::HEX4 << myPC + myOffset << "'L" << Base::HEX4 << myPC + myOffset << "'";
+    myDisasmBuf << hex4(myPC + myOffset) << "'L" << hex4(myPC + myOffset) << "'";
   else
-    myDisasmBuf << Base::HEX4 << myPC + myOffset << "'     '";
-  myDisasmBuf << ".byte $" << Base::HEX2 << int(byte) << "  |";
+    myDisasmBuf << hex4(myPC + myOffset) << "'     '";
+  myDisasmBuf << ".byte $" << hex2(byte) << "  |";
   for (uInt8 i = 0, c = byte; i < 8; ++i, c <<= 1)
     myDisasmBuf << ((c > 127) ? bitString : " ");
-  myDisasmBuf << "|   $" << Base::HEX4 << myPC + myOffset << "'";
+  myDisasmBuf << "|   $" << hex4(myPC + myOffset) << "'";
   if (mySettings.gfxFormat == Base::Fmt::_2)
     myDisasmBuf << Base::toString(byte, Base::Fmt::_2_8);
   else
-    myDisasmBuf << Base::HEX2 << int(byte);
+    myDisasmBuf << hex2(byte);
 
   addEntry(isPGfx ? Device::PGFX : Device::GFX);
 }
@@ -1156,9 +1226,9 @@ void DiStella::outputColors()
 
   // output label/address
   if(checkBit(myPC, Device::REFERENCED))
-    myDisasmBuf << Base::HEX4 << myPC + myOffset << "'L" << Base::HEX4 << myPC + myOffset << "'";
+    myDisasmBuf << hex4(myPC + myOffset) << "'L" << hex4(myPC + myOffset) << "'";
   else
-    myDisasmBuf << Base::HEX4 << myPC + myOffset << "'     '";
+    myDisasmBuf << hex4(myPC + myOffset) << "'     '";
 
   // output color
   string color;
@@ -1167,26 +1237,28 @@ void DiStella::outputColors()
   if(myDbg.myConsole.timing() == ConsoleTiming::ntsc)
   {
     color = NTSC_COLOR[byte >> 4];
-    myDisasmBuf << color << "|$" << Base::HEX1 << (byte & 0xf);
+    myDisasmBuf << color << "|$" << hex1(byte & 0xf);
   }
   else if(myDbg.myConsole.timing() == ConsoleTiming::pal)
   {
     color = PAL_COLOR[byte >> 4];
-    myDisasmBuf << color << "|$" << Base::HEX1 << (byte & 0xf);
+    myDisasmBuf << color << "|$" << hex1(byte & 0xf);
   }
   else
   {
     color = SECAM_COLOR[(byte >> 1) & 0x7];
-    myDisasmBuf << "$" << Base::HEX1 << (byte >> 4) << "|" << color;
+    myDisasmBuf << "$" << hex1(byte >> 4) << "|" << color;
   }
-  myDisasmBuf << std::setw(int(16 - color.length())) << std::setfill(' ');
+  // pad the color name (like a stream width of 16 - name length would)
+  if(color.length() < 13)
+    myDisasmBuf.spaces(13 - color.length());
 
   // output address
-  myDisasmBuf << "; $" << Base::HEX4 << myPC + myOffset << " "
+  myDisasmBuf << "; $" << hex4(myPC + myOffset) << " "
     << (checkBit(myPC, Device::COL) ? "(Px)" : checkBit(myPC, Device::PCOL) ? "(PF)" : "(BK)");
 
   // output color value
-  myDisasmBuf << "'" << Base::HEX2 << int(byte);
+  myDisasmBuf << "'" << hex2(byte);
 
   addEntry(checkBit(myPC, Device::COL) ? Device::COL :
            checkBit(myPC, Device::PCOL) ? Device::PCOL : Device::BCOL);
@@ -1213,16 +1285,15 @@ void DiStella::outputBytes(Device::AccessType type)
       if (!lineEmpty)
         addEntry(type);
 
-      myDisasmBuf << Base::HEX4 << myPC + myOffset << "'L" << Base::HEX4
-        << myPC + myOffset << "'.byte " << "$" << Base::HEX2
-        << int(Debugger::debugger().peek(myPC + myOffset));
+      myDisasmBuf << hex4(myPC + myOffset) << "'L" << hex4(myPC + myOffset)
+        << "'.byte " << "$" << hex2(Debugger::debugger().peek(myPC + myOffset));
       ++myPC;
       numBytes = 1;
       lineEmpty = false;
     } else if (lineEmpty) {
       // start a new line without a label
-      myDisasmBuf << Base::HEX4 << myPC + myOffset << "'     '"
-        << ".byte $" << Base::HEX2 << int(Debugger::debugger().peek(myPC + myOffset));
+      myDisasmBuf << hex4(myPC + myOffset) << "'     '"
+        << ".byte $" << hex2(Debugger::debugger().peek(myPC + myOffset));
       ++myPC;
       numBytes = 1;
       lineEmpty = false;
@@ -1232,7 +1303,7 @@ void DiStella::outputBytes(Device::AccessType type)
       addEntry(type);
       lineEmpty = true;
     } else {
-      myDisasmBuf << ",$" << Base::HEX2 << int(Debugger::debugger().peek(myPC + myOffset));
+      myDisasmBuf << ",$" << hex2(Debugger::debugger().peek(myPC + myOffset));
       ++myPC;
     }
     isType = checkBits(myPC, type,
@@ -110,15 +110,60 @@ class DiStella
     void outputColors();
     void outputBytes(Device::AccessType type);
 
+    // Helpers for splitting a formatted line into the fields of a tag
+    static uInt16 parseHex(const string& line, size_t pos);
+    static string nextField(const string& line, size_t& pos, bool delimited = true);
+
+    /**
+      A line of disassembly is formatted into this buffer instead of a
+      stringstream; its storage is kept between lines, and hex digits are
+      taken from a lookup table, so formatting a line allocates nothing.
+    */
+    class LineBuffer
+    {
+      public:
+        // Tags for hex (at least 'digits' digits) and decimal (right aligned
+        // to 'width') output of a value
+        struct Hex { uInt32 value; uInt32 digits; };
+        struct Dec { Int32 value; uInt32 width; };
+
+        LineBuffer() { myText.reserve(256); }
+
+        LineBuffer& operator<<(char c) { myText += c; return *this; }
+        LineBuffer& operator<<(const char* s) { myText += s; return *this; }
+        LineBuffer& operator<<(const string& s) { myText += s; return *this; }
+        LineBuffer& operator<<(const LineBuffer& b) { myText += b.myText; return *this; }
+        LineBuffer& operator<<(const Hex& h);
+        LineBuffer& operator<<(const Dec& d);
+
+        void spaces(size_t count) { myText.append(count, ' '); }
+
+        const string& str() const { return myText; }
+        void clear() { myText.clear(); }
+
+      private:
+        string myText;
+    };
+
+    static LineBuffer::Hex hex1(uInt32 value) { return {value, 1}; }
+    static LineBuffer::Hex hex2(uInt32 value) { return {value, 2}; }
+    static LineBuffer::Hex hex4(uInt32 value) { return {value, 4}; }
+    static LineBuffer::Dec dec(Int32 value, uInt32 width = 0) { return {value, width}; }
+
     // Convenience methods to generate appropriate labels
-    inline void labelA12High(stringstream& buf, uInt8 op, uInt16 addr, AddressType labfound)
+    inline void labelA12High(LineBuffer& buf, uInt8 op, uInt16 addr, AddressType labfound)
     {
-      if(!myDbg.getLabel(buf, addr, true))
-        buf << "L" << Common::Base::HEX4 << addr;
+      myLabelBuf.str("");
+      if(myDbg.getLabel(myLabelBuf, addr, true))
+        buf << myLabelBuf.str();
+      else
+        buf << "L" << hex4(addr);
     }
-    inline void labelA12Low(stringstream& buf, uInt8 op, uInt16 addr, AddressType labfound)
+    inline void labelA12Low(LineBuffer& buf, uInt8 op, uInt16 addr, AddressType labfound)
     {
-      myDbg.getLabel(buf, addr, ourLookup[op].rw_mode == RWMode::READ, 2);
+      myLabelBuf.str("");
+      myDbg.getLabel(myLabelBuf, addr, ourLookup[op].rw_mode == RWMode::READ, 2);
+      buf << myLabelBuf.str();
       if (labfound == AddressType::TIA)
       {
         if(ourLookup[op].rw_mode == RWMode::READ)
@@ -137,7 +182,9 @@ class DiStella
     CartDebug::DisassemblyList& myList;
     const Settings& mySettings;
     CartDebug::ReservedEquates& myReserved;
-    stringstream myDisasmBuf;
+    LineBuffer myDisasmBuf;
+    // Reused for the labels CartDebug outputs into a stream
+    ostringstream myLabelBuf;
     std::queue<uInt16> myAddressQueue;
     uInt16 myOffset{0}, myPC{0}, myPCEnd{0};
     uInt16 mySegType{0};
@@ -20,6 +20,8 @@
 
 #include "bspf.hxx"
 
+class CompiledExpression;
+
 /**
   This class provides an implementation of an expression node, which
   is a construct that is given two other expressions and evaluates and
@@ -37,6 +39,12 @@ class Expression
 
     virtual Int32 evaluate() const { return 0; }
 
+    /**
+      Append the code evaluating this expression.  By default, the code
+      calls evaluate().
+    */
+    virtual void compile(CompiledExpression& code) const;
+
   protected:
     unique_ptr<Expression> myLHS, myRHS;
 
@@ -0,0 +1,229 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define RAM_SEARCH_SSE2
+#endif
+
+#include "Base.hxx"
+#include "Cart.hxx"
+#include "Console.hxx"
+#include "M6532.hxx"
+#include "RamSearch.hxx"
+
+namespace {
+  // The comparisons, for a single byte and (with SSE2) for 16 bytes at
+  // once; each returns a mask which is 0xff where the comparison holds.
+  // 'a' and 'b' are the parameters of the comparison.
+#ifdef RAM_SEARCH_SSE2
+  #define RAM_SEARCH_OP(name, scalarExpr, sseExpr)                             \
+    struct name {                                                              \
+      static uInt8 scalar(uInt8 cur, uInt8 prev, uInt8 a, uInt8 b) {           \
+        return (scalarExpr) ? 0xff : 0;                                        \
+      }                                                                        \
+      static __m128i sse2(__m128i cur, __m128i prev, __m128i a, __m128i b) {   \
+        return sseExpr;                                                        \
+      }                                                                        \
+    };
+
+  inline __m128i inv(__m128i mask) { return _mm_cmpeq_epi8(mask, _mm_setzero_si128()); }
+  inline __m128i eq(__m128i x, __m128i y) { return _mm_cmpeq_epi8(x, y); }
+  // x > y resp. x < y, unsigned
+  inline __m128i gt(__m128i x, __m128i y) { return inv(eq(_mm_max_epu8(x, y), y)); }
+  inline __m128i lt(__m128i x, __m128i y) { return inv(eq(_mm_min_epu8(x, y), y)); }
+#else
+  #define RAM_SEARCH_OP(name, scalarExpr, sseExpr)                             \
+    struct name {                                                              \
+      static uInt8 scalar(uInt8 cur, uInt8 prev, uInt8 a, uInt8 b) {           \
+        return (scalarExpr) ? 0xff : 0;                                        \
+      }                                                                        \
+    };
+#endif
+
+  RAM_SEARCH_OP(Equal,        cur == a,   eq(cur, a))
+  RAM_SEARCH_OP(NotEqual,     cur != a,   inv(eq(cur, a)))
+  RAM_SEARCH_OP(Greater,      cur > a,    gt(cur, a))
+  RAM_SEARCH_OP(Less,         cur < a,    lt(cur, a))
+  RAM_SEARCH_OP(Changed,      cur != prev, inv(eq(cur, prev)))
+  RAM_SEARCH_OP(Unchanged,    cur == prev, eq(cur, prev))
+  RAM_SEARCH_OP(Increased,    cur > prev,  gt(cur, prev))
+  RAM_SEARCH_OP(Decreased,    cur < prev,  lt(cur, prev))
+  RAM_SEARCH_OP(NotIncreased, cur <= prev, inv(gt(cur, prev)))
+  RAM_SEARCH_OP(NotDecreased, cur >= prev, inv(lt(cur, prev)))
+  // Previous value plus resp. minus 'a', without wrapping around; 'b' is
+  // the largest resp. smallest previous value this is possible for
+  RAM_SEARCH_OP(Added,        cur == uInt8(prev + a) && prev <= b,
+                _mm_and_si128(eq(cur, _mm_add_epi8(prev, a)), inv(gt(prev, b))))
+  RAM_SEARCH_OP(Subtracted,   cur == uInt8(prev - a) && prev >= b,
+                _mm_and_si128(eq(cur, _mm_sub_epi8(prev, a)), inv(lt(prev, b))))
+
+  #undef RAM_SEARCH_OP
+
+  template<typename Op>
+  void applyFilter(const uInt8* ram, const uInt8* prev, uInt8* mask,
+                   size_t size, uInt8 a, uInt8 b)
+  {
+    size_t i = 0;
+
+  #ifdef RAM_SEARCH_SSE2
+    const __m128i va = _mm_set1_epi8(char(a)), vb = _mm_set1_epi8(char(b));
+
+    for(; i + 16 <= size; i += 16)
+    {
+      __m128i* m = reinterpret_cast<__m128i*>(mask + i);
+      _mm_storeu_si128(m, _mm_and_si128(_mm_loadu_si128(m),
+        Op::sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ram + i)),
+                 _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev + i)),
+                 va, vb)));
+    }
+  #endif
+
+    for(; i < size; ++i)
+      mask[i] &= Op::scalar(ram[i], prev[i], a, b);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RamSearch::start(const ByteArray& ram)
+{
+  myPrevious = ram;
+  myMask.assign(ram.size(), 0xff);
+  myCount = uInt32(ram.size());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 RamSearch::filter(const ByteArray& ram, Compare compare, Int32 value)
+{
+  // A snapshot of a different size (e.g. of another ROM) starts over
+  if(ram.size() != myPrevious.size())
+    start(ram);
+
+  return filter(ram, compare, value, myPrevious);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 RamSearch::filter(const ByteArray& ram, Compare compare, Int32 value,
+                         const ByteArray& reference)
+{
+  if(ram.size() != myMask.size() || reference.size() != ram.size())
+    return myCount;
+
+  const uInt8* cur = ram.data();
+  const uInt8* prev = reference.data();
+  uInt8* mask = myMask.data();
+  const size_t size = ram.size();
+  const uInt8 a = uInt8(value);
+  // Values outside of the byte range match all or no bytes
+  const bool below = value < 0, above = value > 255;
+
+  switch(compare)
+  {
+    case Compare::Equal:
+      if(below || above)
+        std::fill(myMask.begin(), myMask.end(), 0);
+      else
+        applyFilter<Equal>(cur, prev, mask, size, a, 0);
+      break;
+
+    case Compare::NotEqual:
+      if(!below && !above)
+        applyFilter<NotEqual>(cur, prev, mask, size, a, 0);
+      break;
+
+    case Compare::Greater:
+      if(above)
+        std::fill(myMask.begin(), myMask.end(), 0);
+      else if(!below)
+        applyFilter<Greater>(cur, prev, mask, size, a, 0);
+      break;
+
+    case Compare::Less:
+      if(below)
+        std::fill(myMask.begin(), myMask.end(), 0);
+      else if(!above)
+        applyFilter<Less>(cur, prev, mask, size, a, 0);
+      break;
+
+    case Compare::Changed:      applyFilter<Changed>(cur, prev, mask, size, 0, 0);      break;
+    case Compare::Unchanged:    applyFilter<Unchanged>(cur, prev, mask, size, 0, 0);    break;
+    case Compare::Increased:    applyFilter<Increased>(cur, prev, mask, size, 0, 0);    break;
+    case Compare::Decreased:    applyFilter<Decreased>(cur, prev, mask, size, 0, 0);    break;
+    case Compare::NotIncreased: applyFilter<NotIncreased>(cur, prev, mask, size, 0, 0); break;
+    case Compare::NotDecreased: applyFilter<NotDecreased>(cur, prev, mask, size, 0, 0); break;
+
+    case Compare::ChangedBy:
+      if(value > 255 || value < -255)
+        std::fill(myMask.begin(), myMask.end(), 0);
+      else if(value >= 0)
+        applyFilter<Added>(cur, prev, mask, size, a, uInt8(255 - value));
+      else
+        applyFilter<Subtracted>(cur, prev, mask, size, uInt8(-value), uInt8(-value));
+      break;
+  }
+
+  myPrevious = ram;
+
+  myCount = 0;
+  for(size_t i = 0; i < size; ++i)
+    myCount += mask[i] & 1;
+
+  return myCount;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RamSearch::reset()
+{
+  myPrevious.clear();
+  myMask.clear();
+  myCount = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+IntArray RamSearch::candidates(uInt32 max) const
+{
+  IntArray list;
+
+  for(uInt32 i = 0; i < myMask.size() && list.size() < max; ++i)
+    if(myMask[i])
+      list.push_back(i);
+
+  return list;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RamSearch::snapshot(const Console& console, ByteArray& ram)
+{
+  const Cartridge& cart = console.cartridge();
+  const uInt32 cartSize = cart.internalRamSize();
+
+  ram.resize(128 + cartSize);
+  std::copy_n(console.riot().getRAM(), 128, ram.begin());
+  for(uInt32 i = 0; i < cartSize; ++i)
+    ram[128 + i] = cart.internalRamGetValue(i);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string RamSearch::location(uInt32 index)
+{
+  using Common::Base;
+
+  if(index < 128)
+    return "$" + Base::toString(0x80 + index, Base::Fmt::_16_2);
+  else
+    return "cart RAM $" + Base::toString(index - 128, Base::Fmt::_16_4);
+}
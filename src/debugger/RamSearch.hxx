@@ -0,0 +1,114 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef RAM_SEARCH_HXX
+#define RAM_SEARCH_HXX
+
+class Console;
+
+#include "bspf.hxx"
+
+/**
+  Narrows down the RAM locations which hold a value of interest (a score,
+  the number of lives, ...) by repeatedly comparing snapshots of RAM.
+
+  A snapshot is an array of bytes; for searching the whole console, it is
+  the RIOT RAM followed by all of the cartridge's internal RAM (see
+  snapshot()).  The candidates are kept as a mask parallel to it (0xff for
+  each remaining candidate), so each comparison is a single branch free
+  pass over the arrays, 16 bytes at a time where SSE2 is available.
+
+  @author  Stella Team
+*/
+class RamSearch
+{
+  public:
+    enum class Compare: uInt8 {
+      // Compare the new snapshot with a value
+      Equal, NotEqual, Greater, Less,
+      // Compare the new snapshot with the previous one
+      Changed, Unchanged, Increased, Decreased,
+      NotIncreased, NotDecreased,
+      // The new value is the previous one plus a (signed) value
+      ChangedBy
+    };
+
+    RamSearch() = default;
+
+    /**
+      Start a new search; all locations of the snapshot are candidates.
+    */
+    void start(const ByteArray& ram);
+
+    /**
+      Keep only the candidates for which the comparison holds, and make
+      'ram' the previous snapshot for the next comparison.
+
+      @return  The number of remaining candidates
+    */
+    uInt32 filter(const ByteArray& ram, Compare compare, Int32 value = 0);
+
+    /**
+      Like above, but compare with 'reference' instead of the previous
+      snapshot (which must have the same size).
+    */
+    uInt32 filter(const ByteArray& ram, Compare compare, Int32 value,
+                  const ByteArray& reference);
+
+    /**
+      Forget the search (no candidates, no snapshot).
+    */
+    void reset();
+
+    bool active() const { return !myPrevious.empty(); }
+    uInt32 size() const { return uInt32(myPrevious.size()); }
+    uInt32 count() const { return myCount; }
+    bool isCandidate(uInt32 index) const {
+      return index < myMask.size() && myMask[index];
+    }
+    uInt8 previous(uInt32 index) const { return myPrevious[index]; }
+
+    /**
+      The indices of the (first 'max') remaining candidates.
+    */
+    IntArray candidates(uInt32 max = ~0U) const;
+
+    /**
+      Copy the RIOT RAM and all of the cartridge's internal RAM into 'ram'.
+    */
+    static void snapshot(const Console& console, ByteArray& ram);
+
+    /**
+      Describe the location of a snapshot index (an address in zero page
+      RAM, or an offset into the cartridge RAM).
+    */
+    static string location(uInt32 index);
+
+  private:
+    ByteArray myPrevious;
+    ByteArray myMask;
+    uInt32 myCount{0};
+
+  private:
+    // Following constructors and assignment operators not supported
+    RamSearch(const RamSearch&) = delete;
+    RamSearch(RamSearch&&) = delete;
+    RamSearch& operator=(const RamSearch&) = delete;
+    RamSearch& operator=(RamSearch&&) = delete;
+};
+
+#endif // RAM_SEARCH_HXX
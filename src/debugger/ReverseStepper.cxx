@@ -0,0 +1,444 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "OSystem.hxx"
+#include "Console.hxx"
+#include "System.hxx"
+#include "M6502.hxx"
+#include "M6532.hxx"
+#include "TIA.hxx"
+#include "EmulationTiming.hxx"
+#include "Serializer.hxx"
+#include "StateManager.hxx"
+#include "RewindManager.hxx"
+#include "Debugger.hxx"
+#include "CpuDebug.hxx"
+#include "ReverseStepper.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ReverseStepper::ReverseStepper(OSystem& osystem, Debugger& debugger)
+  : myOSystem{osystem},
+    myDebugger{debugger}
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ReverseStepper::checkpoint()
+{
+  const uInt64 now = cycles();
+
+  myCheckpoints.erase(myCheckpoints.lower_bound(now), myCheckpoints.end());
+
+  Checkpoint checkpoint;
+  if(save(checkpoint))
+  {
+    myCheckpoints.emplace(now, std::move(checkpoint));
+    thinOut();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ReverseStepper::stepBack(uInt32 instructions, string& message)
+{
+  if(!startMove(message))
+    return false;
+
+  // Start stepping early enough for the requested instructions (at most
+  // 7 cycles each) and a WSYNC; if that's not enough, look further back
+  uInt64 margin = uInt64(instructions) * 7 + 76;
+  Checkpoint scanStart;
+  vector<uInt64> boundaries;
+
+  for(;;)
+  {
+    const uInt64 from = myStartCycles > margin ? myStartCycles - margin : 0;
+
+    if(!scan(from, myStartCycles, scanStart, boundaries))
+    {
+      message = "no earlier state available";
+      return finishMove(false);
+    }
+    if(boundaries.size() >= instructions)
+      return finishMove(land(scanStart, boundaries.size() - instructions));
+
+    if(myHistoryExhausted || from == 0)
+    {
+      if(boundaries.empty())
+      {
+        message = "no earlier state available";
+        return finishMove(false);
+      }
+      message = "oldest available state reached";
+      return finishMove(land(scanStart, 0));
+    }
+    margin *= 4;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ReverseStepper::cyclesBack(uInt64 cycles, string& message)
+{
+  if(!startMove(message))
+    return false;
+
+  const uInt64 target = myStartCycles > cycles ? myStartCycles - cycles : 0;
+
+  if(!restoreNearest(target) || !replayTo(target))
+  {
+    message = "no earlier state available";
+    return finishMove(false);
+  }
+  if(myHistoryExhausted)
+    message = "oldest available state reached";
+
+  // A long halt (WSYNC) may span the target, move back at least one
+  // instruction then
+  if(this->cycles() >= myStartCycles)
+  {
+    restore(myStart);
+    finishMove(true);
+    message.clear();
+
+    return stepBack(1, message);
+  }
+
+  return finishMove(true);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ReverseStepper::runBack(string& message)
+{
+  if(!startMove(message))
+    return false;
+
+  const uInt64 maxCycles = uInt64(MAX_RUN_BACK_FRAMES) * cyclesPerFrame();
+  Checkpoint scanStart;
+  vector<uInt64> boundaries;
+  vector<size_t> hits;
+
+  // Search the history backwards, from one checkpoint to the next
+  uInt64 chunkEnd = myStartCycles;
+  while(chunkEnd > 0 && myStartCycles - chunkEnd < maxCycles)
+  {
+    if(!restoreNearest(chunkEnd - 1) || cycles() >= chunkEnd)
+      break;
+
+    const uInt64 chunkStart = cycles();
+    if(!scan(chunkStart, chunkEnd, scanStart, boundaries, &hits))
+      break;
+
+    if(!hits.empty())
+      return finishMove(land(scanStart, hits.back()));
+
+    if(myHistoryExhausted)
+      break;
+    chunkEnd = chunkStart;
+  }
+
+  message = "no breakpoint or trap hit found";
+  return finishMove(false);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t ReverseStepper::memoryUsage() const
+{
+  size_t size = myStart.data.capacity();
+
+  for(const auto& checkpoint: myCheckpoints)
+    size += checkpoint.second.data.capacity();
+
+  return size;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ReverseStepper::startMove(string& message)
+{
+  myStartCycles = cycles();
+  myHistoryExhausted = false;
+
+  // Silence audio before saving, so the sample log for rewind playback is
+  // neither consumed by the save nor replayed by the load
+  myOSystem.console().tia().enableAudioOutput(false);
+
+  if(!save(myStart))
+  {
+    myOSystem.console().tia().enableAudioOutput(true);
+    message = "saving the current state failed";
+    return false;
+  }
+  myStartFingerprint = fingerprint();
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ReverseStepper::finishMove(bool success)
+{
+  if(!success)
+    restore(myStart);
+
+  // Allow continuing from a breakpoint which was moved back to
+  myOSystem.console().system().m6502().skipBreakAtCurrentCycle();
+  myOSystem.console().tia().enableAudioOutput(true);
+
+  return success;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ReverseStepper::save(Checkpoint& checkpoint) const
+{
+  const Console& console = myOSystem.console();
+
+  for(int attempt = 0; attempt < 2; ++attempt)
+  {
+    if(!checkpoint.data.empty())
+    {
+      Serializer out(checkpoint.data.data(), checkpoint.data.size());
+      if(console.save(out) && console.tia().saveDisplay(out))
+      {
+        checkpoint.size = out.size();
+        return true;
+      }
+    }
+
+    // The buffer is missing or too small, so determine the required size
+    Serializer probe;
+    if(!console.save(probe) || !console.tia().saveDisplay(probe))
+      break;
+
+    checkpoint.data.resize(probe.size() + probe.size() / 4);
+  }
+  checkpoint.size = 0;
+
+  return false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ReverseStepper::restore(const Checkpoint& checkpoint) const
+{
+  Console& console = myOSystem.console();
+  Serializer in(checkpoint.data.data(), checkpoint.size);
+
+  return checkpoint.size > 0 && console.load(in) && console.tia().loadDisplay(in);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ReverseStepper::insertCheckpoint()
+{
+  const uInt64 now = cycles();
+  const uInt64 distance = cyclesPerFrame() / 2;
+
+  const auto next = myCheckpoints.lower_bound(now);
+  if(next != myCheckpoints.end() && next->first - now < distance)
+    return;
+  if(next != myCheckpoints.begin() && now - std::prev(next)->first < distance)
+    return;
+
+  Checkpoint checkpoint;
+  if(save(checkpoint))
+  {
+    myCheckpoints.emplace_hint(next, now, std::move(checkpoint));
+    thinOut();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ReverseStepper::thinOut()
+{
+  while(myCheckpoints.size() > MAX_CHECKPOINTS)
+  {
+    auto drop = myCheckpoints.end();
+    uInt64 minGap = ~uInt64(0);
+
+    for(auto prev = myCheckpoints.begin(), it = std::next(prev);
+        std::next(it) != myCheckpoints.end(); prev = it++)
+    {
+      const uInt64 gap = std::next(it)->first - prev->first;
+      if(gap < minGap)
+      {
+        minGap = gap;
+        drop = it;
+      }
+    }
+    myCheckpoints.erase(drop);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ReverseStepper::restoreNearest(uInt64 cycles)
+{
+  auto it = myCheckpoints.upper_bound(cycles);
+
+  if(it == myCheckpoints.begin() && fetchFromRewind(cycles))
+    it = myCheckpoints.upper_bound(cycles);
+
+  if(it != myCheckpoints.begin())
+    return restore(std::prev(it)->second);
+
+  // Nothing that early, so start from as early as possible
+  myHistoryExhausted = true;
+
+  return !myCheckpoints.empty() && myCheckpoints.begin()->first < myStartCycles &&
+         restore(myCheckpoints.begin()->second);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ReverseStepper::fetchFromRewind(uInt64 cycles)
+{
+  RewindManager& rewindManager = myOSystem.state().rewindManager();
+  Checkpoint found;
+  uInt64 foundCycles = 0;
+  bool ok = false;
+
+  rewindManager.visitStates([&]() {
+    const uInt64 now = this->cycles();
+    if(now <= cycles && (!ok || now >= foundCycles))
+    {
+      ok = save(found);
+      foundCycles = now;
+    }
+  });
+  if(!ok || !restore(found))
+    return false;
+
+  // The input may have changed since the state was saved, so make sure the
+  // replay arrives here again
+  M6502& cpu = myOSystem.console().system().m6502();
+  while(this->cycles() < myStartCycles)
+  {
+    const uInt64 before = this->cycles();
+    cpu.replay(myStartCycles - before);
+    if(this->cycles() == before)
+      return false;
+  }
+  if(fingerprint() != myStartFingerprint)
+    return false;
+
+  myCheckpoints.emplace(foundCycles, std::move(found));
+  thinOut();
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ReverseStepper::replayTo(uInt64 cycles)
+{
+  M6502& cpu = myOSystem.console().system().m6502();
+  const uInt64 frameCycles = cyclesPerFrame();
+
+  while(this->cycles() < cycles)
+  {
+    const uInt64 before = this->cycles();
+    // Traps don't matter here, just continue
+    cpu.replay(std::min(cycles - before, frameCycles));
+    if(this->cycles() == before)
+      return false;
+
+    insertCheckpoint();
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ReverseStepper::scan(uInt64 from, uInt64 until, Checkpoint& scanStart,
+                          vector<uInt64>& boundaries, vector<size_t>* hits)
+{
+  boundaries.clear();
+  if(hits)
+    hits->clear();
+
+  if(!restoreNearest(from) || !replayTo(from) || !save(scanStart))
+    return false;
+
+  M6502& cpu = myOSystem.console().system().m6502();
+  const uInt64 frameCycles = cyclesPerFrame();
+  uInt64 lastCheckpoint = cycles();
+  bool trapped = false;
+
+  while(cycles() < until)
+  {
+    const uInt64 before = cycles();
+
+    boundaries.push_back(before);
+    if(hits && (trapped || cpu.breakPending()))
+      hits->push_back(boundaries.size() - 1);
+
+    trapped = cpu.replay(1);
+    if(cycles() == before)
+      return false;
+
+    if(cycles() - lastCheckpoint >= frameCycles)
+    {
+      insertCheckpoint();
+      lastCheckpoint = cycles();
+    }
+  }
+
+  // The last instruction may have hit a trap, stopping right at the end
+  if(hits && trapped && cycles() < myStartCycles)
+  {
+    boundaries.push_back(cycles());
+    hits->push_back(boundaries.size() - 1);
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ReverseStepper::land(const Checkpoint& scanStart, size_t instructions)
+{
+  if(!restore(scanStart))
+    return false;
+
+  M6502& cpu = myOSystem.console().system().m6502();
+  for(size_t i = 0; i < instructions; ++i)
+    cpu.replay(1);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ByteArray ReverseStepper::fingerprint() const
+{
+  const uInt8* ram = myOSystem.console().riot().getRAM();
+  ByteArray result(ram, ram + 128);
+
+  const CpuDebug& cpu = myDebugger.cpuDebug();
+  for(const int reg: {cpu.pc(), cpu.sp(), cpu.a(), cpu.x(), cpu.y()})
+  {
+    result.push_back(uInt8(reg));
+    result.push_back(uInt8(reg >> 8));
+  }
+  const uInt64 now = cycles();
+  for(int i = 0; i < 8; ++i)
+    result.push_back(uInt8(now >> (i * 8)));
+
+  return result;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 ReverseStepper::cycles() const
+{
+  return myOSystem.console().tia().cycles();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 ReverseStepper::cyclesPerFrame() const
+{
+  return myOSystem.console().emulationTiming().cyclesPerFrame();
+}
@@ -0,0 +1,203 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef REVERSE_STEPPER_HXX
+#define REVERSE_STEPPER_HXX
+
+class OSystem;
+class Debugger;
+
+#include <map>
+
+#include "bspf.hxx"
+
+/**
+  Moves the emulation backwards while debugging, by instructions,
+  scanlines, frames or to the last breakpoint/trap which was hit.
+
+  The emulation is deterministic, so any earlier position can be reached by
+  loading an earlier state and replaying the emulation from there, with
+  the fast CPU core (see M6502::replay).  The debugger captures a
+  checkpoint (console state plus display) before each of its forward
+  moves, and more are added about once per frame while replaying.  The
+  number of checkpoints is limited; the surplus ones are thinned out
+  evenly, so the replay never needs to cover more than a small part of
+  the history.
+
+  Before the first checkpoint of a debugger session (which is taken when
+  the debugger is entered), the rewind states are used instead.  Since the
+  input may have changed while the emulation was running, a replay from
+  them is verified to arrive at the current position again first.
+
+  Moving back doesn't add rewind states.
+
+  @author  Stella Team
+*/
+class ReverseStepper
+{
+  public:
+    ReverseStepper(OSystem& osystem, Debugger& debugger);
+
+    /**
+      Capture a checkpoint at the current position, and drop those after
+      it (they belong to a future which is about to be replaced).
+    */
+    void checkpoint();
+
+    /**
+      Drop all checkpoints (e.g. when the emulation continues without the
+      debugger or a state is loaded).
+    */
+    void clear() { myCheckpoints.clear(); }
+
+    /**
+      Move back by the given number of instructions.
+
+      @param message  Set to an error, or a note if the oldest available
+                      position was reached before
+      @return  True if the emulation was moved back
+    */
+    bool stepBack(uInt32 instructions, string& message);
+
+    /**
+      Move back to the first instruction at or after the given number of
+      cycles earlier (at least one instruction).
+    */
+    bool cyclesBack(uInt64 cycles, string& message);
+
+    /**
+      Move back to the last position before the current one at which the
+      emulation would have stopped for a breakpoint, a conditional break
+      or a trap.
+    */
+    bool runBack(string& message);
+
+    /**
+      The memory used by the checkpoints.
+    */
+    size_t memoryUsage() const;
+
+  private:
+    struct Checkpoint {
+      ByteArray data;  // console state followed by the display
+      size_t size{0};
+    };
+    // Checkpoints by their system cycles
+    using CheckpointMap = std::map<uInt64, Checkpoint>;
+
+    static constexpr size_t MAX_CHECKPOINTS = 64;
+    // Maximum distance which is searched for a breakpoint, in frames
+    static constexpr uInt32 MAX_RUN_BACK_FRAMES = 600;
+
+  private:
+    /**
+      Prepare a move back from the current position.
+    */
+    bool startMove(string& message);
+
+    /**
+      Finish a move back; if unsuccessful, return to the original position.
+    */
+    bool finishMove(bool success);
+
+    bool save(Checkpoint& checkpoint) const;
+    bool restore(const Checkpoint& checkpoint) const;
+
+    /**
+      Add a checkpoint at the current position (during a replay), unless
+      there is one nearby already.
+    */
+    void insertCheckpoint();
+
+    /**
+      Limit the number of checkpoints by dropping those which are the
+      closest to their neighbours.  The oldest and newest are kept.
+    */
+    void thinOut();
+
+    /**
+      Restore the latest checkpoint at or before the given cycle, trying
+      the rewind states if there is none.  Failing that, the oldest
+      checkpoint before the start position is restored, and the history
+      is marked as exhausted.
+
+      @return  False if there is no earlier position at all
+    */
+    bool restoreNearest(uInt64 cycles);
+
+    /**
+      Find the latest rewind state at or before the given cycle, verify
+      that the replay from it arrives at the start position, and add it as
+      checkpoint.
+    */
+    bool fetchFromRewind(uInt64 cycles);
+
+    /**
+      Replay to the first instruction at or after the given cycle, adding
+      checkpoints along the way.
+    */
+    bool replayTo(uInt64 cycles);
+
+    /**
+      Replay from the latest checkpoint at or before 'from' to there, and
+      continue instruction by instruction until 'until' is reached.
+
+      @param scanStart   Set to the state at which the stepping started
+      @param boundaries  Set to the cycles at each instruction stepped
+      @param hits        If given, set to the indices of the boundaries at
+                         which a breakpoint or trap would have stopped the
+                         emulation
+    */
+    bool scan(uInt64 from, uInt64 until, Checkpoint& scanStart,
+              vector<uInt64>& boundaries, vector<size_t>* hits = nullptr);
+
+    /**
+      Restore the scan start state and step the given number of
+      instructions.
+    */
+    bool land(const Checkpoint& scanStart, size_t instructions);
+
+    // The CPU registers, RAM and cycles (to verify a replay)
+    ByteArray fingerprint() const;
+
+    uInt64 cycles() const;
+    uInt64 cyclesPerFrame() const;
+
+  private:
+    OSystem& myOSystem;
+    Debugger& myDebugger;
+
+    CheckpointMap myCheckpoints;
+
+    // The position at which the current move started
+    Checkpoint myStart;
+    uInt64 myStartCycles{0};
+    ByteArray myStartFingerprint;
+
+    // No position earlier than the restored one is available
+    bool myHistoryExhausted{false};
+
+  private:
+    // Following constructors and assignment operators not supported
+    ReverseStepper() = delete;
+    ReverseStepper(const ReverseStepper&) = delete;
+    ReverseStepper(ReverseStepper&&) = delete;
+    ReverseStepper& operator=(const ReverseStepper&) = delete;
+    ReverseStepper& operator=(ReverseStepper&&) = delete;
+};
+
+#endif // REVERSE_STEPPER_HXX
@@ -0,0 +1,181 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include <algorithm>
+#include <map>
+
+#include "Base.hxx"
+#include "ThumbProfiler.hxx"
+
+namespace {
+  template<typename T>
+  void sortByCycles(vector<T>& list, uInt32 max)
+  {
+    const auto hotter = [](const T& a, const T& b) {
+      return a.cycles > b.cycles;
+    };
+    if(list.size() > max)
+    {
+      std::partial_sort(list.begin(), list.begin() + max, list.end(), hotter);
+      list.resize(max);
+    }
+    else
+      std::sort(list.begin(), list.end(), hotter);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ThumbProfiler::ThumbProfiler(uInt32 romSize, uInt32 ramBase, uInt32 ramSize)
+  : myRomSize{romSize},
+    myRamBase{ramBase},
+    myRamSize{ramSize}
+{
+  myCounters.resize((romSize + ramSize) >> 1);
+  myFrameCounters.resize(myCounters.size());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbProfiler::call(uInt32 index)
+{
+  if(myCounters[index].calls++ == 0)
+    myFunctions.insert(address(index));
+  ++touch(index).calls;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 ThumbProfiler::function(uInt32 addr) const
+{
+  auto it = myFunctions.upper_bound(addr);
+
+  return it == myFunctions.begin() ? NO_FUNCTION : *--it;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbProfiler::endFrame()
+{
+  std::map<uInt32, Function> functions;
+
+  for(const uInt32 index: myTouched)
+  {
+    FrameCounter& counter = myFrameCounters[index];
+    const uInt32 addr = address(index);
+    Function& func = functions[function(addr)];
+
+    func.cycles += counter.cycles;
+    if(counter.calls)
+      functions[addr].calls += counter.calls;
+    counter = FrameCounter();
+  }
+  myTouched.clear();
+
+  myLastFrame.clear();
+  for(auto& [addr, func]: functions)
+  {
+    func.addr = addr;
+    myLastFrame.push_back(func);
+  }
+  sortByCycles(myLastFrame, uInt32(myLastFrame.size()));
+
+  ++myFrames;
+  myLastFrameCycles = myFrameCycles;
+  myPeakFrameCycles = std::max(myPeakFrameCycles, myFrameCycles);
+  myFrameCycles = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<ThumbProfiler::Spot> ThumbProfiler::hotSpots(uInt32 max) const
+{
+  vector<Spot> spots;
+
+  for(uInt32 i = 0; i < myCounters.size(); ++i)
+  {
+    const Counter& counter = myCounters[i];
+    if(counter.count == 0)
+      continue;
+
+    Spot spot;
+    spot.addr = address(i);
+    spot.cycles = counter.cycles;
+    spot.count = counter.count;
+    spots.push_back(spot);
+  }
+  sortByCycles(spots, max);
+
+  return spots;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<ThumbProfiler::Function> ThumbProfiler::functions(uInt32 max) const
+{
+  std::map<uInt32, Function> functions;
+
+  // The counters are in ascending order of addresses, so the function
+  // only has to be looked up when the next one is passed
+  uInt32 func = NO_FUNCTION;
+  auto next = myFunctions.begin();
+
+  for(uInt32 i = 0; i < myCounters.size(); ++i)
+  {
+    const Counter& counter = myCounters[i];
+    if(counter.count == 0 && counter.calls == 0)
+      continue;
+
+    const uInt32 addr = address(i);
+    while(next != myFunctions.end() && *next <= addr)
+      func = *next++;
+
+    functions[func].cycles += counter.cycles;
+    if(counter.calls)
+      functions[addr].calls += counter.calls;
+  }
+  if(myOutsideCycles)
+    functions[NO_FUNCTION].cycles += myOutsideCycles;
+
+  vector<Function> list;
+  for(auto& [addr, function]: functions)
+  {
+    function.addr = addr;
+    list.push_back(function);
+  }
+  sortByCycles(list, max);
+
+  return list;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 ThumbProfiler::save(ostream& out) const
+{
+  const auto hex = [](uInt32 addr) {
+    return addr == NO_FUNCTION ? string("(none)  ") : Common::Base::toString(addr, Common::Base::Fmt::_16_8);
+  };
+
+  out << "# " << myFrames << " frames, " << myTotalCycles << " cycles, last frame "
+      << myLastFrameCycles << ", peak frame " << myPeakFrameCycles << "\n"
+      << "# function  cycles  calls\n";
+
+  const vector<Function> list = functions(uInt32(myCounters.size()) + 1);
+  for(const Function& func: list)
+    out << hex(func.addr) << "  " << func.cycles << "  " << func.calls << "\n";
+
+  out << "# address  cycles  count  function\n";
+  for(const Spot& spot: hotSpots(uInt32(myCounters.size())))
+    out << hex(spot.addr) << "  " << spot.cycles << "  " << spot.count
+        << "  " << hex(function(spot.addr)) << "\n";
+
+  return uInt32(list.size());
+}
@@ -0,0 +1,289 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef THUMB_PROFILER_HXX
+#define THUMB_PROFILER_HXX
+
+#include <set>
+
+#include "bspf.hxx"
+
+/**
+  Counts the ARM cycles spent by the Thumb instructions at each address of
+  the ROM and RAM of an ARM cart, like CpuProfiler does for the 6507.  The
+  cycles of an instruction are all cycles counted by the Thumbulator from
+  its fetch until the fetch of the next one, including the flash wait
+  states and the effects of the MAM.  They are counted before the cycle
+  factor is applied.
+
+  The targets of BL/BLX calls (and the entry point of each run) are taken
+  as the start of a function.  Each instruction is attributed to the
+  nearest function starting at or below its address, which gives the
+  cycles a function spends itself (excluding the functions it calls).
+
+  Besides the totals, the cycles of each function are collected for the
+  last frame which called the ARM code.
+
+  @author  Stella Team
+*/
+class ThumbProfiler
+{
+  public:
+    static constexpr uInt32 NO_FUNCTION = ~0U;
+
+    struct Spot {
+      uInt32 addr{0};
+      uInt64 cycles{0};
+      uInt64 count{0};   // number of times the instruction was executed
+    };
+
+    struct Function {
+      uInt32 addr{NO_FUNCTION};  // the entry point
+      uInt64 cycles{0};          // own cycles, excluding called functions
+      uInt64 calls{0};
+    };
+
+  public:
+    /**
+      Create a profiler for the given memory layout.
+
+      @param romSize  The size of the ROM, which starts at address 0
+      @param ramBase  The start address of the RAM
+      @param ramSize  The size of the RAM
+    */
+    ThumbProfiler(uInt32 romSize, uInt32 ramBase, uInt32 ramSize);
+
+    /**
+      Called when the ARM code is entered; the first instruction is the
+      entry point of a function.  When the frame differs from the one of
+      the previous run, that frame is finished.
+
+      @param frame  The number of the (6507) frame the run belongs to
+    */
+    void beginRun(uInt32 frame)
+    {
+      if(frame != myFrame)
+      {
+        if(myFrameStarted)
+          endFrame();
+        myFrame = frame;
+      }
+      myFrameStarted = true;
+
+      myIndex = NO_INDEX;
+      myLastCycles = 0;
+      myOutside = false;
+      myPendingCall = true;
+    }
+
+    /**
+      Called before an instruction is fetched.  The cycles counted since
+      the previous fetch are charged to the previous instruction.
+
+      @param addr         The address of the instruction
+      @param totalCycles  The cycles counted so far in this run
+    */
+    void fetch(uInt32 addr, uInt32 totalCycles)
+    {
+      charge(totalCycles);
+
+      myIndex = index(addr);
+      myOutside = myIndex == NO_INDEX;
+      if(myPendingCall)
+      {
+        myPendingCall = false;
+        if(!myOutside)
+          call(myIndex);
+      }
+    }
+
+    /**
+      Called by a BL/BLX instruction; the next instruction fetched is the
+      entry point of the called function.
+    */
+    void call() { myPendingCall = true; }
+
+    /**
+      Called when the ARM code returns, to charge the last instruction.
+    */
+    void endRun(uInt32 totalCycles)
+    {
+      charge(totalCycles);
+      myIndex = NO_INDEX;
+      myOutside = false;
+    }
+
+    /**
+      The total number of cycles recorded, and of frames finished.
+    */
+    uInt64 totalCycles() const { return myTotalCycles; }
+    uInt32 frames() const { return myFrames; }
+
+    /**
+      The cycles of the last and of the most expensive frame.
+    */
+    uInt64 lastFrameCycles() const { return myLastFrameCycles; }
+    uInt64 peakFrameCycles() const { return myPeakFrameCycles; }
+
+    /**
+      The functions of the last frame, in descending order of cycles.
+    */
+    const vector<Function>& lastFrame() const { return myLastFrame; }
+
+    /**
+      The instructions which took the most cycles, in descending order.
+
+      @param max  The maximum number of spots to return
+    */
+    vector<Spot> hotSpots(uInt32 max) const;
+
+    /**
+      The functions which took the most cycles in total, in descending
+      order.  Code executed outside of a known function is reported
+      for NO_FUNCTION.
+
+      @param max  The maximum number of functions to return
+    */
+    vector<Function> functions(uInt32 max) const;
+
+    /**
+      Write a report of all functions and the hot spots, one line per
+      entry, with a header giving the frame statistics.
+
+      @param out  The stream to write to
+      @return  The number of functions written
+    */
+    uInt32 save(ostream& out) const;
+
+  private:
+    struct Counter {
+      uInt64 cycles{0};
+      uInt32 count{0};
+      uInt32 calls{0};
+    };
+
+    // The counters of the current frame
+    struct FrameCounter {
+      uInt32 cycles{0};
+      uInt32 calls{0};
+      bool touched{false};
+    };
+
+    static constexpr uInt32 NO_INDEX = ~0U;
+
+    uInt32 index(uInt32 addr) const
+    {
+      if(addr < myRomSize)
+        return addr >> 1;
+      if(addr - myRamBase < myRamSize)
+        return (myRomSize + addr - myRamBase) >> 1;
+      return NO_INDEX;
+    }
+
+    uInt32 address(uInt32 index) const
+    {
+      const uInt32 offset = index << 1;
+      return offset < myRomSize ? offset : offset - myRomSize + myRamBase;
+    }
+
+    void charge(uInt32 totalCycles)
+    {
+      const uInt32 cycles = totalCycles - myLastCycles;
+      myLastCycles = totalCycles;
+
+      if(myIndex != NO_INDEX)
+      {
+        Counter& counter = myCounters[myIndex];
+        counter.cycles += cycles;
+        ++counter.count;
+
+        FrameCounter& frame = touch(myIndex);
+        frame.cycles += cycles;
+      }
+      else if(myOutside)
+        myOutsideCycles += cycles;
+      myTotalCycles += cycles;
+      myFrameCycles += cycles;
+    }
+
+    FrameCounter& touch(uInt32 index)
+    {
+      FrameCounter& frame = myFrameCounters[index];
+      if(!frame.touched)
+      {
+        frame.touched = true;
+        myTouched.push_back(index);
+      }
+      return frame;
+    }
+
+    void call(uInt32 index);
+
+    /**
+      Finish the current frame, and make its cycles per function
+      available as the last frame.
+    */
+    void endFrame();
+
+    /**
+      The entry point of the function containing the given address, or
+      NO_FUNCTION.
+    */
+    uInt32 function(uInt32 addr) const;
+
+  private:
+    uInt32 myRomSize{0};
+    uInt32 myRamBase{0};
+    uInt32 myRamSize{0};
+
+    // One counter per halfword of ROM, followed by the RAM
+    vector<Counter> myCounters;
+    vector<FrameCounter> myFrameCounters;
+    vector<uInt32> myTouched;  // indices of the non-zero frame counters
+
+    // The entry points of all functions called so far
+    std::set<uInt32> myFunctions;
+
+    uInt64 myTotalCycles{0};
+    uInt64 myOutsideCycles{0};  // code neither in ROM nor in RAM
+
+    // The instruction being executed, and the cycles counted at its fetch
+    uInt32 myIndex{NO_INDEX};
+    uInt32 myLastCycles{0};
+    bool myOutside{false};
+    bool myPendingCall{false};
+
+    // The current frame, and the number of frames finished
+    uInt32 myFrame{0};
+    bool myFrameStarted{false};
+    uInt32 myFrames{0};
+    uInt64 myFrameCycles{0};
+    uInt64 myLastFrameCycles{0};
+    uInt64 myPeakFrameCycles{0};
+    vector<Function> myLastFrame;
+
+  private:
+    // Following constructors and assignment operators not supported
+    ThumbProfiler() = delete;
+    ThumbProfiler(const ThumbProfiler&) = delete;
+    ThumbProfiler(ThumbProfiler&&) = delete;
+    ThumbProfiler& operator=(const ThumbProfiler&) = delete;
+    ThumbProfiler& operator=(ThumbProfiler&&) = delete;
+};
+
+#endif
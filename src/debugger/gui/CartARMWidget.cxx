@@ -115,12 +115,25 @@ void CartridgeARMWidget::addCycleWidgets(int xpos, int ypos)
   myMamMode->setToolTip("Select emulated Memory Accelerator Module (MAM) mode.");
   myMamMode->setTarget(this);
 
+  ypos += (myLineHeight + VGAP) * 2;
+  myProfile = new CheckboxWidget(_boss, _font, xpos, ypos + 1, "Profile",
+                                 kProfileChanged);
+  myProfile->setToolTip("Profile the ARM code per function (BL target).\n"
+                        "See 'profile arm' in the prompt for details.");
+  myProfile->setTarget(this);
+
+  myProfileSummary = new StaticTextWidget(_boss, _font, myCycleFactor->getLeft(), ypos + 1,
+      myThumbInstructions->getRight() - myCycleFactor->getLeft(), myFontHeight, "");
+  myProfileSummary->setToolTip("ARM cycles of the last frame, and its most expensive\n"
+                               "functions.");
+
   // define the tab order
   addFocusWidget(myIncCycles);
   addFocusWidget(myCycleFactor);
   addFocusWidget(myChipType);
   addFocusWidget(myLockMamMode);
   addFocusWidget(myMamMode);
+  addFocusWidget(myProfile);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -181,6 +194,9 @@ void CartridgeARMWidget::loadConfig()
   changed.push_back(myCart.stats().instructions != uInt32(myOldState.armRun[1]));
   myThumbInstructions->setList(alist, vlist, changed);
 
+  myProfile->setState(myCart.isArmProfiling());
+  myProfileSummary->setLabel(profileSummary());
+
   CartDebugWidget::loadConfig();
 }
 
@@ -207,6 +223,10 @@ void CartridgeARMWidget::handleCommand(CommandSender* sender,
       handleArmCycles();
       break;
 
+    case kProfileChanged:
+      handleProfile();
+      break;
+
     default:
       break;
   }
@@ -284,3 +304,39 @@ void CartridgeARMWidget::handleArmCycles()
   myCart.cycleFactor(factor);
   myCart.enableCycleCount(devSettings);
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeARMWidget::handleProfile()
+{
+  if(myProfile->getState())
+    myCart.startArmProfile();
+  else
+    myCart.stopArmProfile();
+
+  myProfileSummary->setLabel(profileSummary());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string CartridgeARMWidget::profileSummary() const
+{
+  const ThumbProfiler* profiler = myCart.armProfiler();
+  if(!profiler || profiler->frames() == 0)
+    return "";
+
+  ostringstream buf;
+  buf << "Frame " << profiler->lastFrameCycles();
+
+  // The three most expensive functions
+  const vector<ThumbProfiler::Function>& functions = profiler->lastFrame();
+  for(uInt32 i = 0; i < functions.size() && i < 3 && profiler->lastFrameCycles(); ++i)
+  {
+    const ThumbProfiler::Function& func = functions[i];
+
+    buf << (i ? ", " : ": ")
+        << (func.addr == ThumbProfiler::NO_FUNCTION
+            ? string("-") : Common::Base::toString(func.addr, Common::Base::Fmt::_16))
+        << " " << (func.cycles * 100 / profiler->lastFrameCycles()) << "%";
+  }
+
+  return buf.str();
+}
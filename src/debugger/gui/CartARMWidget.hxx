@@ -53,6 +53,8 @@ class CartridgeARMWidget : public CartDebugWidget
     void handleMamLock();
     void handleMamMode();
     void handleArmCycles();
+    void handleProfile();
+    string profileSummary() const;
 
   private:
     struct CartState {
@@ -73,6 +75,8 @@ class CartridgeARMWidget : public CartDebugWidget
     DataGridWidget*   myPrevThumbInstructions{nullptr};
     DataGridWidget*   myThumbCycles{nullptr};
     DataGridWidget*   myThumbInstructions{nullptr};
+    CheckboxWidget*   myProfile{nullptr};
+    StaticTextWidget* myProfileSummary{nullptr};
 
     CartState myOldState;
 
@@ -81,7 +85,8 @@ class CartridgeARMWidget : public CartDebugWidget
       kMamLockChanged   = 'mlCh',
       kMamModeChanged   = 'mmCh',
       kIncCyclesChanged = 'inCH',
-      kFactorChanged    = 'fcCH'
+      kFactorChanged    = 'fcCH',
+      kProfileChanged   = 'prCH'
     };
 
   private:
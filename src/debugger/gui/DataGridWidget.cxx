@@ -124,20 +124,23 @@ void DataGridWidget::setList(const IntArray& alist, const IntArray& vlist,
     || !std::equal(_changedList.begin(), _changedList.end(),
                    changed.begin(), changed.end());
 
-  _addrList.clear();
-  _valueList.clear();
-  _valueStringList.clear();
-  _changedList.clear();
+  // Only format the values which have changed since the last call; all of
+  // them if the number format has changed
+  const bool reformat = _valueStringList.size() != vlist.size() ||
+                        _hexUppercase != Common::Base::hexUppercase() ||
+                        _defaultBase != Common::Base::format();
+  _hexUppercase = Common::Base::hexUppercase();
+  _defaultBase = Common::Base::format();
+
+  _valueStringList.resize(size);
+  for(int i = 0; i < size; ++i)
+    if(reformat || _valueList[i] != vlist[i])
+      _valueStringList[i] = Common::Base::toString(vlist[i], _base);
 
   _addrList    = alist;
   _valueList   = vlist;
   _changedList = changed;
 
-  // An efficiency thing
-  string temp;
-  for(int i = 0; i < size; ++i)
-    _valueStringList.push_back(Common::Base::toString(_valueList[i], _base));
-
   /*
   cerr << "_addrList.size() = "     << _addrList.size()
        << ", _valueList.size() = "   << _valueList.size()
@@ -154,6 +157,8 @@ void DataGridWidget::setList(const IntArray& alist, const IntArray& vlist,
 
     setDirty();
   }
+  else if(reformat)
+    setDirty();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -130,6 +130,10 @@ class DataGridWidget : public EditableWidget
     IntArray    _valueList;
     StringList  _valueStringList;
     BoolArray   _changedList;
+
+    // The global number format _valueStringList was created with
+    bool _hexUppercase{false};
+    Common::Base::Fmt _defaultBase{Common::Base::Fmt::_DEFAULT};
     BoolArray   _hiliteList;
 
     int       _selectedItem{0};
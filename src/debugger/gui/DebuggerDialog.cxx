@@ -28,6 +28,7 @@
 #include "TiaZoomWidget.hxx"
 #include "AudioWidget.hxx"
 #include "PromptWidget.hxx"
+#include "ProfileWidget.hxx"
 #include "CpuWidget.hxx"
 #include "RiotRamWidget.hxx"
 #include "RiotWidget.hxx"
@@ -495,6 +496,13 @@ void DebuggerDialog::addTabArea()
   myTab->setParentWidget(tabID, aud);
   addToFocusList(aud->getFocusList(), myTab, tabID);
 
+  // The cycle profile tab
+  tabID = myTab->addTab("Profile");
+  ProfileWidget* prof = new ProfileWidget(myTab, *myLFont, *myNFont,
+                                          2, 2, widWidth, widHeight);
+  myTab->setParentWidget(tabID, prof);
+  addToFocusList(prof->getFocusList(), myTab, tabID);
+
   myTab->setActiveTab(0);
 }
 
@@ -0,0 +1,136 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "Font.hxx"
+#include "GuiObject.hxx"
+#include "OSystem.hxx"
+#include "Debugger.hxx"
+#include "DebuggerParser.hxx"
+#include "CartDebug.hxx"
+#include "CpuProfiler.hxx"
+#include "M6502.hxx"
+#include "PromptWidget.hxx"
+#include "StringListWidget.hxx"
+#include "Widget.hxx"
+#include "ProfileWidget.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ProfileWidget::ProfileWidget(GuiObject* boss, const GUI::Font& lfont,
+                             const GUI::Font& nfont,
+                             int x, int y, int w, int h)
+  : Widget(boss, lfont, x, y, w, h),
+    CommandSender(boss)
+{
+  const int fontWidth  = lfont.getMaxCharWidth(),
+            lineHeight = lfont.getLineHeight(),
+            buttonW = 7 * fontWidth;
+  int xpos = 10, ypos = 10;
+
+  myStartStop = new ButtonWidget(boss, lfont, xpos, ypos, buttonW, lineHeight,
+                                 "Start", kStartStopCmd);
+  myStartStop->setTarget(this);
+  addFocusWidget(myStartStop);
+
+  xpos += buttonW + 10;
+  myFastMode = new CheckboxWidget(boss, lfont, xpos, ypos + 1, "Fast mode");
+  myFastMode->setToolTip("Count per address only.\n"
+                         "No banks and call stacks, but less overhead.");
+  addFocusWidget(myFastMode);
+
+  xpos = myFastMode->getRight() + 20;
+  mySave = new ButtonWidget(boss, lfont, xpos, ypos, buttonW, lineHeight,
+                            "Save", kSaveCmd);
+  mySave->setToolTip("Save call stacks for flame graphs.");
+  mySave->setTarget(this);
+  addFocusWidget(mySave);
+
+  xpos = 10;  ypos += lineHeight + 6;
+  myStatus = new StaticTextWidget(boss, lfont, xpos, ypos, w - 20, lfont.getFontHeight(),
+                                  "", TextAlign::Left);
+
+  ypos += lineHeight + 2;
+  myHotSpots = new StringListWidget(boss, nfont, xpos, ypos, w - 20, h - ypos - 10,
+                                    false);
+  myHotSpots->setEditable(false);
+  addFocusWidget(myHotSpots);
+
+  setHelpAnchor("ProfileTab", true);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ProfileWidget::loadConfig()
+{
+  Debugger& dbg = instance().debugger();
+  const M6502& cpu = dbg.m6502();
+  const CpuProfiler* profiler = cpu.cpuProfiler();
+
+  myStartStop->setLabel(cpu.isProfiling() ? "Stop" : "Start");
+  myFastMode->setEnabled(!cpu.isProfiling());
+  mySave->setEnabled(profiler && profiler->mode() == CpuProfiler::Mode::Full);
+
+  StringList list;
+  if(profiler && profiler->totalCycles())
+  {
+    ostringstream buf;
+    buf << (cpu.isProfiling() ? "Profiling, " : "Stopped, ") << profiler->totalCycles()
+        << " cycles (" << (profiler->mode() == CpuProfiler::Mode::Fast ? "fast" : "full")
+        << " mode)";
+    myStatus->setLabel(buf.str());
+
+    list.push_back("  cycles       %      count  address");
+    for(const auto& spot: profiler->hotSpots(MAX_SPOTS))
+    {
+      buf.str("");
+      buf << std::setw(8) << spot.cycles << "  " << std::setw(5) << std::fixed
+          << std::setprecision(1) << (spot.cycles * 100.0 / profiler->totalCycles())
+          << "%  " << std::setw(9) << spot.count << "  "
+          << dbg.cartDebug().getLabel(spot.addr, true, 4);
+      if(spot.bank != CpuProfiler::NO_BANK)
+        buf << " (bank " << spot.bank << ")";
+      list.push_back(buf.str());
+    }
+  }
+  else
+    myStatus->setLabel(cpu.isProfiling() ? "Profiling, no cycles yet" : "No profile recorded");
+
+  myHotSpots->setList(list);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ProfileWidget::handleCommand(CommandSender* sender, int cmd, int data, int id)
+{
+  Debugger& dbg = instance().debugger();
+
+  switch(cmd)
+  {
+    case kStartStopCmd:
+      if(dbg.m6502().isProfiling())
+        dbg.parser().run("profile");
+      else
+        dbg.parser().run(myFastMode->getState() ? "profile fast" : "profile full");
+      loadConfig();
+      break;
+
+    case kSaveCmd:
+      dbg.prompt().print(dbg.parser().run("profile save") + '\n');
+      dbg.prompt().printPrompt();
+      break;
+
+    default:
+      break;
+  }
+}
@@ -0,0 +1,68 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef PROFILE_WIDGET_HXX
+#define PROFILE_WIDGET_HXX
+
+class GuiObject;
+class ButtonWidget;
+class CheckboxWidget;
+class StaticTextWidget;
+class StringListWidget;
+
+#include "Widget.hxx"
+#include "Command.hxx"
+
+/**
+  Controls the cycle profiler (see CpuProfiler) and lists the hot spots
+  of the current profile.
+*/
+class ProfileWidget : public Widget, public CommandSender
+{
+  public:
+    ProfileWidget(GuiObject* boss, const GUI::Font& lfont, const GUI::Font& nfont,
+                  int x, int y, int w, int h);
+    ~ProfileWidget() override = default;
+
+  private:
+    enum {
+      kStartStopCmd = 'PRss',
+      kSaveCmd      = 'PRsv'
+    };
+
+    // The number of hot spots listed
+    static constexpr uInt32 MAX_SPOTS = 64;
+
+    ButtonWidget* myStartStop{nullptr};
+    CheckboxWidget* myFastMode{nullptr};
+    ButtonWidget* mySave{nullptr};
+    StaticTextWidget* myStatus{nullptr};
+    StringListWidget* myHotSpots{nullptr};
+
+  private:
+    void handleCommand(CommandSender* sender, int cmd, int data, int id) override;
+    void loadConfig() override;
+
+    // Following constructors and assignment operators not supported
+    ProfileWidget() = delete;
+    ProfileWidget(const ProfileWidget&) = delete;
+    ProfileWidget(ProfileWidget&&) = delete;
+    ProfileWidget& operator=(const ProfileWidget&) = delete;
+    ProfileWidget& operator=(ProfileWidget&&) = delete;
+};
+
+#endif
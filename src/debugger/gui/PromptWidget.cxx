@@ -56,6 +56,7 @@ PromptWidget::PromptWidget(GuiObject* boss, const GUI::Font& font,
   _lineWidth = (_w - ScrollBarWidget::scrollBarWidth(_font) - 2) / _kConsoleCharWidth;
   _linesPerPage = (_h - 2) / _kConsoleLineHeight;
   _linesInBuffer = kBufferSize / _lineWidth;
+  _buffer.resize(kBufferSize);
 
   // Add scrollbar
   _scrollBar = new ScrollBarWidget(boss, font, _x + _w, _y,
@@ -90,11 +91,13 @@ void PromptWidget::drawWidget(bool hilite)
         fgcolor = _bgcolor;
         bgcolor = ColorId((c & 0x1ffff) >> 8);
         s.fillRect(x, y, _kConsoleCharWidth, _kConsoleCharHeight, bgcolor);
+        s.drawChar(_font, c & 0x7f, x, y, fgcolor);
       }
-      else
+      else if((c & 0x7f) > ' ')  // the background is cleared already
+      {
         fgcolor = ColorId(c >> 8);
-
-      s.drawChar(_font, c & 0x7f, x, y, fgcolor);
+        s.drawChar(_font, c & 0x7f, x, y, fgcolor);
+      }
       x += _kConsoleCharWidth;
     }
     y += _kConsoleLineHeight;
@@ -827,6 +830,9 @@ void PromptWidget::updateScrollBuffer()
     _firstLineInBuffer = firstline;
   }
 
+  if(_printing)
+    return;
+
   _scrollBar->_numEntries = numlines;
   _scrollBar->_currentPos = _scrollBar->_numEntries - (line - _scrollLine + _linesPerPage);
   _scrollBar->_entriesPerPage = _linesPerPage;
@@ -881,14 +887,38 @@ void PromptWidget::putcharIntern(int c)
       updateScrollBuffer();
     }
   }
-  setDirty();
+  if(!_printing)
+    setDirty();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void PromptWidget::print(const string& str)
 {
-  for(char c: str)
-    putcharIntern(c);
+  const char* text = str.data();
+  const char* const end = text + str.size();
+
+  // Text which doesn't fit into the buffer would be scrolled out right away,
+  // so only the last lines of long output are printed (colors are reset at
+  // each new line, so skipping whole lines changes nothing else)
+  if(str.size() > size_t(kBufferSize))
+  {
+    int lines = 0;
+    for(const char* p = end - 1; p > text; --p)
+      if(*p == '\n' && ++lines > _linesInBuffer)
+      {
+        text = p + 1;
+        nextLine();
+        break;
+      }
+  }
+
+  _printing = true;
+  for(; text < end; ++text)
+    putcharIntern(*text);
+  _printing = false;
+
+  updateScrollBuffer();
+  setDirty();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -931,18 +961,19 @@ void PromptWidget::scrollToCurrent()
 string PromptWidget::saveBuffer(const FilesystemNode& file)
 {
   stringstream out;
-  for(int start = 0; start < _promptStartPos; start += _lineWidth)
+  for(int start = _firstLineInBuffer * _lineWidth; start < _promptStartPos;
+      start += _lineWidth)
   {
     int end = start + _lineWidth - 1;
 
     // Look for first non-space, printing char from end of line
-    while( char(_buffer[end] & 0xff) <= ' ' && end >= start)
+    while(end >= start && char(buffer(end) & 0xff) <= ' ')
       end--;
 
     // Spit out the line minus its trailing junk
     // Strip off any color/inverse bits
     for(int j = start; j <= end; ++j)
-      out << char(_buffer[j] & 0xff);
+      out << char(buffer(j) & 0xff);
 
     // add a \n
     out << endl;
@@ -965,7 +996,7 @@ void PromptWidget::clearScreen()
   _scrollLine = _linesPerPage - 1;
   _firstLineInBuffer = 0;
   _promptStartPos = _promptEndPos = -1;
-  memset(_buffer, 0, kBufferSize * sizeof(int));
+  std::fill(_buffer.begin(), _buffer.end(), 0);
 
   if(!_firstTime)
     updateScrollBuffer();
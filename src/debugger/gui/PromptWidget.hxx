@@ -58,7 +58,7 @@ class PromptWidget : public Widget, public CommandSender
   protected:
     ATTRIBUTE_FMT_PRINTF int printf(const char* format, ...);
     ATTRIBUTE_FMT_PRINTF int vprintf(const char* format, va_list argptr);
-    int& buffer(int idx) { return _buffer[idx % kBufferSize]; }
+    int& buffer(int idx) { return _buffer[idx & (kBufferSize - 1)]; }
 
     void drawWidget(bool hilite) override;
     void drawCaret();
@@ -101,12 +101,13 @@ class PromptWidget : public Widget, public CommandSender
 
   private:
     enum {
-      kBufferSize = 32768,
+      kBufferSize = 1 << 18,  // must be a power of two
       kLineBufferSize = 256,
       kHistorySize = 1000
     };
 
-    int  _buffer[kBufferSize];  // NOLINT  (will be rewritten soon)
+    // Ring buffer of character cells, _lineWidth cells per line
+    std::vector<int> _buffer;
     int  _linesInBuffer;
 
     int  _lineWidth;
@@ -132,6 +133,9 @@ class PromptWidget : public Widget, public CommandSender
     bool _inverse{false};
     bool _firstTime{true};
     bool _exitedEarly{false};
+    // Set while print() appends a block of text; the scrollbar is only
+    // updated (and the widget marked dirty) once it is complete
+    bool _printing{false};
 
     int historyDir(int& index, int direction);
     void historyAdd(const string& entry);
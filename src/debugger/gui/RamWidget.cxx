@@ -405,30 +405,13 @@ string RamWidget::doSearch(const string& str)
 
   int searchVal = instance().debugger().stringToValue(str);
 
-  // Clear the search array of previous items
-  mySearchAddr.clear();
-  mySearchValue.clear();
-  mySearchState.clear();
-
-  // Now, search all memory locations for this value, and add it to the
-  // search array
+  // Start a new search over all memory locations; unless all of them are
+  // requested, keep only those holding the value
   const ByteArray& ram = currentRam(0);
-  bool hitfound = false;
-  for(uInt32 addr = 0; addr < ram.size(); ++addr)
-  {
-    int value = ram[addr];
-    if(comparisonSearch && searchVal != value)
-    {
-      mySearchState.push_back(false);
-    }
-    else
-    {
-      mySearchAddr.push_back(addr);
-      mySearchValue.push_back(value);
-      mySearchState.push_back(true);
-      hitfound = true;
-    }
-  }
+  mySearch.start(ram);
+  if(comparisonSearch)
+    mySearch.filter(ram, RamSearch::Compare::Equal, searchVal);
+  bool hitfound = mySearch.count() > 0;
 
   // If we have some hits, enable the comparison methods
   if(hitfound)
@@ -481,33 +464,11 @@ string RamWidget::doCompare(const string& str)
 
   // Now, search all memory locations previously 'found' for this value
   const ByteArray& ram = currentRam(0);
-  bool hitfound = false;
-  IntArray tempAddrList, tempValueList;
-  mySearchState.clear();
-  for(uInt32 i = 0; i < ram.size(); ++i)
-    mySearchState.push_back(false);
-
-  for(uInt32 i = 0; i < mySearchAddr.size(); ++i)
-  {
-    if(comparativeSearch)
-    {
-      searchVal = mySearchValue[i] + offset;
-      if(searchVal < 0 || searchVal > 255)
-        continue;
-    }
-
-    int addr = mySearchAddr[i];
-    if(ram[addr] == searchVal)
-    {
-      tempAddrList.push_back(addr);
-      tempValueList.push_back(searchVal);
-      mySearchState[addr] = hitfound = true;
-    }
-  }
-
-  // Update the searchArray for the new addresses and data
-  mySearchAddr = tempAddrList;
-  mySearchValue = tempValueList;
+  if(comparativeSearch)
+    mySearch.filter(ram, RamSearch::Compare::ChangedBy, offset);
+  else
+    mySearch.filter(ram, RamSearch::Compare::Equal, searchVal);
+  bool hitfound = mySearch.count() > 0;
 
   // If we have some hits, enable the comparison methods
   if(hitfound)
@@ -526,9 +487,7 @@ string RamWidget::doCompare(const string& str)
 void RamWidget::doRestart()
 {
   // Erase all search buffers, reset to start mode
-  mySearchAddr.clear();
-  mySearchValue.clear();
-  mySearchState.clear();
+  mySearch.reset();
   showSearchResults();
 
   mySearchButton->setEnabled(true);
@@ -542,15 +501,7 @@ void RamWidget::showSearchResults()
   // Only update the search results for the bank currently being shown
   BoolArray temp;
   uInt32 start = myCurrentRamBank * myPageSize;
-  if(mySearchState.size() == 0 || start > mySearchState.size())
-  {
-    for(uInt32 i = 0; i < myPageSize; ++i)
-      temp.push_back(false);
-  }
-  else
-  {
-    for(uInt32 i = start; i < start + myPageSize; ++i)
-      temp.push_back(mySearchState[i]);
-  }
+  for(uInt32 i = start; i < start + myPageSize; ++i)
+    temp.push_back(mySearch.isCandidate(i));
   myRamGrid->setHiliteList(temp);
 }
@@ -29,6 +29,7 @@ class InputTextDialog;
 
 #include "Widget.hxx"
 #include "Command.hxx"
+#include "RamSearch.hxx"
 
 class RamWidget : public Widget, public CommandSender
 {
@@ -113,9 +114,7 @@ class RamWidget : public Widget, public CommandSender
     ButtonWidget* myRestartButton{nullptr};
 
     ByteArray myOldValueList;
-    IntArray mySearchAddr;
-    IntArray mySearchValue;
-    BoolArray mySearchState;
+    RamSearch mySearch;
 
   private:
     // Following constructors and assignment operators not supported
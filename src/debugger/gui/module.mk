@@ -67,6 +67,7 @@ MODULE_OBJS := \
         src/debugger/gui/KeyboardWidget.o \
         src/debugger/gui/PaddleWidget.o \
         src/debugger/gui/PointingDeviceWidget.o \
+        src/debugger/gui/ProfileWidget.o \
         src/debugger/gui/PromptWidget.o \
         src/debugger/gui/QuadTariWidget.o \
         src/debugger/gui/RamWidget.o \
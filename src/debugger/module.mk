@@ -2,12 +2,20 @@ MODULE := src/debugger
 
 MODULE_OBJS := \
         src/debugger/BreakpointMap.o \
+        src/debugger/CompiledExpression.o \
+        src/debugger/CompletionTrie.o \
+        src/debugger/ConditionList.o \
+        src/debugger/CpuProfiler.o \
+        src/debugger/CpuTrace.o \
         src/debugger/Debugger.o \
         src/debugger/DebuggerParser.o \
         src/debugger/CartDebug.o \
         src/debugger/CpuDebug.o \
         src/debugger/DiStella.o \
+        src/debugger/RamSearch.o \
+        src/debugger/ReverseStepper.o \
         src/debugger/RiotDebug.o \
+        src/debugger/ThumbProfiler.o \
         src/debugger/TIADebug.o
 
 MODULE_DIRS += \
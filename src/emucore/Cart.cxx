@@ -19,6 +19,8 @@
 #include "Settings.hxx"
 #include "System.hxx"
 #include "MD5.hxx"
+#include "MemoryUsage.hxx"
+#include "Serializer.hxx"
 #ifdef DEBUGGER_SUPPORT
   #include "Debugger.hxx"
   #include "Base.hxx"
@@ -58,13 +60,16 @@ bool Cartridge::saveROM(const FilesystemNode& out) const
   try
   {
     size_t size = 0;
-    const ByteBuffer& image = getImage(size);
+    const uInt8* image = getImage(size);
     if(size == 0)
     {
       cerr << "save not supported" << endl;
       return false;
     }
-    out.write(image, size);
+    // FilesystemNode::write() only accepts an owned buffer
+    ByteBuffer buffer = make_unique<uInt8[]>(size);
+    std::copy_n(image, size, buffer.get());
+    out.write(buffer, size);
   }
   catch(...)
   {
@@ -129,28 +134,80 @@ void Cartridge::pokeRAM(uInt8& dest, uInt16 address, uInt8 value)
   dest = value;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge::addMemoryUsage(MemoryUsage& usage) const
+{
+  size_t size = 0;
+  getImage(size);
+
+  usage.add(MemoryUsage::Category::romImage, size);
+  usage.add(MemoryUsage::Category::cartRAM, internalRamSize());
+  if(myRomAccessBase)
+    usage.add(MemoryUsage::Category::accessArrays,
+              myAccessSize * (sizeof(Device::AccessFlags) + 2 * sizeof(Device::AccessCounter)));
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Cartridge::createRomAccessArrays(size_t size)
 {
   myAccessSize = uInt32(size);
-#ifdef DEBUGGER_SUPPORT
-  myRomAccessBase = make_unique<Device::AccessFlags[]>(size);
-  std::fill_n(myRomAccessBase.get(), size, Device::ROW);
-  myRomAccessCounter = make_unique<Device::AccessCounter[]>(size * 2);
-  std::fill_n(myRomAccessCounter.get(), size * 2, 0);
-#else
   myRomAccessBase = nullptr;
   myRomAccessCounter = nullptr;
+#ifdef DEBUGGER_SUPPORT
+  // Without access tracking, the arrays are only allocated on demand
+  if(myRomAccessEnabled)
+    allocateRomAccessArrays();
 #endif
 }
 
 #ifdef DEBUGGER_SUPPORT
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge::allocateRomAccessArrays()
+{
+  if(myAccessSize == 0)
+    return;
+
+  myRomAccessBase = make_unique<Device::AccessFlags[]>(myAccessSize);
+  std::fill_n(myRomAccessBase.get(), myAccessSize, Device::ROW);
+  myRomAccessCounter = make_unique<Device::AccessCounter[]>(myAccessSize * 2);
+  std::fill_n(myRomAccessCounter.get(), myAccessSize * 2, 0);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge::enableRomAccessArrays()
+{
+  if(myRomAccessEnabled)
+    return;
+
+  myRomAccessEnabled = true;
+  allocateRomAccessArrays();
+
+  // When already installed, the page accesses still point nowhere. The
+  // current bank layout is restored by saving the state, installing the
+  // cart again (which points all pages into the new arrays) and reloading
+  // the state (which re-applies the banks).  What happened before can't be
+  // reconstructed; all flags start as ROW and all counters at zero.
+  if(mySystem != nullptr && myRomAccessBase)
+  {
+    Serializer state;
+    if(save(state))
+    {
+      install(*mySystem);
+      state.rewind();
+      load(state);
+    }
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string Cartridge::getAccessCounters() const
 {
   ostringstream out;
   uInt32 offset = 0;
 
+  if(!myRomAccessCounter)
+    return out.str();
+
   for(uInt16 bank = 0; bank < romBankCount(); ++bank)
   {
     uInt16 origin = bankOrigin(bank);
@@ -197,7 +254,7 @@ uInt16 Cartridge::bankOrigin(uInt16 bank) const
   //addrMask;
 
   count.fill(0);
-  for(uInt16 addr = 0x0000; addr < bankSize(bank); ++addr)
+  for(uInt16 addr = 0x0000; myRomAccessBase && addr < bankSize(bank); ++addr)
   {
     Device::AccessFlags flags = myRomAccessBase[offset + addr];
     // only count really accessed addresses
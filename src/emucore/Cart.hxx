@@ -19,6 +19,8 @@
 #define CARTRIDGE_HXX
 
 class Cartridge;
+class CartridgeARM;
+class MemoryUsage;
 class Properties;
 class FilesystemNode;
 class CartDebugWidget;
@@ -128,6 +130,22 @@ class Cartridge : public Device
     */
     virtual uInt8 internalRamGetValue(uInt16 addr) const { return 0; }
 
+    /**
+      Get direct access to the extended RAM of the cart, for frontends
+      which inspect and modify it while the emulation is running.
+
+      @param size  Set to the size of the RAM in bytes
+      @return  Pointer to the RAM, or nullptr if the cart has none
+    */
+    virtual uInt8* getRAM(size_t& size) { size = 0; return nullptr; }
+
+    /**
+      Add the memory held by the cart (ROM image, RAM and access arrays)
+      to the given usage.  Carts which keep further copies of the ROM add
+      these as well.
+    */
+    virtual void addMemoryUsage(MemoryUsage& usage) const;
+
   #ifdef DEBUGGER_SUPPORT
     /**
       To be called at the start of each instruction.
@@ -172,6 +190,13 @@ class Cartridge : public Device
       @return  The origin of the bank
     */
     uInt16 bankOrigin(uInt16 bank) const;
+
+    /**
+      Allocate the code-access arrays, if not done yet.  Called when access
+      tracking is enabled.  If the cart is already installed, the page
+      accesses are set up again for the current banks.
+    */
+    void enableRomAccessArrays();
   #endif
 
   public:
@@ -247,9 +272,9 @@ class Cartridge : public Device
       Access the internal ROM image for this cartridge.
 
       @param size  Set to the size of the internal ROM image data
-      @return  A reference to the internal ROM image data
+      @return  A pointer to the internal ROM image data
     */
-    virtual const ByteBuffer& getImage(size_t& size) const = 0;
+    virtual const uInt8* getImage(size_t& size) const = 0;
 
     /**
       Get a descriptor for the cart name.
@@ -274,6 +299,12 @@ class Cartridge : public Device
     */
     virtual uInt32 thumbCallback(uInt8 function, uInt32 value1, uInt32 value2) { return 0; }
 
+    /**
+      Get the cartridge as an ARM based one (i.e. one running code in the
+      Thumbulator), or nullptr if it isn't.
+    */
+    virtual CartridgeARM* arm() { return nullptr; }
+
   #ifdef DEBUGGER_SUPPORT
     /**
       Get optional debugger widget responsible for displaying info about the cart.
@@ -324,14 +355,39 @@ class Cartridge : public Device
     void pokeRAM(uInt8& dest, uInt16 address, uInt8 value);
 
     /**
-      Create an array that holds code-access information for every byte
+      Define the arrays that hold code-access information for every byte
       of the ROM (indicated by 'size').  Note that this is only used by
-      the debugger, and is unavailable otherwise.
+      the debugger, and is unavailable otherwise.  The arrays are only
+      allocated once access tracking is enabled (see
+      enableRomAccessArrays()); until then, the page accesses get nullptr.
 
       @param size  The size of the code-access array to create
     */
     void createRomAccessArrays(size_t size);
 
+  #ifdef DEBUGGER_SUPPORT
+    /**
+      Allocate and clear the code-access arrays.
+    */
+    void allocateRomAccessArrays();
+  #endif
+
+    /**
+      Pointers into the code-access arrays, for setting up page accesses.
+      These are nullptr as long as the arrays aren't allocated.
+
+      @param offset  The offset into the ROM access area
+    */
+    Device::AccessFlags* romAccessBase(size_t offset) const {
+      return myRomAccessBase ? &myRomAccessBase[offset] : nullptr;
+    }
+    Device::AccessCounter* romPeekCounter(size_t offset) const {
+      return myRomAccessCounter ? &myRomAccessCounter[offset] : nullptr;
+    }
+    Device::AccessCounter* romPokeCounter(size_t offset) const {
+      return myRomAccessCounter ? &myRomAccessCounter[offset + myAccessSize] : nullptr;
+    }
+
     /**
       Fill the given RAM array with (possibly random) data.
 
@@ -390,7 +446,10 @@ class Cartridge : public Device
     uInt16 myRamWriteAccess{0};
 
     // Total size of ROM access area (might include RAM too)
-    uInt32 myAccessSize;
+    uInt32 myAccessSize{0};
+
+    // Whether the ROM access arrays are allocated (on first tracking use)
+    bool myRomAccessEnabled{false};
 
   private:
     // The startup bank to use (where to look for the reset vector address)
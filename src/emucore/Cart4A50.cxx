@@ -186,6 +186,9 @@ bool Cartridge4A50::poke(uInt16 address, uInt8 value)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Device::AccessFlags Cartridge4A50::getAccessFlags(uInt16 address) const
 {
+  if(!myRomAccessBase)
+    return 0;
+
   if((address & 0x1800) == 0x1000)           // 2K region from 0x1000 - 0x17ff
   {
     if(myIsRomLow)
@@ -218,6 +221,9 @@ Device::AccessFlags Cartridge4A50::getAccessFlags(uInt16 address) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Cartridge4A50::setAccessFlags(uInt16 address, Device::AccessFlags flags)
 {
+  if(!myRomAccessBase)
+    return;
+
   if((address & 0x1800) == 0x1000)           // 2K region from 0x1000 - 0x17ff
   {
     if(myIsRomLow)
@@ -351,10 +357,10 @@ bool Cartridge4A50::patch(uInt16 address, uInt8 value)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-const ByteBuffer& Cartridge4A50::getImage(size_t& size) const
+const uInt8* Cartridge4A50::getImage(size_t& size) const
 {
   size = mySize;
-  return myImage;
+  return myImage.get();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
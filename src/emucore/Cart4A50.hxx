@@ -96,9 +96,9 @@ class Cartridge4A50 : public Cartridge
       Access the internal ROM image for this cartridge.
 
       @param size  Set to the size of the internal ROM image data
-      @return  A reference to the internal ROM image data
+      @return  A pointer to the internal ROM image data
     */
-    const ByteBuffer& getImage(size_t& size) const override;
+    const uInt8* getImage(size_t& size) const override;
 
     /**
       Save the current state of this cart to the given Serializer.
@@ -46,8 +46,11 @@ class Cartridge4K : public CartridgeEnhanced
       @param settings  A reference to the various settings (read-only)
       @param bsSize    The size specified by the bankswitching scheme
     */
-    Cartridge4K(const ByteBuffer& image, size_t size, const string& md5,
+    Cartridge4K(const uInt8* image, size_t size, const string& md5,
                 const Settings& settings, size_t bsSize = 4_KB);
+    Cartridge4K(const ByteBuffer& image, size_t size, const string& md5,
+                const Settings& settings, size_t bsSize = 4_KB)
+      : Cartridge4K(image.get(), size, md5, settings, bsSize) { }
     ~Cartridge4K() override = default;
 
   public:
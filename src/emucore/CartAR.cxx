@@ -18,6 +18,8 @@
 #include "M6502.hxx"
 #include "System.hxx"
 #include "Settings.hxx"
+#include "MemoryUsage.hxx"
+#include "EventCounters.hxx"
 #include "CartAR.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -36,6 +38,12 @@ CartridgeAR::CartridgeAR(const ByteBuffer& image, size_t size,
     std::copy_n(ourDefaultHeader.data(), ourDefaultHeader.size(),
                 myLoadImages.get()+myImage.size());
 
+  // Index the loads by their number; the first one wins if a number
+  // appears more than once
+  myLoadIndex.fill(-1);
+  for(Int16 image = myNumberOfLoadImages - 1; image >= 0; --image)
+    myLoadIndex[myLoadImages[(image * 8448) + myImage.size() + 5]] = image;
+
   // We use System::PageAccess.romAccessBase, but don't allow its use
   // through a pointer, since the AR scheme doesn't support bankswitching
   // in the normal sense
@@ -195,6 +203,9 @@ bool CartridgeAR::poke(uInt16 addr, uInt8)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Device::AccessFlags CartridgeAR::getAccessFlags(uInt16 address) const
 {
+  if(!myRomAccessBase)
+    return 0;
+
   return myRomAccessBase[(address & 0x07FF) +
            myImageOffset[(address & 0x0800) ? 1 : 0]];
 }
@@ -202,6 +213,9 @@ Device::AccessFlags CartridgeAR::getAccessFlags(uInt16 address) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeAR::setAccessFlags(uInt16 address, Device::AccessFlags flags)
 {
+  if(!myRomAccessBase)
+    return;
+
   myRomAccessBase[(address & 0x07FF) +
     myImageOffset[(address & 0x0800) ? 1 : 0]] |= flags;
 }
@@ -293,6 +307,7 @@ bool CartridgeAR::bankConfiguration(uInt8 configuration)
       break;
     }
   }
+  EventCounters::count(EventCounters::Event::bankSwitch);
   return myBankChanged = true;
 }
 
@@ -304,20 +319,21 @@ void CartridgeAR::initializeROM()
   // contents placed in the ourDummyROMCode array), the offsets will
   // almost definitely change
 
+  // Initialize ROM with illegal 6502 opcode that causes a real 6502 to jam
+  std::fill_n(myImage.begin() + (3<<11), 2_KB, 0x02);
+
+  // Copy the "dummy" Supercharger BIOS code into the ROM area (the code is
+  // shared by all instances, so only the copy is patched below)
+  std::copy_n(ourDummyROMCode.data(), ourDummyROMCode.size(), myImage.data() + (3<<11));
+
   // The scrom.asm code checks a value at offset 109 as follows:
   //   0xFF -> do a complete jump over the SC BIOS progress bars code
   //   0x00 -> show SC BIOS progress bars as normal
-  ourDummyROMCode[109] = mySettings.getBool("fastscbios") ? 0xFF : 0x00;
+  myImage[(3<<11) + 109] = mySettings.getBool("fastscbios") ? 0xFF : 0x00;
 
   // The accumulator should contain a random value after exiting the
   // SC BIOS code - a value placed in offset 281 will be stored in A
-  ourDummyROMCode[281] = mySystem->randGenerator().next();
-
-  // Initialize ROM with illegal 6502 opcode that causes a real 6502 to jam
-  std::fill_n(myImage.begin() + (3<<11), 2_KB, 0x02);
-
-  // Copy the "dummy" Supercharger BIOS code into the ROM area
-  std::copy_n(ourDummyROMCode.data(), ourDummyROMCode.size(), myImage.data() + (3<<11));
+  myImage[(3<<11) + 281] = mySystem->randGenerator().next();
 
   // Finally set 6502 vectors to point to initial load code at 0xF80A of BIOS
   myImage[(3<<11) + 2044] = 0x0A;
@@ -340,50 +356,45 @@ uInt8 CartridgeAR::checksum(uInt8* s, uInt16 length)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeAR::loadIntoRAM(uInt8 load)
 {
-  uInt16 image;
-
-  // Scan through all of the loads to see if we find the one we're looking for
-  for(image = 0; image < myNumberOfLoadImages; ++image)
+  // Find the image containing the requested load
+  const Int16 image = myLoadIndex[load];
+  if(image >= 0)
   {
-    // Is this the correct load?
-    if(myLoadImages[(image * 8448) + myImage.size() + 5] == load)
-    {
-      // Copy the load's header
-      std::copy_n(myLoadImages.get() + (image * 8448) + myImage.size(), myHeader.size(), myHeader.data());
+    // Copy the load's header
+    std::copy_n(myLoadImages.get() + (image * 8448) + myImage.size(), myHeader.size(), myHeader.data());
+
+    // Verify the load's header
+    if(checksum(myHeader.data(), 8) != 0x55)
+      cerr << "WARNING: The Supercharger header checksum is invalid...\n";
 
-      // Verify the load's header
-      if(checksum(myHeader.data(), 8) != 0x55)
-        cerr << "WARNING: The Supercharger header checksum is invalid...\n";
+    // Load all of the pages from the load
+    bool invalidPageChecksumSeen = false;
+    for(uInt32 j = 0; j < myHeader[3]; ++j)
+    {
+      uInt32 bank = myHeader[16 + j] & 0x03;
+      uInt32 page = (myHeader[16 + j] >> 2) & 0x07;
+      uInt8* src = myLoadImages.get() + (image * 8448) + (j * 256);
+      uInt8 sum = checksum(src, 256) + myHeader[16 + j] + myHeader[64 + j];
 
-      // Load all of the pages from the load
-      bool invalidPageChecksumSeen = false;
-      for(uInt32 j = 0; j < myHeader[3]; ++j)
+      if(!invalidPageChecksumSeen && (sum != 0x55))
       {
-        uInt32 bank = myHeader[16 + j] & 0x03;
-        uInt32 page = (myHeader[16 + j] >> 2) & 0x07;
-        uInt8* src = myLoadImages.get() + (image * 8448) + (j * 256);
-        uInt8 sum = checksum(src, 256) + myHeader[16 + j] + myHeader[64 + j];
-
-        if(!invalidPageChecksumSeen && (sum != 0x55))
-        {
-          cerr << "WARNING: Some Supercharger page checksums are invalid...\n";
-          invalidPageChecksumSeen = true;
-        }
-
-        // Copy page to Supercharger RAM (don't allow a copy into ROM area)
-        if(bank < 3)
-          std::copy_n(src, 256, myImage.data() + (bank * 2048) + (page * 256));
+        cerr << "WARNING: Some Supercharger page checksums are invalid...\n";
+        invalidPageChecksumSeen = true;
       }
 
-      // Copy the bank switching byte and starting address into the 2600's
-      // RAM for the "dummy" SC BIOS to access it
-      mySystem->poke(0xfe, myHeader[0]);
-      mySystem->poke(0xff, myHeader[1]);
-      mySystem->poke(0x80, myHeader[2]);
-
-      myBankChanged = true;
-      return;
+      // Copy page to Supercharger RAM (don't allow a copy into ROM area)
+      if(bank < 3)
+        std::copy_n(src, 256, myImage.data() + (bank * 2048) + (page * 256));
     }
+
+    // Copy the bank switching byte and starting address into the 2600's
+    // RAM for the "dummy" SC BIOS to access it
+    mySystem->poke(0xfe, myHeader[0]);
+    mySystem->poke(0xff, myHeader[1]);
+    mySystem->poke(0x80, myHeader[2]);
+
+    myBankChanged = true;
+    return;
   }
 
   // TODO: Should probably switch to an internal ROM routine to display
@@ -420,10 +431,18 @@ bool CartridgeAR::patch(uInt16 address, uInt8 value)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-const ByteBuffer& CartridgeAR::getImage(size_t& size) const
+const uInt8* CartridgeAR::getImage(size_t& size) const
 {
   size = mySize;
-  return myLoadImages;
+  return myLoadImages.get();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeAR::addMemoryUsage(MemoryUsage& usage) const
+{
+  Cartridge::addMemoryUsage(usage);
+
+  usage.add(MemoryUsage::Category::cartRAM, myImage.size());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -440,12 +459,7 @@ bool CartridgeAR::save(Serializer& out) const
     // The 256 byte header for the current 8448 byte load
     out.putByteArray(myHeader.data(), myHeader.size());
 
-    // All of the 8448 byte loads associated with the game
-    // Note that the size of this array is myNumberOfLoadImages * 8448
-    out.putByteArray(myLoadImages.get(), myNumberOfLoadImages * 8448);
-
-    // Indicates how many 8448 loads there are
-    out.putByte(myNumberOfLoadImages);
+    // The loads themselves never change, and come with the ROM image
 
     // Indicates if the RAM is write enabled
     out.putBool(myWriteEnabled);
@@ -485,13 +499,6 @@ bool CartridgeAR::load(Serializer& in)
     // The 256 byte header for the current 8448 byte load
     in.getByteArray(myHeader.data(), myHeader.size());
 
-    // All of the 8448 byte loads associated with the game
-    // Note that the size of this array is myNumberOfLoadImages * 8448
-    in.getByteArray(myLoadImages.get(), myNumberOfLoadImages * 8448);
-
-    // Indicates how many 8448 loads there are
-    myNumberOfLoadImages = in.getByte();
-
     // Indicates if the RAM is write enabled
     myWriteEnabled = in.getBool();
 
@@ -517,7 +524,7 @@ bool CartridgeAR::load(Serializer& in)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-std::array<uInt8, 294> CartridgeAR::ourDummyROMCode = {
+const std::array<uInt8, 294> CartridgeAR::ourDummyROMCode = {
   0xa5, 0xfa, 0x85, 0x80, 0x4c, 0x18, 0xf8, 0xff,
   0xff, 0xff, 0x78, 0xd8, 0xa0, 0x00, 0xa2, 0x00,
   0x94, 0x00, 0xe8, 0xd0, 0xfb, 0x4c, 0x50, 0xf8,
@@ -105,9 +105,15 @@ class CartridgeAR : public Cartridge
       Access the internal ROM image for this cartridge.
 
       @param size  Set to the size of the internal ROM image data
-      @return  A reference to the internal ROM image data
+      @return  A pointer to the internal ROM image data
     */
-    const ByteBuffer& getImage(size_t& size) const override;
+    const uInt8* getImage(size_t& size) const override;
+
+    /**
+      Add the memory held by the cart; the loaded images are the ROM, and
+      the Supercharger's RAM (and BIOS) come on top.
+    */
+    void addMemoryUsage(MemoryUsage& usage) const override;
 
     /**
       Save the current state of this cart to the given Serializer.
@@ -209,6 +215,10 @@ class CartridgeAR : public Cartridge
     // Indicates how many 8448 loads there are
     uInt8 myNumberOfLoadImages{0};
 
+    // The image containing each load number (-1 if there is none), so that
+    // a load request doesn't have to search the loads
+    std::array<Int16, 256> myLoadIndex;
+
     // Indicates if the RAM is write enabled
     bool myWriteEnabled{false};
 
@@ -228,7 +238,7 @@ class CartridgeAR : public Cartridge
     uInt16 myCurrentBank{0};
 
     // Fake SC-BIOS code to simulate the Supercharger load bars
-    static std::array<uInt8, 294> ourDummyROMCode;
+    static const std::array<uInt8, 294> ourDummyROMCode;
 
     // Default 256-byte header to use if one isn't included in the ROM
     // This data comes from z26
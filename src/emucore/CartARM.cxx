@@ -17,6 +17,10 @@
 
 #include "System.hxx"
 #include "Settings.hxx"
+#include "MemoryUsage.hxx"
+#ifdef DEBUGGER_SUPPORT
+  #include "TIA.hxx"
+#endif
 #include "CartARM.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -25,11 +29,36 @@ CartridgeARM::CartridgeARM(const string& md5, const Settings& settings)
 {
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeARM::acquireImage(const string& md5, size_t size,
+                                const std::function<void(uInt8*)>& init)
+{
+  myImage = ImageCache::acquire(name() + ":" + md5, size, init);
+  myImageSize = size;
+  myImageShared = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeARM::unshareImage()
+{
+  if(!myImageShared)
+    return false;
+
+  myImage = ImageCache::copy(myImage, myImageSize);
+  myImageShared = false;
+  if(myThumbEmulator)
+    myThumbEmulator->setRom(reinterpret_cast<uInt16*>(myImage.get()));
+
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeARM::setInitialState()
 {
   bool devSettings = mySettings.getBool("dev.settings");
+  bool fastArm = mySettings.getBool("fastarm");
 
+  myThumbEmulator->enableThreadedCode(mySettings.getBool("threadedarm"));
   if(devSettings)
   {
     myIncCycles = mySettings.getBool("dev.thumb.inccycles");
@@ -38,9 +67,19 @@ void CartridgeARM::setInitialState()
   }
   else
   {
-    myIncCycles = false;
+    // Unless disabled, player settings skip counting the ARM cycles, which
+    // only a few games depend on
+    myIncCycles = !fastArm;
   }
-  enableCycleCount(devSettings);
+  enableCycleCount(devSettings || !fastArm);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeARM::addMemoryUsage(MemoryUsage& usage) const
+{
+  Cartridge::addMemoryUsage(usage);
+
+  usage.add(MemoryUsage::Category::romImage, myThumbEmulator->decodedRomSize());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -74,6 +113,14 @@ void CartridgeARM::updateCycles(int cycles)
 #endif
 }
 
+#ifdef DEBUGGER_SUPPORT
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeARM::startArmProfile()
+{
+  myThumbEmulator->startProfile([this]() { return mySystem->tia().frameCount(); });
+}
+#endif
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeARM::incCycles(bool enable)
 {
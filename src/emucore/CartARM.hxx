@@ -19,6 +19,7 @@
 #define CARTRIDGE_ARM_HXX
 
 #include "Thumbulator.hxx"
+#include "ImageCache.hxx"
 #include "Cart.hxx"
 
 /**
@@ -34,6 +35,24 @@ class CartridgeARM : public Cartridge
     CartridgeARM(const string& md5, const Settings& settings);
     ~CartridgeARM() override = default;
 
+    CartridgeARM* arm() override { return this; }
+
+  #ifdef DEBUGGER_SUPPORT
+    /**
+      Start/stop profiling the ARM code, per instruction, function and
+      frame (see ThumbProfiler).
+    */
+    void startArmProfile();
+    void stopArmProfile() { myThumbEmulator->stopProfile(); }
+    bool isArmProfiling() const { return myThumbEmulator->isProfiling(); }
+    const ThumbProfiler* armProfiler() const { return myThumbEmulator->profiler(); }
+  #endif
+
+    /**
+      Add the memory held by the cart, including the decoded ARM code.
+    */
+    void addMemoryUsage(MemoryUsage& usage) const override;
+
   protected:
     /**
       Notification method invoked by the system when the console type
@@ -85,7 +104,64 @@ class CartridgeARM : public Cartridge
     void setMamMode(Thumbulator::MamModeType mamMode) { myThumbEmulator->setMamMode(mamMode); }
     Thumbulator::MamModeType mamMode() const { return myThumbEmulator->mamMode(); }
 
+    /**
+      Get the ROM image from the process-wide image cache.  All carts
+      created from the same ROM share one read-only copy of it.
+
+      @param md5   The md5sum of the cart image
+      @param size  The size of the image to allocate
+      @param init  Fills the image in case it is not cached yet
+    */
+    void acquireImage(const string& md5, size_t size,
+                      const std::function<void(uInt8*)>& init);
+
+    /**
+      Replace a shared ROM image by a private copy (copy-on-write).  This
+      must be done before the image is modified.  The Thumbulator is
+      redirected to the new copy.
+
+      @return  True if the image was copied, which means that any other
+               pointers into the image must be updated
+    */
+    bool unshareImage();
+
+    /**
+      Read/write a 32-bit word in the memory shared with the ARM code (e.g.
+      a datastream pointer in the cart RAM), which is always little-endian.
+      On little-endian hosts this is a single load or store.
+    */
+    static uInt32 getWord(const uInt8* ptr)
+    {
+    #ifdef __BIG_ENDIAN__
+      return ptr[0] | (ptr[1] << 8) | (ptr[2] << 16) | (uInt32(ptr[3]) << 24);
+    #else
+      uInt32 value;
+      std::memcpy(&value, ptr, sizeof(value));
+      return value;
+    #endif
+    }
+    static void setWord(uInt8* ptr, uInt32 value)
+    {
+    #ifdef __BIG_ENDIAN__
+      ptr[0] = value & 0xff;
+      ptr[1] = (value >> 8) & 0xff;
+      ptr[2] = (value >> 16) & 0xff;
+      ptr[3] = (value >> 24) & 0xff;
+    #else
+      std::memcpy(ptr, &value, sizeof(value));
+    #endif
+    }
+
   protected:
+    // The ROM image of the cart, possibly shared with other carts
+    ImageCache::Image myImage;
+
+    // Size of the image
+    size_t myImageSize{0};
+
+    // Indicates that the image can be shared with other carts
+    bool myImageShared{false};
+
     // Pointer to the Thumb ARM emulator object
     unique_ptr<Thumbulator> myThumbEmulator;
 
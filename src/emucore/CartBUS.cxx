@@ -23,6 +23,7 @@
 #include "System.hxx"
 #include "M6532.hxx"
 #include "TIA.hxx"
+#include "EventCounters.hxx"
 #include "CartBUS.hxx"
 #include "exception/FatalEmulationError.hxx"
 
@@ -42,11 +43,13 @@
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 CartridgeBUS::CartridgeBUS(const ByteBuffer& image, size_t size,
                            const string& md5, const Settings& settings)
-  : CartridgeARM(md5, settings),
-    myImage{make_unique<uInt8[]>(32_KB)}
+  : CartridgeARM(md5, settings)
 {
-  // Copy the ROM image into my buffer
-  std::copy_n(image.get(), std::min(32_KB, size), myImage.get());
+  // Get the 32K ROM image, which is shared by all carts using the same ROM
+  acquireImage(md5, 32_KB, [&](uInt8* data) {
+    std::fill_n(data, 32_KB, 0);
+    std::copy_n(image.get(), std::min(32_KB, size), data);
+  });
 
   // Even though the ROM is 32K, only 28K is accessible to the 6507
   createRomAccessArrays(28_KB);
@@ -444,11 +447,12 @@ bool CartridgeBUS::bank(uInt16 bank, uInt16)
   // Map Program ROM image into the system
   for(uInt16 addr = 0x1040; addr < 0x2000; addr += System::PAGE_SIZE)
   {
-    access.romAccessBase = &myRomAccessBase[myBankOffset + (addr & 0x0FFF)];
-    access.romPeekCounter = &myRomAccessCounter[myBankOffset + (addr & 0x0FFF)];
-    access.romPokeCounter = &myRomAccessCounter[myBankOffset + (addr & 0x0FFF) + 28_KB];
+    access.romAccessBase = romAccessBase(myBankOffset + (addr & 0x0FFF));
+    access.romPeekCounter = romPeekCounter(myBankOffset + (addr & 0x0FFF));
+    access.romPokeCounter = romPokeCounter(myBankOffset + (addr & 0x0FFF));
     mySystem->setPageAccess(addr, access);
   }
+  EventCounters::count(EventCounters::Event::bankSwitch);
   return myBankChanged = true;
 }
 
@@ -472,6 +476,9 @@ bool CartridgeBUS::patch(uInt16 address, uInt8 value)
   // For now, we ignore attempts to patch the BUS address space
   if(address >= 0x0040)
   {
+    if(unshareImage())
+      myProgramImage = myImage.get() + 4_KB;
+
     myProgramImage[myBankOffset + (address & 0x0FFF)] = value;
     return myBankChanged = true;
   }
@@ -480,10 +487,10 @@ bool CartridgeBUS::patch(uInt16 address, uInt8 value)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-const ByteBuffer& CartridgeBUS::getImage(size_t& size) const
+const uInt8* CartridgeBUS::getImage(size_t& size) const
 {
   size = 32_KB;
-  return myImage;
+  return myImage.get();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -647,41 +654,28 @@ bool CartridgeBUS::load(Serializer& in)
 uInt32 CartridgeBUS::getDatastreamPointer(uInt8 index) const
 {
 //  index &= 0x0f;
-
-  return myRAM[DSxPTR + index*4 + 0]        +  // low byte
-        (myRAM[DSxPTR + index*4 + 1] << 8)  +
-        (myRAM[DSxPTR + index*4 + 2] << 16) +
-        (myRAM[DSxPTR + index*4 + 3] << 24) ;  // high byte
+  return getWord(myRAM.data() + DSxPTR + index*4);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeBUS::setDatastreamPointer(uInt8 index, uInt32 value)
 {
 //  index &= 0x0f;
-  myRAM[DSxPTR + index*4 + 0] = value & 0xff;          // low byte
-  myRAM[DSxPTR + index*4 + 1] = (value >> 8) & 0xff;
-  myRAM[DSxPTR + index*4 + 2] = (value >> 16) & 0xff;
-  myRAM[DSxPTR + index*4 + 3] = (value >> 24) & 0xff;  // high byte
+  setWord(myRAM.data() + DSxPTR + index*4, value);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 CartridgeBUS::getDatastreamIncrement(uInt8 index) const
 {
 //  index &= 0x0f;
-  return myRAM[DSxINC + index*4 + 0]        +   // low byte
-        (myRAM[DSxINC + index*4 + 1] << 8)  +
-        (myRAM[DSxINC + index*4 + 2] << 16) +
-        (myRAM[DSxINC + index*4 + 3] << 24) ;   // high byte
+  return getWord(myRAM.data() + DSxINC + index*4);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 CartridgeBUS::getAddressMap(uInt8 index) const
 {
   //  index &= 0x0f;
-  return myRAM[DSMAPS + index*4 + 0]        +   // low byte
-        (myRAM[DSMAPS + index*4 + 1] << 8)  +
-        (myRAM[DSMAPS + index*4 + 2] << 16) +
-        (myRAM[DSMAPS + index*4 + 3] << 24) ;   // high byte
+  return getWord(myRAM.data() + DSMAPS + index*4);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -699,12 +693,7 @@ uInt32 CartridgeBUS::getWaveform(uInt8 index) const
 //        (myBUSRAM[WAVEFORM + index*4 + 3] << 24) -   // high byte
 //         0x40000800;
 
-  uInt32 result;
-
-  result = myRAM[WAVEFORM + index*4 + 0]        +  // low byte
-          (myRAM[WAVEFORM + index*4 + 1] << 8)  +
-          (myRAM[WAVEFORM + index*4 + 2] << 16) +
-          (myRAM[WAVEFORM + index*4 + 3] << 24);   // high byte
+  uInt32 result = getWord(myRAM.data() + WAVEFORM + index*4);
 
   result -= 0x40000800;
 
@@ -717,14 +706,7 @@ uInt32 CartridgeBUS::getWaveform(uInt8 index) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 CartridgeBUS::getSample()
 {
-  uInt32 result;
-
-  result = myRAM[WAVEFORM + 0]        +  // low byte
-          (myRAM[WAVEFORM + 1] << 8)  +
-          (myRAM[WAVEFORM + 2] << 16) +
-          (myRAM[WAVEFORM + 3] << 24);   // high byte
-
-  return result;
+  return getWord(myRAM.data() + WAVEFORM);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -737,10 +719,7 @@ uInt32 CartridgeBUS::getWaveformSize(uInt8 index) const
 void CartridgeBUS::setAddressMap(uInt8 index, uInt32 value)
 {
   //  index &= 0x0f;
-  myRAM[DSMAPS + index*4 + 0] = value & 0xff;          // low byte
-  myRAM[DSMAPS + index*4 + 1] = (value >> 8) & 0xff;
-  myRAM[DSMAPS + index*4 + 2] = (value >> 16) & 0xff;
-  myRAM[DSMAPS + index*4 + 3] = (value >> 24) & 0xff;  // high byte
+  setWord(myRAM.data() + DSMAPS + index*4, value);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -107,9 +107,9 @@ class CartridgeBUS : public CartridgeARM
       Access the internal ROM image for this cartridge.
 
       @param size  Set to the size of the internal ROM image data
-      @return  A reference to the internal ROM image data
+      @return  A pointer to the internal ROM image data
     */
-    const ByteBuffer& getImage(size_t& size) const override;
+    const uInt8* getImage(size_t& size) const override;
 
     /**
       Save the current state of this cart to the given Serializer.
@@ -155,6 +155,14 @@ class CartridgeBUS : public CartridgeARM
   */
   uInt8 internalRamGetValue(uInt16 addr) const override;
 
+  /**
+    Get direct access to the cart internal RAM.
+
+    @param size  Set to the size of the RAM in bytes
+    @return  Pointer to the RAM
+  */
+  uInt8* getRAM(size_t& size) override { size = myRAM.size(); return myRAM.data(); }
+
 
   #ifdef DEBUGGER_SUPPORT
     /**
@@ -224,9 +232,6 @@ class CartridgeBUS : public CartridgeARM
     uInt32 getSample();
 
   private:
-    // The 32K ROM image of the cartridge
-    ByteBuffer myImage;
-
     // Pointer to the 28K program ROM image of the cartridge
     uInt8* myProgramImage{nullptr};
 
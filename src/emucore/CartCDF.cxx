@@ -24,6 +24,7 @@
 #endif
 
 #include "System.hxx"
+#include "EventCounters.hxx"
 #include "CartCDF.hxx"
 #include "TIA.hxx"
 #include "exception/FatalEmulationError.hxx"
@@ -66,10 +67,11 @@ CartridgeCDF::CartridgeCDF(const ByteBuffer& image, size_t size,
                            const string& md5, const Settings& settings)
   : CartridgeARM(md5, settings)
 {
-  // Copy the ROM image into my buffer
+  // Get the ROM image, which is shared by all carts using the same ROM
   mySize = std::min(size, 512_KB);
-  myImage = make_unique<uInt8[]>(mySize);
-  std::copy_n(image.get(), mySize, myImage.get());
+  acquireImage(md5, mySize, [&](uInt8* data) {
+    std::copy_n(image.get(), mySize, data);
+  });
 
   // Detect cart version
   setupVersion();
@@ -231,13 +233,8 @@ uInt8 CartridgeCDF::peek(uInt16 address)
     ++myJMPoperandAddress;
 
     pointer = getDatastreamPointer(myFastJumpStream);
-    if (isCDFJplus()) {
-      value = myDisplayImage[ pointer >> 16 ];
-      pointer += 0x00010000;  // always increment by 1
-    } else {
-      value = myDisplayImage[ pointer >> 20 ];
-      pointer += 0x00100000;  // always increment by 1
-    }
+    value = myDisplayImage[ pointer >> myDatastreamShift ];
+    pointer += 1 << myDatastreamShift;  // always increment by 1
 
     setDatastreamPointer(myFastJumpStream, pointer);
 
@@ -444,11 +441,12 @@ bool CartridgeCDF::bank(uInt16 bank, uInt16)
   // Map Program ROM image into the system
   for(uInt16 addr = 0x1040; addr < 0x2000; addr += System::PAGE_SIZE)
   {
-    access.romAccessBase = &myRomAccessBase[myBankOffset + (addr & 0x0FFF)];
-    access.romPeekCounter = &myRomAccessCounter[myBankOffset + (addr & 0x0FFF)];
-    access.romPokeCounter = &myRomAccessCounter[myBankOffset + (addr & 0x0FFF) + 28_KB];  // TODO: Change for CDFJ+???
+    access.romAccessBase = romAccessBase(myBankOffset + (addr & 0x0FFF));
+    access.romPeekCounter = romPeekCounter(myBankOffset + (addr & 0x0FFF));
+    access.romPokeCounter = romPokeCounter(myBankOffset + (addr & 0x0FFF));
     mySystem->setPageAccess(addr, access);
   }
+  EventCounters::count(EventCounters::Event::bankSwitch);
   return myBankChanged = true;
 }
 
@@ -472,6 +470,9 @@ bool CartridgeCDF::patch(uInt16 address, uInt8 value)
   // For now, we ignore attempts to patch the CDF address space
   if(address >= 0x0040)
   {
+    if(unshareImage())
+      myProgramImage = myImage.get() + (isCDFJplus() ? 2_KB : 4_KB);
+
     myProgramImage[myBankOffset + (address & 0x0FFF)] = value;
     return myBankChanged = true;
   }
@@ -480,10 +481,10 @@ bool CartridgeCDF::patch(uInt16 address, uInt8 value)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-const ByteBuffer& CartridgeCDF::getImage(size_t& size) const
+const uInt8* CartridgeCDF::getImage(size_t& size) const
 {
   size = mySize;
-  return myImage;
+  return myImage.get();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -617,45 +618,25 @@ bool CartridgeCDF::load(Serializer& in)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 CartridgeCDF::getDatastreamPointer(uInt8 index) const
 {
-  uInt16 address = myDatastreamBase + index * 4;
-
-  return myRAM[address + 0]        +  // low byte
-        (myRAM[address + 1] << 8)  +
-        (myRAM[address + 2] << 16) +
-        (myRAM[address + 3] << 24) ;  // high byte
+  return getWord(myRAM.data() + myDatastreamBase + index * 4);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeCDF::setDatastreamPointer(uInt8 index, uInt32 value)
 {
-  uInt16 address = myDatastreamBase + index * 4;
-
-  myRAM[address + 0] = value & 0xff;          // low byte
-  myRAM[address + 1] = (value >> 8) & 0xff;
-  myRAM[address + 2] = (value >> 16) & 0xff;
-  myRAM[address + 3] = (value >> 24) & 0xff;  // high byte
+  setWord(myRAM.data() + myDatastreamBase + index * 4, value);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 CartridgeCDF::getDatastreamIncrement(uInt8 index) const
 {
-  uInt16 address = myDatastreamIncrementBase + index * 4;
-
-  return myRAM[address + 0]        +   // low byte
-        (myRAM[address + 1] << 8)  +
-        (myRAM[address + 2] << 16) +
-        (myRAM[address + 3] << 24) ;   // high byte
+  return getWord(myRAM.data() + myDatastreamIncrementBase + index * 4);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 CartridgeCDF::getWaveform(uInt8 index) const
 {
-  uInt16 address = myWaveformBase + index * 4;
-
-  uInt32 result = myRAM[address + 0]        +  // low byte
-                 (myRAM[address + 1] << 8)  +
-                 (myRAM[address + 2] << 16) +
-                 (myRAM[address + 3] << 24);   // high byte
+  uInt32 result = getWord(myRAM.data() + myWaveformBase + index * 4);
 
   result -= (0x40000000 + uInt32(2_KB));
 
@@ -670,14 +651,7 @@ uInt32 CartridgeCDF::getWaveform(uInt8 index) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 CartridgeCDF::getSample()
 {
-  uInt16 address = myWaveformBase;
-
-  uInt32 result = myRAM[address + 0]        +  // low byte
-                 (myRAM[address + 1] << 8)  +
-                 (myRAM[address + 2] << 16) +
-                 (myRAM[address + 3] << 24);   // high byte
-
-  return result;
+  return getWord(myRAM.data() + myWaveformBase);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -699,18 +673,13 @@ uInt8 CartridgeCDF::readFromDatastream(uInt8 index)
   // I = Increment
   // F = Fractional
 
+  //
+  // CDFJ+ uses 16 bit pointers and 8 bit fractions instead
   uInt32 pointer = getDatastreamPointer(index);
   uInt16 increment = getDatastreamIncrement(index);
+  uInt8 value = myDisplayImage[ pointer >> myDatastreamShift ];
 
-  uInt8 value;
-  if (isCDFJplus()) {
-    value = myDisplayImage[ pointer >> 16 ];
-    pointer += (increment << 8);
-  } else {
-    value = myDisplayImage[ pointer >> 20 ];
-    pointer += (increment << 12);
-  }
-
+  pointer += increment << (myDatastreamShift - 8);
   setDatastreamPointer(index, pointer);
   return value;
 }
@@ -724,6 +693,7 @@ void CartridgeCDF::setupVersion()
       getUInt32(myImage.get(), 0x17C) == 0x00000001) {    // V1
 
     myCDFSubtype = CDFSubtype::CDFJplus;
+    myDatastreamShift = 16;
     myAmplitudeStream = 0x23;
     myFastjumpStreamIndexMask = 0xfe;
     myDatastreamBase = 0x0098;
@@ -128,9 +128,9 @@ class CartridgeCDF : public CartridgeARM
       Access the internal ROM image for this cartridge.
 
       @param size  Set to the size of the internal ROM image data
-      @return  A reference to the internal ROM image data
+      @return  A pointer to the internal ROM image data
     */
-    const ByteBuffer& getImage(size_t& size) const override;
+    const uInt8* getImage(size_t& size) const override;
 
     /**
       Save the current state of this cart to the given Serializer.
@@ -174,6 +174,14 @@ class CartridgeCDF : public CartridgeARM
     */
     uInt8 internalRamGetValue(uInt16 addr) const override;
 
+    /**
+      Get direct access to the cart internal RAM.
+
+      @param size  Set to the size of the RAM in bytes
+      @return  Pointer to the RAM
+    */
+    uInt8* getRAM(size_t& size) override { size = myRAM.size(); return myRAM.data(); }
+
     /**
       Set if we are using CDFJ+ bankswitching
      */
@@ -254,9 +262,6 @@ class CartridgeCDF : public CartridgeARM
     void setupVersion();
 
   private:
-    // The ROM image of the cartridge
-    ByteBuffer myImage{nullptr};
-
     // The size of the ROM image
     size_t mySize{0};
 
@@ -337,6 +342,9 @@ class CartridgeCDF : public CartridgeARM
     // Pointer to the array of datastream increments
     uInt16 myDatastreamIncrementBase{0};
 
+    // Position of the display data address in a datastream pointer
+    uInt8 myDatastreamShift{20};
+
     // Pointer to the beginning of the waveform data block
     uInt16 myWaveformBase{0};
 
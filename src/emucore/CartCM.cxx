@@ -18,6 +18,7 @@
 #include "CompuMate.hxx"
 #include "System.hxx"
 #include "M6532.hxx"
+#include "EventCounters.hxx"
 #include "CartCM.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -120,9 +121,9 @@ bool CartridgeCM::bank(uInt16 bank, uInt16)
   for(uInt16 addr = 0x1000; addr < 0x1800; addr += System::PAGE_SIZE)
   {
     access.directPeekBase = &myImage[myBankOffset + (addr & 0x0FFF)];
-    access.romAccessBase = &myRomAccessBase[myBankOffset + (addr & 0x0FFF)];
-    access.romPeekCounter = &myRomAccessCounter[myBankOffset + (addr & 0x0FFF)];
-    access.romPokeCounter = &myRomAccessCounter[myBankOffset + (addr & 0x0FFF) + myAccessSize];
+    access.romAccessBase = romAccessBase(myBankOffset + (addr & 0x0FFF));
+    access.romPeekCounter = romPeekCounter(myBankOffset + (addr & 0x0FFF));
+    access.romPokeCounter = romPokeCounter(myBankOffset + (addr & 0x0FFF));
     mySystem->setPageAccess(addr, access);
   }
 
@@ -134,16 +135,16 @@ bool CartridgeCM::bank(uInt16 bank, uInt16)
     if(mySWCHA & 0x10)
     {
       access.directPeekBase = &myImage[myBankOffset + (addr & 0x0FFF)];
-      access.romAccessBase = &myRomAccessBase[myBankOffset + (addr & 0x0FFF)];
-      access.romPeekCounter = &myRomAccessCounter[myBankOffset + (addr & 0x0FFF)];
-      access.romPokeCounter = &myRomAccessCounter[myBankOffset + (addr & 0x0FFF) + myAccessSize];
+      access.romAccessBase = romAccessBase(myBankOffset + (addr & 0x0FFF));
+      access.romPeekCounter = romPeekCounter(myBankOffset + (addr & 0x0FFF));
+      access.romPokeCounter = romPokeCounter(myBankOffset + (addr & 0x0FFF));
     }
     else
     {
       access.directPeekBase = &myRAM[addr & 0x7FF];
-      access.romAccessBase = &myRomAccessBase[myBankOffset + (addr & 0x07FF)];
-      access.romPeekCounter = &myRomAccessCounter[myBankOffset + (addr & 0x07FF)];
-      access.romPokeCounter = &myRomAccessCounter[myBankOffset + (addr & 0x07FF) + myAccessSize];
+      access.romAccessBase = romAccessBase(myBankOffset + (addr & 0x07FF));
+      access.romPeekCounter = romPeekCounter(myBankOffset + (addr & 0x07FF));
+      access.romPokeCounter = romPokeCounter(myBankOffset + (addr & 0x07FF));
     }
 
     if((mySWCHA & 0x30) == 0x20)
@@ -154,6 +155,7 @@ bool CartridgeCM::bank(uInt16 bank, uInt16)
     mySystem->setPageAccess(addr, access);
   }
 
+  EventCounters::count(EventCounters::Event::bankSwitch);
   return myBankChanged = true;
 }
 
@@ -185,10 +187,10 @@ bool CartridgeCM::patch(uInt16 address, uInt8 value)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-const ByteBuffer& CartridgeCM::getImage(size_t& size) const
+const uInt8* CartridgeCM::getImage(size_t& size) const
 {
   size = 16_KB;
-  return myImage;
+  return myImage.get();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
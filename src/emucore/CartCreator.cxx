@@ -55,6 +55,7 @@
 #include "CartFC.hxx"
 #include "CartFE.hxx"
 #include "CartMDM.hxx"
+#include "CartROMOnly.hxx"
 #include "CartSB.hxx"
 #include "CartTVBoy.hxx"
 #include "CartUA.hxx"
@@ -71,7 +72,8 @@
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 unique_ptr<Cartridge> CartCreator::create(const FilesystemNode& file,
     const ByteBuffer& image, size_t size, string& md5,
-    const string& propertiesType, Settings& settings)
+    const string& propertiesType, Settings& settings,
+    Bankswitch::Type autodetected)
 {
   unique_ptr<Cartridge> cartridge;
   Bankswitch::Type type = Bankswitch::nameToType(propertiesType),
@@ -91,7 +93,8 @@ unique_ptr<Cartridge> CartCreator::create(const FilesystemNode& file,
   // If we ask for extended info, always do an autodetect
   if(type == Bankswitch::Type::_AUTO || settings.getBool("rominfo"))
   {
-    detectedType = CartDetector::autodetectType(image, size);
+    detectedType = autodetected != Bankswitch::Type::_AUTO
+      ? autodetected : CartDetector::autodetectType(image, size);
     if(type != Bankswitch::Type::_AUTO && type != detectedType)
       cerr << "Auto-detection not consistent: "
            << Bankswitch::typeToName(type) << ", "
@@ -111,7 +114,7 @@ unique_ptr<Cartridge> CartCreator::create(const FilesystemNode& file,
       if(size == 2*2_KB || size == 2*4_KB || size == 2*8_KB || size == 2*16_KB)
       {
         cartridge =
-          createFromMultiCart(image, size, 2, md5, detectedType, id, settings);
+          createFromMultiCart(image, size, 2, md5, id, settings);
         buf << id;
       }
       else
@@ -124,7 +127,7 @@ unique_ptr<Cartridge> CartCreator::create(const FilesystemNode& file,
       if(size == 4*2_KB || size == 4*4_KB || size == 4*8_KB)
       {
         cartridge =
-          createFromMultiCart(image, size, 4, md5, detectedType, id, settings);
+          createFromMultiCart(image, size, 4, md5, id, settings);
         buf << id;
       }
       else
@@ -137,7 +140,7 @@ unique_ptr<Cartridge> CartCreator::create(const FilesystemNode& file,
       if(size == 8*2_KB || size == 8*4_KB || size == 8*8_KB)
       {
         cartridge =
-          createFromMultiCart(image, size, 8, md5, detectedType, id, settings);
+          createFromMultiCart(image, size, 8, md5, id, settings);
         buf << id;
       }
       else
@@ -150,7 +153,7 @@ unique_ptr<Cartridge> CartCreator::create(const FilesystemNode& file,
       if(size == 16*2_KB || size == 16*4_KB || size == 16*8_KB)
       {
         cartridge =
-          createFromMultiCart(image, size, 16, md5, detectedType, id, settings);
+          createFromMultiCart(image, size, 16, md5, id, settings);
         buf << id;
       }
       else
@@ -163,7 +166,7 @@ unique_ptr<Cartridge> CartCreator::create(const FilesystemNode& file,
       if(size == 32*2_KB || size == 32*4_KB)
       {
         cartridge =
-          createFromMultiCart(image, size, 32, md5, detectedType, id, settings);
+          createFromMultiCart(image, size, 32, md5, id, settings);
         buf << id;
       }
       else
@@ -176,7 +179,7 @@ unique_ptr<Cartridge> CartCreator::create(const FilesystemNode& file,
       if(size == 64*2_KB || size == 64*4_KB)
       {
         cartridge =
-          createFromMultiCart(image, size, 64, md5, detectedType, id, settings);
+          createFromMultiCart(image, size, 64, md5, id, settings);
         buf << id;
       }
       else
@@ -189,7 +192,7 @@ unique_ptr<Cartridge> CartCreator::create(const FilesystemNode& file,
       if(size == 128*2_KB || size == 128*4_KB)
       {
         cartridge =
-          createFromMultiCart(image, size, 128, md5, detectedType, id, settings);
+          createFromMultiCart(image, size, 128, md5, id, settings);
         buf << id;
       }
       else
@@ -215,7 +218,7 @@ unique_ptr<Cartridge> CartCreator::create(const FilesystemNode& file,
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 unique_ptr<Cartridge>
 CartCreator::createFromMultiCart(const ByteBuffer& image, size_t& size,
-    uInt32 numroms, string& md5, Bankswitch::Type type, string& id, Settings& settings)
+    uInt32 numroms, string& md5, string& id, Settings& settings)
 {
   // Get a piece of the larger image
   uInt32 i = settings.getInt("romloadcount");
@@ -228,21 +231,24 @@ CartCreator::createFromMultiCart(const ByteBuffer& image, size_t& size,
   settings.setValue("romloadcount", i);
 
   size /= numroms;
-  ByteBuffer slice = make_unique<uInt8[]>(size);
-  std::copy_n(image.get()+i*size, size, slice.get());
+
+  // The game is passed to the cart as a view into the larger image, and
+  // only copied once (into the cart's own image)
+  const uInt8* slice = image.get() + i * size;
 
   // We need a new md5 and name
-  md5 = MD5::hash(slice, uInt32(size)); // FIXME
+  md5 = MD5::hash(slice, size);
   ostringstream buf;
   buf << " [G" << (i+1) << "]";
   id = buf.str();
 
-  if(size <= 2_KB)       type = Bankswitch::Type::_2K;
-  else if(size == 4_KB)  type = Bankswitch::Type::_4K;
-  else if(size == 8_KB)  type = Bankswitch::Type::_F8;
-  else  /* default */    type = Bankswitch::Type::_4K;
-
-  return createFromImage(slice, size, type, md5, settings);
+  // Same as createFromImage() for the corresponding types
+  if(size <= 2_KB)
+    return make_unique<Cartridge2K>(slice, size, md5, settings);
+  else if(size == 8_KB)
+    return make_unique<CartridgeROMOnly<CartridgeF8>>(slice, size, md5, settings);
+  else
+    return make_unique<Cartridge4K>(slice, size, md5, settings);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -308,15 +314,15 @@ CartCreator::createFromImage(const ByteBuffer& image, size_t size, Bankswitch::T
     case Bankswitch::Type::_F0:
       return make_unique<CartridgeF0>(image, size, md5, settings);
     case Bankswitch::Type::_F4:
-      return make_unique<CartridgeF4>(image, size, md5, settings);
+      return make_unique<CartridgeROMOnly<CartridgeF4>>(image, size, md5, settings);
     case Bankswitch::Type::_F4SC:
       return make_unique<CartridgeF4SC>(image, size, md5, settings);
     case Bankswitch::Type::_F6:
-      return make_unique<CartridgeF6>(image, size, md5, settings);
+      return make_unique<CartridgeROMOnly<CartridgeF6>>(image, size, md5, settings);
     case Bankswitch::Type::_F6SC:
       return make_unique<CartridgeF6SC>(image, size, md5, settings);
     case Bankswitch::Type::_F8:
-      return make_unique<CartridgeF8>(image, size, md5, settings);
+      return make_unique<CartridgeROMOnly<CartridgeF8>>(image, size, md5, settings);
     case Bankswitch::Type::_F8SC:
       return make_unique<CartridgeF8SC>(image, size, md5, settings);
     case Bankswitch::Type::_FA:
@@ -43,22 +43,23 @@ class CartCreator
       @param md5      The md5sum for the given ROM image (can be updated)
       @param dtype    The detected bankswitch type of the ROM image
       @param settings The settings container
+      @param autodetected  The autodetected type of the image, if already known
       @return   Pointer to the new cartridge object allocated on the heap
     */
     static unique_ptr<Cartridge> create(const FilesystemNode& file,
                  const ByteBuffer& image, size_t size, string& md5,
-                 const string& dtype, Settings& settings);
+                 const string& dtype, Settings& settings,
+                 Bankswitch::Type autodetected = Bankswitch::Type::_AUTO);
 
   private:
     /**
       Create a cartridge from a multi-cart image pointer; internally this
-      takes a slice of the ROM image ues that for the cartridge.
+      passes a slice of the ROM image to the cartridge, without copying it.
 
       @param image    A pointer to the complete ROM image
       @param size     The size of the ROM image slice
       @param numroms  The number of ROMs in the multicart
       @param md5      The md5sum for the slice of the ROM image
-      @param type     The detected type of the slice of the ROM image
       @param id       The ID for the slice of the ROM image
       @param settings The settings container
 
@@ -66,8 +67,7 @@ class CartCreator
     */
     static unique_ptr<Cartridge>
       createFromMultiCart(const ByteBuffer& image, size_t& size,
-        uInt32 numroms, string& md5, Bankswitch::Type type, string& id,
-        Settings& settings);
+        uInt32 numroms, string& md5, string& id, Settings& settings);
 
     /**
       Create a cartridge from the entire image pointer.
@@ -34,16 +34,19 @@ void CartridgeDPC::reset()
   CartridgeEnhanced::reset();
 
   myAudioCycles = 0;
-  myFractionalClocks = 0.0;
-  myDpcPitch = mySettings.getInt(AudioSettings::SETTING_DPC_PITCH);
+  myFractionalClocks = 0;
+  setDpcPitch(mySettings.getInt(AudioSettings::SETTING_DPC_PITCH));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeDPC::consoleChanged(ConsoleTiming timing)
 {
-  constexpr double NTSC  = 1193191.66666667;  // NTSC  6507 clock rate
-  constexpr double PAL   = 1182298.0;         // PAL   6507 clock rate
-  constexpr double SECAM = 1187500.0;         // SECAM 6507 clock rate
+  // In thirds of a Hz, since the NTSC rate isn't a whole number
+  constexpr uInt32 NTSC  = 3579575;  // NTSC  6507 clock rate (1193191.67 Hz)
+  constexpr uInt32 PAL   = 3546894;  // PAL   6507 clock rate (1182298 Hz)
+  constexpr uInt32 SECAM = 3562500;  // SECAM 6507 clock rate (1187500 Hz)
+
+  const uInt32 clockRate = myClockRate;
 
   switch(timing)
   {
@@ -52,6 +55,9 @@ void CartridgeDPC::consoleChanged(ConsoleTiming timing)
     case ConsoleTiming::secam:  myClockRate = SECAM;  break;
     default:  break;  // satisfy compiler
   }
+
+  // Keep the fractional clocks, relative to the new clock rate
+  myFractionalClocks = myFractionalClocks * myClockRate / clockRate;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -98,11 +104,11 @@ inline void CartridgeDPC::updateMusicModeDataFetchers()
   myAudioCycles = mySystem->cycles();
 
   // Calculate the number of DPC OSC clocks since the last update
-  double clocks = ((myDpcPitch * cycles) / myClockRate) + myFractionalClocks;
-  uInt32 wholeClocks = uInt32(clocks);
-  myFractionalClocks = clocks - double(wholeClocks);
+  const uInt64 clocks = cycles * myClocksPerCycle + myFractionalClocks;
+  const uInt32 wholeClocks = uInt32(clocks / myClockRate);
+  myFractionalClocks = clocks % myClockRate;
 
-  if(wholeClocks <= 0)
+  if(wholeClocks == 0)
     return;
 
   // Let's update counters and flags of the music mode data fetchers
@@ -379,7 +385,7 @@ bool CartridgeDPC::save(Serializer& out) const
     out.putByte(myRandomNumber);
 
     out.putLong(myAudioCycles);
-    out.putDouble(myFractionalClocks);
+    out.putDouble(double(myFractionalClocks) / myClockRate);
   }
   catch(...)
   {
@@ -419,7 +425,8 @@ bool CartridgeDPC::load(Serializer& in)
 
     // Get system cycles and fractional clocks
     myAudioCycles = in.getLong();
-    myFractionalClocks = in.getDouble();
+    myFractionalClocks = std::min(uInt64(in.getDouble() * myClockRate + 0.5),
+                                  uInt64(myClockRate - 1));
   }
   catch(...)
   {
@@ -113,7 +113,10 @@ class CartridgeDPC : public CartridgeF8
 
       @param pitch  The new pitch value
     */
-    void setDpcPitch(double pitch) { myDpcPitch = pitch; }
+    void setDpcPitch(double pitch) {
+      myDpcPitch = pitch;
+      myClocksPerCycle = uInt64(pitch) * 3;
+    }
 
   #ifdef DEBUGGER_SUPPORT
     /**
@@ -157,8 +160,8 @@ class CartridgeDPC : public CartridgeF8
     void updateMusicModeDataFetchers();
 
   private:
-    // Console clock rate
-    double myClockRate{1193191.66666667};
+    // Console clock rate (in thirds of a Hz)
+    uInt32 myClockRate{3579575};
 
     // Pointer to the 2K display ROM image of the cartridge
     uInt8* myDisplayImage{nullptr};
@@ -185,7 +188,12 @@ class CartridgeDPC : public CartridgeF8
     uInt64 myAudioCycles{0};
 
     // Fractional DPC music OSC clocks unused during the last update
-    double myFractionalClocks{0.0};
+    // (in units of 1 / myClockRate)
+    uInt64 myFractionalClocks{0};
+
+    // DPC music OSC clocks per CPU cycle (in units of 1 / myClockRate), i.e.
+    // the pitch in thirds of a Hz
+    uInt64 myClocksPerCycle{0};
 
     // DPC pitch
     double myDpcPitch{0.0};
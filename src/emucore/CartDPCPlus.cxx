@@ -20,6 +20,7 @@
 #endif
 #include "MD5.hxx"
 #include "System.hxx"
+#include "EventCounters.hxx"
 #include "CartDPCPlus.hxx"
 #include "TIA.hxx"
 #include "exception/FatalEmulationError.hxx"
@@ -28,14 +29,15 @@
 CartridgeDPCPlus::CartridgeDPCPlus(const ByteBuffer& image, size_t size,
                                    const string& md5, const Settings& settings)
   : CartridgeARM(md5, settings),
-    myImage{make_unique<uInt8[]>(32_KB)},
     mySize{std::min(size, 32_KB)}
 {
   // Image is always 32K, but in the case of ROM < 32K, the image is
-  // copied to the end of the buffer
-  if(mySize < 32_KB)
-    std::fill_n(myImage.get(), mySize, 0);
-  std::copy_n(image.get(), size, myImage.get() + (32_KB - mySize));
+  // copied to the end of the buffer; it is shared by all carts using
+  // the same ROM
+  acquireImage(md5, 32_KB, [&](uInt8* data) {
+    std::fill_n(data, 32_KB - mySize, 0);
+    std::copy_n(image.get(), mySize, data + (32_KB - mySize));
+  });
   createRomAccessArrays(24_KB);
 
   // Pointer to the program ROM (24K @ 3K offset; ignore first 3K)
@@ -220,7 +222,6 @@ uInt8 CartridgeDPCPlus::peek(uInt16 address)
   address &= 0x0FFF;
 
   uInt8 peekvalue = myProgramImage[myBankOffset + address];
-  uInt8 flag;
 
   // In debugger/bank-locked mode, we ignore all hotspots and in general
   // anything that can change the internal state of the cart
@@ -244,8 +245,11 @@ uInt8 CartridgeDPCPlus::peek(uInt16 address)
     uInt32 index = address & 0x07;
     uInt32 function = (address >> 3) & 0x07;
 
-    // Update flag for selected data fetcher
-    flag = (((myTops[index]-(myCounters[index] & 0x00ff)) & 0xFF) > ((myTops[index]-myBottoms[index]) & 0xFF)) ? 0xFF : 0;
+    // Flag for selected data fetcher, only needed by the windowed and flag
+    // registers
+    const auto flag = [this, index]() -> uInt8 {
+      return (((myTops[index]-(myCounters[index] & 0x00ff)) & 0xFF) > ((myTops[index]-myBottoms[index]) & 0xFF)) ? 0xFF : 0;
+    };
 
     switch(function)
     {
@@ -311,7 +315,7 @@ uInt8 CartridgeDPCPlus::peek(uInt16 address)
       // DFxDATAW - display data read AND'd w/flag ("windowed")
       case 0x02:
       {
-        result = myDisplayImage[myCounters[index]] & flag;
+        result = myDisplayImage[myCounters[index]] & flag();
         myCounters[index] = (myCounters[index] + 0x1) & 0x0fff;
         break;
       }
@@ -333,7 +337,7 @@ uInt8 CartridgeDPCPlus::peek(uInt16 address)
           case 0x02:  // DF2FLAG
           case 0x03:  // DF3FLAG
           {
-            result = flag;
+            result = flag();
             break;
           }
           case 0x04:  // reserved
@@ -605,11 +609,12 @@ bool CartridgeDPCPlus::bank(uInt16 bank, uInt16)
   // Map Program ROM image into the system
   for(uInt16 addr = 0x1080; addr < 0x2000; addr += System::PAGE_SIZE)
   {
-    access.romAccessBase = &myRomAccessBase[myBankOffset + (addr & 0x0FFF)];
-    access.romPeekCounter = &myRomAccessCounter[myBankOffset + (addr & 0x0FFF)];
-    access.romPokeCounter = &myRomAccessCounter[myBankOffset + (addr & 0x0FFF) + 24_KB];
+    access.romAccessBase = romAccessBase(myBankOffset + (addr & 0x0FFF));
+    access.romPeekCounter = romPeekCounter(myBankOffset + (addr & 0x0FFF));
+    access.romPokeCounter = romPokeCounter(myBankOffset + (addr & 0x0FFF));
     mySystem->setPageAccess(addr, access);
   }
+  EventCounters::count(EventCounters::Event::bankSwitch);
   return myBankChanged = true;
 }
 
@@ -633,6 +638,9 @@ bool CartridgeDPCPlus::patch(uInt16 address, uInt8 value)
   // For now, we ignore attempts to patch the DPC address space
   if(address >= 0x0080)
   {
+    if(unshareImage())
+      myProgramImage = myImage.get() + 3_KB;
+
     myProgramImage[myBankOffset + (address & 0x0FFF)] = value;
     return myBankChanged = true;
   }
@@ -641,10 +649,10 @@ bool CartridgeDPCPlus::patch(uInt16 address, uInt8 value)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-const ByteBuffer& CartridgeDPCPlus::getImage(size_t& size) const
+const uInt8* CartridgeDPCPlus::getImage(size_t& size) const
 {
   size = mySize;
-  return myImage;
+  return myImage.get();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -108,9 +108,9 @@ class CartridgeDPCPlus : public CartridgeARM
       Access the internal ROM image for this cartridge.
 
       @param size  Set to the size of the internal ROM image data
-      @return  A reference to the internal ROM image data
+      @return  A pointer to the internal ROM image data
     */
-    const ByteBuffer& getImage(size_t& size) const override;
+    const uInt8* getImage(size_t& size) const override;
 
     /**
       Save the current state of this cart to the given Serializer.
@@ -149,6 +149,14 @@ class CartridgeDPCPlus : public CartridgeARM
     */
     uInt8 internalRamGetValue(uInt16 addr) const override;
 
+    /**
+      Get direct access to the cart internal RAM.
+
+      @param size  Set to the size of the RAM in bytes
+      @return  Pointer to the RAM
+    */
+    uInt8* getRAM(size_t& size) override { size = myDPCRAM.size(); return myDPCRAM.data(); }
+
 
   #ifdef DEBUGGER_SUPPORT
     /**
@@ -214,8 +222,7 @@ class CartridgeDPCPlus : public CartridgeARM
     void callFunction(uInt8 value);
 
   private:
-    // The ROM image and size
-    ByteBuffer myImage;
+    // The size of the ROM image
     size_t mySize{0};
 
     // Pointer to the 24K program ROM image of the cartridge
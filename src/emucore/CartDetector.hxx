@@ -18,6 +18,9 @@
 #ifndef CARTRIDGE_DETECTOR_HXX
 #define CARTRIDGE_DETECTOR_HXX
 
+class RomSignatures;
+class SignatureScanner;
+
 #include "Bankswitch.hxx"
 #include "bspf.hxx"
 
@@ -40,7 +43,77 @@ class CartDetector
     */
     static Bankswitch::Type autodetectType(const ByteBuffer& image, size_t size);
 
+    /**
+      Same as above, with the signatures of the image already scanned
+      (e.g. together with those for controller detection).
+    */
+    static Bankswitch::Type autodetectType(const ByteBuffer& image, size_t size,
+                                           const RomSignatures& signatures);
+
   private:
+    friend class RomSignatures;
+
+    /**
+      The byte signatures searched for in the complete image. The actual
+      byte sequences are defined in CartDetector.cxx.
+    */
+    enum class Signature: uInt8 {
+      // F8
+      STA_1FF9, STA_FFF9,
+      // 0840
+      LDA_0800, LDA_0840, BIT_0800, NOP_0800_JMP, NOP_0FFF_JMP,
+      // 3E, 3F
+      STA_3E, STA_3F,
+      // 3EX, 3E+, BUS, CDF, CTY, DPC+
+      STR_3EX, STR_TJ3E, STR_BUS, STR_CDF, STR_PLUSCDFJ, STR_LENIN, STR_DPCP,
+      // CV
+      STA_F3FF_X, STA_F400_Y,
+      // E0
+      STA_1FE0, STA_5FE0, STA_FFE9, NOP_1FE0, LDA_1FE0, LDA_FFE9, LDA_FFED,
+      LDA_BFF3,
+      // E7, E78K
+      LDA_FFE2, LDA_FFE4, LDA_FFE5, LDA_FFE6, LDA_1FE5, LDA_1FE7, NOP_1FE7,
+      STA_FFE7, STA_1FE7,
+      // EF
+      NOP_FFE0, LDA_FFE0,
+      // FC
+      STA_1FF8_LSR_LSR_STA, STA_FFF8_STA_FFFC, STY_FFF9_LDA_FFFC,
+      // FE
+      JSR_D000_DEC_C5, JSR_F8C3_LDA_82, BNE_JSR_FE73, JSR_F000_STY_D6,
+      // SB
+      LDA_0800_X,
+      // TV Boy
+      STA_82_Y_JMP_FFFC,
+      // UA
+      STA_0240, LDA_0240, LDA_021F_X, BIT_02C0, STA_02C0, LDA_02C0, BIT_0FC0,
+      // WD
+      LDA_39_JMP,
+      // X07
+      LDA_080D, LDA_081D, LDA_082D, NOP_080D, NOP_081D, NOP_082D,
+
+      numSignatures
+    };
+
+    /**
+      The number of occurrences of each signature in the image, counted
+      the same way as searchForBytes() does
+    */
+    using SignatureHits =
+      std::array<uInt32, static_cast<size_t>(Signature::numSignatures)>;
+
+    /**
+      Add the signatures to the scanner, with ids starting at 'firstId'
+    */
+    static void addSignatures(SignatureScanner& scanner, uInt32 firstId);
+
+    /**
+      Returns true if the signature was found at least 'minhits' times
+    */
+    static bool found(const SignatureHits& hits, Signature signature,
+                      uInt32 minhits = 1) {
+      return hits[static_cast<size_t>(signature)] >= minhits;
+    }
+
     /**
       Search the image for the specified byte signature
 
@@ -77,27 +150,27 @@ class CartDetector
     /**
       Returns true if the image is probably a 0840 bankswitching cartridge
     */
-    static bool isProbably0840(const ByteBuffer& image, size_t size);
+    static bool isProbably0840(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a 3E bankswitching cartridge
     */
-    static bool isProbably3E(const ByteBuffer& image, size_t size);
+    static bool isProbably3E(const SignatureHits& hits);
 
     /**
     Returns true if the image is probably a 3EX bankswitching cartridge
     */
-    static bool isProbably3EX(const ByteBuffer& image, size_t size);
+    static bool isProbably3EX(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a 3E+ bankswitching cartridge
     */
-    static bool isProbably3EPlus(const ByteBuffer& image, size_t size);
+    static bool isProbably3EPlus(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a 3F bankswitching cartridge
     */
-    static bool isProbably3F(const ByteBuffer& image, size_t size);
+    static bool isProbably3F(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a 4A50 bankswitching cartridge
@@ -117,22 +190,22 @@ class CartDetector
     /**
       Returns true if the image is probably a BUS bankswitching cartridge
     */
-    static bool isProbablyBUS(const ByteBuffer& image, size_t size);
+    static bool isProbablyBUS(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a CDF bankswitching cartridge
     */
-    static bool isProbablyCDF(const ByteBuffer& image, size_t size);
+    static bool isProbablyCDF(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a CTY bankswitching cartridge
     */
-    static bool isProbablyCTY(const ByteBuffer& image, size_t size);
+    static bool isProbablyCTY(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a CV bankswitching cartridge
     */
-    static bool isProbablyCV(const ByteBuffer& image, size_t size);
+    static bool isProbablyCV(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a DF/DFSC bankswitching cartridge
@@ -142,27 +215,28 @@ class CartDetector
     /**
       Returns true if the image is probably a DPC+ bankswitching cartridge
     */
-    static bool isProbablyDPCplus(const ByteBuffer& image, size_t size);
+    static bool isProbablyDPCplus(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a E0 bankswitching cartridge
     */
-    static bool isProbablyE0(const ByteBuffer& image, size_t size);
+    static bool isProbablyE0(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a E7 bankswitching cartridge
     */
-    static bool isProbablyE7(const ByteBuffer& image, size_t size);
+    static bool isProbablyE7(const SignatureHits& hits);
 
     /**
     Returns true if the image is probably a E78K bankswitching cartridge
     */
-    static bool isProbablyE78K(const ByteBuffer& image, size_t size);
+    static bool isProbablyE78K(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably an EF/EFSC bankswitching cartridge
     */
-    static bool isProbablyEF(const ByteBuffer& image, size_t size, Bankswitch::Type& type);
+    static bool isProbablyEF(const ByteBuffer& image, size_t size,
+                             const SignatureHits& hits, Bankswitch::Type& type);
 
     /**
       Returns true if the image is probably an F6 bankswitching cartridge
@@ -177,12 +251,12 @@ class CartDetector
     /**
       Returns true if the image is probably an FC bankswitching cartridge
     */
-    static bool isProbablyFC(const ByteBuffer& image, size_t size);
+    static bool isProbablyFC(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably an FE bankswitching cartridge
     */
-    static bool isProbablyFE(const ByteBuffer& image, size_t size);
+    static bool isProbablyFE(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a MDM bankswitching cartridge
@@ -192,27 +266,27 @@ class CartDetector
     /**
       Returns true if the image is probably a SB bankswitching cartridge
     */
-    static bool isProbablySB(const ByteBuffer& image, size_t size);
+    static bool isProbablySB(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a TV Boy bankswitching cartridge
     */
-    static bool isProbablyTVBoy(const ByteBuffer& image, size_t size);
+    static bool isProbablyTVBoy(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a UA bankswitching cartridge
     */
-    static bool isProbablyUA(const ByteBuffer& image, size_t size);
+    static bool isProbablyUA(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a Wickstead Design bankswitching cartridge
     */
-    static bool isProbablyWD(const ByteBuffer& image, size_t size);
+    static bool isProbablyWD(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably an X07 bankswitching cartridge
     */
-    static bool isProbablyX07(const ByteBuffer& image, size_t size);
+    static bool isProbablyX07(const SignatureHits& hits);
 
   private:
     // Following constructors and assignment operators not supported
@@ -18,10 +18,11 @@
 #include "Logger.hxx"
 #include "System.hxx"
 #include "PlusROM.hxx"
+#include "EventCounters.hxx"
 #include "CartEnhanced.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-CartridgeEnhanced::CartridgeEnhanced(const ByteBuffer& image, size_t size,
+CartridgeEnhanced::CartridgeEnhanced(const uInt8* image, size_t size,
                                      const string& md5, const Settings& settings,
                                      size_t bsSize)
   : Cartridge(settings, md5)
@@ -54,7 +55,7 @@ CartridgeEnhanced::CartridgeEnhanced(const ByteBuffer& image, size_t size,
   // Directly copy the ROM image into the buffer
   // Only copy up to the amount of data the ROM provides; extra unused
   // space will be filled with 0's from above
-  std::copy_n(image.get(), std::min(mySize, size), myImage.get());
+  std::copy_n(image, std::min(mySize, size), myImage.get());
 
 #if 0
   // Determine whether we have a PlusROM cart
@@ -85,6 +86,23 @@ void CartridgeEnhanced::install(System& system)
   // Allocate more space only if RAM has its own bank(s)
   createRomAccessArrays(mySize + (myRomOffset > 0 ? 0 : myRamSize));
 
+  // Precompute the page access methods of all ROM pages
+  const uInt32 romPages = uInt32(mySize >> System::PAGE_SHIFT);
+  myRomPageAccess = make_unique<System::PageAccess[]>(romPages);
+  for(uInt32 page = 0; page < romPages; ++page)
+  {
+    const uInt32 offset = page << System::PAGE_SHIFT;
+    System::PageAccess& access = myRomPageAccess[page];
+
+    access.device = this;
+    access.type = System::PageAccessType::READ;
+    if(myDirectPeek)
+      access.directPeekBase = &myImage[offset];
+    access.romAccessBase = romAccessBase(offset);
+    access.romPeekCounter = romPeekCounter(offset);
+    access.romPokeCounter = romPokeCounter(offset);
+  }
+
   // Allocate array for the segment's current bank offset
   myCurrentSegOffset = make_unique<uInt32[]>(myBankSegs);
 
@@ -106,9 +124,9 @@ void CartridgeEnhanced::install(System& system)
     {
       const uInt16 offset = addr & myRamMask;
 
-      access.romAccessBase = &myRomAccessBase[myWriteOffset + offset];
-      access.romPeekCounter = &myRomAccessCounter[myWriteOffset + offset];
-      access.romPokeCounter = &myRomAccessCounter[myWriteOffset + offset + myAccessSize];
+      access.romAccessBase = romAccessBase(myWriteOffset + offset);
+      access.romPeekCounter = romPeekCounter(myWriteOffset + offset);
+      access.romPokeCounter = romPokeCounter(myWriteOffset + offset);
       mySystem->setPageAccess(addr, access);
     }
 
@@ -119,9 +137,9 @@ void CartridgeEnhanced::install(System& system)
       const uInt16 offset = addr & myRamMask;
 
       access.directPeekBase = &myRAM[offset];
-      access.romAccessBase = &myRomAccessBase[myReadOffset + offset];
-      access.romPeekCounter = &myRomAccessCounter[myReadOffset + offset];
-      access.romPokeCounter = &myRomAccessCounter[myReadOffset + offset + myAccessSize];
+      access.romAccessBase = romAccessBase(myReadOffset + offset);
+      access.romPeekCounter = romPeekCounter(myReadOffset + offset);
+      access.romPokeCounter = romPokeCounter(myReadOffset + offset);
       mySystem->setPageAccess(addr, access);
     }
   }
@@ -258,20 +276,26 @@ bool CartridgeEnhanced::bank(uInt16 bank, uInt16 segment)
     else
       hotSpotAddr = 0xFFFF; // none
 
-    System::PageAccess access(this, System::PageAccessType::READ);
-    // Setup the page access methods for the current bank
-    for(uInt16 addr = fromAddr; addr < toAddr; addr += System::PAGE_SIZE)
+    // Setup the page access methods for the current bank by copying its
+    // precomputed pages; banks smaller than the 4K segment are mirrored
+    const System::PageAccess* bankPages = &myRomPageAccess[bankOffset >> System::PAGE_SHIFT];
+    const uInt16 bankPageCount = myBankSize >> System::PAGE_SHIFT;
+    for(uInt16 addr = fromAddr; addr < toAddr; )
     {
-      const uInt32 offset = bankOffset + (addr & myBankMask);
-
-      if(myDirectPeek && addr != hotSpotAddr)
-        access.directPeekBase = &myImage[offset];
-      else
-        access.directPeekBase = nullptr;
-      access.romAccessBase = &myRomAccessBase[offset];
-      access.romPeekCounter = &myRomAccessCounter[offset];
-      access.romPokeCounter = &myRomAccessCounter[offset + myAccessSize];
-      mySystem->setPageAccess(addr, access);
+      const uInt16 first = (addr & myBankMask) >> System::PAGE_SHIFT;
+      const uInt16 count = std::min<uInt16>(bankPageCount - first,
+                                            (toAddr - addr) >> System::PAGE_SHIFT);
+
+      mySystem->setPageAccess(addr, bankPages + first, count);
+      addr += count << System::PAGE_SHIFT;
+    }
+    // The hotspot page must be handled by peek()
+    if(myDirectPeek && hotSpotAddr >= fromAddr && hotSpotAddr < toAddr)
+    {
+      System::PageAccess access = mySystem->getPageAccess(hotSpotAddr);
+
+      access.directPeekBase = nullptr;
+      mySystem->setPageAccess(hotSpotAddr, access);
     }
   }
   else
@@ -294,9 +318,9 @@ bool CartridgeEnhanced::bank(uInt16 bank, uInt16 segment)
     {
       const uInt32 offset = bankOffset + (addr & myRamMask);
 
-      access.romAccessBase = &myRomAccessBase[offset];
-      access.romPeekCounter = &myRomAccessCounter[offset];
-      access.romPokeCounter = &myRomAccessCounter[offset + myAccessSize];
+      access.romAccessBase = romAccessBase(offset);
+      access.romPeekCounter = romPeekCounter(offset);
+      access.romPokeCounter = romPokeCounter(offset);
       mySystem->setPageAccess(addr, access);
     }
 
@@ -310,12 +334,13 @@ bool CartridgeEnhanced::bank(uInt16 bank, uInt16 segment)
       const uInt32 offset = bankOffset + (addr & myRamMask);
 
       access.directPeekBase = &myRAM[offset - mySize];
-      access.romAccessBase = &myRomAccessBase[offset];
-      access.romPeekCounter = &myRomAccessCounter[offset];
-      access.romPokeCounter = &myRomAccessCounter[offset + myAccessSize];
+      access.romAccessBase = romAccessBase(offset);
+      access.romPeekCounter = romPeekCounter(offset);
+      access.romPokeCounter = romPokeCounter(offset);
       mySystem->setPageAccess(addr, access);
     }
   }
+  EventCounters::count(EventCounters::Event::bankSwitch);
   return myBankChanged = true;
 }
 
@@ -373,10 +398,17 @@ bool CartridgeEnhanced::patch(uInt16 address, uInt8 value)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-const ByteBuffer& CartridgeEnhanced::getImage(size_t& size) const
+const uInt8* CartridgeEnhanced::getImage(size_t& size) const
 {
   size = mySize;
-  return myImage;
+  return myImage.get();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8* CartridgeEnhanced::getRAM(size_t& size)
+{
+  size = myRamSize;
+  return myRamSize ? myRAM.get() : nullptr;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
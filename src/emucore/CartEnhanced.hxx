@@ -23,6 +23,7 @@ class System;
 #include "bspf.hxx"
 #include "Cart.hxx"
 #include "PlusROM.hxx"
+#include "System.hxx"
 #ifdef DEBUGGER_SUPPORT
   #include "CartEnhancedWidget.hxx"
 #endif
@@ -46,9 +47,13 @@ class CartridgeEnhanced : public Cartridge
       @param settings  A reference to the various settings (read-only)
       @param bsSize    The size specified by the bankswitching scheme
     */
-    CartridgeEnhanced(const ByteBuffer& image, size_t size,
+    CartridgeEnhanced(const uInt8* image, size_t size,
                       const string& md5, const Settings& settings,
                       size_t bsSize);
+    CartridgeEnhanced(const ByteBuffer& image, size_t size,
+                      const string& md5, const Settings& settings,
+                      size_t bsSize)
+      : CartridgeEnhanced(image.get(), size, md5, settings, bsSize) { }
     ~CartridgeEnhanced() override = default;
 
   public:
@@ -121,9 +126,17 @@ class CartridgeEnhanced : public Cartridge
       Access the internal ROM image for this cartridge.
 
       @param size  Set to the size of the internal ROM image data
-      @return  A reference to the internal ROM image data
+      @return  A pointer to the internal ROM image data
+    */
+    const uInt8* getImage(size_t& size) const override;
+
+    /**
+      Get direct access to the extended RAM of this cartridge.
+
+      @param size  Set to the size of the RAM in bytes
+      @return  A pointer to the RAM, or nullptr if there is none
     */
-    const ByteBuffer& getImage(size_t& size) const override;
+    uInt8* getRAM(size_t& size) override;
 
     /**
       Save the current state of this cart to the given Serializer.
@@ -216,6 +229,10 @@ class CartridgeEnhanced : public Cartridge
     // Contains the offset into the ROM image for each of the bank segments
     DWordBuffer myCurrentSegOffset{nullptr};
 
+    // Page access methods for each page of the ROM image, precomputed so
+    // that bank() can install a ROM bank by copying a slice of them
+    std::unique_ptr<System::PageAccess[]> myRomPageAccess{nullptr};
+
     // Indicates whether to use direct ROM peeks or not
     bool myDirectPeek{true};
 
@@ -24,16 +24,3 @@ CartridgeF4::CartridgeF4(const ByteBuffer& image, size_t size,
   : CartridgeEnhanced(image, size, md5, settings, bsSize)
 {
 }
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeF4::checkSwitchBank(uInt16 address, uInt8)
-{
-  // Switch banks if necessary
-  // Note: addresses could be calculated from hotspot and bank count
-  if((address >= 0x1FF4) && (address <= 0x1FFB))
-  {
-    bank(address - 0x1FF4);
-    return true;
-  }
-  return false;
-}
@@ -67,8 +67,21 @@ class CartridgeF4 : public CartridgeEnhanced
     }
   #endif
 
+  protected:
+    // Defined here, so the final CartridgeROMOnly<> variant can inline it
+    bool checkSwitchBank(uInt16 address, uInt8 = 0) override
+    {
+      // Switch banks if necessary
+      // Note: addresses could be calculated from hotspot and bank count
+      if((address >= 0x1FF4) && (address <= 0x1FFB))
+      {
+        bank(address - 0x1FF4);
+        return true;
+      }
+      return false;
+    }
+
   private:
-    bool checkSwitchBank(uInt16 address, uInt8 value = 0) override;
 
     uInt16 hotspot() const override { return 0x1FF4; }
 
@@ -18,31 +18,9 @@
 #include "CartF8.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-CartridgeF8::CartridgeF8(const ByteBuffer& image, size_t size,
+CartridgeF8::CartridgeF8(const uInt8* image, size_t size,
                          const string& md5, const Settings& settings,
                          size_t bsSize)
   : CartridgeEnhanced(image, size, md5, settings, bsSize)
 {
 }
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeF8::checkSwitchBank(uInt16 address, uInt8)
-{
-  // Switch banks if necessary
-  switch(address)
-  {
-    case 0x1FF8:
-      // Set the current bank to the lower 4k bank
-      bank(0);
-      return true;
-
-    case 0x1FF9:
-      // Set the current bank to the upper 4k bank
-      bank(1);
-      return true;
-
-    default:
-      break;
-  }
-  return false;
-}
@@ -43,8 +43,11 @@ class CartridgeF8 : public CartridgeEnhanced
       @param settings  A reference to the various settings (read-only)
       @param bsSize    The size specified by the bankswitching scheme
     */
-    CartridgeF8(const ByteBuffer& image, size_t size, const string& md5,
+    CartridgeF8(const uInt8* image, size_t size, const string& md5,
                 const Settings& settings, size_t bsSize = 8_KB);
+    CartridgeF8(const ByteBuffer& image, size_t size, const string& md5,
+                const Settings& settings, size_t bsSize = 8_KB)
+      : CartridgeF8(image.get(), size, md5, settings, bsSize) { }
     ~CartridgeF8() override = default;
 
   public:
@@ -67,8 +70,30 @@ class CartridgeF8 : public CartridgeEnhanced
     }
   #endif
 
+  protected:
+    // Defined here, so the final CartridgeROMOnly<> variant can inline it
+    bool checkSwitchBank(uInt16 address, uInt8 = 0) override
+    {
+      // Switch banks if necessary
+      switch(address)
+      {
+        case 0x1FF8:
+          // Set the current bank to the lower 4k bank
+          bank(0);
+          return true;
+
+        case 0x1FF9:
+          // Set the current bank to the upper 4k bank
+          bank(1);
+          return true;
+
+        default:
+          break;
+      }
+      return false;
+    }
+
   private:
-    bool checkSwitchBank(uInt16 address, uInt8 value = 0) override;
 
     uInt16 hotspot() const override { return 0x1FF8; }
 
@@ -16,6 +16,7 @@
 //============================================================================
 
 #include "TimerManager.hxx"
+#include "StorageWorker.hxx"
 #include "CartFA2.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -82,6 +83,7 @@ bool CartridgeFA2::poke(uInt16 address, uInt8 value)
 void CartridgeFA2::setNVRamFile(const string& nvramdir, const string& romfile)
 {
   myFlashFile = nvramdir + romfile + "_flash.dat";
+  loadFlash();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -113,32 +115,19 @@ uInt8 CartridgeFA2::ramReadWrite()
 
     // We go ahead and do the access now, and only return when a sufficient
     // amount of time has passed
-    Serializer serializer(myFlashFile);
-    if(serializer)
+    // The flash contents are cached, and saved in the background, so the
+    // emulation doesn't have to wait for the storage
+    if(myFlash)
     {
       if(myRAM[255] == 1)       // read
       {
-        try
-        {
-          serializer.getByteArray(myRAM.get(), myRamSize);
-        }
-        catch(...)
-        {
-          std::fill_n(myRAM.get(), myRamSize, 0);
-        }
+        std::copy_n(myFlash.get(), myRamSize, myRAM.get());
         myRamAccessTimeout += 500;  // Add 0.5 ms delay for read
       }
       else if(myRAM[255] == 2)  // write
       {
-        try
-        {
-          serializer.putByteArray(myRAM.get(), myRamSize);
-        }
-        catch(...)
-        {
-          // Maybe add logging here that save failed?
-          cerr << name() << ": ERROR saving score table" << endl;
-        }
+        std::copy_n(myRAM.get(), myRamSize, myFlash.get());
+        saveFlash();
         myRamAccessTimeout += 101000;  // Add 101 ms delay for write
       }
     }
@@ -165,42 +154,65 @@ uInt8 CartridgeFA2::ramReadWrite()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeFA2::flash(uInt8 operation)
 {
-  Serializer serializer(myFlashFile);
-  if(serializer)
+  if(!myFlash)
+    return;
+
+  if(operation == 0)       // erase
   {
-    if(operation == 0)       // erase
-    {
-      try
-      {
-        std::array<uInt8, 256> buf = {};
-        serializer.putByteArray(buf.data(), buf.size());
-      }
-      catch(...)
-      {
-      }
-    }
-    else if(operation == 1)  // read
+    std::fill_n(myFlash.get(), myRamSize, 0);
+    saveFlash();
+  }
+  else if(operation == 1)  // read
+    std::copy_n(myFlash.get(), myRamSize, myRAM.get());
+  else if(operation == 2)  // write
+  {
+    std::copy_n(myRAM.get(), myRamSize, myFlash.get());
+    saveFlash();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeFA2::loadFlash()
+{
+  // Make sure a pending save of a previous instance has been completed
+  StorageWorker::instance().flush();
+
+  // A missing or short file reads as erased flash
+  myFlash = make_unique<uInt8[]>(myRamSize);
+  try
+  {
+    Serializer serializer(myFlashFile, Serializer::Mode::ReadOnly);
+    if(!serializer)
+      throw runtime_error("");
+    serializer.getByteArray(myFlash.get(), myRamSize);
+  }
+  catch(...)
+  {
+    std::fill_n(myFlash.get(), myRamSize, 0);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeFA2::saveFlash()
+{
+  // The job gets its own copy, the cache may change again before it runs
+  auto data = std::make_shared<ByteBuffer>(make_unique<uInt8[]>(myRamSize));
+  std::copy_n(myFlash.get(), myRamSize, data->get());
+
+  const string file = myFlashFile, cartName = name();
+  const size_t size = myRamSize;
+
+  StorageWorker::instance().enqueue(file, [file, cartName, data, size]() {
+    Serializer serializer(file);
+    try
     {
-      try
-      {
-        serializer.getByteArray(myRAM.get(), myRamSize);
-      }
-      catch(...)
-      {
-        std::fill_n(myRAM.get(), myRamSize, 0);
-      }
+      if(!serializer)
+        throw runtime_error("");
+      serializer.putByteArray(data->get(), size);
     }
-    else if(operation == 2)  // write
+    catch(...)
     {
-      try
-      {
-        serializer.putByteArray(myRAM.get(), myRamSize);
-      }
-      catch(...)
-      {
-        // Maybe add logging here that save failed?
-        cerr << name() << ": ERROR saving score table" << endl;
-      }
+      cerr << cartName << ": ERROR saving score table" << endl;
     }
-  }
+  });
 }
@@ -133,6 +133,16 @@ class CartridgeFA2 : public CartridgeFA
     */
     void flash(uInt8 operation);
 
+    /**
+      Read the contents of the flash file into the cache.
+    */
+    void loadFlash();
+
+    /**
+      Write the cached flash contents to the file, in the background.
+    */
+    void saveFlash();
+
   private:
     // The time after which the first request of a load/save operation
     // will actually be completed
@@ -144,6 +154,10 @@ class CartridgeFA2 : public CartridgeFA
     // of internal RAM to Harmony cart flash
     string myFlashFile;
 
+    // The contents of the flash file, which all accesses work on; null
+    // until the file is known
+    ByteBuffer myFlash;
+
   private:
     // Following constructors and assignment operators not supported
     CartridgeFA2() = delete;
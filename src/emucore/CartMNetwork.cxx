@@ -16,6 +16,7 @@
 //============================================================================
 
 #include "System.hxx"
+#include "EventCounters.hxx"
 #include "CartMNetwork.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -70,9 +71,9 @@ void CartridgeMNetwork::setAccess(uInt16 addrFrom, uInt16 size,
       access.directPeekBase = &directData[directOffset + (addr & addrMask)];
     else if(type == System::PageAccessType::WRITE)  // all RAM writes mapped to ::poke()
       access.directPokeBase = nullptr;
-    access.romAccessBase = &myRomAccessBase[codeOffset + (addr & addrMask)];
-    access.romPeekCounter = &myRomAccessCounter[codeOffset + (addr & addrMask)];
-    access.romPokeCounter = &myRomAccessCounter[codeOffset + (addr & addrMask) + myAccessSize];
+    access.romAccessBase = romAccessBase(codeOffset + (addr & addrMask));
+    access.romPeekCounter = romPeekCounter(codeOffset + (addr & addrMask));
+    access.romPokeCounter = romPokeCounter(codeOffset + (addr & addrMask));
     mySystem->setPageAccess(addr, access);
   }
 }
@@ -88,9 +89,9 @@ void CartridgeMNetwork::install(System& system)
   for(uInt16 addr = (0x1FE0 & ~System::PAGE_MASK); addr < 0x2000;
       addr += System::PAGE_SIZE)
   {
-    access.romAccessBase = &myRomAccessBase[0x1fc0];
-    access.romPeekCounter = &myRomAccessCounter[0x1fc0];
-    access.romPokeCounter = &myRomAccessCounter[0x1fc0 + myAccessSize];
+    access.romAccessBase = romAccessBase(0x1fc0);
+    access.romPeekCounter = romPeekCounter(0x1fc0);
+    access.romPokeCounter = romPokeCounter(0x1fc0);
     mySystem->setPageAccess(addr, access);
   }
   /*setAccess(0x1FE0 & ~System::PAGE_MASK, System::PAGE_SIZE,
@@ -197,6 +198,7 @@ void CartridgeMNetwork::bankRAM(uInt16 bank)
   // Set the page accessing method for the 256 bytes of RAM reading pages
   setAccess(0x1900, 0x100, 0x0400 + offset, myRAM.data(), romSize() + BANK_SIZE / 2, System::PageAccessType::READ);
 
+  EventCounters::count(EventCounters::Event::bankSwitch);
   myBankChanged = true;
 }
 
@@ -223,6 +225,7 @@ bool CartridgeMNetwork::bank(uInt16 bank, uInt16)
     // Set the page accessing method for the 1K bank of RAM reading pages
     setAccess(0x1000 + BANK_SIZE / 2, BANK_SIZE / 2, 0, myRAM.data(), romSize(), System::PageAccessType::READ);
   }
+  EventCounters::count(EventCounters::Event::bankSwitch);
   return myBankChanged = true;
 }
 
@@ -263,10 +266,10 @@ bool CartridgeMNetwork::patch(uInt16 address, uInt8 value)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-const ByteBuffer& CartridgeMNetwork::getImage(size_t& size) const
+const uInt8* CartridgeMNetwork::getImage(size_t& size) const
 {
   size = romBankCount() * BANK_SIZE;
-  return myImage;
+  return myImage.get();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
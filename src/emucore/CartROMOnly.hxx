@@ -0,0 +1,82 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef CARTRIDGE_ROM_ONLY_HXX
+#define CARTRIDGE_ROM_ONLY_HXX
+
+#include "bspf.hxx"
+
+/**
+  Final variant of a bankswitching scheme which consists of plain 4K ROM
+  banks, without any RAM and with all hotspots in ROM space (e.g. F8, F6
+  and F4).
+
+  With direct peeks only the hotspot page ever reaches peek() and poke(),
+  but these still go through the generic CartridgeEnhanced code and its
+  virtual hotspot() and checkSwitchBank() calls. Since this class is final
+  and calls the scheme's (inline) checkSwitchBank() non-virtually, the
+  compiler can inline the complete hotspot handling into the accesses.
+
+  The scheme itself is unchanged (name, state, debugger widget), so only
+  CartCreator needs to know about this class.
+
+  @author  Stella Team
+*/
+template<class Cart>
+class CartridgeROMOnly final : public Cart
+{
+  public:
+    using Cart::Cart;
+    ~CartridgeROMOnly() override = default;
+
+  public:
+    /**
+      Get the byte at the specified address.
+
+      @return The byte at the specified address
+    */
+    uInt8 peek(uInt16 address) override
+    {
+      Cart::checkSwitchBank(address & Cart::ADDR_MASK);
+
+      return this->myImage[this->myCurrentSegOffset[0] + (address & Cart::ROM_MASK)];
+    }
+
+    /**
+      Change the byte at the specified address to the given value.
+
+      @param address The address where the value should be stored
+      @param value   The value to be stored at the address
+      @return  True if the poke changed the device address space, else false
+    */
+    bool poke(uInt16 address, uInt8 value) override
+    {
+      Cart::checkSwitchBank(address & Cart::ADDR_MASK, value);
+
+      return false;
+    }
+
+  private:
+    // Following constructors and assignment operators not supported
+    CartridgeROMOnly() = delete;
+    CartridgeROMOnly(const CartridgeROMOnly&) = delete;
+    CartridgeROMOnly(CartridgeROMOnly&&) = delete;
+    CartridgeROMOnly& operator=(const CartridgeROMOnly&) = delete;
+    CartridgeROMOnly& operator=(CartridgeROMOnly&&) = delete;
+};
+
+#endif
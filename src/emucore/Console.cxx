@@ -29,6 +29,7 @@
 #include "Event.hxx"
 #include "EventHandler.hxx"
 #include "ControllerDetector.hxx"
+#include "RomSignatures.hxx"
 #include "Joystick.hxx"
 #include "Keyboard.hxx"
 #include "KidVid.hxx"
@@ -62,6 +63,7 @@
 #include "FrameLayout.hxx"
 #include "AudioQueue.hxx"
 #include "AudioSettings.hxx"
+#include "MemoryUsage.hxx"
 #include "frame-manager/FrameManager.hxx"
 #include "frame-manager/FrameLayoutDetector.hxx"
 
@@ -119,15 +121,18 @@ Console::Console(OSystem& osystem, unique_ptr<Cartridge>& cart,
   : myOSystem{osystem},
     myEvent{osystem.eventHandler().event()},
     myProperties{props},
+    myArena{Common::ObjectArena::capacityFor<
+      M6502, M6532, TIA, FrameManager, Switches, System>()},
     myCart{std::move(cart)},
     myAudioSettings{audioSettings}
 {
-  // Create subsystems for the console
-  my6502 = make_unique<M6502>(myOSystem.settings());
-  myRiot = make_unique<M6532>(*this, myOSystem.settings());
-  myTIA  = make_unique<TIA>(*this, [this]() { return timing(); },  myOSystem.settings());
-  myFrameManager = make_unique<FrameManager>();
-  mySwitches = make_unique<Switches>(myEvent, myProperties, myOSystem.settings());
+  // Create subsystems for the console; they share one block of memory,
+  // which keeps them close together and is released at once
+  my6502 = myArena.create<M6502>(myOSystem.settings());
+  myRiot = myArena.create<M6532>(*this, myOSystem.settings());
+  myTIA  = myArena.create<TIA>(*this, [this]() { return timing(); },  myOSystem.settings());
+  myFrameManager = myArena.create<FrameManager>();
+  mySwitches = myArena.create<Switches>(myEvent, myProperties, myOSystem.settings());
 
   myTIA->setFrameManager(myFrameManager.get());
 
@@ -135,7 +140,7 @@ Console::Console(OSystem& osystem, unique_ptr<Cartridge>& cart,
   myOSystem.random().initSeed(static_cast<uInt32>(TimerManager::getTicks()));
 
   // Construct the system and components
-  mySystem = make_unique<System>(myOSystem.random(), *my6502, *myRiot, *myTIA, *myCart);
+  mySystem = myArena.create<System>(myOSystem.random(), *my6502, *myRiot, *myTIA, *myCart);
 
   // The real controllers for this console will be added later
   // For now, we just add dummy joystick controllers, since autodetection
@@ -172,7 +177,12 @@ Console::Console(OSystem& osystem, unique_ptr<Cartridge>& cart,
 
   if(myDisplayFormat == "AUTO" || myOSystem.settings().getBool("rominfo"))
   {
-    autodetectFrameLayout();
+    // Reloading a ROM reuses the format detected when it was loaded before
+    if(!myOSystem.propSet().getDetectedFormat(md5, myDisplayFormat))
+    {
+      autodetectFrameLayout();
+      myOSystem.propSet().setDetectedFormat(md5, myDisplayFormat);
+    }
 
     if(myProperties.get(PropType::Display_Format) == "AUTO")
     {
@@ -250,6 +260,16 @@ Console::~Console()
   myOSystem.sound().close();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Console::addMemoryUsage(MemoryUsage& usage) const
+{
+  myCart->addMemoryUsage(usage);
+  myTIA->addMemoryUsage(usage);
+  myRiot->addMemoryUsage(usage);
+  if(myAudioQueue)
+    usage.add(MemoryUsage::Category::audioQueue, myAudioQueue->memoryUsage());
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Console::setConsoleTiming()
 {
@@ -285,7 +305,9 @@ void Console::autodetectFrameLayout(bool reset)
     myRiot->update();
   }
 
-  for(int i = 0; i < 60; ++i) myTIA->update();
+  // Stop early once the detection is confident about the layout
+  for(int i = 0; i < 60 && !frameLayoutDetector.layoutStable(); ++i)
+    myTIA->update();
 
   myTIA->setFrameManager(myFrameManager.get());
 
@@ -818,7 +840,7 @@ void Console::setControllers(const string& romMd5)
     Controller::Type rightType =
         Controller::getType(myProperties.get(PropType::Controller_Right));
     size_t size = 0;
-    const ByteBuffer& image = myCart->getImage(size);
+    const uInt8* image = myCart->getImage(size);
     const bool swappedPorts =
         myProperties.get(PropType::Console_SwapPorts) == "YES";
 
@@ -826,10 +848,19 @@ void Console::setControllers(const string& romMd5)
     if(image != nullptr && size != 0)
     {
       Logger::debug(myProperties.get(PropType::Cart_Name) + ":");
-      leftType = ControllerDetector::detectType(image, size, leftType,
-          !swappedPorts ? Controller::Jack::Left : Controller::Jack::Right, myOSystem.settings());
-      rightType = ControllerDetector::detectType(image, size, rightType,
-          !swappedPorts ? Controller::Jack::Right : Controller::Jack::Left, myOSystem.settings());
+      const Settings& settings = myOSystem.settings();
+
+      // A single pass over the image finds the signatures for both ports
+      if(leftType == Controller::Type::Unknown ||
+         rightType == Controller::Type::Unknown || settings.getBool("rominfo"))
+      {
+        const RomSignatures signatures(image, size);
+
+        leftType = ControllerDetector::detectType(signatures, leftType,
+            !swappedPorts ? Controller::Jack::Left : Controller::Jack::Right, settings);
+        rightType = ControllerDetector::detectType(signatures, rightType,
+            !swappedPorts ? Controller::Jack::Right : Controller::Jack::Left, settings);
+      }
     }
 
     unique_ptr<Controller>
@@ -851,6 +882,13 @@ void Console::setControllers(const string& romMd5)
 
   myTIA->bindToControllers();
 
+  // Controllers with sound of their own (the KidVid tape) are mixed into
+  // the TIA output
+  AudioSource* source = myLeftControl->audioSource();
+  if(source == nullptr)
+    source = myRightControl->audioSource();
+  myTIA->setAudioSource(source);
+
   // now that we know the controllers, enable the event mappings
   myOSystem.eventHandler().enableEmulationKeyMappings();
   myOSystem.eventHandler().enableEmulationJoyMappings();
@@ -977,7 +1015,8 @@ unique_ptr<Controller> Console::getControllerPort(const Controller::Type type,
       break;
 
     case Controller::Type::KidVid:
-      controller = make_unique<KidVid>(port, myEvent, *mySystem, romMd5);
+      controller = make_unique<KidVid>(port, myEvent, *mySystem, romMd5,
+                                       myOSystem.baseDir());
       break;
 
     case Controller::Type::MindLink:
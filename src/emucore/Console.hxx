@@ -29,6 +29,7 @@ class CompuMate;
 class Debugger;
 class AudioQueue;
 class AudioSettings;
+class MemoryUsage;
 
 #include "bspf.hxx"
 #include "ConsoleIO.hxx"
@@ -41,7 +42,8 @@ class AudioSettings;
 #include "EventHandlerConstants.hxx"
 #include "EmulationTiming.hxx"
 #include "ConsoleTiming.hxx"
-#include "frame-manager/AbstractFrameManager.hxx"
+#include "frame-manager/FrameManager.hxx"
+#include "ObjectArena.hxx"
 
 /**
   Contains detailed info about a console.
@@ -131,6 +133,12 @@ class Console : public Serializable, public ConsoleIO
     */
     Cartridge& cartridge() const { return *myCart; }
 
+    /**
+      Add the memory held by the console (cart, TIA, RIOT and the audio
+      queue) to the given usage.
+    */
+    void addMemoryUsage(MemoryUsage& usage) const;
+
     /**
       Get the 6532 used by the console
 
@@ -420,21 +428,25 @@ class Console : public Serializable, public ConsoleIO
     // Properties for the game
     Properties myProperties;
 
+    // Memory for the components which live as long as the console (must be
+    // declared before them, since it has to outlive them)
+    Common::ObjectArena myArena;
+
     // Pointer to the 6502 based system being emulated
-    unique_ptr<System> mySystem;
+    Common::ObjectArena::Ptr<System> mySystem;
 
     // Pointer to the M6502 CPU
-    unique_ptr<M6502> my6502;
+    Common::ObjectArena::Ptr<M6502> my6502;
 
     // Pointer to the 6532 (aka RIOT) (the debugger needs it)
     // A RIOT of my own! (...with apologies to The Clash...)
-    unique_ptr<M6532> myRiot;
+    Common::ObjectArena::Ptr<M6532> myRiot;
 
     // Pointer to the TIA object
-    unique_ptr<TIA> myTIA;
+    Common::ObjectArena::Ptr<TIA> myTIA;
 
     // The frame manager instance that is used during emulation
-    unique_ptr<AbstractFrameManager> myFrameManager;
+    Common::ObjectArena::Ptr<FrameManager> myFrameManager;
 
     // The audio fragment queue that connects TIA and audio driver
     shared_ptr<AudioQueue> myAudioQueue;
@@ -443,7 +455,7 @@ class Console : public Serializable, public ConsoleIO
     unique_ptr<Cartridge> myCart;
 
     // Pointer to the switches on the front of the console
-    unique_ptr<Switches> mySwitches;
+    Common::ObjectArena::Ptr<Switches> mySwitches;
 
     // Pointers to the left and right controllers
     unique_ptr<Controller> myLeftControl, myRightControl;
@@ -0,0 +1,140 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "FSNode.hxx"
+#include "ConsoleBatch.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ConsoleBatch::ConsoleBatch(uInt32 threads)
+{
+  if(threads == 0)
+    threads = std::max(std::thread::hardware_concurrency(), 1U);
+
+  for(uInt32 i = 0; i < threads; ++i)
+    myThreads.emplace_back(&ConsoleBatch::threadMain, this);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ConsoleBatch::~ConsoleBatch()
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myQuit = true;
+  }
+
+  myWakeupCondition.notify_all();
+
+  for(auto& thread : myThreads) thread.join();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t ConsoleBatch::addConsole(const FilesystemNode& rom)
+{
+  myConsoles.push_back(make_unique<HeadlessConsole>(rom));
+
+  myFrameBuffers.resize(myConsoles.size() * FRAME_BUFFER_SIZE, 0);
+  myRAM.resize(myConsoles.size() * RAM_SIZE, 0);
+  myFailed.resize(myConsoles.size(), 0);
+
+  return myConsoles.size() - 1;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ConsoleBatch::emulateFrame()
+{
+  {
+    std::unique_lock<std::mutex> lock(myMutex);
+
+    myNextConsole = 0;
+    myPendingWorkers = static_cast<uInt32>(myThreads.size());
+    ++myGeneration;
+
+    myWakeupCondition.notify_all();
+
+    while(myPendingWorkers > 0) myDoneCondition.wait(lock);
+  }
+
+  if(myPendingException)
+  {
+    std::exception_ptr ex = myPendingException;
+    myPendingException = nullptr;
+
+    std::rethrow_exception(ex);
+  }
+
+  return std::none_of(myFailed.begin(), myFailed.end(),
+                      [](uInt8 failed) { return failed; });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConsoleBatch::reset()
+{
+  for(auto& console : myConsoles)
+    if(!console->resetToCheckpoint())
+      console->reset();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConsoleBatch::threadMain()
+{
+  uInt64 generation = 0;
+
+  for(;;)
+  {
+    {
+      std::unique_lock<std::mutex> lock(myMutex);
+
+      while(!myQuit && generation == myGeneration) myWakeupCondition.wait(lock);
+
+      if(myQuit) return;
+
+      generation = myGeneration;
+    }
+
+    try {
+      processConsoles();
+    }
+    catch(...) {
+      std::lock_guard<std::mutex> lock(myMutex);
+
+      if(!myPendingException) myPendingException = std::current_exception();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(myMutex);
+
+      if(--myPendingWorkers == 0) myDoneCondition.notify_one();
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConsoleBatch::processConsoles()
+{
+  size_t i;
+
+  while((i = myNextConsole++) < myConsoles.size())
+  {
+    HeadlessConsole& console = *myConsoles[i];
+
+    myFailed[i] = !console.emulateFrame();
+
+    std::copy_n(console.frameBuffer(), FRAME_BUFFER_SIZE,
+                myFrameBuffers.data() + i * FRAME_BUFFER_SIZE);
+    std::copy_n(console.ram(), RAM_SIZE, myRAM.data() + i * RAM_SIZE);
+  }
+}
@@ -0,0 +1,140 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef CONSOLE_BATCH_HXX
+#define CONSOLE_BATCH_HXX
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <exception>
+
+class FilesystemNode;
+
+#include "bspf.hxx"
+#include "TIAConstants.hxx"
+#include "HeadlessConsole.hxx"
+
+/**
+  Hosts a number of HeadlessConsole instances in a single process and steps
+  all of them in lock-step, one frame per call, on a persistent pool of
+  worker threads.
+
+  After each step the frame buffers and RAM of all consoles are available
+  as contiguous arrays (console i starts at offset i * frameBufferSize()
+  resp. i * RAM_SIZE), ready to be consumed as a batch.
+*/
+class ConsoleBatch
+{
+  public:
+    static constexpr size_t FRAME_BUFFER_SIZE =
+      TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight;
+    static constexpr size_t RAM_SIZE = 128;
+
+  public:
+    /**
+      Create a batch that is stepped by the given number of worker
+      threads (0 = one per hardware thread).
+    */
+    explicit ConsoleBatch(uInt32 threads = 0);
+
+    /**
+      The destructor shuts down and joins the workers.
+    */
+    ~ConsoleBatch();
+
+  public:
+    /**
+      Add a console running the given ROM. Throws a runtime_error if the
+      console cannot be created.
+
+      @return  The index of the new console
+    */
+    size_t addConsole(const FilesystemNode& rom);
+
+    /**
+      Emulate one frame on every console and update the frame buffer and
+      RAM arrays. Exceptions that occur on the workers are rethrown here.
+
+      @return  False if emulation failed on at least one console
+    */
+    bool emulateFrame();
+
+    /**
+      Reset all consoles; those with a checkpoint are put back into it
+      (see HeadlessConsole::resetToCheckpoint()).
+    */
+    void reset();
+
+    size_t size() const { return myConsoles.size(); }
+
+    HeadlessConsole& console(size_t i) { return *myConsoles[i]; }
+
+    /**
+      Whether emulation of the given console failed during the last step.
+    */
+    bool failed(size_t i) const { return myFailed[i]; }
+
+    const uInt8* frameBuffers() const { return myFrameBuffers.data(); }
+    const uInt8* frameBuffer(size_t i) const {
+      return myFrameBuffers.data() + i * FRAME_BUFFER_SIZE;
+    }
+
+    const uInt8* ram() const { return myRAM.data(); }
+    const uInt8* ram(size_t i) const { return myRAM.data() + i * RAM_SIZE; }
+
+  private:
+    void threadMain();
+
+    /**
+      Step all consoles that have not been claimed by another worker yet.
+    */
+    void processConsoles();
+
+  private:
+    vector<unique_ptr<HeadlessConsole>> myConsoles;
+
+    vector<uInt8> myFrameBuffers;
+    vector<uInt8> myRAM;
+    vector<uInt8> myFailed;
+
+    vector<std::thread> myThreads;
+
+    std::mutex myMutex;
+    std::condition_variable myWakeupCondition;
+    std::condition_variable myDoneCondition;
+
+    // Incremented for every step; workers wake up when it changes
+    uInt64 myGeneration{0};
+    uInt32 myPendingWorkers{0};
+    bool myQuit{false};
+
+    // Index of the next console that is to be claimed by a worker
+    std::atomic<size_t> myNextConsole{0};
+
+    std::exception_ptr myPendingException;
+
+  private:
+    // Following constructors and assignment operators not supported
+    ConsoleBatch(const ConsoleBatch&) = delete;
+    ConsoleBatch(ConsoleBatch&&) = delete;
+    ConsoleBatch& operator=(const ConsoleBatch&) = delete;
+    ConsoleBatch& operator=(ConsoleBatch&&) = delete;
+};
+
+#endif // CONSOLE_BATCH_HXX
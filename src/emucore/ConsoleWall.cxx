@@ -0,0 +1,173 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <cmath>
+
+#include "FrameBuffer.hxx"
+#include "FBSurface.hxx"
+#include "TIASurface.hxx"
+#include "TIAConstants.hxx"
+#include "AtariNTSC.hxx"
+#include "ConsoleBatch.hxx"
+#include "HeadlessConsole.hxx"
+#include "TIA.hxx"
+#include "ConsoleWall.hxx"
+
+namespace {
+  constexpr uInt32 TIA_WIDTH = TIAConstants::frameBufferWidth;
+  constexpr uInt32 NTSC_WIDTH = AtariNTSC::outWidth(TIAConstants::frameBufferWidth);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ConsoleWall::ConsoleWall(FrameBuffer& fb, uInt32 tiles, uInt32 lines)
+  : myFB{fb},
+    myTiles{std::max(tiles, 1U)},
+    myLines{BSPF::clamp(lines, 1U, TIAConstants::frameBufferHeight)}
+{
+  // As square as possible
+  myColumns = uInt32(std::ceil(std::sqrt(double(myTiles))));
+  myRows = (myTiles + myColumns - 1) / myColumns;
+
+  // Allocated wide enough for the TV filter, of which only a part is used
+  // without it
+  mySurface = myFB.allocateSurface(myColumns * NTSC_WIDTH, myRows * myLines,
+                                   ScalingInterpolation::sharp);
+  myShown.resize(size_t(myTiles) * TIA_WIDTH * myLines);
+
+  updateTileWidth();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ConsoleWall::~ConsoleWall()
+{
+  myFB.deallocateSurface(mySurface);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConsoleWall::update(uInt32 tile, const uInt8* frame, uInt32 height)
+{
+  if(tile >= myTiles)
+    return;
+
+  updateTileWidth();
+
+  TIASurface& tiaSurface = myFB.tiaSurface();
+  const Common::Rect rect = tileRect(tile);
+  uInt8* shown = myShown.data() + size_t(tile) * TIA_WIDTH * myLines;
+  height = std::min(height, myLines);
+
+  uInt32 *pixels = nullptr, pitch = 0;
+  mySurface->basePtr(pixels, pitch);
+  uInt32* out = pixels + rect.y() * pitch + rect.x();
+
+  // Find the rows which changed; lines below the frame are shown black
+  uInt32 first = myLines, last = 0;
+  for(uInt32 y = 0; y < myLines; ++y)
+  {
+    uInt8* dst = shown + y * TIA_WIDTH;
+    if(y < height)
+    {
+      const uInt8* src = frame + y * TIA_WIDTH;
+      if(std::equal(src, src + TIA_WIDTH, dst))
+        continue;
+      std::copy_n(src, TIA_WIDTH, dst);
+    }
+    else
+    {
+      if(std::all_of(dst, dst + TIA_WIDTH, [](uInt8 c) { return c == 0; }))
+        continue;
+      std::fill_n(dst, TIA_WIDTH, 0);
+    }
+    first = std::min(first, y);
+    last = y;
+  }
+  if(first > last)
+    return;
+
+  const uInt32 rows = last - first + 1;
+  if(tiaSurface.ntscEnabled())
+  {
+    // The filter only works along the lines, so the changed span suffices
+    tiaSurface.ntsc().render(shown + first * TIA_WIDTH, TIA_WIDTH, rows,
+                             out + first * pitch, pitch << 2);
+  }
+  else
+  {
+    const PaletteArray& palette = tiaSurface.palette();
+    for(uInt32 y = first; y <= last; ++y)
+    {
+      const uInt8* src = shown + y * TIA_WIDTH;
+      uInt32* dst = out + y * pitch;
+      for(uInt32 x = 0; x < TIA_WIDTH; ++x)
+        dst[x] = palette[src[x]];
+    }
+  }
+  mySurface->setDirty(rect.x(), rect.y() + first, myTileWidth, rows);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConsoleWall::update(ConsoleBatch& batch)
+{
+  const uInt32 tiles = std::min(myTiles, uInt32(batch.size()));
+
+  for(uInt32 tile = 0; tile < tiles; ++tile)
+    update(tile, batch.frameBuffer(tile), batch.console(tile).tia().height());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConsoleWall::render(const Common::Rect& dst)
+{
+  updateTileWidth();
+
+  mySurface->setSrcRect(Common::Rect(width(), height()));
+  mySurface->setDstRect(dst);
+  mySurface->render();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Common::Rect ConsoleWall::tileRect(uInt32 tile) const
+{
+  const uInt32 x = (tile % myColumns) * myTileWidth;
+  const uInt32 y = (tile / myColumns) * myLines;
+
+  return Common::Rect(x, y, x + myTileWidth, y + myLines);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConsoleWall::updateTileWidth()
+{
+  const uInt32 tileWidth = myFB.tiaSurface().ntscEnabled() ? NTSC_WIDTH : TIA_WIDTH;
+
+  if(tileWidth != myTileWidth)
+  {
+    myTileWidth = tileWidth;
+    clear();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConsoleWall::clear()
+{
+  uInt32 *pixels = nullptr, pitch = 0;
+  mySurface->basePtr(pixels, pitch);
+
+  std::fill_n(pixels, size_t(pitch) * mySurface->height(), 0);
+  mySurface->setDirty(0, mySurface->height());
+
+  // Make every row count as changed on the next update
+  std::fill(myShown.begin(), myShown.end(), 0xff);
+}
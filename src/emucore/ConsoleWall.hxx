@@ -0,0 +1,122 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef CONSOLE_WALL_HXX
+#define CONSOLE_WALL_HXX
+
+class FrameBuffer;
+class FBSurface;
+class ConsoleBatch;
+
+#include "Rect.hxx"
+#include "bspf.hxx"
+
+/**
+  Shows the frames of many consoles (e.g. of a ConsoleBatch or a
+  tournament) side by side, arranged in a grid of tiles.
+
+  All tiles live in a single surface, so a refresh costs one texture upload
+  (restricted to the rows which changed since the last one) and one draw
+  call, instead of one per console.  The palette and the TV filter are
+  shared with the main TIA surface, so the tiles look like the main
+  emulation and follow its settings.
+
+  Each tile remembers the indexed frame it last showed; only rows which
+  differ are converted again.
+
+  @author  Stella Team
+*/
+class ConsoleWall
+{
+  public:
+    /**
+      Create a wall.
+
+      @param fb     The framebuffer to allocate the surface from
+      @param tiles  The number of consoles to show
+      @param lines  The height of each tile in scanlines; taller frames
+                    are cropped
+    */
+    ConsoleWall(FrameBuffer& fb, uInt32 tiles, uInt32 lines);
+    ~ConsoleWall();
+
+    /**
+      Update a tile with the given TIA frame (indexed colors, 160 pixels
+      per line).
+
+      @param tile    The tile to update
+      @param frame   The frame to show
+      @param height  The number of valid lines in the frame
+    */
+    void update(uInt32 tile, const uInt8* frame, uInt32 height);
+
+    /**
+      Update all tiles with the current frames of the batch's consoles.
+    */
+    void update(ConsoleBatch& batch);
+
+    /**
+      Draw all tiles, scaled into the given rectangle of the screen.
+    */
+    void render(const Common::Rect& dst);
+
+    /**
+      The area of a tile within the unscaled wall.
+    */
+    Common::Rect tileRect(uInt32 tile) const;
+
+    uInt32 tiles() const { return myTiles; }
+    uInt32 columns() const { return myColumns; }
+    uInt32 rows() const { return myRows; }
+
+    uInt32 width() const { return myColumns * myTileWidth; }
+    uInt32 height() const { return myRows * myLines; }
+
+  private:
+    /**
+      Adapt the tile width to the current TV filter, clearing all tiles if
+      it changed.
+    */
+    void updateTileWidth();
+
+    void clear();
+
+  private:
+    FrameBuffer& myFB;
+    shared_ptr<FBSurface> mySurface;
+
+    uInt32 myTiles{0};
+    uInt32 myLines{0};
+    uInt32 myColumns{0};
+    uInt32 myRows{0};
+
+    // Width of a tile in pixels, depends on the TV filter
+    uInt32 myTileWidth{0};
+
+    // The frames currently shown, one after the other
+    ByteArray myShown;
+
+  private:
+    // Following constructors and assignment operators not supported
+    ConsoleWall() = delete;
+    ConsoleWall(const ConsoleWall&) = delete;
+    ConsoleWall(ConsoleWall&&) = delete;
+    ConsoleWall& operator=(const ConsoleWall&) = delete;
+    ConsoleWall& operator=(ConsoleWall&&) = delete;
+};
+
+#endif // CONSOLE_WALL_HXX
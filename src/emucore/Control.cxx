@@ -32,6 +32,12 @@ Controller::Controller(Jack jack, const Event& event, const System& system,
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 Controller::read()
+{
+  return myDigitalPinState & 0b1111;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 Controller::readDigitalPins()
 {
   uInt8 ioport = 0b0000;
   if(read(DigitalPin::One))   ioport |= 0b0001;
@@ -156,5 +162,5 @@ void Controller::setAutoFireRate(int rate, bool isNTSC)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-int Controller::AUTO_FIRE_RATE = 0;
+std::atomic<int> Controller::AUTO_FIRE_RATE{0};
 
@@ -18,11 +18,13 @@
 #ifndef CONTROLLER_HXX
 #define CONTROLLER_HXX
 
+class AudioSource;
 class Controller;
 class ControllerLowLevel;
 class Event;
 class System;
 
+#include <atomic>
 #include <functional>
 
 #include "bspf.hxx"
@@ -136,6 +138,10 @@ class Controller : public Serializable
       Read the entire state of all digital pins for this controller.
       Note that this method must use the lower 4 bits, and zero the upper bits.
 
+      The default implementation returns the pin states which were set
+      (without calling read(DigitalPin)), so controllers which determine
+      any of pins 1 - 4 at read time must override it (see readDigitalPins()).
+
       @return The state of all digital pins
     */
     virtual uInt8 read();
@@ -192,6 +198,12 @@ class Controller : public Serializable
     */
     virtual bool isAnalog() const { return false; }
 
+    /**
+      The sound the controller produces itself, which is mixed into the
+      TIA output (e.g. the KidVid tape), or nullptr if there is none.
+    */
+    virtual AudioSource* audioSource() { return nullptr; }
+
     /**
       Notification method invoked by the system after its reset method has
       been called.  It may be necessary to override this method for
@@ -287,10 +299,12 @@ class Controller : public Serializable
       The read/write methods above are meant to be used at a higher level.
     */
     inline bool setPin(DigitalPin pin, bool value) {
-      return myDigitalPinState[static_cast<int>(pin)] = value;
+      const uInt8 mask = 1 << static_cast<int>(pin);
+      myDigitalPinState = value ? myDigitalPinState | mask : myDigitalPinState & ~mask;
+      return value;
     }
     inline bool getPin(DigitalPin pin) const {
-      return myDigitalPinState[static_cast<int>(pin)];
+      return myDigitalPinState & (1 << static_cast<int>(pin));
     }
     inline void setPin(AnalogPin pin, AnalogReadout::Connection value) {
       myAnalogPinValue[static_cast<int>(pin)] = value;
@@ -312,6 +326,13 @@ class Controller : public Serializable
       setPin(AnalogPin::Nine, AnalogReadout::disconnect());
     }
 
+    /**
+      Read pins 1 - 4 one by one using read(DigitalPin).
+
+      @return The state of all digital pins
+    */
+    uInt8 readDigitalPins();
+
     /**
       Checks for the next auto fire event.
 
@@ -367,15 +388,16 @@ class Controller : public Serializable
     onAnalogPinUpdateCallback myOnAnalogPinUpdateCallback{nullptr};
 
     /// Defines the speed of the auto fire
-    static int AUTO_FIRE_RATE;
+    static std::atomic<int> AUTO_FIRE_RATE;
 
     /// Delay[frames] until the next fire event
     int myFireDelay{0};
     int myFireDelayP1{0}; // required for paddles only
 
   private:
-    /// The boolean value on each digital pin
-    std::array<bool, 5> myDigitalPinState{true, true, true, true, true};
+    /// The value on each digital pin, one bit per pin (in the order of
+    /// DigitalPin, so the lower 4 bits are the port value)
+    uInt8 myDigitalPinState{0b11111};
 
     /// The analog value on each analog pin
     std::array<AnalogReadout::Connection, 2>
@@ -19,6 +19,8 @@
 #define CONTROLLER_DETECTOR_HXX
 
 class Settings;
+class RomSignatures;
+class SignatureScanner;
 
 #include "Control.hxx"
 
@@ -41,7 +43,15 @@ class ControllerDetector
       @param settings   A reference to the various settings (read-only)
       @return   The detected controller type
     */
-    static Controller::Type detectType(const ByteBuffer& image, size_t size,
+    static Controller::Type detectType(const uInt8* image, size_t size,
+        const Controller::Type controller, const Controller::Jack port,
+        const Settings& settings);
+
+    /**
+      Same as above, with the signatures of the image already scanned
+      (e.g. once for both ports).
+    */
+    static Controller::Type detectType(const RomSignatures& signatures,
         const Controller::Type controller, const Controller::Jack port,
         const Settings& settings);
 
@@ -57,72 +67,103 @@ class ControllerDetector
 
       @return   The (detected) controller name
     */
-    static string detectName(const ByteBuffer& image, size_t size,
+    static string detectName(const uInt8* image, size_t size,
+        const Controller::Type type, const Controller::Jack port,
+        const Settings& settings);
+
+    /**
+      Same as above, with the signatures of the image already scanned.
+    */
+    static string detectName(const RomSignatures& signatures,
         const Controller::Type type, const Controller::Jack port,
         const Settings& settings);
 
   private:
+    friend class RomSignatures;
+
     /**
-      Detects the controller type at the given port.
+      The groups of byte signatures searched for in the complete image;
+      a check succeeds if any signature of its group is found.  The actual
+      byte sequences are defined in ControllerDetector.cxx.
+    */
+    enum class Signature: uInt8 {
+      JoystickButtonLeft, JoystickButtonRight,
+      // Keyboards access both of their port's paddle inputs
+      KeyboardLeft0, KeyboardLeft1, KeyboardRight0, KeyboardRight1,
+      GenesisButtonLeft, GenesisButtonRight,
+      PaddleLeft, PaddleRight,
+      TrakBall, AtariMouse, AmigaMouse,
+      SaveKey,
+      LightGunLeft, LightGunRight,
+      QuadTari, QuadTariLeft, QuadTariRight,
+
+      numSignatures
+    };
 
-      @param image      A reference to the ROM image
-      @param size       The size of the ROM image
-      @param port       The port to be checked
-      @param settings   A reference to the various settings (read-only)
+    /**
+      The number of occurrences of each signature group in the image
+    */
+    using SignatureHits =
+      std::array<uInt32, static_cast<size_t>(Signature::numSignatures)>;
 
-      @return   The detected controller type
+    /**
+      Add the signatures to the scanner, with ids starting at 'firstId'
     */
-    static Controller::Type autodetectPort(const ByteBuffer& image, size_t size,
-        Controller::Jack port, const Settings& settings);
+    static void addSignatures(SignatureScanner& scanner, uInt32 firstId);
 
     /**
-      Search the image for the specified byte signature.
+      Returns true if any signature of the group was found
+    */
+    static bool found(const SignatureHits& hits, Signature signature) {
+      return hits[static_cast<size_t>(signature)] > 0;
+    }
 
-      @param image      A pointer to the ROM image
-      @param imagesize  The size of the ROM image
-      @param signature  The byte sequence to search for
-      @param sigsize    The number of bytes in the signature
+    /**
+      Detects the controller type at the given port.
 
-      @return  True if the signature was found, else false
+      @param hits       The signatures found in the ROM image
+      @param port       The port to be checked
+      @param settings   A reference to the various settings (read-only)
+
+      @return   The detected controller type
     */
-    static bool searchForBytes(const ByteBuffer& image, size_t imagesize,
-                               const uInt8* signature, uInt32 sigsize);
+    static Controller::Type autodetectPort(const SignatureHits& hits,
+        Controller::Jack port, const Settings& settings);
 
     // Returns true if the port's joystick button access code is found.
-    static bool usesJoystickButton(const ByteBuffer& image, size_t size,
+    static bool usesJoystickButton(const SignatureHits& hits,
                                    Controller::Jack port);
 
     // Returns true if the port's keyboard access code is found.
-    static bool usesKeyboard(const ByteBuffer& image, size_t size,
-                             Controller::Jack port);
+    static bool usesKeyboard(const SignatureHits& hits, Controller::Jack port);
 
     // Returns true if the port's 2nd Genesis button access code is found.
-    static bool usesGenesisButton(const ByteBuffer& image, size_t size,
+    static bool usesGenesisButton(const SignatureHits& hits,
                                   Controller::Jack port);
 
     // Returns true if the port's paddle button access code is found.
-    static bool usesPaddle(const ByteBuffer& image, size_t size,
+    static bool usesPaddle(const SignatureHits& hits,
                            Controller::Jack port, const Settings& settings);
 
     // Returns true if a Trak-Ball table is found.
-    static bool isProbablyTrakBall(const ByteBuffer& image, size_t size);
+    static bool isProbablyTrakBall(const SignatureHits& hits);
 
     // Returns true if an Atari Mouse table is found.
-    static bool isProbablyAtariMouse(const ByteBuffer& image, size_t size);
+    static bool isProbablyAtariMouse(const SignatureHits& hits);
 
     // Returns true if an Amiga Mouse table is found.
-    static bool isProbablyAmigaMouse(const ByteBuffer& image, size_t size);
+    static bool isProbablyAmigaMouse(const SignatureHits& hits);
 
     // Returns true if a SaveKey code pattern is found.
-    static bool isProbablySaveKey(const ByteBuffer& image, size_t size,
+    static bool isProbablySaveKey(const SignatureHits& hits,
                                   Controller::Jack port);
 
     // Returns true if a Lightgun code pattern is found
-    static bool isProbablyLightGun(const ByteBuffer& image, size_t size,
+    static bool isProbablyLightGun(const SignatureHits& hits,
                                    Controller::Jack port);
 
     // Returns true if a QuadTari code pattern is found.
-    static bool isProbablyQuadTari(const ByteBuffer& image, size_t size,
+    static bool isProbablyQuadTari(const SignatureHits& hits,
                                    Controller::Jack port);
 
   private:
@@ -227,4 +227,4 @@ void Driving::setSensitivity(int sensitivity)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-float Driving::SENSITIVITY = 1.0;
+std::atomic<float> Driving::SENSITIVITY{1.0F};
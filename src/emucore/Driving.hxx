@@ -114,7 +114,7 @@ class Driving : public Controller
 
     // User-defined sensitivity; adjustable since end-users may prefer different
     // speeds
-    static float SENSITIVITY;
+    static std::atomic<float> SENSITIVITY;
 
   private:
     /**
@@ -20,6 +20,9 @@
 #include "EmulationWorker.hxx"
 #include "DispatchResult.hxx"
 #include "TIA.hxx"
+#include "AudioQueue.hxx"
+#include "TraceRecorder.hxx"
+#include "ThreadControl.hxx"
 
 using namespace std::chrono;
 
@@ -91,6 +94,9 @@ void EmulationWorker::start(uInt32 cyclesPerSecond, uInt64 maxCycles, uInt64 min
     if (myState != State::waitingForResume)
       fatal("start called on running or dead worker");
 
+    // The emulation cost of a new console is unknown
+    if (tia != myTia) myLoad = 0.;
+
     // Store the parameters for emulation
     myTia = tia;
     myCyclesPerSecond = cyclesPerSecond;
@@ -98,6 +104,9 @@ void EmulationWorker::start(uInt32 cyclesPerSecond, uInt64 maxCycles, uInt64 min
     myMinCycles = minCycles;
     myDispatchResult = dispatchResult;
 
+    // The thread is suspended, so we can safely configure the TIA
+    myTia->setRenderInterval(myRenderInterval);
+
     // Raise the signal...
     myPendingSignal = Signal::resume;
   }
@@ -144,6 +153,9 @@ void EmulationWorker::threadMain(std::condition_variable* initializedCondition,
 {
   std::unique_lock<std::mutex> lock(myThreadIsRunningMutex);
 
+  if (TraceRecorder::enabled()) TraceRecorder::instance().setThreadName("Emulation");
+  ThreadControl::apply(ThreadControl::Thread::emulation);
+
   try {
     {
       // Wait until our parent releases the lock and sleeps
@@ -264,10 +276,29 @@ void EmulationWorker::dispatchEmulation(std::unique_lock<std::mutex>& lock)
 
   uInt64 totalCycles = 0;
 
-  do {
-    myTia->update(*myDispatchResult, totalCycles > 0 ? myMinCycles - totalCycles : myMaxCycles);
-    totalCycles += myDispatchResult->getCycles();
-  } while (totalCycles < myMinCycles && myDispatchResult->getStatus() == DispatchResult::Status::ok);
+  {
+    TraceRecorder::Scope traceScope("Timeslice", "emulation");
+
+    uInt64 maxCycles = timesliceCycles(), minCycles = std::min(myMinCycles, maxCycles);
+
+    if (myScanlineAligned) {
+      // The CPU may still overshoot the line end by part of an instruction
+      const uInt64 rest = (myTia->clocksThisLine() / 3 + maxCycles) % 76;
+
+      if (maxCycles > rest) maxCycles -= rest;
+      minCycles = maxCycles;
+    }
+
+    const auto start = high_resolution_clock::now();
+
+    do {
+      myTia->update(*myDispatchResult, totalCycles > 0 ? minCycles - totalCycles : maxCycles);
+      totalCycles += myDispatchResult->getCycles();
+    } while (totalCycles < minCycles && myDispatchResult->getStatus() == DispatchResult::Status::ok);
+
+    updateLoad(totalCycles, high_resolution_clock::now() - start);
+    traceScope.setArg("cycles", totalCycles);
+  }
 
   myTotalCycles += totalCycles;
 
@@ -295,6 +326,47 @@ void EmulationWorker::dispatchEmulation(std::unique_lock<std::mutex>& lock)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 EmulationWorker::timesliceCycles() const
+{
+  // Never go below an eighth of a frame (a quarter of the nominal minimum), as
+  // this would only add wakeups
+  const uInt64 lowerBound = std::min(std::max<uInt64>(myMinCycles / 4, 1), myMaxCycles);
+
+  // Cheap emulation ends its timeslices at the end of a frame, as before
+  double cycles = static_cast<double>(myMaxCycles);
+
+  // Keep the wall time of a timeslice bounded, so the main thread never waits long
+  // for a running timeslice to finish
+  if (myLoad > 0.)
+    cycles = std::min(cycles, MAX_TIMESLICE_REALTIME * myCyclesPerSecond / myLoad);
+
+  // With less than half of the audio queue filled, deliver audio in smaller portions
+  const AudioQueue* queue = myTia->audioQueue();
+  if (queue && queue->capacity() > 0) {
+    const double fill = static_cast<double>(queue->size()) / queue->capacity();
+
+    if (fill < 0.5) cycles *= std::max(2 * fill, 0.25);
+  }
+
+  return std::clamp(static_cast<uInt64>(cycles), lowerBound, myMaxCycles);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EmulationWorker::updateLoad(uInt64 cycles, duration<double> realtime)
+{
+  if (cycles == 0 || myCyclesPerSecond == 0) return;
+
+  const double load =
+    realtime.count() * static_cast<double>(myCyclesPerSecond) / static_cast<double>(cycles);
+
+  // React quickly to expensive timeslices, but only slowly to cheap ones
+  if (myLoad == 0.)
+    myLoad = load;
+  else
+    myLoad += (load > myLoad ? 0.5 : 0.1) * (load - myLoad);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void EmulationWorker::clearSignal()
 {
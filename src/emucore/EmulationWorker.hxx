@@ -33,6 +33,11 @@
  * In combination, the scheduling in the main loop and the microscheduling in the worker
  * ensure that the emulation continues to run even if rendering blocks, ensuring the real
  * time scheduling required for cycle exact audio to work.
+ *
+ * The size of the timeslices adapts to the measured cost of emulation and to the fill
+ * level of the audio queue. Cheap carts keep running one frame per timeslice, while
+ * expensive ones (ARM) are cut into slices that bound the time the main thread may have
+ * to wait for a running slice. A draining audio queue is fed in smaller portions.
  */
 
 #ifndef EMULATION_WORKER_HXX
@@ -65,7 +70,9 @@ class EmulationWorker
     ~EmulationWorker();
 
     /**
-      Wake up the worker and start emulation with the specified parameters.
+      Wake up the worker and start emulation with the specified parameters. The
+      maximum number of cycles per timeslice is reduced as required, see
+      timesliceCycles().
      */
     void start(uInt32 cyclesPerSecond, uInt64 maxCycles, uInt64 minCycles, DispatchResult* dispatchResult, TIA* tia);
 
@@ -74,6 +81,19 @@ class EmulationWorker
      */
     uInt64 stop();
 
+    /**
+      Draw only every nth frame (0 = none) while emulating, see
+      TIA::setRenderInterval. Takes effect with the next start().
+     */
+    void setRenderInterval(uInt32 interval) { myRenderInterval = interval; }
+
+    /**
+      End each timeslice at the end of a scanline, and don't end it early at
+      the end of a frame. Used when the slices are shorter than a frame to
+      sample input, which is then applied at a scanline boundary.
+     */
+    void setScanlineAligned(bool aligned) { myScanlineAligned = aligned; }
+
   private:
 
     /**
@@ -108,6 +128,17 @@ class EmulationWorker
      */
     void dispatchEmulation(std::unique_lock<std::mutex>& lock);
 
+    /**
+      The maximum number of cycles for the next timeslice, adapted to the emulation
+      cost and the audio queue fill level.
+     */
+    uInt64 timesliceCycles() const;
+
+    /**
+      Update the measured emulation cost with a finished timeslice.
+     */
+    void updateLoad(uInt64 cycles, std::chrono::duration<double> realtime);
+
     /**
       Clear any pending signal and wake up the main thread (if it is waiting for the signal
       to be cleared).
@@ -193,6 +224,14 @@ class EmulationWorker
     uInt64 myMaxCycles{0};
     uInt64 myMinCycles{0};
     DispatchResult* myDispatchResult{nullptr};
+    uInt32 myRenderInterval{1};
+    bool myScanlineAligned{false};
+
+    // Wall time needed per emulated second (smoothed), 0 if not measured yet
+    double myLoad{0.};
+
+    // Wall time a single timeslice should not exceed (in seconds)
+    static constexpr double MAX_TIMESLICE_REALTIME = 0.004;
 
     // Total number of cycles during this emulation run
     uInt64 myTotalCycles{0};
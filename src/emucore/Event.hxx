@@ -169,6 +169,8 @@ class Event
       SALeftAxis0Value, SALeftAxis1Value, SARightAxis0Value, SARightAxis1Value,
       QTPaddle3AFire, QTPaddle3BFire, QTPaddle4AFire, QTPaddle4BFire,
       UIHelp,
+      ToggleMovieRecord,
+      CalibrateAudio,
       LastType
     };
 
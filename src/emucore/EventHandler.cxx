@@ -34,7 +34,9 @@
 #include "PropsSet.hxx"
 #include "Settings.hxx"
 #include "Sound.hxx"
+#include "AudioCalibration.hxx"
 #include "StateManager.hxx"
+#include "Netplay.hxx"
 #include "RewindManager.hxx"
 #include "TimerManager.hxx"
 #ifdef GUI_SUPPORT
@@ -249,6 +251,11 @@ void EventHandler::poll(uInt64 time)
   // Process events from the underlying hardware
   pollEvent();
 
+#ifdef PNG_SUPPORT
+  // Report snapshots saved in the background
+  myOSystem.png().update();
+#endif
+
   // Update controllers and console switches, and in general all other things
   // related to emulation
   if(myState == EventHandlerState::EMULATION)
@@ -261,8 +268,7 @@ void EventHandler::poll(uInt64 time)
       myOSystem.state().update();
 
   #ifdef CHEATCODE_SUPPORT
-    for(auto& cheat: myOSystem.cheat().perFrame())
-      cheat->evaluate();
+    myOSystem.cheat().applyPerFrame();
   #endif
 
   #ifdef PNG_SUPPORT
@@ -651,6 +657,10 @@ void EventHandler::handleEvent(Event::Type event, Int32 value, bool repeated)
   // or need to be preprocessed before passing them on
   const bool pressed = (value != 0);
 
+  // Netplay peers must not diverge
+  if(myOSystem.netplayActive() && !Netplay::allowsEvent(event))
+    return;
+
   // The global settings keys change settings or values as long as the setting
   //  message from the previous settings event is still displayed.
   // Therefore, do not change global settings/values or direct values if
@@ -859,6 +869,10 @@ void EventHandler::handleEvent(Event::Type event, Int32 value, bool repeated)
       }
       return;
 
+    case Event::CalibrateAudio:
+      if(pressed && !repeated) myOSystem.audioCalibration().toggle();
+      return;
+
     case Event::VidmodeDecrease:
       if(pressed)
       {
@@ -1809,6 +1823,10 @@ void EventHandler::handleEvent(Event::Type event, Int32 value, bool repeated)
       if (pressed && !repeated) myOSystem.state().toggleTimeMachine();
       return;
 
+    case Event::ToggleMovieRecord:
+      if (pressed && !repeated) myOSystem.state().toggleRecordMode();
+      return;
+
   #ifdef PNG_SUPPORT
     case Event::ToggleContSnapshots:
       if (pressed && !repeated) myOSystem.png().toggleContinuousSnapshots(false);
@@ -3260,6 +3278,7 @@ EventHandler::EmulActionList EventHandler::ourEmulActionList = { {
   { Event::SoundToggle,             "Toggle sound",                          "" },
   { Event::VolumeDecrease,          "Decrease volume",                       "" },
   { Event::VolumeIncrease,          "Increase volume",                       "" },
+  { Event::CalibrateAudio,          "Calibrate audio buffering",             "" },
 
 
   { Event::DecreaseDeadzone,        "Decrease joystick deadzone",            "" },
@@ -3310,6 +3329,7 @@ EventHandler::EmulActionList EventHandler::ourEmulActionList = { {
   { Event::Unwind10Menu,            "Unwind 10 states & enter TM UI",        "" },
   { Event::UnwindAllMenu,           "Unwind all states & enter TM UI",       "" },
   { Event::TogglePlayBackMode,      "Toggle 'Time Machine' playback mode",   "" },
+  { Event::ToggleMovieRecord,       "Toggle input movie recording",          "" },
 
   { Event::Combo1,                  "Combo 1",                               "" },
   { Event::Combo2,                  "Combo 2",                               "" },
@@ -3376,6 +3396,7 @@ const Event::EventSet EventHandler::MiscEvents = {
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 const Event::EventSet EventHandler::AudioVideoEvents = {
   Event::VolumeDecrease, Event::VolumeIncrease, Event::SoundToggle,
+  Event::CalibrateAudio,
   Event::VidmodeDecrease, Event::VidmodeIncrease,
   Event::ToggleFullScreen, Event::ToggleAdaptRefresh,
   Event::OverscanDecrease, Event::OverscanIncrease,
@@ -3399,7 +3420,7 @@ const Event::EventSet EventHandler::StateEvents = {
   Event::TimeMachineMode, Event::RewindPause, Event::UnwindPause, Event::ToggleTimeMachine,
   Event::Rewind1Menu, Event::Rewind10Menu, Event::RewindAllMenu,
   Event::Unwind1Menu, Event::Unwind10Menu, Event::UnwindAllMenu,
-  Event::TogglePlayBackMode,
+  Event::TogglePlayBackMode, Event::ToggleMovieRecord,
   Event::SaveAllStates, Event::LoadAllStates, Event::ToggleAutoSlot,
 };
 
@@ -55,6 +55,7 @@ void FBSurface::pixel(uInt32 x, uInt32 y, ColorId color)
   uInt32* buffer = myPixels + y * myPitch + x;
 
   *buffer = myPalette[color];
+  setDirty(x, y, 1, 1);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -125,6 +126,7 @@ void FBSurface::hLine(uInt32 x, uInt32 y, uInt32 x2, ColorId color)
   if(!checkBounds(x, y) || !checkBounds(x2, 2))
     return;
 
+  setDirty(x, y, x2 - x + 1, 1);
   uInt32* buffer = myPixels + y * myPitch + x;
   while(x++ <= x2)
     *buffer++ = myPalette[color];
@@ -136,6 +138,7 @@ void FBSurface::vLine(uInt32 x, uInt32 y, uInt32 y2, ColorId color)
   if(!checkBounds(x, y) || !checkBounds(x, y2))
     return;
 
+  setDirty(x, y, 1, y2 - y + 1);
   uInt32* buffer = static_cast<uInt32*>(myPixels + y * myPitch + x);
   while(y++ <= y2)
   {
@@ -163,53 +166,24 @@ void FBSurface::drawChar(const GUI::Font& font, uInt8 chr,
     drawChar(font, chr, tx + 1, ty + 1, shadowColor);
   }
 
-  const FontDesc& desc = font.desc();
-
-  // If this character is not included in the font, use the default char.
-  if(chr < desc.firstchar || chr >= desc.firstchar + desc.size)
-  {
-    if (chr == ' ') return;
-    chr = desc.defaultchar;
-  }
-  chr -= desc.firstchar;
-
-  // Get the bounding box of the character
-  int bbw, bbh, bbx, bby;
-  if(!desc.bbx)
-  {
-    bbw = desc.fbbw;
-    bbh = desc.fbbh;
-    bbx = desc.fbbx;
-    bby = desc.fbby;
-  }
-  else
-  {
-    bbw = desc.bbx[chr].w;  // NOLINT
-    bbh = desc.bbx[chr].h;  // NOLINT
-    bbx = desc.bbx[chr].x;  // NOLINT
-    bby = desc.bbx[chr].y;  // NOLINT
-  }
+  const GUI::Font::Glyph& glyph = font.glyph(chr);
+  if(glyph.h == 0)
+    return;
 
-  uInt32 cx = tx + bbx;
-  uInt32 cy = ty + desc.ascent - bby - bbh;
+  uInt32 cx = tx + glyph.x;
+  uInt32 cy = ty + glyph.y;
 
-  if(!checkBounds(cx , cy) || !checkBounds(cx + bbw - 1, cy + bbh - 1))
+  if(!checkBounds(cx , cy) || !checkBounds(cx + glyph.w - 1, cy + glyph.h - 1))
     return;
 
-  const uInt16* tmp = desc.bits + (desc.offset ? desc.offset[chr] : (chr * desc.fbbh));
+  // The glyph is pre-rasterized into runs of set pixels (see GUI::Font)
   uInt32* buffer = myPixels + cy * myPitch + cx;
+  const uInt32 pixel = myPalette[color];
+  const GUI::Font::Run* run = font.runs(glyph);
+  setDirty(cx, cy, glyph.w, glyph.h);
 
-  for(int y = 0; y < bbh; y++)
-  {
-    const uInt16 ptr = *tmp++;
-    uInt16 mask = 0x8000;
-
-    for(int x = 0; x < bbw; x++, mask >>= 1)
-      if(ptr & mask)
-        buffer[x] = myPalette[color];
-
-    buffer += myPitch;
-  }
+  for(uInt32 i = 0; i < glyph.count; ++i, ++run)
+    std::fill_n(buffer + run->y * myPitch + run->x, run->len, pixel);
 #endif
 }
 
@@ -228,6 +202,7 @@ void FBSurface::drawBitmap(const uInt32* bitmap, uInt32 tx, uInt32 ty,
     return;
 
   uInt32* buffer = myPixels + ty * myPitch + tx;
+  setDirty(tx, ty, w, h);
 
   for(uInt32 y = 0; y < h; ++y)
   {
@@ -247,6 +222,7 @@ void FBSurface::drawPixels(const uInt32* data, uInt32 tx, uInt32 ty, uInt32 nump
     return;
 
   uInt32* buffer = myPixels + ty * myPitch + tx;
+  setDirty(tx, ty, numpixels, 1);
 
   for(uInt32 i = 0; i < numpixels; ++i)
     *buffer++ = data[i];
@@ -470,3 +446,4 @@ bool FBSurface::checkBounds(const uInt32 x, const uInt32 y) const
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 FullPaletteArray FBSurface::myPalette = { 0 };
+uInt64 FBSurface::ourUploadedBytes = 0;
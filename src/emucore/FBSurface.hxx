@@ -61,6 +61,108 @@ class FBSurface
       pitch = myPitch;
     }
 
+    /**
+      A few rectangles covering the modified area of a surface, each given
+      as [left, right) x [top, bottom).  A rectangle touching an existing
+      one is merged into it; when all slots are in use, it is merged into
+      the one growing least.
+    */
+    struct DirtyRegion {
+      struct Rect {
+        uInt32 left{0}, top{0}, right{0}, bottom{0};
+      };
+      static constexpr uInt32 MAX_RECTS = 4;
+
+      std::array<Rect, MAX_RECTS> rects;
+      uInt32 count{0};
+
+      void add(uInt32 left, uInt32 top, uInt32 right, uInt32 bottom)
+      {
+        if(left >= right || top >= bottom)
+          return;
+
+        for(uInt32 i = 0; i < count; ++i)
+          if(left <= rects[i].right && rects[i].left <= right &&
+             top <= rects[i].bottom && rects[i].top <= bottom)
+          {
+            merge(rects[i], left, top, right, bottom);
+            return;
+          }
+
+        if(count < MAX_RECTS)
+        {
+          rects[count++] = Rect{left, top, right, bottom};
+          return;
+        }
+
+        uInt32 best = 0;
+        uInt64 bestGrowth = ~uInt64(0);
+        for(uInt32 i = 0; i < count; ++i)
+        {
+          const Rect& r = rects[i];
+          const uInt64 growth =
+            area(std::min(r.left, left), std::min(r.top, top),
+                 std::max(r.right, right), std::max(r.bottom, bottom)) -
+            area(r.left, r.top, r.right, r.bottom);
+          if(growth < bestGrowth)
+          {
+            best = i;  bestGrowth = growth;
+          }
+        }
+        merge(rects[best], left, top, right, bottom);
+      }
+      void add(const DirtyRegion& other)
+      {
+        for(uInt32 i = 0; i < other.count; ++i)
+          add(other.rects[i].left, other.rects[i].top,
+              other.rects[i].right, other.rects[i].bottom);
+      }
+      void setAll() { rects[0] = Rect{0, 0, ~0U, ~0U};  count = 1; }
+      void clear()  { count = 0; }
+      bool empty() const { return count == 0; }
+
+      private:
+        static void merge(Rect& r, uInt32 left, uInt32 top, uInt32 right, uInt32 bottom)
+        {
+          r.left = std::min(r.left, left);  r.top = std::min(r.top, top);
+          r.right = std::max(r.right, right);  r.bottom = std::max(r.bottom, bottom);
+        }
+        static uInt64 area(uInt32 left, uInt32 top, uInt32 right, uInt32 bottom)
+        {
+          return uInt64(right - left) * (bottom - top);
+        }
+    };
+
+    /**
+      This method marks the given rectangle as modified, so that child
+      classes can restrict the next upload to the screen to the changed
+      area.  It must be called by everyone modifying the surface pixels
+      directly (see basePtr()); the drawing primitives below call it
+      themselves.
+
+      @param x  The first modified column
+      @param y  The first modified row
+      @param w  The number of modified columns
+      @param h  The number of modified rows
+    */
+    inline void setDirty(uInt32 x, uInt32 y, uInt32 w, uInt32 h)
+    {
+      myDirtyRegion.add(x, y, x + w, y + h);
+    }
+
+    /**
+      This method marks the given (complete) rows as modified.
+
+      @param y  The first modified row
+      @param h  The number of modified rows
+    */
+    inline void setDirty(uInt32 y, uInt32 h) { setDirty(0, y, ~0U >> 1, h); }
+
+    /**
+      This method marks the whole surface as modified.
+    */
+    inline void setDirty() { myDirtyRegion.setAll(); }
+
     /**
       This method is called to get a copy of the specified ARGB data from
       the behind-the-scenes surface.
@@ -378,6 +480,20 @@ class FBSurface
      */
     virtual void setScalingInterpolation(ScalingInterpolation) = 0;
 
+    /**
+      Darken every second scanline of the scaled image by the given
+      intensity (in percent) while drawing, if supported.
+
+      @param intensity  The scanline intensity, 0 disables scanlines
+    */
+    virtual void setScanlines(uInt32 intensity) {}
+
+    /**
+      Answers whether the surface draws the scanlines itself; otherwise
+      they have to be drawn by a separate overlay surface.
+    */
+    virtual bool drawsScanlines() const { return false; }
+
     /**
       The child class chooses which (if any) of the actual attributes
       can be applied.
@@ -387,6 +503,13 @@ class FBSurface
 
     static void setPalette(const FullPaletteArray& palette) { myPalette = palette; }
 
+    /**
+      The number of bytes uploaded to the screen by all surfaces since the
+      last call to resetUploadedBytes() (used for the frame statistics).
+    */
+    static uInt64 uploadedBytes() { return ourUploadedBytes; }
+    static void resetUploadedBytes() { ourUploadedBytes = 0; }
+
   protected:
     /**
       This method should be called to check if the given coordinates
@@ -405,6 +528,17 @@ class FBSurface
     */
     bool isWhiteSpace(const char s) const;
 
+    /**
+      Get the area modified since the last call, and reset it.
+
+      @param region  The modified area (empty if unmodified)
+    */
+    inline void takeDirtyRegion(DirtyRegion& region)
+    {
+      region = myDirtyRegion;
+      myDirtyRegion.clear();
+    }
+
   protected:
     uInt32* myPixels{nullptr};  // NOTE: MUST be set in child classes
     uInt32 myPitch{0};          // NOTE: MUST be set in child classes
@@ -412,6 +546,11 @@ class FBSurface
     Attributes myAttributes;
 
     static FullPaletteArray myPalette;
+    static uInt64 ourUploadedBytes;
+
+  private:
+    // The area modified since the last upload
+    DirtyRegion myDirtyRegion;
 
   private:
     // Following constructors and assignment operators not supported
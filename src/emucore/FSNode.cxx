@@ -71,9 +71,11 @@ bool FilesystemNode::exists() const
 bool FilesystemNode::getAllChildren(FSList& fslist, ListMode mode,
                                     const NameFilter& filter,
                                     bool includeParentDirectory,
-                                    const CancelCheck& isCancelled) const
+                                    const CancelCheck& isCancelled,
+                                    const BatchReceiver& onBatch) const
 {
-  if(getChildren(fslist, mode, filter, includeParentDirectory, true, isCancelled))
+  if(getChildren(fslist, mode, filter, includeParentDirectory, true, isCancelled,
+                 onBatch))
   {
     // Sort only once at the end
   #if defined(ZIP_SUPPORT)
@@ -90,15 +92,7 @@ bool FilesystemNode::getAllChildren(FSList& fslist, ListMode mode,
     }
   #endif
 
-    std::sort(fslist.begin(), fslist.end(),
-              [](const FilesystemNode& node1, const FilesystemNode& node2)
-    {
-      if(node1.isDirectory() != node2.isDirectory())
-        return node1.isDirectory();
-      else
-        return BSPF::compareIgnoreCase(node1.getName(), node2.getName()) < 0;
-    }
-    );
+    std::sort(fslist.begin(), fslist.end(), listOrder);
 
   #if defined(ZIP_SUPPORT)
     // After sorting replace zip files with zip nodes
@@ -124,7 +118,8 @@ bool FilesystemNode::getChildren(FSList& fslist, ListMode mode,
                                  const NameFilter& filter,
                                  bool includeChildDirectories,
                                  bool includeParentDirectory,
-                                 const CancelCheck& isCancelled) const
+                                 const CancelCheck& isCancelled,
+                                 const BatchReceiver& onBatch) const
 {
   if (!_realNode || !_realNode->isDirectory())
     return false;
@@ -174,11 +169,26 @@ bool FilesystemNode::getChildren(FSList& fslist, ListMode mode,
     fslist.emplace_back(parent);
   }
 
+  // Hand the nodes added since the last batch to the receiver (if any)
+  size_t batchStart = fslist.size();
+  const auto flushBatch = [&](size_t minSize)
+  {
+    if(onBatch && fslist.size() - batchStart >= std::max<size_t>(minSize, 1))
+    {
+      onBatch(fslist, batchStart);
+      batchStart = fslist.size();
+    }
+  };
+
   // And now add the rest of the entries
   for (const auto& i: tmp)
   {
     if(isCancelled())
+    {
+      flushBatch(0);
       return false;
+    }
+    flushBatch(BATCH_SIZE);
 
   #if defined(ZIP_SUPPORT)
     if (BSPF::endsWithIgnoreCase(i->getPath(), ".zip"))
@@ -212,7 +222,13 @@ bool FilesystemNode::getChildren(FSList& fslist, ListMode mode,
       if(includeChildDirectories)
       {
         if(i->isDirectory())
-          node.getChildren(fslist, mode, filter, includeChildDirectories, false, isCancelled);
+        {
+          // The sub-directory delivers its own batches
+          flushBatch(0);
+          node.getChildren(fslist, mode, filter, includeChildDirectories, false,
+                           isCancelled, onBatch);
+          batchStart = fslist.size();
+        }
         else
           // do not add directories in this mode
           if(filter(node))
@@ -225,6 +241,8 @@ bool FilesystemNode::getChildren(FSList& fslist, ListMode mode,
       }
     }
   }
+  flushBatch(0);
+
   return true;
 }
 
@@ -319,6 +337,18 @@ bool FilesystemNode::isWritable() const
   return _realNode ? _realNode->isWritable() : false;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FilesystemNode::getFileInfo(uInt64& size, uInt64& mtime) const
+{
+  return _realNode ? _realNode->getFileInfo(size, mtime) : false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FilesystemNode::getDirectoryStamp(uInt64& stamp) const
+{
+  return _realNode ? _realNode->getDirectoryStamp(stamp) : false;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool FilesystemNode::makeDir()
 {
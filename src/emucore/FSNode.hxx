@@ -66,6 +66,11 @@ class FilesystemNode
     using NameFilter = std::function<bool(const FilesystemNode& node)>;
     using CancelCheck = std::function<bool()> const;
 
+    /** Function called while a listing is being built, each time another
+        batch of nodes has been appended to the list (starting at 'first').
+        The receiver may reorder the list, but must not add or remove nodes.*/
+    using BatchReceiver = std::function<void(FSList& fslist, size_t first)>;
+
     /**
      * Create a new pathless FilesystemNode. Since there's no path associated
      * with this node, path-related operations (i.e. exists(), isDirectory(),
@@ -126,18 +131,26 @@ class FilesystemNode
      * Return a list of child nodes of this and all sub-directories. If called on a node
      * that does not represent a directory, false is returned.
      *
+     * If 'onBatch' is given, it is called whenever another batch of nodes
+     * has been added, so the listing can be shown while it is still growing.
+     * The final list is sorted only once all nodes have been found.
+     *
      * @return true if successful, false otherwise (e.g. when the directory
      *         does not exist).
      */
     bool getAllChildren(FSList& fslist, ListMode mode = ListMode::DirectoriesOnly,
                         const NameFilter& filter = [](const FilesystemNode&) { return true; },
                         bool includeParentDirectory = true,
-                        const CancelCheck& isCancelled = []() { return false; }) const;
+                        const CancelCheck& isCancelled = []() { return false; },
+                        const BatchReceiver& onBatch = nullptr) const;
 
     /**
      * Return a list of child nodes of this directory node. If called on a node
      * that does not represent a directory, false is returned.
      *
+     * If 'onBatch' is given, it is called whenever another batch of nodes
+     * has been added, so the listing can be shown while it is still growing.
+     *
      * @return true if successful, false otherwise (e.g. when the directory
      *         does not exist).
      */
@@ -145,7 +158,20 @@ class FilesystemNode
                      const NameFilter& filter = [](const FilesystemNode&){ return true; },
                      bool includeChildDirectories = false,
                      bool includeParentDirectory = true,
-                     const CancelCheck& isCancelled = []() { return false; }) const;
+                     const CancelCheck& isCancelled = []() { return false; },
+                     const BatchReceiver& onBatch = nullptr) const;
+
+    /**
+     * Compare two nodes in the order used for listings: directories first,
+     * then by (case-insensitive) name.
+     */
+    static bool listOrder(const FilesystemNode& node1, const FilesystemNode& node2)
+    {
+      if(node1.isDirectory() != node2.isDirectory())
+        return node1.isDirectory();
+      else
+        return BSPF::compareIgnoreCase(node1.getName(), node2.getName()) < 0;
+    }
 
     /**
      * Set/get a string representation of the name of the file. This is can be
@@ -226,6 +252,29 @@ class FilesystemNode
      */
     bool isWritable() const;
 
+    /**
+     * Get the size and the time of the last modification of the file this
+     * node refers to, without reading it.  For nodes inside an archive, the
+     * information refers to the archive itself.
+     *
+     * @param size   The size of the file in bytes
+     * @param mtime  The modification time (seconds since the epoch)
+     *
+     * @return bool true if the information is available, false otherwise.
+     */
+    bool getFileInfo(uInt64& size, uInt64& mtime) const;
+
+    /**
+     * Get a stamp of the directory this node refers to, which changes
+     * whenever an entry is added to, removed from or renamed in the
+     * directory (its modification time, in the finest resolution available).
+     *
+     * @param stamp  The stamp of the directory
+     *
+     * @return bool true if the information is available, false otherwise.
+     */
+    bool getDirectoryStamp(uInt64& stamp) const;
+
     /**
      * Create a directory from the current node path.
      *
@@ -298,6 +347,9 @@ class FilesystemNode
     explicit FilesystemNode(const AbstractFSNodePtr& realNode);
     AbstractFSNodePtr _realNode;
     void setPath(const string& path);
+
+    // Number of nodes collected before they are passed to a BatchReceiver
+    static constexpr size_t BATCH_SIZE = 256;
 };
 
 
@@ -420,6 +472,21 @@ class AbstractFSNode
      */
     virtual bool isWritable() const = 0;
 
+    /**
+     * Get the size and the time of the last modification of the file, see
+     * FilesystemNode::getFileInfo().
+     *
+     * @return bool true if the information is available, false otherwise.
+     */
+    virtual bool getFileInfo(uInt64& size, uInt64& mtime) const { return false; }
+
+    /**
+     * Get the stamp of the directory, see FilesystemNode::getDirectoryStamp().
+     *
+     * @return bool true if the information is available, false otherwise.
+     */
+    virtual bool getDirectoryStamp(uInt64& stamp) const { return false; }
+
     /**
      * Create a directory from the current node path.
      *
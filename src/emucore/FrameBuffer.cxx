@@ -34,6 +34,10 @@
 #include "PaletteHandler.hxx"
 #include "StateManager.hxx"
 #include "RewindManager.hxx"
+#include "FrameProfiler.hxx"
+#include "EventCounters.hxx"
+#include "MemoryUsage.hxx"
+#include "TimerManager.hxx"
 
 #ifdef DEBUGGER_SUPPORT
   #include "Debugger.hxx"
@@ -60,7 +64,10 @@
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 FrameBuffer::FrameBuffer(OSystem& osystem)
-  : myOSystem{osystem}
+  : myOSystem{osystem},
+    myTurbo{osystem.settings().handle<bool>("turbo")},
+    mySpeed{osystem.settings().handle<float>("speed")},
+    myDevSettings{osystem.settings().handle<bool>("dev.settings")}
 {
 }
 
@@ -287,7 +294,10 @@ FBInitStatus FrameBuffer::createDisplay(const string& title, BufferType type,
   const GUI::Font& f = hidpiEnabled() ? infoFont() : font();
   myStatsMsg.color = kColorInfo;
   myStatsMsg.w = f.getMaxCharWidth() * 40 + 3;
-  myStatsMsg.h = (f.getFontHeight() + 2) * 3;
+  // Leave room for the frame profile and the event counts (header plus one
+  // line per stage or event)
+  myStatsMsg.h = (f.getFontHeight() + 2) *
+    (4 + 1 + FrameProfiler::NUM_STAGES + 1 + EventCounters::NUM_EVENTS);
 
   if(!myStatsMsg.surface)
   {
@@ -352,6 +362,11 @@ void FrameBuffer::update(UpdateMode mode)
     || myPendingRender;
   myPendingRender = false;
 
+  // Whatever is drawn (or exposed) now, the next emulation frame must be
+  // presented again
+  if(myTIASurface)
+    myTIASurface->invalidateFrame();
+
   switch(myOSystem.eventHandler().state())
   {
     case EventHandlerState::NONE:
@@ -543,32 +558,69 @@ void FrameBuffer::update(UpdateMode mode)
   // Push buffers to screen only when necessary
   if(redraw || rerender)
     myBackend->renderToScreen();
+
+  // Only uploads in emulation mode are reported in the frame stats
+  FBSurface::resetUploadedBytes();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void FrameBuffer::updateInEmulationMode(float framesPerSecond)
+bool FrameBuffer::updateInEmulationMode(float framesPerSecond)
 {
   // Update method that is specifically tailored to emulation mode
   //
   // We don't worry about selective rendering here; the rendering
-  // always happens at the full framerate
+  // always happens at the full framerate, unless the frame didn't change
+
+  myLastScanlines = myOSystem.console().tia().frameBufferScanlinesLastFrame();
+  myPausedCount = 0;
+
+  // Identical frames (e.g. title screens, or the game waiting for input)
+  // are neither rendered nor presented again, unless overlays change
+  const bool unchanged = myTIASurface->frameUnchanged();
+  if(unchanged && !myStatsMsg.enabled && !myMsg.enabled)
+  {
+    myLastPresentTime = 0.;
+    myLastUploadedBytes = 0;
+    FrameProfiler::instance().endFrame();
+    EventCounters::instance().endFrame();
+    return false;
+  }
 
   clear();  // TODO - test this: it may cause slowdowns on older systems
-  myTIASurface->render();
+
+  // With threading, the new frame is post-processed while the previous
+  // one is presented
+  myTIASurface->renderPipelined();
 
   // Show frame statistics
   if(myStatsMsg.enabled)
     drawFrameStats(framesPerSecond);
 
-  myLastScanlines = myOSystem.console().tia().frameBufferScanlinesLastFrame();
-  myPausedCount = 0;
-
   // Draw any pending messages
   if(myMsg.enabled)
     drawMessage();
 
   // Push buffers to screen
+  const auto presentStart = std::chrono::high_resolution_clock::now();
   myBackend->renderToScreen();
+  myLastPresentTime = std::chrono::duration<double>(
+    std::chrono::high_resolution_clock::now() - presentStart).count();
+
+  myTIASurface->finishPostProcessing();
+
+  // Remember the amount of pixel data uploaded for this frame
+  myLastUploadedBytes = FBSurface::uploadedBytes();
+  FBSurface::resetUploadedBytes();
+
+  FrameProfiler::instance().endFrame();
+  EventCounters::instance().endFrame();
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int FrameBuffer::refreshRate() const
+{
+  return myBackend ? myBackend->refreshRate() : 0;
 }
 
 #ifdef GUI_SUPPORT
@@ -684,10 +736,10 @@ void FrameBuffer::drawFrameStats(float framesPerSecond)
     << std::fixed << std::setprecision(1) << framesPerSecond
     << "fps @ "
     << std::fixed << std::setprecision(0) << 100 *
-      (myOSystem.settings().getBool("turbo")
-        ? 20.0F
-        : myOSystem.settings().getFloat("speed"))
-    << "% speed";
+      (myTurbo() ? 20.0F : mySpeed())
+    << "% speed, "
+    << std::fixed << std::setprecision(1) << myLastUploadedBytes / 1024.0
+    << "KB upload";
 
   myStatsMsg.surface->drawString(f, ss.str(), xPos, yPos,
       myStatsMsg.w, myStatsMsg.color, TextAlign::Left, 0, true, kBGColor);
@@ -696,14 +748,89 @@ void FrameBuffer::drawFrameStats(float framesPerSecond)
   ss.str("");
 
   ss << info.BankSwitch;
-  if (myOSystem.settings().getBool("dev.settings")) ss << "| Developer";
+  if (myDevSettings()) ss << "| Developer";
 
   myStatsMsg.surface->drawString(f, ss.str(), xPos, yPos,
       myStatsMsg.w, myStatsMsg.color, TextAlign::Left, 0, true, kBGColor);
 
+  yPos += dy;
+
+  // draw memory usage; collecting it waits for a pending rewind state, so
+  // it is only refreshed once per second
+  const uInt64 now = TimerManager::getTicks();
+  if(now - myStatsMemoryTime >= 1000000)
+  {
+    myStatsMemory = myOSystem.memoryUsage().total();
+    myStatsMemoryTime = now;
+  }
+  ss.str("");
+  ss << "Memory " << MemoryUsage::formatBytes(myStatsMemory);
+
+  myStatsMsg.surface->drawString(f, ss.str(), xPos, yPos,
+      myStatsMsg.w, myStatsMsg.color, TextAlign::Left, 0, true, kBGColor);
+
+  yPos += dy;
+
+  // draw frame profile
+  if(FrameProfiler::enabled())
+  {
+    const FrameProfiler& profiler = FrameProfiler::instance();
+
+    ss.str("");
+    ss << std::left << std::setw(11) << "ms" << std::right
+       << std::setw(7) << "p50" << std::setw(7) << "p99" << std::setw(7) << "max";
+    myStatsMsg.surface->drawString(f, ss.str(), xPos, yPos,
+        myStatsMsg.w, myStatsMsg.color, TextAlign::Left, 0, true, kBGColor);
+    yPos += dy;
+
+    for(uInt32 i = 0; i < FrameProfiler::NUM_STAGES; ++i)
+    {
+      const auto stage = static_cast<FrameProfiler::Stage>(i);
+      const FrameProfiler::Summary& s = profiler.summary(stage);
+
+      ss.str("");
+      ss << std::left << std::setw(11) << FrameProfiler::stageName(stage) << std::right
+         << std::fixed << std::setprecision(2)
+         << std::setw(7) << s.p50 << std::setw(7) << s.p99 << std::setw(7) << s.max;
+      myStatsMsg.surface->drawString(f, ss.str(), xPos, yPos,
+          myStatsMsg.w, myStatsMsg.color, TextAlign::Left, 0, true, kBGColor);
+      yPos += dy;
+    }
+  }
+
+  // draw event counts
+  if(EventCounters::enabled())
+  {
+    const EventCounters& counters = EventCounters::instance();
+    const EventCounters::Counts totals = counters.totals();
+
+    ss.str("");
+    ss << std::left << std::setw(12) << "events" << std::right
+       << std::setw(9) << "frame" << std::setw(10) << "avg";
+    myStatsMsg.surface->drawString(f, ss.str(), xPos, yPos,
+        myStatsMsg.w, myStatsMsg.color, TextAlign::Left, 0, true, kBGColor);
+    yPos += dy;
+
+    for(uInt32 i = 0; i < EventCounters::NUM_EVENTS; ++i)
+    {
+      const auto event = static_cast<EventCounters::Event>(i);
+
+      ss.str("");
+      ss << std::left << std::setw(12) << EventCounters::eventName(event) << std::right
+         << std::setw(9) << counters.lastFrame()[event]
+         << std::fixed << std::setprecision(1) << std::setw(10)
+         << (counters.frames() ? double(totals[event]) / counters.frames() : 0.);
+      myStatsMsg.surface->drawString(f, ss.str(), xPos, yPos,
+          myStatsMsg.w, myStatsMsg.color, TextAlign::Left, 0, true, kBGColor);
+      yPos += dy;
+    }
+  }
+
+  // Only show the lines actually drawn
+  myStatsMsg.surface->setSrcSize(myStatsMsg.w, yPos);
   myStatsMsg.surface->setDstPos(imageRect().x() + 10, imageRect().y() + 8);
   myStatsMsg.surface->setDstSize(myStatsMsg.w * hidpiScaleFactor(),
-                                 myStatsMsg.h * hidpiScaleFactor());
+                                 yPos * hidpiScaleFactor());
   myStatsMsg.surface->render();
 #endif
 }
@@ -885,6 +1012,23 @@ void FrameBuffer::setPauseDelay()
   myPausedCount = uInt32(2 * myOSystem.frameRate());
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameBuffer::addMemoryUsage(MemoryUsage& usage) const
+{
+  for(const auto& surface: mySurfaceList)
+    usage.add(MemoryUsage::Category::surfaces,
+              size_t(surface->width()) * surface->height() * sizeof(uInt32) * 2);
+
+#ifdef GUI_SUPPORT
+  for(const auto* f: {myFont.get(), myInfoFont.get(), mySmallFont.get(), myLauncherFont.get()})
+    if(f)
+      usage.add(MemoryUsage::Category::fonts, f->memoryUsage());
+#endif
+
+  if(myTIASurface)
+    usage.add(MemoryUsage::Category::tiaBuffers, myTIASurface->memoryUsage());
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 shared_ptr<FBSurface> FrameBuffer::allocateSurface(
     int w, int h, ScalingInterpolation inter, const uInt32* data)
@@ -25,6 +25,7 @@ class Console;
 class Settings;
 class FBSurface;
 class TIASurface;
+class MemoryUsage;
 
 #ifdef GUI_SUPPORT
   #include "Font.hxx"
@@ -32,6 +33,7 @@ class TIASurface;
 
 #include "Rect.hxx"
 #include "Variant.hxx"
+#include "Settings.hxx"
 #include "TIAConstants.hxx"
 #include "FBBackend.hxx"
 #include "FrameBufferConstants.hxx"
@@ -94,8 +96,22 @@ class FrameBuffer
 
     /**
       There is a dedicated update method for emulation mode.
+
+      @return  False if the frame was skipped, since it is identical to
+               the one presented last
+    */
+    bool updateInEmulationMode(float framesPerSecond);
+
+    /**
+      The time (in seconds) spent presenting the last frame in emulation
+      mode.  With vsync, this includes waiting for the vblank.
+    */
+    double lastPresentTime() const { return myLastPresentTime; }
+
+    /**
+      The refresh rate of the current display, or 0 if unknown.
     */
-    void updateInEmulationMode(float framesPerSecond);
+    int refreshRate() const;
 
     /**
       Set pending rendering flag.
@@ -227,6 +243,13 @@ class FrameBuffer
     */
     TIASurface& tiaSurface() const { return *myTIASurface; }
 
+    /**
+      Add the memory held by the surfaces, fonts and the RGB frame buffers
+      to the given usage.  Each surface is assumed to have a texture of the
+      same size.
+    */
+    void addMemoryUsage(MemoryUsage& usage) const;
+
     /**
       Toggles between fullscreen and window mode.
     */
@@ -540,6 +563,17 @@ class FrameBuffer
     Message myStatsMsg;
     bool myStatsEnabled{false};
     uInt32 myLastScanlines{0};
+    // Bytes uploaded by all surfaces during the last emulation frame
+    uInt64 myLastUploadedBytes{0};
+    // Memory usage shown in the stats, and when it was last collected
+    size_t myStatsMemory{0};
+    uInt64 myStatsMemoryTime{0};
+    // Time spent in presenting the last emulation frame
+    double myLastPresentTime{0.};
+    // Settings shown in the stats of every frame
+    Settings::Handle<bool> myTurbo;
+    Settings::Handle<float> mySpeed;
+    Settings::Handle<bool> myDevSettings;
 
     bool myGrabMouse{false};
     vector<bool> myHiDPIAllowed;
@@ -0,0 +1,346 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "FSNode.hxx"
+#include "Cart.hxx"
+#include "CartCreator.hxx"
+#include "MD5.hxx"
+#include "Joystick.hxx"
+#include "DispatchResult.hxx"
+#include "FrameLayoutDetector.hxx"
+#include "Serializer.hxx"
+#include "HeadlessConsole.hxx"
+
+namespace {
+  // Upper bound for the number of timeslices that make up a frame; the
+  // frame manager will always finish a frame well before that
+  constexpr uInt32 MAX_SLICES_PER_FRAME = 10;
+
+  // Number of frames used for frame layout detection (see ProfilingRunner)
+  constexpr uInt32 DETECTION_FRAMES = 60;
+
+  constexpr size_t FRAME_BUFFER_SIZE =
+    TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+HeadlessConsole::HeadlessConsole(const FilesystemNode& rom,
+                                 const Settings::Options& options)
+  : HeadlessConsole(loadRom(rom), options, true, FrameLayout::ntsc)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+HeadlessConsole::HeadlessConsole(const shared_ptr<const RomImage>& rom,
+                                 const Settings::Options& options,
+                                 bool detectLayout, FrameLayout layout)
+  : myOptions{options},
+    myRom{rom},
+    myCart{createCartridge(*rom, options, mySettings)},
+    myCPU{mySettings},
+    myRIOT{myIO, mySettings},
+    myTIA{myIO, [this]() { return myConsoleTiming; }, mySettings},
+    mySystem{myRandom, myCPU, myRIOT, myTIA, *myCart}
+{
+  myIO.myLeftControl = make_unique<Joystick>(Controller::Jack::Left, myEvent, mySystem);
+  myIO.myRightControl = make_unique<Joystick>(Controller::Jack::Right, myEvent, mySystem);
+  myIO.mySwitches = make_unique<Switches>(myEvent, myProperties, mySettings);
+
+  myTIA.bindToControllers();
+  myCart->setStartBankFromPropsFunc([]() { return -1; });
+
+  // There is no debugger which could consume access flags; clients that
+  // want them can switch tracking back on through system(). Switching it
+  // off before installing the devices avoids allocating the cart's ROM
+  // access arrays at all.
+  mySystem.setAccessTracking(false);
+  mySystem.initialize();
+
+  if(detectLayout)
+    autodetectFrameLayout();
+  else
+  {
+    myFrameLayout = layout;
+    myConsoleTiming = layout == FrameLayout::pal
+      ? ConsoleTiming::pal
+      : ConsoleTiming::ntsc;
+  }
+
+  myTIA.setFrameManager(&myFrameManager);
+  myTIA.setLayout(myFrameLayout);
+
+  mySystem.reset();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+HeadlessConsole::~HeadlessConsole()
+{
+  myTIA.clearFrameManager();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+shared_ptr<const HeadlessConsole::RomImage>
+HeadlessConsole::loadRom(const FilesystemNode& node)
+{
+  if(!node.isFile())
+    throw runtime_error(node.getPath() + " is not a ROM image");
+
+  auto rom = make_shared<RomImage>();
+
+  rom->node = node;
+  rom->size = node.read(rom->image);
+  if(rom->size == 0)
+    throw runtime_error("unable to read " + node.getPath());
+
+  rom->md5 = MD5::hash(rom->image, rom->size);
+
+  return rom;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+unique_ptr<Cartridge> HeadlessConsole::createCartridge(const RomImage& rom,
+                                                       const Settings::Options& options,
+                                                       Settings& settings)
+{
+  settings.setValue("fastscbios", true);
+  for(const auto& [key, value]: options)
+    settings.setValue(key, value);
+
+  string md5 = rom.md5;
+  string type = "";
+  unique_ptr<Cartridge> cartridge =
+      CartCreator::create(rom.node, rom.image, rom.size, md5, type, settings);
+
+  if(!cartridge)
+    throw runtime_error("unable to determine cartridge type");
+
+  return cartridge;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void HeadlessConsole::autodetectFrameLayout()
+{
+  FrameLayoutDetector frameLayoutDetector;
+  myTIA.setFrameManager(&frameLayoutDetector);
+  mySystem.reset();
+
+  // Stop early once the detection is confident about the layout
+  for(uInt32 i = 0; i < DETECTION_FRAMES && !frameLayoutDetector.layoutStable(); ++i)
+    myTIA.update();
+
+  myFrameLayout = frameLayoutDetector.detectedLayout();
+  myConsoleTiming = myFrameLayout == FrameLayout::pal
+    ? ConsoleTiming::pal
+    : ConsoleTiming::ntsc;
+
+  myTIA.clearFrameManager();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool HeadlessConsole::emulateFrame()
+{
+  DispatchResult dispatchResult;
+
+  // Poll the input once per frame, as the frontend does for a full Console
+  updateInput();
+
+  for(uInt32 i = 0; i < MAX_SLICES_PER_FRAME && !myTIA.newFramePending(); ++i)
+  {
+    myTIA.update(dispatchResult);
+
+    if(dispatchResult.getStatus() != DispatchResult::Status::ok)
+      return false;
+  }
+
+  myTIA.renderToFrameBuffer();
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool HeadlessConsole::emulateUntil(uInt64 cycles)
+{
+  DispatchResult dispatchResult;
+
+  // The CPU always completes the instruction which crosses the budget, so
+  // this ends on the same instruction boundary as the original run
+  while(mySystem.cycles() < cycles)
+  {
+    myTIA.update(dispatchResult, cycles - mySystem.cycles());
+
+    if(dispatchResult.getStatus() != DispatchResult::Status::ok)
+      return false;
+  }
+
+  myTIA.renderToFrameBuffer();
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void HeadlessConsole::reset()
+{
+  mySystem.reset();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+unique_ptr<HeadlessConsole> HeadlessConsole::fork()
+{
+  // The private c'tor cannot be reached through make_unique
+  unique_ptr<HeadlessConsole> child{
+    new HeadlessConsole(myRom, myOptions, false, myFrameLayout)};
+
+  if(!child->copyStateFrom(*this))
+    return nullptr;
+
+  child->myCheckpoint = myCheckpoint;
+
+  return child;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool HeadlessConsole::copyStateFrom(HeadlessConsole& source)
+{
+  if(source.myRom->md5 != myRom->md5)
+    return false;
+
+  // Determine the state size once, and size the buffer accordingly
+  if(myStateBuffer.empty())
+  {
+    Serializer probe;
+
+    if(!source.save(probe))
+      return false;
+
+    myStateBuffer.resize(probe.size());
+  }
+
+  Serializer out(myStateBuffer.data(), myStateBuffer.size());
+  if(!source.save(out))
+    return false;
+
+  Serializer in(static_cast<const uInt8*>(myStateBuffer.data()), out.size());
+  if(!load(in))
+    return false;
+
+  myFrameLayout = source.myFrameLayout;
+  myConsoleTiming = source.myConsoleTiming;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool HeadlessConsole::captureCheckpoint()
+{
+  auto checkpoint = make_shared<Checkpoint>();
+
+  Serializer probe;
+  if(!save(probe))
+    return false;
+
+  // Save again into a buffer of exactly the right size, which can then be
+  // read without going through a stream
+  checkpoint->state.resize(probe.size());
+  Serializer out(checkpoint->state.data(), checkpoint->state.size());
+  if(!save(out))
+    return false;
+  checkpoint->state.resize(out.size());
+
+  const uInt8* frameBuffer = myTIA.frameBuffer();
+  checkpoint->frameBuffer.assign(frameBuffer, frameBuffer + FRAME_BUFFER_SIZE);
+
+  myCheckpoint = std::move(checkpoint);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool HeadlessConsole::resetToCheckpoint()
+{
+  if(!myCheckpoint)
+    return false;
+
+  Serializer in(myCheckpoint->state.data(), myCheckpoint->state.size());
+  if(!load(in))
+    return false;
+
+  std::copy(myCheckpoint->frameBuffer.begin(), myCheckpoint->frameBuffer.end(),
+            myTIA.frameBuffer());
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+MemoryUsage HeadlessConsole::memoryUsage() const
+{
+  MemoryUsage usage;
+
+  // The cart holds its own copy of the image
+  usage.add(MemoryUsage::Category::romImage, myRom->size);
+  myCart->addMemoryUsage(usage);
+  myTIA.addMemoryUsage(usage);
+  myRIOT.addMemoryUsage(usage);
+
+  usage.add(MemoryUsage::Category::states, myStateBuffer.capacity());
+  if(myCheckpoint)
+    usage.add(MemoryUsage::Category::states,
+              myCheckpoint->state.capacity() + myCheckpoint->frameBuffer.capacity());
+
+  return usage;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool HeadlessConsole::save(Serializer& out) const
+{
+  try
+  {
+    if(!mySystem.save(out))
+      return false;
+
+    if(!(myIO.myLeftControl->save(out) && myIO.myRightControl->save(out) &&
+         myIO.mySwitches->save(out)))
+      return false;
+  }
+  catch(...)
+  {
+    cerr << "ERROR: HeadlessConsole::save" << endl;
+    return false;
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool HeadlessConsole::load(Serializer& in)
+{
+  try
+  {
+    if(!mySystem.load(in))
+      return false;
+
+    if(!(myIO.myLeftControl->load(in) && myIO.myRightControl->load(in) &&
+         myIO.mySwitches->load(in)))
+      return false;
+  }
+  catch(...)
+  {
+    cerr << "ERROR: HeadlessConsole::load" << endl;
+    return false;
+  }
+
+  return true;
+}
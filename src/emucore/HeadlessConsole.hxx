@@ -0,0 +1,275 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef HEADLESS_CONSOLE_HXX
+#define HEADLESS_CONSOLE_HXX
+
+class Cartridge;
+class Serializer;
+
+#include "bspf.hxx"
+#include "FSNode.hxx"
+#include "Control.hxx"
+#include "Switches.hxx"
+#include "Settings.hxx"
+#include "ConsoleIO.hxx"
+#include "ConsoleTiming.hxx"
+#include "Props.hxx"
+#include "Event.hxx"
+#include "Random.hxx"
+#include "M6502.hxx"
+#include "M6532.hxx"
+#include "TIA.hxx"
+#include "System.hxx"
+#include "FrameManager.hxx"
+#include "FrameLayout.hxx"
+#include "MemoryUsage.hxx"
+
+/**
+  A minimal emulated machine (cartridge, CPU, RIOT and TIA) without any of
+  the frontend infrastructure (OSystem, FrameBuffer, sound, event handling)
+  that a full Console depends on. Both controllers are joysticks, and input
+  is provided by writing to the event object directly.
+
+  The frame buffer holds TIA palette indices; no TV effects or palette
+  conversion are applied.
+
+  Costly emulation events are counted as for a regular console, once
+  EventCounters is enabled; subtracting two snapshots of its totals gives
+  the events of the frames emulated in between.
+*/
+class HeadlessConsole
+{
+  public:
+    /**
+      Create a new console for the given ROM image. Throws a runtime_error
+      if the image cannot be read or its bankswitching type cannot be
+      determined.
+
+      @param rom      The ROM image to load
+      @param options  Settings that differ from the defaults; they are
+                      applied before the cartridge is created
+    */
+    explicit HeadlessConsole(const FilesystemNode& rom,
+                             const Settings::Options& options = {});
+    ~HeadlessConsole();
+
+    /**
+      Create a new console that runs the same ROM and is in exactly the
+      same state as this one. The ROM image is shared, and neither ROM
+      loading nor frame layout detection is repeated.
+
+      @return  The forked console, or nullptr if the state could not be
+               transferred
+    */
+    unique_ptr<HeadlessConsole> fork();
+
+    /**
+      Put this console into the state of the given console, which must run
+      the same ROM. This is cheaper than fork(), as no objects are created;
+      a pool of consoles can thus be branched from a single state over and
+      over again.
+    */
+    bool copyStateFrom(HeadlessConsole& source);
+
+    /**
+      Saves / restores the current state of the machine (system, controllers
+      and switches), in the same way Console does.
+    */
+    bool save(Serializer& out) const;
+    bool load(Serializer& in);
+
+    /**
+      Capture the current state (including the last completed frame) as
+      the checkpoint for resetToCheckpoint(), typically right after boot or
+      at the start of a game.  The checkpoint is shared with all consoles
+      forked afterwards.
+
+      @return  False if the state could not be saved
+    */
+    bool captureCheckpoint();
+
+    /**
+      Put the machine back into the checkpoint state.  This is much cheaper
+      than reset() followed by running the boot frames again: nothing is
+      reinitialized, detected or allocated; the state is read into the
+      existing objects straight from the checkpoint buffer.
+
+      @return  False if no checkpoint was captured, or it failed to load
+    */
+    bool resetToCheckpoint();
+
+    bool hasCheckpoint() const { return myCheckpoint != nullptr; }
+
+    /**
+      The memory held by this console.  The ROM image and the checkpoint
+      are shared with forks, and reported by each of them.
+    */
+    MemoryUsage memoryUsage() const;
+
+  public:
+    /**
+      Emulate until the TIA has completed a frame, and make that frame
+      available in the frame buffer. The controllers and switches pick up
+      the current state of the event object before the frame starts.
+
+      @return  False if emulation has failed (e.g. on a CPU fatal error)
+    */
+    bool emulateFrame();
+
+    /**
+      Emulate until the CPU cycle count has reached the given value, and
+      make the last completed frame available in the frame buffer. Unlike
+      emulateFrame(), the input is not polled.
+
+      @return  False if emulation has failed (e.g. on a CPU fatal error)
+    */
+    bool emulateUntil(uInt64 cycles);
+
+    /**
+      Update the controllers and switches from the event object, in the
+      same way as a frontend polling the input.
+    */
+    void updateInput() { myRIOT.update(); }
+
+    /**
+      Reset the machine to its power-on state.
+    */
+    void reset();
+
+    /**
+      The last completed frame (TIA palette indices, H_PIXEL pixels per line,
+      frameBufferHeight lines).
+    */
+    const uInt8* frameBuffer() { return myTIA.frameBuffer(); }
+
+    /**
+      The 128 bytes of RIOT RAM.
+    */
+    const uInt8* ram() const { return myRIOT.getRAM(); }
+
+    /**
+      The event object that feeds the controllers and console switches.
+    */
+    Event& event() { return myEvent; }
+
+    /**
+      The MD5 of the ROM image.
+    */
+    const string& md5() const { return myRom->md5; }
+
+    /**
+      The properties of the ROM (e.g. for HighScoresManager::get()).
+    */
+    const Properties& properties() const { return myProperties; }
+
+    const Controller& leftController() const { return *myIO.myLeftControl; }
+    const Controller& rightController() const { return *myIO.myRightControl; }
+
+    FrameLayout frameLayout() const { return myFrameLayout; }
+    ConsoleTiming timing() const { return myConsoleTiming; }
+
+    uInt64 cycles() const { return mySystem.cycles(); }
+
+    TIA& tia() { return myTIA; }
+    M6502& cpu() { return myCPU; }
+    M6532& riot() { return myRIOT; }
+    System& system() { return mySystem; }
+    Cartridge& cartridge() { return *myCart; }
+
+  private:
+    // The ROM image, shared between a console and all of its forks
+    struct RomImage {
+      FilesystemNode node;
+      ByteBuffer image;
+      size_t size{0};
+      string md5;
+    };
+
+    // A captured state, shared between a console and all of its forks
+    struct Checkpoint {
+      vector<uInt8> state;
+      vector<uInt8> frameBuffer;
+    };
+
+    struct IO: public ConsoleIO {
+      Controller& leftController() const override { return *myLeftControl; }
+      Controller& rightController() const override { return *myRightControl; }
+      Switches& switches() const override { return *mySwitches; }
+
+      unique_ptr<Controller> myLeftControl;
+      unique_ptr<Controller> myRightControl;
+      unique_ptr<Switches> mySwitches;
+    };
+
+  private:
+    HeadlessConsole(const shared_ptr<const RomImage>& rom,
+                    const Settings::Options& options,
+                    bool detectLayout, FrameLayout layout);
+
+    static shared_ptr<const RomImage> loadRom(const FilesystemNode& rom);
+
+    /**
+      Detect the frame layout by running a number of frames through
+      a FrameLayoutDetector.
+    */
+    void autodetectFrameLayout();
+
+    static unique_ptr<Cartridge> createCartridge(const RomImage& rom,
+                                                 const Settings::Options& options,
+                                                 Settings& settings);
+
+  private:
+    // Every console owns its settings; this allows several instances to
+    // coexist on different threads without sharing mutable state
+    Settings mySettings;
+    Properties myProperties;
+
+    // The non-default settings, which are passed on to all forks
+    Settings::Options myOptions;
+
+    shared_ptr<const RomImage> myRom;
+    unique_ptr<Cartridge> myCart;
+
+    IO myIO;
+    Random myRandom{0};
+    Event myEvent;
+
+    M6502 myCPU;
+    M6532 myRIOT;
+    TIA myTIA;
+    System mySystem;
+
+    FrameManager myFrameManager;
+    FrameLayout myFrameLayout{FrameLayout::ntsc};
+    ConsoleTiming myConsoleTiming{ConsoleTiming::ntsc};
+
+    // Scratch buffer for transferring state; allocated on first use
+    vector<uInt8> myStateBuffer;
+
+    shared_ptr<const Checkpoint> myCheckpoint;
+
+  private:
+    // Following constructors and assignment operators not supported
+    HeadlessConsole() = delete;
+    HeadlessConsole(const HeadlessConsole&) = delete;
+    HeadlessConsole(HeadlessConsole&&) = delete;
+    HeadlessConsole& operator=(const HeadlessConsole&) = delete;
+    HeadlessConsole& operator=(HeadlessConsole&&) = delete;
+};
+
+#endif
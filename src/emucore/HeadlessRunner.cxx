@@ -0,0 +1,201 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <algorithm>
+
+#include "HeadlessRunner.hxx"
+#include "HeadlessConsole.hxx"
+#include "InputMovie.hxx"
+#include "SharedStateExport.hxx"
+#include "Control.hxx"
+#include "FSNode.hxx"
+#include "TIA.hxx"
+#include "TIAConstants.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+HeadlessRunner::HeadlessRunner(int argc, char* argv[])
+{
+  for(int i = 2; i < argc; ++i)
+  {
+    const string arg = argv[i];
+
+    if(arg[0] != '-')
+    {
+      myRomFile = arg;
+      continue;
+    }
+    if(i + 1 >= argc)
+      throw runtime_error("missing argument for '" + arg + "'");
+
+    if(arg == "-frames")
+    {
+      const int frames = BSPF::stringToInt(argv[++i]);
+      if(frames <= 0)
+        throw runtime_error("invalid number of frames");
+
+      myFrames = frames;
+    }
+    else if(arg == "-input")
+      myScriptFile = argv[++i];
+    else if(arg == "-movie")
+      myMovieFile = argv[++i];
+    else if(arg == "-dumpram")
+      myRAMFile = argv[++i];
+    else if(arg == "-dumpframe")
+      myFrameFile = argv[++i];
+    else if(arg == "-sharedmem")
+      mySharedMemory = argv[++i];
+    else
+      throw runtime_error("unknown option '" + arg + "'");
+  }
+
+  if(myRomFile.empty())
+    throw runtime_error("no ROM given");
+  if(!myScriptFile.empty() && !myMovieFile.empty())
+    throw runtime_error("'-input' and '-movie' can't be combined");
+  if(!mySharedMemory.empty() && !(myScriptFile.empty() && myMovieFile.empty()))
+    throw runtime_error("'-sharedmem' can't be combined with '-input' or '-movie'");
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool HeadlessRunner::run()
+{
+  if(!myScriptFile.empty())
+    myScript.load(myScriptFile);
+
+  HeadlessConsole console{FilesystemNode(myRomFile)};
+  string result;
+
+  const bool ok = myMovieFile.empty()
+    ? runScript(console, result) : runMovie(console, result);
+
+  cout << myRomFile << ": "
+       << (console.frameLayout() == FrameLayout::pal ? "PAL" : "NTSC") << ", "
+       << result << ", " << console.cycles() << " cycles" << endl;
+
+  if(!myRAMFile.empty())
+    dumpRAM(console);
+  if(!myFrameFile.empty())
+    dumpFrame(console);
+
+  if(!ok)
+    cerr << "emulation failed after " << result << endl;
+
+  return ok;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool HeadlessRunner::runScript(HeadlessConsole& console, string& result)
+{
+  Event& event = console.event();
+  uInt32 frame = 0;
+
+  unique_ptr<SharedStateExport> sharedState;
+  if(!mySharedMemory.empty())
+    sharedState = make_unique<SharedStateExport>(mySharedMemory, console);
+
+  for(; frame < myFrames; ++frame)
+  {
+    if(sharedState)
+      sharedState->applyInput(event);
+    else
+      myScript.apply(frame, event);
+
+    if(!console.emulateFrame())
+      break;
+
+    if(sharedState)
+      sharedState->publish();
+  }
+
+  result = std::to_string(frame) + " frames";
+
+  return frame == myFrames;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool HeadlessRunner::runMovie(HeadlessConsole& console, string& result) const
+{
+  InputMovie movie;
+  InputMovie::Info info;
+
+  // Any error is reported here, since the movie only sees the result
+  const auto loadState = [&console, &info](Serializer& in) {
+    if(info.md5 != console.md5())
+      cerr << "movie was recorded with a different ROM" << endl;
+    else if(info.leftController != console.leftController().name() ||
+            info.rightController != console.rightController().name())
+      cerr << "movie was recorded with different controllers ("
+           << info.leftController << ", " << info.rightController << ")" << endl;
+    else
+      return console.load(in);
+
+    return false;
+  };
+
+  if(!movie.play(myMovieFile, info, loadState))
+    throw runtime_error("cannot play back movie '" + myMovieFile + "'");
+
+  Event& event = console.event();
+  uInt64 target = console.cycles();
+  uInt32 cycles = 0, polls = 0;
+  bool ok = true;
+
+  while(movie.nextPoll(cycles))
+  {
+    target += cycles;
+    if(!(ok = console.emulateUntil(target)))
+      break;
+
+    movie.applyPoll(event);
+    console.updateInput();
+    ++polls;
+  }
+
+  result = std::to_string(polls) + " polls";
+
+  return ok;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void HeadlessRunner::dumpRAM(const HeadlessConsole& console) const
+{
+  constexpr size_t RAM_SIZE = 128;
+
+  ByteBuffer buffer = make_unique<uInt8[]>(RAM_SIZE);
+  std::copy_n(console.ram(), RAM_SIZE, buffer.get());
+
+  FilesystemNode(myRAMFile).write(buffer, RAM_SIZE);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void HeadlessRunner::dumpFrame(HeadlessConsole& console) const
+{
+  const uInt32 width = TIAConstants::frameBufferWidth;
+  const uInt32 height = std::min(console.tia().height(),
+                                 TIAConstants::frameBufferHeight);
+
+  const string header = "P5\n" + std::to_string(width) + " " +
+      std::to_string(height) + "\n255\n";
+  const size_t size = header.size() + width * height;
+
+  ByteBuffer buffer = make_unique<uInt8[]>(size);
+  std::copy(header.cbegin(), header.cend(), buffer.get());
+  std::copy_n(console.frameBuffer(), width * height, buffer.get() + header.size());
+
+  FilesystemNode(myFrameFile).write(buffer, size);
+}
@@ -0,0 +1,75 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef HEADLESS_RUNNER_HXX
+#define HEADLESS_RUNNER_HXX
+
+#include "bspf.hxx"
+#include "InputScript.hxx"
+
+class HeadlessConsole;
+
+/**
+  Runs a ROM for a fixed number of frames on a HeadlessConsole, i.e.
+  without OSystem, framebuffer, sound or event handling infrastructure,
+  and dumps the final state.
+
+  Usage: stella -headless [-frames <n>]
+                          [-input <script> | -movie <file> | -sharedmem <name>]
+                          [-dumpram <file>] [-dumpframe <file>] rom
+
+  The input script is described in InputScript.
+
+  '-movie' plays back an input movie recorded by the StateManager instead,
+  starting from the recorded state and feeding the input at exactly the
+  recorded cycles; '-frames' is ignored then.
+
+  '-sharedmem' publishes every frame, the RAM and the cart RAM in a shared
+  memory region of the given name, and takes the input from it instead
+  (see SharedStateExport).
+
+  '-dumpram' writes the 128 bytes of RIOT RAM, '-dumpframe' writes the last
+  frame as a binary PGM image holding TIA palette indices.
+*/
+class HeadlessRunner
+{
+  public:
+    HeadlessRunner(int argc, char* argv[]);
+
+    bool run();
+
+  private:
+    bool runScript(HeadlessConsole& console, string& result);
+    bool runMovie(HeadlessConsole& console, string& result) const;
+
+    void dumpRAM(const HeadlessConsole& console) const;
+    void dumpFrame(HeadlessConsole& console) const;
+
+  private:
+    string myRomFile;
+    string myScriptFile;
+    string myMovieFile;
+    string myRAMFile;
+    string myFrameFile;
+    string mySharedMemory;
+
+    uInt32 myFrames{60};
+
+    InputScript myScript;
+};
+
+#endif
@@ -0,0 +1,57 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "EventCounters.hxx"
+#include "ImageCache.hxx"
+
+std::mutex ImageCache::ourMutex;
+std::map<string, std::weak_ptr<uInt8[]>> ImageCache::ourImages;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ImageCache::Image ImageCache::acquire(const string& key, size_t size,
+                                      const std::function<void(uInt8*)>& init)
+{
+  const string fullKey = key + ":" + std::to_string(size);
+  std::lock_guard<std::mutex> lock(ourMutex);
+
+  // Drop the entries of images which are no longer in use
+  for(auto it = ourImages.begin(); it != ourImages.end(); )
+    if(it->second.expired())
+      it = ourImages.erase(it);
+    else
+      ++it;
+
+  const auto it = ourImages.find(fullKey);
+  if(it != ourImages.end())
+    return it->second.lock();
+
+  EventCounters::count(EventCounters::Event::cacheMiss);
+  Image image(new uInt8[size]);
+  init(image.get());
+  ourImages[fullKey] = image;
+
+  return image;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ImageCache::Image ImageCache::copy(const Image& image, size_t size)
+{
+  Image result(new uInt8[size]);
+  std::copy_n(image.get(), size, result.get());
+
+  return result;
+}
@@ -0,0 +1,76 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef IMAGE_CACHE_HXX
+#define IMAGE_CACHE_HXX
+
+#include <functional>
+#include <map>
+#include <mutex>
+
+#include "bspf.hxx"
+
+/**
+  A process-wide cache of read-only ROM images.  Carts which keep large
+  images around (e.g. the ARM based schemes) acquire them from here, so
+  that every cart created from the same ROM shares one copy of the data.
+
+  The cache only holds weak references; an image is released as soon as
+  the last cart using it is destroyed.  Shared images must never be
+  modified; a cart has to create a private copy first (see 'copy').
+*/
+class ImageCache
+{
+  public:
+    using Image = shared_ptr<uInt8[]>;
+
+    /**
+      Get the image registered under the given key.  If no such image
+      exists, a new one of the given size is created, filled by 'init'
+      and registered.
+
+      @param key   Identifies the image (MD5 plus any layout specifics)
+      @param size  The size of the image in bytes
+      @param init  Fills a newly created image
+      @return  The shared image
+    */
+    static Image acquire(const string& key, size_t size,
+                         const std::function<void(uInt8*)>& init);
+
+    /**
+      Create a private (unregistered) copy of an image.
+
+      @param image  The image to copy
+      @param size   The size of the image in bytes
+      @return  The new image
+    */
+    static Image copy(const Image& image, size_t size);
+
+  private:
+    static std::mutex ourMutex;
+    static std::map<string, std::weak_ptr<uInt8[]>> ourImages;
+
+  private:
+    // Following constructors and assignment operators not supported
+    ImageCache() = delete;
+    ImageCache(const ImageCache&) = delete;
+    ImageCache(ImageCache&&) = delete;
+    ImageCache& operator=(const ImageCache&) = delete;
+    ImageCache& operator=(ImageCache&&) = delete;
+};
+
+#endif
@@ -0,0 +1,210 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "InputMovie.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+InputMovie::~InputMovie()
+{
+  close();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool InputMovie::record(const string& filename, const Info& info,
+                        const StateFunc& saveState, uInt64 cycles)
+{
+  close();
+
+  myStream = make_unique<Serializer>(filename, Serializer::Mode::ReadWriteTrunc);
+  if(!*myStream)
+  {
+    myStream.reset();
+    return false;
+  }
+
+  try
+  {
+    myStream->putString(MOVIE_HEADER);
+    myStream->putString(info.md5);
+    myStream->putString(info.leftController);
+    myStream->putString(info.rightController);
+
+    if(!saveState(*myStream))
+    {
+      myStream.reset();
+      return false;
+    }
+  }
+  catch(...)
+  {
+    myStream.reset();
+    return false;
+  }
+
+  // The first poll records all events which are active at the start
+  myValues.fill(0);
+  myCycles = cycles;
+  myRecording = true;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void InputMovie::addPoll(uInt64 cycles, const Event& event)
+{
+  if(!isRecording())
+    return;
+
+  myChanges.clear();
+  for(int type = Event::NoType + 1; type < Event::LastType; ++type)
+  {
+    const Int32 value = event.get(Event::Type(type));
+
+    if(value != myValues[type])
+    {
+      myChanges.emplace_back(Event::Type(type), value);
+      myValues[type] = value;
+    }
+  }
+
+  try
+  {
+    myStream->putInt(uInt32(cycles - myCycles));
+    myStream->putShort(uInt16(myChanges.size()));
+    for(const auto& [type, value]: myChanges)
+    {
+      myStream->putShort(type);
+      myStream->putInt(value);
+    }
+  }
+  catch(...)
+  {
+    cerr << "ERROR: InputMovie::addPoll" << endl;
+    myStream.reset();
+  }
+
+  myCycles = cycles;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void InputMovie::close()
+{
+  if(isRecording())
+  {
+    try
+    {
+      myStream->putInt(0);
+      myStream->putShort(END_OF_MOVIE);
+    }
+    catch(...)
+    {
+      cerr << "ERROR: InputMovie::close" << endl;
+    }
+  }
+
+  myStream.reset();
+  myRecording = false;
+  myChanges.clear();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool InputMovie::play(const string& filename, Info& info,
+                      const StateFunc& loadState)
+{
+  close();
+
+  myStream = make_unique<Serializer>(filename, Serializer::Mode::ReadOnly);
+  if(!*myStream)
+  {
+    myStream.reset();
+    return false;
+  }
+
+  try
+  {
+    if(myStream->getString() != MOVIE_HEADER)
+    {
+      myStream.reset();
+      return false;
+    }
+
+    info.md5 = myStream->getString();
+    info.leftController = myStream->getString();
+    info.rightController = myStream->getString();
+
+    if(!loadState(*myStream))
+    {
+      myStream.reset();
+      return false;
+    }
+  }
+  catch(...)
+  {
+    myStream.reset();
+    return false;
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool InputMovie::nextPoll(uInt32& cycles)
+{
+  myChanges.clear();
+  if(!myStream || myRecording)
+    return false;
+
+  try
+  {
+    cycles = myStream->getInt();
+
+    const uInt16 count = myStream->getShort();
+    if(count == END_OF_MOVIE)
+    {
+      myStream.reset();
+      return false;
+    }
+
+    for(uInt16 i = 0; i < count; ++i)
+    {
+      const uInt16 type = myStream->getShort();
+      const Int32 value = myStream->getInt();
+
+      if(type == Event::NoType || type >= Event::LastType)
+        throw runtime_error("invalid event");
+
+      myChanges.emplace_back(Event::Type(type), value);
+    }
+  }
+  catch(...)
+  {
+    // A movie which has not been closed properly ends with the last
+    // complete poll
+    myChanges.clear();
+    myStream.reset();
+    return false;
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void InputMovie::applyPoll(Event& event) const
+{
+  for(const auto& [type, value]: myChanges)
+    event.set(type, value);
+}
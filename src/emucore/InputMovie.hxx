@@ -0,0 +1,136 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef INPUT_MOVIE_HXX
+#define INPUT_MOVIE_HXX
+
+#define MOVIE_HEADER "06060000movie"
+
+#include <functional>
+
+#include "bspf.hxx"
+#include "Event.hxx"
+#include "Serializer.hxx"
+
+/**
+  An input movie: the machine state at the start of the recording, followed
+  by the input picked up at every poll of the frontend. Each poll stores the
+  number of CPU cycles since the previous one and the event values which
+  have changed since then.
+
+  Since the input is fed back at exactly the recorded cycles, playback is
+  deterministic and independent of the pacing of the recording frontend;
+  it can run on a HeadlessConsole as fast as the host allows.
+
+  @author  Stella Team
+*/
+class InputMovie
+{
+  public:
+    // Information about the recorded ROM and setup
+    struct Info {
+      string md5;
+      string leftController;
+      string rightController;
+    };
+
+    using StateFunc = std::function<bool(Serializer&)>;
+
+    InputMovie() = default;
+    ~InputMovie();
+
+  public:
+    /**
+      Start recording into the given file, which is overwritten.
+
+      @param filename   The movie file
+      @param info       The recorded ROM and controllers
+      @param saveState  Writes the current machine state
+      @param cycles     The current CPU cycle count of the machine
+
+      @return  False if the file could not be written
+    */
+    bool record(const string& filename, const Info& info,
+                const StateFunc& saveState, uInt64 cycles);
+
+    /**
+      Record the input as it has been picked up by the controllers at the
+      given cycle count; to be called after each poll.
+    */
+    void addPoll(uInt64 cycles, const Event& event);
+
+    /**
+      Finish recording or playback, and close the file.
+    */
+    void close();
+
+    bool isRecording() const { return myStream && myRecording; }
+
+    /**
+      Start playing back the given file.
+
+      @param filename   The movie file
+      @param info       Receives the recorded ROM and controllers
+      @param loadState  Puts the machine into the recorded initial state,
+                        after checking 'info'
+
+      @return  False if the file is invalid or the state could not be loaded
+    */
+    bool play(const string& filename, Info& info, const StateFunc& loadState);
+
+    /**
+      Read the next poll of the movie being played back.
+
+      @param cycles  Receives the CPU cycles since the previous poll (or the
+                     start of the movie)
+
+      @return  False at the end of the movie
+    */
+    bool nextPoll(uInt32& cycles);
+
+    /**
+      Apply the event values recorded for the current poll; these must be
+      applied after emulating up to the poll and before updating the
+      controllers.
+    */
+    void applyPoll(Event& event) const;
+
+  private:
+    // Marks the end of the recording
+    static constexpr uInt16 END_OF_MOVIE = 0xffff;
+
+    unique_ptr<Serializer> myStream;
+    bool myRecording{false};
+
+    // The event values at the previous poll (recording)
+    std::array<Int32, Event::LastType> myValues;
+
+    // Cycle count at the previous poll (recording)
+    uInt64 myCycles{0};
+
+    // The event changes of the current poll (playback)
+    vector<std::pair<Event::Type, Int32>> myChanges;
+
+  private:
+    // Following constructors and assignment operators not supported
+    InputMovie(const InputMovie&) = delete;
+    InputMovie(InputMovie&&) = delete;
+    InputMovie& operator=(const InputMovie&) = delete;
+    InputMovie& operator=(InputMovie&&) = delete;
+};
+
+#endif
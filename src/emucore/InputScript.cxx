@@ -0,0 +1,103 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <algorithm>
+
+#include "InputScript.hxx"
+#include "FSNode.hxx"
+
+namespace {
+  // The events which can be scripted, by name
+  constexpr std::array<std::pair<const char*, Event::Type>, 18> SCRIPT_EVENTS = {{
+    { "ConsoleColor",        Event::ConsoleColor        },
+    { "ConsoleBlackWhite",   Event::ConsoleBlackWhite   },
+    { "ConsoleLeftDiffA",    Event::ConsoleLeftDiffA    },
+    { "ConsoleLeftDiffB",    Event::ConsoleLeftDiffB    },
+    { "ConsoleRightDiffA",   Event::ConsoleRightDiffA   },
+    { "ConsoleRightDiffB",   Event::ConsoleRightDiffB   },
+    { "ConsoleSelect",       Event::ConsoleSelect       },
+    { "ConsoleReset",        Event::ConsoleReset        },
+    { "LeftJoystickUp",      Event::LeftJoystickUp      },
+    { "LeftJoystickDown",    Event::LeftJoystickDown    },
+    { "LeftJoystickLeft",    Event::LeftJoystickLeft    },
+    { "LeftJoystickRight",   Event::LeftJoystickRight   },
+    { "LeftJoystickFire",    Event::LeftJoystickFire    },
+    { "RightJoystickUp",     Event::RightJoystickUp     },
+    { "RightJoystickDown",   Event::RightJoystickDown   },
+    { "RightJoystickLeft",   Event::RightJoystickLeft   },
+    { "RightJoystickRight",  Event::RightJoystickRight  },
+    { "RightJoystickFire",   Event::RightJoystickFire   }
+  }};
+
+  Event::Type eventType(const string& name)
+  {
+    for(const auto& [eventName, type]: SCRIPT_EVENTS)
+      if(BSPF::equalsIgnoreCase(name, eventName))
+        return type;
+
+    return Event::NoType;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void InputScript::load(const string& filename)
+{
+  stringstream in;
+  if(FilesystemNode(filename).read(in) == 0)
+    throw runtime_error("cannot read input script '" + filename + "'");
+
+  myEvents.clear();
+  myNext = 0;
+
+  string line;
+  uInt32 lineNumber = 0;
+
+  while(std::getline(in, line))
+  {
+    ++lineNumber;
+
+    istringstream fields(line);
+    string frame, name;
+
+    if(!(fields >> frame) || frame[0] == '#')
+      continue;
+
+    ScriptEvent scriptEvent;
+    const int frameNumber = BSPF::stringToInt(frame, -1);
+
+    if(frameNumber < 0 || !(fields >> name) ||
+       (scriptEvent.type = eventType(name)) == Event::NoType)
+      throw runtime_error("invalid input script line " + std::to_string(lineNumber));
+
+    scriptEvent.frame = frameNumber;
+    if(!(fields >> scriptEvent.value))
+      scriptEvent.value = 1;
+
+    myEvents.push_back(scriptEvent);
+  }
+
+  // Keep the order of events within a frame
+  std::stable_sort(myEvents.begin(), myEvents.end(),
+    [](const ScriptEvent& a, const ScriptEvent& b) { return a.frame < b.frame; });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void InputScript::apply(uInt32 frame, Event& event)
+{
+  for(; myNext < myEvents.size() && myEvents[myNext].frame <= frame; ++myNext)
+    event.set(myEvents[myNext].type, myEvents[myNext].value);
+}
@@ -0,0 +1,75 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef INPUT_SCRIPT_HXX
+#define INPUT_SCRIPT_HXX
+
+#include "bspf.hxx"
+#include "Event.hxx"
+
+/**
+  A frame-based input script for headless runs. The script holds one
+  event per line in the form '<frame> <event> [<value>]', e.g.
+  '120 LeftJoystickFire 1'. The event is applied before the given frame is
+  emulated, and keeps its value until it is changed again by another line;
+  the value defaults to 1. Supported events are the console switches and
+  both joysticks, named as in Event::Type. Empty lines and lines starting
+  with '#' are ignored.
+
+  @author  Stella Team
+*/
+class InputScript
+{
+  public:
+    InputScript() = default;
+
+    /**
+      Load the script from the given file. Throws a runtime_error if the
+      file cannot be read or contains an invalid line.
+    */
+    void load(const string& filename);
+
+    /**
+      Apply all events of the script up to and including the given frame
+      which have not been applied yet.
+    */
+    void apply(uInt32 frame, Event& event);
+
+    /**
+      Start over at the beginning of the script; e.g. to replay it to
+      a fresh event object.
+    */
+    void rewind() { myNext = 0; }
+
+    bool empty() const { return myEvents.empty(); }
+
+  private:
+    struct ScriptEvent {
+      uInt32 frame{0};
+      Event::Type type{Event::NoType};
+      Int32 value{1};
+    };
+
+  private:
+    // The events, ordered by frame
+    vector<ScriptEvent> myEvents;
+
+    // The next event to be applied
+    size_t myNext{0};
+};
+
+#endif
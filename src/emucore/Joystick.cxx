@@ -173,4 +173,4 @@ int Joystick::deadZoneValue(int deadzone)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-int Joystick::_DEAD_ZONE = 3200;
+std::atomic<int> Joystick::_DEAD_ZONE{3200};
@@ -123,7 +123,7 @@ class Joystick : public Controller
     // Controller to emulate in normal mouse axis mode
     int myControlID{-1};
 
-    static int _DEAD_ZONE;
+    static std::atomic<int> _DEAD_ZONE;
 
   private:
     /**
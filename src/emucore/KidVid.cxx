@@ -22,9 +22,10 @@
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 KidVid::KidVid(Jack jack, const Event& event, const System& system,
-               const string& romMd5)
+               const string& romMd5, const FilesystemNode& sampleDir)
   : Controller(jack, event, system, Controller::Type::KidVid),
-    myEnabled{myJack == Jack::Right}
+    myEnabled{myJack == Jack::Right},
+    mySampleDir{sampleDir}
 {
   // Right now, there are only two games that use the KidVid
   if(romMd5 == "ee6665683ebdb539e89ba620981cb0f6")
@@ -148,11 +149,10 @@ void KidVid::update()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void KidVid::openSampleFile()
 {
-#if 0
-  static const char* const kvNameTable[6] = {
+  static constexpr std::array<const char*, 6> kvNameTable = {
     "kvs3.wav", "kvs1.wav", "kvs2.wav", "kvb3.wav", "kvb1.wav", "kvb2.wav"
   };
-  static uInt32 StartSong[6] = {
+  static constexpr std::array<uInt32, 6> StartSong = {
     44+38, 0, 44, 44+38+42+62+80, 44+38+42, 44+38+42+62
   };
 
@@ -165,44 +165,39 @@ void KidVid::openSampleFile()
     i += myTape - 1;
     if(myTape == 4) i -= 3;
 
-    mySampleFile = fopen(kvNameTable[i], "rb");
-    if(mySampleFile != nullptr)
+    // The whole files are read at once, so that no file access is
+    // necessary while the tape is playing
+    const auto readFile = [this](const char* name, ByteBuffer& data) {
+      FilesystemNode file = mySampleDir;
+      file /= name;
+      try { return file.read(data); }
+      catch(...) { return size_t(0); }
+    };
+    mySampleSize = readFile(kvNameTable[i], mySampleData);
+    mySharedSampleSize = readFile("kvshared.wav", mySharedSampleData);
+    myFileOpened = mySampleSize > 0 && mySharedSampleSize > 0;
+    if(!myFileOpened)
     {
-cerr << "opened file: " << kvNameTable[i] << endl;
-      mySharedSampleFile = fopen("kvshared.wav", "rb");
-      if(mySharedSampleFile == nullptr)
-      {
-        fclose(mySampleFile);
-        myFileOpened = false;
-      }
-      else
-      {
-cerr << "opened file: " << "kvshared.wav" << endl;
-//         fseek(mySampleFile, 45, SEEK_SET);
-        myFileOpened = true;
-      }
+      mySampleData.reset();
+      mySharedSampleData.reset();
     }
-    else
-      myFileOpened = false;
 
     mySongCounter = 0;
     myTapeBusy = false;
     myFilePointer = StartSong[i];
   }
-#endif
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void KidVid::closeSampleFile()
 {
-#if 0
   if(myFileOpened)
   {
-    fclose(mySampleFile);
-    fclose(mySharedSampleFile);
+    mySampleData.reset();
+    mySharedSampleData.reset();
+    mySampleSize = mySharedSampleSize = 0;
     myFileOpened = false;
   }
-#endif
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -216,12 +211,10 @@ void KidVid::setNextSong()
     mySharedData = (temp < 10);
     mySongCounter = ourSongStart[temp+1] - ourSongStart[temp];
 
-#if 0
     if(mySharedData)
-      ; // fseek(mySharedSampleFile, ourSongStart[temp], SEEK_SET);
+      mySharedSamplePos = ourSongStart[temp];
     else
-      ; // fseek(mySampleFile, ourSongStart[temp], SEEK_SET);
-#endif
+      mySamplePos = ourSongStart[temp];
 
     ++myFilePointer;
     myTapeBusy = true;
@@ -234,17 +227,25 @@ void KidVid::setNextSong()
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void KidVid::render(uInt8* samples, uInt32 count)
+{
+  for(uInt32 i = 0; i < count; ++i)
+  {
+    getNextSampleByte();
+    samples[i] = mySampleByte;
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void KidVid::getNextSampleByte()
 {
-//  static int oddeven = 0;
   if(mySongCounter == 0)
     mySampleByte = 0x80;
-#if 0
   else
   {
-    oddeven = oddeven^1;
-    if(oddeven & 1)
+    myOddEven = !myOddEven;
+    if(myOddEven)
     {
       mySongCounter--;
       myTapeBusy = (mySongCounter > 262*48) || !myBeep;
@@ -252,9 +253,11 @@ void KidVid::getNextSampleByte()
       if(myFileOpened)
       {
         if(mySharedData)
-          mySampleByte = getc(mySharedSampleFile);
+          mySampleByte = mySharedSamplePos < mySharedSampleSize
+            ? mySharedSampleData[mySharedSamplePos++] : 0x80;
         else
-          mySampleByte = getc(mySampleFile);
+          mySampleByte = mySamplePos < mySampleSize
+            ? mySampleData[mySamplePos++] : 0x80;
       }
       else
         mySampleByte = 0x80;
@@ -263,7 +266,6 @@ void KidVid::getNextSampleByte()
         setNextSong();
     }
   }
-#endif
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -18,12 +18,12 @@
 #ifndef KIDVID_HXX
 #define KIDVID_HXX
 
-#include <cstdio>
-
 class Event;
 
 #include "bspf.hxx"
+#include "Audio.hxx"
 #include "Control.hxx"
+#include "FSNode.hxx"
 
 /**
   The KidVid Voice Module, created by Coleco.  This class emulates the
@@ -32,11 +32,14 @@ class Event;
 
     http://www.atariage.com/2600/archives/KidVidAudio/index.html
 
+  The files are read into memory when a tape is inserted, and the samples
+  are handed to the TIA sound in blocks.
+
   This code was heavily borrowed from z26.
 
   @author  Stephen Anthony & z26 team
 */
-class KidVid : public Controller
+class KidVid : public Controller, public AudioSource
 {
   public:
     /**
@@ -46,9 +49,10 @@ class KidVid : public Controller
       @param event  The event object to use for events
       @param system The system using this controller
       @param romMd5 The md5 of the ROM using this controller
+      @param sampleDir The directory containing the WAV files
     */
     KidVid(Jack jack, const Event& event, const System& system,
-           const string& romMd5);
+           const string& romMd5, const FilesystemNode& sampleDir);
     ~KidVid() override;
 
   public:
@@ -63,6 +67,16 @@ class KidVid : public Controller
     */
     string name() const override { return "KidVid"; }
 
+    /**
+      The tape is played through the TIA sound.
+    */
+    AudioSource* audioSource() override { return this; }
+
+    /**
+      Generate the next samples of the tape (see AudioSource).
+    */
+    void render(uInt8* samples, uInt32 count) override;
+
   private:
     // Open/close a WAV sample file
     void openSampleFile();
@@ -72,7 +86,6 @@ class KidVid : public Controller
     void setNextSong();
 
     // Generate next sample byte
-    // TODO - rework this, perhaps send directly to sound class
     void getNextSampleByte();
 
   private:
@@ -89,12 +102,20 @@ class KidVid : public Controller
     // supports, and if it's plugged into the right port
     bool myEnabled{false};
 
-    // The file handles for the WAV files
-    // FILE *mySampleFile, *mySharedSampleFile;
+    // The directory containing the WAV files
+    FilesystemNode mySampleDir;
+
+    // The contents of the WAV files, and the current read positions
+    ByteBuffer mySampleData, mySharedSampleData;
+    size_t mySampleSize{0}, mySharedSampleSize{0};
+    size_t mySamplePos{0}, mySharedSamplePos{0};
 
     // Indicates if sample files have been successfully opened
     bool myFileOpened{false};
 
+    // Each sample byte lasts for two TIA samples
+    bool myOddEven{false};
+
     // Is the tape currently 'busy' / in use?
     bool myTapeBusy{false};
 
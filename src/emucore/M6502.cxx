@@ -17,7 +17,7 @@
 
 #ifdef DEBUGGER_SUPPORT
   #include "Debugger.hxx"
-  #include "Expression.hxx"
+  #include "ConditionList.hxx"
   #include "Device.hxx"
   #include "Base.hxx"
 
@@ -42,6 +42,7 @@
 #include "System.hxx"
 #include "M6502.hxx"
 #include "DispatchResult.hxx"
+#include "FrameProfiler.hxx"
 #include "exception/EmulationWarning.hxx"
 #include "exception/FatalEmulationError.hxx"
 
@@ -78,7 +79,7 @@ void M6502::reset()
   PS(BSPF::containsIgnoreCase(cpurandom, "P") ?
           mySystem->randGenerator().next() : 0x20);
 
-  icycles = 0;
+  icycles = mySyncedCycles = 0;
 
   // Load PC from the reset vector
   PC = uInt16(mySystem->peek(0xfffc)) | (uInt16(mySystem->peek(0xfffd)) << 8);
@@ -98,6 +99,13 @@ void M6502::reset()
   myLastBreakCycle = ULLONG_MAX;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void M6502::syncCycles()
+{
+  mySystem->incrementCycles(icycles - mySyncedCycles);
+  mySyncedCycles = icycles;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 inline uInt8 M6502::peek(uInt16 address, Device::AccessFlags flags)
 {
@@ -111,26 +119,41 @@ inline uInt8 M6502::peek(uInt16 address, Device::AccessFlags flags)
     myLastAddress = address;
   }
   ////////////////////////////////////////////////
-  mySystem->incrementCycles(SYSTEM_CYCLES_PER_CPU);
+  // The system clock is only brought up to date for accesses which may
+  // depend on it (see syncCycles())
   icycles += SYSTEM_CYCLES_PER_CPU;
   myFlags = flags;
-  uInt8 result = mySystem->peek(address, flags);
+  uInt8 result;
+  if(!mySystem->cpuPeekDirect(address, result))
+  {
+    syncCycles();
+    result = mySystem->peek(address, flags);
+  }
   myLastPeekAddress = address;
 
 #ifdef DEBUGGER_SUPPORT
-  if(myReadTraps.isInitialized() && myReadTraps.isSet(address)
+  if(myTraceRecord && flags == DISASM_DATA)
+  {
+    myTraceRecord->readAddress = address;
+    myTraceRecord->readValue = result;
+    myTraceRecord->flags |= CpuTrace::HasRead;
+  }
+
+  if((mySystem->pageTraps(address) & System::PageReadTrap) && myReadTraps.isSet(address)
      && (myGhostReadsTrap || flags != DISASM_NONE))
   {
+    syncCycles();
     myLastPeekBaseAddress = myDebugger->getBaseAddress(myLastPeekAddress, true); // mirror handling
     int cond = evalCondTraps();
     if(cond > -1)
     {
-      myJustHitReadTrapFlag = true;
+      myExecutionStatus |= TrapHitBit;
       stringstream msg;
       msg << "RTrap" << (flags == DISASM_NONE ? "G[" : "[") << Common::Base::HEX2 << cond << "]"
-        << (myTrapCondNames[cond].empty() ? ": " : "If: {" + myTrapCondNames[cond] + "} ");
+        << (myTrapConds.names()[cond].empty() ? ": " : "If: {" + myTrapConds.names()[cond] + "} ");
       myHitTrapInfo.message = msg.str();
       myHitTrapInfo.address = address;
+      myHitTrapInfo.read = true;
     }
   }
 #endif  // DEBUGGER_SUPPORT
@@ -149,23 +172,35 @@ inline void M6502::poke(uInt16 address, uInt8 value, Device::AccessFlags flags)
     myLastAddress = address;
   }
   ////////////////////////////////////////////////
-  mySystem->incrementCycles(SYSTEM_CYCLES_PER_CPU);
   icycles += SYSTEM_CYCLES_PER_CPU;
-  mySystem->poke(address, value, flags);
+  if(!mySystem->cpuPokeDirect(address, value))
+  {
+    syncCycles();
+    mySystem->poke(address, value, flags);
+  }
   myLastPokeAddress = address;
 
 #ifdef DEBUGGER_SUPPORT
-  if(myWriteTraps.isInitialized() && myWriteTraps.isSet(address))
+  if(myTraceRecord)
   {
+    myTraceRecord->writeAddress = address;
+    myTraceRecord->writeValue = value;
+    myTraceRecord->flags |= CpuTrace::HasWrite;
+  }
+
+  if((mySystem->pageTraps(address) & System::PageWriteTrap) && myWriteTraps.isSet(address))
+  {
+    syncCycles();
     myLastPokeBaseAddress = myDebugger->getBaseAddress(myLastPokeAddress, false); // mirror handling
     int cond = evalCondTraps();
     if(cond > -1)
     {
-      myJustHitWriteTrapFlag = true;
+      myExecutionStatus |= TrapHitBit;
       stringstream msg;
-      msg << "WTrap[" << Common::Base::HEX2 << cond << "]" << (myTrapCondNames[cond].empty() ? ":" : "If: {" + myTrapCondNames[cond] + "}");
+      msg << "WTrap[" << Common::Base::HEX2 << cond << "]" << (myTrapConds.names()[cond].empty() ? ":" : "If: {" + myTrapConds.names()[cond] + "}");
       myHitTrapInfo.message = msg.str();
       myHitTrapInfo.address = address;
+      myHitTrapInfo.read = false;
     }
   }
 #endif  // DEBUGGER_SUPPORT
@@ -182,6 +217,7 @@ void M6502::requestHalt()
 inline void M6502::handleHalt()
 {
   if (myHaltRequested) {
+    syncCycles();
     myOnHaltCallback();
     myHaltRequested = false;
   }
@@ -190,7 +226,16 @@ inline void M6502::handleHalt()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::execute(uInt64 number, DispatchResult& result)
 {
-  _execute(number, result);
+  FrameProfiler::Scope profilerScope(FrameProfiler::Stage::cpu);
+
+#ifdef DEBUGGER_SUPPORT
+  if(debuggerActive())
+    _execute<true>(number, result);
+  else
+    _execute<false>(number, result);
+#else
+  _execute<false>(number, result);
+#endif
 
 #ifdef DEBUGGER_SUPPORT
   // Debugger hack: this ensures that stepping a "STA WSYNC" will actually end at the
@@ -203,8 +248,8 @@ void M6502::execute(uInt64 number, DispatchResult& result)
   // Make sure that the hardware state matches the current system clock. This is necessary
   // to maintain a consistent state for the debugger after stepping and to make sure
   // that audio samples are generated for the whole timeslice.
-  mySystem->tia().updateEmulation();
-  mySystem->m6532().updateEmulation();
+  // The RIOT timer doesn't need this, it is evaluated lazily on access.
+  mySystem->tia().synchronize();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -218,15 +263,11 @@ bool M6502::execute(uInt64 number)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool debugging>
 inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
 {
   myExecutionStatus = 0;
 
-#ifdef DEBUGGER_SUPPORT
-  TIA& tia = mySystem->tia();
-  M6532& riot = mySystem->m6532();
-#endif
-
   uInt64 previousCycles = mySystem->cycles();
   uInt64 currentCycles = 0;
 
@@ -236,84 +277,69 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
     while (!myExecutionStatus && currentCycles < cycles * SYSTEM_CYCLES_PER_CPU)
     {
   #ifdef DEBUGGER_SUPPORT
-      // Don't break if we haven't actually executed anything yet
-      if (myLastBreakCycle != mySystem->cycles()) {
-        if(myJustHitReadTrapFlag || myJustHitWriteTrapFlag)
-        {
-          bool read = myJustHitReadTrapFlag;
-          myJustHitReadTrapFlag = myJustHitWriteTrapFlag = false;
-
-          myLastBreakCycle = mySystem->cycles();
-
-          if(myLogBreaks)
-            myDebugger->log(myHitTrapInfo.message);
-          else
+      if constexpr(debugging)
+      {
+        // Don't break if we haven't actually executed anything yet
+        if (myLastBreakCycle != mySystem->cycles()) {
+          if(myBreakPoints.isInitialized())
           {
-            result.setDebugger(currentCycles, myHitTrapInfo.message + " ",
-                               read ? "Read trap" : "Write trap",
-                               myHitTrapInfo.address, read);
-            return;
-          }
-        }
+            uInt8 bank = mySystem->cart().getBank(PC);
 
-        if(myBreakPoints.isInitialized())
-        {
-          uInt8 bank = mySystem->cart().getBank(PC);
+            if(myBreakPoints.check(PC, bank))
+            {
+              myLastBreakCycle = mySystem->cycles();
+              // disable a one-shot breakpoint
+              if(myBreakPoints.get(PC, bank) & BreakpointMap::ONE_SHOT)
+              {
+                myBreakPoints.erase(PC, bank);
+                return;
+              }
+              else
+              {
+                if(myLogBreaks)
+                  myDebugger->log("BP:");
+                else
+                {
+                  ostringstream msg;
+
+                  msg << "BP: $" << Common::Base::HEX4 << PC << ", bank #" << std::dec << int(bank);
+                  result.setDebugger(currentCycles, msg.str(), "Breakpoint");
+                  return;
+                }
+              }
+            }
+          }
 
-          if(myBreakPoints.check(PC, bank))
+          int cond = evalCondBreaks();
+          if(cond > -1)
           {
+            ostringstream msg;
+
             myLastBreakCycle = mySystem->cycles();
-            // disable a one-shot breakpoint
-            if(myBreakPoints.get(PC, bank) & BreakpointMap::ONE_SHOT)
+
+            if(myLogBreaks)
             {
-              myBreakPoints.erase(PC, bank);
-              return;
+              msg << "CBP[" << Common::Base::HEX2 << cond << "]:";
+              myDebugger->log(msg.str());
             }
             else
             {
-              if(myLogBreaks)
-                myDebugger->log("BP:");
-              else
-              {
-                ostringstream msg;
-
-                msg << "BP: $" << Common::Base::HEX4 << PC << ", bank #" << std::dec << int(bank);
-                result.setDebugger(currentCycles, msg.str(), "Breakpoint");
-                return;
-              }
+              msg << "CBP[" << Common::Base::HEX2 << cond << "]: " << myCondBreaks.names()[cond];
+              result.setDebugger(currentCycles, msg.str(), "Conditional breakpoint");
+              return;
             }
           }
         }
 
-        int cond = evalCondBreaks();
+        int cond = evalCondSaveStates();
         if(cond > -1)
         {
           ostringstream msg;
-
-          myLastBreakCycle = mySystem->cycles();
-
-          if(myLogBreaks)
-          {
-            msg << "CBP[" << Common::Base::HEX2 << cond << "]:";
-            myDebugger->log(msg.str());
-          }
-          else
-          {
-            msg << "CBP[" << Common::Base::HEX2 << cond << "]: " << myCondBreakNames[cond];
-            result.setDebugger(currentCycles, msg.str(), "Conditional breakpoint");
-            return;
-          }
+          msg << "conditional savestate [" << Common::Base::HEX2 << cond << "]";
+          myDebugger->addState(msg.str());
         }
       }
 
-      int cond = evalCondSaveStates();
-      if(cond > -1)
-      {
-        ostringstream msg;
-        msg << "conditional savestate [" << Common::Base::HEX2 << cond << "]";
-        myDebugger->addState(msg.str());
-      }
-
       mySystem->cart().clearAllRAMAccesses();
   #endif  // DEBUGGER_SUPPORT
 
@@ -324,9 +350,28 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
         uInt16 operandAddress = 0, intermediateAddress = 0;
         uInt8 operand = 0;
 
-        icycles = 0;
+        icycles = mySyncedCycles = 0;
     #ifdef DEBUGGER_SUPPORT
         uInt16 oldPC = PC;
+
+        if(debugging && myCpuTrace)
+        {
+          CpuTrace::Record& record = myCpuTrace->begin();
+
+          record.cycles = mySystem->cycles();
+          record.frame = mySystem->tia().frameCount();
+          record.scanline = uInt16(mySystem->tia().scanlines());
+          record.pc = PC;
+          record.bank = mySystem->cart().getBank(PC);
+          record.a = A;  record.x = X;  record.y = Y;
+          record.sp = SP;  record.ps = PS();
+          record.flags = 0;
+          myTraceRecord = &record;
+        }
+
+        // The bank must be known before the instruction may switch it
+        const uInt16 profileBank = debugging && myProfiling && myCpuProfiler->needsBank()
+          ? mySystem->cart().getBank(PC) : 0;
     #endif
 
         // Fetch instruction at the program counter
@@ -341,9 +386,21 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
           default:
             FatalEmulationError::raise("invalid instruction");
         }
+        syncCycles();
 
     #ifdef DEBUGGER_SUPPORT
-        if(myReadFromWritePortBreak)
+        if(debugging && myTraceRecord)
+        {
+          myTraceRecord->opcode = IR;
+          myTraceRecord->icycles = icycles;
+          myTraceRecord = nullptr;
+          myCpuTrace->end();
+        }
+
+        if(debugging && myProfiling)
+          myCpuProfiler->record(oldPC, profileBank, IR, icycles);
+
+        if(debugging && myReadFromWritePortBreak)
         {
           uInt16 rwpAddr = mySystem->cart().getIllegalRAMReadAccess();
           if(rwpAddr)
@@ -355,7 +412,7 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
           }
         }
 
-        if (myWriteToReadPortBreak)
+        if (debugging && myWriteToReadPortBreak)
         {
           uInt16 wrpAddr = mySystem->cart().getIllegalRAMWriteAccess();
           if (wrpAddr)
@@ -368,23 +425,31 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
         }
     #endif  // DEBUGGER_SUPPORT
       } catch (const FatalEmulationError& e) {
+        syncCycles();
         myExecutionStatus |= FatalErrorBit;
         result.setMessage(e.what());
       } catch (const EmulationWarning& e) {
+        syncCycles();
         result.setDebugger(currentCycles, e.what(), "Emulation exception", PC);
         return;
       }
 
       currentCycles = (mySystem->cycles() - previousCycles);
 
+      // A branch may have closed an idle loop polling the timer
+      if constexpr(!debugging)
+        if((IR & 0x1F) == 0x10 && !myExecutionStatus &&
+           currentCycles < cycles * SYSTEM_CYCLES_PER_CPU)
+          currentCycles += skipIdleLoop(cycles * SYSTEM_CYCLES_PER_CPU - currentCycles);
+
   #ifdef DEBUGGER_SUPPORT
-      if(myStepStateByInstruction)
+      if(debugging && myStepStateByInstruction)
       {
         // Check out M6502::execute for an explanation.
         handleHalt();
 
-        tia.updateEmulation();
-        riot.updateEmulation();
+        mySystem->tia().synchronize();
+        mySystem->m6532().updateEmulation();
       }
   #endif
     }
@@ -406,6 +471,25 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
       return;
     }
 
+  #ifdef DEBUGGER_SUPPORT
+    // See if the last instruction hit a trap (in both cores)
+    if(myExecutionStatus & TrapHitBit)
+    {
+      myExecutionStatus &= ~TrapHitBit;
+      myLastBreakCycle = mySystem->cycles();
+
+      if(myLogBreaks)
+        myDebugger->log(myHitTrapInfo.message);
+      else
+      {
+        result.setDebugger(currentCycles, myHitTrapInfo.message + " ",
+                           myHitTrapInfo.read ? "Read trap" : "Write trap",
+                           myHitTrapInfo.address, myHitTrapInfo.read);
+        return;
+      }
+    }
+  #endif
+
     // See if execution has been stopped
     if(myExecutionStatus & StopExecutionBit)
     {
@@ -421,6 +505,118 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 M6502::skipIdleLoop(uInt64 maxCycles)
+{
+  if(myHaltRequested)
+    return 0;
+#ifdef DEBUGGER_SUPPORT
+  // Skipped accesses would be missing from the access flags and counters,
+  // and could not hit any traps
+  if(mySystem->accessTracking() || mySystem->hasPageTraps())
+    return 0;
+#endif
+
+  // Fetch the loop's code; all accesses must be free of side effects
+  const uInt16 loop = PC;
+  std::array<uInt8, 6> code;
+  for(uInt16 i = 0; i < code.size(); ++i)
+  {
+    const uInt16 addr = loop + i;
+    const System::PageAccess& access = mySystem->getPageAccess(addr);
+
+    if(access.directPeekBase == nullptr)
+      return 0;
+    code[i] = access.directPeekBase[addr & System::PAGE_MASK];
+  }
+
+  // The taken branch at the end of the loop (offset -5) must be the
+  // instruction which just got us here
+  if(code[3] != IR || code[4] != 0xFB)
+    return 0;
+  if(code[0] != 0xAD && code[0] != 0xAE && code[0] != 0xAC && code[0] != 0x2C)
+    return 0;  // not LDA/LDX/LDY/BIT absolute
+
+  // The loop must read INTIM/TIMINT (or a mirror) from the RIOT itself
+  const uInt16 address = code[1] | (uInt16(code[2]) << 8);
+  M6532& riot = mySystem->m6532();
+  if((address & 0x1284) != 0x0284 || mySystem->getPageAccess(address).device != &riot)
+    return 0;
+
+  // A taken branch to another page costs one more cycle and does an
+  // additional dummy read
+  const uInt16 branchEnd = loop + 5;
+  uInt64 period = 7;
+  if((branchEnd ^ loop) & 0xFF00)
+  {
+    if(mySystem->getPageAccess((branchEnd & 0xFF00) | (loop & 0x00FF)).directPeekBase == nullptr)
+      return 0;
+    ++period;
+  }
+
+  // The timer is read in the 4th cycle of each iteration
+  const uInt64 start = mySystem->cycles() + 4;
+  uInt64 iterations = 0;
+  uInt8 value = 0;
+
+  while((iterations + 1) * period <= maxCycles)
+  {
+    uInt8 read;
+    uInt64 stable;
+
+    if(!riot.peekTimer(address, start + iterations * period, read, stable))
+      break;
+
+    // Determine the flags after the read, and whether the branch is taken
+    bool n = read & 0x80, notz = read, v = V;
+    if(code[0] == 0x2C)
+    {
+      notz = A & read;
+      v = read & 0x40;
+    }
+    bool taken;
+    switch(code[3])
+    {
+      case 0x10: taken = !n;    break;  // BPL
+      case 0x30: taken = n;     break;  // BMI
+      case 0x50: taken = !v;    break;  // BVC
+      case 0x70: taken = v;     break;  // BVS
+      case 0x90: taken = !C;    break;  // BCC
+      case 0xB0: taken = C;     break;  // BCS
+      case 0xD0: taken = notz;  break;  // BNE
+      default:   taken = !notz; break;  // BEQ
+    }
+    if(!taken)
+      break;
+
+    // All following iterations reading the same value behave identically
+    iterations += std::min(stable / period + 1, maxCycles / period - iterations);
+    value = read;
+  }
+
+  if(iterations == 0)
+    return 0;
+
+  // Leave the CPU in the state after the last skipped iteration
+  switch(code[0])
+  {
+    case 0xAD: A = value; break;
+    case 0xAE: X = value; break;
+    case 0xAC: Y = value; break;
+    default:   V = value & 0x40; break;
+  }
+  N = value & 0x80;
+  notZ = code[0] == 0x2C ? (A & value) : value;
+
+  const uInt64 skipped = iterations * period;
+  // Every cycle of the loop accesses an address different from the previous one
+  myNumberOfDistinctAccesses += uInt32(skipped);
+  riot.skipTimerReads(uInt32(iterations));
+  mySystem->incrementCycles(uInt32(skipped));
+
+  return skipped;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::interruptHandler()
 {
@@ -555,25 +751,89 @@ void M6502::attach(Debugger& debugger)
   myDebugger = &debugger;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool M6502::startCpuTrace(const string& filename)
+{
+  stopCpuTrace();
+
+  auto trace = make_unique<CpuTrace>();
+  if(!trace->start(filename))
+    return false;
+
+  myCpuTrace = std::move(trace);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::stopCpuTrace()
+{
+  myTraceRecord = nullptr;
+  myCpuTrace.reset();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::startCpuProfile(CpuProfiler::Mode mode)
+{
+  myCpuProfiler = make_unique<CpuProfiler>(mode, mySystem->cart().romBankCount());
+  myProfiling = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool M6502::replay(uInt64 cycles)
+{
+  DispatchResult result;
+
+  // Logged traps were already logged when the emulation passed them first,
+  // and don't stop the execution anyway
+  const bool logBreaks = myLogBreaks;
+  myLogBreaks = false;
+  _execute<false>(cycles, result);
+  myLogBreaks = logBreaks;
+
+  // See execute()
+  handleHalt();
+  mySystem->tia().synchronize();
+
+  return !logBreaks && result.getStatus() == DispatchResult::Status::debugger;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool M6502::breakPending()
+{
+  if(myBreakPoints.isInitialized())
+  {
+    const uInt8 bank = mySystem->cart().getBank(PC);
+
+    if(myBreakPoints.check(PC, bank) &&
+       !(myBreakPoints.get(PC, bank) & BreakpointMap::ONE_SHOT))
+      return true;
+  }
+
+  return evalCondBreaks() > -1;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::skipBreakAtCurrentCycle()
+{
+  myLastBreakCycle = mySystem->cycles();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 M6502::addCondBreak(Expression* e, const string& name, bool oneShot)
 {
-  myCondBreaks.emplace_back(e);
-  myCondBreakNames.push_back(name);
+  const uInt32 idx = myCondBreaks.add(e, name);
 
   updateStepStateByInstruction();
 
-  return uInt32(myCondBreaks.size() - 1);
+  return idx;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool M6502::delCondBreak(uInt32 idx)
 {
-  if(idx < myCondBreaks.size())
+  if(myCondBreaks.remove(idx))
   {
-    Vec::removeAt(myCondBreaks, idx);
-    Vec::removeAt(myCondBreakNames, idx);
-
     updateStepStateByInstruction();
 
     return true;
@@ -585,7 +845,6 @@ bool M6502::delCondBreak(uInt32 idx)
 void M6502::clearCondBreaks()
 {
   myCondBreaks.clear();
-  myCondBreakNames.clear();
 
   updateStepStateByInstruction();
 }
@@ -593,28 +852,24 @@ void M6502::clearCondBreaks()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 const StringList& M6502::getCondBreakNames() const
 {
-  return myCondBreakNames;
+  return myCondBreaks.names();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 M6502::addCondSaveState(Expression* e, const string& name)
 {
-  myCondSaveStates.emplace_back(e);
-  myCondSaveStateNames.push_back(name);
+  const uInt32 idx = myCondSaveStates.add(e, name);
 
   updateStepStateByInstruction();
 
-  return uInt32(myCondSaveStates.size() - 1);
+  return idx;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool M6502::delCondSaveState(uInt32 idx)
 {
-  if(idx < myCondSaveStates.size())
+  if(myCondSaveStates.remove(idx))
   {
-    Vec::removeAt(myCondSaveStates, idx);
-    Vec::removeAt(myCondSaveStateNames, idx);
-
     updateStepStateByInstruction();
 
     return true;
@@ -626,7 +881,6 @@ bool M6502::delCondSaveState(uInt32 idx)
 void M6502::clearCondSaveStates()
 {
   myCondSaveStates.clear();
-  myCondSaveStateNames.clear();
 
   updateStepStateByInstruction();
 }
@@ -634,28 +888,24 @@ void M6502::clearCondSaveStates()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 const StringList& M6502::getCondSaveStateNames() const
 {
-  return myCondSaveStateNames;
+  return myCondSaveStates.names();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 M6502::addCondTrap(Expression* e, const string& name)
 {
-  myTrapConds.emplace_back(e);
-  myTrapCondNames.push_back(name);
+  const uInt32 idx = myTrapConds.add(e, name);
 
   updateStepStateByInstruction();
 
-  return uInt32(myTrapConds.size() - 1);
+  return idx;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool M6502::delCondTrap(uInt32 brk)
 {
-  if(brk < myTrapConds.size())
+  if(myTrapConds.remove(brk))
   {
-    Vec::removeAt(myTrapConds, brk);
-    Vec::removeAt(myTrapCondNames, brk);
-
     updateStepStateByInstruction();
 
     return true;
@@ -667,7 +917,6 @@ bool M6502::delCondTrap(uInt32 brk)
 void M6502::clearCondTraps()
 {
   myTrapConds.clear();
-  myTrapCondNames.clear();
 
   updateStepStateByInstruction();
 }
@@ -675,13 +924,13 @@ void M6502::clearCondTraps()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 const StringList& M6502::getCondTrapNames() const
 {
-  return myTrapCondNames;
+  return myTrapConds.names();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::updateStepStateByInstruction()
 {
-  myStepStateByInstruction = myCondBreaks.size() || myCondSaveStates.size() ||
-                             myTrapConds.size();
+  myStepStateByInstruction = !myCondBreaks.empty() || !myCondSaveStates.empty() ||
+                             !myTrapConds.empty();
 }
 #endif  // DEBUGGER_SUPPORT
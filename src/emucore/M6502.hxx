@@ -28,7 +28,9 @@ class DispatchResult;
   class Debugger;
   class CpuDebug;
 
-  #include "Expression.hxx"
+  #include "ConditionList.hxx"
+  #include "CpuProfiler.hxx"
+  #include "CpuTrace.hxx"
   #include "TrapArray.hxx"
   #include "BreakpointMap.hxx"
 #endif
@@ -98,6 +100,7 @@ class M6502 : public Serializable
     void setOnHaltCallback(const onHaltCallback& callback) {
       myOnHaltCallback = callback;
     }
+    const onHaltCallback& getOnHaltCallback() const { return myOnHaltCallback; }
 
     /**
       RDY pulled low --- halt on next read.
@@ -257,6 +260,48 @@ class M6502 : public Serializable
     void setWriteToReadPortBreak(bool enable) { myWriteToReadPortBreak = enable; }
     void setLogBreaks(bool enable) { myLogBreaks = enable; }
     bool getLogBreaks() { return myLogBreaks; }
+
+    /**
+      Execute instructions with the fast core, ignoring breakpoints and
+      conditions (used by the debugger to replay the emulation from a
+      checkpoint).  Like execute(), the hardware is synchronized at the end.
+
+      @param cycles  The number of cycles to execute
+      @return  True if a trap stopped the execution early
+    */
+    bool replay(uInt64 cycles);
+
+    /**
+      Check whether a (not one-shot) breakpoint or a conditional break
+      would stop the execution before the current instruction.
+    */
+    bool breakPending();
+
+    /**
+      Don't stop before the current instruction, as if the execution had
+      just been stopped there.
+    */
+    void skipBreakAtCurrentCycle();
+
+    /**
+      Start recording a binary trace of all executed instructions into
+      the given file (see CpuTrace), resp. stop the recording.
+
+      @return  False if the trace file couldn't be created
+    */
+    bool startCpuTrace(const string& filename);
+    void stopCpuTrace();
+    const CpuTrace* cpuTrace() const { return myCpuTrace.get(); }
+
+    /**
+      Start counting the cycles of all executed instructions (see
+      CpuProfiler), discarding the previous profile, resp. stop counting.
+      The profile stays available until the next start.
+    */
+    void startCpuProfile(CpuProfiler::Mode mode);
+    void stopCpuProfile() { myProfiling = false; }
+    bool isProfiling() const { return myProfiling; }
+    const CpuProfiler* cpuProfiler() const { return myCpuProfiler.get(); }
 #endif  // DEBUGGER_SUPPORT
 
   private:
@@ -327,13 +372,56 @@ class M6502 : public Serializable
     */
     void handleHalt();
 
+    /**
+      Add the cycles of the current instruction which haven't been added
+      to the system clock yet. Accesses to RAM and ROM pages don't depend
+      on the clock, so it is only updated before device accesses (and the
+      debugger's traps and halts), and at the end of each instruction.
+    */
+    void syncCycles();
+
     /**
       This is the actual dispatch function that does the grunt work. M6502::execute
       wraps it and makes sure that any pending halt is processed before returning.
+
+      @tparam debugging  Whether breakpoints, traps, conditional breaks etc.
+                         are checked; the instantiation without them is used
+                         whenever none of these is set (see 'debuggerActive')
     */
+    template<bool debugging>
     void _execute(uInt64 cycles, DispatchResult& result);
 
+    /**
+      Check whether the CPU is at the start of an idle loop which does
+      nothing but poll the RIOT timer, e.g.
+
+        loop: LDA INTIM   (or LDX/LDY/BIT, INTIM or TIMINT)
+              BNE loop    (or any other branch)
+
+      and if so, skip as many iterations as can be predicted to have the
+      same outcome, by advancing the system clock. The result is exactly
+      the same as executing the iterations.
+
+      @param maxCycles  The maximum number of cycles to skip
+      @return  The number of cycles skipped
+    */
+    uInt64 skipIdleLoop(uInt64 maxCycles);
+
 #ifdef DEBUGGER_SUPPORT
+    /**
+      Check whether any breakpoints, conditional breaks/saves or read/write
+      port breaks are set, which must be checked while executing. Traps
+      are not included, they are checked on access to trapped pages only
+      (see System::setPageTraps) and also handled by the fast core.
+    */
+    bool debuggerActive() const {
+      return myBreakPoints.isInitialized() ||
+             myStepStateByInstruction || !myCondBreaks.empty() ||
+             !myCondSaveStates.empty() ||
+             myReadFromWritePortBreak || myWriteToReadPortBreak ||
+             myCpuTrace != nullptr || myProfiling;
+    }
+
     /**
       Check whether we are required to update hardware (TIA + RIOT) in lockstep
       with the CPU and update the flag accordingly.
@@ -351,16 +439,20 @@ class M6502 : public Serializable
       StopExecutionBit        = 0x01,
       FatalErrorBit           = 0x02,
       MaskableInterruptBit    = 0x04,
-      NonmaskableInterruptBit = 0x08
+      NonmaskableInterruptBit = 0x08,
+      TrapHitBit              = 0x10
     ;
     uInt8 myExecutionStatus{0};
 
+    // The members up to myHaltRequested are accessed by every instruction
+    // (or every memory access), and are kept together at the start of the
+    // object, so they share as few cache lines as possible.  Everything
+    // which is only used for debugging, on halt or by the state handling
+    // follows below.
+
     /// Pointer to the system the processor is installed in or the null pointer
     System* mySystem{nullptr};
 
-    /// Reference to the settings
-    const Settings& mySettings;
-
     uInt8 A{0};    // Accumulator
     uInt8 X{0};    // X index register
     uInt8 Y{0};    // Y index register
@@ -377,6 +469,10 @@ class M6502 : public Serializable
     bool C{false};     // C flag for processor status register
 
     uInt8 icycles{0}; // cycles of last instruction
+    uInt8 mySyncedCycles{0}; // part of icycles added to the system clock
+
+    /// Indicates whether RDY was pulled low
+    bool myHaltRequested{false};
 
     /// Indicates the numer of distinct memory accesses
     uInt32 myNumberOfDistinctAccesses{0};
@@ -384,63 +480,52 @@ class M6502 : public Serializable
     /// Indicates the last address which was accessed
     uInt16 myLastAddress{0};
 
-    /// Last cycle that triggered a breakpoint
-    uInt64 myLastBreakCycle{ULLONG_MAX};
-
     /// Indicates the last address which was accessed specifically
     /// by a peek or poke command
     uInt16 myLastPeekAddress{0}, myLastPokeAddress{0};
-    /// Indicates the last base (= non-mirrored) address which was
-    /// accessed specifically by a peek or poke command
-    uInt16 myLastPeekBaseAddress{0}, myLastPokeBaseAddress{0};
     // Indicates the type of the last access
     uInt16 myFlags{0};
 
-    /// Indicates the last address used to access data by a peek command
-    /// for the CPU registers (S/A/X/Y)
-    Int32 myLastSrcAddressS{-1}, myLastSrcAddressA{-1},
-          myLastSrcAddressX{-1}, myLastSrcAddressY{-1};
-
     /// Indicates the data address used by the last command that performed
     /// a poke (currently, the last address used by STx)
     /// If an address wasn't used (ie, as in immediate mode), the address
     /// is set to zero
     uInt16 myDataAddressForPoke{0};
 
+    /// Indicates the last address used to access data by a peek command
+    /// for the CPU registers (S/A/X/Y)
+    Int32 myLastSrcAddressS{-1}, myLastSrcAddressA{-1},
+          myLastSrcAddressX{-1}, myLastSrcAddressY{-1};
+
     /// Indicates the number of system cycles per processor cycle
     static constexpr uInt32 SYSTEM_CYCLES_PER_CPU = 1;
 
+    /// Reference to the settings
+    const Settings& mySettings;
+
+    /// Indicates the last base (= non-mirrored) address which was
+    /// accessed specifically by a peek or poke command
+    uInt16 myLastPeekBaseAddress{0}, myLastPokeBaseAddress{0};
+
+    /// Last cycle that triggered a breakpoint
+    uInt64 myLastBreakCycle{ULLONG_MAX};
+
     /// Called when the processor enters halt state
     onHaltCallback myOnHaltCallback{nullptr};
 
-    /// Indicates whether RDY was pulled low
-    bool myHaltRequested{false};
-
 #ifdef DEBUGGER_SUPPORT
     Int32 evalCondBreaks() {
-      for(Int32 i = Int32(myCondBreaks.size()) - 1; i >= 0; --i)
-        if(myCondBreaks[i]->evaluate())
-          return i;
-
-      return -1; // no break hit
+      return myCondBreaks.evaluate(PC);
     }
 
     Int32 evalCondSaveStates()
     {
-      for(Int32 i = Int32(myCondSaveStates.size()) - 1; i >= 0; --i)
-        if(myCondSaveStates[i]->evaluate())
-          return i;
-
-      return -1; // no save state point hit
+      return myCondSaveStates.evaluate(PC);
     }
 
     Int32 evalCondTraps()
     {
-      for(Int32 i = Int32(myTrapConds.size()) - 1; i >= 0; --i)
-        if(myTrapConds[i]->evaluate())
-          return i;
-
-      return -1; // no trapif hit
+      return myTrapConds.evaluate();
     }
 
     /// Pointer to the debugger for this processor or the null pointer
@@ -449,22 +534,26 @@ class M6502 : public Serializable
     // Addresses for which the specified action should occur
     TrapArray myReadTraps, myWriteTraps;
 
-    // Did we just now hit a trap?
-    bool myJustHitReadTrapFlag{false};
-    bool myJustHitWriteTrapFlag{false};
+    // The trap hit by the current instruction (signalled by TrapHitBit)
     struct HitTrapInfo {
       string message;
       int address{0};
+      bool read{false};
     };
     HitTrapInfo myHitTrapInfo;
 
     BreakpointMap myBreakPoints;
-    vector<unique_ptr<Expression>> myCondBreaks;
-    StringList myCondBreakNames;
-    vector<unique_ptr<Expression>> myCondSaveStates;
-    StringList myCondSaveStateNames;
-    vector<unique_ptr<Expression>> myTrapConds;
-    StringList myTrapCondNames;
+    ConditionList myCondBreaks;
+    ConditionList myCondSaveStates;
+    ConditionList myTrapConds;
+
+    // The active instruction trace, and its record of the current instruction
+    unique_ptr<CpuTrace> myCpuTrace;
+    CpuTrace::Record* myTraceRecord{nullptr};
+
+    // The cycle profile, and whether it is currently being recorded
+    unique_ptr<CpuProfiler> myCpuProfiler;
+    bool myProfiling{false};
 #endif  // DEBUGGER_SUPPORT
 
     bool myGhostReadsTrap{false};          // trap on ghost reads
@@ -22,6 +22,7 @@
 #include "Switches.hxx"
 #include "System.hxx"
 #include "Base.hxx"
+#include "MemoryUsage.hxx"
 
 #include "M6532.hxx"
 
@@ -110,45 +111,92 @@ void M6532::update()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6532::updateEmulation()
 {
-  uInt32 cycles = uInt32(mySystem->cycles() - myLastCycle);
-  uInt32 subTimer = mySubTimer;
+  const uInt64 cycles = mySystem->cycles() - myLastCycle;
 
   // Guard against further state changes if the debugger alread forwarded emulation
   // state (in particular myWrappedThisCycle)
   if (cycles == 0) return;
 
-  myWrappedThisCycle = false;
-  mySubTimer = (cycles + mySubTimer) % myDivider;
+  advanceTimer(cycles, myTimer, mySubTimer, myInterruptFlag, myWrappedThisCycle);
+
+  myLastCycle = mySystem->cycles();
+
+#ifdef DEBUGGER_SUPPORT
+  myTimWrappedOnRead = myTimWrappedOnWrite = false;
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6532::advanceTimer(uInt64 cycles, uInt8& timer, uInt32& subTimer,
+                         uInt8& interruptFlag, bool& wrapped) const
+{
+  // Note: the timer is only evaluated on demand, so 'cycles' may span a
+  // long time and all calculations are done in 64 bit
+  const uInt32 oldSubTimer = subTimer;
 
-  if ((myInterruptFlag & TimerBit) == 0)
+  wrapped = false;
+  subTimer = uInt32((cycles + subTimer) % myDivider);
+
+  if ((interruptFlag & TimerBit) == 0)
   {
-    uInt32 timerTicks = (cycles + subTimer) / myDivider;
+    const uInt64 timerTicks = (cycles + oldSubTimer) / myDivider;
 
-    if(timerTicks > myTimer)
+    if(timerTicks > timer)
     {
-      cycles -= ((myTimer + 1) * myDivider - subTimer);
+      cycles -= ((timer + 1) * myDivider - oldSubTimer);
 
-      myWrappedThisCycle = cycles == 0;
-      myTimer = 0xFF;
-      myInterruptFlag |= TimerBit;
+      wrapped = cycles == 0;
+      timer = 0xFF;
+      interruptFlag |= TimerBit;
     }
     else
     {
-      myTimer -= timerTicks;
+      timer -= uInt8(timerTicks);
       cycles = 0;
     }
   }
 
-  if((myInterruptFlag & TimerBit) != 0) {
-    myTimer = (myTimer - cycles) & 0xFF;
-    myWrappedThisCycle = myTimer == 0xFF;
+  if((interruptFlag & TimerBit) != 0) {
+    timer = uInt8(timer - cycles);
+    wrapped = timer == 0xFF;
   }
+}
 
-  myLastCycle = mySystem->cycles();
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool M6532::peekTimer(uInt16 address, uInt64 cycle, uInt8& value, uInt64& stable) const
+{
+  uInt8 timer = myTimer, interruptFlag = myInterruptFlag;
+  uInt32 subTimer = mySubTimer;
+  bool wrapped = myWrappedThisCycle;
 
-#ifdef DEBUGGER_SUPPORT
-  myTimWrappedOnRead = myTimWrappedOnWrite = false;
-#endif
+  if(cycle > myLastCycle)
+    advanceTimer(cycle - myLastCycle, timer, subTimer, interruptFlag, wrapped);
+
+  if((address & 0x01) == 0x00)  // INTIM
+  {
+    value = timer;
+    if((interruptFlag & TimerBit) != 0)
+    {
+      // After the wrap, the timer changes with every cycle
+      stable = 0;
+      // Reading INTIM clears the timer flag
+      return wrapped;
+    }
+    // Before the wrap, the timer changes with the divider
+    stable = myDivider - subTimer - 1;
+  }
+  else                          // TIMINT
+  {
+    value = interruptFlag;
+    // Once set, the timer flag can only be cleared by software
+    if((interruptFlag & TimerBit) != 0)
+      stable = ~uInt64(0);
+    else
+      stable = (timer + 1) * uInt64(myDivider) - subTimer - 1;
+    // Reading TIMINT clears the PA7 flag
+    return (interruptFlag & PA7Bit) == 0;
+  }
+  return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -173,8 +221,15 @@ void M6532::installDelegate(System& system, Device& device)
   //    (addr & 0x0200) == 0x0200 is IO     (A9 is 1)
   //    (addr & 0x0300) == 0x0100 is Stack  (A8 is 1, A9 is 0)
   //    (addr & 0x0300) == 0x0000 is ZP RAM (A8 is 0, A9 is 0)
+  //
+  // Since the timer is evaluated lazily, ZP RAM doesn't need peek()/poke()
+  // and can be accessed directly (unless another device handles it)
   for (uInt16 addr = 0; addr < 0x1000; addr += System::PAGE_SIZE)
     if ((addr & 0x0080) == 0x0080) {
+      if (&device == this && (addr & 0x0200) == 0x0000)
+        access.directPeekBase = access.directPokeBase = &myRAM[addr & 0x0040];
+      else
+        access.directPeekBase = access.directPokeBase = nullptr;
       mySystem->setPageAccess(addr, access);
     }
 }
@@ -182,8 +237,6 @@ void M6532::installDelegate(System& system, Device& device)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 M6532::peek(uInt16 addr)
 {
-  updateEmulation();
-
   // A9 distinguishes I/O registers from ZP RAM
   // A9 = 1 is read from I/O
   // A9 = 0 is read from RAM
@@ -222,6 +275,9 @@ uInt8 M6532::peek(uInt16 addr)
     case 0x04:    // INTIM - Timer Output
     case 0x06:
     {
+      // The timer is only brought up to date when it is actually read
+      updateEmulation();
+
       // Timer Flag is always cleared when accessing INTIM
       if (!myWrappedThisCycle) myInterruptFlag &= ~TimerBit;
   #ifdef DEBUGGER_SUPPORT
@@ -234,6 +290,8 @@ uInt8 M6532::peek(uInt16 addr)
     case 0x05:    // TIMINT/INSTAT - Interrupt Flag
     case 0x07:
     {
+      updateEmulation();
+
       // PA7 Flag is always cleared after accessing TIMINT
       uInt8 result = myInterruptFlag;
       myInterruptFlag &= ~PA7Bit;
@@ -256,8 +314,6 @@ uInt8 M6532::peek(uInt16 addr)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool M6532::poke(uInt16 addr, uInt8 value)
 {
-  updateEmulation();
-
   // A9 distinguishes I/O registers from ZP RAM
   // A9 = 1 is write to I/O
   // A9 = 0 is write to RAM
@@ -318,6 +374,9 @@ void M6532::setTimerRegister(uInt8 value, uInt8 interval)
 {
   static constexpr std::array<uInt32, 4> divider = { 1, 8, 64, 1024 };
 
+  // Catch up with the old timer first, this determines myWrappedThisCycle
+  updateEmulation();
+
   myDivider = divider[interval];
   myOutTimer[interval] = value;
 
@@ -367,6 +426,17 @@ void M6532::setPinState(bool swcha)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6532::addMemoryUsage(MemoryUsage& usage) const
+{
+#ifdef DEBUGGER_SUPPORT
+  usage.add(MemoryUsage::Category::accessArrays,
+            sizeof(myRAMAccessBase) + sizeof(myStackAccessBase) + sizeof(myIOAccessBase) +
+            sizeof(myRAMAccessCounter) + sizeof(myStackAccessCounter) +
+            sizeof(myIOAccessCounter) + sizeof(myZPAccessDelay));
+#endif
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool M6532::save(Serializer& out) const
 {
@@ -19,6 +19,7 @@
 #define M6532_HXX
 
 class ConsoleIO;
+class MemoryUsage;
 class RiotDebug;
 class System;
 class Settings;
@@ -123,6 +124,37 @@ class M6532 : public Device
      */
     void updateEmulation();
 
+    /**
+      Determine the value a read of the timer register (INTIM or TIMINT)
+      at the given address would return at the given (future) system
+      cycle, without changing any state. This allows the CPU to skip idle
+      loops which poll the timer.
+
+      Nothing must access the RIOT between now and the given cycle for the
+      result to be valid.
+
+      @param address  The timer register address (INTIM or TIMINT)
+      @param cycle    The system cycle at which the read would happen
+      @param value    The value the read would return
+      @param stable   The number of cycles after 'cycle' during which the
+                      read would keep returning the same value
+
+      @return  False if the read would change the RIOT state (i.e. clear
+               the timer or PA7 flag), in which case it must be emulated
+    */
+    bool peekTimer(uInt16 address, uInt64 cycle, uInt8& value, uInt64& stable) const;
+
+    /**
+      Account for timer reads skipped by the CPU (see peekTimer()).
+
+      @param reads  The number of INTIM/TIMINT reads skipped
+    */
+    void skipTimerReads(uInt32 reads) {
+    #ifdef DEBUGGER_SUPPORT
+      myTimReadCycles += reads * 7;
+    #endif
+    }
+
     /**
       Get a pointer to the RAM contents.
 
@@ -130,6 +162,20 @@ class M6532 : public Device
     */
     const uInt8* getRAM() const { return myRAM.data(); }
 
+    /**
+      Get a writable pointer to the RAM contents, for frontends which
+      inspect and modify the RAM directly (e.g. cheats or achievements).
+      Changes take effect immediately.
+
+      @return  Pointer to RAM array.
+    */
+    uInt8* getRAM() { return myRAM.data(); }
+
+    /**
+      Add the memory held by the access arrays to the given usage.
+    */
+    void addMemoryUsage(MemoryUsage& usage) const;
+
   #ifdef DEBUGGER_SUPPORT
     /**
       Query the access counters
@@ -147,6 +193,12 @@ class M6532 : public Device
   private:
 
     void setTimerRegister(uInt8 data, uInt8 interval);
+
+    /**
+      Advance the given timer state by the given number of cycles.
+    */
+    void advanceTimer(uInt64 cycles, uInt8& timer, uInt32& subTimer,
+                      uInt8& interruptFlag, bool& wrapped) const;
     void setPinState(bool shcha);
 
   #ifdef DEBUGGER_SUPPORT
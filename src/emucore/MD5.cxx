@@ -46,14 +46,11 @@
 
 namespace MD5 {
 
-// Setup the types used by the MD5 routines
-using POINTER = uInt8*;
-
 // MD5 context.
 struct MD5_CTX
 {
   uInt32 state[4];    /* state (ABCD) */
-  uInt32 count[2];    /* number of bits, modulo 2^64 (lsb first) */
+  uInt64 count;       /* number of bytes processed */
   uInt8 buffer[64];   /* input buffer */
 };
 
@@ -75,22 +72,23 @@ struct MD5_CTX
 #define S43 15
 #define S44 21
 
+// On little-endian targets, the message words can be loaded directly
+#if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || \
+    defined(_MSC_VER)
+  #define MD5_LITTLE_ENDIAN
+#endif
+
 static void MD5Init(MD5_CTX*);
-static void MD5Update(MD5_CTX*, const uInt8*, uInt32);
+static void MD5Update(MD5_CTX*, const uInt8*, size_t);
 static void MD5Final(uInt8[16], MD5_CTX*);
 static void MD5Transform(uInt32 [4], const uInt8 [64]);
-static void Encode(uInt8*, uInt32*, uInt32);
+static void Encode(uInt8*, const uInt32*, uInt32);
 static void Decode(uInt32*, const uInt8*, uInt32);
 
-static uInt8 PADDING[64] = {
-  0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
-};
-
 // F, G, H and I are basic MD5 functions.
-#define F(x, y, z) (((x) & (y)) | ((~x) & (z)))
-#define G(x, y, z) (((x) & (z)) | ((y) & (~z)))
+// F is written with one operation less than in RFC 1321, G is inlined
+// into GG (see below).
+#define F(x, y, z) ((z) ^ ((x) & ((y) ^ (z))))
 #define H(x, y, z) ((x) ^ (y) ^ (z))
 #define I(x, y, z) ((y) ^ ((x) | (~z)))
 
@@ -99,13 +97,17 @@ static uInt8 PADDING[64] = {
 
 // FF, GG, HH, and II transformations for rounds 1, 2, 3, and 4.
 // Rotation is separate from addition to prevent recomputation.
+// Since the two terms of G(b, c, d) = (b & d) | (c & ~d) never share any
+// bits, GG adds them separately, and the term not depending on the result
+// of the previous step (b) can be computed in parallel to it.
 #define FF(a, b, c, d, x, s, ac) { \
  (a) += F ((b), (c), (d)) + (x) + uInt32(ac); \
  (a) = ROTATE_LEFT ((a), (s)); \
  (a) += (b); \
   }
 #define GG(a, b, c, d, x, s, ac) { \
- (a) += G ((b), (c), (d)) + (x) + uInt32(ac); \
+ (a) += ((c) & ~(d)) + (x) + uInt32(ac); \
+ (a) += (b) & (d); \
  (a) = ROTATE_LEFT ((a), (s)); \
  (a) += (b); \
   }
@@ -123,7 +125,7 @@ static uInt8 PADDING[64] = {
 // MD5 initialization. Begins an MD5 operation, writing a new context.
 static void MD5Init(MD5_CTX* context)
 {
-  context->count[0] = context->count[1] = 0;
+  context->count = 0;
   /* Load magic initialization constants. */
   context->state[0] = 0x67452301;
   context->state[1] = 0xefcdab89;
@@ -134,63 +136,60 @@ static void MD5Init(MD5_CTX* context)
 // MD5 block update operation. Continues an MD5 message-digest
 // operation, processing another message block, and updating the
 // context.
-static void MD5Update(MD5_CTX* context, const uInt8* input,
-    uInt32 inputLen)
+static void MD5Update(MD5_CTX* context, const uInt8* input, size_t inputLen)
 {
-  uInt32 i, index, partLen;
-
   /* Compute number of bytes mod 64 */
-  index = uInt32((context->count[0] >> 3) & 0x3F);
+  size_t index = size_t(context->count & 0x3F);
 
-  /* Update number of bits */
-  if ((context->count[0] += (uInt32(inputLen) << 3))
-   < (uInt32(inputLen) << 3))
-    context->count[1]++;
-  context->count[1] += (uInt32(inputLen) >> 29);
+  /* Update number of bytes */
+  context->count += inputLen;
 
-  partLen = 64 - index;
+  /* Complete a partially filled buffer first */
+  if (index > 0) {
+    const size_t partLen = std::min<size_t>(64 - index, inputLen);
 
-  /* Transform as many times as possible. */
-  if (inputLen >= partLen) {
-    memcpy (const_cast<POINTER>(&context->buffer[index]),
-            const_cast<POINTER>(input), partLen);
-    MD5Transform (context->state, context->buffer);
-
-    for (i = partLen; i + 63 < inputLen; i += 64)
-      MD5Transform (context->state, &input[i]);
+    memcpy(&context->buffer[index], input, partLen);
+    input += partLen;
+    inputLen -= partLen;
+    index += partLen;
+    if (index < 64)
+      return;
 
-    index = 0;
+    MD5Transform (context->state, context->buffer);
   }
-  else
-    i = 0;
+
+  /* Transform all complete blocks directly from the input */
+  for (; inputLen >= 64; input += 64, inputLen -= 64)
+    MD5Transform (context->state, input);
 
   /* Buffer remaining input */
-  memcpy(const_cast<POINTER>(&context->buffer[index]),
-         const_cast<POINTER>(&input[i]), inputLen-i);
+  if (inputLen > 0)
+    memcpy(context->buffer, input, inputLen);
 }
 
 // MD5 finalization. Ends an MD5 message-digest operation, writing the
-// the message digest and zeroizing the context.
+// the message digest.
 static void MD5Final(uInt8 digest[16], MD5_CTX* context)
 {
-  uInt8 bits[8];
-  uInt32 index, padLen;
+  const uInt64 bitCount = context->count << 3;
+  size_t index = size_t(context->count & 0x3f);
 
-  /* Save number of bits */
-  Encode (bits, context->count, 8);
-
-  /* Pad out to 56 mod 64. */
-  index = uInt32((context->count[0] >> 3) & 0x3f);
-  padLen = (index < 56) ? (56 - index) : (120 - index);
-  MD5Update (context, PADDING, padLen);
+  /* Pad out to 56 mod 64, with a single '1' bit followed by zeros */
+  context->buffer[index++] = 0x80;
+  if (index > 56) {
+    memset(&context->buffer[index], 0, 64 - index);
+    MD5Transform (context->state, context->buffer);
+    index = 0;
+  }
+  memset(&context->buffer[index], 0, 56 - index);
 
   /* Append length (before padding) */
-  MD5Update (context, bits, 8);
+  const uInt32 bits[2] = { uInt32(bitCount), uInt32(bitCount >> 32) };
+  Encode (&context->buffer[56], bits, 8);
+  MD5Transform (context->state, context->buffer);
+
   /* Store state in digest */
   Encode (digest, context->state, 16);
-
-  /* Zeroize sensitive information. */
-  memset (reinterpret_cast<POINTER>(context), 0, sizeof(*context));
 }
 
 // MD5 basic transformation. Transforms state based on block.
@@ -276,14 +275,11 @@ static void MD5Transform(uInt32 state[4], const uInt8 block[64])
   state[1] += b;
   state[2] += c;
   state[3] += d;
-
-  /* Zeroize sensitive information. */
-  memset (reinterpret_cast<POINTER>(x), 0, sizeof(x));
 }
 
 // Encodes input (uInt32) into output (uInt8). Assumes len is
 // a multiple of 4.
-static void Encode(uInt8* output, uInt32* input, uInt32 len)
+static void Encode(uInt8* output, const uInt32* input, uInt32 len)
 {
   uInt32 i, j;
 
@@ -299,18 +295,22 @@ static void Encode(uInt8* output, uInt32* input, uInt32 len)
 // a multiple of 4.
 static void Decode(uInt32* output, const uInt8* input, uInt32 len)
 {
+#ifdef MD5_LITTLE_ENDIAN
+  // Compiles to plain (unaligned) word loads
+  memcpy(output, input, len);
+#else
   uInt32 i, j;
 
   for (i = 0, j = 0; j < len; ++i, j += 4)
     output[i] = (uInt32(input[j])) | ((uInt32(input[j+1])) << 8) |
     ((uInt32(input[j+2])) << 16) | ((uInt32(input[j+3])) << 24);
+#endif
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string hash(const string& buffer)
 {
-  std::vector<uint8_t> vec(buffer.begin(), buffer.end());
-
-  return hash(vec.data(), vec.size());
+  return hash(reinterpret_cast<const uInt8*>(buffer.data()), buffer.size());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -322,23 +322,22 @@ string hash(const ByteBuffer& buffer, size_t length)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string hash(const uInt8* buffer, size_t length)
 {
-  char hex[] = "0123456789abcdef";
+  static constexpr char hex[] = "0123456789abcdef";
   MD5_CTX context;
   uInt8 md5[16];
-  uInt32 len32 = static_cast<uInt32>(length);  // Always use 32-bit for now
 
   MD5Init(&context);
-  MD5Update(&context, buffer, len32);
+  MD5Update(&context, buffer, length);
   MD5Final(md5, &context);
 
-  string result;
+  char result[32];
   for(int t = 0; t < 16; ++t)
   {
-    result += hex[(md5[t] >> 4) & 0x0f];
-    result += hex[md5[t] & 0x0f];
+    result[t * 2]     = hex[(md5[t] >> 4) & 0x0f];
+    result[t * 2 + 1] = hex[md5[t] & 0x0f];
   }
 
-  return result;
+  return string(result, 32);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
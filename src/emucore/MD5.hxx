@@ -28,11 +28,6 @@ namespace MD5 {
     Get the MD5 Message-Digest of the specified message with the
     given length.  The digest consists of 32 hexadecimal digits.
 
-    Note that currently, the length is truncated internally to
-    32 bits, until the MD5 routines are rewritten for 64-bit.
-    Based on the size of data we currently use, this may never
-    actually happen.
-
     @param buffer The message to compute the digest of
     @param length The length of the message
     @return The message-digest
@@ -16,8 +16,10 @@
 //============================================================================
 
 #include <cstdio>
+#include <fstream>
 
 #include "System.hxx"
+#include "StorageWorker.hxx"
 #include "MT24LC256.hxx"
 
 //#define DEBUG_EEPROM
@@ -50,24 +52,24 @@ MT24LC256::MT24LC256(const FilesystemNode& eepromfile, const System& system,
     myDataFile{eepromfile}
 {
   // Load the data from an external file (if it exists)
-  bool fileValid = false;
   try
   {
     // A valid file must be 32768 bytes; otherwise we create a new one
     if(myDataFile.read(myData) == FLASH_SIZE)
-      fileValid = true;
+      myDataFileValid = true;
   }
   catch(...)
   {
-    fileValid = false;
+    myDataFileValid = false;
   }
 
-  if(!fileValid)
+  // A new file is written completely
+  myPageDirty.fill(!myDataFileValid);
+  if(!myDataFileValid)
   {
     myData = make_unique<uInt8[]>(FLASH_SIZE);
     std::fill_n(myData.get(), FLASH_SIZE, INITIAL_VALUE);
-    myDataChanged = true;
-   }
+  }
 
   // Then initialize the I2C state
   jpee_init();
@@ -78,12 +80,10 @@ MT24LC256::MT24LC256(const FilesystemNode& eepromfile, const System& system,
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 MT24LC256::~MT24LC256()
 {
-  // Save EEPROM data to external file only when necessary
-  if(myDataChanged)
-  {
-    try { myDataFile.write(myData, FLASH_SIZE); }
-    catch(...) { }
-  }
+  // Wait for a running write-back, then save the remaining changes
+  myWriteTimer->clear();
+  StorageWorker::instance().flush();
+  writeBack();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -139,19 +139,24 @@ void MT24LC256::systemReset()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void MT24LC256::eraseAll()
 {
+  std::lock_guard<std::mutex> lock(myDataMutex);
+
   std::fill_n(myData.get(), FLASH_SIZE, INITIAL_VALUE);
-  myDataChanged = true;
+  for(uInt32 page = 0; page < PAGE_NUM; ++page)
+    setPageDirty(page);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void MT24LC256::eraseCurrent()
 {
+  std::lock_guard<std::mutex> lock(myDataMutex);
+
   for(uInt32 page = 0; page < PAGE_NUM; ++page)
   {
     if(myPageHit[page])
     {
       std::fill_n(myData.get() + page * PAGE_SIZE, PAGE_SIZE, INITIAL_VALUE);
-      myDataChanged = true;
+      setPageDirty(page);
     }
   }
 }
@@ -165,6 +170,73 @@ bool MT24LC256::isPageUsed(uInt32 page) const
     return false;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MT24LC256::setPageDirty(uInt32 page)
+{
+  myPageDirty[page] = true;
+
+  if(!myWritePending)
+  {
+    myWritePending = true;
+    // The timer only delays, the file is written by the storage worker
+    myWriteTimer->setTimeout([this]() {
+      StorageWorker::instance().enqueue(myDataFile.getPath(), [this]() { writeBack(); });
+    }, WRITE_DELAY);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MT24LC256::writeBack()
+{
+  // Take a snapshot of the data, so that the emulation does not have
+  // to wait for the file to be written
+  ByteBuffer data;
+  std::array<bool, PAGE_NUM> dirty;
+  bool wholeFile = false;
+  {
+    std::lock_guard<std::mutex> lock(myDataMutex);
+
+    myWritePending = false;
+    if(std::none_of(myPageDirty.begin(), myPageDirty.end(),
+                    [](bool d) { return d; }))
+      return;
+
+    data = make_unique<uInt8[]>(FLASH_SIZE);
+    std::copy_n(myData.get(), FLASH_SIZE, data.get());
+    dirty = myPageDirty;
+    myPageDirty.fill(false);
+    wholeFile = !myDataFileValid;
+  }
+
+  // Only the modified pages are written to an existing file
+  if(!wholeFile)
+  {
+    std::fstream out(myDataFile.getPath(),
+                     std::ios::in | std::ios::out | std::ios::binary);
+    for(uInt32 page = 0; page < PAGE_NUM && out; ++page)
+    {
+      if(dirty[page])
+      {
+        out.seekp(page * PAGE_SIZE);
+        out.write(reinterpret_cast<const char*>(data.get() + page * PAGE_SIZE),
+                  PAGE_SIZE);
+      }
+    }
+    out.flush();
+    wholeFile = !out;
+  }
+
+  if(wholeFile)
+  {
+    bool valid = false;
+    try { valid = myDataFile.write(data, FLASH_SIZE) == FLASH_SIZE; }
+    catch(...) { }
+
+    std::lock_guard<std::mutex> lock(myDataMutex);
+    myDataFileValid = valid;
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void MT24LC256::jpee_init()
 {
@@ -228,9 +300,10 @@ void MT24LC256::jpee_data_stop()
       jpee_pptr = 4+jpee_pagemask-(jpee_address & jpee_pagemask);
       JPEE_LOG1("I2C_WARNING PAGECROSSING!(Truncate to %d bytes)",jpee_pptr-3)
     }
+    std::lock_guard<std::mutex> lock(myDataMutex);
     for (int i=3; i<jpee_pptr; i++)
     {
-      myDataChanged = true;
+      setPageDirty(jpee_address / PAGE_SIZE);
       myPageHit[jpee_address / PAGE_SIZE] = true;
 
       myCallback("AtariVox/SaveKey EEPROM write");
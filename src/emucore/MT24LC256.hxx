@@ -20,8 +20,11 @@
 
 class System;
 
+#include <mutex>
+
 #include "Control.hxx"
 #include "FSNode.hxx"
+#include "TimerManager.hxx"
 #include "bspf.hxx"
 
 /**
@@ -29,6 +32,9 @@ class System;
   Erasable PROM accessed using the I2C protocol.  Thanks to J. Payson
   (aka Supercat) for the bulk of this code.
 
+  Modified pages are written back to the data file in the background,
+  shortly after they have been changed.
+
   @author  Stephen Anthony & J. Payson
 */
 class MT24LC256
@@ -54,6 +60,10 @@ class MT24LC256
     // Initial state value of flash EEPROM
     static constexpr uInt8 INITIAL_VALUE = 0xff;
 
+    // Delay (in ms) between the first change and writing back the data;
+    // all changes within this period are written at once
+    static constexpr TimerManager::millisec WRITE_DELAY = 1000;
+
     /** Read boolean data from the SDA line */
     bool readSDA() const { return jpee_mdat && jpee_sdat; }
 
@@ -84,6 +94,13 @@ class MT24LC256
 
     void update();
 
+    // Mark the page as modified and schedule its write-back; you must be
+    // holding the 'myDataMutex' lock to call this
+    void setPageDirty(uInt32 page);
+
+    // Write all modified pages to the data file
+    void writeBack();
+
   private:
     // The system of the parent controller
     const System& mySystem;
@@ -113,8 +130,21 @@ class MT24LC256
     // The file containing the EEPROM data
     FilesystemNode myDataFile;
 
-    // Indicates if the EEPROM has changed since class invocation
-    bool myDataChanged{false};
+    // Indicates that the data file has the expected size, so that single
+    // pages can be written
+    bool myDataFileValid{false};
+
+    // Track which pages have to be written to the data file
+    std::array<bool, PAGE_NUM> myPageDirty;
+
+    // Indicates that a write-back has been scheduled
+    bool myWritePending{false};
+
+    // Guards the EEPROM data and the dirty pages against the write-back
+    std::mutex myDataMutex;
+
+    // Runs the write-back in the background
+    unique_ptr<TimerManager> myWriteTimer{make_unique<TimerManager>()};
 
     // Required for I2C functionality
     Int32 jpee_mdat{0}, jpee_sdat{0}, jpee_mclk{0};
@@ -0,0 +1,74 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "MemoryUsage.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t MemoryUsage::total() const
+{
+  size_t total = 0;
+  for(size_t bytes: myBytes)
+    total += bytes;
+
+  return total;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string MemoryUsage::toString() const
+{
+  ostringstream buf;
+
+  for(uInt32 i = 0; i < NUM_CATEGORIES; ++i)
+    buf << std::left << std::setw(18) << name(Category(i)) << std::right
+        << std::setw(10) << formatBytes(myBytes[i]) << "\n";
+  buf << std::left << std::setw(18) << "Total" << std::right
+      << std::setw(10) << formatBytes(total());
+
+  return buf.str();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string MemoryUsage::name(Category category)
+{
+  switch(category)
+  {
+    case Category::romImage:     return "ROM image";
+    case Category::cartRAM:      return "Cart RAM";
+    case Category::accessArrays: return "Access tracking";
+    case Category::states:       return "Save states";
+    case Category::tiaBuffers:   return "TIA buffers";
+    case Category::surfaces:     return "Surfaces";
+    case Category::fonts:        return "Fonts";
+    case Category::audioQueue:   return "Audio queue";
+    default:                     return "";
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string MemoryUsage::formatBytes(size_t bytes)
+{
+  ostringstream buf;
+
+  if(bytes < 1024)
+    buf << bytes << " B";
+  else if(bytes < 1024 * 1024)
+    buf << std::fixed << std::setprecision(1) << bytes / 1024.0 << " KB";
+  else
+    buf << std::fixed << std::setprecision(1) << bytes / (1024.0 * 1024.0) << " MB";
+
+  return buf.str();
+}
@@ -0,0 +1,76 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef MEMORY_USAGE_HXX
+#define MEMORY_USAGE_HXX
+
+#include "bspf.hxx"
+
+/**
+  The memory held by a console and the frontend parts serving it, summed up
+  per category.  Each component adds what it owns; shared data (e.g. a ROM
+  image shared by forked consoles) is reported by every owner.
+
+  The numbers are the sizes of the allocated buffers, not including
+  allocator overhead or the (small) objects holding them.
+
+  @author  Stella Team
+*/
+class MemoryUsage
+{
+  public:
+    enum class Category: uInt8 {
+      romImage,       // the ROM image, and copies of it
+      cartRAM,        // RAM on the cartridge
+      accessArrays,   // debugger access flags and counters
+      states,         // rewind states and checkpoints
+      tiaBuffers,     // emulated and post-processed frames
+      surfaces,       // surfaces and their textures
+      fonts,          // rasterized GUI fonts
+      audioQueue,     // audio fragments
+      numCategories
+    };
+    static constexpr uInt32 NUM_CATEGORIES = uInt32(Category::numCategories);
+
+  public:
+    MemoryUsage() = default;
+
+    void add(Category category, size_t bytes) {
+      myBytes[uInt32(category)] += bytes;
+    }
+
+    size_t bytes(Category category) const { return myBytes[uInt32(category)]; }
+
+    size_t total() const;
+
+    /**
+      A table with one line per category, and the total.
+    */
+    string toString() const;
+
+    static string name(Category category);
+
+    /**
+      Format the given size as bytes, KB or MB.
+    */
+    static string formatBytes(size_t bytes);
+
+  private:
+    std::array<size_t, NUM_CATEGORIES> myBytes{0};
+};
+
+#endif
@@ -0,0 +1,390 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <chrono>
+
+#include "MicroBenchmark.hxx"
+#include "AtariNTSC.hxx"
+#include "FSNode.hxx"
+#include "HeadlessConsole.hxx"
+#include "Logger.hxx"
+#include "Missile.hxx"
+#include "Player.hxx"
+#include "Thumbulator.hxx"
+#include "TIAConstants.hxx"
+#include "DelayQueue.hxx"
+#include "json_lib.hxx"
+
+using namespace std::chrono;
+using json = nlohmann::json;
+
+namespace {
+  // Clocks per scanline during which the TIA objects are ticked
+  constexpr uInt32 CLOCKS_PER_LINE = TIAConstants::H_PIXEL;
+
+  // Address of the ARM code, clear of the addresses the cartridge drivers
+  // intercept
+  constexpr uInt32 THUMB_CODE = 0x1000;
+  constexpr uInt32 THUMB_ROM_SIZE = 0x2000;
+
+  // The ARM programs loop this many times; a single run must stay below
+  // the Thumbulator's instruction limit
+  constexpr uInt32 THUMB_LOOPS = 1 << 12;
+
+  struct ThumbProgram {
+    const char* name;
+    uInt32 instructionsPerLoop;
+    vector<uInt16> code;
+  };
+
+  // Each program returns by branching to the (even) link register
+  const std::array<ThumbProgram, 3> THUMB_PROGRAMS = {{
+    { "alu", 6, {
+      0x2000,   // movs r0, #0
+      0x2101,   // movs r1, #1
+      0x0309,   // lsls r1, r1, #12
+      0x1840,   // loop: adds r0, r0, r1
+      0x4042,   // eors r2, r0
+      0x00D3,   // lsls r3, r2, #3
+      0x4358,   // muls r0, r3
+      0x3901,   // subs r1, #1
+      0xD1F9,   // bne loop
+      0x4770    // bx lr
+    }},
+    { "memory", 7, {
+      0x4C05,   // ldr r4, =0x40001000
+      0x2101,   // movs r1, #1
+      0x0309,   // lsls r1, r1, #12
+      0x6825,   // loop: ldr r5, [r4, #0]
+      0x3501,   // adds r5, #1
+      0x6065,   // str r5, [r4, #4]
+      0x7866,   // ldrb r6, [r4, #1]
+      0x70E6,   // strb r6, [r4, #3]
+      0x3901,   // subs r1, #1
+      0xD1F8,   // bne loop
+      0x4770,   // bx lr
+      0x0000,
+      0x1000, 0x4000
+    }},
+    { "call", 6, {
+      0x4677,   // mov r7, lr
+      0x2101,   // movs r1, #1
+      0x0309,   // lsls r1, r1, #12
+      0xF000,   // loop: bl sub
+      0xF803,
+      0x3901,   // subs r1, #1
+      0xD1FB,   // bne loop
+      0x4738,   // bx r7
+      0x3001,   // sub: adds r0, #1
+      0x4770    // bx lr
+    }}
+  }};
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+MicroBenchmark::MicroBenchmark(int argc, char* argv[])
+{
+  for (int i = 2; i < argc; i++) {
+    string arg = argv[i];
+
+    if (arg == "-json")
+      myJsonOutput = true;
+    else if (arg == "-filter" && i + 1 < argc)
+      myFilter = argv[++i];
+    else if (arg == "-mintime" && i + 1 < argc)
+      myMinTime = std::max(BSPF::stringToInt(argv[++i]), 1) / 1000.;
+    else
+      myRomFile = arg;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+MicroBenchmark::~MicroBenchmark()
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MicroBenchmark::run()
+{
+  if (myRomFile.empty()) throw runtime_error("no ROM given");
+
+  Logger::instance().setLogParameters(Logger::Level::ERR, false);
+
+  // Run the ROM for a while, so that the benchmarks see a typical state
+  myConsole = make_unique<HeadlessConsole>(FilesystemNode(myRomFile));
+  for (uInt32 frame = 0; frame < 60; ++frame)
+    if (!myConsole->emulateFrame())
+      throw runtime_error("emulation failed after " + std::to_string(frame) + " frames");
+
+  myWidth = myConsole->tia().width();
+  myHeight = myConsole->tia().height();
+  myFrame.assign(myConsole->frameBuffer(), myConsole->frameBuffer() + myWidth * myHeight);
+
+  registerBenchmarks();
+
+  json report = json::array();
+
+  for (const auto& benchmark : myBenchmarks) {
+    if (benchmark.name.find(myFilter) == string::npos) continue;
+
+    const Result result = measure(benchmark);
+    const double time = result.realtime / result.operations;
+
+    if (!myJsonOutput) {
+      cout << std::left << std::setw(32) << result.name << std::right << std::fixed
+           << std::setprecision(2) << std::setw(12) << 1e9 * time << " ns/op"
+           << std::setw(14) << result.operations << " ops" << endl;
+
+      continue;
+    }
+
+    report.push_back({
+      {"name", result.name},
+      {"operations", result.operations},
+      {"wallTime", result.realtime},
+      {"nsPerOperation", 1e9 * time}
+    });
+  }
+
+  if (myJsonOutput) cout << report.dump(2) << endl;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MicroBenchmark::registerBenchmarks()
+{
+  registerSystemBenchmarks();
+  registerTIABenchmarks();
+  registerRIOTBenchmarks();
+  registerThumbBenchmarks();
+  registerNTSCBenchmarks();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MicroBenchmark::registerSystemBenchmarks()
+{
+  System& system = myConsole->system();
+
+  // Address ranges of the devices, as decoded by the System
+  constexpr std::array<std::tuple<const char*, uInt16, uInt16>, 4> ranges = {{
+    { "tia",  0x0000, 0x0040 },
+    { "ram",  0x0080, 0x0080 },
+    { "riot", 0x0280, 0x0020 },
+    { "cart", 0x1000, 0x1000 }
+  }};
+
+  for (const auto& [device, base, size] : ranges) {
+    add(string("System::peek/") + device, [&system, base = base, size = size](uInt64 iterations) {
+      uInt64 sum = 0;
+      for (uInt64 i = 0; i < iterations; ++i)
+        sum += system.peek(base + (i % size));
+
+      return sum;
+    });
+  }
+
+  // Pokes to the cart area would trigger bankswitching or write to
+  // extended RAM instead
+  for (const auto& [device, base, size] : ranges) {
+    if (base == 0x1000) continue;
+
+    add(string("System::poke/") + device, [&system, base = base, size = size](uInt64 iterations) {
+      for (uInt64 i = 0; i < iterations; ++i)
+        system.poke(base + (i % size), uInt8(i));
+
+      return iterations;
+    });
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MicroBenchmark::registerTIABenchmarks()
+{
+  // Sized as in the TIA
+  using Queue = DelayQueue<16, 16>;
+
+  // The number of writes scheduled per clock
+  for (uInt32 writes : {0, 1, 4}) {
+    auto queue = make_shared<Queue>();
+
+    add("DelayQueue::push+execute/" + std::to_string(writes),
+        [queue, writes](uInt64 iterations) {
+      uInt64 sum = 0;
+      const auto executor = [&sum](uInt8 address, uInt8 value) { sum += address ^ value; };
+
+      for (uInt64 i = 0; i < iterations; ++i) {
+        // Writes go to the TIA registers, as in the emulation
+        for (uInt32 w = 0; w < writes; ++w)
+          queue->push(uInt8((i * writes + w) % 0x40), uInt8(i), 1 + (i + w) % 8);
+
+        queue->execute(executor);
+      }
+
+      return sum;
+    });
+  }
+
+  TIA& tia = myConsole->tia();
+
+  // NUSIZ: one copy, three close copies, quad width
+  for (uInt8 nusiz : {0x00, 0x03, 0x07}) {
+    auto player = make_shared<Player>(0x7FFF);
+    player->setTIA(&tia);
+    player->grp(0xA5);
+    player->nusiz(nusiz, true);
+
+    add("Player::tick/nusiz" + std::to_string(nusiz), [player](uInt64 iterations) {
+      uInt64 sum = 0;
+      for (uInt64 i = 0; i < iterations; ++i) {
+        player->tick();
+        sum += player->collision;
+
+        if (i % CLOCKS_PER_LINE == CLOCKS_PER_LINE - 1) player->nextLine();
+      }
+
+      return sum;
+    });
+  }
+
+  // Disabled and enabled, with the widest size while enabled
+  for (bool enabled : {false, true}) {
+    auto missile = make_shared<Missile>(0x7FFF);
+    missile->setTIA(&tia);
+    missile->nusiz(0x30);
+    missile->enam(enabled ? 0x02 : 0x00);
+
+    add(string("Missile::tick/") + (enabled ? "enabled" : "disabled"),
+        [missile](uInt64 iterations) {
+      uInt64 sum = 0;
+      for (uInt64 i = 0; i < iterations; ++i) {
+        missile->tick(uInt8(i % CLOCKS_PER_LINE));
+        sum += missile->collision;
+
+        if (i % CLOCKS_PER_LINE == CLOCKS_PER_LINE - 1) missile->nextLine();
+      }
+
+      return sum;
+    });
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MicroBenchmark::registerRIOTBenchmarks()
+{
+  M6532& riot = myConsole->riot();
+
+  add("M6532::update", [&riot](uInt64 iterations) {
+    for (uInt64 i = 0; i < iterations; ++i)
+      riot.update();
+
+    return iterations;
+  });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MicroBenchmark::registerThumbBenchmarks()
+{
+  for (const auto& program : THUMB_PROGRAMS) {
+    // The ROM and RAM have to outlive the Thumbulator
+    auto rom = make_shared<vector<uInt16>>(THUMB_ROM_SIZE / 2, 0);
+    auto ram = make_shared<vector<uInt16>>(RAMSIZE / 2, 0);
+    std::copy(program.code.cbegin(), program.code.cend(), rom->begin() + THUMB_CODE / 2);
+
+    // No cartridge is needed, since the programs don't call into the driver
+    auto thumb = make_shared<Thumbulator>(
+      rom->data(), ram->data(), THUMB_ROM_SIZE, 0, THUMB_CODE, 0x40007ff0,
+      true, 1.0, Thumbulator::ConfigureFor::DPCplus, nullptr);
+
+    // One iteration is one run of the program
+    add(string("Thumbulator/") + program.name, [rom, ram, thumb](uInt64 iterations) {
+      uInt64 sum = 0;
+      for (uInt64 i = 0; i < iterations; ++i) {
+        uInt32 cycles = 0;
+        thumb->run(cycles, false);
+        sum += cycles;
+      }
+
+      return sum;
+    }, uInt64(THUMB_LOOPS) * program.instructionsPerLoop);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MicroBenchmark::registerNTSCBenchmarks()
+{
+  // Any palette will do, the filter cost does not depend on it
+  PaletteArray palette;
+  for (uInt32 i = 0; i < palette.size(); ++i)
+    palette[i] = ((i * 0x1f) & 0xff) << 16 | ((i * 0x3b) & 0xff) << 8 | (i & 0xff);
+
+  const std::array<std::pair<const char*, const AtariNTSC::Setup*>, 2> presets = {{
+    { "composite", &AtariNTSC::TV_Composite },
+    { "rgb",       &AtariNTSC::TV_RGB       }
+  }};
+
+  const uInt32 pitch = AtariNTSC::outWidth(myWidth) * sizeof(uInt32);
+  auto output = make_shared<vector<uInt32>>(size_t(AtariNTSC::outWidth(myWidth)) * myHeight);
+
+  for (const auto& [preset, setup] : presets) {
+    auto ntsc = make_shared<AtariNTSC>();
+    ntsc->initialize(*setup);
+    ntsc->setPalette(palette);
+    ntsc->setRenderThreads(1);
+
+    // One iteration is one frame
+    add(string("AtariNTSC::render/") + preset, [this, ntsc, output, pitch](uInt64 iterations) {
+      for (uInt64 i = 0; i < iterations; ++i)
+        ntsc->render(myFrame.data(), myWidth, myHeight, output->data(), pitch, nullptr);
+
+      return uInt64(output->front());
+    });
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MicroBenchmark::add(const string& name, const Body& body, uInt64 operations)
+{
+  myBenchmarks.push_back({name, body, operations});
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+MicroBenchmark::Result MicroBenchmark::measure(const Benchmark& benchmark) const
+{
+  // Keeps the results alive
+  static volatile uInt64 sink = 0;
+
+  Result result;
+  result.name = benchmark.name;
+
+  // Warm up the caches
+  sink = sink + benchmark.body(1);
+
+  for (uInt64 iterations = 1; ; iterations *= 2) {
+    const auto start = high_resolution_clock::now();
+    sink = sink + benchmark.body(iterations);
+    const double realtime =
+      duration_cast<duration<double>>(high_resolution_clock::now() - start).count();
+
+    if (realtime >= myMinTime) {
+      result.operations = iterations * benchmark.operations;
+      result.realtime = realtime;
+
+      return result;
+    }
+  }
+}
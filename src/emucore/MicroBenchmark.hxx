@@ -0,0 +1,113 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef MICRO_BENCHMARK_HXX
+#define MICRO_BENCHMARK_HXX
+
+#include <functional>
+
+#include "bspf.hxx"
+
+class HeadlessConsole;
+
+/**
+  Measures individual hot paths of the emulation core in isolation:
+  System::peek and poke dispatch, the TIA DelayQueue, Player and Missile
+  ticks, M6532::update, the Thumbulator and AtariNTSC::render.
+
+  Usage: stella -benchmicro [-json] [-filter <text>] [-mintime <ms>] rom
+
+  Each benchmark is instantiated for a number of parameters, e.g. the
+  address range for peek/poke or the instruction mix for the Thumbulator,
+  and named '<benchmark>/<parameter>'. The ROM provides the machine state
+  for the benchmarks that need one. Every benchmark is repeated with a
+  doubling number of iterations until it has run for at least the minimum
+  time (default 200 ms); the time per operation (an access, a clock, an ARM
+  instruction, a frame) is reported. With
+  '-filter' only the benchmarks whose name contains the given text are
+  run. With '-json' a machine-readable report is written to stdout.
+*/
+class MicroBenchmark
+{
+  public:
+
+    MicroBenchmark(int argc, char* argv[]);
+    ~MicroBenchmark();
+
+    bool run();
+
+  private:
+
+    // Runs the given number of iterations, and returns a value
+    // depending on the work done, so that it can't be optimized away
+    using Body = std::function<uInt64(uInt64 iterations)>;
+
+    struct Benchmark {
+      string name;
+      Body body;
+      // The operations done per iteration, e.g. ARM instructions
+      uInt64 operations{1};
+    };
+
+    struct Result {
+      string name;
+      uInt64 operations{0};
+      double realtime{0};
+    };
+
+  private:
+
+    /**
+      Create all benchmarks; these share the console and captured frame.
+    */
+    void registerBenchmarks();
+
+    void registerSystemBenchmarks();
+    void registerTIABenchmarks();
+    void registerRIOTBenchmarks();
+    void registerThumbBenchmarks();
+    void registerNTSCBenchmarks();
+
+    void add(const string& name, const Body& body, uInt64 operations = 1);
+
+    Result measure(const Benchmark& benchmark) const;
+
+  private:
+
+    string myRomFile;
+    string myFilter;
+    double myMinTime{0.2};
+    bool myJsonOutput{false};
+
+    unique_ptr<HeadlessConsole> myConsole;
+
+    // A frame captured from the ROM (TIA palette indices)
+    uInt32 myWidth{0}, myHeight{0};
+    ByteArray myFrame;
+
+    vector<Benchmark> myBenchmarks;
+
+  private:
+    // Following constructors and assignment operators not supported
+    MicroBenchmark() = delete;
+    MicroBenchmark(const MicroBenchmark&) = delete;
+    MicroBenchmark(MicroBenchmark&&) = delete;
+    MicroBenchmark& operator=(const MicroBenchmark&) = delete;
+    MicroBenchmark& operator=(MicroBenchmark&&) = delete;
+};
+
+#endif // MICRO_BENCHMARK_HXX
@@ -29,6 +29,7 @@
 #endif
 #ifdef DEBUGGER_SUPPORT
   #include "Debugger.hxx"
+  #include "ReverseStepper.hxx"
 #endif
 #ifdef GUI_SUPPORT
   #include "Menu.hxx"
@@ -49,12 +50,19 @@
 #include "TIAConstants.hxx"
 #include "Settings.hxx"
 #include "PropsSet.hxx"
+#include "RomMetadataCache.hxx"
+#include "RomLoader.hxx"
 #include "EventHandler.hxx"
 #include "PNGLibrary.hxx"
 #include "Console.hxx"
 #include "Random.hxx"
 #include "StateManager.hxx"
+#include "RewindManager.hxx"
+#include "Netplay.hxx"
+#include "FrameStreamer.hxx"
+#include "AudioCalibration.hxx"
 #include "TimerManager.hxx"
+#include "ThreadControl.hxx"
 #ifdef GUI_SUPPORT
 #include "HighScoresManager.hxx"
 #endif
@@ -62,6 +70,9 @@
 #include "TIA.hxx"
 #include "DispatchResult.hxx"
 #include "EmulationWorker.hxx"
+#include "FrameProfiler.hxx"
+#include "EventCounters.hxx"
+#include "TraceRecorder.hxx"
 #include "AudioSettings.hxx"
 #include "repository/KeyValueRepositoryNoop.hxx"
 #include "repository/CompositeKeyValueRepositoryNoop.hxx"
@@ -101,6 +112,11 @@ OSystem::OSystem()
   myBuildInfo = info.str();
 
   mySettings = MediaFactory::createSettings();
+  myTurbo = mySettings->handle<bool>("turbo");
+  mySpeed = mySettings->handle<float>("speed");
+  myRunAhead = mySettings->handle<int>("runahead");
+  myTurboRender = mySettings->handle<int>("turborender");
+  myInputRate = mySettings->handle<int>("inputrate");
 
   myPropSet = make_unique<PropertiesSet>();
 
@@ -156,9 +172,11 @@ bool OSystem::initialize(const Settings::Options& options)
   myEventHandler->initialize();
 
   myStateManager = make_unique<StateManager>(*this);
-  myTimerManager = make_unique<TimerManager>();
+  // Our timers are fired by the main loop
+  myTimerManager = make_unique<TimerManager>(false);
 
   myAudioSettings = make_unique<AudioSettings>(*mySettings);
+  myAudioCalibration = make_unique<AudioCalibration>(*this);
 
   // Create the sound object; the sound subsystem isn't actually
   // opened until needed, so this is non-blocking (on those systems
@@ -225,6 +243,7 @@ void OSystem::loadConfig(const Settings::Options& options)
 
   mySettings->setRepository(getSettingsRepository());
   myPropSet->setRepository(getPropertyRepository());
+  myRomCache = make_unique<RomMetadataCache>(getRomCacheRepository());
 
   mySettings->load(options);
 
@@ -238,6 +257,7 @@ void OSystem::loadConfig(const Settings::Options& options)
 
   Logger::instance().setLogParameters(mySettings->getInt("loglevel"),
                                       mySettings->getBool("logtoconsole"));
+  Logger::instance().setHistorySize(mySettings->getInt("loghistory"));
   Logger::debug("Loading config options ...");
 
   // Get updated paths for all configuration files
@@ -461,6 +481,14 @@ string OSystem::createConsole(const FilesystemNode& rom, const string& md5sum,
     }
     myConsole->initializeAudio();
 
+    // Remember the ROM's MD5 and autodetected frame layout ('NTSC*' or 'PAL*')
+    RomMetadataCache::Metadata metadata;
+    const string& format = myConsole->about().DisplayFormat;
+    metadata.md5 = myRomMD5;
+    if(!format.empty() && format.back() == '*')
+      metadata.layout = format.substr(0, format.length() - 1);
+    myRomCache->update(myRomFile, metadata);
+
     string saveOnExit = settings().getString("saveonexit");
     bool devSettings = settings().getBool("dev.settings");
     bool activeTM = settings().getBool(devSettings ? "dev.timemachine" : "plr.timemachine");
@@ -490,11 +518,45 @@ string OSystem::createConsole(const FilesystemNode& rom, const string& md5sum,
     myEventHandler->handleConsoleStartupEvents();
     myConsole->riot().update();
 
+    // Profile the frames of every console separately
+    FrameProfiler::instance().setEnabled(mySettings->getBool("frameprofile"));
+    EventCounters::instance().setEnabled(mySettings->getBool("eventcounters"));
+
     #ifdef DEBUGGER_SUPPORT
       if(mySettings->getBool("debug"))
         myEventHandler->enterDebugMode();
     #endif
 
+    // Start netplay once the console switches are set up from the properties
+    if(!mySettings->getString("netplay").empty())
+    {
+      myNetplay = make_unique<Netplay>(*this);
+
+      const string error = myNetplay->start();
+      if(!error.empty())
+      {
+        Logger::error(error);
+        myFrameBuffer->showTextMessage(error);
+        myNetplay.reset();
+      }
+    }
+
+    const string streamTarget = mySettings->getString("stream");
+    if(!streamTarget.empty())
+    {
+      myFrameStreamer = make_unique<FrameStreamer>();
+
+      const string error = myFrameStreamer->start(streamTarget);
+      if(error.empty())
+        myConsole->tia().setAudioSink(myFrameStreamer.get());
+      else
+      {
+        Logger::error(error);
+        myFrameBuffer->showTextMessage(error);
+        myFrameStreamer.reset();
+      }
+    }
+
     if(!showmessage &&
        settings().getBool(devSettings ? "dev.detectedinfo" : "plr.detectedinfo"))
     {
@@ -518,6 +580,39 @@ bool OSystem::reloadConsole(bool nextrom)
   return createConsole(myRomFile, myRomMD5, false) == EmptyString;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void OSystem::prepareConsole(const FilesystemNode& rom)
+{
+  if(!myRomLoader)
+    myRomLoader = make_unique<RomLoader>();
+
+  myRomLoader->prepare(rom);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+MemoryUsage OSystem::memoryUsage() const
+{
+  MemoryUsage usage;
+
+  if(myConsole)
+  {
+    myConsole->addMemoryUsage(usage);
+    usage.add(MemoryUsage::Category::states,
+              myStateManager->rewindManager().getMemoryUsed());
+  #ifdef DEBUGGER_SUPPORT
+    if(myDebugger)
+      usage.add(MemoryUsage::Category::states,
+                myDebugger->reverseStepper().memoryUsage());
+  #endif
+  }
+  if(myRomLoader)
+    usage.add(MemoryUsage::Category::romImage, myRomLoader->preparedSize());
+  if(myFrameBuffer)
+    myFrameBuffer->addMemoryUsage(usage);
+
+  return usage;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool OSystem::hasConsole() const
 {
@@ -576,6 +671,28 @@ string OSystem::getROMInfo(const FilesystemNode& romfile)
 void OSystem::resetFps()
 {
   myFpsMeter.reset();
+  resetFramePacing();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void OSystem::resetFramePacing()
+{
+  // Pacing needs vsync, as it locks to the time present waits for vblank
+  const int refreshRate = myFrameBuffer ? myFrameBuffer->refreshRate() : 0;
+
+  myDisplayPeriod = refreshRate > 0 ? 1. / refreshRate : 0.;
+
+  if(!myConsole || refreshRate <= 0 || !mySettings->getBool("vsync") ||
+     !mySettings->getBool("framepacing"))
+  {
+    myFramePacer.reset();
+    return;
+  }
+
+  const EmulationTiming& timing = myConsole->emulationTiming();
+
+  myFramePacer.reset(myDisplayPeriod,
+    static_cast<double>(timing.cyclesPerFrame()) / timing.cyclesPerSecond());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -583,10 +700,29 @@ unique_ptr<Console> OSystem::openConsole(const FilesystemNode& romfile, string&
 {
   unique_ptr<Console> console;
 
-  // Open the cartridge image and read it in
+  // Open the cartridge image and read it in, unless this was already done
+  // in the background
   ByteBuffer image;
   size_t size = 0;
-  if((image = openROM(romfile, md5, size)) != nullptr)
+  RomLoader::Rom prepared;
+  if(myRomLoader && myRomLoader->take(romfile, prepared))
+  {
+    image = std::move(prepared.image);
+    size = prepared.size;
+    if(md5 == "")
+      md5 = prepared.md5;
+
+    // Same side-effect as in openROM()
+    myPropSet->loadPerROM(romfile, md5);
+  }
+  else
+  {
+    if(myRomLoader)
+      myRomLoader->cancel();
+    image = openROM(romfile, md5, size);
+  }
+
+  if(image != nullptr)
   {
     // Get a valid set of properties, including any entered on the commandline
     // For initial creation of the Cart, we're only concerned with the BS type
@@ -608,7 +744,8 @@ unique_ptr<Console> OSystem::openConsole(const FilesystemNode& romfile, string&
     string cartmd5 = md5;
     const string& type = props.get(PropType::Cart_Type);
     unique_ptr<Cartridge> cart =
-      CartCreator::create(romfile, image, size, cartmd5, type, *mySettings);
+      CartCreator::create(romfile, image, size, cartmd5, type, *mySettings,
+                          prepared.type);
 
     // Some properties may not have a name set; we can't leave it blank
     if(props.get(PropType::Cart_Name) == EmptyString)
@@ -673,14 +810,70 @@ void OSystem::closeConsole()
 {
   if(myConsole)
   {
+    if(FrameProfiler::enabled())
+      saveFrameProfile();
+
   #ifdef CHEATCODE_SUPPORT
     // If a previous console existed, save cheats before creating a new one
     myCheatManager->saveCheats(myConsole->properties().get(PropType::Cart_MD5));
   #endif
+    myNetplay.reset();
+    if(myFrameStreamer)
+    {
+      myConsole->tia().setAudioSink(nullptr);
+      myFrameStreamer.reset();
+    }
+    myAudioCalibration->cancel(false);
     myConsole.reset();
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void OSystem::saveFrameProfile()
+{
+  FrameProfiler& profiler = FrameProfiler::instance();
+
+  Logger::info(profiler.toString());
+
+  FilesystemNode node(myUserDir.getPath() + "frameprofile.json");
+  stringstream out;
+  out << profiler.toJson() << endl;
+
+  try
+  {
+    node.write(out);
+    Logger::info("Frame profile saved to " + node.getShortPath());
+  }
+  catch(...)
+  {
+    Logger::error("ERROR: Couldn't save frame profile to " + node.getShortPath());
+  }
+
+  // Only report each profile once
+  profiler.setEnabled(false);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void OSystem::saveTrace(const FilesystemNode& node)
+{
+  TraceRecorder& recorder = TraceRecorder::instance();
+
+  recorder.stop();
+
+  stringstream out;
+  out << recorder.toJson() << endl;
+
+  try
+  {
+    node.write(out);
+    Logger::info("Trace saved to " + node.getShortPath());
+  }
+  catch(...)
+  {
+    Logger::error("ERROR: Couldn't save trace to " + node.getShortPath());
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 ByteBuffer OSystem::openROM(const FilesystemNode& rom, string& md5, size_t& size)
 {
@@ -736,28 +929,80 @@ double OSystem::dispatchEmulation(EmulationWorker& emulationWorker)
   const EmulationTiming& timing = myConsole->emulationTiming();
   DispatchResult dispatchResult;
 
+  // In fast forward, frames are emulated faster than the display can show
+  // them. The surplus frames are neither drawn by the TIA nor rendered, so
+  // the emulation speed isn't bounded by the video pipeline.
+  const bool turbo = myTurbo();
+  const bool fastForward = myDisplayPeriod > 0 && (turbo || mySpeed() > 1);
+
   // Check whether we have a frame pending for rendering...
   bool framePending = tia.newFramePending();
-  // ... and copy it to the frame buffer. It is important to do this before
-  // the worker is started to avoid racing.
+  // ... and if it may be presented already (pending frames just pile up)
+  if (framePending && fastForward &&
+      duration<double>(high_resolution_clock::now() - myLastPresent).count() <
+      myDisplayPeriod * 0.9)
+    framePending = false;
+  // ... and pick it up for rendering. Frames are exchanged without locking,
+  // so the worker never has to wait for the renderer.
   if (framePending) {
     myFpsMeter.render(tia.framesSinceLastRender());
+
+    // Display a frame from the future, as computed with the current input
+    const uInt32 runAhead = myRunAhead();
+    if (runAhead > 0) myStateManager->runAhead(runAhead);
+
     tia.renderToFrameBuffer();
+    streamFrame();
   }
 
+  // In turbo mode, most frames are never displayed anyway. Otherwise,
+  // draw about one frame per display refresh.
+  uInt32 renderInterval = 1;
+  if (turbo)
+    renderInterval = myTurboRender();
+  else if (fastForward)
+    renderInterval = std::max(static_cast<uInt32>(myDisplayPeriod *
+      timing.cyclesPerSecond() / timing.cyclesPerFrame()), 1U);
+  emulationWorker.setRenderInterval(renderInterval);
+
+  // To sample input several times per frame, the timeslices are cut into
+  // whole scanlines. Input arriving while the main thread waits for a slice
+  // is then applied at the next scanline boundary after about the time it
+  // was received, instead of once per frame.
+  const uInt32 inputRate = myInputRate();
+  uInt64 maxCycles = timing.maxCyclesPerTimeslice(),
+         minCycles = timing.minCyclesPerTimeslice();
+
+  if (inputRate > 1)
+    maxCycles = minCycles =
+      std::max<uInt64>(timing.cyclesPerFrame() / inputRate / 76, 1) * 76;
+  emulationWorker.setScanlineAligned(inputRate > 1);
+
+  // Frame pacing runs the emulation slightly faster or slower, in order to
+  // finish frames just before the display's vblank
+  const uInt32 cyclesPerSecond = static_cast<uInt32>(timing.cyclesPerSecond() *
+    (turbo ? 1. : myFramePacer.speedFactor()));
+
   // Start emulation on a dedicated thread. It will do its own scheduling to
   // sync 6507 and real time and will run until we stop the worker.
   emulationWorker.start(
-    timing.cyclesPerSecond(),
-    timing.maxCyclesPerTimeslice(),
-    timing.minCyclesPerTimeslice(),
+    cyclesPerSecond,
+    maxCycles,
+    minCycles,
     &dispatchResult,
     &tia
   );
 
   // Render the frame. This may block, but emulation will continue to run on
   // the worker, so the audio pipeline is kept fed :)
-  if (framePending) myFrameBuffer->updateInEmulationMode(myFpsMeter.fps());
+  if (framePending) {
+    TraceRecorder::Scope traceScope("Render", "main");
+    const bool presented = myFrameBuffer->updateInEmulationMode(myFpsMeter.fps());
+    myLastPresent = high_resolution_clock::now();
+
+    // Skipped frames give no feedback about the display's timing
+    if (presented && !turbo) myFramePacer.presented(myFrameBuffer->lastPresentTime());
+  }
 
   // Stop the worker and wait until it has finished
   uInt64 totalCycles = emulationWorker.stop();
@@ -769,6 +1014,8 @@ double OSystem::dispatchEmulation(EmulationWorker& emulationWorker)
 
     case DispatchResult::Status::debugger:
       #ifdef DEBUGGER_SUPPORT
+       // The debugger always needs the current frame
+       tia.setRenderInterval(1);
        myDebugger->start(
           dispatchResult.getMessage(),
           dispatchResult.getAddress(),
@@ -798,12 +1045,65 @@ double OSystem::dispatchEmulation(EmulationWorker& emulationWorker)
 
   // Return the 6507 time used in seconds
   return static_cast<double>(totalCycles) /
-      static_cast<double>(timing.cyclesPerSecond());
+      static_cast<double>(cyclesPerSecond);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double OSystem::dispatchNetplay()
+{
+  if (!myConsole) return 0.;
+
+  TIA& tia(myConsole->tia());
+  const EmulationTiming& timing = myConsole->emulationTiming();
+
+  // Every frame is displayed
+  tia.setRenderInterval(1);
+
+  if (myNetplay->runFrame()) {
+    // Rolled back frames are never displayed
+    myFpsMeter.render(1);
+    tia.renderToFrameBuffer();
+    streamFrame();
+
+    TraceRecorder::Scope traceScope("Render", "main");
+    myFrameBuffer->updateInEmulationMode(myFpsMeter.fps());
+  }
+
+  // While waiting for the peer, the time of a frame passes as well
+  return myNetplay->timeScale() *
+    static_cast<double>(timing.cyclesPerFrame()) /
+    static_cast<double>(timing.cyclesPerSecond());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void OSystem::streamFrame()
+{
+  if(!myFrameStreamer) return;
+
+  TIA& tia(myConsole->tia());
+
+  myFrameStreamer->setSampleRate(myConsole->emulationTiming().audioSampleRate());
+  myFrameStreamer->sendFrame(tia.frameBuffer(), tia.height(),
+                             myFrameBuffer->tiaSurface().rgbPalette());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void OSystem::mainLoop()
 {
+  // Start tracing before any of the traced threads is created
+  const string traceFile = mySettings->getString("trace");
+  if(traceFile != "")
+  {
+    TraceRecorder::instance().start();
+    TraceRecorder::instance().setThreadName("Main");
+  }
+
+  // Set up pinning and priorities before the other threads are started
+  ThreadControl::loadSettings(*mySettings);
+  if(!ThreadControl::apply(ThreadControl::Thread::main))
+    Logger::info("Unable to set the affinity or priority of the threads");
+  myPreciseSleep.setSpinning(mySettings->getBool("precisesleep"));
+
   // 6507 time
   time_point<high_resolution_clock> virtualTime = high_resolution_clock::now();
   // The emulation worker
@@ -813,13 +1113,18 @@ void OSystem::mainLoop()
 
   for(;;)
   {
+    TraceRecorder::Scope traceScope("MainLoop", "main");
+
     bool wasEmulation = myEventHandler->state() == EventHandlerState::EMULATION;
 
     myEventHandler->poll(TimerManager::getTicks());
     if(myQuitLoop) break;  // Exit if the user wants to quit
+    myTimerManager->update();
 
     if (!wasEmulation && myEventHandler->state() == EventHandlerState::EMULATION) {
       myFpsMeter.reset();
+      resetFramePacing();
+      FrameProfiler::instance().skipFrame();
       virtualTime = high_resolution_clock::now();
     }
 
@@ -827,7 +1132,8 @@ void OSystem::mainLoop()
 
     if (myEventHandler->state() == EventHandlerState::EMULATION)
       // Dispatch emulation and render frame (if applicable)
-      timesliceSeconds = dispatchEmulation(emulationWorker);
+      timesliceSeconds = myNetplay
+        ? dispatchNetplay() : dispatchEmulation(emulationWorker);
     else if(myEventHandler->state() == EventHandlerState::PLAYBACK)
     {
       // Playback at emulation speed
@@ -859,11 +1165,22 @@ void OSystem::mainLoop()
       virtualTime = now;
     else if (virtualTime > now) {
       // Wait until we have caught up with 6507 time
-      std::this_thread::sleep_until(virtualTime);
+      TraceRecorder::Scope sleepScope("Sleep", "main");
+      const auto late = myPreciseSleep.waitUntil(virtualTime);
+
+      if(FrameProfiler::enabled())
+        FrameProfiler::instance().add(FrameProfiler::Stage::oversleep,
+                                      duration_cast<FrameProfiler::Clock::duration>(late));
     }
   }
 
   // Cleanup time
+  if(FrameProfiler::enabled())
+    saveFrameProfile();
+
+  if(TraceRecorder::enabled())
+    saveTrace(FilesystemNode(traceFile));
+
 #ifdef CHEATCODE_SUPPORT
   if(myConsole)
     myCheatManager->saveCheats(myConsole->properties().get(PropType::Cart_MD5));
@@ -23,9 +23,14 @@ class FrameBuffer;
 class EventHandler;
 class Properties;
 class PropertiesSet;
+class RomMetadataCache;
+class RomLoader;
 class Random;
 class Sound;
 class StateManager;
+class Netplay;
+class FrameStreamer;
+class AudioCalibration;
 class TimerManager;
 class HighScoresManager;
 class EmulationWorker;
@@ -55,8 +60,11 @@ class AudioSettings;
 #include "FrameBufferConstants.hxx"
 #include "EventHandlerConstants.hxx"
 #include "FpsMeter.hxx"
+#include "FramePacer.hxx"
+#include "PreciseSleep.hxx"
 #include "Settings.hxx"
 #include "Logger.hxx"
+#include "MemoryUsage.hxx"
 #include "bspf.hxx"
 #include "repository/KeyValueRepository.hxx"
 #include "repository/CompositeKeyValueRepository.hxx"
@@ -133,6 +141,13 @@ class OSystem
     */
     PropertiesSet& propSet() const { return *myPropSet; }
 
+    /**
+      Get the cache of information derived from ROM files.
+
+      @return The ROM metadata cache object
+    */
+    RomMetadataCache& romCache() const { return *myRomCache; }
+
     /**
       Get the console of the system.  The console won't always exist,
       so we should test if it's available.
@@ -142,6 +157,11 @@ class OSystem
     Console& console() const { return *myConsole; }
     bool hasConsole() const;
 
+    /**
+      Answers whether the current console is played online (see Netplay).
+    */
+    bool netplayActive() const { return myNetplay != nullptr; }
+
     /**
       Get the audio settings object of the system.
 
@@ -149,6 +169,11 @@ class OSystem
     */
     AudioSettings& audioSettings() { return *myAudioSettings; }
 
+    /**
+      Get the calibration of the audio buffering for the current device.
+    */
+    AudioCalibration& audioCalibration() const { return *myAudioCalibration; }
+
   #ifdef GUI_SUPPORT
     /**
       Get the high score manager of the system.
@@ -172,6 +197,12 @@ class OSystem
     */
     TimerManager& timer() const { return *myTimerManager; }
 
+    /**
+      Collect the memory held by the running console, its rewind states and
+      the frame buffer (surfaces, fonts etc.).
+    */
+    MemoryUsage memoryUsage() const;
+
     /**
       This method should be called to save the current settings. It first asks
       each subsystem to update its settings, then it saves all settings to the
@@ -353,6 +384,15 @@ class OSystem
     */
     bool reloadConsole(bool nextrom = true);
 
+    /**
+      Starts reading the given ROM in the background, since it will likely
+      be started next (e.g. because it is selected in the launcher).  This
+      replaces (cancels) any ROM prepared before.
+
+      @param rom  The FSNode of the ROM
+    */
+    void prepareConsole(const FilesystemNode& rom);
+
     /**
       Creates a new ROM launcher, to select a new ROM to emulate.
 
@@ -400,7 +440,7 @@ class OSystem
     void quit() { myQuitLoop = true; }
 
     /**
-      Reset FPS measurement.
+      Reset FPS measurement and frame pacing.
     */
     void resetFps();
 
@@ -446,6 +486,8 @@ class OSystem
 
     virtual shared_ptr<CompositeKeyValueRepositoryAtomic> getHighscoreRepository() = 0;
 
+    virtual shared_ptr<KeyValueRepositoryAtomic> getRomCacheRepository() = 0;
+
   protected:
 
     //////////////////////////////////////////////////////////////////////
@@ -491,6 +533,12 @@ class OSystem
     // Pointer to the PropertiesSet object
     unique_ptr<PropertiesSet> myPropSet;
 
+    // Pointer to the RomMetadataCache object
+    unique_ptr<RomMetadataCache> myRomCache;
+
+    // Pointer to the RomLoader object (only created when used)
+    unique_ptr<RomLoader> myRomLoader;
+
     // Pointer to the (currently defined) Console object
     unique_ptr<Console> myConsole;
 
@@ -538,6 +586,16 @@ class OSystem
     // Pointer to the TimerManager object
     unique_ptr<TimerManager> myTimerManager;
 
+    // Rollback netplay session for the current console, if any
+    unique_ptr<Netplay> myNetplay;
+
+    // Streams the current console to a spectator, if requested
+    unique_ptr<FrameStreamer> myFrameStreamer;
+
+    // Finds the lowest latency audio settings on request (uses the timer
+    // manager, so it must be destroyed first)
+    unique_ptr<AudioCalibration> myAudioCalibration;
+
   #ifdef GUI_SUPPORT
     // Pointer to the HighScoresManager object
     unique_ptr<HighScoresManager> myHighScoresManager;
@@ -561,6 +619,22 @@ class OSystem
     static constexpr uInt32 FPS_METER_QUEUE_SIZE = 100;
     FpsMeter myFpsMeter{FPS_METER_QUEUE_SIZE};
 
+    // Locks emulation to the display's vblank
+    FramePacer myFramePacer;
+
+    // Waits for the deadline of the next timeslice in the main loop
+    PreciseSleep myPreciseSleep;
+
+    // Time between two vblanks of the display (0 if unknown), and the
+    // time the last emulation frame was presented
+    double myDisplayPeriod{0.};
+    std::chrono::time_point<std::chrono::high_resolution_clock> myLastPresent;
+
+    // Settings which are read for every timeslice
+    Settings::Handle<bool> myTurbo;
+    Settings::Handle<float> mySpeed;
+    Settings::Handle<int> myRunAhead, myTurboRender, myInputRate;
+
     // If not empty, a hint for derived classes to use this as the
     // base directory (where all settings are stored)
     // Derived classes are free to ignore it and use their own defaults
@@ -596,6 +670,19 @@ class OSystem
     */
     void closeConsole();
 
+    /**
+      Log the frame profile of the current console, and save it (including
+      all frames in the profiler's window) as 'frameprofile.json' into the
+      user directory.
+    */
+    void saveFrameProfile();
+
+    /**
+      Stop tracing, and save the trace events recorded since the start of
+      the main loop (in Chrome trace event format) into the given file.
+    */
+    void saveTrace(const FilesystemNode& node);
+
     /**
       Gets all possible info about the given console.
 
@@ -606,6 +693,23 @@ class OSystem
 
     double dispatchEmulation(EmulationWorker& emulationWorker);
 
+    /**
+      Emulate and render the next netplay frame on the main thread.  The
+      emulation worker isn't used, as every frame must be emulated with
+      known input.
+    */
+    double dispatchNetplay();
+
+    /**
+      Send the frame just rendered to the spectator, if streaming.
+    */
+    void streamFrame();
+
+    /**
+      Restart frame pacing for the current console and display.
+    */
+    void resetFramePacing();
+
     // Following constructors and assignment operators not supported
     OSystem(const OSystem&) = delete;
     OSystem(OSystem&&) = delete;
@@ -16,6 +16,7 @@
 //============================================================================
 
 #include "StellaDb.hxx"
+#include "repository/KeyValueRepositoryWriteBehind.hxx"
 #include "OSystemStandalone.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -34,7 +35,9 @@ string OSystemStandalone::describePresistence()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 shared_ptr<KeyValueRepository> OSystemStandalone::getSettingsRepository()
 {
-  return shared_ptr<KeyValueRepository>(myStellaDb, &myStellaDb->settingsRepository());
+  // Settings are changed from the UI, which must not wait for the database
+  return make_shared<KeyValueRepositoryWriteBehind>(
+    shared_ptr<KeyValueRepositoryAtomic>(myStellaDb, &myStellaDb->settingsRepository()));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -48,3 +51,9 @@ shared_ptr<CompositeKeyValueRepositoryAtomic> OSystemStandalone::getHighscoreRep
 {
   return shared_ptr<CompositeKeyValueRepositoryAtomic>(myStellaDb, &myStellaDb->highscoreRepository());
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+shared_ptr<KeyValueRepositoryAtomic> OSystemStandalone::getRomCacheRepository()
+{
+  return shared_ptr<KeyValueRepositoryAtomic>(myStellaDb, &myStellaDb->romCacheRepository());
+}
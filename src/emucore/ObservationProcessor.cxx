@@ -0,0 +1,209 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define OBSERVATION_PROCESSOR_SSE2
+#endif
+
+#include <cmath>
+
+#include "ObservationProcessor.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ObservationProcessor::setPalette(const PaletteArray& palette)
+{
+  for(size_t i = 0; i < palette.size(); ++i)
+  {
+    const uInt32 r = (palette[i] >> 16) & 0xff,
+                 g = (palette[i] >> 8) & 0xff,
+                 b = palette[i] & 0xff;
+
+    // ITU-R BT.601 luma
+    myGrayPalette[i] = static_cast<uInt8>((r * 299 + g * 587 + b * 114 + 500) / 1000);
+    myRGBPalette[i] = palette[i] & 0xffffff;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ObservationProcessor::setSize(uInt32 srcWidth, uInt32 srcHeight,
+                                   uInt32 dstWidth, uInt32 dstHeight)
+{
+  mySrcWidth = srcWidth;   mySrcHeight = srcHeight;
+  myDstWidth = dstWidth;   myDstHeight = dstHeight;
+
+  myWeights.clear();
+  calculateSpans(myColumnSpans, srcWidth, dstWidth);
+  calculateSpans(myRowSpans, srcHeight, dstHeight);
+
+  myColumnSums.resize(srcWidth);
+  for(auto& gray: myGray)
+    gray.resize(size_t(srcWidth) * srcHeight);
+  myPooled.resize(size_t(srcWidth) * srcHeight);
+
+  clearHistory();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ObservationProcessor::calculateSpans(vector<Span>& spans,
+                                          uInt32 srcSize, uInt32 dstSize)
+{
+  spans.resize(dstSize);
+  if(srcSize == 0 || dstSize == 0)
+    return;
+
+  const double scale = double(srcSize) / dstSize;
+
+  for(uInt32 d = 0; d < dstSize; ++d)
+  {
+    const double start = d * scale, end = (d + 1) * scale;
+    const uInt32 first = uInt32(start),
+                 last = std::min(uInt32(std::ceil(end)), srcSize) - 1;
+    Span& span = spans[d];
+
+    span.first = first;
+    span.count = last - first + 1;
+    span.weights = uInt32(myWeights.size());
+
+    // Each source pixel contributes by the part of it that is covered
+    Int32 sum = 0;
+    size_t largest = span.weights;
+    for(uInt32 s = first; s <= last; ++s)
+    {
+      const double coverage = std::min(end, s + 1.) - std::max(start, double(s));
+      const auto weight = static_cast<uInt16>(std::lround(coverage / scale * 256));
+
+      myWeights.push_back(weight);
+      sum += weight;
+      if(weight > myWeights[largest])
+        largest = myWeights.size() - 1;
+    }
+    // Rounding must not change the brightness
+    myWeights[largest] = static_cast<uInt16>(myWeights[largest] + 256 - sum);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ObservationProcessor::grayscale(const uInt8* frame, uInt8* out) const
+{
+  const size_t size = size_t(mySrcWidth) * mySrcHeight;
+
+  for(size_t i = 0; i < size; ++i)
+    out[i] = myGrayPalette[frame[i]];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ObservationProcessor::rgb(const uInt8* frame, uInt8* out) const
+{
+  const size_t size = size_t(mySrcWidth) * mySrcHeight;
+
+  for(size_t i = 0; i < size; ++i, out += 3)
+  {
+    const uInt32 pixel = myRGBPalette[frame[i]];
+
+    out[0] = static_cast<uInt8>(pixel >> 16);
+    out[1] = static_cast<uInt8>(pixel >> 8);
+    out[2] = static_cast<uInt8>(pixel);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ObservationProcessor::maxPool(const uInt8* a, const uInt8* b, uInt8* out,
+                                   size_t size)
+{
+  size_t i = 0;
+
+#ifdef OBSERVATION_PROCESSOR_SSE2
+  for(; i + 16 <= size; i += 16)
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+      _mm_max_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                   _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i))));
+#endif
+
+  for(; i < size; ++i)
+    out[i] = std::max(a[i], b[i]);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ObservationProcessor::downsample(const uInt8* gray, uInt8* out)
+{
+  uInt16* sums = myColumnSums.data();
+
+  for(const Span& row: myRowSpans)
+  {
+    // Vertical pass; the weights sum up to 256, so this can't overflow
+    std::fill_n(sums, mySrcWidth, 0);
+    for(uInt32 j = 0; j < row.count; ++j)
+    {
+      const uInt8* src = gray + size_t(row.first + j) * mySrcWidth;
+      const uInt16 weight = myWeights[row.weights + j];
+      uInt32 x = 0;
+
+    #ifdef OBSERVATION_PROCESSOR_SSE2
+      const __m128i zero = _mm_setzero_si128(),
+                    w = _mm_set1_epi16(static_cast<short>(weight));
+
+      for(; x + 16 <= mySrcWidth; x += 16)
+      {
+        const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+        __m128i* lo = reinterpret_cast<__m128i*>(sums + x);
+        __m128i* hi = reinterpret_cast<__m128i*>(sums + x + 8);
+
+        _mm_storeu_si128(lo, _mm_add_epi16(_mm_loadu_si128(lo),
+          _mm_mullo_epi16(_mm_unpacklo_epi8(p, zero), w)));
+        _mm_storeu_si128(hi, _mm_add_epi16(_mm_loadu_si128(hi),
+          _mm_mullo_epi16(_mm_unpackhi_epi8(p, zero), w)));
+      }
+    #endif
+
+      for(; x < mySrcWidth; ++x)
+        sums[x] = static_cast<uInt16>(sums[x] + src[x] * weight);
+    }
+
+    // Horizontal pass
+    for(const Span& column: myColumnSpans)
+    {
+      const uInt16* weights = &myWeights[column.weights];
+      uInt32 sum = 0;
+
+      for(uInt32 i = 0; i < column.count; ++i)
+        sum += uInt32(sums[column.first + i]) * weights[i];
+
+      *out++ = static_cast<uInt8>((sum + 0x8000) >> 16);
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ObservationProcessor::process(const uInt8* frame, uInt8* out)
+{
+  uInt8* gray = myGray[myCurrent].data();
+  const uInt8* pooled = gray;
+
+  grayscale(frame, gray);
+
+  // Objects are often drawn every other frame only (flicker)
+  if(myHasHistory)
+  {
+    maxPool(gray, myGray[myCurrent ^ 1].data(), myPooled.data(), myPooled.size());
+    pooled = myPooled.data();
+  }
+  downsample(pooled, out);
+
+  myCurrent ^= 1;
+  myHasHistory = true;
+}
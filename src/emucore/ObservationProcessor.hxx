@@ -0,0 +1,134 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef OBSERVATION_PROCESSOR_HXX
+#define OBSERVATION_PROCESSOR_HXX
+
+#include "bspf.hxx"
+#include "FrameBufferConstants.hxx"
+
+/**
+  Turns the indexed TIA frame buffer (as provided by TIA::frameBuffer() or
+  HeadlessConsole::frameBuffer()) into compact observations, e.g. for
+  machine learning: grayscale conversion, max-pooling of the last two
+  frames and area downsampling, all written into caller-provided buffers.
+
+  This bypasses the ARGB path of TIASurface entirely; no TV effects are
+  applied.  The palette is only used to derive the grayscale resp. RGB
+  values of the 128 TIA colors.
+*/
+class ObservationProcessor
+{
+  public:
+    ObservationProcessor() = default;
+
+    /**
+      Set the palette (0xRRGGBB entries, indexed like the frame buffer).
+    */
+    void setPalette(const PaletteArray& palette);
+
+    /**
+      Set the dimensions of the source frame and of the downsampled
+      observation.  This also clears the frame history.
+
+      @param srcWidth   Width of the frame buffer (usually H_PIXEL)
+      @param srcHeight  Number of frame buffer lines to use
+      @param dstWidth   Width of the downsampled observation
+      @param dstHeight  Height of the downsampled observation
+    */
+    void setSize(uInt32 srcWidth, uInt32 srcHeight,
+                 uInt32 dstWidth, uInt32 dstHeight);
+
+    /**
+      The complete pipeline: convert the frame to grayscale, max-pool it
+      with the previous frame passed in (if any) and downsample the result.
+
+      @param frame  The indexed frame (srcWidth x srcHeight)
+      @param out    The observation (dstWidth x dstHeight bytes)
+    */
+    void process(const uInt8* frame, uInt8* out);
+
+    /**
+      Forget the previous frame, e.g. after a reset.
+    */
+    void clearHistory() { myHasHistory = false; }
+
+  public:
+    /**
+      Convert an indexed frame (srcWidth x srcHeight) to grayscale.
+    */
+    void grayscale(const uInt8* frame, uInt8* out) const;
+
+    /**
+      Convert an indexed frame (srcWidth x srcHeight) to packed 24 bit RGB.
+    */
+    void rgb(const uInt8* frame, uInt8* out) const;
+
+    /**
+      Downsample a grayscale frame (srcWidth x srcHeight) to the observation
+      size (dstWidth x dstHeight), averaging the covered area.
+    */
+    void downsample(const uInt8* gray, uInt8* out);
+
+    /**
+      Per pixel maximum of two buffers.
+    */
+    static void maxPool(const uInt8* a, const uInt8* b, uInt8* out, size_t size);
+
+  private:
+    // Source pixels (and their weights, summing up to 256) which cover
+    // a destination pixel
+    struct Span {
+      uInt32 first{0};
+      uInt32 count{0};
+      uInt32 weights{0};  // index into myWeights
+    };
+
+    /**
+      Calculate the spans for area scaling 'srcSize' pixels to 'dstSize'.
+    */
+    void calculateSpans(vector<Span>& spans, uInt32 srcSize, uInt32 dstSize);
+
+  private:
+    std::array<uInt8, kColor> myGrayPalette{0};
+    std::array<uInt32, kColor> myRGBPalette{0};
+
+    uInt32 mySrcWidth{0}, mySrcHeight{0};
+    uInt32 myDstWidth{0}, myDstHeight{0};
+
+    vector<Span> myColumnSpans, myRowSpans;
+    vector<uInt16> myWeights;
+
+    // The current row during downsampling, scaled vertically only
+    // (8.8 fixed point)
+    vector<uInt16> myColumnSums;
+
+    // Grayscale of the current and previous frame, and their maximum
+    std::array<vector<uInt8>, 2> myGray;
+    vector<uInt8> myPooled;
+    uInt32 myCurrent{0};
+    bool myHasHistory{false};
+
+  private:
+    // Following constructors and assignment operators not supported
+    ObservationProcessor(const ObservationProcessor&) = delete;
+    ObservationProcessor(ObservationProcessor&&) = delete;
+    ObservationProcessor& operator=(const ObservationProcessor&) = delete;
+    ObservationProcessor& operator=(ObservationProcessor&&) = delete;
+};
+
+#endif // OBSERVATION_PROCESSOR_HXX
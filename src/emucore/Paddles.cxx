@@ -270,7 +270,7 @@ void Paddles::updateMouse(bool& firePressedA, bool& firePressedB)
     // We're in auto mode, where a single axis is used for one paddle only
     myCharge[myMPaddleID] = BSPF::clamp(myCharge[myMPaddleID] -
                                         (myEvent.get(myAxisMouseMotion) * MOUSE_SENSITIVITY),
-                                        TRIGMIN, TRIGRANGE);
+                                        TRIGMIN, TRIGRANGE.load());
     if(myMPaddleID == 0)
       firePressedA = firePressedA
         || myEvent.get(Event::MouseButtonLeftValue)
@@ -288,7 +288,7 @@ void Paddles::updateMouse(bool& firePressedA, bool& firePressedB)
     {
       myCharge[myMPaddleIDX] = BSPF::clamp(myCharge[myMPaddleIDX] -
                                            (myEvent.get(Event::MouseAxisXMove) * MOUSE_SENSITIVITY),
-                                           TRIGMIN, TRIGRANGE);
+                                           TRIGMIN, TRIGRANGE.load());
       if(myMPaddleIDX == 0)
         firePressedA = firePressedA
           || myEvent.get(Event::MouseButtonLeftValue);
@@ -300,7 +300,7 @@ void Paddles::updateMouse(bool& firePressedA, bool& firePressedB)
     {
       myCharge[myMPaddleIDY] = BSPF::clamp(myCharge[myMPaddleIDY] -
                                            (myEvent.get(Event::MouseAxisYMove) * MOUSE_SENSITIVITY),
-                                           TRIGMIN, TRIGRANGE);
+                                           TRIGMIN, TRIGRANGE.load());
       if(myMPaddleIDY == 0)
         firePressedA = firePressedA
           || myEvent.get(Event::MouseButtonRightValue);
@@ -457,13 +457,13 @@ void Paddles::setDigitalPaddleRange(int range)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-int Paddles::XCENTER = 0;
-int Paddles::YCENTER = 0;
-float Paddles::SENSITIVITY = 1.0;
-
-int Paddles::TRIGRANGE = Paddles::TRIGMAX;
-int Paddles::DIGITAL_SENSITIVITY = -1;
-int Paddles::DIGITAL_DISTANCE = -1;
-int Paddles::MOUSE_SENSITIVITY = -1;
-int Paddles::DEJITTER_BASE = 0;
-int Paddles::DEJITTER_DIFF = 0;
+std::atomic<int> Paddles::XCENTER{0};
+std::atomic<int> Paddles::YCENTER{0};
+std::atomic<float> Paddles::SENSITIVITY{1.0F};
+
+std::atomic<int> Paddles::TRIGRANGE{Paddles::TRIGMAX};
+std::atomic<int> Paddles::DIGITAL_SENSITIVITY{-1};
+std::atomic<int> Paddles::DIGITAL_DISTANCE{-1};
+std::atomic<int> Paddles::MOUSE_SENSITIVITY{-1};
+std::atomic<int> Paddles::DEJITTER_BASE{0};
+std::atomic<int> Paddles::DEJITTER_DIFF{0};
@@ -170,7 +170,7 @@ class Paddles : public Controller
     // to paddle resistance
     static constexpr int TRIGMIN = 1;
     static constexpr int TRIGMAX = 4096;
-    static int TRIGRANGE;  // This one is variable for the upper range
+    static std::atomic<int> TRIGRANGE;  // This one is variable for the upper range
 
     // Pre-compute the events we care about based on given port
     // This will eliminate test for left or right port in update()
@@ -190,13 +190,13 @@ class Paddles : public Controller
     int myLastAxisX{0}, myLastAxisY{0};
     int myAxisDigitalZero{0}, myAxisDigitalOne{0};
 
-    static int XCENTER;
-    static int YCENTER;
-    static float SENSITIVITY;
+    static std::atomic<int> XCENTER;
+    static std::atomic<int> YCENTER;
+    static std::atomic<float> SENSITIVITY;
 
-    static int DIGITAL_SENSITIVITY, DIGITAL_DISTANCE;
-    static int DEJITTER_BASE, DEJITTER_DIFF;
-    static int MOUSE_SENSITIVITY;
+    static std::atomic<int> DIGITAL_SENSITIVITY, DIGITAL_DISTANCE;
+    static std::atomic<int> DEJITTER_BASE, DEJITTER_DIFF;
+    static std::atomic<int> MOUSE_SENSITIVITY;
 
     /**
       Swap two events.
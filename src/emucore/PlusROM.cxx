@@ -17,9 +17,35 @@
 
 #include <regex>
 
+#if defined(BSPF_UNIX) || defined(BSPF_MACOS)
+  #include <cerrno>
+  #include <fcntl.h>
+  #include <netdb.h>
+  #include <poll.h>
+  #include <sys/socket.h>
+  #include <sys/types.h>
+  #include <unistd.h>
+  #define PLUSROM_NETWORK
+#endif
+
 #include "bspf.hxx"
+#include "Logger.hxx"
 #include "PlusROM.hxx"
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+PlusROM::~PlusROM()
+{
+  if(myWorker.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lock(myMutex);
+      myStopWorker = true;
+    }
+    myRequestAvailable.notify_one();
+    myWorker.join();
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool PlusROM::initialize(const ByteBuffer& image, size_t size)
 {
@@ -48,8 +74,10 @@ bool PlusROM::initialize(const ByteBuffer& image, size_t size)
   if(i >= size || image[i] != 0 || !isValidHost(host))
     return myIsPlusROM = false;  // Invalid host
 
-  myURL = "http://" + host + "/" + path;
-  cerr << "URL: " << myURL << endl;
+  myHost = host;
+  myPath = "/" + path;
+  myURL = "http://" + host + myPath;
+  Logger::info("PlusROM URL: " + myURL);
   return myIsPlusROM = true;
 }
 
@@ -59,10 +87,16 @@ bool PlusROM::peekHotspot(uInt16 address, uInt8& value)
   switch(address & 0x0FFF)
   {
     case 0x0FF2:  // Read next byte from Rx buffer
-      return false;
+      receive();
+      value = myRxBuffer[myRxReadPos];
+      if(myRxReadPos != myRxWritePos)
+        ++myRxReadPos;
+      return true;
 
     case 0x0FF3:  // Get number of unread bytes in Rx buffer
-      return false;
+      receive();
+      value = myRxWritePos - myRxReadPos;
+      return true;
   }
   return false;
 }
@@ -73,11 +107,14 @@ bool PlusROM::pokeHotspot(uInt16 address, uInt8 value)
   switch(address & 0x0FFF)
   {
     case 0x0FF0:  // Write byte to Tx buffer
-      return false;
+      myTxBuffer[myTxPos++] = value;
+      return true;
 
     case 0x0FF1:  // Write byte to Tx buffer and send to backend
                   // (and receive into Rx buffer)
-      return false;
+      myTxBuffer[myTxPos++] = value;
+      send();
+      return true;
   }
   return false;
 }
@@ -89,6 +126,9 @@ bool PlusROM::save(Serializer& out) const
   {
     out.putByteArray(myRxBuffer.data(), myRxBuffer.size());
     out.putByteArray(myTxBuffer.data(), myTxBuffer.size());
+    out.putByte(myRxReadPos);
+    out.putByte(myRxWritePos);
+    out.putByte(myTxPos);
   }
   catch(...)
   {
@@ -106,6 +146,9 @@ bool PlusROM::load(Serializer& in)
   {
     in.getByteArray(myRxBuffer.data(), myRxBuffer.size());
     in.getByteArray(myTxBuffer.data(), myTxBuffer.size());
+    myRxReadPos = in.getByte();
+    myRxWritePos = in.getByte();
+    myTxPos = in.getByte();
   }
   catch(...)
   {
@@ -140,3 +183,182 @@ bool PlusROM::isValidPath(const string& path) const
 
   return true;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PlusROM::send()
+{
+  // A full buffer wraps around, so a size of 0 means 256 bytes
+  Request request;
+  request.size = myTxPos == 0 ? myTxBuffer.size() : myTxPos;
+  request.data = make_unique<uInt8[]>(request.size);
+  std::copy_n(myTxBuffer.data(), request.size, request.data.get());
+  myTxPos = 0;
+
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myRequests.push_back(std::move(request));
+  }
+  if(!myWorker.joinable())
+    myWorker = std::thread([this]() { run(); });
+  else
+    myRequestAvailable.notify_one();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PlusROM::receive()
+{
+  // Most reads happen without a new response, and must not wait for the
+  // background thread
+  if(myResponseCount.load(std::memory_order_acquire) == 0)
+    return;
+
+  std::deque<string> responses;
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    responses.swap(myResponses);
+    myResponseCount.store(0, std::memory_order_release);
+  }
+
+  // Bytes which don't fit into the Rx buffer are dropped, as on the
+  // real hardware
+  for(const auto& response: responses)
+    for(auto c: response)
+    {
+      if(uInt8(myRxWritePos + 1) == myRxReadPos)
+        break;
+      myRxBuffer[myRxWritePos++] = static_cast<uInt8>(c);
+    }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PlusROM::run()
+{
+  std::unique_lock<std::mutex> lock(myMutex);
+
+  for(;;)
+  {
+    myRequestAvailable.wait(lock, [this]() {
+      return myStopWorker || !myRequests.empty();
+    });
+    if(myStopWorker)
+      return;
+
+    // Requests are sent one after the other, in the order the cart
+    // submitted them, since the host may depend on that
+    Request request = std::move(myRequests.front());
+    myRequests.pop_front();
+
+    lock.unlock();
+    string response;
+    const bool success = transmit(request.data, request.size, response);
+    lock.lock();
+
+    if(success)
+    {
+      myResponses.push_back(std::move(response));
+      myResponseCount.store(uInt32(myResponses.size()),
+                            std::memory_order_release);
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool PlusROM::transmit(const ByteBuffer& request, size_t size,
+                       string& response) const
+{
+#ifdef PLUSROM_NETWORK
+  addrinfo hints{}, *addresses = nullptr;
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  if(getaddrinfo(myHost.c_str(), "80", &hints, &addresses) != 0)
+  {
+    Logger::error("PlusROM: cannot resolve " + myHost);
+    return false;
+  }
+
+  // Connect without blocking, so that an unreachable host times out
+  int fd = -1;
+  for(addrinfo* a = addresses; a != nullptr && fd < 0; a = a->ai_next)
+  {
+    fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+    if(fd < 0)
+      continue;
+
+    const int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+
+    pollfd p{fd, POLLOUT, 0};
+    int error = 0;
+    socklen_t len = sizeof(error);
+    if(connect(fd, a->ai_addr, a->ai_addrlen) == 0 ||
+       (errno == EINPROGRESS && poll(&p, 1, REQUEST_TIMEOUT) == 1 &&
+        getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len) == 0 &&
+        error == 0))
+    {
+      fcntl(fd, F_SETFL, flags);
+    }
+    else
+    {
+      close(fd);
+      fd = -1;
+    }
+  }
+  freeaddrinfo(addresses);
+  if(fd < 0)
+  {
+    Logger::error("PlusROM: cannot connect to " + myHost);
+    return false;
+  }
+
+  timeval timeout{REQUEST_TIMEOUT / 1000, (REQUEST_TIMEOUT % 1000) * 1000};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+  string message =
+    "POST " + myPath + " HTTP/1.0\r\n"
+    "Host: " + myHost + "\r\n"
+    "Content-Type: application/octet-stream\r\n"
+    "Content-Length: " + std::to_string(size) + "\r\n"
+    "Connection: close\r\n\r\n";
+  message.append(reinterpret_cast<const char*>(request.get()), size);
+
+  bool sent = true;
+  for(size_t pos = 0; pos < message.size() && sent; )
+  {
+    const ssize_t n = ::send(fd, message.data() + pos, message.size() - pos, 0);
+    sent = n > 0;
+    if(sent)
+      pos += n;
+  }
+
+  // The connection is closed by the host after the response
+  string reply;
+  if(sent)
+  {
+    std::array<char, 1024> buf;
+    ssize_t n;
+    while((n = recv(fd, buf.data(), buf.size(), 0)) > 0)
+      reply.append(buf.data(), n);
+    sent = n == 0;
+  }
+  close(fd);
+
+  // Expect status 200, and a body consisting of its length and the payload
+  const size_t body = reply.find("\r\n\r\n");
+  const size_t status = reply.find(' ');
+  if(!sent || body == string::npos || status == string::npos ||
+     reply.compare(status + 1, 3, "200") != 0 ||
+     reply.size() < body + 5 ||
+     uInt8(reply[body + 4]) != reply.size() - body - 5)
+  {
+    Logger::error("PlusROM: invalid response from " + myURL);
+    return false;
+  }
+
+  response = reply.substr(body + 5);
+  return true;
+#else
+  Logger::error("PlusROM: networking not supported on this platform");
+  return false;
+#endif
+}
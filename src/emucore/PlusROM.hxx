@@ -18,6 +18,12 @@
 #ifndef PLUSROM_HXX
 #define PLUSROM_HXX
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 #include "bspf.hxx"
 #include "Serializable.hxx"
 
@@ -40,13 +46,17 @@
     $1FF3 contains the number of (unread) bytes left in the receive buffer
       (these bytes can be from multiple responses)
 
+  Requests are sent by a background thread, so that the emulation never
+  waits for the network.  Responses are collected in a completion queue,
+  and moved into the receive buffer the next time the cart reads from it.
+
   @author  Stephen Anthony
 */
 class PlusROM : public Serializable
 {
   public:
     PlusROM() = default;
-    ~PlusROM() override = default;
+    ~PlusROM() override;
 
   public:
     /**
@@ -109,17 +119,68 @@ class PlusROM : public Serializable
     bool load(Serializer& in) override;
 
   private:
+    // Time (in ms) after which a request is abandoned
+    static constexpr int REQUEST_TIMEOUT = 5000;
+
     //////////////////////////////////////////////////////
     // These probably belong in the networking library
     bool isValidHost(const string& host) const;
     bool isValidPath(const string& path) const;
     //////////////////////////////////////////////////////
 
+    /**
+      Queue the contents of the Tx buffer for sending, and start the
+      background thread if necessary.
+    */
+    void send();
+
+    /**
+      Move the responses received so far into the Rx buffer.
+    */
+    void receive();
+
+    /**
+      The background thread's main loop; sends the queued requests in order.
+    */
+    void run();
+
+    /**
+      Send a single request to the host, and wait for the response.
+
+      @param request   The bytes to send
+      @param size      The number of bytes to send
+      @param response  The response payload, without the length byte
+
+      @return  Whether a valid response was received
+    */
+    bool transmit(const ByteBuffer& request, size_t size, string& response) const;
+
   private:
     bool myIsPlusROM{false};
-    string myURL;
+    string myHost, myPath, myURL;
 
     std::array<uInt8, 256> myRxBuffer, myTxBuffer;
+    uInt8 myRxReadPos{0}, myRxWritePos{0}, myTxPos{0};
+
+    // A request waiting to be sent
+    struct Request {
+      ByteBuffer data;
+      size_t size{0};
+    };
+
+    // Requests waiting to be sent, and the responses not yet moved into
+    // the Rx buffer; both are guarded by 'myMutex'
+    std::deque<Request> myRequests;
+    std::deque<string> myResponses;
+    std::mutex myMutex;
+    std::condition_variable myRequestAvailable;
+
+    // Number of responses in 'myResponses', so that the emulation can check
+    // for them without taking the lock
+    std::atomic<uInt32> myResponseCount{0};
+
+    std::thread myWorker;
+    bool myStopWorker{false};
 
   private:
     // Following constructors and assignment operators not supported
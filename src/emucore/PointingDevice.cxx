@@ -149,4 +149,4 @@ void PointingDevice::updateDirection(int counter, float& counterRemainder,
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-float PointingDevice::TB_SENSITIVITY = 1.0;
+std::atomic<float> PointingDevice::TB_SENSITIVITY{1.0F};
@@ -130,7 +130,7 @@ class PointingDevice : public Controller
 
     // User-defined sensitivity; adjustable since end-users may have different
     // mouse speeds
-    static float TB_SENSITIVITY;
+    static std::atomic<float> TB_SENSITIVITY;
 
 private:
     // Following constructors and assignment operators not supported
@@ -15,33 +15,76 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <fstream>
+#include <string_view>
+#include <thread>
 
 #include "ProfilingRunner.hxx"
 #include "FSNode.hxx"
+#include "HeadlessConsole.hxx"
 #include "Cart.hxx"
-#include "CartCreator.hxx"
-#include "MD5.hxx"
-#include "Control.hxx"
-#include "M6502.hxx"
-#include "M6532.hxx"
 #include "TIA.hxx"
 #include "ConsoleTiming.hxx"
-#include "FrameManager.hxx"
-#include "FrameLayoutDetector.hxx"
 #include "EmulationTiming.hxx"
-#include "ConsoleTiming.hxx"
-#include "System.hxx"
-#include "Joystick.hxx"
-#include "Random.hxx"
 #include "DispatchResult.hxx"
+#include "Logger.hxx"
+#include "json_lib.hxx"
 
 using namespace std::chrono;
+using json = nlohmann::json;
 
 namespace {
   static constexpr uInt32 RUNTIME_DEFAULT = 60;
 
+  size_t hashRam(HeadlessConsole& console) {
+    constexpr size_t RAM_SIZE = 128;
+
+    size_t cartRamSize = 0;
+    const uInt8* cartRam = console.cartridge().getRAM(cartRamSize);
+    std::hash<std::string_view> hash;
+
+    return
+      hash({reinterpret_cast<const char*>(console.ram()), RAM_SIZE}) * 31 ^
+      hash({reinterpret_cast<const char*>(cartRam), cartRamSize});
+  }
+
+  json perfReport(const PerfCounters::Values& perf, uInt64 frames) {
+    json report = json::object();
+
+    for (uInt32 i = 0; i < PerfCounters::NUM_COUNTERS; ++i) {
+      const auto counter = PerfCounters::Counter(i);
+      if (!perf.has(counter)) continue;
+
+      report[PerfCounters::name(counter)] = perf[counter];
+      if (frames > 0)
+        report[PerfCounters::name(counter) + "PerFrame"] = double(perf[counter]) / frames;
+    }
+
+    if (perf.has(PerfCounters::Counter::instructions) &&
+        perf.has(PerfCounters::Counter::cycles) && perf[PerfCounters::Counter::cycles] > 0)
+      report["ipc"] = double(perf[PerfCounters::Counter::instructions]) /
+                      perf[PerfCounters::Counter::cycles];
+
+    return report;
+  }
+
+  // Two-sided 95% quantile of Student's t distribution
+  double tQuantile(double degreesOfFreedom) {
+    static constexpr std::array<double, 10> T95{
+      12.71, 4.30, 3.18, 2.78, 2.57, 2.45, 2.36, 2.31, 2.26, 2.23
+    };
+
+    if (degreesOfFreedom < 1) return T95[0];
+    if (degreesOfFreedom <= 10) return T95[uInt32(degreesOfFreedom) - 1];
+    if (degreesOfFreedom <= 20) return 2.09;
+    if (degreesOfFreedom <= 30) return 2.04;
+
+    return 1.96;
+  }
+
   void updateProgress(uInt32 from, uInt32 to) {
     while (from < to) {
       if (from % 10 == 0 && from > 0) cout << from << "%";
@@ -56,12 +99,60 @@ namespace {
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 ProfilingRunner::ProfilingRunner(int argc, char* argv[])
-  : profilingRuns{std::max<size_t>(argc - 2, 0)}
 {
   for (int i = 2; i < argc; i++) {
-    ProfilingRun& run(profilingRuns[i-2]);
-
     string arg = argv[i];
+
+    if (arg == "-threads" && i + 1 < argc) {
+      int threads = BSPF::stringToInt(argv[++i]);
+      myThreads = threads > 0
+        ? threads
+        : std::max(std::thread::hardware_concurrency(), 1U);
+
+      continue;
+    }
+    else if (arg == "-json") {
+      myJsonOutput = true;
+
+      continue;
+    }
+    else if (arg == "-repeat" && i + 1 < argc) {
+      myRepeat = std::max(BSPF::stringToInt(argv[++i]), 1);
+
+      continue;
+    }
+    else if (arg == "-warmup" && i + 1 < argc) {
+      myWarmup = std::max(BSPF::stringToInt(argv[++i]), 0);
+
+      continue;
+    }
+    else if (arg == "-baseline" && i + 1 < argc) {
+      myBaselineFile = argv[++i];
+
+      continue;
+    }
+    else if (arg == "-threshold" && i + 1 < argc) {
+      myThreshold = std::max(BSPF::stringToInt(argv[++i]), 0) / 100.;
+
+      continue;
+    }
+    else if (arg == "-perf") {
+      myPerf = true;
+
+      continue;
+    }
+    else if (arg == "-comparetracking") {
+      myCompareTracking = true;
+
+      continue;
+    }
+    else if (arg == "-comparearm") {
+      myCompareArm = true;
+
+      continue;
+    }
+
+    ProfilingRun run;
     size_t splitPoint = arg.find_first_of(':');
 
     run.romFile = splitPoint == string::npos ? arg : arg.substr(0, splitPoint);
@@ -71,108 +162,547 @@ ProfilingRunner::ProfilingRunner(int argc, char* argv[])
       int runtime = BSPF::stringToInt(arg.substr(splitPoint+1, string::npos));
       run.runtime = runtime > 0 ? runtime : RUNTIME_DEFAULT;
     }
+
+    profilingRuns.push_back(run);
   }
 
-  mySettings.setValue("fastscbios", true);
+  myThreads = std::min<uInt32>(myThreads, std::max<size_t>(profilingRuns.size(), 1));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool ProfilingRunner::run()
 {
-  cout << "Profiling Stella..." << endl;
+  vector<ProfilingResult> results(profilingRuns.size());
+
+  // Keep the JSON report on stdout parseable
+  if (myJsonOutput) Logger::instance().setLogParameters(Logger::Level::ERR, false);
+
+  // Fail before spending any time if the baseline is unusable
+  if (!myBaselineFile.empty() && !loadBaseline()) return false;
+
+  if (!myJsonOutput) cout << "Profiling Stella..." << endl;
+
+  time_point<high_resolution_clock> tp = high_resolution_clock::now();
+
+  if (myThreads <= 1 && !myJsonOutput) {
+    for (size_t i = 0; i < profilingRuns.size(); ++i) {
+      const ProfilingRun& run(profilingRuns[i]);
+
+      cout << endl << "running " << run.romFile << " for " << run.runtime << " seconds..." << endl;
 
-  for (ProfilingRun& run : profilingRuns) {
-    cout << endl << "running " << run.romFile << " for " << run.runtime << " seconds..." << endl;
+      if (!runOne(run, results[i], true)) {
+        cout << "ERROR: " << results[i].error << endl;
+        return false;
+      }
+    }
+  }
+  else {
+    vector<std::thread> workers;
+
+    myNextRun = 0;
+    for (uInt32 i = 0; i < myThreads; ++i)
+      workers.emplace_back(&ProfilingRunner::runWorker, this, std::ref(results));
 
-    if (!runOne(run)) return false;
+    for (auto& worker : workers) worker.join();
   }
 
-  return true;
+  double realtimeUsed = duration_cast<duration<double>>(high_resolution_clock::now () - tp).count();
+
+  for (size_t i = 0; i < results.size(); ++i)
+    compareToBaseline(profilingRuns[i], results[i]);
+
+  printReport(results, realtimeUsed);
+
+  return std::all_of(results.begin(), results.end(),
+    [](const ProfilingResult& result) { return result.ok && !result.regression; });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool ProfilingRunner::runOne(const ProfilingRun& run)
+void ProfilingRunner::runWorker(vector<ProfilingResult>& results)
 {
-  FilesystemNode imageFile(run.romFile);
+  size_t i;
 
-  if (!imageFile.isFile()) {
-    cout << "ERROR: " << run.romFile << " is not a ROM image" << endl;
-    return false;
+  while ((i = myNextRun++) < profilingRuns.size()) {
+    const ProfilingRun& run(profilingRuns[i]);
+    ProfilingResult& result(results[i]);
+
+    try {
+      runOne(run, result, false);
+    }
+    catch (const runtime_error& e) {
+      result.ok = false;
+      result.error = e.what();
+    }
+
+    if (myJsonOutput) continue;
+
+    std::lock_guard<std::mutex> lock(myOutputMutex);
+
+    cout << run.romFile << ": ";
+    if (result.ok) {
+      cout << std::fixed << std::setprecision(2) << result.realtime << " seconds";
+      if (result.samples > 1)
+        cout << " +/- " << result.realtimeCI95;
+      cout << ", " << std::setprecision(0) << (result.cycles / result.realtime) << " cycles/s";
+      if (myCompareTracking)
+        cout << std::setprecision(2) << " (" << result.realtimeTracking
+             << " seconds with access tracking)";
+      if (myCompareArm) {
+        cout << std::setprecision(2) << " (" << result.realtimeArm
+             << " seconds with ARM cycles, ";
+        if (result.armDivergenceFrame)
+          cout << "differs from frame " << result.armDivergenceFrame << ")";
+        else
+          cout << "identical)";
+      }
+    }
+    else
+      cout << "ERROR: " << result.error;
+    cout << endl;
+
+    if (result.ok && myPerf) {
+      cout << "  ";
+      printPerf(result);
+    }
   }
+}
 
-  ByteBuffer image;
-  size_t size = imageFile.read(image);
-  if (size == 0) {
-    cout << "ERROR: unable to read " << run.romFile << endl;
-    return false;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ProfilingRunner::printReport(const vector<ProfilingResult>& results,
+                                  double realtime) const
+{
+  uInt32 failed = 0;
+  uInt64 cycles = 0, frames = 0;
+  double cpuTime = 0;
+
+  for (const auto& result : results) {
+    if (!result.ok) {
+      ++failed;
+      continue;
+    }
+
+    cycles += result.cycles;
+    frames += result.frames;
+    cpuTime += result.realtime;
   }
 
-  string md5 = MD5::hash(image, size);
-  string type = "";
-  unique_ptr<Cartridge> cartridge = CartCreator::create(
-      imageFile, image, size, md5, type, mySettings);
+  if (!myJsonOutput) {
+    if (results.size() > 1)
+      cout << endl << "profiled " << results.size() << " ROMs on " << myThreads
+           << " thread(s), " << failed << " failed" << endl
+           << "wall time: " << realtime << " seconds, accumulated run time: "
+           << cpuTime << " seconds" << endl;
 
-  if (!cartridge) {
-    cout << "ERROR: unable to determine cartridge type" << endl;
-    return false;
+    if (!myBaselineFile.empty()) printComparison(results);
+
+    return;
   }
 
-  IO consoleIO;
-  Random rng(0);
-  Event event;
+  json report = json::object();
+  json runs = json::array();
+
+  for (size_t i = 0; i < results.size(); ++i) {
+    const ProfilingResult& result(results[i]);
+    json entry = json::object();
+
+    entry["rom"] = profilingRuns[i].romFile;
+    entry["runtime"] = profilingRuns[i].runtime;
+    entry["ok"] = result.ok;
+
+    if (result.ok) {
+      entry["layout"] = result.layout;
+      entry["cycles"] = result.cycles;
+      entry["frames"] = result.frames;
+      entry["wallTime"] = result.realtime;
+      entry["samples"] = result.samples;
+      entry["rejectedSamples"] = result.rejected;
+      entry["wallTimeStdDev"] = result.realtimeStdDev;
+      entry["wallTimeCI95"] = result.realtimeCI95;
+      entry["cyclesPerSecond"] = result.cycles / result.realtime;
+      entry["framesPerSecond"] = result.frames / result.realtime;
+      if (myCompareTracking) {
+        entry["trackingWallTime"] = result.realtimeTracking;
+        entry["trackingCyclesPerSecond"] = result.cycles / result.realtimeTracking;
+      }
+      if (myPerf)
+        entry["perf"] = perfReport(result.perf, result.frames);
+      if (myCompareArm) {
+        entry["armWallTime"] = result.realtimeArm;
+        entry["armCyclesPerSecond"] = result.cycles / result.realtimeArm;
+        entry["armTimingDependent"] = result.armDivergenceFrame != 0;
+        if (result.armDivergenceFrame)
+          entry["armDivergenceFrame"] = result.armDivergenceFrame;
+      }
+      if (result.compared)
+        entry["baseline"] = {
+          {"speedChange", result.speedChange},
+          {"significant", result.significant},
+          {"regression", result.regression}
+        };
+    }
+    else
+      entry["error"] = result.error;
+
+    runs.push_back(entry);
+  }
 
-  M6502 cpu(mySettings);
-  M6532 riot(consoleIO, mySettings);
-  TIA tia(consoleIO, []() { return ConsoleTiming::ntsc; }, mySettings);
-  System system(rng, cpu, riot, tia, *cartridge);
+  report["runs"] = runs;
+  report["summary"] = {
+    {"roms", results.size()},
+    {"failed", failed},
+    {"threads", myThreads},
+    {"cycles", cycles},
+    {"frames", frames},
+    {"wallTime", realtime},
+    {"accumulatedTime", cpuTime},
+    {"cyclesPerSecond", realtime > 0 ? cycles / realtime : 0}
+  };
+  if (!myBaselineFile.empty()) {
+    report["summary"]["baseline"] = myBaselineFile;
+    report["summary"]["regressions"] = std::count_if(results.begin(), results.end(),
+      [](const ProfilingResult& result) { return result.regression; });
+  }
+
+  cout << report.dump(2) << endl;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ProfilingRunner::printComparison(const vector<ProfilingResult>& results) const
+{
+  cout << endl << "compared to " << myBaselineFile << " (threshold "
+       << std::setprecision(0) << myThreshold * 100 << "%):" << endl;
+
+  for (size_t i = 0; i < results.size(); ++i) {
+    const ProfilingResult& result(results[i]);
+
+    cout << "  " << profilingRuns[i].romFile << ": ";
+    if (!result.ok)
+      cout << "failed";
+    else if (!result.compared)
+      cout << "not in baseline";
+    else {
+      cout << std::showpos << std::setprecision(1) << result.speedChange * 100
+           << std::noshowpos << "% speed, "
+           << (result.significant ? "significant" : "not significant");
+      if (result.regression) cout << ", REGRESSION";
+    }
+    cout << endl;
+  }
+}
 
-  consoleIO.myLeftControl = make_unique<Joystick>(Controller::Jack::Left, event, system);
-  consoleIO.myRightControl = make_unique<Joystick>(Controller::Jack::Right, event, system);
-  consoleIO.mySwitches = make_unique<Switches>(event, myProps, mySettings);
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ProfilingRunner::printPerf(const ProfilingResult& result) const
+{
+  const PerfCounters::Values& perf = result.perf;
+  const uInt64 frames = std::max<uInt64>(result.frames, 1);
+  bool any = false;
+
+  for (uInt32 i = 0; i < PerfCounters::NUM_COUNTERS; ++i) {
+    const auto counter = PerfCounters::Counter(i);
+    if (!perf.has(counter)) continue;
+
+    cout << (any ? ", " : "") << PerfCounters::name(counter) << ": " << perf[counter]
+         << " (" << std::fixed << std::setprecision(0) << double(perf[counter]) / frames
+         << "/frame)";
+    any = true;
+  }
 
-  tia.bindToControllers();
-  cartridge->setStartBankFromPropsFunc([]() { return -1; });
-  system.initialize();
+  if (!any) {
+    cout << "performance counters not available" << endl;
+    return;
+  }
 
-  FrameLayoutDetector frameLayoutDetector;
-  tia.setFrameManager(&frameLayoutDetector);
-  system.reset();
+  if (perf.has(PerfCounters::Counter::instructions) &&
+      perf.has(PerfCounters::Counter::cycles) && perf[PerfCounters::Counter::cycles] > 0)
+    cout << ", IPC " << std::setprecision(2)
+         << double(perf[PerfCounters::Counter::instructions]) / perf[PerfCounters::Counter::cycles];
 
-  (cout << "detecting frame layout... ").flush();
-  for(int i = 0; i < 60; ++i) tia.update();
+  cout << endl;
+}
 
-  FrameLayout frameLayout = frameLayoutDetector.detectedLayout();
-  ConsoleTiming consoleTiming = ConsoleTiming::ntsc;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ProfilingRunner::runOne(const ProfilingRun& run, ProfilingResult& result,
+                             bool verbose)
+{
+  FilesystemNode imageFile(run.romFile);
 
-  switch (frameLayout) {
-    case FrameLayout::ntsc:
-      cout << "NTSC";
-      consoleTiming = ConsoleTiming::ntsc;
-      break;
+  if (verbose) (cout << "detecting frame layout... ").flush();
 
-    case FrameLayout::pal:
-      cout << "PAL";
-      consoleTiming = ConsoleTiming::pal;
-      break;
+  // Every run gets its own console, including settings, so that runs on
+  // different threads do not share any mutable state
+  unique_ptr<HeadlessConsole> console;
+  try {
+    console = make_unique<HeadlessConsole>(imageFile);
+  }
+  catch (const runtime_error& e) {
+    if (verbose) cout << endl;
+    result.error = e.what();
+    return false;
   }
 
-  (cout << endl).flush();
+  FrameLayout frameLayout = console->frameLayout();
+  ConsoleTiming consoleTiming = console->timing();
 
-  FrameManager frameManager;
-  tia.setFrameManager(&frameManager);
-  tia.setLayout(frameLayout);
+  result.layout = frameLayout == FrameLayout::pal ? "PAL" : "NTSC";
 
-  system.reset();
+  if (verbose) (cout << result.layout << endl).flush();
 
   EmulationTiming emulationTiming(frameLayout, consoleTiming);
-  uInt64 cycles = 0;
   uInt64 cyclesTarget = uInt64(run.runtime) * emulationTiming.cyclesPerSecond();
 
+  if (verbose) (cout << "0%").flush();
+
+  vector<size_t> ramHashes;
+  vector<double> samples;
+
+  // Every repetition starts from power-on; the warmup runs are discarded,
+  // the RAM hashes and the counters are taken from the first measured run
+  for (uInt32 repetition = 0; repetition < myWarmup + myRepeat; ++repetition) {
+    const bool first = repetition == myWarmup;
+    double realtime = 0;
+
+    if (repetition > 0) {
+      try {
+        console = make_unique<HeadlessConsole>(imageFile);
+      }
+      catch (const runtime_error& e) {
+        if (verbose) cout << endl;
+        result.error = e.what();
+        return false;
+      }
+    }
+
+    if (!emulate(*console, cyclesTarget, verbose && repetition == 0, result.cycles,
+                 result.frames, realtime, first && myCompareArm ? &ramHashes : nullptr,
+                 first && myPerf ? &result.perf : nullptr)) {
+      if (verbose) cout << endl;
+      result.error = "emulation failed after " + std::to_string(result.cycles) + " cycles";
+      return false;
+    }
+
+    if (verbose && repetition == 0) (cout << "100%").flush();
+    if (verbose && repetition > 0) (cout << ".").flush();
+    if (repetition >= myWarmup) samples.push_back(realtime);
+  }
+
+  evaluateSamples(samples, result);
+
+  if (verbose) {
+    cout << endl << "real time: " << result.realtime << " seconds";
+    if (result.samples > 1)
+      cout << " +/- " << result.realtimeCI95 << " (" << result.samples << " runs, "
+           << result.rejected << " outliers rejected)";
+    cout << endl;
+    if (myPerf) printPerf(result);
+  }
+
+  if (myCompareTracking) {
+    // Repeat the same run from power-on, this time with access tracking
+    uInt64 cycles = 0, frames = 0;
+
+    try {
+      console = make_unique<HeadlessConsole>(imageFile);
+    }
+    catch (const runtime_error& e) {
+      result.error = e.what();
+      return false;
+    }
+    console->system().setAccessTracking(true);
+
+    if (!emulate(*console, cyclesTarget, false, cycles, frames, result.realtimeTracking)) {
+      result.error = "emulation with access tracking failed after " +
+        std::to_string(cycles) + " cycles";
+      return false;
+    }
+
+    if (verbose)
+      cout << "real time with access tracking: " << result.realtimeTracking
+           << " seconds" << endl;
+  }
+
+  if (myCompareArm) {
+    // Repeat the same run from power-on, this time counting the ARM cycles
+    // and stalling the 6507 accordingly, as the real hardware does
+    uInt64 cycles = 0, frames = 0;
+    vector<size_t> armRamHashes;
+
+    try {
+      console = make_unique<HeadlessConsole>(imageFile, Settings::Options{{"fastarm", false}});
+    }
+    catch (const runtime_error& e) {
+      result.error = e.what();
+      return false;
+    }
+
+    if (!emulate(*console, cyclesTarget, false, cycles, frames, result.realtimeArm,
+                 &armRamHashes)) {
+      result.error = "emulation with ARM cycle counting failed after " +
+        std::to_string(cycles) + " cycles";
+      return false;
+    }
+
+    const auto mismatch = std::mismatch(ramHashes.begin(), ramHashes.end(),
+      armRamHashes.begin(), armRamHashes.end());
+    result.armDivergenceFrame = mismatch.first == ramHashes.end() ||
+                                mismatch.second == armRamHashes.end()
+      ? 0
+      : uInt64(mismatch.first - ramHashes.begin()) + 1;
+
+    if (verbose) {
+      cout << "real time with ARM cycles: " << result.realtimeArm << " seconds, ";
+      if (result.armDivergenceFrame)
+        cout << "RAM differs from frame " << result.armDivergenceFrame << endl;
+      else
+        cout << "RAM identical" << endl;
+    }
+  }
+
+  result.ok = true;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ProfilingRunner::evaluateSamples(vector<double> samples,
+                                      ProfilingResult& result) const
+{
+  const auto median = [](vector<double> values) {
+    std::sort(values.begin(), values.end());
+    const size_t mid = values.size() / 2;
+
+    return values.size() % 2 ? values[mid] : (values[mid - 1] + values[mid]) / 2;
+  };
+
+  const size_t total = samples.size();
+
+  // Reject samples which are more than three (normal scaled) median absolute
+  // deviations off the median, e.g. runs disturbed by other processes
+  if (total >= 3) {
+    const double center = median(samples);
+    vector<double> deviations;
+
+    for (double sample : samples) deviations.push_back(std::abs(sample - center));
+
+    const double mad = 1.4826 * median(deviations);
+    if (mad > 0)
+      samples.erase(std::remove_if(samples.begin(), samples.end(),
+        [&](double sample) { return std::abs(sample - center) > 3 * mad; }),
+        samples.end());
+  }
+
+  const size_t n = samples.size();
+  double mean = 0, variance = 0;
+
+  for (double sample : samples) mean += sample;
+  mean /= n;
+
+  for (double sample : samples) variance += (sample - mean) * (sample - mean);
+  if (n > 1) variance /= n - 1;
+
+  result.samples = uInt32(n);
+  result.rejected = uInt32(total - n);
+  result.realtime = mean;
+  result.realtimeStdDev = std::sqrt(variance);
+  result.realtimeCI95 = n > 1
+    ? tQuantile(n - 1) * result.realtimeStdDev / std::sqrt(n)
+    : 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ProfilingRunner::loadBaseline()
+{
+  std::ifstream in(myBaselineFile);
+
+  if (!in) {
+    cerr << "ERROR: unable to read baseline " << myBaselineFile << endl;
+    return false;
+  }
+
+  try {
+    const json baseline = json::parse(in);
+
+    for (const auto& entry : baseline.at("runs")) {
+      if (!entry.value("ok", false)) continue;
+
+      BaselineRun run;
+      run.cycles = entry.at("cycles").get<uInt64>();
+      run.realtime = entry.at("wallTime").get<double>();
+      // Reports of single runs carry no deviation
+      run.realtimeStdDev = entry.value("wallTimeStdDev", 0.);
+      run.samples = entry.value("samples", 1U);
+
+      if (run.cycles > 0 && run.realtime > 0)
+        myBaseline[entry.at("rom").get<string>()] = run;
+    }
+  }
+  catch (const json::exception& e) {
+    cerr << "ERROR: invalid baseline " << myBaselineFile << ": " << e.what() << endl;
+    return false;
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ProfilingRunner::compareToBaseline(const ProfilingRun& run,
+                                        ProfilingResult& result) const
+{
+  const auto it = myBaseline.find(run.romFile);
+  if (!result.ok || it == myBaseline.end()) return;
+
+  const BaselineRun& baseline = it->second;
+
+  // Compare the time per emulated cycle, so runs of different lengths are
+  // comparable as well
+  const double time = result.realtime / result.cycles;
+  const double baselineTime = baseline.realtime / baseline.cycles;
+
+  result.compared = true;
+  result.speedChange = baselineTime / time - 1;
+
+  if (result.samples > 1 && baseline.samples > 1) {
+    // Welch's t-test
+    const double v = std::pow(result.realtimeStdDev / result.cycles, 2) / result.samples;
+    const double vBaseline =
+      std::pow(baseline.realtimeStdDev / baseline.cycles, 2) / baseline.samples;
+    const double se = std::sqrt(v + vBaseline);
+
+    if (se > 0) {
+      const double df = (v + vBaseline) * (v + vBaseline) /
+        (v * v / (result.samples - 1) + vBaseline * vBaseline / (baseline.samples - 1));
+
+      result.significant = std::abs(time - baselineTime) / se > tQuantile(df);
+    }
+    else
+      result.significant = time != baselineTime;
+  }
+  else
+    // Nothing to test without repetitions, the threshold decides alone
+    result.significant = true;
+
+  result.regression = result.significant && result.speedChange < -myThreshold;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ProfilingRunner::emulate(HeadlessConsole& console, uInt64 cyclesTarget,
+                              bool verbose, uInt64& cycles, uInt64& frames,
+                              double& realtime, vector<size_t>* ramHashes,
+                              PerfCounters::Values* perf) const
+{
+  TIA& tia(console.tia());
+
   DispatchResult dispatchResult;
   dispatchResult.setOk(0);
 
   uInt32 percent = 0;
-  (cout << "0%").flush();
+  cycles = frames = 0;
+
+  // The counters follow the calling thread, so they must be opened here
+  unique_ptr<PerfCounters> counters;
+  if (perf) {
+    counters = make_unique<PerfCounters>();
+    counters->start();
+  }
 
   time_point<high_resolution_clock> tp = high_resolution_clock::now();
 
@@ -180,7 +710,14 @@ bool ProfilingRunner::runOne(const ProfilingRun& run)
     tia.update(dispatchResult);
     cycles += dispatchResult.getCycles();
 
-    if (tia.newFramePending()) tia.renderToFrameBuffer();
+    if (tia.newFramePending()) {
+      tia.renderToFrameBuffer();
+      ++frames;
+
+      if (ramHashes) ramHashes->push_back(hashRam(console));
+    }
+
+    if (!verbose) continue;
 
     uInt32 percentNow = uInt32(std::min((100 * cycles) / cyclesTarget, static_cast<uInt64>(100)));
     updateProgress(percent, percentNow);
@@ -188,15 +725,9 @@ bool ProfilingRunner::runOne(const ProfilingRun& run)
     percent = percentNow;
   }
 
-  double realtimeUsed = duration_cast<duration<double>>(high_resolution_clock::now () - tp).count();
+  realtime = duration_cast<duration<double>>(high_resolution_clock::now () - tp).count();
 
-  if (dispatchResult.getStatus() != DispatchResult::Status::ok) {
-    cout << endl << "ERROR: emulation failed after " << cycles << " cycles";
-    return false;
-  }
+  if (counters) *perf = counters->stop();
 
-  (cout << "100%" << endl).flush();
-  cout << "real time: " << realtimeUsed << " seconds" << endl;
-
-  return true;
+  return dispatchResult.getStatus() == DispatchResult::Status::ok;
 }
@@ -18,13 +18,50 @@
 #ifndef PROFILING_RUNNER
 #define PROFILING_RUNNER
 
-#include "bspf.hxx"
-#include "Control.hxx"
-#include "Switches.hxx"
-#include "Settings.hxx"
-#include "ConsoleIO.hxx"
-#include "Props.hxx"
+#include <atomic>
+#include <map>
+#include <mutex>
 
+#include "bspf.hxx"
+#include "PerfCounters.hxx"
+
+class HeadlessConsole;
+
+/**
+  Runs one or more ROMs headless for a fixed amount of emulated time and
+  reports the achieved emulation speed.
+
+  Usage: stella -profile [-threads <n>] [-json] [-perf] [-comparetracking]
+                        [-comparearm] [-repeat <n>] [-warmup <n>]
+                        [-baseline <json report>] [-threshold <percent>]
+                        rom[:seconds] ...
+
+  With '-threads' the runs are distributed over a pool of worker threads,
+  each of which owns a completely independent emulation stack. With
+  '-json' a machine-readable report (one record per ROM plus a summary)
+  is written to stdout instead of the human-readable progress output.
+  With '-perf' the hardware performance counters of the emulating thread
+  (see PerfCounters) are collected for every ROM, and reported together
+  with the IPC and the counts per emulated frame.
+  With '-comparetracking' every ROM is run a second time with the
+  debugger's access flag and counter tracking enabled (off by default
+  in headless emulation), and both timings are reported. With '-comparearm'
+  every ROM is run a second time with ARM cycle counting ('-fastarm 0'),
+  and besides both timings the first frame (if any) at which the RIOT and
+  cart RAM of the two runs differ is reported; ROMs without a difference
+  do not depend on the ARM timing and can be emulated with the fast ARM
+  mode. The RAM is hashed after every frame in both runs then.
+
+  With '-repeat' every ROM is run the given number of times (each from
+  power-on), after '-warmup' discarded runs. Runs more than three median
+  absolute deviations off the median are rejected as outliers, and the
+  mean wall time is reported with its standard deviation and 95%
+  confidence interval. '-baseline' compares the speed of every ROM to a
+  JSON report written by an earlier profiling run (matched by ROM path);
+  with repetitions on both sides, a difference is significant if Welch's
+  t-test says so at 95%. A significant slowdown beyond '-threshold'
+  percent (default 5) is a regression, and makes the run fail.
+*/
 class ProfilingRunner {
   public:
 
@@ -36,30 +73,90 @@ class ProfilingRunner {
 
     struct ProfilingRun {
       string romFile;
-      uInt32 runtime;
+      uInt32 runtime{0};
     };
 
-    struct IO: public ConsoleIO {
-      Controller& leftController() const override { return *myLeftControl; }
-      Controller& rightController() const override { return *myRightControl; }
-      Switches& switches() const override { return *mySwitches; }
+    struct ProfilingResult {
+      bool ok{false};
+      string error;
+      string layout;
+      uInt64 cycles{0};
+      uInt64 frames{0};
+      // Mean wall time of the measured repetitions, after rejecting outliers
+      double realtime{0};
+      double realtimeStdDev{0};
+      double realtimeCI95{0};
+      uInt32 samples{0};
+      uInt32 rejected{0};
+      // Wall time of the same run with access tracking enabled
+      double realtimeTracking{0};
+      // Wall time of the same run with ARM cycle counting, and the first
+      // frame (counting from one) at which its RAM differs (zero if none)
+      double realtimeArm{0};
+      uInt64 armDivergenceFrame{0};
+      // Hardware performance counters of the run
+      PerfCounters::Values perf;
+      // Comparison to the baseline; the speed change is relative (positive
+      // is faster)
+      bool compared{false};
+      double speedChange{0};
+      bool significant{false};
+      bool regression{false};
+    };
 
-      unique_ptr<Controller> myLeftControl;
-      unique_ptr<Controller> myRightControl;
-      unique_ptr<Switches> mySwitches;
+    struct BaselineRun {
+      uInt64 cycles{0};
+      double realtime{0};
+      double realtimeStdDev{0};
+      uInt32 samples{1};
     };
 
   private:
 
-    bool runOne(const ProfilingRun& run);
+    bool runOne(const ProfilingRun& run, ProfilingResult& result, bool verbose);
+
+    bool emulate(HeadlessConsole& console, uInt64 cyclesTarget, bool verbose,
+                 uInt64& cycles, uInt64& frames, double& realtime,
+                 vector<size_t>* ramHashes = nullptr,
+                 PerfCounters::Values* perf = nullptr) const;
+
+    void evaluateSamples(vector<double> samples, ProfilingResult& result) const;
+
+    bool loadBaseline();
+
+    void compareToBaseline(const ProfilingRun& run, ProfilingResult& result) const;
+
+    void runWorker(vector<ProfilingResult>& results);
+
+    void printReport(const vector<ProfilingResult>& results, double realtime) const;
+
+    void printPerf(const ProfilingResult& result) const;
+
+    void printComparison(const vector<ProfilingResult>& results) const;
 
   private:
 
     vector<ProfilingRun> profilingRuns;
 
-    Settings mySettings;
+    uInt32 myThreads{1};
+    bool myJsonOutput{false};
+    bool myPerf{false};
+
+    uInt32 myRepeat{1};
+    uInt32 myWarmup{0};
+
+    string myBaselineFile;
+    // Relative slowdown which counts as regression
+    double myThreshold{0.05};
+    std::map<string, BaselineRun> myBaseline;
+    bool myCompareTracking{false};
+    bool myCompareArm{false};
+
+    // Index of the next run to be picked up by a worker
+    std::atomic<size_t> myNextRun{0};
 
-    Properties myProps;
+    // Serializes console output from the workers
+    std::mutex myOutputMutex;
 };
 
 #endif // PROFILING_RUNNER
@@ -36,9 +36,13 @@ Properties::Properties(const Properties& properties)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Properties::load(KeyValueRepository& repo)
 {
-  setDefaults();
+  load(repo.load());
+}
 
-  const auto props = repo.load();
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Properties::load(const std::map<string, Variant>& props)
+{
+  setDefaults();
 
   for (const auto& [key, value]: props)
     set(getPropType(key), value.toString());
@@ -281,7 +285,7 @@ std::array<string, Properties::NUM_PROPS> Properties::ourDefaultProperties =
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-std::array<string, Properties::NUM_PROPS> Properties::ourPropertyNames =
+const std::array<string, Properties::NUM_PROPS> Properties::ourPropertyNames =
 {
   "Cart.MD5",
   "Cart.Manufacturer",
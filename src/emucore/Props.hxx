@@ -84,6 +84,7 @@ class Properties
 
   public:
     void load(KeyValueRepository& repo);
+    void load(const std::map<string, Variant>& props);
 
     bool save(KeyValueRepository& repo) const;
 
@@ -183,7 +184,7 @@ class Properties
     static std::array<string, NUM_PROPS> ourDefaultProperties;
 
     // The text strings associated with each property type
-    static std::array<string, NUM_PROPS> ourPropertyNames;
+    static const std::array<string, NUM_PROPS> ourPropertyNames;
 };
 
 #endif
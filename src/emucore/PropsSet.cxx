@@ -26,6 +26,57 @@
 #include "repository/CompositeKeyValueRepositoryNoop.hxx"
 #include "repository/KeyValueRepositoryPropertyFile.hxx"
 
+namespace {
+  // Convert an md5sum in (case-insensitive) hex form into its binary key
+  bool parseMD5(const string& md5, DefPropsKey& key)
+  {
+    if(md5.length() != 32)
+      return false;
+
+    uInt64 value[2] = { 0, 0 };
+    for(size_t i = 0; i < 32; ++i)
+    {
+      const char c = md5[i];
+      uInt64 nibble;
+      if(c >= '0' && c <= '9')       nibble = c - '0';
+      else if(c >= 'a' && c <= 'f')  nibble = c - 'a' + 10;
+      else if(c >= 'A' && c <= 'F')  nibble = c - 'A' + 10;
+      else                           return false;
+
+      value[i >> 4] = (value[i >> 4] << 4) | nibble;
+    }
+    key.hi = value[0];
+    key.lo = value[1];
+
+    return true;
+  }
+
+  // Convert a binary key back into the lowercase hex form of the md5sum
+  string formatMD5(const DefPropsKey& key)
+  {
+    static constexpr char HEX[] = "0123456789abcdef";
+    string md5(32, '0');
+    for(int i = 15; i >= 0; --i)
+    {
+      md5[i]      = HEX[(key.hi >> ((15 - i) << 2)) & 0xf];
+      md5[i + 16] = HEX[(key.lo >> ((15 - i) << 2)) & 0xf];
+    }
+    return md5;
+  }
+
+  // Copy all non-default values of a built-in entry into 'properties';
+  // the md5sum column isn't stored in the table
+  void loadDefProps(uInt32 idx, Properties& properties)
+  {
+    for(uInt8 p = 1; p < static_cast<uInt8>(PropType::NumTypes); ++p)
+    {
+      const uInt16 value = DefProps[idx][p - 1];
+      if(value != 0)
+        properties.set(PropType(p), DefPropsStrings[value]);
+    }
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 PropertiesSet::PropertiesSet() : myRepository{make_shared<CompositeKeyValueRepositoryNoop>()} {}
 
@@ -33,12 +84,23 @@ PropertiesSet::PropertiesSet() : myRepository{make_shared<CompositeKeyValueRepos
 void PropertiesSet::setRepository(shared_ptr<CompositeKeyValueRepository> repository)
 {
   myRepository = repository;
+  myCache.clear();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool PropertiesSet::getMD5(const string& md5, Properties& properties,
                            bool useDefaults) const
 {
+  if(!useDefaults)
+  {
+    const auto cached = myCache.find(md5);
+    if(cached != myCache.end())
+    {
+      properties = cached->second.properties;
+      return cached->second.found;
+    }
+  }
+
   properties.setDefaults();
   bool found = false;
 
@@ -53,8 +115,10 @@ bool PropertiesSet::getMD5(const string& md5, Properties& properties,
   // First check properties from external file
   if(!useDefaults)
   {
-    if (myRepository->has(md5)) {
-      properties.load(*myRepository->get(md5));
+    // A single query tells whether there are properties, and gets them
+    const auto values = myRepository->get(md5)->load();
+    if (!values.empty()) {
+      properties.load(values);
 
       found = true;
     }
@@ -69,32 +133,38 @@ bool PropertiesSet::getMD5(const string& md5, Properties& properties,
     }
   }
 
-  // Otherwise, search the internal database using binary search
+  // Otherwise, search the internal database; the candidates are narrowed
+  // down by the first md5sum byte, then located using binary search
   if(!found)
   {
-    int low = 0, high = DEF_PROPS_SIZE - 1;
-    while(low <= high)
+    DefPropsKey key;
+    if(parseMD5(md5, key))
     {
-      int i = (low + high) / 2;
-      int cmp = BSPF::compareIgnoreCase(md5,
-          DefProps[i][static_cast<uInt8>(PropType::Cart_MD5)]);
-
-      if(cmp == 0)  // found it
+      const uInt32 bucket = key.hi >> 56;
+      uInt32 low = DefPropsBucket[bucket], high = DefPropsBucket[bucket + 1];
+      while(low < high)
       {
-        for(uInt8 p = 0; p < static_cast<uInt8>(PropType::NumTypes); ++p)
-          if(DefProps[i][p][0] != 0)
-            properties.set(PropType(p), DefProps[i][p]);
+        const uInt32 i = (low + high) / 2;
+        const DefPropsKey& k = DefPropsMD5[i];
 
-        found = true;
-        break;
+        if(k.hi == key.hi && k.lo == key.lo)  // found it
+        {
+          loadDefProps(i, properties);
+          properties.set(PropType::Cart_MD5, formatMD5(k));
+          found = true;
+          break;
+        }
+        else if(key.hi < k.hi || (key.hi == k.hi && key.lo < k.lo))
+          high = i;     // look at lower range
+        else
+          low = i + 1;  // look at upper range
       }
-      else if(cmp < 0)
-        high = i - 1; // look at lower range
-      else
-        low = i + 1;  // look at upper range
     }
   }
 
+  if(!useDefaults)
+    myCache[md5] = CacheEntry{found, properties};
+
   return found;
 }
 
@@ -120,7 +190,12 @@ void PropertiesSet::insert(const Properties& properties, bool save)
   Properties defaultProps;
   if(getMD5(md5, defaultProps, false) && defaultProps == properties)
     return;
-  else if(getMD5(md5, defaultProps, true) && defaultProps == properties)
+
+  // The properties change, which may change the detected display format
+  myDetectedFormats.erase(md5);
+  myCache.erase(md5);
+
+  if(getMD5(md5, defaultProps, true) && defaultProps == properties)
   {
     cerr << "DELETE" << endl << std::flush;
     myRepository->remove(md5);
@@ -140,6 +215,23 @@ void PropertiesSet::insert(const Properties& properties, bool save)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PropertiesSet::setDetectedFormat(const string& md5, const string& format)
+{
+  myDetectedFormats[md5] = format;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool PropertiesSet::getDetectedFormat(const string& md5, string& format) const
+{
+  const auto it = myDetectedFormats.find(md5);
+  if(it == myDetectedFormats.end())
+    return false;
+
+  format = it->second;
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void PropertiesSet::loadPerROM(const FilesystemNode& rom, const string& md5)
 {
@@ -196,12 +288,13 @@ void PropertiesSet::print() const
   Properties properties;
   for(uInt32 i = 0; i < DEF_PROPS_SIZE; ++i)
   {
+    const string md5 = formatMD5(DefPropsMD5[i]);
+
     properties.setDefaults();
-    for(uInt8 p = 0; p < static_cast<uInt8>(PropType::NumTypes); ++p)
-      if(DefProps[i][p][0] != 0)
-        properties.set(PropType(p), DefProps[i][p]);
+    loadDefProps(i, properties);
+    properties.set(PropType::Cart_MD5, md5);
 
-    list.emplace(DefProps[i][static_cast<uInt8>(PropType::Cart_MD5)], properties);
+    list.emplace(md5, properties);
   }
 
   // Now, print the resulting list
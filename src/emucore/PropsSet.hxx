@@ -69,6 +69,28 @@ class PropertiesSet
     */
     void insert(const Properties& properties, bool save = true);
 
+    /**
+      Remember the display format autodetected for the ROM with the given
+      md5 for the rest of the session, so that reloading the ROM can skip
+      the detection. Inserting changed properties for the ROM discards
+      the detected format again.
+
+      @param md5     The md5 of the ROM
+      @param format  The detected display format
+    */
+    void setDetectedFormat(const string& md5, const string& format);
+
+    /**
+      Get the display format previously detected for the ROM with the
+      given md5 (see setDetectedFormat()).
+
+      @param md5     The md5 of the ROM
+      @param format  The detected display format, if available
+
+      @return  True if a display format was detected before, else false
+    */
+    bool getDetectedFormat(const string& md5, string& format) const;
+
     /**
       Load properties for a specific ROM from a per-ROM properties file,
       if it exists.  In any event, also do some error checking, like making
@@ -99,6 +121,17 @@ class PropertiesSet
     // be discarded when the program ends
     PropsList myTempProps;
 
+    // The display formats autodetected during this session, by md5
+    std::map<string, string> myDetectedFormats;
+
+    // The results of getMD5() including the external properties, by md5;
+    // ROMs without any properties are remembered as well
+    struct CacheEntry {
+      bool found{false};
+      Properties properties;
+    };
+    mutable std::map<string, CacheEntry> myCache;
+
     shared_ptr<CompositeKeyValueRepository> myRepository;
 
   private:
@@ -108,9 +108,9 @@ unique_ptr<Controller> QuadTari::addController(const Controller::Type type, bool
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool QuadTari::read(DigitalPin pin)
+Controller& QuadTari::activeController() const
 {
-  // We need to override the Controller::read() method, since the QuadTari
+  // We need to override the Controller::read() methods, since the QuadTari
   // can switch the controller multiple times per frame
   // (we can't just read 60 times per second in the ::update() method)
 
@@ -124,10 +124,19 @@ bool QuadTari::read(DigitalPin pin)
     // If bit 7 of VBlank is not set, read first, else second controller
     readFirst = !(mySystem.tia().registerValue(VBLANK) & 0x80);
 
-  if(readFirst)
-    return myFirstController->read(pin);
-  else
-    return mySecondController->read(pin);
+  return readFirst ? *myFirstController : *mySecondController;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 QuadTari::read()
+{
+  return activeController().read();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool QuadTari::read(DigitalPin pin)
+{
+  return activeController().read(pin);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -51,6 +51,14 @@ class QuadTari : public Controller
   public:
      using Controller::read;
 
+    /**
+      Read the entire state of all digital pins for this controller.
+      The active controller is determined once for all four pins.
+
+      @return The state of all digital pins
+    */
+    uInt8 read() override;
+
     /**
       Read the value of the specified digital pin for this controller.
 
@@ -98,6 +106,11 @@ class QuadTari : public Controller
   private:
     unique_ptr<Controller> addController(const Controller::Type type, bool second);
 
+    /**
+      The controller which is currently selected by VBLANK bit 7.
+    */
+    Controller& activeController() const;
+
     const OSystem& myOSystem;
     const Properties& myProperties;
     unique_ptr<Controller> myFirstController;
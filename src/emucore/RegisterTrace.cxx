@@ -0,0 +1,306 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <cstring>
+
+#include "AudioQueue.hxx"
+#include "HeadlessConsole.hxx"
+#include "MD5.hxx"
+#include "Serializer.hxx"
+#include "TIAConstants.hxx"
+#include "RegisterTrace.hxx"
+
+namespace {
+  // TIA registers (all mirrors), resp. RIOT I/O and timer registers
+  bool isTIA(uInt16 address) { return (address & 0x1080) == 0x0000; }
+  bool isRIOT(uInt16 address) { return (address & 0x1280) == 0x0280; }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RegisterTrace::Recorder::Recorder(HeadlessConsole& console, RegisterTrace& trace)
+  : myConsole{console},
+    myTrace{trace},
+    myStartCycle{console.cycles()}
+{
+  System& system = console.system();
+
+  myTrace.layout = console.frameLayout();
+  myTrace.romMD5 = console.md5();
+  myTrace.entries.clear();
+
+  // Put the recorder in front of whatever handles the register pages; the
+  // RAM pages are accessed directly and don't matter
+  for(uInt16 page = 0; page < System::NUM_PAGES; ++page)
+  {
+    const uInt16 address = page << System::PAGE_SHIFT;
+
+    myPages[page] = system.getPageAccess(address);
+    if(isTIA(address) || isRIOT(address))
+    {
+      System::PageAccess access(this, System::PageAccessType::READWRITE);
+      system.setPageAccess(address, access);
+    }
+  }
+
+  // WSYNC halts the CPU until the end of the scanline
+  myHaltCallback = console.cpu().getOnHaltCallback();
+  console.cpu().setOnHaltCallback([this]() {
+    record(Access::halt, 0, 0);
+    myHaltCallback();
+  });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RegisterTrace::Recorder::~Recorder()
+{
+  System& system = myConsole.system();
+
+  for(uInt16 page = 0; page < System::NUM_PAGES; ++page)
+    system.setPageAccess(page << System::PAGE_SHIFT, myPages[page]);
+
+  myConsole.cpu().setOnHaltCallback(myHaltCallback);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RegisterTrace::Recorder::finish(uInt32 frames)
+{
+  myTrace.frames = frames;
+  myTrace.cycles = myConsole.cycles() - myStartCycle;
+  myTrace.frameMD5 = hashFrame(myConsole);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 RegisterTrace::Recorder::peek(uInt16 address)
+{
+  const System::PageAccess& access =
+    myPages[(address & System::ADDRESS_MASK) >> System::PAGE_SHIFT];
+  const uInt8 value = access.device->peek(address);
+
+  record(isTIA(address) ? Access::tiaRead : Access::riotRead, address, value);
+
+  return value;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RegisterTrace::Recorder::poke(uInt16 address, uInt8 value)
+{
+  const System::PageAccess& access =
+    myPages[(address & System::ADDRESS_MASK) >> System::PAGE_SHIFT];
+
+  // Recorded first, since the write may halt the CPU
+  record(isTIA(address) ? Access::tiaWrite : Access::riotWrite, address, value);
+
+  return access.device->poke(address, value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RegisterTrace::Recorder::record(Access access, uInt16 address, uInt8 value)
+{
+  myTrace.entries.push_back(Entry{myConsole.cycles() - myStartCycle, access,
+                                  uInt8(address), value});
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RegisterTrace::Player::Player(HeadlessConsole& console, const RegisterTrace& trace)
+  : myConsole{console},
+    myTrace{trace},
+    myStartCycle{console.cycles()}
+{
+  if(console.md5() != trace.romMD5)
+    throw runtime_error("the trace was recorded with another ROM");
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RegisterTrace::Player::setAudioQueue(const shared_ptr<AudioQueue>& queue)
+{
+  myAudioQueue = queue;
+  myConsole.tia().setAudioQueue(queue);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RegisterTrace::Player::run()
+{
+  TIA& tia = myConsole.tia();
+  M6532& riot = myConsole.riot();
+  M6502& cpu = myConsole.cpu();
+
+  for(const Entry& entry: myTrace.entries)
+  {
+    advance(entry.cycle);
+
+    switch(entry.access)
+    {
+      case Access::tiaWrite:
+        tia.poke(entry.address, entry.value);
+        // WSYNC requests a halt, which is replayed by its own entry
+        cpu.clearHaltRequest();
+        break;
+
+      case Access::tiaRead:
+      {
+        const uInt8 value = tia.peek(entry.address);
+
+        // Only the collision registers are independent of the input
+        if((entry.address & 0x08) == 0 && (value & 0xc0) != (entry.value & 0xc0))
+          ++myMismatches;
+        break;
+      }
+
+      case Access::riotWrite:
+        riot.poke(0x0200 | entry.address, entry.value);
+        break;
+
+      case Access::riotRead:
+        riot.peek(0x0200 | entry.address);
+        break;
+
+      case Access::halt:
+        cpu.getOnHaltCallback()();
+        break;
+    }
+    completeFrames();
+  }
+
+  advance(myTrace.cycles);
+  tia.synchronize();
+  completeFrames();
+
+  myFrameMatches = hashFrame(myConsole) == myTrace.frameMD5;
+
+  return myFrameMatches && myMismatches == 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RegisterTrace::Player::advance(uInt64 cycle)
+{
+  System& system = myConsole.system();
+  const uInt64 target = myStartCycle + cycle;
+
+  // A halt may already have advanced the clock beyond the target, if the
+  // replay diverged
+  if(system.cycles() < target)
+    system.incrementCycles(uInt32(target - system.cycles()));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RegisterTrace::Player::completeFrames()
+{
+  TIA& tia = myConsole.tia();
+
+  if(!tia.newFramePending())
+    return;
+
+  tia.renderToFrameBuffer();
+  ++myFrames;
+
+  // Drain the audio queue, as the sound driver would
+  if(myAudioQueue)
+    while((myFragment = myAudioQueue->dequeue(myFragment)) != nullptr)
+      ++myFragments;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RegisterTrace::save(const string& filename) const
+{
+  Serializer out(filename, Serializer::Mode::ReadWriteTrunc);
+  if(!out)
+    throw runtime_error("cannot create trace '" + filename + "'");
+
+  out.putByteArray(reinterpret_cast<const uInt8*>("STRT"), 4);
+  out.putShort(VERSION);
+  out.putByte(layout == FrameLayout::pal ? 1 : 0);
+  out.putString(romMD5);
+  out.putInt(frames);
+  out.putLong(cycles);
+  out.putString(frameMD5);
+  out.putLong(entries.size());
+
+  uInt64 last = 0;
+  for(const Entry& entry: entries)
+  {
+    // Most entries are only a few cycles apart
+    uInt64 delta = entry.cycle - last;
+    last = entry.cycle;
+    while(delta >= 0x80)
+    {
+      out.putByte(uInt8(delta) | 0x80);
+      delta >>= 7;
+    }
+    out.putByte(uInt8(delta));
+
+    out.putByte(uInt8(entry.access));
+    if(entry.access != Access::halt)
+    {
+      out.putByte(entry.address);
+      out.putByte(entry.value);
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RegisterTrace::load(const string& filename)
+{
+  Serializer in(filename, Serializer::Mode::ReadOnly);
+  if(!in)
+    throw runtime_error("cannot read trace '" + filename + "'");
+
+  std::array<uInt8, 4> magic;
+  in.getByteArray(magic.data(), magic.size());
+  if(std::memcmp(magic.data(), "STRT", 4) != 0 || in.getShort() != VERSION)
+    throw runtime_error("'" + filename + "' is not a supported register trace");
+
+  layout = in.getByte() == 1 ? FrameLayout::pal : FrameLayout::ntsc;
+  romMD5 = in.getString();
+  frames = in.getInt();
+  cycles = in.getLong();
+  frameMD5 = in.getString();
+
+  entries.clear();
+  entries.resize(in.getLong());
+
+  uInt64 cycle = 0;
+  for(Entry& entry: entries)
+  {
+    uInt64 delta = 0;
+    uInt8 byte;
+    uInt32 shift = 0;
+    do
+    {
+      byte = in.getByte();
+      delta |= uInt64(byte & 0x7f) << shift;
+      shift += 7;
+    } while(byte & 0x80);
+
+    cycle += delta;
+    entry.cycle = cycle;
+    entry.access = Access(in.getByte());
+    if(entry.access > Access::halt)
+      throw runtime_error("'" + filename + "' is corrupt");
+    if(entry.access != Access::halt)
+    {
+      entry.address = in.getByte();
+      entry.value = in.getByte();
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string RegisterTrace::hashFrame(HeadlessConsole& console)
+{
+  return MD5::hash(console.frameBuffer(),
+    TIAConstants::frameBufferWidth * TIAConstants::frameBufferHeight);
+}
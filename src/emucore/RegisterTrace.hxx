@@ -0,0 +1,207 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef REGISTER_TRACE_HXX
+#define REGISTER_TRACE_HXX
+
+class AudioQueue;
+class HeadlessConsole;
+
+#include "bspf.hxx"
+#include "Device.hxx"
+#include "FrameLayout.hxx"
+#include "M6502.hxx"
+#include "System.hxx"
+
+/**
+  A trace of all accesses of the CPU to the TIA and RIOT registers, with
+  the system cycle at which each happened, and of the CPU halts caused by
+  WSYNC.  Recorded from a headless run of a ROM, it can be replayed into
+  the TIA and RIOT of a console without running the CPU, which makes the
+  work of the TIA (and audio) a deterministic workload of its own, e.g.
+  for benchmarking the TIA and renderer independent of the CPU emulation.
+
+  Reads are part of the trace, since they advance the TIA and RIOT, and
+  their values (e.g. of the input pins) are kept for reference.  Replay
+  verifies the collision reads, and the last frame against the one of
+  the recording.
+
+  A ROM whose cartridge snoops or alters accesses to the TIA (e.g. BUS)
+  is traced as seen by the CPU; bankswitching hotspots in the TIA address
+  space are traced like any other write.
+
+  The file starts with a header ('S', 'T', 'R', 'T', the format version,
+  the frame layout, the MD5 of the ROM, the number of frames and cycles,
+  and the MD5 of the last frame), followed by the number of entries and
+  the entries themselves: the cycles since the previous entry as a
+  variable length number, the kind of access and, unless it is a halt,
+  the address (low byte) and the value.
+
+  @author  Stella Team
+*/
+class RegisterTrace
+{
+  public:
+    enum class Access: uInt8 {
+      tiaWrite, tiaRead, riotWrite, riotRead, halt
+    };
+
+    struct Entry {
+      uInt64 cycle{0};    // system cycles since the start of the trace
+      Access access{Access::halt};
+      uInt8 address{0};   // low byte of the address
+      uInt8 value{0};
+    };
+
+    /**
+      Records the accesses of a console, from construction until destruction.
+    */
+    class Recorder : public Device
+    {
+      public:
+        /**
+          Start recording; the accesses are appended to the given trace.
+        */
+        Recorder(HeadlessConsole& console, RegisterTrace& trace);
+        ~Recorder() override;
+
+        /**
+          Finish the trace with the current cycle and frame.
+        */
+        void finish(uInt32 frames);
+
+        void reset() override { }
+        void install(System&) override { }
+        bool save(Serializer&) const override { return false; }
+        bool load(Serializer&) override { return false; }
+
+        uInt8 peek(uInt16 address) override;
+        bool poke(uInt16 address, uInt8 value) override;
+
+      private:
+        void record(Access access, uInt16 address, uInt8 value);
+
+      private:
+        HeadlessConsole& myConsole;
+        RegisterTrace& myTrace;
+        uInt64 myStartCycle{0};
+
+        // The page accesses replaced by the recorder, which accesses are
+        // passed on to (e.g. the TIA, or a cartridge delegating the TIA)
+        std::array<System::PageAccess, System::NUM_PAGES> myPages;
+        M6502::onHaltCallback myHaltCallback;
+
+      private:
+        // Following constructors and assignment operators not supported
+        Recorder() = delete;
+        Recorder(const Recorder&) = delete;
+        Recorder(Recorder&&) = delete;
+        Recorder& operator=(const Recorder&) = delete;
+        Recorder& operator=(Recorder&&) = delete;
+    };
+
+    /**
+      Replays a trace into the TIA and RIOT of a console, whose CPU is not
+      used.  The console must run the traced ROM, and be in its power-on
+      state.
+    */
+    class Player
+    {
+      public:
+        Player(HeadlessConsole& console, const RegisterTrace& trace);
+
+        /**
+          Attach an audio queue, which receives the samples generated by the
+          TIA; it is drained after every frame, as the sound driver would.
+        */
+        void setAudioQueue(const shared_ptr<AudioQueue>& queue);
+
+        /**
+          Replay the complete trace.
+
+          @return  False if the replay diverged from the recording
+        */
+        bool run();
+
+        uInt32 frames() const { return myFrames; }
+        uInt64 fragments() const { return myFragments; }
+
+        /**
+          The number of collision reads which returned a different value
+          than recorded.
+        */
+        uInt32 mismatches() const { return myMismatches; }
+
+        /**
+          Whether the last frame equals the one of the recording.
+        */
+        bool frameMatches() const { return myFrameMatches; }
+
+      private:
+        void advance(uInt64 cycle);
+        void completeFrames();
+
+      private:
+        HeadlessConsole& myConsole;
+        const RegisterTrace& myTrace;
+        shared_ptr<AudioQueue> myAudioQueue;
+        Int16* myFragment{nullptr};
+
+        uInt64 myStartCycle{0};
+        uInt32 myFrames{0};
+        uInt64 myFragments{0};
+        uInt32 myMismatches{0};
+        bool myFrameMatches{false};
+
+      private:
+        // Following constructors and assignment operators not supported
+        Player() = delete;
+        Player(const Player&) = delete;
+        Player(Player&&) = delete;
+        Player& operator=(const Player&) = delete;
+        Player& operator=(Player&&) = delete;
+    };
+
+  public:
+    RegisterTrace() = default;
+
+    /**
+      Save to resp. load from the given file. Throws a runtime_error on
+      failure.
+    */
+    void save(const string& filename) const;
+    void load(const string& filename);
+
+    /**
+      The MD5 of the given frame buffer (as held by HeadlessConsole).
+    */
+    static string hashFrame(HeadlessConsole& console);
+
+  public:
+    FrameLayout layout{FrameLayout::ntsc};
+    string romMD5;
+    uInt32 frames{0};
+    uInt64 cycles{0};
+    string frameMD5;
+
+    vector<Entry> entries;
+
+  private:
+    static constexpr uInt16 VERSION = 1;
+};
+
+#endif
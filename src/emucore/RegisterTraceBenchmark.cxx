@@ -0,0 +1,174 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <chrono>
+
+#include "RegisterTraceBenchmark.hxx"
+#include "AudioQueue.hxx"
+#include "EmulationTiming.hxx"
+#include "FSNode.hxx"
+#include "HeadlessConsole.hxx"
+#include "InputScript.hxx"
+#include "Logger.hxx"
+#include "RegisterTrace.hxx"
+#include "json_lib.hxx"
+
+using namespace std::chrono;
+using json = nlohmann::json;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RegisterTraceBenchmark::RegisterTraceBenchmark(int argc, char* argv[])
+{
+  vector<string> files;
+
+  for (int i = 2; i < argc; i++) {
+    string arg = argv[i];
+
+    if (arg == "-json")
+      myJsonOutput = true;
+    else if (arg == "-audio")
+      myAudio = true;
+    else if (arg == "-frames" && i + 1 < argc)
+      myFrames = std::max(BSPF::stringToInt(argv[++i]), 1);
+    else if (arg == "-repeat" && i + 1 < argc)
+      myRepeat = std::max(BSPF::stringToInt(argv[++i]), 1);
+    else if (arg == "-input" && i + 1 < argc)
+      myInputFile = argv[++i];
+    else if (myCommand.empty())
+      myCommand = arg;
+    else
+      files.push_back(arg);
+  }
+
+  if (files.size() != 2)
+    throw runtime_error("usage: -regtrace record|play ... rom trace (resp. trace rom)");
+
+  myRomFile = files[myCommand == "play" ? 1 : 0];
+  myTraceFile = files[myCommand == "play" ? 0 : 1];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RegisterTraceBenchmark::run()
+{
+  // Keeps the JSON report parseable
+  Logger::instance().setLogParameters(Logger::Level::ERR, false);
+
+  if (myCommand == "record") {
+    record();
+
+    return true;
+  }
+  else if (myCommand == "play")
+    return play();
+
+  throw runtime_error("unknown command '" + myCommand + "'");
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RegisterTraceBenchmark::record() const
+{
+  HeadlessConsole console{FilesystemNode(myRomFile)};
+  InputScript script;
+  RegisterTrace trace;
+
+  if (!myInputFile.empty()) script.load(myInputFile);
+
+  {
+    RegisterTrace::Recorder recorder(console, trace);
+
+    for (uInt32 frame = 0; frame < myFrames; frame++) {
+      script.apply(frame, console.event());
+
+      if (!console.emulateFrame())
+        throw runtime_error("emulation failed after " + std::to_string(frame) + " frames");
+    }
+
+    recorder.finish(myFrames);
+  }
+
+  trace.save(myTraceFile);
+
+  cout << myFrames << " frames, " << trace.cycles << " cycles, "
+       << trace.entries.size() << " accesses recorded to " << myTraceFile << endl;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RegisterTraceBenchmark::play() const
+{
+  RegisterTrace trace;
+  trace.load(myTraceFile);
+
+  const FilesystemNode rom(myRomFile);
+  const EmulationTiming timing(trace.layout);
+
+  double realtime = 0;
+  uInt32 frames = 0;
+  uInt64 fragments = 0;
+  uInt32 mismatches = 0;
+  bool frameOk = true;
+
+  for (uInt32 i = 0; i < myRepeat; i++) {
+    // The console is set up outside of the measurement
+    HeadlessConsole console{rom};
+    RegisterTrace::Player player(console, trace);
+
+    if (myAudio)
+      player.setAudioQueue(make_shared<AudioQueue>(
+        timing.audioFragmentSize(), timing.audioQueueCapacity(), false));
+
+    const auto tStart = high_resolution_clock::now();
+    player.run();
+    const double time =
+      duration_cast<duration<double>>(high_resolution_clock::now() - tStart).count();
+
+    if (i == 0 || time < realtime) realtime = time;
+
+    frames = player.frames();
+    fragments = player.fragments();
+    mismatches = std::max(mismatches, player.mismatches());
+    frameOk = frameOk && player.frameMatches();
+  }
+
+  const bool ok = frameOk && mismatches == 0;
+
+  if (myJsonOutput) {
+    json report = json::object();
+    report["trace"] = myTraceFile;
+    report["ok"] = ok;
+    report["frames"] = frames;
+    report["recordedFrames"] = trace.frames;
+    report["accesses"] = trace.entries.size();
+    report["cycles"] = trace.cycles;
+    report["realtime"] = realtime;
+    report["framesPerSecond"] = frames / realtime;
+    report["collisionMismatches"] = mismatches;
+    report["frameOk"] = frameOk;
+    if (myAudio) report["audioFragments"] = fragments;
+
+    cout << report.dump(2) << endl;
+  }
+  else {
+    cout << frames << " frames, " << trace.entries.size() << " accesses in "
+         << std::fixed << std::setprecision(3) << realtime * 1000 << " ms ("
+         << std::setprecision(0) << frames / realtime << " frames/s";
+    if (myAudio) cout << ", " << fragments << " audio fragments";
+    cout << "), last frame " << (frameOk ? "ok" : "MISMATCH")
+         << ", collisions " << (mismatches == 0 ? "ok" : "MISMATCH") << endl;
+  }
+
+  return ok;
+}
@@ -0,0 +1,73 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef REGISTER_TRACE_BENCHMARK_HXX
+#define REGISTER_TRACE_BENCHMARK_HXX
+
+#include "bspf.hxx"
+
+/**
+  Records register traces (see RegisterTrace), and replays them into the
+  TIA without running the CPU, measuring the time taken by the TIA (and
+  optionally the audio circuit).
+
+  Usage: stella -regtrace record [-frames <n>] [-input <script>] rom trace
+         stella -regtrace play [-json] [-audio] [-repeat <n>] trace rom
+
+  'record' runs the ROM headless for the given number of frames (default
+  600), with the input of an optional InputScript. 'play' replays the
+  trace into a fresh console of the same ROM, as often as given by
+  '-repeat' (default 5), and reports the fastest replay. With '-audio' an
+  audio queue is attached, so that the TIA generates samples as well. The
+  replay fails if it diverges from the recording. With '-json'
+  a machine-readable report is written to stdout.
+*/
+class RegisterTraceBenchmark
+{
+  public:
+
+    RegisterTraceBenchmark(int argc, char* argv[]);
+
+    bool run();
+
+  private:
+
+    void record() const;
+
+    bool play() const;
+
+  private:
+
+    string myCommand;
+    string myRomFile;
+    string myTraceFile;
+    string myInputFile;
+    uInt32 myFrames{600};
+    uInt32 myRepeat{5};
+    bool myAudio{false};
+    bool myJsonOutput{false};
+
+  private:
+    // Following constructors and assignment operators not supported
+    RegisterTraceBenchmark() = delete;
+    RegisterTraceBenchmark(const RegisterTraceBenchmark&) = delete;
+    RegisterTraceBenchmark(RegisterTraceBenchmark&&) = delete;
+    RegisterTraceBenchmark& operator=(const RegisterTraceBenchmark&) = delete;
+    RegisterTraceBenchmark& operator=(RegisterTraceBenchmark&&) = delete;
+};
+
+#endif // REGISTER_TRACE_BENCHMARK_HXX
@@ -0,0 +1,314 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <chrono>
+
+#include "ReplayBenchmark.hxx"
+#include "Cart.hxx"
+#include "FSNode.hxx"
+#include "HeadlessConsole.hxx"
+#include "InputScript.hxx"
+#include "Logger.hxx"
+#include "MD5.hxx"
+#include "Serializer.hxx"
+#include "TIAConstants.hxx"
+#include "json_lib.hxx"
+
+using namespace std::chrono;
+using json = nlohmann::json;
+
+namespace {
+  constexpr uInt32 FRAMES_DEFAULT = 600;
+
+  // The directory part of a path, including the trailing separator
+  string directoryOf(const string& path) {
+    return path.substr(0, path.find_last_of("/\\") + 1);
+  }
+
+  // Resolves paths in a suite relative to the suite's directory
+  string resolvePath(const string& baseDir, const string& path) {
+    const bool absolute = !path.empty() &&
+      (path[0] == '/' || path[0] == '\\' || (path.size() > 1 && path[1] == ':'));
+
+    return absolute ? path : baseDir + path;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ReplayBenchmark::ReplayBenchmark(int argc, char* argv[])
+{
+  for (int i = 2; i < argc; i++) {
+    string arg = argv[i];
+
+    if (arg == "-json") {
+      myJsonOutput = true;
+
+      continue;
+    }
+    else if (arg == "-update") {
+      myUpdate = true;
+
+      continue;
+    }
+    else if (arg == "-tiacheck") {
+      myCheckTia = true;
+
+      continue;
+    }
+
+    mySuites.push_back(arg);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ReplayBenchmark::run()
+{
+  // Keeps the JSON report parseable
+  Logger::instance().setLogParameters(Logger::Level::ERR, false);
+
+  if (mySuites.empty())
+    throw runtime_error("no benchmark suite given");
+
+  bool ok = true;
+  vector<Result> results;
+
+  for (const string& suite : mySuites)
+    ok = runSuite(suite, results) && ok;
+
+  if (myJsonOutput) {
+    json report = json::array();
+
+    for (const Result& result : results) {
+      json entry = json::object();
+      entry["scheme"] = result.scheme;
+      entry["rom"] = result.rom;
+      entry["ok"] = passed(result);
+
+      if (!result.error.empty())
+        entry["error"] = result.error;
+      else {
+        entry["frames"] = result.frames;
+        entry["cycles"] = result.cycles;
+        entry["realtime"] = result.realtime;
+        entry["cyclesPerSecond"] = result.cycles / result.realtime;
+        entry["hash"] = result.hash;
+        entry["expectedHash"] = result.expectedHash;
+        entry["replayOk"] = result.replayHash == result.hash;
+        if (myCheckTia)
+          entry["referenceOk"] = result.referenceHash == result.hash;
+      }
+
+      report.push_back(entry);
+    }
+
+    cout << report.dump(2) << endl;
+  }
+  else {
+    uInt32 failed = 0;
+    for (const Result& result : results)
+      if (!passed(result)) failed++;
+
+    cout << endl << results.size() << " runs, " << failed << " failed" << endl;
+  }
+
+  return ok;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ReplayBenchmark::runSuite(const string& suiteFile, vector<Result>& results) const
+{
+  stringstream buf;
+  if (FilesystemNode(suiteFile).read(buf) == 0)
+    throw runtime_error("cannot read benchmark suite '" + suiteFile + "'");
+
+  json suite;
+  try {
+    suite = json::parse(buf.str());
+  }
+  catch (const json::exception& e) {
+    throw runtime_error("invalid benchmark suite '" + suiteFile + "': " + e.what());
+  }
+
+  if (!suite.contains("runs") || !suite.at("runs").is_array())
+    throw runtime_error("invalid benchmark suite '" + suiteFile + "': no runs");
+
+  const string baseDir = directoryOf(suiteFile);
+  bool ok = true;
+
+  for (json& run : suite.at("runs")) {
+    Result result;
+
+    try {
+      result.scheme = run.value("scheme", "");
+      result.rom = run.value("rom", "");
+      result.frames = run.value("frames", FRAMES_DEFAULT);
+      result.expectedHash = run.value("hash", "");
+
+      if (result.rom.empty() || result.frames < 2)
+        throw runtime_error("invalid run");
+
+      InputScript script;
+      if (run.contains("input"))
+        script.load(resolvePath(baseDir, run.at("input").get<string>()));
+
+      runOne(resolvePath(baseDir, result.rom), script, result);
+    }
+    catch (const json::exception& e) {
+      result.error = string("invalid run: ") + e.what();
+    }
+    catch (const runtime_error& e) {
+      result.error = e.what();
+    }
+
+    if (myUpdate && result.error.empty()) {
+      run["hash"] = result.hash;
+      result.expectedHash = result.hash;
+    }
+
+    if (!myJsonOutput) printResult(result);
+
+    ok = passed(result) && ok;
+    results.push_back(result);
+  }
+
+  if (myUpdate) {
+    stringstream out;
+    out << suite.dump(2) << endl;
+
+    if (FilesystemNode(suiteFile).write(out) == 0)
+      throw runtime_error("cannot write benchmark suite '" + suiteFile + "'");
+  }
+
+  return ok;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ReplayBenchmark::runOne(const string& romFile, InputScript& script,
+                             Result& result) const
+{
+  const FilesystemNode rom(romFile);
+  const uInt32 halfway = result.frames / 2;
+
+  HeadlessConsole console{rom};
+  Serializer state;
+
+  // Only emulation is timed, not the save state taken halfway
+  const auto tStart = high_resolution_clock::now();
+  bool ok = emulate(console, script, 0, halfway);
+  auto tEnd = high_resolution_clock::now();
+
+  ok = ok && console.save(state);
+
+  const auto tResume = high_resolution_clock::now();
+  ok = ok && emulate(console, script, halfway, result.frames);
+  tEnd = high_resolution_clock::now() - tResume + tEnd;
+
+  if (!ok)
+    throw runtime_error("emulation failed");
+
+  result.cycles = console.cycles();
+  result.realtime = duration_cast<duration<double>>(tEnd - tStart).count();
+  result.hash = hashState(console);
+
+  // Replay the second half on a new console, which starts from the saved
+  // state and gets the input of the script up to this point at once
+  HeadlessConsole replay{rom};
+
+  script.rewind();
+  state.rewind();
+
+  if (!replay.load(state) || !emulate(replay, script, halfway, result.frames))
+    throw runtime_error("replay from state failed");
+
+  result.replayHash = hashState(replay);
+
+  if (!myCheckTia) return;
+
+  // Run the whole trace again, with every color clock stepped individually
+  HeadlessConsole reference{rom};
+
+  reference.tia().setScheduler(TIA::Scheduler::clock);
+  script.rewind();
+
+  if (!emulate(reference, script, 0, result.frames))
+    throw runtime_error("emulation with the reference TIA scheduler failed");
+
+  result.referenceHash = hashState(reference);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ReplayBenchmark::emulate(HeadlessConsole& console, InputScript& script,
+                              uInt32 from, uInt32 to)
+{
+  for (uInt32 frame = from; frame < to; frame++) {
+    script.apply(frame, console.event());
+
+    if (!console.emulateFrame()) return false;
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string ReplayBenchmark::hashState(HeadlessConsole& console)
+{
+  constexpr size_t RAM_SIZE = 128;
+  constexpr size_t FRAME_SIZE =
+    TIAConstants::frameBufferWidth * TIAConstants::frameBufferHeight;
+
+  size_t cartRamSize = 0;
+  const uInt8* cartRam = console.cartridge().getRAM(cartRamSize);
+
+  vector<uInt8> data(console.ram(), console.ram() + RAM_SIZE);
+  data.insert(data.end(), cartRam, cartRam + cartRamSize);
+  data.insert(data.end(), console.frameBuffer(), console.frameBuffer() + FRAME_SIZE);
+
+  return MD5::hash(data.data(), data.size());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ReplayBenchmark::passed(const Result& result)
+{
+  return result.error.empty() && result.hash == result.expectedHash &&
+    result.replayHash == result.hash &&
+    (result.referenceHash.empty() || result.referenceHash == result.hash);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ReplayBenchmark::printResult(const Result& result) const
+{
+  cout << std::left << std::setw(8) << result.scheme << std::right;
+
+  if (!result.error.empty()) {
+    cout << "ERROR: " << result.error << " (" << result.rom << ")" << endl;
+
+    return;
+  }
+
+  cout << std::setw(6) << result.frames << " frames, " << std::fixed
+       << std::setprecision(0) << std::setw(10)
+       << result.cycles / result.realtime << " cycles/s, hash "
+       << (result.expectedHash.empty() ? "missing"
+          : result.hash == result.expectedHash ? "ok" : "MISMATCH")
+       << ", replay " << (result.replayHash == result.hash ? "ok" : "MISMATCH");
+
+  if (!result.referenceHash.empty())
+    cout << ", reference TIA "
+         << (result.referenceHash == result.hash ? "ok" : "MISMATCH");
+
+  cout << endl;
+}
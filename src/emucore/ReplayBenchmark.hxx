@@ -0,0 +1,118 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef REPLAY_BENCHMARK_HXX
+#define REPLAY_BENCHMARK_HXX
+
+#include "bspf.hxx"
+
+class HeadlessConsole;
+class InputScript;
+
+/**
+  Replays fixed input traces on a set of ROMs, checks that the emulation
+  is deterministic, and reports the emulation speed for each of them.
+  Meant to catch both emulation and performance regressions, e.g. in
+  a particular bankswitching scheme.
+
+  Usage: stella -benchreplay [-json] [-update] [-tiacheck] suite ...
+
+  A suite is a JSON file holding a list of runs:
+
+    { "runs": [ { "scheme": "F8", "rom": "f8.bin", "frames": 1200,
+                  "input": "joystick.txt", "hash": "..." }, ... ] }
+
+  Paths are relative to the suite file, 'input' is an InputScript and
+  optional. Each ROM is run headless for the given number of frames, and
+  the RIOT RAM, the cart RAM and the last frame are hashed at the end.
+  The run must reproduce the recorded 'hash', and the second half of the
+  run is replayed on a new console from a state saved halfway, which must
+  arrive at the same hash. With '-update' the hashes in the suite are
+  replaced by the current ones instead. With '-tiacheck' every run is
+  repeated with the per-clock reference TIA scheduler, which must arrive
+  at the same hash as the default event scheduler. With '-json'
+  a machine-readable report is written to stdout.
+*/
+class ReplayBenchmark
+{
+  public:
+
+    ReplayBenchmark(int argc, char* argv[]);
+
+    bool run();
+
+  private:
+
+    struct Result {
+      string scheme;
+      string rom;
+      uInt32 frames{0};
+      uInt64 cycles{0};
+      double realtime{0};
+      string hash;
+      string expectedHash;
+      string replayHash;
+      string referenceHash;
+      string error;
+    };
+
+  private:
+
+    /**
+      Run all runs of the given suite; returns false if any of them failed.
+    */
+    bool runSuite(const string& suiteFile, vector<Result>& results) const;
+
+    /**
+      Run and verify a single ROM. Throws a runtime_error if the ROM or
+      the input cannot be loaded.
+    */
+    void runOne(const string& romFile, InputScript& script, Result& result) const;
+
+    /**
+      Emulate the given range of frames with the scripted input.
+    */
+    static bool emulate(HeadlessConsole& console, InputScript& script,
+                        uInt32 from, uInt32 to);
+
+    /**
+      The hash of the machine state which is checked.
+    */
+    static string hashState(HeadlessConsole& console);
+
+    static bool passed(const Result& result);
+
+    void printResult(const Result& result) const;
+
+  private:
+
+    vector<string> mySuites;
+
+    bool myJsonOutput{false};
+    bool myUpdate{false};
+    bool myCheckTia{false};
+
+  private:
+    // Following constructors and assignment operators not supported
+    ReplayBenchmark() = delete;
+    ReplayBenchmark(const ReplayBenchmark&) = delete;
+    ReplayBenchmark(ReplayBenchmark&&) = delete;
+    ReplayBenchmark& operator=(const ReplayBenchmark&) = delete;
+    ReplayBenchmark& operator=(ReplayBenchmark&&) = delete;
+};
+
+#endif // REPLAY_BENCHMARK_HXX
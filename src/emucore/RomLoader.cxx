@@ -0,0 +1,193 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "CartDetector.hxx"
+#include "MD5.hxx"
+#include "TraceRecorder.hxx"
+#include "RomLoader.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomLoader::RomLoader()
+{
+  myThread = std::thread(&RomLoader::threadMain, this);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomLoader::~RomLoader()
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myQuit = true;
+  }
+  myWakeupCondition.notify_one();
+
+  myThread.join();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RomLoader::prepare(const FilesystemNode& node)
+{
+  if(node.isDirectory() || !Bankswitch::isValidRomName(node) ||
+     BSPF::containsIgnoreCase(node.getPath(), ".zip"))
+  {
+    cancel();
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    // Already being prepared (or done)
+    if(myPath == node.getPath())
+      return true;
+
+    myPath = node.getPath();
+    ++myRequest;
+    myLoaded = false;
+    myRom = Rom();
+  }
+  myWakeupCondition.notify_one();
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomLoader::cancel()
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+
+  myPath.clear();
+  ++myRequest;
+  myLoaded = false;
+  myRom = Rom();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t RomLoader::preparedSize()
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+
+  return myLoaded ? myRom.size : 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RomLoader::take(const FilesystemNode& node, Rom& rom)
+{
+  uInt64 fileSize = 0, fileTime = 0;
+  {
+    std::unique_lock<std::mutex> lock(myMutex);
+
+    if(myPath.empty() || myPath != node.getPath())
+      return false;
+
+    myDoneCondition.wait(lock, [this]() { return myFinished == myRequest; });
+
+    const bool loaded = myLoaded;
+    if(loaded)
+    {
+      rom = std::move(myRom);
+      fileSize = myFileSize;
+      fileTime = myFileTime;
+    }
+    // Nothing is prepared anymore
+    myPath.clear();
+    myLoaded = false;
+    myRom = Rom();
+
+    if(!loaded)
+      return false;
+  }
+
+  // The file may have been changed since it was read (e.g. by rebuilding it)
+  uInt64 size = 0, mtime = 0;
+  return node.getFileInfo(size, mtime) && size == fileSize && mtime == fileTime;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomLoader::threadMain()
+{
+  if(TraceRecorder::enabled()) TraceRecorder::instance().setThreadName("RomLoader");
+
+  std::unique_lock<std::mutex> lock(myMutex);
+
+  for(;;)
+  {
+    myWakeupCondition.wait(lock, [this]() {
+      return myQuit || (!myPath.empty() && myFinished != myRequest);
+    });
+    if(myQuit)
+      return;
+
+    const string path = myPath;
+    const uInt32 request = myRequest;
+
+    lock.unlock();
+    loadRom(path, request);
+    lock.lock();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomLoader::loadRom(const string& path, uInt32 request)
+{
+  TraceRecorder::Scope traceScope("PrepareRom", "emulation");
+
+  const auto cancelled = [&]() {
+    std::lock_guard<std::mutex> lock(myMutex);
+    return myRequest != request;
+  };
+
+  const FilesystemNode node(path);
+  Rom rom;
+  uInt64 fileSize = 0, fileTime = 0;
+
+  // Without the file info, a changed file couldn't be detected later
+  bool loaded = node.getFileInfo(fileSize, fileTime);
+  try
+  {
+    if(loaded)
+      loaded = (rom.size = node.read(rom.image)) > 0;
+  }
+  catch(const runtime_error&)
+  {
+    // The ROM will be read (and the error reported) when it is started
+    loaded = false;
+  }
+
+  if(loaded && !cancelled())
+    rom.md5 = MD5::hash(rom.image, rom.size);
+  if(loaded && !cancelled())
+    rom.type = CartDetector::autodetectType(rom.image, rom.size);
+
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    // Drop the result if another ROM was requested meanwhile
+    if(myRequest != request)
+      return;
+
+    myFinished = request;
+    myLoaded = loaded;
+    if(loaded)
+    {
+      myRom = std::move(rom);
+      myFileSize = fileSize;
+      myFileTime = fileTime;
+    }
+  }
+  myDoneCondition.notify_all();
+}
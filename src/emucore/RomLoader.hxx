@@ -0,0 +1,121 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef ROM_LOADER_HXX
+#define ROM_LOADER_HXX
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "Bankswitch.hxx"
+#include "FSNode.hxx"
+#include "bspf.hxx"
+
+/**
+  Prepares the creation of a console in a background thread.
+
+  The ROM which is likely to be started next (e.g. the one selected in the
+  launcher) is read, hashed and its bankswitch type autodetected ahead of
+  time, so that only the devices and the framebuffer remain to be created
+  on the main thread once it is actually started.
+
+  Only one ROM is prepared at a time; asking for another one cancels the
+  current preparation (a read in progress is finished, but its result is
+  dropped).  A prepared ROM is only handed out while its file is unchanged.
+
+  ROMs inside ZIP archives are not prepared, since all ZIP archives are
+  accessed through a single shared handler.
+
+  @author  Stella Team
+*/
+class RomLoader
+{
+  public:
+    struct Rom {
+      ByteBuffer image;
+      size_t size{0};
+      string md5;
+      // The autodetected type of the complete image
+      Bankswitch::Type type{Bankswitch::Type::_AUTO};
+    };
+
+  public:
+    RomLoader();
+    ~RomLoader();
+
+    /**
+      Start preparing the given ROM, replacing any other one.
+
+      @return  False if the ROM cannot be prepared in the background
+    */
+    bool prepare(const FilesystemNode& node);
+
+    /**
+      Cancel the current preparation, and drop the prepared ROM.
+    */
+    void cancel();
+
+    /**
+      Get the prepared ROM, waiting for its preparation to finish if
+      necessary.  Afterwards, nothing is prepared anymore.
+
+      @param node  The ROM about to be started
+      @param rom   Receives the prepared image and its data
+
+      @return  False if the given ROM was not prepared (or has changed since)
+    */
+    bool take(const FilesystemNode& node, Rom& rom);
+
+    /**
+      The size of the prepared image (0 if none is prepared yet).
+    */
+    size_t preparedSize();
+
+  private:
+    void threadMain();
+
+    // Read, hash and autodetect the requested ROM
+    void loadRom(const string& path, uInt32 request);
+
+  private:
+    std::thread myThread;
+    std::mutex myMutex;
+    std::condition_variable myWakeupCondition;
+    std::condition_variable myDoneCondition;
+    bool myQuit{false};
+
+    // The ROM requested, and a counter identifying the request
+    string myPath;
+    uInt32 myRequest{0};
+    // The request which was last finished (or given up) by the worker
+    uInt32 myFinished{0};
+
+    // The result of the finished request
+    bool myLoaded{false};
+    Rom myRom;
+    uInt64 myFileSize{0}, myFileTime{0};
+
+  private:
+    // Following constructors and assignment operators not supported
+    RomLoader(const RomLoader&) = delete;
+    RomLoader(RomLoader&&) = delete;
+    RomLoader& operator=(const RomLoader&) = delete;
+    RomLoader& operator=(RomLoader&&) = delete;
+};
+
+#endif
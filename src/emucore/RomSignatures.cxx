@@ -0,0 +1,47 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include "SignatureScanner.hxx"
+#include "RomSignatures.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomSignatures::RomSignatures(const uInt8* image, size_t size)
+{
+  constexpr uInt32 NUM_CART_SIGNATURES = uInt32(std::tuple_size<
+      CartDetector::SignatureHits>::value);
+  constexpr uInt32 NUM_CONTROLLER_SIGNATURES = uInt32(std::tuple_size<
+      ControllerDetector::SignatureHits>::value);
+
+  // The cartridge signatures come first, followed by the controller ones
+  static const unique_ptr<SignatureScanner> scanner = []() {
+    auto s = make_unique<SignatureScanner>(
+        NUM_CART_SIGNATURES + NUM_CONTROLLER_SIGNATURES);
+
+    CartDetector::addSignatures(*s, 0);
+    ControllerDetector::addSignatures(*s, NUM_CART_SIGNATURES);
+    s->build();
+
+    return s;
+  }();
+
+  const SignatureScanner::Hits hits = scanner->scan(image, size);
+
+  std::copy_n(hits.begin(), NUM_CART_SIGNATURES, myCartHits.begin());
+  std::copy_n(hits.begin() + NUM_CART_SIGNATURES, NUM_CONTROLLER_SIGNATURES,
+              myControllerHits.begin());
+}
@@ -0,0 +1,67 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef ROM_SIGNATURES_HXX
+#define ROM_SIGNATURES_HXX
+
+#include "CartDetector.hxx"
+#include "ControllerDetector.hxx"
+#include "bspf.hxx"
+
+/**
+  The byte signatures which the cartridge and the controller detection
+  search for, found in a single pass over a ROM image.  Scan an image
+  once, and pass the result to CartDetector::autodetectType() and to
+  ControllerDetector::detectType() for both ports.
+
+  @author  Stella Team
+*/
+class RomSignatures
+{
+  public:
+    /**
+      Scan the image for the signatures of both detectors.
+
+      @param image  A pointer to the ROM image
+      @param size   The size of the ROM image
+    */
+    RomSignatures(const uInt8* image, size_t size);
+
+  private:
+    friend class CartDetector;
+    friend class ControllerDetector;
+
+    const CartDetector::SignatureHits& cartHits() const { return myCartHits; }
+    const ControllerDetector::SignatureHits& controllerHits() const {
+      return myControllerHits;
+    }
+
+  private:
+    CartDetector::SignatureHits myCartHits{};
+    ControllerDetector::SignatureHits myControllerHits{};
+
+  private:
+    // Following constructors and assignment operators not supported
+    RomSignatures() = delete;
+    RomSignatures(const RomSignatures&) = delete;
+    RomSignatures(RomSignatures&&) = delete;
+    RomSignatures& operator=(const RomSignatures&) = delete;
+    RomSignatures& operator=(RomSignatures&&) = delete;
+};
+
+#endif
@@ -61,6 +61,14 @@ class SaveKey : public Controller
   public:
     using Controller::read;
 
+    /**
+      Read the entire state of all digital pins for this controller.
+      The EEPROM pins are read one by one, since they change at read time.
+
+      @return The state of all digital pins
+    */
+    uInt8 read() override { return readDigitalPins(); }
+
     /**
       Read the value of the specified digital pin for this controller.
 
@@ -30,6 +30,11 @@
   strings are written as characters prepended by the length of the string,
   boolean values are written using a special character pattern.
 
+  Alternatively, the data can be serialized to / from a caller-provided
+  buffer of fixed capacity; this doesn't allocate and avoids the overhead
+  of the iostream machinery, and is meant for frequently taken in-memory
+  states (rewind, libretro, forking).
+
   @author  Stephen Anthony
 */
 class Serializer
@@ -52,12 +57,26 @@ class Serializer
     explicit Serializer(const string& filename, Mode m = Mode::ReadWrite);
     Serializer();
 
+    /**
+      Creates a new Serializer device that reads from and writes to the
+      given buffer. Writing beyond the capacity of the buffer, or reading
+      beyond the data written so far, throws an exception.
+    */
+    Serializer(uInt8* buffer, size_t capacity);
+
+    /**
+      Creates a new read-only Serializer device on the given data.
+    */
+    Serializer(const uInt8* buffer, size_t size);
+
   public:
     /**
       Answers whether the serializer is currently initialized for reading
       and writing.
     */
-    explicit operator bool() const { return myStream != nullptr; }
+    explicit operator bool() const {
+      return myStream != nullptr || myReadBuffer != nullptr;
+    }
 
     /**
       Resets the read/write location to the beginning of the stream.
@@ -69,6 +88,12 @@ class Serializer
     */
     size_t size() const;
 
+    /**
+      Returns the underlying buffer, or nullptr if this device is backed
+      by a stream.
+    */
+    const uInt8* data() const { return myReadBuffer; }
+
     /**
       Reads a byte value (unsigned 8-bit) from the current input stream.
 
@@ -215,10 +240,23 @@ class Serializer
     */
     void putBool(bool b);
 
+  private:
+    void read(void* data, size_t size) const;
+    void write(const void* data, size_t size);
+
   private:
     // The stream to send the serialized data to.
     unique_ptr<iostream> myStream;
 
+    // Alternatively, the buffer the data is serialized to / from. The write
+    // pointer is null if the buffer is read-only.
+    const uInt8* myReadBuffer{nullptr};
+    uInt8* myWriteBuffer{nullptr};
+    size_t myCapacity{0};
+    mutable size_t myReadPos{0};
+    size_t myWritePos{0};
+    size_t myEnd{0};
+
     static constexpr uInt8 TruePattern = 0xfe, FalsePattern = 0x01;
 
   private:
@@ -43,6 +43,10 @@ Settings::Settings()
   setPermanent("video", "");
   setPermanent("speed", "1.0");
   setPermanent("vsync", "true");
+  setPermanent("framepacing", "true");
+  setPermanent("precisesleep", "true");
+  setPermanent("highpriority", "false");
+  setPermanent("affinity", "auto");
   setPermanent("center", "true");
   setPermanent("windowedpos", Common::Point(50, 50));
   setPermanent("display", 0);
@@ -58,6 +62,7 @@ Settings::Settings()
   setPermanent("tia.vsizeadjust", 0);
   setPermanent("tia.dbgcolors", "roygpb");
   setPermanent("tia.correct_aspect", "true");
+  setPermanent("tia.scheduler", "event");
   // Palette options
   setPermanent("palette", PaletteHandler::SETTING_STANDARD);
   setPermanent("pal.phase_ntsc", "26.2");
@@ -131,6 +136,7 @@ Settings::Settings()
   setPermanent("sssingle", "false");
   setPermanent("ss1x", "false");
   setPermanent("ssinterval", "2");
+  setPermanent("ssformat", "png");
   setPermanent("autoslot", "false");
   setPermanent("saveonexit", "none");
 
@@ -174,13 +180,28 @@ Settings::Settings()
   // Misc options
   setPermanent("loglevel", int(Logger::Level::INFO));
   setPermanent("logtoconsole", "0");
+  setPermanent("loghistory", int(Logger::DEFAULT_HISTORY));
   setPermanent("avoxport", "");
   setPermanent("fastscbios", "true");
+  setPermanent("threadedarm", "false");
+  setPermanent("fastarm", "true");
   setPermanent("threads", "false");
   setTemporary("romloadcount", "0");
   setTemporary("maxres", "");
+  setTemporary("frameprofile", "false");
+  setTemporary("eventcounters", "false");
+  setTemporary("trace", "");
   setPermanent("initials", "");
   setTemporary("turbo", "0");
+  setPermanent("turborender", "4");
+  setPermanent("runahead", "0");
+  setPermanent("inputrate", "1");
+  setTemporary("netplay", "");
+  setPermanent("netplay.port", "5400");
+  setPermanent("netplay.player", "1");
+  setPermanent("netplay.delay", "2");
+  setPermanent("netplay.rollback", "8");
+  setTemporary("stream", "");
 
 #ifdef DEBUGGER_SUPPORT
   // Debugger/disassembly options
@@ -211,6 +232,8 @@ Settings::Settings()
   setPermanent("plr.timemachine", true);
   setPermanent("plr.tm.size", 200);
   setPermanent("plr.tm.uncompressed", 60);
+  setPermanent("plr.tm.memory", 32); // MB, 0 = no limit
+  setPermanent("plr.tm.archive", "false");
   setPermanent("plr.tm.interval", "30f"); // = 0.5 seconds
   setPermanent("plr.tm.horizon", "10m"); // = ~10 minutes
   setPermanent("plr.detectedinfo", "false");
@@ -240,6 +263,8 @@ Settings::Settings()
   setPermanent("dev.timemachine", true);
   setPermanent("dev.tm.size", 1000);
   setPermanent("dev.tm.uncompressed", 600);
+  setPermanent("dev.tm.memory", 128); // MB, 0 = no limit
+  setPermanent("dev.tm.archive", "false");
   setPermanent("dev.tm.interval", "1f"); // = 1 frame
   setPermanent("dev.tm.horizon", "30s"); // = ~30 seconds
   setPermanent("dev.detectedinfo", "true");
@@ -294,6 +319,24 @@ void Settings::validate()
   f = getFloat("speed");
   if (f <= 0) setValue("speed", "1.0");
 
+  i = getInt("turborender");
+  if(i < 1) setValue("turborender", 1);
+
+  i = getInt("runahead");
+  if(i < 0 || i > 4) setValue("runahead", 0);
+
+  i = getInt("inputrate");
+  if(i < 1 || i > 8) setValue("inputrate", 1);
+
+  i = getInt("netplay.player");
+  if(i < 1 || i > 2) setValue("netplay.player", 1);
+
+  i = getInt("netplay.delay");
+  if(i < 0 || i > 10) setValue("netplay.delay", 2);
+
+  i = getInt("netplay.rollback");
+  if(i < 1 || i > 30) setValue("netplay.rollback", 8);
+
   i = getInt("tia.vsizeadjust");
   if(i < -5 || i > 5)  setValue("tia.vsizeadjust", 0);
 
@@ -323,6 +366,9 @@ void Settings::validate()
   i = getInt("dev.tm.uncompressed");
   if(i < 0 || i > size) setValue("dev.tm.uncompressed", size);
 
+  i = getInt("dev.tm.memory");
+  if(i < 0 || i > 1024) setValue("dev.tm.memory", 128);
+
   /*i = getInt("dev.tm.interval");
   if(i < 0 || i > 5) setValue("dev.tm.interval", 0);
 
@@ -342,6 +388,9 @@ void Settings::validate()
   i = getInt("plr.tm.uncompressed");
   if(i < 0 || i > size) setValue("plr.tm.uncompressed", size);
 
+  i = getInt("plr.tm.memory");
+  if(i < 0 || i > 1024) setValue("plr.tm.memory", 32);
+
   /*i = getInt("plr.tm.interval");
   if(i < 0 || i > 5) setValue("plr.tm.interval", 3);
 
@@ -406,6 +455,9 @@ void Settings::validate()
   i = getInt("loglevel");
   if(i < int(Logger::Level::MIN) || i > int(Logger::Level::MAX))
     setValue("loglevel", int(Logger::Level::INFO));
+
+  i = getInt("loghistory");
+  if(i < 1) setValue("loghistory", int(Logger::DEFAULT_HISTORY));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -430,6 +482,11 @@ void Settings::usage() const
     << "                 software        Software mode (no acceleration)\n"
     << endl
     << "  -vsync        <1|0>          Enable 'synchronize to vertical blank interrupt'\n"
+    << "  -framepacing  <1|0>          Lock emulation to the vertical blank (needs vsync)\n"
+    << "  -precisesleep <1|0>          Spin shortly before frame deadlines instead of sleeping\n"
+    << "  -highpriority <1|0>          Raise the priority of the emulation threads\n"
+    << "  -affinity     <auto|off|..>  Pin the main, emulation, audio and timer threads\n"
+    << "                                to CPU cores (e.g. '0,2,3,*')\n"
     << "  -fullscreen   <1|0>          Enable fullscreen mode\n"
     << "  -center       <1|0>          Centers game window in windowed modes\n"
     << "  -windowedpos  <XxY>          Sets the window position in windowed emulator mode\n"
@@ -454,6 +511,15 @@ void Settings::usage() const
     << endl
     << "  -speed        <number>       Run emulation at the given speed\n"
     << "  -turbo        <1|0>          Enable 'Turbo' mode for maximum emulation speed\n"
+    << "  -turborender  <number>       Draw only every nth frame in 'Turbo' mode\n"
+    << "  -runahead     <0-4>          Display frames emulated ahead to hide input lag\n"
+    << "  -inputrate    <1-8>          Sample input the given number of times per frame\n"
+    << "  -netplay      <host:port>    Play online against the given peer\n"
+    << "  -netplay.port     <number>   Local UDP port for netplay\n"
+    << "  -netplay.player   <1|2>      Joystick port of the local player\n"
+    << "  -netplay.delay    <0-10>     Frames of input delay for netplay\n"
+    << "  -netplay.rollback <1-30>     Maximum number of frames rolled back\n"
+    << "  -stream       <host:port>    Stream video and audio to a spectator\n"
     << "  -uimessages   <1|0>          Show onscreen UI messages for different events\n"
     << "  -pausedim     <1|0>          Enable emulation dimming in pause mode\n"
     << endl
@@ -465,7 +531,7 @@ void Settings::usage() const
     << "  -audio.sample_rate        <number>   Output sample rate (44100|48000|96000)\n"
     << "  -audio.fragment_size      <number>   Fragment size (128|256|512|1024|\n"
     << "                                        2048|4096)\n"
-    << "  -audio.resampling_quality <1-3>      Resampling quality\n"
+    << "  -audio.resampling_quality <1-4>      Resampling quality\n"
     << "  -audio.headroom           <0-20>     Additional half-frames to prebuffer\n"
     << "  -audio.buffer_size        <0-20>     Max. number of additional half-\n"
     << "                                        frames to buffer\n"
@@ -483,6 +549,8 @@ void Settings::usage() const
     << "  -tia.dbgcolors   <string>     Debug colors to use for each object (see manual\n"
     << "                                 for description)\n"
     << "  -tia.correct_aspect <1|0>     Enable aspect ratio correct scaling\n"
+    << "  -tia.scheduler   <event|clock> Step the TIA from event to event, or clock by\n"
+    << "                                 clock (slow reference)\n"
     << endl
     << "  -tv.filter    <0-5>           Set TV effects off (0) or to specified mode\n"
     << "                                 (1-5)\n"
@@ -501,6 +569,7 @@ void Settings::usage() const
     << "  -loglevel     <0|1|2>        Set level of logging during application run\n"
     << endl
     << "  -logtoconsole <1|0>          Log output to console/commandline\n"
+    << "  -loghistory   <number>       Number of log messages kept in memory\n"
     << "  -joydeadzone  <number>       Sets 'deadzone' area for analog joysticks (0-29)\n"
     << "  -joyallow4    <1|0>          Allow all 4 directions on a joystick to be\n"
     << "                                pressed simultaneously\n"
@@ -524,6 +593,8 @@ void Settings::usage() const
     << "  -modcombo     <1|0>          Enable modifier key combos\n"
     << "                                (Control-Q for quit may not work when disabled!)\n"
     << "  -fastscbios   <1|0>          Disable Supercharger BIOS progress loading bars\n"
+    << "  -threadedarm  <1|0>          Use threaded code dispatch in ARM emulation\n"
+    << "  -fastarm      <1|0>          Skip ARM cycle counting with player settings\n"
     << "  -threads      <1|0>          Whether to using multi-threading during\n"
     << "                                emulation\n"
     << "  -snapsavedir  <path>         The directory to save snapshot files to\n"
@@ -535,6 +606,8 @@ void Settings::usage() const
     << "                                scaling/effects)\n"
     << "  -ssinterval   <number>       Number of seconds between snapshots in\n"
     << "                                continuous snapshot mode\n"
+    << "  -ssformat     <png|y4m>      Record continuous snapshots as PNG images or\n"
+    << "                                as a Y4M video\n"
     << endl
     << "  -saveonexit   <none|current| Automatically save state(s) when exiting\n"
     << "                 all>           emulation\n"
@@ -597,6 +670,12 @@ void Settings::usage() const
     << "                                direction/fire button held down\n"
     << "  -maxres       <WxH>          Used by developers to force the maximum size of\n"
     << "                                the application window\n"
+    << "  -frameprofile <1|0>          Time the stages of each frame, show them in the\n"
+    << "                                console info overlay and save them on exit\n"
+    << "  -eventcounters <1|0>         Count costly emulation events per frame, show\n"
+    << "                                them in the console info overlay\n"
+    << "  -trace        <file>         Record a timeline of emulation, main loop, audio\n"
+    << "                                and rewind activity into a Chrome trace file\n"
     << "  -basedir  <path>             Override the base directory for all config files\n"
     << "  -baseinappdir                Override the base directory for all config files\n"
     << "                                by attempting to use the application directory\n"
@@ -743,6 +822,18 @@ void Settings::setValue(const string& key, const Variant& value, bool persist)
     myTemporarySettings[key] = value;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const Variant& Settings::slot(const string& key)
+{
+  // std::map never moves its elements, so the reference stays valid for
+  // the lifetime of the settings
+  auto it = myPermanentSettings.find(key);
+  if(it != myPermanentSettings.end())
+    return it->second;
+
+  return myTemporarySettings[key];
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Settings::setPermanent(const string& key, const Variant& value)
 {
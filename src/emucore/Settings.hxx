@@ -106,6 +106,41 @@ class Settings
     const Common::Size getSize(const string& key) const { return value(key).toSize(); }
     const Common::Point getPoint(const string& key) const { return value(key).toPoint(); }
 
+    /**
+      A setting which is looked up once, and can then be read as cheaply as
+      a field.  It refers to the slot the setting is stored in, which is
+      updated in place by 'setValue', so it always yields the current value.
+      A handle must not outlive the Settings object it was obtained from.
+    */
+    template<typename T>
+    class Handle
+    {
+      public:
+        Handle() = default;
+
+        T get() const;
+        T operator()() const { return get(); }
+
+        explicit operator bool() const { return mySlot != nullptr; }
+
+      private:
+        friend class Settings;
+        explicit Handle(const Variant& slot) : mySlot{&slot} { }
+
+        const Variant* mySlot{nullptr};
+    };
+
+    /**
+      Resolve the specified key into a typed handle.  If the key doesn't
+      exist yet, it is created as an empty temporary setting, so that
+      values set later on are seen through the handle.
+
+      @param key  The key of the setting to lookup
+      @return  The handle of the setting
+    */
+    template<typename T>
+    Handle<T> handle(const string& key) { return Handle<T>(slot(key)); }
+
   protected:
     /**
       Add key/value pair to specified map.  Note that these should only be called
@@ -117,6 +152,11 @@ class Settings
     void setTemporary(const string& key, const Variant& value);
 
   private:
+    /**
+      Answer the storage of the specified key, creating it if necessary.
+    */
+    const Variant& slot(const string& key);
+
     /**
       This method must be called *after* settings have been fully loaded
       to validate (and change, if necessary) any improper settings.
@@ -152,4 +192,14 @@ class Settings
     Settings& operator=(Settings&&) = delete;
 };
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<> inline int Settings::Handle<int>::get() const {
+  return mySlot->toInt();
+}
+template<> inline float Settings::Handle<float>::get() const {
+  return mySlot->toFloat();
+}
+template<> inline bool Settings::Handle<bool>::get() const {
+  return mySlot->toBool();
+}
 #endif
@@ -0,0 +1,175 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#if defined(BSPF_WINDOWS)
+  #include "Windows.hxx"
+#else
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <sys/mman.h>
+#endif
+
+#include "HeadlessConsole.hxx"
+#include "Cart.hxx"
+#include "Event.hxx"
+#include "TIAConstants.hxx"
+#include "SharedStateExport.hxx"
+
+namespace {
+  // Must match the order of SharedStateExport::InputBit
+  constexpr std::array<Event::Type, SharedStateExport::NumInputBits> INPUT_EVENTS = {
+    Event::LeftJoystickUp, Event::LeftJoystickDown, Event::LeftJoystickLeft,
+    Event::LeftJoystickRight, Event::LeftJoystickFire,
+    Event::RightJoystickUp, Event::RightJoystickDown, Event::RightJoystickLeft,
+    Event::RightJoystickRight, Event::RightJoystickFire,
+    Event::ConsoleSelect, Event::ConsoleReset,
+    Event::ConsoleColor, Event::ConsoleBlackWhite,
+    Event::ConsoleLeftDiffA, Event::ConsoleLeftDiffB,
+    Event::ConsoleRightDiffA, Event::ConsoleRightDiffB
+  };
+
+  constexpr uInt32 RAM_SIZE = 128;
+
+  // Keep the data blocks aligned for SIMD consumers
+  constexpr uInt32 align(uInt32 offset) { return (offset + 63) & ~63U; }
+}
+
+// The region is shared between processes, so the atomics must not depend
+// on a lock inside of this process
+static_assert(std::atomic<uInt32>::is_always_lock_free,
+              "32 bit atomics must be lock free");
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SharedStateExport::SharedStateExport(const string& name, HeadlessConsole& console)
+  : myConsole{console},
+    myName{name}
+{
+  Header header;
+
+  header.frameWidth = TIAConstants::H_PIXEL;
+  header.frameHeight = TIAConstants::frameBufferHeight;
+  header.frameOffset = align(sizeof(Header));
+  header.ramOffset = align(header.frameOffset + header.frameWidth * header.frameHeight);
+  header.cartRamOffset = align(header.ramOffset + RAM_SIZE);
+  header.cartRamSize = console.cartridge().internalRamSize();
+  header.size = align(header.cartRamOffset + header.cartRamSize);
+
+  mySize = header.size;
+
+#if defined(BSPF_WINDOWS)
+  myMapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                 0, DWORD(mySize), name.c_str());
+  if(myMapping == nullptr)
+    throw runtime_error("cannot create shared memory '" + name + "'");
+
+  myRegion = static_cast<uInt8*>(
+    MapViewOfFile(myMapping, FILE_MAP_ALL_ACCESS, 0, 0, mySize));
+#else
+  myFd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+  if(myFd < 0)
+    throw runtime_error("cannot create shared memory '" + name + "'");
+
+  void* region = MAP_FAILED;
+  if(ftruncate(myFd, off_t(mySize)) == 0)
+    region = mmap(nullptr, mySize, PROT_READ | PROT_WRITE, MAP_SHARED, myFd, 0);
+  if(region != MAP_FAILED)
+    myRegion = static_cast<uInt8*>(region);
+#endif
+
+  if(myRegion == nullptr)
+  {
+    unmap();
+    throw runtime_error("cannot map shared memory '" + name + "'");
+  }
+
+  std::fill_n(myRegion, mySize, 0);
+  myHeader = new(myRegion) Header;
+
+  myHeader->size = header.size;
+  myHeader->frameWidth = header.frameWidth;
+  myHeader->frameHeight = header.frameHeight;
+  myHeader->frameOffset = header.frameOffset;
+  myHeader->ramOffset = header.ramOffset;
+  myHeader->cartRamOffset = header.cartRamOffset;
+  myHeader->cartRamSize = header.cartRamSize;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SharedStateExport::~SharedStateExport()
+{
+  unmap();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SharedStateExport::unmap()
+{
+#if defined(BSPF_WINDOWS)
+  if(myRegion)
+    UnmapViewOfFile(myRegion);
+  if(myMapping)
+    CloseHandle(myMapping);
+  myMapping = nullptr;
+#else
+  if(myRegion)
+    munmap(myRegion, mySize);
+  if(myFd >= 0)
+  {
+    close(myFd);
+    shm_unlink(myName.c_str());
+  }
+  myFd = -1;
+#endif
+
+  myRegion = nullptr;
+  myHeader = nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SharedStateExport::publish()
+{
+  Header& header = *myHeader;
+  const uInt32 sequence = header.sequence.load(std::memory_order_relaxed);
+
+  // Odd while writing; readers which see this (or a different value after
+  // reading) retry
+  header.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  std::copy_n(myConsole.frameBuffer(), header.frameWidth * header.frameHeight,
+              myRegion + header.frameOffset);
+  std::copy_n(myConsole.ram(), RAM_SIZE, myRegion + header.ramOffset);
+
+  const Cartridge& cart = myConsole.cartridge();
+  uInt8* cartRam = myRegion + header.cartRamOffset;
+  for(uInt32 i = 0; i < header.cartRamSize; ++i)
+    cartRam[i] = cart.internalRamGetValue(uInt16(i));
+
+  header.visibleHeight = std::min(myConsole.tia().height(), header.frameHeight);
+  header.cycles = myConsole.cycles();
+  ++header.frame;
+
+  header.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SharedStateExport::applyInput(Event& event) const
+{
+  const uInt32 input = myHeader->input.load(std::memory_order_acquire);
+
+  for(uInt32 bit = 0; bit < NumInputBits; ++bit)
+    event.set(INPUT_EVENTS[bit], (input >> bit) & 1);
+}
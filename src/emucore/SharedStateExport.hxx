@@ -0,0 +1,127 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef SHARED_STATE_EXPORT_HXX
+#define SHARED_STATE_EXPORT_HXX
+
+#include <atomic>
+
+class HeadlessConsole;
+class Event;
+
+#include "bspf.hxx"
+
+/**
+  Publishes the state of a HeadlessConsole in a named shared memory region
+  (POSIX shm_open() resp. a Windows file mapping), so that other processes
+  can read it without copying it through a pipe.
+
+  The region starts with a Header, which holds the offsets of the frame
+  buffer (TIA palette indices, frameWidth x frameHeight), the 128 bytes of
+  RIOT RAM and the cart RAM (cartRamSize bytes, may be 0).
+
+  The data is protected by a sequence lock: 'sequence' is odd while a frame
+  is being written, and incremented to the next even value once it is
+  complete.  A reader copies what it needs, and retries if 'sequence' was
+  odd before or has changed afterwards.
+
+  The 'input' slot is written by the client; each bit is one of the
+  InputBit events, and is applied before the next frame is emulated.
+*/
+class SharedStateExport
+{
+  public:
+    static constexpr uInt32 MAGIC = 0x53544c41;  // 'STLA'
+    static constexpr uInt32 VERSION = 1;
+
+    enum InputBit: uInt32 {
+      LeftJoystickUp, LeftJoystickDown, LeftJoystickLeft, LeftJoystickRight,
+      LeftJoystickFire,
+      RightJoystickUp, RightJoystickDown, RightJoystickLeft, RightJoystickRight,
+      RightJoystickFire,
+      ConsoleSelect, ConsoleReset, ConsoleColor, ConsoleBlackWhite,
+      ConsoleLeftDiffA, ConsoleLeftDiffB, ConsoleRightDiffA, ConsoleRightDiffB,
+      NumInputBits
+    };
+
+    struct Header {
+      uInt32 magic{MAGIC};
+      uInt32 version{VERSION};
+      uInt32 size{0};             // total size of the region
+
+      uInt32 frameWidth{0};
+      uInt32 frameHeight{0};
+      uInt32 frameOffset{0};
+      uInt32 ramOffset{0};
+      uInt32 cartRamOffset{0};
+      uInt32 cartRamSize{0};
+
+      std::atomic<uInt32> sequence{0};
+      uInt32 visibleHeight{0};    // valid lines of the last frame
+      uInt64 frame{0};            // number of frames published so far
+      uInt64 cycles{0};           // CPU cycles at the end of the frame
+
+      std::atomic<uInt32> input{0};
+    };
+
+  public:
+    /**
+      Create the shared memory region with the given name (e.g. "/stella0"
+      on POSIX systems), sized for the given console.  Throws a
+      runtime_error if this fails.
+    */
+    SharedStateExport(const string& name, HeadlessConsole& console);
+    ~SharedStateExport();
+
+    /**
+      Copy the current frame, RAM and cart RAM into the region, and
+      signal a completed frame.
+    */
+    void publish();
+
+    /**
+      Set the events from the input slot.
+    */
+    void applyInput(Event& event) const;
+
+  private:
+    void unmap();
+
+  private:
+    HeadlessConsole& myConsole;
+    string myName;
+
+    uInt8* myRegion{nullptr};
+    size_t mySize{0};
+    Header* myHeader{nullptr};
+
+  #if defined(BSPF_WINDOWS)
+    void* myMapping{nullptr};
+  #else
+    int myFd{-1};
+  #endif
+
+  private:
+    // Following constructors and assignment operators not supported
+    SharedStateExport() = delete;
+    SharedStateExport(const SharedStateExport&) = delete;
+    SharedStateExport(SharedStateExport&&) = delete;
+    SharedStateExport& operator=(const SharedStateExport&) = delete;
+    SharedStateExport& operator=(SharedStateExport&&) = delete;
+};
+
+#endif // SHARED_STATE_EXPORT_HXX
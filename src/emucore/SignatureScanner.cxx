@@ -0,0 +1,126 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include <queue>
+
+#include "SignatureScanner.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SignatureScanner::SignatureScanner(uInt32 numIds)
+  : myNumIds{numIds}
+{
+  myTransitions.emplace_back();
+  myTransitions.back().fill(NO_STATE);
+  myMatches.emplace_back();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SignatureScanner::add(uInt32 id, const uInt8* bytes, uInt32 size)
+{
+  // Extend the trie by the signature
+  size_t state = 0;
+
+  for(uInt32 i = 0; i < size; ++i)
+  {
+    uInt16& next = myTransitions[state][bytes[i]];
+
+    if(next == NO_STATE)
+    {
+      next = static_cast<uInt16>(myTransitions.size());
+      myTransitions.emplace_back();
+      myTransitions.back().fill(NO_STATE);
+      myMatches.emplace_back();
+    }
+    state = myTransitions[state][bytes[i]];
+  }
+
+  myMatches[state].push_back(static_cast<uInt16>(myIds.size()));
+  myIds.push_back(id);
+  mySizes.push_back(static_cast<uInt8>(size));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SignatureScanner::build()
+{
+  // Breadth-first traversal of the trie, which calculates the failure link
+  // of every state (the state of the longest proper suffix that is also in
+  // the trie) and replaces missing transitions by those of the failure link
+  vector<uInt16> failure(myTransitions.size(), 0);
+  std::queue<uInt16> states;
+
+  for(auto& next: myTransitions[0])
+  {
+    if(next == NO_STATE)
+      next = 0;
+    else
+      states.push(next);
+  }
+
+  while(!states.empty())
+  {
+    const uInt16 state = states.front();
+    states.pop();
+
+    const auto& fail = myMatches[failure[state]];
+    myMatches[state].insert(myMatches[state].end(), fail.begin(), fail.end());
+
+    for(size_t byte = 0; byte < 256; ++byte)
+    {
+      uInt16& next = myTransitions[state][byte];
+      const uInt16 fallback = myTransitions[failure[state]][byte];
+
+      if(next == NO_STATE)
+        next = fallback;
+      else
+      {
+        failure[next] = fallback;
+        states.push(next);
+      }
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SignatureScanner::Hits SignatureScanner::scan(const uInt8* image, size_t size) const
+{
+  Hits hits(myNumIds, 0);
+
+  // The position at which the next occurrence of each signature may start
+  vector<size_t> nextStart(myIds.size(), 0);
+
+  uInt16 state = 0;
+  for(size_t pos = 0; pos < size; ++pos)
+  {
+    state = myTransitions[state][image[pos]];
+
+    for(const auto signature: myMatches[state])
+    {
+      const size_t start = pos + 1 - mySizes[signature];
+
+      // Like searchForBytes(), count non-overlapping occurrences only, skip
+      // the byte after each occurrence and ignore one at the very end
+      if(start >= nextStart[signature] && pos + 1 < size)
+      {
+        ++hits[myIds[signature]];
+        nextStart[signature] = pos + 2;
+      }
+    }
+  }
+
+  return hits;
+}
@@ -0,0 +1,100 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef SIGNATURE_SCANNER_HXX
+#define SIGNATURE_SCANNER_HXX
+
+#include "bspf.hxx"
+
+/**
+  Multi-pattern matcher (Aho-Corasick automaton) for the byte signatures
+  which the cartridge and controller autodetection search for.
+
+  The signatures are combined into a single automaton, which is built once
+  and then finds all signatures in a single pass over the image.  The
+  automaton is a fully expanded DFA, each state has a transition for every
+  possible byte.
+
+  Each signature belongs to an id; several signatures may share one, if
+  only their total number of occurrences is of interest.
+
+  @author  Stella Team
+*/
+class SignatureScanner
+{
+  public:
+    /**
+      The number of occurrences of the signatures of each id
+    */
+    using Hits = vector<uInt32>;
+
+    /**
+      Create an empty scanner for the given number of ids.
+    */
+    explicit SignatureScanner(uInt32 numIds);
+
+    /**
+      Add a signature; must be called before build().
+
+      @param id     The id to count the occurrences of the signature for
+      @param bytes  The byte sequence
+      @param size   The number of bytes in the sequence
+    */
+    void add(uInt32 id, const uInt8* bytes, uInt32 size);
+
+    /**
+      Complete the automaton once all signatures have been added.
+    */
+    void build();
+
+    /**
+      Count the occurrences of all signatures in the image.  Like the
+      'searchForBytes()' methods of the detectors, only non-overlapping
+      occurrences are counted, the byte after each occurrence is skipped,
+      and an occurrence ending at the very last byte is ignored.
+    */
+    Hits scan(const uInt8* image, size_t size) const;
+
+    uInt32 numIds() const { return myNumIds; }
+
+  private:
+    static constexpr uInt16 NO_STATE = 0xffff;
+
+    uInt32 myNumIds{0};
+
+    // Transition table, 256 entries per state; state 0 is the initial state
+    vector<std::array<uInt16, 256>> myTransitions;
+
+    // The signatures (indices into the following) ending in each state,
+    // including those reached by following the failure links
+    vector<vector<uInt16>> myMatches;
+
+    // The id and size of each signature
+    vector<uInt32> myIds;
+    vector<uInt8> mySizes;
+
+  private:
+    // Following constructors and assignment operators not supported
+    SignatureScanner() = delete;
+    SignatureScanner(const SignatureScanner&) = delete;
+    SignatureScanner(SignatureScanner&&) = delete;
+    SignatureScanner& operator=(const SignatureScanner&) = delete;
+    SignatureScanner& operator=(SignatureScanner&&) = delete;
+};
+
+#endif
@@ -97,6 +97,32 @@ class Sound
     */
     virtual string about() const = 0;
 
+    /**
+      Timing of the audio callback since the sound was last opened.  A
+      maximum close to the fragment period, or any underruns, indicate that
+      the fragment size is too small for the device.
+    */
+    struct CallbackStats {
+      uInt64 callbacks{0};
+      double averageMs{0.};
+      double maxMs{0.};
+      double maxIntervalMs{0.};  // the longest time between two callbacks
+      double periodMs{0.};       // the time one fragment plays
+      uInt32 underruns{0};
+      uInt32 overflows{0};       // fragments dropped by the audio queue
+    };
+
+    /**
+      The statistics, or none (no callbacks) if the sound doesn't use
+      a callback.
+    */
+    virtual CallbackStats callbackStats() const { return CallbackStats(); }
+
+    /**
+      Restart collecting the statistics (except for the fragment period).
+    */
+    virtual void resetCallbackStats() { }
+
     /**
       Get the supported devices for the audio hardware.
 
@@ -0,0 +1,260 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "Cart.hxx"
+#include "Serializer.hxx"
+#include "StateSearch.hxx"
+
+namespace {
+  constexpr std::array<std::array<Event::Type, 5>, 2> JOYSTICK_EVENTS = {{
+    { Event::LeftJoystickUp, Event::LeftJoystickDown, Event::LeftJoystickLeft,
+      Event::LeftJoystickRight, Event::LeftJoystickFire },
+    { Event::RightJoystickUp, Event::RightJoystickDown, Event::RightJoystickLeft,
+      Event::RightJoystickRight, Event::RightJoystickFire }
+  }};
+
+  // Save the state of the console into the buffer, which is resized to fit
+  bool saveState(const HeadlessConsole& console, ByteArray& buffer)
+  {
+    for(int attempt = 0; attempt < 2; ++attempt)
+    {
+      if(!buffer.empty())
+      {
+        Serializer out(buffer.data(), buffer.size());
+        if(console.save(out))
+        {
+          buffer.resize(out.size());
+          return true;
+        }
+      }
+
+      // The buffer is missing or too small, so determine the required size
+      Serializer probe;
+      if(!console.save(probe))
+        break;
+
+      buffer.resize(probe.size());
+    }
+
+    return false;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateSearch::StateSearch(uInt32 threads)
+{
+  if(threads == 0)
+    threads = std::max(std::thread::hardware_concurrency(), 1U);
+
+  for(uInt32 i = 0; i < threads; ++i)
+    myThreads.emplace_back(&StateSearch::threadMain, this, i);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateSearch::~StateSearch()
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myQuit = true;
+  }
+
+  myWakeupCondition.notify_all();
+
+  for(auto& thread : myThreads) thread.join();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<StateSearch::Branch> StateSearch::evaluate(
+    HeadlessConsole& start, const vector<Sequence>& candidates,
+    const ScoreFunc& score, size_t best, bool keepStates)
+{
+  if(!saveState(start, myStartState))
+    throw runtime_error("StateSearch: saving the start state failed");
+
+  // The workers' consoles are forked once, and reused as long as the ROM
+  // doesn't change
+  if(myConsoles.empty() || myConsoles.front()->md5() != start.md5())
+  {
+    myConsoles.clear();
+    for(size_t i = 0; i < myThreads.size(); ++i)
+    {
+      unique_ptr<HeadlessConsole> console = start.fork();
+      if(!console)
+        throw runtime_error("StateSearch: forking the start console failed");
+
+      myConsoles.push_back(std::move(console));
+    }
+  }
+
+  myCandidates = &candidates;
+  myScoreFunc = &score;
+  myKeepStates = keepStates;
+  myBranches.assign(candidates.size(), Branch{});
+
+  {
+    std::unique_lock<std::mutex> lock(myMutex);
+
+    myNextCandidate = 0;
+    myPendingWorkers = static_cast<uInt32>(myThreads.size());
+    ++myGeneration;
+
+    myWakeupCondition.notify_all();
+
+    while(myPendingWorkers > 0) myDoneCondition.wait(lock);
+  }
+
+  myCandidates = nullptr;
+  myScoreFunc = nullptr;
+
+  if(myPendingException)
+  {
+    std::exception_ptr ex = myPendingException;
+    myPendingException = nullptr;
+
+    std::rethrow_exception(ex);
+  }
+
+  vector<Branch> branches = std::move(myBranches);
+  myBranches.clear();
+
+  std::stable_sort(branches.begin(), branches.end(),
+    [](const Branch& a, const Branch& b) {
+      return a.failed != b.failed ? b.failed : a.score > b.score;
+    });
+  if(branches.size() > best)
+    branches.resize(best);
+
+  return branches;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateSearch::restore(const Branch& branch, HeadlessConsole& console)
+{
+  if(branch.state.empty())
+    return false;
+
+  Serializer in(branch.state.data(), branch.state.size());
+
+  return console.load(in);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateSearch::ScoreFunc StateSearch::highScore(const HSM::ScoresProps& info)
+{
+  return [info](HeadlessConsole& console) {
+    const Cartridge& cart = console.cartridge();
+
+    // Read the memory like HighScoresManager::peek() does
+    const Int32 score = HighScoresManager::score(info, [&](uInt16 addr) -> Int16 {
+      if(addr < 0x100U || cart.internalRamSize() == 0)
+        return console.system().peek(addr);
+      else
+        return cart.internalRamGetValue(addr);
+    });
+
+    if(score == HSM::NO_VALUE)
+      return std::numeric_limits<double>::lowest();
+
+    return info.scoreInvert ? -double(score) : double(score);
+  };
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateSearch::applyInput(Input input, Event& event)
+{
+  for(size_t player = 0; player < JOYSTICK_EVENTS.size(); ++player)
+  {
+    const uInt8 bits = uInt8(input >> (player * 8));
+
+    for(size_t i = 0; i < JOYSTICK_EVENTS[player].size(); ++i)
+      event.set(JOYSTICK_EVENTS[player][i], (bits >> i) & 1);
+  }
+
+  const uInt8 switches = uInt8(input | (input >> 8));
+  event.set(Event::ConsoleSelect, (switches & Select) != 0);
+  event.set(Event::ConsoleReset, (switches & Reset) != 0);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateSearch::threadMain(size_t index)
+{
+  uInt64 generation = 0;
+
+  for(;;)
+  {
+    {
+      std::unique_lock<std::mutex> lock(myMutex);
+
+      while(!myQuit && generation == myGeneration) myWakeupCondition.wait(lock);
+
+      if(myQuit) return;
+
+      generation = myGeneration;
+    }
+
+    try {
+      processCandidates(*myConsoles[index]);
+    }
+    catch(...) {
+      std::lock_guard<std::mutex> lock(myMutex);
+
+      if(!myPendingException) myPendingException = std::current_exception();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(myMutex);
+
+      if(--myPendingWorkers == 0) myDoneCondition.notify_one();
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateSearch::processCandidates(HeadlessConsole& console)
+{
+  size_t i;
+
+  while((i = myNextCandidate++) < myCandidates->size())
+  {
+    Branch& branch = myBranches[i];
+    branch.candidate = i;
+
+    // All workers read the same start state
+    Serializer in(static_cast<const uInt8*>(myStartState.data()), myStartState.size());
+    branch.failed = !console.load(in);
+
+    for(const Input input: (*myCandidates)[i])
+    {
+      if(branch.failed)
+        break;
+
+      applyInput(input, console.event());
+      branch.failed = !console.emulateFrame();
+    }
+    if(branch.failed)
+      continue;
+
+    branch.score = (*myScoreFunc)(console);
+
+    if(myKeepStates)
+    {
+      branch.state.resize(myStartState.size());
+      if(!saveState(console, branch.state))
+        branch.state.clear();
+    }
+  }
+}
@@ -0,0 +1,164 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef STATE_SEARCH_HXX
+#define STATE_SEARCH_HXX
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <exception>
+#include <functional>
+
+#include "bspf.hxx"
+#include "HeadlessConsole.hxx"
+#include "HighScoresManager.hxx"
+
+/**
+  Evaluates many candidate input sequences from a common state in parallel,
+  for bots and tool-assisted play which explore the input breadth-wise.
+
+  Each worker thread owns a console forked from the start console.  For
+  every candidate it claims, it loads the start state (serialized once,
+  and shared read-only by all workers), emulates the candidate's frames
+  with its input, and rates the resulting state with a user supplied
+  scoring function.  The best branches are returned, optionally with their
+  final states, so the search can continue from them.
+
+  @author  Stella Team
+*/
+class StateSearch
+{
+  public:
+    // The joystick and switch bits of one player's input
+    enum InputBit: uInt8 {
+      Up = 1 << 0, Down = 1 << 1, Left = 1 << 2, Right = 1 << 3,
+      Fire = 1 << 4, Select = 1 << 5, Reset = 1 << 6
+    };
+
+    // The input of one frame; the bits of the left player in the low
+    // byte, those of the right player in the high byte
+    using Input = uInt16;
+    using Sequence = vector<Input>;
+
+    /**
+      Rates the state of a console at the end of a candidate; higher is
+      better.  It is called on the worker threads, concurrently for
+      different consoles, so it must not access shared mutable data.
+    */
+    using ScoreFunc = std::function<double(HeadlessConsole&)>;
+
+    struct Branch {
+      size_t candidate{0};  // index into the candidates
+      double score{0.};
+      bool failed{false};   // emulation failed, the score is meaningless
+      ByteArray state;      // the final state (if requested)
+    };
+
+  public:
+    /**
+      Create a search which runs on the given number of worker threads
+      (0 = one per hardware thread).
+    */
+    explicit StateSearch(uInt32 threads = 0);
+
+    /**
+      The destructor shuts down and joins the workers.
+    */
+    ~StateSearch();
+
+    /**
+      Emulate all candidates from the current state of the given console
+      (which is left unchanged), and return the best ones, ordered by
+      their score.  Failed candidates are ranked last.  Exceptions which
+      occur on the workers are rethrown here.
+
+      @param start       The console in the start state
+      @param candidates  The input sequences to evaluate
+      @param score       Rates the final state of each candidate
+      @param best        The maximum number of branches returned
+      @param keepStates  Return the final state of each branch
+
+      @return  The best branches
+    */
+    vector<Branch> evaluate(HeadlessConsole& start, const vector<Sequence>& candidates,
+                            const ScoreFunc& score, size_t best, bool keepStates = false);
+
+    /**
+      Put the console into the final state of the given branch (which must
+      have been evaluated with 'keepStates', for the same ROM).
+    */
+    static bool restore(const Branch& branch, HeadlessConsole& console);
+
+    /**
+      A scoring function which reads the score from RAM, as defined by the
+      high score properties of the ROM (see HighScoresManager::get()).
+      Inverted scores are negated, so higher is always better.
+    */
+    static ScoreFunc highScore(const HSM::ScoresProps& info);
+
+    /**
+      Apply the input to the console's event object.
+    */
+    static void applyInput(Input input, Event& event);
+
+  private:
+    void threadMain(size_t index);
+
+    /**
+      Evaluate all candidates that have not been claimed by another worker
+      yet.
+    */
+    void processCandidates(HeadlessConsole& console);
+
+  private:
+    vector<std::thread> myThreads;
+    // One console per worker
+    vector<unique_ptr<HeadlessConsole>> myConsoles;
+
+    // The current evaluation
+    ByteArray myStartState;
+    size_t myStartStateSize{0};
+    const vector<Sequence>* myCandidates{nullptr};
+    const ScoreFunc* myScoreFunc{nullptr};
+    bool myKeepStates{false};
+    vector<Branch> myBranches;
+
+    std::mutex myMutex;
+    std::condition_variable myWakeupCondition;
+    std::condition_variable myDoneCondition;
+
+    // Incremented for every evaluation; workers wake up when it changes
+    uInt64 myGeneration{0};
+    uInt32 myPendingWorkers{0};
+    bool myQuit{false};
+
+    // Index of the next candidate that is to be claimed by a worker
+    std::atomic<size_t> myNextCandidate{0};
+
+    std::exception_ptr myPendingException;
+
+  private:
+    // Following constructors and assignment operators not supported
+    StateSearch(const StateSearch&) = delete;
+    StateSearch(StateSearch&&) = delete;
+    StateSearch& operator=(const StateSearch&) = delete;
+    StateSearch& operator=(StateSearch&&) = delete;
+};
+
+#endif // STATE_SEARCH_HXX
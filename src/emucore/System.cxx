@@ -39,6 +39,9 @@ System::System(Random& random, M6502& m6502, M6532& m6532,
   PageAccess access(&myNullDevice, System::PageAccessType::READ);
   myPageAccessTable.fill(access);
   myPageIsDirtyTable.fill(false);
+#ifdef DEBUGGER_SUPPORT
+  myPageTrapTable.fill(0);
+#endif
 
   // Bus starts out unlocked (in other words, peek() changes myDataBusState)
   myDataBusLocked = false;
@@ -47,6 +50,12 @@ System::System(Random& random, M6502& m6502, M6532& m6532,
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void System::initialize()
 {
+#ifdef DEBUGGER_SUPPORT
+  // Allocate before installing, so the cart's pages point into the arrays
+  if(myAccessTracking)
+    myCart.enableRomAccessArrays();
+#endif
+
   // Install all devices
   myM6532.install(*this);
   myTIA.install(*this);
@@ -54,6 +63,16 @@ void System::initialize()
   myM6502.install(*this);  // Must always be installed last
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::setAccessTracking(bool enable)
+{
+  myAccessTracking = enable;
+#ifdef DEBUGGER_SUPPORT
+  if(enable)
+    myCart.enableRomAccessArrays();
+#endif
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void System::reset(bool autodetect)
 {
@@ -104,18 +123,21 @@ uInt8 System::peek(uInt16 addr, Device::AccessFlags flags)
   const PageAccess& access = getPageAccess(addr);
 
 #ifdef DEBUGGER_SUPPORT
-  // Set access type
-  if(access.romAccessBase)
-    *(access.romAccessBase + (addr & PAGE_MASK)) |= (flags | (addr & Device::HADDR));
-  else
-    access.device->setAccessFlags(addr, flags);
-  // Increase access counter
-  if(flags != Device::NONE)
+  if(myAccessTracking)
   {
-    if(access.romPeekCounter)
-      *(access.romPeekCounter + (addr & PAGE_MASK)) += 1;
+    // Set access type
+    if(access.romAccessBase)
+      *(access.romAccessBase + (addr & PAGE_MASK)) |= (flags | (addr & Device::HADDR));
     else
-      access.device->increaseAccessCounter(addr);
+      access.device->setAccessFlags(addr, flags);
+    // Increase access counter
+    if(flags != Device::NONE)
+    {
+      if(access.romPeekCounter)
+        *(access.romPeekCounter + (addr & PAGE_MASK)) += 1;
+      else
+        access.device->increaseAccessCounter(addr);
+    }
   }
 #endif
 
@@ -141,18 +163,21 @@ void System::poke(uInt16 addr, uInt8 value, Device::AccessFlags flags)
   const PageAccess& access = myPageAccessTable[page];
 
 #ifdef DEBUGGER_SUPPORT
-  // Set access type
-  if(access.romAccessBase)
-    *(access.romAccessBase + (addr & PAGE_MASK)) |= (flags | (addr & Device::HADDR));
-  else
-    access.device->setAccessFlags(addr, flags);
-  // Increase access counter
-  if(flags != Device::NONE)
+  if(myAccessTracking)
   {
-    if(access.romPokeCounter)
-      *(access.romPokeCounter + (addr & PAGE_MASK)) += 1;
+    // Set access type
+    if(access.romAccessBase)
+      *(access.romAccessBase + (addr & PAGE_MASK)) |= (flags | (addr & Device::HADDR));
     else
-      access.device->increaseAccessCounter(addr, true);
+      access.device->setAccessFlags(addr, flags);
+    // Increase access counter
+    if(flags != Device::NONE)
+    {
+      if(access.romPokeCounter)
+        *(access.romPokeCounter + (addr & PAGE_MASK)) += 1;
+      else
+        access.device->increaseAccessCounter(addr, true);
+    }
   }
 #endif
 
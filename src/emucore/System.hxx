@@ -28,6 +28,7 @@ class Cartridge;
 #include "NullDev.hxx"
 #include "Random.hxx"
 #include "Serializable.hxx"
+#include "EventCounters.hxx"
 
 /**
   This class represents a system consisting of a 6502 microprocessor
@@ -196,6 +197,66 @@ class System : public Serializable
     */
     void poke(uInt16 address, uInt8 value, Device::AccessFlags flags = Device::NONE);
 
+    /**
+      Inline variants of peek() and poke() for the CPU, for pages with a
+      direct peek/poke base. They return false if the access must go
+      through peek() resp. poke() instead (device accesses, access
+      tracking); the CPU only brings the system clock up to date for these
+      (see M6502::syncCycles()). The result is identical to calling peek()
+      and poke().
+    */
+    bool cpuPeekDirect(uInt16 address, uInt8& result) {
+      const PageAccess& access = getPageAccess(address);
+
+    #ifdef DEBUGGER_SUPPORT
+      if(myAccessTracking || !access.directPeekBase)
+    #else
+      if(!access.directPeekBase)
+    #endif
+        return false;
+
+      result = access.directPeekBase[address & PAGE_MASK];
+    #ifdef DEBUGGER_SUPPORT
+      if(!myDataBusLocked)
+    #endif
+        myDataBusState = result;
+
+      return true;
+    }
+    bool cpuPokeDirect(uInt16 address, uInt8 value) {
+      const uInt16 page = (address & ADDRESS_MASK) >> PAGE_SHIFT;
+      const PageAccess& access = myPageAccessTable[page];
+
+    #ifdef DEBUGGER_SUPPORT
+      if(myAccessTracking || !access.directPokeBase)
+    #else
+      if(!access.directPokeBase)
+    #endif
+        return false;
+
+      access.directPokeBase[address & PAGE_MASK] = value;
+      myPageIsDirtyTable[page] = true;
+    #ifdef DEBUGGER_SUPPORT
+      if(!myDataBusLocked)
+    #endif
+        myDataBusState = value;
+
+      return true;
+    }
+
+    /**
+      Like peek() and poke(), but using the direct peek/poke base where
+      possible.
+    */
+    uInt8 cpuPeek(uInt16 address, Device::AccessFlags flags) {
+      uInt8 result;
+      return cpuPeekDirect(address, result) ? result : peek(address, flags);
+    }
+    void cpuPoke(uInt16 address, uInt8 value, Device::AccessFlags flags) {
+      if(!cpuPokeDirect(address, value))
+        poke(address, value, flags);
+    }
+
     /**
       Lock/unlock the data bus. When the bus is locked, peek() and
       poke() don't update the bus state. The bus should be unlocked
@@ -208,6 +269,19 @@ class System : public Serializable
     void lockDataBus()   { myDataBusLocked = true;  }
     void unlockDataBus() { myDataBusLocked = false; }
 
+    /**
+      Enable/disable recording of access flags and access counters on
+      every peek() and poke(). This information is only consumed by the
+      debugger and disassembler, so it can be switched off when neither
+      is going to be used (e.g. headless emulation). Has no effect in
+      builds without debugger support, which never record it.
+
+      The cart's ROM access arrays are allocated when tracking is first
+      enabled.
+    */
+    void setAccessTracking(bool enable);
+    bool accessTracking() const { return myAccessTracking; }
+
   #ifdef DEBUGGER_SUPPORT
     /**
       Access and modify the access type flags for the given
@@ -223,6 +297,51 @@ class System : public Serializable
       @param address The address to modify
     */
     void increaseAccessCounter(uInt16 address, bool isWrite);
+
+    /**
+      Bits for the page trap table, indicating which kinds of traps are
+      set for any address within a page (or one of its mirrors)
+    */
+    static constexpr uInt8
+      PageReadTrap  = 1 << 0,
+      PageWriteTrap = 1 << 1;
+
+    /**
+      Set the kinds of traps which are set for the page containing the
+      given address. The CPU only checks its (per address) trap arrays
+      for accesses to pages marked here, all other pages are accessed
+      without any trap overhead.
+
+      @param addr   The address/page the traps should be set for
+      @param traps  The kinds of traps set for that page (PageReadTrap, PageWriteTrap)
+    */
+    void setPageTraps(uInt16 addr, uInt8 traps) {
+      uInt8& pageTraps = myPageTrapTable[(addr & ADDRESS_MASK) >> PAGE_SHIFT];
+
+      myNumTrappedPages += (traps != 0) - (pageTraps != 0);
+      pageTraps = traps;
+    }
+
+    /**
+      Get the kinds of traps which are set for the page containing the
+      given address.
+    */
+    uInt8 pageTraps(uInt16 addr) const {
+      return myPageTrapTable[(addr & ADDRESS_MASK) >> PAGE_SHIFT];
+    }
+
+    /**
+      Answer whether traps are set for any page.
+    */
+    bool hasPageTraps() const { return myNumTrappedPages > 0; }
+
+    /**
+      Remove the traps of all pages.
+    */
+    void clearPageTraps() {
+      myPageTrapTable.fill(0);
+      myNumTrappedPages = 0;
+    }
   #endif
 
   public:
@@ -303,9 +422,23 @@ class System : public Serializable
       @param access The accessing methods to be used by the page
     */
     void setPageAccess(uInt16 addr, const PageAccess& access) {
+      EventCounters::count(EventCounters::Event::pageRemap);
       myPageAccessTable[(addr & ADDRESS_MASK) >> PAGE_SHIFT] = access;
     }
 
+    /**
+      Set the page accessing methods for a run of consecutive pages,
+      starting at the specified address.
+
+      @param addr    The address of the first page
+      @param access  The accessing methods to be used by the pages
+      @param pages   The number of pages to set
+    */
+    void setPageAccess(uInt16 addr, const PageAccess* access, uInt16 pages) {
+      EventCounters::count(EventCounters::Event::pageRemap, pages);
+      std::copy_n(access, pages, &myPageAccessTable[(addr & ADDRESS_MASK) >> PAGE_SHIFT]);
+    }
+
     /**
       Get the page accessing method for the specified address.
 
@@ -384,16 +517,8 @@ class System : public Serializable
     // Number of system cycles executed since last reset
     uInt64 myCycles{0};
 
-    // Null device to use for page which are not installed
-    NullDevice myNullDevice;
-
-    // The list of PageAccess structures
-    std::array<PageAccess, NUM_PAGES> myPageAccessTable;
-
-    // The list of dirty pages
-    std::array<bool, NUM_PAGES> myPageIsDirtyTable;
-
-    // The current state of the Data Bus
+    // The current state of the Data Bus (kept next to the cycle counter,
+    // since both are used by every access, unlike the page tables below)
     uInt8 myDataBusState{0};
 
     // Whether or not peek() updates the data bus state. This
@@ -401,11 +526,29 @@ class System : public Serializable
     // debugger is active.
     bool myDataBusLocked{false};
 
+    // Whether peek() and poke() record access flags and counters
+    bool myAccessTracking{true};
+
     // Whether autodetection is currently running (ie, the emulation
     // core is attempting to autodetect display settings, cart modes, etc)
     // Some parts of the codebase need to act differently in such a case
     bool mySystemInAutodetect{false};
 
+    // Null device to use for page which are not installed
+    NullDevice myNullDevice;
+
+    // The list of PageAccess structures
+    std::array<PageAccess, NUM_PAGES> myPageAccessTable;
+
+    // The list of dirty pages
+    std::array<bool, NUM_PAGES> myPageIsDirtyTable;
+
+  #ifdef DEBUGGER_SUPPORT
+    // The kinds of traps set for each page, and the number of such pages
+    std::array<uInt8, NUM_PAGES> myPageTrapTable;
+    uInt32 myNumTrappedPages{0};
+  #endif
+
   private:
     // Following constructors and assignment operators not supported
     System() = delete;
@@ -16,6 +16,7 @@
 //============================================================================
 
 #include <cmath>
+#include <cstring>
 
 #include "FBSurface.hxx"
 #include "Settings.hxx"
@@ -24,6 +25,7 @@
 #include "TIA.hxx"
 #include "PNGLibrary.hxx"
 #include "PaletteHandler.hxx"
+#include "FrameProfiler.hxx"
 #include "TIASurface.hxx"
 
 namespace {
@@ -42,6 +44,38 @@ namespace {
       ScalingInterpolation::sharp;
 #endif
   }
+
+  // Continue a 64 bit hash over one scanline, using the xxHash64 round
+  // per word and the MurmurHash3 finalizer per line.  Each step is a
+  // bijection of the hash, so a change within a single scanline always
+  // changes it, and all bits of the hash depend on every pixel.
+  uInt64 hashScanline(uInt64 hash, const uInt8* line, uInt32 width)
+  {
+    constexpr uInt64 PRIME1 = 0x9e3779b185ebca87ULL;
+    constexpr uInt64 PRIME2 = 0xc2b2ae3d27d4eb4fULL;
+    const auto mixWord = [](uInt64 h, uInt64 word) {
+      h += word * PRIME2;
+      return ((h << 31) | (h >> 33)) * PRIME1;
+    };
+    uInt32 x = 0;
+
+    for(; x + sizeof(uInt64) <= width; x += sizeof(uInt64))
+    {
+      uInt64 word;
+      std::memcpy(&word, line + x, sizeof(uInt64));
+      hash = mixWord(hash, word);
+    }
+    for(; x < width; ++x)
+      hash = mixWord(hash, line[x]);
+
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+
+    return hash;
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -88,8 +122,9 @@ TIASurface::TIASurface(OSystem& system)
 
   myRGBFramebuffer.fill(0);
 
-  // Enable/disable threading in the NTSC TV effects renderer
-  myNTSCFilter.enableThreading(myOSystem.settings().getBool("threads"));
+  // Enable/disable threading in the NTSC TV effects renderer and the
+  // post-processing pipeline
+  enableThreading(myOSystem.settings().getBool("threads"));
 
   myPaletteHandler = make_unique<PaletteHandler>(myOSystem);
   myPaletteHandler->loadConfig(myOSystem.settings());
@@ -98,6 +133,7 @@ TIASurface::TIASurface(OSystem& system)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TIASurface::~TIASurface()
 {
+  stopPipeline();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -105,6 +141,7 @@ void TIASurface::initialize(const Console& console,
                             const VideoModeHandler::Mode& mode)
 {
   myTIA = &(console.tia());
+  invalidateFrame();
 
   myTiaSurface->setDstPos(mode.imageR.x(), mode.imageR.y());
   myTiaSurface->setDstSize(mode.imageR.w(), mode.imageR.h());
@@ -148,7 +185,10 @@ cerr << "SLine:\n"
 void TIASurface::setPalette(const PaletteArray& tia_palette,
                             const PaletteArray& rgb_palette)
 {
+  invalidateFrame();
+
   myPalette = tia_palette;
+  myRGBPalette = rgb_palette;
 
   // The NTSC filtering needs access to the raw RGB data, since it calculates
   // its own internal palette
@@ -168,6 +208,7 @@ const FBSurface& TIASurface::baseSurface(Common::Rect& rect) const
   for(uInt32 y = 0; y < height; ++y)
     for(uInt32 x = 0; x < width; ++x)
         *buf_ptr++ = myPalette[*(myTIA->frameBuffer() + y * tiaw + x / 2)];
+  myBaseTiaSurface->setDirty();
 
   return *myBaseTiaSurface;
 }
@@ -276,6 +317,8 @@ void TIASurface::setScanlineIntensity(int direction)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 TIASurface::enableScanlines(int change)
 {
+  invalidateFrame();
+
   FBSurface::Attributes& attr = mySLineSurface->attributes();
 
   attr.blendalpha += change;
@@ -288,6 +331,8 @@ uInt32 TIASurface::enableScanlines(int change)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIASurface::enablePhosphor(bool enable, int blend)
 {
+  invalidateFrame();
+
   if(myPhosphorHandler.initialize(enable, blend))
   {
     myFilter = Filter(enable ? uInt8(myFilter) | 0x01 : uInt8(myFilter) & 0x10);
@@ -298,6 +343,8 @@ void TIASurface::enablePhosphor(bool enable, int blend)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIASurface::enableNTSC(bool enable)
 {
+  invalidateFrame();
+
   myFilter = Filter(enable ? uInt8(myFilter) | 0x10 : uInt8(myFilter) & 0x01);
 
   uInt32 surfaceWidth = enable ?
@@ -317,6 +364,9 @@ void TIASurface::enableNTSC(bool enable)
   sl_attr.blendalpha = myOSystem.settings().getInt("tv.scanlines");
   mySLineSurface->applyAttributes();
 
+  // Let the TIA surface darken the scanlines while scaling, if it can
+  myTiaSurface->setScanlines(myScanlinesEnabled ? sl_attr.blendalpha : 0);
+
   myRGBFramebuffer.fill(0);
 }
 
@@ -349,51 +399,42 @@ string TIASurface::effectsInfo() const
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-inline uInt32 TIASurface::averageBuffers(uInt32 bufOfs)
+void TIASurface::enableThreading(bool enable)
 {
-  const uInt32 c = myRGBFramebuffer[bufOfs];
-  const uInt32 p = myPrevRGBFramebuffer[bufOfs];
-
-  // Split into RGB values
-  const uInt8 rc = static_cast<uInt8>(c >> 16),
-              gc = static_cast<uInt8>(c >> 8),
-              bc = static_cast<uInt8>(c),
-              rp = static_cast<uInt8>(p >> 16),
-              gp = static_cast<uInt8>(p >> 8),
-              bp = static_cast<uInt8>(p);
-
-  // Mix current calculated buffer with previous calculated buffer (50:50)
-  const uInt8 rn = (rc + rp) / 2;
-  const uInt8 gn = (gc + gp) / 2;
-  const uInt8 bn = (bc + bp) / 2;
-
-  // return averaged value
-  return (rn << 16) | (gn << 8) | bn;
+  invalidateFrame();
+
+  myNTSCFilter.enableThreading(enable);
+
+  if(enable)
+    startPipeline();
+  else
+    stopPipeline();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void TIASurface::render(bool shade)
+void TIASurface::postProcess(const uInt8* tiaIn, uInt32 width, uInt32 height,
+                             uInt32* out, uInt32 outPitch, bool markDirty)
 {
-  uInt32 width = myTIA->width(), height = myTIA->height();
-
-  uInt32 *out, outPitch;
-  myTiaSurface->basePtr(out, outPitch);
-
   switch(myFilter)
   {
     case Filter::Normal:
     {
-      uInt8* tiaIn = myTIA->frameBuffer();
-
-      uInt32 bufofs = 0, screenofsY = 0, pos;
+      // Only rows which actually changed have to be uploaded again
+      uInt32 bufofs = 0, screenofsY = 0;
       for(uInt32 y = 0; y < height; ++y)
       {
-        pos = screenofsY;
-        for (uInt32 x = width / 2; x; --x)
+        uInt32* line = out + screenofsY;
+        uInt32 changed = 0;
+        for(uInt32 x = 0; x < width; ++x)
         {
-          out[pos++] = myPalette[tiaIn[bufofs++]];
-          out[pos++] = myPalette[tiaIn[bufofs++]];
+          const uInt32 pixel = myPalette[tiaIn[bufofs + x]];
+          changed |= line[x] ^ pixel;
+          line[x] = pixel;
         }
+        if(changed && markDirty)
+          myTiaSurface->setDirty(y, 1);
+
+        bufofs += width;
         screenofsY += outPitch;
       }
       break;
@@ -401,33 +442,35 @@ void TIASurface::render(bool shade)
 
     case Filter::Phosphor:
     {
-      uInt8*  tiaIn = myTIA->frameBuffer();
       uInt32* rgbIn = myRGBFramebuffer.data();
 
       if (mySaveSnapFlag)
         std::copy_n(myRGBFramebuffer.begin(), width * height,
                     myPrevRGBFramebuffer.begin());
 
-      uInt32 bufofs = 0, screenofsY = 0, pos;
+      uInt32 bufofs = 0, screenofsY = 0;
       for(uInt32 y = height; y ; --y)
       {
-        pos = screenofsY;
-        for(uInt32 x = width / 2; x ; --x)
-        {
-          // Store back into displayed frame buffer (for next frame)
-          rgbIn[bufofs] = out[pos++] = PhosphorHandler::getPixel(myPalette[tiaIn[bufofs]], rgbIn[bufofs]);
-          ++bufofs;
-          rgbIn[bufofs] = out[pos++] = PhosphorHandler::getPixel(myPalette[tiaIn[bufofs]], rgbIn[bufofs]);
-          ++bufofs;
-        }
+        uInt32* line = out + screenofsY;
+        for(uInt32 x = 0; x < width; ++x)
+          line[x] = myPalette[tiaIn[bufofs + x]];
+
+        // Store back into displayed frame buffer (for next frame)
+        PhosphorHandler::blend(line, rgbIn + bufofs, line, width);
+
+        bufofs += width;
         screenofsY += outPitch;
       }
+      if(markDirty)
+        myTiaSurface->setDirty();
       break;
     }
 
     case Filter::BlarggNormal:
     {
-      myNTSCFilter.render(myTIA->frameBuffer(), width, height, out, outPitch << 2);
+      myNTSCFilter.render(tiaIn, width, height, out, outPitch << 2);
+      if(markDirty)
+        myTiaSurface->setDirty();
       break;
     }
 
@@ -437,16 +480,33 @@ void TIASurface::render(bool shade)
         std::copy_n(myRGBFramebuffer.begin(), height * outPitch,
                     myPrevRGBFramebuffer.begin());
 
-      myNTSCFilter.render(myTIA->frameBuffer(), width, height, out, outPitch << 2, myRGBFramebuffer.data());
+      myNTSCFilter.render(tiaIn, width, height, out, outPitch << 2, myRGBFramebuffer.data());
+      if(markDirty)
+        myTiaSurface->setDirty();
       break;
     }
   }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASurface::render(bool shade)
+{
+  FrameProfiler::Scope profilerScope(FrameProfiler::Stage::tiaSurface);
+
+  uInt32 *out, outPitch;
+  myTiaSurface->basePtr(out, outPitch);
+
+  postProcess(myTIA->frameBuffer(), myTIA->width(), myTIA->height(),
+              out, outPitch, true);
+
+  // Blitting is profiled separately
+  profilerScope.stop();
 
   // Draw TIA image
   myTiaSurface->render();
 
-  // Draw overlaying scanlines
-  if(myScanlinesEnabled)
+  // Draw overlaying scanlines, unless already done by the TIA surface
+  if(myScanlinesEnabled && !myTiaSurface->drawsScanlines())
     mySLineSurface->render();
 
   if(shade)
@@ -464,6 +524,194 @@ void TIASurface::render(bool shade)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASurface::renderPipelined()
+{
+  if(!myPipelineThread.joinable())
+  {
+    render();
+    return;
+  }
+
+  FrameProfiler::Scope profilerScope(FrameProfiler::Stage::tiaSurface);
+
+  finishPostProcessing();
+  {
+    // The thread is idle now, so its last result becomes the front buffer
+    std::lock_guard<std::mutex> lock(myPipelineMutex);
+
+    myPipelineFrontValid = myPipelineBackValid;
+    myPipelineFrontWidth = myPipelineWidth;
+    myPipelineFrontHeight = myPipelineHeight;
+    myPipelineBack ^= 1;
+
+    // Hand over a copy of the new frame, since the TIA overwrites its
+    // frame buffer once the next frame is picked up
+    myPipelineTiaWidth = myTIA->width();
+    myPipelineWidth = myTiaSurface->srcRect().w();
+    myPipelineHeight = myTIA->height();
+    std::copy_n(myTIA->frameBuffer(), myPipelineTiaWidth * myPipelineHeight,
+                myPipelineInput.begin());
+    myPipelineBackValid = false;
+    myPipelineState = PipelineState::pending;
+  }
+  myPipelineCondition.notify_one();
+
+  // Upload the previous frame, unless the effects changed in between
+  if(myPipelineFrontValid &&
+     myPipelineFrontWidth == myTiaSurface->srcRect().w() &&
+     myPipelineFrontHeight == myTIA->height())
+  {
+    uInt32 *out, outPitch;
+    myTiaSurface->basePtr(out, outPitch);
+
+    const uInt32* in = myPipelineBuffers[myPipelineBack ^ 1].data();
+    const size_t rowBytes = myPipelineFrontWidth * sizeof(uInt32);
+
+    for(uInt32 y = 0; y < myPipelineFrontHeight; ++y)
+    {
+      uInt32* line = out + y * outPitch;
+      const uInt32* src = in + y * myPipelineFrontWidth;
+
+      // Only rows which actually changed have to be uploaded again
+      if(std::memcmp(line, src, rowBytes))
+      {
+        std::memcpy(line, src, rowBytes);
+        myTiaSurface->setDirty(y, 1);
+      }
+    }
+  }
+
+  // Blitting is profiled separately
+  profilerScope.stop();
+
+  // Draw TIA image
+  myTiaSurface->render();
+
+  // Draw overlaying scanlines, unless already done by the TIA surface
+  if(myScanlinesEnabled && !myTiaSurface->drawsScanlines())
+    mySLineSurface->render();
+
+  if(mySaveSnapFlag)
+  {
+    finishPostProcessing();
+
+    mySaveSnapFlag = false;
+  #ifdef PNG_SUPPORT
+    myOSystem.png().takeSnapshot();
+  #endif
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASurface::finishPostProcessing()
+{
+  std::unique_lock<std::mutex> lock(myPipelineMutex);
+
+  myPipelineCondition.wait(lock,
+    [this]{ return myPipelineState != PipelineState::pending; });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TIASurface::frameUnchanged()
+{
+  const uInt32 width = myTIA->width(), height = myTIA->height();
+  const uInt8* frame = myTIA->frameBuffer();
+  uInt64 hash = uInt64(width) << 32 | height;
+
+  for(uInt32 y = 0; y < height; ++y)
+    hash = hashScanline(hash, frame + size_t(y) * width, width);
+
+  if(myFrameValid && hash == myFrameHash)
+  {
+    if(myUnchangedFrames < 2)
+      ++myUnchangedFrames;
+  }
+  else
+  {
+    myFrameHash = hash;
+    myUnchangedFrames = 0;
+    myFrameValid = true;
+  }
+
+  // Phosphor blends in the previous frames, so the image keeps changing
+  if((uInt8(myFilter) & 0x01) || mySaveSnapFlag)
+    return false;
+
+  // With the post-processing thread, the frame presented lags one behind
+  return myUnchangedFrames >= (myPipelineThread.joinable() ? 2 : 1);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t TIASurface::memoryUsage() const
+{
+  size_t bytes = sizeof(myRGBFramebuffer) + sizeof(myPrevRGBFramebuffer) +
+                 sizeof(myPipelineInput);
+  for(const auto& buffer: myPipelineBuffers)
+    bytes += buffer.capacity() * sizeof(uInt32);
+
+  return bytes;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASurface::startPipeline()
+{
+  if(myPipelineThread.joinable())
+    return;
+
+  for(auto& buffer: myPipelineBuffers)
+    buffer.assign(AtariNTSC::outWidth(TIAConstants::frameBufferWidth) *
+                  TIAConstants::frameBufferHeight, 0);
+  myPipelineBackValid = myPipelineFrontValid = false;
+  myPipelineState = PipelineState::idle;
+
+  myPipelineThread = std::thread([this]{ pipelineLoop(); });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASurface::stopPipeline()
+{
+  if(!myPipelineThread.joinable())
+    return;
+
+  finishPostProcessing();
+  {
+    std::lock_guard<std::mutex> lock(myPipelineMutex);
+    myPipelineState = PipelineState::quit;
+  }
+  myPipelineCondition.notify_one();
+  myPipelineThread.join();
+
+  for(auto& buffer: myPipelineBuffers)
+    vector<uInt32>().swap(buffer);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASurface::pipelineLoop()
+{
+  std::unique_lock<std::mutex> lock(myPipelineMutex);
+
+  while(true)
+  {
+    myPipelineCondition.wait(lock,
+      [this]{ return myPipelineState != PipelineState::idle; });
+    if(myPipelineState == PipelineState::quit)
+      return;
+
+    // The main thread leaves the pipeline alone until the frame is done
+    lock.unlock();
+    postProcess(myPipelineInput.data(),
+                myPipelineTiaWidth, myPipelineHeight,
+                myPipelineBuffers[myPipelineBack].data(), myPipelineWidth,
+                false);
+    lock.lock();
+
+    myPipelineBackValid = true;
+    myPipelineState = PipelineState::idle;
+    myPipelineCondition.notify_all();
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIASurface::renderForSnapshot()
 {
@@ -475,7 +723,6 @@ void TIASurface::renderForSnapshot()
 
   uInt32 width = myTIA->width();
   uInt32 height = myTIA->height();
-  uInt32 pos = 0;
   uInt32 *outPtr, outPitch;
 
   myTiaSurface->basePtr(outPtr, outPitch);
@@ -495,22 +742,19 @@ void TIASurface::renderForSnapshot()
       uInt32 bufofs = 0, screenofsY = 0;
       for(uInt32 y = height; y; --y)
       {
-        pos = screenofsY;
-        for(uInt32 x = width / 2; x; --x)
-        {
-          outPtr[pos++] = averageBuffers(bufofs++);
-          outPtr[pos++] = averageBuffers(bufofs++);
-        }
+        PhosphorHandler::average(myRGBFramebuffer.data() + bufofs,
+          myPrevRGBFramebuffer.data() + bufofs, outPtr + screenofsY, width);
+        bufofs += width;
         screenofsY += outPitch;
       }
+      myTiaSurface->setDirty();
       break;
     }
 
     case Filter::BlarggPhosphor:
-      uInt32 bufofs = 0;
-      for(uInt32 y = height; y; --y)
-        for(uInt32 x = outPitch; x; --x)
-          outPtr[pos++] = averageBuffers(bufofs++);
+      PhosphorHandler::average(myRGBFramebuffer.data(), myPrevRGBFramebuffer.data(),
+        outPtr, height * outPitch);
+      myTiaSurface->setDirty();
       break;
   }
 
@@ -519,8 +763,8 @@ void TIASurface::renderForSnapshot()
     // Draw TIA image
     myTiaSurface->render();
 
-    // Draw overlaying scanlines
-    if(myScanlinesEnabled)
+    // Draw overlaying scanlines, unless already done by the TIA surface
+    if(myScanlinesEnabled && !myTiaSurface->drawsScanlines())
       mySLineSurface->render();
   }
 }
@@ -528,6 +772,8 @@ void TIASurface::renderForSnapshot()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIASurface::updateSurfaceSettings()
 {
+  invalidateFrame();
+
   myTiaSurface->setScalingInterpolation(
       interpolationModeFromSettings(myOSystem.settings())
   );
@@ -25,6 +25,8 @@ class FBSurface;
 class PaletteHandler;
 
 #include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include "Rect.hxx"
 #include "FrameBuffer.hxx"
@@ -78,10 +80,21 @@ class TIASurface
     */
     const FBSurface& baseSurface(Common::Rect& rect) const;
 
+    /**
+      Get the current TIA palette, as mapped for the framebuffer.
+    */
+    const PaletteArray& palette() const { return myPalette; }
+
+    /**
+      Get the RGB components of the current TIA palette (0x00RRGGBB).
+    */
+    const PaletteArray& rgbPalette() const { return myRGBPalette; }
+
     /**
       Get a underlying FBSurface that the TIA is being rendered into.
     */
     const FBSurface& tiaSurface() const { return *myTiaSurface; }
+    FBSurface& tiaSurface() { return *myTiaSurface; }
 
     /**
       Use the palette to map a single indexed pixel color. This is used by the
@@ -161,11 +174,48 @@ class TIASurface
     bool ntscEnabled() const { return uInt8(myFilter) & 0x10; }
     string effectsInfo() const;
 
+    /**
+      Enable/disable multi-threaded rendering; this covers both the NTSC
+      filter and the post-processing thread (see renderPipelined()).
+    */
+    void enableThreading(bool enable);
+
     /**
       This method should be called to draw the TIA image(s) to the screen.
     */
     void render(bool shade = false);
 
+    /**
+      Like render(), but used in emulation mode: with threading enabled, the
+      current TIA frame is handed to the post-processing thread, and the
+      previous frame, which that thread finished meanwhile, is drawn instead.
+      This way post-processing overlaps with presenting the previous frame
+      (and with the emulation of the next one), at the cost of one frame of
+      latency.  finishPostProcessing() must be called before any other
+      method of this class is used again.
+    */
+    void renderPipelined();
+
+    /**
+      Wait until the post-processing thread has finished the current frame.
+    */
+    void finishPostProcessing();
+
+    /**
+      Answer whether the current TIA frame would be displayed exactly like
+      the one presented last, so that rendering and presenting it can be
+      skipped.  The TIA frame is hashed scanline by scanline for this, so
+      this must be called once for every frame in emulation mode, before
+      renderPipelined().
+    */
+    bool frameUnchanged();
+
+    /**
+      Render the next frame in any case, since the image changed otherwise
+      (e.g. effects were changed, or something else was drawn).
+    */
+    void invalidateFrame() { myFrameValid = false; }
+
     /**
       This method prepares the current frame for taking a snapshot.
       In particular, in phosphor modes the blending is adjusted slightly to
@@ -183,15 +233,31 @@ class TIASurface
      */
     void updateSurfaceSettings();
 
-  private:
     /**
-      Average current calculated buffer's pixel with previous calculated buffer's pixel (50:50).
+      The memory (in bytes) held by the RGB frame buffers, including those
+      of the post-processing thread.  The surfaces are not included.
     */
-    uInt32 averageBuffers(uInt32 bufOfs);
+    size_t memoryUsage() const;
 
+  private:
     // Is plain video mode enabled?
     bool correctAspect() const;
 
+    /**
+      Apply the CPU effects (palette, phosphor, NTSC) to a TIA frame.
+
+      @param tiaIn      The TIA frame (palette indices)
+      @param out        The RGB output
+      @param outPitch   Pitch of the output, in pixels
+      @param markDirty  Whether to mark the changed rows of the TIA surface
+    */
+    void postProcess(const uInt8* tiaIn, uInt32 width, uInt32 height,
+                     uInt32* out, uInt32 outPitch, bool markDirty);
+
+    void startPipeline();
+    void stopPipeline();
+    void pipelineLoop();
+
   private:
     // Enumeration created such that phosphor off/on is in LSB,
     // and Blargg off/on is in MSB
@@ -231,12 +297,44 @@ class TIASurface
     // Palette for normal TIA rendering mode
     PaletteArray myPalette;
 
+    // RGB components of the palette above
+    PaletteArray myRGBPalette;
+
     // Flag for saving a snapshot
     bool mySaveSnapFlag{false};
 
     // The palette handler
     unique_ptr<PaletteHandler> myPaletteHandler;
 
+    /////////////////////////////////////////////////////////////
+    // Post-processing pipeline
+    enum class PipelineState { idle, pending, quit };
+
+    std::thread myPipelineThread;
+    std::mutex myPipelineMutex;
+    std::condition_variable myPipelineCondition;
+    PipelineState myPipelineState{PipelineState::idle};
+
+    // Copy of the TIA frame being post-processed
+    std::array<uInt8, TIAConstants::frameBufferWidth *
+        TIAConstants::frameBufferHeight> myPipelineInput;
+    uInt32 myPipelineTiaWidth{0};
+    // Width (= pitch) and height of the post-processed frame
+    uInt32 myPipelineWidth{0}, myPipelineHeight{0};
+
+    // The thread writes into the back buffer, the front buffer holds the
+    // previous frame (valid for the given surface width and height)
+    std::array<vector<uInt32>, 2> myPipelineBuffers;
+    uInt32 myPipelineBack{0};
+    bool myPipelineBackValid{false}, myPipelineFrontValid{false};
+    uInt32 myPipelineFrontWidth{0}, myPipelineFrontHeight{0};
+    /////////////////////////////////////////////////////////////
+
+    // Hash of the last TIA frame, and the number of frames which repeated it
+    uInt64 myFrameHash{0};
+    uInt32 myUnchangedFrames{0};
+    bool myFrameValid{false};
+
   private:
     // Following constructors and assignment operators not supported
     TIASurface() = delete;
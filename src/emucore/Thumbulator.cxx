@@ -26,8 +26,14 @@
 #include "Base.hxx"
 #include "Cart.hxx"
 #include "Thumbulator.hxx"
+#include "MD5.hxx"
+#include "FrameProfiler.hxx"
+#include "EventCounters.hxx"
 using Common::Base;
 
+std::mutex Thumbulator::ourDecodedRomsMutex;
+std::map<string, std::weak_ptr<const Thumbulator::Op[]>> Thumbulator::ourDecodedRoms;
+
 // Uncomment the following to enable specific functionality
 // WARNING!!! This slows the runtime to a crawl
 // #define THUMB_DISS
@@ -100,6 +106,11 @@ using Common::Base;
   // ARM cycles
   #define INC_ARM_CYCLES(m) \
     _totalCycles += m
+
+  // Mark the next instruction as the entry point of a function
+  #define PROFILE_CALL   \
+    if(_profiling)       \
+      _profiler->call()
 #else
   #define INC_S_CYCLES(addr, accessType)
   #define INC_N_CYCLES(addr, accessType)
@@ -119,6 +130,36 @@ using Common::Base;
 
   // ARM cycles
   #define INC_ARM_CYCLES(m)
+
+  #define PROFILE_CALL
+#endif
+
+#ifndef UNSAFE_OPTIMIZATIONS
+  // way more than would otherwise be possible
+  #define CHECK_INSTRUCTION_LIMIT                 \
+    if(_stats.instructions > 500000)              \
+      throw runtime_error("instructions > 500000")
+#else
+  #define CHECK_INSTRUCTION_LIMIT
+#endif
+
+#ifdef THUMB_THREADED_CODE
+  // Threaded code: each instruction directly jumps to the next one's
+  // handler instead of returning to the loop in 'doRun'
+  #define OP_LABEL(op) op_##op:
+  #define NEXT_INSTRUCTION                      \
+    do {                                        \
+      if(_threadedCode)                         \
+      {                                         \
+        CHECK_INSTRUCTION_LIMIT;                \
+        decodedOp = fetchAndDecode(pc, inst);   \
+        goto *opLabels[int(decodedOp)];         \
+      }                                         \
+      return 0;                                 \
+    } while(0)
+#else
+  #define OP_LABEL(op)
+  #define NEXT_INSTRUCTION return 0
 #endif
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -132,15 +173,20 @@ Thumbulator::Thumbulator(const uInt16* rom_ptr, uInt16* ram_ptr, uInt32 rom_size
     cBase{c_base},
     cStart{c_start},
     cStack{c_stack},
-    decodedRom{make_unique<Op[]>(romSize / 2)},  // NOLINT
+    decodedRom{decodeRom(rom_ptr, rom_size)},  // NOLINT
     ram{ram_ptr},
+    decodedRam{make_unique<DecodedRamOp[]>(RAMSIZE / 2)},  // NOLINT
     configuration{configurefor},
     myCartridge{cartridge}
 {
-  for(uInt32 i = 0; i < romSize / 2; ++i)
-    decodedRom[i] = decodeInstructionWord(CONV_RAMROM(rom[i]));
+  const Op decodedZero = decodeInstructionWord(0);
+  for(uInt32 i = 0; i < RAMSIZE / 2; ++i)
+    decodedRam[i].op = decodedZero;
+
+  setupPageTables();
 
   setConsoleTiming(ConsoleTiming::ntsc);
+  updateTiming();
 #ifndef UNSAFE_OPTIMIZATIONS
   trapFatalErrors(traponfatal);
 #endif
@@ -150,20 +196,50 @@ Thumbulator::Thumbulator(const uInt16* rom_ptr, uInt16* ram_ptr, uInt32 rom_size
   reset();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+shared_ptr<const Thumbulator::Op[]> Thumbulator::decodeRom(const uInt16* rom, uInt32 romSize)
+{
+  const string key = std::to_string(romSize) + ":" +
+    MD5::hash(reinterpret_cast<const uInt8*>(rom), romSize);
+  std::lock_guard<std::mutex> lock(ourDecodedRomsMutex);
+
+  // Drop the entries of ROMs which are no longer in use
+  for(auto it = ourDecodedRoms.begin(); it != ourDecodedRoms.end(); )
+    if(it->second.expired())
+      it = ourDecodedRoms.erase(it);
+    else
+      ++it;
+
+  const auto it = ourDecodedRoms.find(key);
+  if(it != ourDecodedRoms.end())
+    return it->second.lock();
+
+  shared_ptr<Op[]> decoded(new Op[romSize / 2]);  // NOLINT
+  for(uInt32 i = 0; i < romSize / 2; ++i)
+    decoded[i] = decodeInstructionWord(CONV_RAMROM(rom[i]));
+  ourDecodedRoms[key] = decoded;
+
+  return decoded;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string Thumbulator::doRun(uInt32& cycles, bool irqDrivenAudio)
 {
   _irqDrivenAudio = irqDrivenAudio;
   reset();
+#ifdef THUMB_CYCLE_COUNT
+  if(_profiling)
+    _profiler->beginRun(_profileFrame());
+#endif
   for(;;)
   {
     if(execute()) break;
-#ifndef UNSAFE_OPTIMIZATIONS
-    if(_stats.instructions > 500000) // way more than would otherwise be possible
-      throw runtime_error("instructions > 500000");
-#endif
+    CHECK_INSTRUCTION_LIMIT;
   }
 #ifdef THUMB_CYCLE_COUNT
+  if(_profiling)
+    _profiler->endRun(_totalCycles);
+
   _totalCycles *= _armCyclesFactor;
 
   // assuming 10% per scanline is spend for audio updates
@@ -224,8 +300,16 @@ void Thumbulator::updateTimer(uInt32 cycles)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string Thumbulator::run(uInt32& cycles, bool irqDrivenAudio)
 {
+  FrameProfiler::Scope profilerScope(FrameProfiler::Stage::thumb);
+
   updateTimer(cycles);
-  return doRun(cycles, irqDrivenAudio);
+  const string result = doRun(cycles, irqDrivenAudio);
+
+  EventCounters::count(EventCounters::Event::thumbCall);
+#ifdef THUMB_CYCLE_COUNT
+  EventCounters::count(EventCounters::Event::armCycles, uInt64(_totalCycles));
+#endif
+  return result;
 }
 
 #ifndef UNSAFE_OPTIMIZATIONS
@@ -281,6 +365,35 @@ void Thumbulator::dump_regs()
 }
 #endif
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::setupPageTables()
+{
+  readPages.fill(nullptr);
+  writePages.fill(nullptr);
+
+  // ROM is read-only; pages reaching beyond the image are not mapped
+  for(uInt32 page = 0; page < ROM_PAGES && ((page + 1) << PAGE_SHIFT) <= romSize; ++page)
+    readPages[page] = rom + (page << PAGE_SHIFT) / 2;
+
+  const uInt32 pageSize = 1 << PAGE_SHIFT;
+  for(uInt32 page = ROM_PAGES; page < NUM_PAGES; ++page)
+  {
+    const uInt32 offset = (page - ROM_PAGES) << PAGE_SHIFT;
+
+    readPages[page] = ram + offset / 2;
+    writePages[page] = ram + offset / 2;
+  #ifndef UNSAFE_OPTIMIZATIONS
+    // Writes to pages overlapping the driver area must be checked
+    for(uInt32 addr = 0x40000000 + offset; addr < 0x40000000 + offset + pageSize; addr += 2)
+      if(isProtected(addr))
+      {
+        writePages[page] = nullptr;
+        break;
+      }
+  #endif
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 Thumbulator::fetch16(uInt32 addr)
 {
@@ -348,6 +461,17 @@ uInt32 Thumbulator::fetch16(uInt32 addr)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Thumbulator::write16(uInt32 addr, uInt32 data)
 {
+  const uInt32 page = pageIndex(addr);
+  if(page < NUM_PAGES && writePages[page] && !(addr & 1))
+  {
+  #ifdef THUMB_STATS
+    ++_stats.writes;
+  #endif
+    DO_DBUG(statusMsg << "write16(" << Base::HEX8 << addr << "," << Base::HEX8 << data << ")" << endl);
+    writePages[page][(addr & PAGE_MASK) >> 1] = CONV_DATA(data);
+    return;
+  }
+
 #ifndef UNSAFE_OPTIMIZATIONS
   if((addr > 0x40007fff) && (addr < 0x50000000))
     fatalError("write16", addr, "abort - out of range");
@@ -380,7 +504,7 @@ void Thumbulator::write16(uInt32 addr, uInt32 data)
       {
         DO_DBUG(statusMsg << "write16(" << Base::HEX8 << "MAMCR" << "," << Base::HEX8 << data << ") *" << endl);
         if(!_lockMamcr)
-          mamcr = static_cast<MamModeType>(data);
+          setMamMode(static_cast<MamModeType>(data));
         return;
       }
   }
@@ -392,6 +516,19 @@ void Thumbulator::write16(uInt32 addr, uInt32 data)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Thumbulator::write32(uInt32 addr, uInt32 data)
 {
+  const uInt32 page = pageIndex(addr);
+  if(page < NUM_PAGES && writePages[page] && !(addr & 3))
+  {
+  #ifdef THUMB_STATS
+    _stats.writes += 2;
+  #endif
+    DO_DBUG(statusMsg << "write32(" << Base::HEX8 << addr << "," << Base::HEX8 << data << ")" << endl);
+    uInt16* const ptr = writePages[page] + ((addr & PAGE_MASK) >> 1);
+    ptr[0] = CONV_DATA(data);
+    ptr[1] = CONV_DATA(data >> 16);
+    return;
+  }
+
 #ifndef UNSAFE_OPTIMIZATIONS
   if(addr & 3)
     fatalError("write32", addr, "abort - misaligned");
@@ -494,7 +631,7 @@ void Thumbulator::write32(uInt32 addr, uInt32 data)
           DO_DBUG(statusMsg << "write32(" << Base::HEX8 << "MAMCR" << ","
                   << Base::HEX8 << data << ") *" << endl);
           if(!_lockMamcr)
-            mamcr = static_cast<MamModeType>(data);
+            setMamMode(static_cast<MamModeType>(data));
           break;
       #endif
 
@@ -573,6 +710,18 @@ bool Thumbulator::isProtected(uInt32 addr)
 uInt32 Thumbulator::read16(uInt32 addr)
 {
   uInt32 data;
+
+  const uInt32 page = pageIndex(addr);
+  if(page < NUM_PAGES && readPages[page] && !(addr & 1))
+  {
+  #ifdef THUMB_STATS
+    ++_stats.reads;
+  #endif
+    data = CONV_RAMROM(readPages[page][(addr & PAGE_MASK) >> 1]);
+    DO_DBUG(statusMsg << "read16(" << Base::HEX8 << addr << ")=" << Base::HEX4 << data << endl);
+    return data;
+  }
+
 #ifndef UNSAFE_OPTIMIZATIONS
   if((addr > 0x40007fff) && (addr < 0x50000000))
     fatalError("read16", addr, "abort - out of range");
@@ -621,12 +770,25 @@ uInt32 Thumbulator::read16(uInt32 addr)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 Thumbulator::read32(uInt32 addr)
 {
+  uInt32 data;
+
+  const uInt32 page = pageIndex(addr);
+  if(page < NUM_PAGES && readPages[page] && !(addr & 3))
+  {
+  #ifdef THUMB_STATS
+    _stats.reads += 2;
+  #endif
+    const uInt16* const ptr = readPages[page] + ((addr & PAGE_MASK) >> 1);
+    data = CONV_RAMROM(ptr[0]) | (uInt32(CONV_RAMROM(ptr[1])) << 16);
+    DO_DBUG(statusMsg << "read32(" << Base::HEX8 << addr << ")=" << Base::HEX8 << data << endl);
+    return data;
+  }
+
 #ifndef UNSAFE_OPTIMIZATIONS
   if(addr & 3)
     fatalError("read32", addr, "abort - misaligned");
 #endif
 
-  uInt32 data;
   switch(addr & 0xF0000000)
   {
     case 0x00000000: //ROM
@@ -1038,13 +1200,16 @@ Thumbulator::Op Thumbulator::decodeInstructionWord(uint16_t inst) {
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-int Thumbulator::execute()
+inline Thumbulator::Op Thumbulator::fetchAndDecode(uInt32& pc, uInt32& inst)
 {
-  uInt32 pc, sp, inst, ra, rb, rc, rm, rd, rn, rs, op;
-
   pc = read_register(15);
 
   uInt32 instructionPtr = pc - 2;
+#ifdef THUMB_CYCLE_COUNT
+  // Before fetching, so that the fetch is charged to this instruction
+  if(_profiling)
+    _profiler->fetch(instructionPtr, _totalCycles);
+#endif
   inst = fetch16(instructionPtr);
 
   pc += 2;
@@ -1059,6 +1224,17 @@ int Thumbulator::execute()
 #ifndef UNSAFE_OPTIMIZATIONS
   if ((instructionPtr & 0xF0000000) == 0 && instructionPtr < romSize)
     decodedOp = decodedRom[instructionPtr >> 1];
+  else if ((instructionPtr & 0xF0000000) == 0x40000000)
+  {
+    // The cached entry is only valid while the code in RAM is unchanged
+    DecodedRamOp& entry = decodedRam[(instructionPtr & RAMADDMASK) >> 1];
+    if(entry.inst != inst)
+    {
+      entry.inst = inst;
+      entry.op = decodeInstructionWord(inst);
+    }
+    decodedOp = entry.op;
+  }
   else
     decodedOp = decodeInstructionWord(inst);
 #else
@@ -1068,9 +1244,59 @@ int Thumbulator::execute()
 #ifdef COUNT_OPS
   ++opCount[int(decodedOp)];
 #endif
+  return decodedOp;
+}
+
+#ifdef THUMB_THREADED_CODE
+  // Labels as values are non-standard
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wpedantic"
+  #ifdef __clang__
+    #pragma clang diagnostic ignored "-Wgnu-label-as-value"
+  #endif
+#endif
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int Thumbulator::execute()
+{
+  uInt32 pc, sp, inst, ra, rb, rc, rm, rd, rn, rs, op;
+
+  Op decodedOp = fetchAndDecode(pc, inst);
+#ifdef THUMB_THREADED_CODE
+ #ifdef UNSAFE_OPTIMIZATIONS
+  // Not emulated, these are handled like invalid instructions
+  #define op_bkpt op_invalid
+  #define op_cps op_invalid
+  #define op_setend op_invalid
+ #endif
+  static const void* const opLabels[] = {
+    &&op_invalid, &&op_adc, &&op_add1, &&op_add2, &&op_add3, &&op_add4,
+    &&op_add5, &&op_add6, &&op_add7, &&op_and_, &&op_asr1, &&op_asr2, &&op_b1,
+    &&op_b2, &&op_bic, &&op_bkpt, &&op_blx1, &&op_blx2, &&op_bx, &&op_cmn,
+    &&op_cmp1, &&op_cmp2, &&op_cmp3, &&op_cps, &&op_cpy, &&op_eor, &&op_ldmia,
+    &&op_ldr1, &&op_ldr2, &&op_ldr3, &&op_ldr4, &&op_ldrb1, &&op_ldrb2,
+    &&op_ldrh1, &&op_ldrh2, &&op_ldrsb, &&op_ldrsh, &&op_lsl1, &&op_lsl2,
+    &&op_lsr1, &&op_lsr2, &&op_mov1, &&op_mov2, &&op_mov3, &&op_mul, &&op_mvn,
+    &&op_neg, &&op_orr, &&op_pop, &&op_push, &&op_rev, &&op_rev16, &&op_revsh,
+    &&op_ror, &&op_sbc, &&op_setend, &&op_stmia, &&op_str1, &&op_str2,
+    &&op_str3, &&op_strb1, &&op_strb2, &&op_strh1, &&op_strh2, &&op_sub1,
+    &&op_sub2, &&op_sub3, &&op_sub4, &&op_swi, &&op_sxtb, &&op_sxth, &&op_tst,
+    &&op_uxtb, &&op_uxth, &&op_numOps
+  };
+ #ifdef UNSAFE_OPTIMIZATIONS
+  #undef op_bkpt
+  #undef op_cps
+  #undef op_setend
+ #endif
+  static_assert(sizeof(opLabels) / sizeof(opLabels[0]) == size_t(Op::numOps) + 1,
+                "opLabels must match Op");
+  if(_threadedCode)
+    goto *opLabels[int(decodedOp)];
+#endif
+
   switch (decodedOp) {
     //ADC
-    case Op::adc: {
+    case Op::adc: OP_LABEL(adc) {
       rd = (inst >> 0) & 0x07;
       rm = (inst >> 3) & 0x07;
       DO_DISS(statusMsg << "adc r" << dec << rd << ",r" << dec << rm << endl);
@@ -1084,11 +1310,11 @@ int Thumbulator::execute()
       do_zflag(rc);
       if(cpsr & CPSR_C) { do_cflag(ra, rb, 1); do_vflag(ra, rb, 1); }
       else              { do_cflag(ra, rb, 0); do_vflag(ra, rb, 0); }
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //ADD(1) small immediate two registers
-    case Op::add1: {
+    case Op::add1: OP_LABEL(add1) {
       rd = (inst >> 0) & 0x7;
       rn = (inst >> 3) & 0x7;
       rb = (inst >> 6) & 0x7;
@@ -1104,7 +1330,7 @@ int Thumbulator::execute()
         do_zflag(rc);
         do_cflag(ra, rb, 0);
         do_vflag(ra, rb, 0);
-        return 0;
+        NEXT_INSTRUCTION;
       }
       else
       {
@@ -1114,7 +1340,7 @@ int Thumbulator::execute()
     }
 
     //ADD(2) big immediate one register
-    case Op::add2: {
+    case Op::add2: OP_LABEL(add2) {
       rb = (inst >> 0) & 0xFF;
       rd = (inst >> 8) & 0x7;
       DO_DISS(statusMsg << "adds r" << dec << rd << ",#0x" << Base::HEX2 << rb << endl);
@@ -1125,11 +1351,11 @@ int Thumbulator::execute()
       do_zflag(rc);
       do_cflag(ra, rb, 0);
       do_vflag(ra, rb, 0);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //ADD(3) three registers
-    case Op::add3: {
+    case Op::add3: OP_LABEL(add3) {
       rd = (inst >> 0) & 0x7;
       rn = (inst >> 3) & 0x7;
       rm = (inst >> 6) & 0x7;
@@ -1142,11 +1368,11 @@ int Thumbulator::execute()
       do_zflag(rc);
       do_cflag(ra, rb, 0);
       do_vflag(ra, rb, 0);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //ADD(4) two registers one or both high no flags
-    case Op::add4: {
+    case Op::add4: OP_LABEL(add4) {
       if((inst >> 6) & 3)
       {
         //UNPREDICTABLE
@@ -1169,11 +1395,11 @@ int Thumbulator::execute()
       }
       //fprintf(stderr,"0x%08X = 0x%08X + 0x%08X\n",rc,ra,rb);
       write_register(rd, rc);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //ADD(5) rd = pc plus immediate
-    case Op::add5: {
+    case Op::add5: OP_LABEL(add5) {
       rb = (inst >> 0) & 0xFF;
       rd = (inst >> 8) & 0x7;
       rb <<= 2;
@@ -1181,11 +1407,11 @@ int Thumbulator::execute()
       ra = read_register(15);
       rc = (ra & (~3U)) + rb;
       write_register(rd, rc);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //ADD(6) rd = sp plus immediate
-    case Op::add6: {
+    case Op::add6: OP_LABEL(add6) {
       rb = (inst >> 0) & 0xFF;
       rd = (inst >> 8) & 0x7;
       rb <<= 2;
@@ -1193,22 +1419,22 @@ int Thumbulator::execute()
       ra = read_register(13);
       rc = ra + rb;
       write_register(rd, rc);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //ADD(7) sp plus immediate
-    case Op::add7: {
+    case Op::add7: OP_LABEL(add7) {
       rb = (inst >> 0) & 0x7F;
       rb <<= 2;
       DO_DISS(statusMsg << "add SP,#0x" << Base::HEX2 << rb << endl);
       ra = read_register(13);
       rc = ra + rb;
       write_register(13, rc);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //AND
-    case Op::and_: {
+    case Op::and_: OP_LABEL(and_) {
       rd = (inst >> 0) & 0x7;
       rm = (inst >> 3) & 0x7;
       DO_DISS(statusMsg << "ands r" << dec << rd << ",r" << dec << rm << endl);
@@ -1218,11 +1444,11 @@ int Thumbulator::execute()
       write_register(rd, rc);
       do_nflag(rc);
       do_zflag(rc);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //ASR(1) two register immediate
-    case Op::asr1: {
+    case Op::asr1: OP_LABEL(asr1) {
       rd = (inst >> 0) & 0x07;
       rm = (inst >> 3) & 0x07;
       rb = (inst >> 6) & 0x1F;
@@ -1253,11 +1479,11 @@ int Thumbulator::execute()
       do_nflag(rc);
       do_zflag(rc);
       INC_SHIFT_CYCLES;
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //ASR(2) two register
-    case Op::asr2: {
+    case Op::asr2: OP_LABEL(asr2) {
       rd = (inst >> 0) & 0x07;
       rs = (inst >> 3) & 0x07;
       DO_DISS(statusMsg << "asrs r" << dec << rd << ",r" << dec << rs << endl);
@@ -1294,11 +1520,11 @@ int Thumbulator::execute()
       do_nflag(rc);
       do_zflag(rc);
       INC_SHIFT_CYCLES;
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //B(1) conditional branch
-    case Op::b1: {
+    case Op::b1: OP_LABEL(b1) {
     #ifdef THUMB_STATS
       ++_stats.branches;
     #endif
@@ -1316,75 +1542,75 @@ int Thumbulator::execute()
           DO_DISS(statusMsg << "beq 0x" << Base::HEX8 << (rb-3) << endl);
           if(cpsr & CPSR_Z)
             write_register(15, rb);
-          return 0;
+          NEXT_INSTRUCTION;
 
         case 0x1: //b ne  z clear
           DO_DISS(statusMsg << "bne 0x" << Base::HEX8 << (rb-3) << endl);
           if(!(cpsr & CPSR_Z))
             write_register(15, rb);
-          return 0;
+          NEXT_INSTRUCTION;
 
         case 0x2: //b cs c set
           DO_DISS(statusMsg << "bcs 0x" << Base::HEX8 << (rb-3) << endl);
           if(cpsr & CPSR_C)
             write_register(15, rb);
-          return 0;
+          NEXT_INSTRUCTION;
 
         case 0x3: //b cc c clear
           DO_DISS(statusMsg << "bcc 0x" << Base::HEX8 << (rb-3) << endl);
           if(!(cpsr & CPSR_C))
             write_register(15, rb);
-          return 0;
+          NEXT_INSTRUCTION;
 
         case 0x4: //b mi n set
           DO_DISS(statusMsg << "bmi 0x" << Base::HEX8 << (rb-3) << endl);
           if(cpsr & CPSR_N)
             write_register(15, rb);
-          return 0;
+          NEXT_INSTRUCTION;
 
         case 0x5: //b pl n clear
           DO_DISS(statusMsg << "bpl 0x" << Base::HEX8 << (rb-3) << endl);
           if(!(cpsr & CPSR_N))
             write_register(15, rb);
-          return 0;
+          NEXT_INSTRUCTION;
 
         case 0x6: //b vs v set
           DO_DISS(statusMsg << "bvs 0x" << Base::HEX8 << (rb-3) << endl);
           if(cpsr & CPSR_V)
             write_register(15, rb);
-          return 0;
+          NEXT_INSTRUCTION;
 
         case 0x7: //b vc v clear
           DO_DISS(statusMsg << "bvc 0x" << Base::HEX8 << (rb-3) << endl);
           if(!(cpsr & CPSR_V))
             write_register(15, rb);
-          return 0;
+          NEXT_INSTRUCTION;
 
         case 0x8: //b hi c set z clear
           DO_DISS(statusMsg << "bhi 0x" << Base::HEX8 << (rb-3) << endl);
           if((cpsr & CPSR_C) && (!(cpsr & CPSR_Z)))
             write_register(15, rb);
-          return 0;
+          NEXT_INSTRUCTION;
 
         case 0x9: //b ls c clear or z set
           DO_DISS(statusMsg << "bls 0x" << Base::HEX8 << (rb-3) << endl);
           if((cpsr & CPSR_Z) || (!(cpsr & CPSR_C)))
             write_register(15, rb);
-          return 0;
+          NEXT_INSTRUCTION;
 
         case 0xA: //b ge N == V
           DO_DISS(statusMsg << "bge 0x" << Base::HEX8 << (rb-3) << endl);
           if(((cpsr & CPSR_N) && (cpsr & CPSR_V)) ||
              ((!(cpsr & CPSR_N)) && (!(cpsr & CPSR_V))))
             write_register(15, rb);
-          return 0;
+          NEXT_INSTRUCTION;
 
         case 0xB: //b lt N != V
           DO_DISS(statusMsg << "blt 0x" << Base::HEX8 << (rb-3) << endl);
           if((!(cpsr & CPSR_N) && (cpsr & CPSR_V)) ||
             (((cpsr & CPSR_N)) && !(cpsr & CPSR_V)))
             write_register(15, rb);
-          return 0;
+          NEXT_INSTRUCTION;
 
         case 0xC: //b gt Z==0 and N == V
           DO_DISS(statusMsg << "bgt 0x" << Base::HEX8 << (rb-3) << endl);
@@ -1394,7 +1620,7 @@ int Thumbulator::execute()
                ((!(cpsr & CPSR_N)) && (!(cpsr & CPSR_V))))
               write_register(15, rb);
           }
-          return 0;
+          NEXT_INSTRUCTION;
 
         case 0xD: //b le Z==1 or N != V
           DO_DISS(statusMsg << "ble 0x" << Base::HEX8 << (rb-3) << endl);
@@ -1402,7 +1628,7 @@ int Thumbulator::execute()
             (!(cpsr & CPSR_N) && (cpsr & CPSR_V)) ||
             (((cpsr & CPSR_N)) && !(cpsr & CPSR_V)))
             write_register(15, rb);
-          return 0;
+          NEXT_INSTRUCTION;
 
         case 0xE:
           //undefined instruction
@@ -1419,7 +1645,7 @@ int Thumbulator::execute()
     }
 
     //B(2) unconditional branch
-    case Op::b2: {
+    case Op::b2: OP_LABEL(b2) {
     #ifdef THUMB_STATS
       ++_stats.branches;
     #endif
@@ -1431,11 +1657,11 @@ int Thumbulator::execute()
       rb += 2;
       DO_DISS(statusMsg << "B 0x" << Base::HEX8 << (rb-3) << endl);
       write_register(15, rb);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //BIC
-    case Op::bic: {
+    case Op::bic: OP_LABEL(bic) {
       rd = (inst >> 0) & 0x7;
       rm = (inst >> 3) & 0x7;
       DO_DISS(statusMsg << "bics r" << dec << rd << ",r" << dec << rm << endl);
@@ -1445,12 +1671,12 @@ int Thumbulator::execute()
       write_register(rd, rc);
       do_nflag(rc);
       do_zflag(rc);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
 #ifndef UNSAFE_OPTIMIZATIONS
     //BKPT
-    case Op::bkpt: {
+    case Op::bkpt: OP_LABEL(bkpt) {
       rb = (inst >> 0) & 0xFF;
       statusMsg << "bkpt 0x" << Base::HEX2 << rb << endl;
       return 1;
@@ -1458,7 +1684,7 @@ int Thumbulator::execute()
 #endif
 
     //BL/BLX(1)
-    case Op::blx1: {
+    case Op::blx1: OP_LABEL(blx1) {
       if((inst & 0x1800) == 0x1000) //H=b10
       {
         DO_DISS(statusMsg << endl);
@@ -1467,7 +1693,7 @@ int Thumbulator::execute()
         rb <<= 12;
         rb += pc;
         write_register(14, rb);
-        return 0;
+        NEXT_INSTRUCTION;
       }
       else if((inst & 0x1800) == 0x1800) //H=b11
       {
@@ -1478,7 +1704,8 @@ int Thumbulator::execute()
         DO_DISS(statusMsg << "bl 0x" << Base::HEX8 << (rb-3) << endl);
         write_register(14, (pc-2) | 1);
         write_register(15, rb);
-        return 0;
+        PROFILE_CALL;
+        NEXT_INSTRUCTION;
       }
       else if((inst & 0x1800) == 0x0800) //H=b01
       {
@@ -1492,13 +1719,14 @@ int Thumbulator::execute()
         DO_DISS(statusMsg << "bl 0x" << Base::HEX8 << (rb-3) << endl);
         write_register(14, (pc-2) | 1);
         write_register(15, rb);
-        return 0;
+        PROFILE_CALL;
+        NEXT_INSTRUCTION;
       }
       break;
     }
 
     //BLX(2)
-    case Op::blx2: {
+    case Op::blx2: OP_LABEL(blx2) {
       rm = (inst >> 3) & 0xF;
       DO_DISS(statusMsg << "blx r" << dec << rm << endl);
       rc = read_register(rm);
@@ -1509,7 +1737,8 @@ int Thumbulator::execute()
         write_register(14, (pc-2) | 1);
         //rc &= ~1;
         write_register(15, rc);
-        return 0;
+        PROFILE_CALL;
+        NEXT_INSTRUCTION;
       }
       else
       {
@@ -1520,7 +1749,7 @@ int Thumbulator::execute()
     }
 
     //BX
-    case Op::bx: {
+    case Op::bx: OP_LABEL(bx) {
       rm = (inst >> 3) & 0xF;
       DO_DISS(statusMsg << "bx r" << dec << rm << endl);
       rc = read_register(rm);
@@ -1531,7 +1760,7 @@ int Thumbulator::execute()
         // branch to odd address denotes 16 bit ARM code
         //rc &= ~1;
         write_register(15, rc);
-        return 0;
+        NEXT_INSTRUCTION;
       }
       else
       {
@@ -1756,14 +1985,14 @@ int Thumbulator::execute()
           //rc &= ~1;
           write_register(15, rc);
           //_totalCycles += 100; // just a wild guess
-          return 0;
+          NEXT_INSTRUCTION;
         }
         return 1;
       }
     }
 
     //CMN
-    case Op::cmn: {
+    case Op::cmn: OP_LABEL(cmn) {
       rn = (inst >> 0) & 0x7;
       rm = (inst >> 3) & 0x7;
       DO_DISS(statusMsg << "cmns r" << dec << rn << ",r" << dec << rm << endl);
@@ -1774,11 +2003,11 @@ int Thumbulator::execute()
       do_zflag(rc);
       do_cflag(ra, rb, 0);
       do_vflag(ra, rb, 0);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //CMP(1) compare immediate
-    case Op::cmp1: {
+    case Op::cmp1: OP_LABEL(cmp1) {
       rb = (inst >> 0) & 0xFF;
       rn = (inst >> 8) & 0x07;
       DO_DISS(statusMsg << "cmp r" << dec << rn << ",#0x" << Base::HEX2 << rb << endl);
@@ -1789,11 +2018,11 @@ int Thumbulator::execute()
       do_zflag(rc);
       do_cflag(ra, ~rb, 1);
       do_vflag(ra, ~rb, 1);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //CMP(2) compare register
-    case Op::cmp2: {
+    case Op::cmp2: OP_LABEL(cmp2) {
       rn = (inst >> 0) & 0x7;
       rm = (inst >> 3) & 0x7;
       DO_DISS(statusMsg << "cmps r" << dec << rn << ",r" << dec << rm << endl);
@@ -1805,11 +2034,11 @@ int Thumbulator::execute()
       do_zflag(rc);
       do_cflag(ra, ~rb, 1);
       do_vflag(ra, ~rb, 1);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //CMP(3) compare high register
-    case Op::cmp3: {
+    case Op::cmp3: OP_LABEL(cmp3) {
       if(((inst >> 6) & 3) == 0x0)
       {
         //UNPREDICTABLE
@@ -1829,19 +2058,19 @@ int Thumbulator::execute()
       do_zflag(rc);
       do_cflag(ra, ~rb, 1);
       do_vflag(ra, ~rb, 1);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
 #ifndef UNSAFE_OPTIMIZATIONS
     //CPS
-    case Op::cps: {
+    case Op::cps: OP_LABEL(cps) {
       DO_DISS(statusMsg << "cps TODO" << endl);
       return 1;
     }
 #endif
 
     //CPY copy high register
-    case Op::cpy: {
+    case Op::cpy: OP_LABEL(cpy) {
       //same as mov except you can use both low registers
       //going to let mov handle high registers
       rd = (inst >> 0) & 0x7;
@@ -1849,11 +2078,11 @@ int Thumbulator::execute()
       DO_DISS(statusMsg << "cpy r" << dec << rd << ",r" << dec << rm << endl);
       rc = read_register(rm);
       write_register(rd, rc);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //EOR
-    case Op::eor: {
+    case Op::eor: OP_LABEL(eor) {
       rd = (inst >> 0) & 0x7;
       rm = (inst >> 3) & 0x7;
       DO_DISS(statusMsg << "eors r" << dec << rd << ",r" << dec << rm << endl);
@@ -1863,11 +2092,11 @@ int Thumbulator::execute()
       write_register(rd, rc);
       do_nflag(rc);
       do_zflag(rc);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //LDMIA
-    case Op::ldmia: {
+    case Op::ldmia: OP_LABEL(ldmia) {
       rn = (inst >> 8) & 0x7;
     #if defined(THUMB_DISS)
       statusMsg << "ldmia r" << dec << rn << "!,{";
@@ -1904,11 +2133,11 @@ int Thumbulator::execute()
       //there is a write back exception.
       if((inst & (1 << rn)) == 0)
         write_register(rn, sp);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //LDR(1) two register immediate
-    case Op::ldr1: {
+    case Op::ldr1: OP_LABEL(ldr1) {
       rd = (inst >> 0) & 0x07;
       rn = (inst >> 3) & 0x07;
       rb = (inst >> 6) & 0x1F;
@@ -1918,11 +2147,11 @@ int Thumbulator::execute()
       rc = read32(rb);
       write_register(rd, rc);
       INC_LDR_CYCLES;
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //LDR(2) three register
-    case Op::ldr2: {
+    case Op::ldr2: OP_LABEL(ldr2) {
       rd = (inst >> 0) & 0x7;
       rn = (inst >> 3) & 0x7;
       rm = (inst >> 6) & 0x7;
@@ -1931,11 +2160,11 @@ int Thumbulator::execute()
       rc = read32(rb);
       write_register(rd, rc);
       INC_LDR_CYCLES;
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //LDR(3)
-    case Op::ldr3: {
+    case Op::ldr3: OP_LABEL(ldr3) {
       rb = (inst >> 0) & 0xFF;
       rd = (inst >> 8) & 0x07;
       rb <<= 2;
@@ -1947,11 +2176,11 @@ int Thumbulator::execute()
       rc = read32(rb);
       write_register(rd, rc);
       INC_LDR_CYCLES;
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //LDR(4)
-    case Op::ldr4: {
+    case Op::ldr4: OP_LABEL(ldr4) {
       rb = (inst >> 0) & 0xFF;
       rd = (inst >> 8) & 0x07;
       rb <<= 2;
@@ -1962,11 +2191,11 @@ int Thumbulator::execute()
       rc = read32(rb);
       write_register(rd, rc);
       INC_LDR_CYCLES;
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //LDRB(1)
-    case Op::ldrb1: {
+    case Op::ldrb1: OP_LABEL(ldrb1) {
       rd = (inst >> 0) & 0x07;
       rn = (inst >> 3) & 0x07;
       rb = (inst >> 6) & 0x1F;
@@ -1986,11 +2215,11 @@ int Thumbulator::execute()
       }
       write_register(rd, rc & 0xFF);
       INC_LDRB_CYCLES;
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //LDRB(2)
-    case Op::ldrb2: {
+    case Op::ldrb2: OP_LABEL(ldrb2) {
       rd = (inst >> 0) & 0x7;
       rn = (inst >> 3) & 0x7;
       rm = (inst >> 6) & 0x7;
@@ -2007,11 +2236,11 @@ int Thumbulator::execute()
       }
       write_register(rd, rc & 0xFF);
       INC_LDRB_CYCLES;
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //LDRH(1)
-    case Op::ldrh1: {
+    case Op::ldrh1: OP_LABEL(ldrh1) {
       rd = (inst >> 0) & 0x07;
       rn = (inst >> 3) & 0x07;
       rb = (inst >> 6) & 0x1F;
@@ -2021,11 +2250,11 @@ int Thumbulator::execute()
       rc = read16(rb);
       write_register(rd, rc & 0xFFFF);
       INC_LDR_CYCLES;
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //LDRH(2)
-    case Op::ldrh2: {
+    case Op::ldrh2: OP_LABEL(ldrh2) {
       rd = (inst >> 0) & 0x7;
       rn = (inst >> 3) & 0x7;
       rm = (inst >> 6) & 0x7;
@@ -2034,11 +2263,11 @@ int Thumbulator::execute()
       rc = read16(rb);
       write_register(rd, rc & 0xFFFF);
       INC_LDR_CYCLES;
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //LDRSB
-    case Op::ldrsb: {
+    case Op::ldrsb: OP_LABEL(ldrsb) {
       rd = (inst >> 0) & 0x7;
       rn = (inst >> 3) & 0x7;
       rm = (inst >> 6) & 0x7;
@@ -2058,11 +2287,11 @@ int Thumbulator::execute()
         rc |= ((~0U) << 8);
       write_register(rd, rc);
       INC_LDRB_CYCLES;
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //LDRSH
-    case Op::ldrsh: {
+    case Op::ldrsh: OP_LABEL(ldrsh) {
       rd = (inst >> 0) & 0x7;
       rn = (inst >> 3) & 0x7;
       rm = (inst >> 6) & 0x7;
@@ -2074,11 +2303,11 @@ int Thumbulator::execute()
         rc |= ((~0U) << 16);
       write_register(rd, rc);
       INC_LDR_CYCLES;
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //LSL(1)
-    case Op::lsl1: {
+    case Op::lsl1: OP_LABEL(lsl1) {
       rd = (inst >> 0) & 0x07;
       rm = (inst >> 3) & 0x07;
       rb = (inst >> 6) & 0x1F;
@@ -2100,11 +2329,11 @@ int Thumbulator::execute()
       do_nflag(rc);
       do_zflag(rc);
       INC_SHIFT_CYCLES;
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //LSL(2) two register
-    case Op::lsl2: {
+    case Op::lsl2: OP_LABEL(lsl2) {
       rd = (inst >> 0) & 0x07;
       rs = (inst >> 3) & 0x07;
       DO_DISS(statusMsg << "lsls r" << dec << rd << ",r" << dec << rs << endl);
@@ -2133,11 +2362,11 @@ int Thumbulator::execute()
       do_nflag(rc);
       do_zflag(rc);
       INC_SHIFT_CYCLES;
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //LSR(1) two register immediate
-    case Op::lsr1: {
+    case Op::lsr1: OP_LABEL(lsr1) {
       rd = (inst >> 0) & 0x07;
       rm = (inst >> 3) & 0x07;
       rb = (inst >> 6) & 0x1F;
@@ -2157,11 +2386,11 @@ int Thumbulator::execute()
       do_nflag(rc);
       do_zflag(rc);
       INC_SHIFT_CYCLES;
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //LSR(2) two register
-    case Op::lsr2: {
+    case Op::lsr2: OP_LABEL(lsr2) {
       rd = (inst >> 0) & 0x07;
       rs = (inst >> 3) & 0x07;
       DO_DISS(statusMsg << "lsrs r" << dec << rd << ",r" << dec << rs << endl);
@@ -2190,22 +2419,22 @@ int Thumbulator::execute()
       do_nflag(rc);
       do_zflag(rc);
       INC_SHIFT_CYCLES;
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //MOV(1) immediate
-    case Op::mov1: {
+    case Op::mov1: OP_LABEL(mov1) {
       rb = (inst >> 0) & 0xFF;
       rd = (inst >> 8) & 0x07;
       DO_DISS(statusMsg << "movs r" << dec << rd << ",#0x" << Base::HEX2 << rb << endl);
       write_register(rd, rb);
       do_nflag(rb);
       do_zflag(rb);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //MOV(2) two low registers
-    case Op::mov2: {
+    case Op::mov2: OP_LABEL(mov2) {
       rd = (inst >> 0) & 7;
       rn = (inst >> 3) & 7;
       DO_DISS(statusMsg << "movs r" << dec << rd << ",r" << dec << rn << endl);
@@ -2216,11 +2445,11 @@ int Thumbulator::execute()
       do_zflag(rc);
       do_cflag_bit(0);
       do_vflag_bit(0);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //MOV(3)
-    case Op::mov3: {
+    case Op::mov3: OP_LABEL(mov3) {
       rd  = (inst >> 0) & 0x7;
       rd |= (inst >> 4) & 0x8;
       rm  = (inst >> 3) & 0xF;
@@ -2237,11 +2466,11 @@ int Thumbulator::execute()
         rc += 2;  //The program counter is special
       }
       write_register(rd, rc);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //MUL
-    case Op::mul: {
+    case Op::mul: OP_LABEL(mul) {
       rd = (inst >> 0) & 0x7;
       rm = (inst >> 3) & 0x7;
       DO_DISS(statusMsg << "muls r" << dec << rd << ",r" << dec << rm << endl);
@@ -2269,11 +2498,11 @@ int Thumbulator::execute()
       write_register(rd, rc);
       do_nflag(rc);
       do_zflag(rc);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //MVN
-    case Op::mvn: {
+    case Op::mvn: OP_LABEL(mvn) {
       rd = (inst >> 0) & 0x7;
       rm = (inst >> 3) & 0x7;
       DO_DISS(statusMsg << "mvns r" << dec << rd << ",r" << dec << rm << endl);
@@ -2282,11 +2511,11 @@ int Thumbulator::execute()
       write_register(rd, rc);
       do_nflag(rc);
       do_zflag(rc);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //NEG
-    case Op::neg: {
+    case Op::neg: OP_LABEL(neg) {
       rd = (inst >> 0) & 0x7;
       rm = (inst >> 3) & 0x7;
       DO_DISS(statusMsg << "negs r" << dec << rd << ",r" << dec << rm << endl);
@@ -2297,11 +2526,11 @@ int Thumbulator::execute()
       do_zflag(rc);
       do_cflag(0, ~ra, 1);
       do_vflag(0, ~ra, 1);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //ORR
-    case Op::orr: {
+    case Op::orr: OP_LABEL(orr) {
       rd = (inst >> 0) & 0x7;
       rm = (inst >> 3) & 0x7;
       DO_DISS(statusMsg << "orrs r" << dec << rd << ",r" << dec << rm << endl);
@@ -2311,11 +2540,11 @@ int Thumbulator::execute()
       write_register(rd, rc);
       do_nflag(rc);
       do_zflag(rc);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //POP
-    case Op::pop: {
+    case Op::pop: OP_LABEL(pop) {
     #if defined(THUMB_DISS)
       statusMsg << "pop {";
       for(ra=0,rb=0x01,rc=0;rb;rb=(rb<<1)&0xFF,++ra)
@@ -2369,11 +2598,11 @@ int Thumbulator::execute()
         sp += 4;
       }
       write_register(13, sp);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //PUSH
-    case Op::push: {
+    case Op::push: OP_LABEL(push) {
     #if defined(THUMB_DISS)
       statusMsg << "push {";
       for(ra=0,rb=0x01,rc=0;rb;rb=(rb<<1)&0xFF,++ra)
@@ -2442,11 +2671,11 @@ int Thumbulator::execute()
       }
       write_register(13, sp);
       FETCH_TYPE_N; // ??? (copied from stmia)
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //REV
-    case Op::rev: {
+    case Op::rev: OP_LABEL(rev) {
       rd = (inst >> 0) & 0x7;
       rn = (inst >> 3) & 0x7;
       DO_DISS(statusMsg << "rev r" << dec << rd << ",r" << dec << rn << endl);
@@ -2456,11 +2685,11 @@ int Thumbulator::execute()
       rc |= ((ra >> 16) & 0xFF) <<  8;
       rc |= ((ra >> 24) & 0xFF) <<  0;
       write_register(rd, rc);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //REV16
-    case Op::rev16: {
+    case Op::rev16: OP_LABEL(rev16) {
       rd = (inst >> 0) & 0x7;
       rn = (inst >> 3) & 0x7;
       DO_DISS(statusMsg << "rev16 r" << dec << rd << ",r" << dec << rn << endl);
@@ -2470,11 +2699,11 @@ int Thumbulator::execute()
       rc |= ((ra >> 16) & 0xFF) << 24;
       rc |= ((ra >> 24) & 0xFF) << 16;
       write_register(rd, rc);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //REVSH
-    case Op::revsh: {
+    case Op::revsh: OP_LABEL(revsh) {
       rd = (inst >> 0) & 0x7;
       rn = (inst >> 3) & 0x7;
       DO_DISS(statusMsg << "revsh r" << dec << rd << ",r" << dec << rn << endl);
@@ -2484,11 +2713,11 @@ int Thumbulator::execute()
       if(rc & 0x8000) rc |= 0xFFFF0000;
       else            rc &= 0x0000FFFF;
       write_register(rd, rc);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //ROR
-    case Op::ror: {
+    case Op::ror: OP_LABEL(ror) {
       rd = (inst >> 0) & 0x7;
       rs = (inst >> 3) & 0x7;
       DO_DISS(statusMsg << "rors r" << dec << rd << ",r" << dec << rs << endl);
@@ -2517,11 +2746,11 @@ int Thumbulator::execute()
       do_nflag(rc);
       do_zflag(rc);
       INC_SHIFT_CYCLES;
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //SBC
-    case Op::sbc: {
+    case Op::sbc: OP_LABEL(sbc) {
       rd = (inst >> 0) & 0x7;
       rm = (inst >> 3) & 0x7;
       DO_DISS(statusMsg << "sbc r" << dec << rd << ",r" << dec << rm << endl);
@@ -2542,19 +2771,19 @@ int Thumbulator::execute()
         do_cflag(ra, ~rb, 0);
         do_vflag(ra, ~rb, 0);
       }
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
 #ifndef UNSAFE_OPTIMIZATIONS
     //SETEND
-    case Op::setend: {
+    case Op::setend: OP_LABEL(setend) {
       statusMsg << "setend not implemented" << endl;
       return 1;
     }
 #endif
 
     //STMIA
-    case Op::stmia: {
+    case Op::stmia: OP_LABEL(stmia) {
       rn = (inst >> 8) & 0x7;
     #if defined(THUMB_DISS)
       statusMsg << "stmia r" << dec << rn << "!,{";
@@ -2589,11 +2818,11 @@ int Thumbulator::execute()
       }
       write_register(rn, sp);
       FETCH_TYPE_N;
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //STR(1)
-    case Op::str1: {
+    case Op::str1: OP_LABEL(str1) {
       rd = (inst >> 0) & 0x07;
       rn = (inst >> 3) & 0x07;
       rb = (inst >> 6) & 0x1F;
@@ -2603,11 +2832,11 @@ int Thumbulator::execute()
       rc = read_register(rd);
       write32(rb, rc);
       INC_STR_CYCLES;
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //STR(2)
-    case Op::str2: {
+    case Op::str2: OP_LABEL(str2) {
       rd = (inst >> 0) & 0x7;
       rn = (inst >> 3) & 0x7;
       rm = (inst >> 6) & 0x7;
@@ -2616,11 +2845,11 @@ int Thumbulator::execute()
       rc = read_register(rd);
       write32(rb, rc);
       INC_STR_CYCLES;
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //STR(3)
-    case Op::str3: {
+    case Op::str3: OP_LABEL(str3) {
       rb = (inst >> 0) & 0xFF;
       rd = (inst >> 8) & 0x07;
       rb <<= 2;
@@ -2630,11 +2859,11 @@ int Thumbulator::execute()
       rc = read_register(rd);
       write32(rb, rc);
       INC_STR_CYCLES;
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //STRB(1)
-    case Op::strb1: {
+    case Op::strb1: OP_LABEL(strb1) {
       rd = (inst >> 0) & 0x07;
       rn = (inst >> 3) & 0x07;
       rb = (inst >> 6) & 0x1F;
@@ -2658,11 +2887,11 @@ int Thumbulator::execute()
       }
       write16(rb & (~1U), ra & 0xFFFF);
       INC_STRB_CYCLES;
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //STRB(2)
-    case Op::strb2: {
+    case Op::strb2: OP_LABEL(strb2) {
       rd = (inst >> 0) & 0x7;
       rn = (inst >> 3) & 0x7;
       rm = (inst >> 6) & 0x7;
@@ -2686,11 +2915,11 @@ int Thumbulator::execute()
       }
       write16(rb & (~1U), ra & 0xFFFF);
       INC_STRB_CYCLES;
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //STRH(1)
-    case Op::strh1: {
+    case Op::strh1: OP_LABEL(strh1) {
       rd = (inst >> 0) & 0x07;
       rn = (inst >> 3) & 0x07;
       rb = (inst >> 6) & 0x1F;
@@ -2700,11 +2929,11 @@ int Thumbulator::execute()
       rc=  read_register(rd);
       write16(rb, rc & 0xFFFF);
       INC_STR_CYCLES;
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //STRH(2)
-    case Op::strh2: {
+    case Op::strh2: OP_LABEL(strh2) {
       rd = (inst >> 0) & 0x7;
       rn = (inst >> 3) & 0x7;
       rm = (inst >> 6) & 0x7;
@@ -2713,11 +2942,11 @@ int Thumbulator::execute()
       rc = read_register(rd);
       write16(rb, rc & 0xFFFF);
       INC_STR_CYCLES;
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //SUB(1)
-    case Op::sub1: {
+    case Op::sub1: OP_LABEL(sub1) {
       rd = (inst >> 0) & 0x7;
       rn = (inst >> 3) & 0x7;
       rb = (inst >> 6) & 0x7;
@@ -2729,11 +2958,11 @@ int Thumbulator::execute()
       do_zflag(rc);
       do_cflag(ra, ~rb, 1);
       do_vflag(ra, ~rb, 1);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //SUB(2)
-    case Op::sub2: {
+    case Op::sub2: OP_LABEL(sub2) {
       rb = (inst >> 0) & 0xFF;
       rd = (inst >> 8) & 0x07;
       DO_DISS(statusMsg << "subs r" << dec << rd << ",#0x" << Base::HEX2 << rb << endl);
@@ -2744,11 +2973,11 @@ int Thumbulator::execute()
       do_zflag(rc);
       do_cflag(ra, ~rb, 1);
       do_vflag(ra, ~rb, 1);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //SUB(3)
-    case Op::sub3: {
+    case Op::sub3: OP_LABEL(sub3) {
       rd = (inst >> 0) & 0x7;
       rn = (inst >> 3) & 0x7;
       rm = (inst >> 6) & 0x7;
@@ -2761,29 +2990,29 @@ int Thumbulator::execute()
       do_zflag(rc);
       do_cflag(ra, ~rb, 1);
       do_vflag(ra, ~rb, 1);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //SUB(4)
-    case Op::sub4: {
+    case Op::sub4: OP_LABEL(sub4) {
       rb = inst & 0x7F;
       rb <<= 2;
       DO_DISS(statusMsg << "sub SP,#0x" << Base::HEX2 << rb << endl);
       ra = read_register(13);
       ra -= rb;
       write_register(13, ra);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //SWI
-    case Op::swi: {
+    case Op::swi: OP_LABEL(swi) {
       rb = inst & 0xFF;
       DO_DISS(statusMsg << "swi 0x" << Base::HEX2 << rb << endl);
 
       if(rb == 0xCC)
       {
         write_register(0, cpsr);
-        return 0;
+        NEXT_INSTRUCTION;
       }
       else
       {
@@ -2795,7 +3024,7 @@ int Thumbulator::execute()
     }
 
     //SXTB
-    case Op::sxtb: {
+    case Op::sxtb: OP_LABEL(sxtb) {
       rd = (inst >> 0) & 0x7;
       rm = (inst >> 3) & 0x7;
       DO_DISS(statusMsg << "sxtb r" << dec << rd << ",r" << dec << rm << endl);
@@ -2804,11 +3033,11 @@ int Thumbulator::execute()
       if(rc & 0x80)
         rc |= (~0U) << 8;
       write_register(rd, rc);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //SXTH
-    case Op::sxth: {
+    case Op::sxth: OP_LABEL(sxth) {
       rd = (inst >> 0) & 0x7;
       rm = (inst >> 3) & 0x7;
       DO_DISS(statusMsg << "sxth r" << dec << rd << ",r" << dec << rm << endl);
@@ -2817,11 +3046,11 @@ int Thumbulator::execute()
       if(rc & 0x8000)
         rc |= (~0U) << 16;
       write_register(rd, rc);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //TST
-    case Op::tst: {
+    case Op::tst: OP_LABEL(tst) {
       rn = (inst >> 0) & 0x7;
       rm = (inst >> 3) & 0x7;
       DO_DISS(statusMsg << "tst r" << dec << rn << ",r" << dec << rm << endl);
@@ -2830,40 +3059,40 @@ int Thumbulator::execute()
       rc = ra & rb;
       do_nflag(rc);
       do_zflag(rc);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //UXTB
-    case Op::uxtb: {
+    case Op::uxtb: OP_LABEL(uxtb) {
       rd = (inst >> 0) & 0x7;
       rm = (inst >> 3) & 0x7;
       DO_DISS(statusMsg << "uxtb r" << dec << rd << ",r" << dec << rm << endl);
       ra = read_register(rm);
       rc = ra & 0xFF;
       write_register(rd, rc);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     //UXTH
-    case Op::uxth: {
+    case Op::uxth: OP_LABEL(uxth) {
       rd = (inst >> 0) & 0x7;
       rm = (inst >> 3) & 0x7;
       DO_DISS(statusMsg << "uxth r" << dec << rd << ",r" << dec << rm << endl);
       ra = read_register(rm);
       rc = ra & 0xFFFF;
       write_register(rd, rc);
-      return 0;
+      NEXT_INSTRUCTION;
     }
 
     // Silence compiler
-    case Op::numOps:
+    case Op::numOps: OP_LABEL(numOps)
       break;
 
 #ifndef UNSAFE_OPTIMIZATIONS
-    case Op::invalid:
+    case Op::invalid: OP_LABEL(invalid)
       break;
 #else
-    default:
+    default: OP_LABEL(invalid)
       break;
 #endif
   }
@@ -2874,6 +3103,10 @@ int Thumbulator::execute()
   return 1;
 }
 
+#ifdef THUMB_THREADED_CODE
+  #pragma GCC diagnostic pop
+#endif
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int Thumbulator::reset()
 {
@@ -2894,7 +3127,10 @@ int Thumbulator::reset()
   // fxq: don't care about below so much (maybe to guess timing???)
 #ifndef UNSAFE_OPTIMIZATIONS
   _stats.instructions = 0;
-  statusMsg.str("");
+  // Only messages of a failed call have to be discarded; replacing the
+  // buffer of the stream on every call is not for free
+  if(statusMsg.tellp() > 0)
+    statusMsg.str("");
 #endif
 #ifdef THUMB_STATS
   _stats.reads = _stats.writes
@@ -2916,6 +3152,16 @@ int Thumbulator::reset()
   return 0;
 }
 
+#ifdef THUMB_CYCLE_COUNT
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::startProfile(const std::function<uInt32()>& frame)
+{
+  _profiler = make_unique<ThumbProfiler>(romSize, 0x40000000, RAMSIZE);
+  _profileFrame = frame;
+  _profiling = true;
+}
+#endif
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Thumbulator::ChipPropsType Thumbulator::setChipType(ChipType type)
 {
@@ -2929,10 +3175,37 @@ Thumbulator::ChipPropsType Thumbulator::setChipType(ChipType type)
 #endif
 
   setConsoleTiming(_consoleTiming);
+  updateTiming();
 
   return props;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::updateTiming()
+{
+#ifdef THUMB_CYCLE_COUNT
+  const uInt8 flash = uInt8(_flashCycles);  // 3|4
+
+  for(uInt32 c = 0; c < 2; ++c)
+    for(uInt32 a = 0; a < 3; ++a)
+    {
+      const auto cycleType = static_cast<CycleType>(c);
+      const auto accessType = static_cast<AccessType>(a);
+      FlashTiming& timing = _flashTiming[c][a];
+
+      // Mode 1 only buffers sequential instruction fetches
+      timing.mam = !(mamcr == MamModeType::mode0 ||
+                     (mamcr == MamModeType::mode1 &&
+                      (cycleType == CycleType::N || accessType == AccessType::data)));
+      timing.hit = 1;
+      // The buffers are still updated in mode X
+      timing.miss = mamcr == MamModeType::modeX ? 1 : flash;
+    }
+
+  _mamBankBit = _flashBanks == 1 ? 0 : 1;
+#endif
+}
+
 #ifdef THUMB_CYCLE_COUNT
 // Notes:
 // For exact cylce counting we have to
@@ -2959,116 +3232,77 @@ Thumbulator::ChipPropsType Thumbulator::setChipType(ChipType type)
 */
 bool Thumbulator::isMamBuffered(uInt32 addr, AccessType accessType)
 {
-  if(_flashBanks == 1) // e.g. LPC2101_02_03
-  {
-    // single Flash bank
-    addr &= ~0x7F; // 128-bit address line
+  // With a single flash bank (e.g. LPC2101_02_03), only the buffers of
+  // bank 0 are used; with dual flash banks (e.g. LPC2104_05_06), the
+  // buffers of the other bank are loaded speculatively
+  const uInt32 bank = (addr >> 7) & _mamBankBit;
 
-    switch(accessType)
-    {
-      case AccessType::prefetch:
-        if(addr != _prefetchBufferAddr[0] && addr != _branchBufferAddr[0])
-        {
-        #ifdef THUMB_STATS
-          ++_stats.mamPrefetchMisses;
-        #endif
-          _prefetchBufferAddr[0] = addr;
-          return false;
-        }
-      #ifdef THUMB_STATS
-        ++_stats.mamPrefetchHits;
-      #endif
-        break;
+  addr &= ~0x7F; // 128-bit address line
 
-      case AccessType::branch:
-        if(addr != _prefetchBufferAddr[0] && addr != _branchBufferAddr[0])
-        {
-        #ifdef THUMB_STATS
-          ++_stats.mamBranchMisses;
-        #endif
-          _branchBufferAddr[0] = addr;
-          return false;
-        }
-      #ifdef THUMB_STATS
-        ++_stats.mamBranchHits;
-      #endif
-
-        break;
-
-      default: // AccessType::data
-        if(addr != _dataBufferAddr)
-        {
-        #ifdef THUMB_STATS
-          ++_stats.mamDataMisses;
-        #endif
-          _dataBufferAddr = addr;
-          return false;
-        }
-      #ifdef THUMB_STATS
-        ++_stats.mamDataHits;
-      #endif
-        break;
-    };
-  }
-  else // e.g. LPC2104_05_06
+  switch(accessType)
   {
-    // dual Flash bank
-    uInt32 bank = (addr & 0x80) ? 1 : 0;
-
-    addr &= ~0x7F; // 128-bit address line
-
-    switch(accessType)
-    {
-      case AccessType::prefetch:
-        // speculative load, executed after last instrucution has been executed
-        _prefetchBufferAddr[bank ^ 1] = addr + 0x80;
-        if(addr != _prefetchBufferAddr[bank] && addr != _branchBufferAddr[bank])
-        {
-        #ifdef THUMB_STATS
-          ++_stats.mamPrefetchMisses;
-        #endif
-          _prefetchBufferAddr[bank] = addr;
-          return false;
-        }
+    case AccessType::prefetch:
+      // speculative load, executed after last instrucution has been executed
+      _prefetchBufferAddr[bank ^ 1] = addr + 0x80;
+      if(addr != _prefetchBufferAddr[bank] && addr != _branchBufferAddr[bank])
+      {
       #ifdef THUMB_STATS
-        ++_stats.mamPrefetchHits;
+        ++_stats.mamPrefetchMisses;
       #endif
-        break;
+        _prefetchBufferAddr[bank] = addr;
+        return false;
+      }
+    #ifdef THUMB_STATS
+      ++_stats.mamPrefetchHits;
+    #endif
+      break;
 
-      case AccessType::branch:
-        if(addr != _prefetchBufferAddr[bank] && addr != _branchBufferAddr[bank])
-        {
-        #ifdef THUMB_STATS
-          ++_stats.mamBranchMisses;
-        #endif
-          // load both branch trail buffers at once
-          _branchBufferAddr[bank] = addr;
-          _branchBufferAddr[bank ^ 1] = addr + 0x80;
-          return false;
-        }
+    case AccessType::branch:
+      if(addr != _prefetchBufferAddr[bank] && addr != _branchBufferAddr[bank])
+      {
       #ifdef THUMB_STATS
-        ++_stats.mamBranchHits;
+        ++_stats.mamBranchMisses;
       #endif
-        break;
+        // load both branch trail buffers at once
+        _branchBufferAddr[bank] = addr;
+        _branchBufferAddr[bank ^ 1] = addr + 0x80;
+        return false;
+      }
+    #ifdef THUMB_STATS
+      ++_stats.mamBranchHits;
+    #endif
+      break;
 
-      default: // AccessType::data
-        if(addr != _dataBufferAddr)
-        {
-        #ifdef THUMB_STATS
-          ++_stats.mamDataMisses;
-        #endif
-          _dataBufferAddr = addr;
-          return false;
-        }
+    default: // AccessType::data
+      if(addr != _dataBufferAddr)
+      {
       #ifdef THUMB_STATS
-        ++_stats.mamDataHits;
+        ++_stats.mamDataMisses;
       #endif
-        break;
-    };
-  }
+        _dataBufferAddr = addr;
+        return false;
+      }
+    #ifdef THUMB_STATS
+      ++_stats.mamDataHits;
+    #endif
+      break;
+  };
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline uInt32 Thumbulator::flashCycles(uInt32 addr, CycleType cycleType,
+                                       AccessType accessType)
+{
+  if(addr & 0xC0000000) // RAM, peripherals
+    return 1;
+
+  const FlashTiming& timing =
+    _flashTiming[static_cast<uInt32>(cycleType)][static_cast<uInt32>(accessType)];
+
+  return timing.mam && isMamBuffered(addr, accessType) ? timing.hit : timing.miss;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Thumbulator::incCycles(AccessType accessType, uInt32 cycles)
 {
@@ -3152,26 +3386,7 @@ void Thumbulator::incSCycles(uInt32 addr, AccessType accessType)
   ++_stats.sCylces;
 #endif
 
-  uInt32 cycles;
-
-
-  if(addr & 0xC0000000) // RAM, peripherals
-    cycles = 1;
-  else // Flash
-  {
-    if(mamcr == MamModeType::mode0 ||
-       (mamcr == MamModeType::mode1 && accessType == AccessType::data))
-    {
-      cycles = _flashCycles; // 3|4
-    }
-    else
-    {
-      if(isMamBuffered(addr, accessType) || mamcr == MamModeType::modeX)
-        cycles = 1;
-      else
-        cycles = _flashCycles;
-    }
-  }
+  uInt32 cycles = flashCycles(addr, CycleType::S, accessType);
 
 #ifdef MERGE_I_S
   //if(accessType != AccessType::prefetch)
@@ -3216,20 +3431,7 @@ void Thumbulator::incNCycles(uInt32 addr, AccessType accessType)
   ++_stats.nCylces;
 #endif
 
-  uInt32 cycles;
-
-  if(addr & 0xC0000000) // RAM, peripherals
-    cycles = 1;
-  else // Flash
-  {
-    if(mamcr < MamModeType::mode2)
-      cycles = _flashCycles; // 3|4
-    else
-      if(isMamBuffered(addr, accessType) || mamcr == MamModeType::modeX)
-        cycles = 1;
-      else
-        cycles = _flashCycles;
-  }
+  uInt32 cycles = flashCycles(addr, CycleType::N, accessType);
 #ifdef MERGE_I_S
   _lastCycleType[2] = _lastCycleType[1];
   _lastCycleType[1] = _lastCycleType[0];
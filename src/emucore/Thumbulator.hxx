@@ -27,6 +27,9 @@
 
 class Cartridge;
 
+#include <map>
+#include <mutex>
+
 #include "bspf.hxx"
 #include "Console.hxx"
 
@@ -51,7 +54,14 @@ class Cartridge;
   #define THUMB_STATS
 #endif
 
+// Computed goto dispatch is a GCC/clang extension
+#if defined(__GNUC__)
+  #define THUMB_THREADED_CODE
+#endif
+
 #ifdef THUMB_CYCLE_COUNT
+  #include "ThumbProfiler.hxx"
+
   //#define EMULATE_PIPELINE  // enable coarse ARM pipeline emulation (TODO)
   #define TIMER_0           // enable timer 0 support (e.g. for measuring cycle count)
 #endif
@@ -115,13 +125,30 @@ class Thumbulator
     const Stats& stats() const { return _stats; }
     uInt32 cycles() const { return _totalCycles; }
     ChipPropsType setChipType(ChipType type);
-    void setMamMode(MamModeType mode) { mamcr = mode; }
+    void setMamMode(MamModeType mode) { mamcr = mode; updateTiming(); }
     void lockMamMode(bool lock) { _lockMamcr = lock; }
+    void enableThreadedCode(bool enable) { _threadedCode = enable; }
     MamModeType mamMode() const { return static_cast<MamModeType>(mamcr); }
+    void setRom(const uInt16* rom_ptr) { rom = rom_ptr; setupPageTables(); }
+    // Size of the decoded ROM (shared by all instances running the same ROM)
+    size_t decodedRomSize() const { return romSize / 2 * sizeof(Op); }
 
   #ifdef THUMB_CYCLE_COUNT
     void cycleFactor(double factor) { _armCyclesFactor = factor; }
     double cycleFactor() const { return _armCyclesFactor; }
+
+    /**
+      Start counting the cycles per instruction and function (see
+      ThumbProfiler), discarding the previous profile, resp. stop counting.
+      The profile stays available until the next start.
+
+      @param frame  Returns the current frame number, which is queried
+                    at the start of each run
+    */
+    void startProfile(const std::function<uInt32()>& frame);
+    void stopProfile() { _profiling = false; }
+    bool isProfiling() const { return _profiling; }
+    ThumbProfiler* profiler() const { return _profiler.get(); }
   #else
     void cycleFactor(double) { }
     double cycleFactor() const { return 1.0; }
@@ -234,6 +261,12 @@ class Thumbulator
 
     static Op decodeInstructionWord(uint16_t inst);
 
+    /**
+      Get the decoded instructions of the given ROM. They are immutable, and
+      shared by all instances running the same ROM.
+    */
+    static shared_ptr<const Op[]> decodeRom(const uInt16* rom, uInt32 romSize);
+
     void do_zflag(uInt32 x);
     void do_nflag(uInt32 x);
     void do_cflag(uInt32 a, uInt32 b, uInt32 c);
@@ -251,11 +284,40 @@ class Thumbulator
     void dump_counters();
     void dump_regs();
   #endif
+    Op fetchAndDecode(uInt32& pc, uInt32& inst);
+
+    /**
+      Map the pages of ROM and RAM which can be accessed directly.  All
+      other memory (peripherals, protected driver RAM, ROM beyond the
+      image) takes the slow path in read16/read32/write16/write32.
+    */
+    void setupPageTables();
+
+    /**
+      Precompute the flash timing for the current chip and MAM mode, which
+      must be called whenever one of them changes.
+    */
+    void updateTiming();
+
+    /**
+      Get the page table index of an address, or NUM_PAGES if the address
+      is neither in ROM nor in RAM.
+    */
+    static uInt32 pageIndex(uInt32 addr) {
+      if(addr < ROMSIZE)
+        return addr >> PAGE_SHIFT;
+      if(addr - 0x40000000 < RAMSIZE)
+        return ROM_PAGES + ((addr - 0x40000000) >> PAGE_SHIFT);
+      return NUM_PAGES;
+    }
     int execute();
+    // Prepare the registers for the next call into the ARM code; the
+    // decoded instructions, page tables, memory and timers persist
     int reset();
 
   #ifdef THUMB_CYCLE_COUNT
     bool isMamBuffered(uInt32 addr, AccessType = AccessType::data);
+    uInt32 flashCycles(uInt32 addr, CycleType cycleType, AccessType accessType);
     void incCycles(AccessType accessType, uInt32 cycles);
     void incSCycles(uInt32 addr, AccessType = AccessType::data);
     void incNCycles(uInt32 addr, AccessType = AccessType::data);
@@ -268,8 +330,27 @@ class Thumbulator
     uInt32 cBase{0};
     uInt32 cStart{0};
     uInt32 cStack{0};
-    const unique_ptr<Op[]> decodedRom;  // NOLINT
+    const shared_ptr<const Op[]> decodedRom;  // NOLINT
     uInt16* ram{nullptr};
+    // Code in RAM can be modified (by the ARM or the cart), so each
+    // decoded entry remembers the instruction word it was decoded from
+    struct DecodedRamOp {
+      uInt16 inst{0};
+      Op op{Op::invalid};
+    };
+    const unique_ptr<DecodedRamOp[]> decodedRam;  // NOLINT
+
+    // The decoded ROMs in use, keyed by ROM size and MD5
+    static std::mutex ourDecodedRomsMutex;
+    static std::map<string, std::weak_ptr<const Op[]>> ourDecodedRoms;
+    // Page tables for direct access to ROM and RAM (1K pages); a nullptr
+    // entry means that the page must be accessed through the slow path
+    static constexpr uInt32 PAGE_SHIFT = 10;
+    static constexpr uInt32 PAGE_MASK = (1 << PAGE_SHIFT) - 1;
+    static constexpr uInt32 ROM_PAGES = ROMSIZE >> PAGE_SHIFT;
+    static constexpr uInt32 NUM_PAGES = ROM_PAGES + (RAMSIZE >> PAGE_SHIFT);
+    std::array<const uInt16*, NUM_PAGES> readPages{nullptr};
+    std::array<uInt16*, NUM_PAGES> writePages{nullptr};
     std::array<uInt32, 16> reg_norm; // normal execution mode, do not have a thread mode
     uInt32 cpsr{0};
     MamModeType mamcr{MamModeType::mode0};
@@ -305,9 +386,14 @@ class Thumbulator
   #endif
     bool _countCycles{false};
     bool _lockMamcr{false};
+    bool _threadedCode{false};
 
   #ifdef THUMB_CYCLE_COUNT
     double _armCyclesFactor{1.05};
+    // The cycle profile, and whether it is currently being recorded
+    unique_ptr<ThumbProfiler> _profiler;
+    std::function<uInt32()> _profileFrame;
+    bool _profiling{false};
     uInt32 _pipeIdx{0};
     CycleType _prefetchCycleType[3]{CycleType::S};
     CycleType _lastCycleType[3]{CycleType::S};
@@ -319,6 +405,16 @@ class Thumbulator
     uInt32 _prefetchBufferAddr[2]{0};
     uInt32 _branchBufferAddr[2]{0};
     uInt32 _dataBufferAddr{0};
+    // The cycles of a flash access, per S/N cycle and access type; when
+    // 'mam' is set, the MAM buffers decide between 'hit' and 'miss'
+    struct FlashTiming {
+      bool mam{false};
+      uInt8 hit{1};
+      uInt8 miss{1};
+    };
+    std::array<std::array<FlashTiming, 3>, 2> _flashTiming;
+    // Selects the MAM buffers of an address (1 for two flash banks)
+    uInt32 _mamBankBit{0};
   #endif
   #ifdef COUNT_OPS
     uInt32 opCount[size_t(Op::numOps)]{0};
@@ -55,6 +55,8 @@ MODULE_OBJS := \
         src/emucore/CartX07.o \
         src/emucore/CompuMate.o \
         src/emucore/Console.o \
+        src/emucore/ConsoleBatch.o \
+        src/emucore/ConsoleWall.o \
         src/emucore/Control.o \
         src/emucore/ControllerDetector.o \
         src/emucore/DispatchResult.o \
@@ -66,15 +68,23 @@ MODULE_OBJS := \
         src/emucore/FBSurface.o \
         src/emucore/FSNode.o \
         src/emucore/Genesis.o \
+        src/emucore/HeadlessConsole.o \
+        src/emucore/HeadlessRunner.o \
+        src/emucore/ImageCache.o \
+        src/emucore/InputMovie.o \
+        src/emucore/InputScript.o \
         src/emucore/Joystick.o \
         src/emucore/Keyboard.o \
         src/emucore/KidVid.o \
         src/emucore/Lightgun.o \
+        src/emucore/MicroBenchmark.o \
         src/emucore/MindLink.o \
         src/emucore/M6502.o \
         src/emucore/M6532.o \
         src/emucore/MT24LC256.o \
         src/emucore/MD5.o \
+        src/emucore/MemoryUsage.o \
+        src/emucore/ObservationProcessor.o \
         src/emucore/OSystem.o \
         src/emucore/OSystemStandalone.o \
         src/emucore/Paddles.o \
@@ -84,9 +94,17 @@ MODULE_OBJS := \
         src/emucore/Props.o \
         src/emucore/PropsSet.o \
         src/emucore/QuadTari.o \
+        src/emucore/RegisterTrace.o \
+        src/emucore/RegisterTraceBenchmark.o \
+        src/emucore/ReplayBenchmark.o \
+        src/emucore/RomLoader.o \
+        src/emucore/RomSignatures.o \
         src/emucore/SaveKey.o \
         src/emucore/Serializer.o \
         src/emucore/Settings.o \
+        src/emucore/SharedStateExport.o \
+        src/emucore/SignatureScanner.o \
+        src/emucore/StateSearch.o \
         src/emucore/Switches.o \
         src/emucore/System.o \
         src/emucore/TIASurface.o \
@@ -35,6 +35,7 @@ void AnalogReadout::reset(uInt64 timestamp)
   myTimestamp = timestamp;
 
   setConsoleTiming(ConsoleTiming::ntsc);
+  updateFlip();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -51,30 +52,30 @@ void AnalogReadout::vblank(uInt8 value, uInt64 timestamp)
   }
 
   myTimestamp = timestamp;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt8 AnalogReadout::inpt(uInt64 timestamp)
-{
-  updateCharge(timestamp);
-
-  bool state = myIsDumped ? false : myU > myUThresh;
-
-  return state ? 0x80 : 0;
+  updateFlip();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AnalogReadout::update(Connection connection, uInt64 timestamp, ConsoleTiming consoleTiming)
 {
+  bool changed = false;
+
   if (consoleTiming != myConsoleTiming) {
+    // Charge up to now with the previous timing
+    updateCharge(timestamp);
+
     setConsoleTiming(consoleTiming);
+    changed = true;
   }
 
   if (connection != myConnection) {
     updateCharge(timestamp);
 
     myConnection = connection;
+    changed = true;
   }
+
+  if (changed) updateFlip();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -115,6 +116,45 @@ void AnalogReadout::updateCharge(uInt64 timestamp)
   myTimestamp = timestamp;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AnalogReadout::updateFlip()
+{
+  myState = myU > myUThresh;
+  myFlipTimestamp = NEVER;
+
+  // While dumped, INPTx reads 0 regardless of the charge
+  if (myIsDumped) return;
+
+  // Solve the charge curves of updateCharge() for the threshold, in clocks
+  const double tau = (myConnection.resistance + R0) * C * myClockFreq;
+  double clocks = -1;
+
+  switch (myConnection.type) {
+    case ConnectionType::vcc:
+      // Charging, myU > myUThresh for all clocks > t
+      if (!myState)
+        clocks = std::floor(tau * log((U_SUPP - myU) / (U_SUPP - myUThresh))) + 1;
+
+      break;
+
+    case ConnectionType::ground:
+      // Discharging, myU > myUThresh for all clocks < t
+      if (myState)
+        clocks = std::ceil(tau * log(myU / myUThresh));
+
+      break;
+
+    case ConnectionType::disconnected:
+      break;
+
+    default:
+      throw runtime_error("unreachable");
+  }
+
+  if (clocks >= 0 && clocks < static_cast<double>(NEVER - myTimestamp))
+    myFlipTimestamp = myTimestamp + static_cast<uInt64>(clocks);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool AnalogReadout::save(Serializer& out) const
 {
@@ -161,6 +201,7 @@ bool AnalogReadout::load(Serializer& in)
     cerr << "ERROR: TIA_AnalogReadout::load" << endl;
     return false;
   }
+  updateFlip();
 
   return true;
 }
@@ -49,7 +49,9 @@ class AnalogReadout : public Serializable
     void vblank(uInt8 value, uInt64 timestamp);
     bool vblankDumped() const { return myIsDumped; }
 
-    uInt8 inpt(uInt64 timestamp);
+    uInt8 inpt(uInt64 timestamp) const {
+      return !myIsDumped && (timestamp >= myFlipTimestamp) != myState ? 0x80 : 0;
+    }
 
     void update(Connection connection, uInt64 timestamp, ConsoleTiming consoleTiming);
 
@@ -73,6 +75,12 @@ class AnalogReadout : public Serializable
 
     void updateCharge(uInt64 timestamp);
 
+    /**
+      Calculate when the charge crosses the threshold, after any change of
+      the charge, connection or timing.
+    */
+    void updateFlip();
+
   private:
 
     double myUThresh{0.0};
@@ -86,6 +94,13 @@ class AnalogReadout : public Serializable
 
     bool myIsDumped{false};
 
+    // The state of INPTx at myTimestamp, and the timestamp from which on
+    // it is inverted (if ever), so that reads don't need to update the charge
+    bool myState{false};
+    uInt64 myFlipTimestamp{NEVER};
+
+    static constexpr uInt64 NEVER = ~0ULL;
+
     static constexpr double
       R0 = 1.8e3,
       C = 68e-9,
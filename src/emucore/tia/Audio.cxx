@@ -45,6 +45,7 @@ Audio::Audio()
 void Audio::reset()
 {
   myCounter = 0;
+  myPendingClocks = 0;
   mySampleIndex = 0;
 
   myChannel0.reset();
@@ -63,6 +64,9 @@ void Audio::setAudioQueue(const shared_ptr<AudioQueue>& queue)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Audio::tick()
 {
+  // Switching from spans to single clocks must not reorder any samples
+  if (myPendingClocks > 0) flush();
+
   switch (myCounter) {
     case 9:
     case 81:
@@ -80,32 +84,113 @@ void Audio::tick()
   if (++myCounter == 228) myCounter = 0;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Audio::flush()
+{
+  uInt32 clocks = myPendingClocks;
+
+  myPendingClocks = 0;
+
+  while (clocks > 0)
+  {
+    // Starting right before the first phase 0 clock, every line produces
+    // two complete samples
+    if (myCounter == 9 && clocks >= 228)
+    {
+      const uInt32 lines = clocks / 228;
+
+      renderSamples(2 * lines);
+      clocks -= 228 * lines;
+
+      continue;
+    }
+
+    // Only four clocks of the 228 clock audio cycle do anything, the others
+    // are skipped
+    const uInt32 nextPhase =
+      myCounter <= 9 ? 9 : myCounter <= 37 ? 37 : myCounter <= 81 ? 81 :
+      myCounter <= 149 ? 149 : 228 + 9;
+    const uInt32 idle = std::min(clocks, nextPhase - myCounter);
+
+    myCounter = (myCounter + idle) % 228;
+    clocks -= idle;
+
+    if (clocks > 0)
+    {
+      tick();
+      --clocks;
+    }
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Audio::phase1()
 {
   uInt8 sample0 = myChannel0.phase1();
   uInt8 sample1 = myChannel1.phase1();
+  uInt8 external = 0x80;
+
+  if(myAudioSource) myAudioSource->render(&external, 1);
 
-  addSample(sample0, sample1);
+  if(!myOutputEnabled) return;
+
+  addSample(sample0, sample1, external);
 #ifdef GUI_SUPPORT
   mySamples.push_back(sample0 | (sample1 << 4));
 #endif
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Audio::addSample(uInt8 sample0, uInt8 sample1)
+void Audio::renderSamples(uInt32 count)
+{
+  // Same as alternating phase0() and phase1(), but the channels render
+  // whole blocks of samples
+  std::array<uInt8, 64> samples0, samples1, external;
+
+  while (count > 0)
+  {
+    const uInt32 n = std::min(count, uInt32(samples0.size()));
+
+    myChannel0.render(samples0.data(), n);
+    myChannel1.render(samples1.data(), n);
+    if (myAudioSource) myAudioSource->render(external.data(), n);
+    count -= n;
+
+    if(!myOutputEnabled) continue;
+
+    for (uInt32 i = 0; i < n; ++i)
+    {
+      addSample(samples0[i], samples1[i], myAudioSource ? external[i] : 0x80);
+    #ifdef GUI_SUPPORT
+      mySamples.push_back(samples0[i] | (samples1[i] << 4));
+    #endif
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Audio::addSample(uInt8 sample0, uInt8 sample1, uInt8 external)
 {
   if(!myAudioQueue) return;
 
+  // External samples are mixed in at half the range of the TIA
+  const Int32 offset = (Int32(external) - 0x80) << 7;
+  const auto mix = [offset](Int16 sample) {
+    return static_cast<Int16>(BSPF::clamp(sample + offset, -0x8000, 0x7fff));
+  };
+
   if(myAudioQueue->isStereo()) {
-    myCurrentFragment[2 * mySampleIndex] = myMixingTableIndividual[sample0];
-    myCurrentFragment[2 * mySampleIndex + 1] = myMixingTableIndividual[sample1];
+    myCurrentFragment[2 * mySampleIndex] = mix(myMixingTableIndividual[sample0]);
+    myCurrentFragment[2 * mySampleIndex + 1] = mix(myMixingTableIndividual[sample1]);
   }
   else {
-    myCurrentFragment[mySampleIndex] = myMixingTableSum[sample0 + sample1];
+    myCurrentFragment[mySampleIndex] = mix(myMixingTableSum[sample0 + sample1]);
   }
 
   if(++mySampleIndex == myAudioQueue->fragmentSize()) {
+    if(myAudioSink)
+      myAudioSink->consume(myCurrentFragment, mySampleIndex, myAudioQueue->isStereo());
+
     mySampleIndex = 0;
     myCurrentFragment = myAudioQueue->enqueue(myCurrentFragment);
   }
@@ -136,6 +221,12 @@ bool Audio::save(Serializer& out) const
     if (!myChannel0.save(out)) return false;
     if (!myChannel1.save(out)) return false;
   #ifdef GUI_SUPPORT
+    if(!myOutputEnabled)
+    {
+      out.putLong(0);
+      return true;
+    }
+
     out.putLong(uInt64(mySamples.size()));
     out.putByteArray(mySamples.data(), mySamples.size());
 
@@ -173,7 +264,7 @@ bool Audio::load(Serializer& in)
     //in.getShortArray((uInt16*)myCurrentFragment, myAudioQueue->fragmentSize());
 
     // Feed all loaded samples into the audio queue
-    for(size_t i = 0; i < sampleSize; i++)
+    for(size_t i = 0; myOutputEnabled && i < sampleSize; i++)
     {
       uInt8 sample = samples[i];
       uInt8 sample0 = sample & 0x0f;
@@ -24,6 +24,32 @@ class AudioQueue;
 #include "AudioChannel.hxx"
 #include "Serializable.hxx"
 
+/**
+  An additional source of samples (e.g. the KidVid tape), which is mixed
+  into the TIA output. Samples are unsigned 8 bit (0x80 is silence), one
+  per TIA sample, and are requested in blocks.
+*/
+class AudioSource
+{
+  public:
+    virtual ~AudioSource() = default;
+
+    virtual void render(uInt8* samples, uInt32 count) = 0;
+};
+
+/**
+  Receives every completed fragment of the audio output (e.g. for
+  streaming), on the thread which runs the emulation. Samples are the same
+  as those passed to the audio queue.
+*/
+class AudioSink
+{
+  public:
+    virtual ~AudioSink() = default;
+
+    virtual void consume(const Int16* fragment, uInt32 size, bool stereo) = 0;
+};
+
 class Audio : public Serializable
 {
   public:
@@ -33,8 +59,41 @@ class Audio : public Serializable
 
     void setAudioQueue(const shared_ptr<AudioQueue>& queue);
 
+    const AudioQueue* audioQueue() const { return myAudioQueue.get(); }
+
+    /**
+      Set an additional source of samples, or clear it with nullptr. The
+      source keeps running while output is disabled.
+    */
+    void setAudioSource(AudioSource* source) { flush(); myAudioSource = source; }
+
+    /**
+      Set a receiver for the output fragments, or clear it with nullptr.
+    */
+    void setAudioSink(AudioSink* sink) { flush(); myAudioSink = sink; }
+
+    /**
+      With output disabled the channels keep running, but no samples reach
+      the audio queue or the sample log for rewind playback; save() and
+      load() then skip the sample log as well (used for run-ahead).
+    */
+    void enableOutput(bool enabled) { flush(); myOutputEnabled = enabled; }
+
     void tick();
 
+    /**
+      Advance by the given number of clocks, same as calling tick() as many
+      times. The clocks are only accumulated; the samples are rendered in
+      one go by flush(), which must be called before the channel registers
+      change and before samples or state are handed out.
+    */
+    void tick(uInt32 clocks) { myPendingClocks += clocks; }
+
+    /**
+      Render the samples of all clocks accumulated by tick(uInt32).
+    */
+    void flush();
+
     AudioChannel& channel0();
 
     AudioChannel& channel1();
@@ -47,12 +106,16 @@ class Audio : public Serializable
 
   private:
     void phase1();
-    void addSample(uInt8 sample0, uInt8 sample1);
+    void renderSamples(uInt32 count);
+    void addSample(uInt8 sample0, uInt8 sample1, uInt8 external = 0x80);
 
   private:
     shared_ptr<AudioQueue> myAudioQueue;
+    AudioSource* myAudioSource{nullptr};
+    AudioSink* myAudioSink{nullptr};
 
     uInt8 myCounter{0};
+    uInt32 myPendingClocks{0};
 
     AudioChannel myChannel0;
     AudioChannel myChannel1;
@@ -62,6 +125,7 @@ class Audio : public Serializable
 
     Int16* myCurrentFragment{nullptr};
     uInt32 mySampleIndex{0};
+    bool myOutputEnabled{true};
   #ifdef GUI_SUPPORT
     mutable ByteArray mySamples;
   #endif
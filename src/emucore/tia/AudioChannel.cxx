@@ -117,6 +117,37 @@ uInt8 AudioChannel::phase1()
   return (myPulseCounter & 0x01) * myAudv;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioChannel::render(uInt8* samples, uInt32 count)
+{
+  while (count > 0)
+  {
+    if (!myClockEnable)
+    {
+      // Until the divider matches AUDF, phase0() only advances the divider
+      // (wrapping from 0x1f to 0) and phase1() leaves the counters alone
+      const uInt32 idle = std::min<uInt32>(count, myDivCounter <= myAudf
+        ? myAudf - myDivCounter
+        : 0x20 - myDivCounter + myAudf);
+
+      if (idle > 0)
+      {
+        std::fill_n(samples, idle, (myPulseCounter & 0x01) * myAudv);
+        myDivCounter = (myDivCounter + idle) & 0x1f;
+
+        samples += idle;
+        count -= idle;
+
+        continue;
+      }
+    }
+
+    phase0();
+    *samples++ = phase1();
+    --count;
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AudioChannel::audc(uInt8 value)
 {
@@ -32,6 +32,14 @@ class AudioChannel : public Serializable
 
     uInt8 phase1();
 
+    /**
+      Render the given number of samples, same as calling phase0() and
+      phase1() as many times. Runs of samples during which the divider
+      does not enable the clock repeat the same output and are filled in
+      at once.
+    */
+    void render(uInt8* samples, uInt32 count);
+
     void audc(uInt8 value);
 
     void audf(uInt8 value);
@@ -125,6 +125,13 @@ class Ball : public Serializable
      */
     bool isOn() const { return (collision & 0x8000); }
 
+    /**
+      The collision mask while the ball is visible resp. invisible.
+     */
+    uInt32 collisionMask(bool on) const {
+      return on ? myCollisionMaskEnabled : myCollisionMaskDisabled;
+    }
+
     /**
       Get the current color.
      */
@@ -174,6 +181,24 @@ class Ball : public Serializable
      */
     inline void tick(bool isReceivingRegularClock = true);
 
+    /**
+      The number of upcoming clocks during which tick() would only advance the
+      counter, as the ball neither draws nor starts drawing.
+     */
+    uInt8 idleClocks() const {
+      return myIsRendering || (myUseInvertedPhaseClock && myInvertedPhaseClock)
+        ? 0 : (156 + TIAConstants::H_PIXEL - myCounter) % TIAConstants::H_PIXEL;
+    }
+
+    /**
+      Advance by the given number (> 0) of idle clocks, see idleClocks().
+     */
+    void skip(uInt8 clocks) {
+      mySignalActive = false;
+      collision = myCollisionMaskDisabled;
+      myCounter = (myCounter + clocks) % TIAConstants::H_PIXEL;
+    }
+
   public:
 
     /**
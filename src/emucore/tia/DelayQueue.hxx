@@ -22,6 +22,7 @@
 #include "bspf.hxx"
 #include "smartmod.hxx"
 #include "DelayQueueMember.hxx"
+#include "EventCounters.hxx"
 
 template<unsigned length, unsigned capacity>
 class DelayQueueIteratorImpl;
@@ -29,6 +30,8 @@ class DelayQueueIteratorImpl;
 template<unsigned length, unsigned capacity>
 class DelayQueue : public Serializable
 {
+  static_assert(length <= 32, "delay queue length exceeds occupancy mask");
+
   public:
     friend DelayQueueIteratorImpl<length, capacity>;
 
@@ -43,6 +46,18 @@ class DelayQueue : public Serializable
 
     template<typename T> void execute(T executor);
 
+    /**
+      The number of upcoming clocks for which execute() would have nothing
+      to do. Returns the maximum uInt32 if the queue is completely empty.
+    */
+    uInt32 idleClocks() const;
+
+    /**
+      Advance the queue by the given number of clocks without executing
+      anything. Only valid if the queue is idle for that many clocks.
+    */
+    void skip(uInt32 clocks);
+
     /**
       Serializable methods (see that class for more information).
     */
@@ -54,6 +69,10 @@ class DelayQueue : public Serializable
     uInt8 myIndex{0};
     std::array<uInt8, 0xFF> myIndices;
 
+    // Bit i is set if myMembers[i] is not empty, so that idle clocks are
+    // found without touching the members
+    uInt32 myOccupied{0};
+
   private:
     DelayQueue(const DelayQueue&) = delete;
     DelayQueue(DelayQueue&&) = delete;
@@ -79,15 +98,22 @@ void DelayQueue<length, capacity>::push(uInt8 address, uInt8 value, uInt8 delay)
   if (delay >= length)
     throw runtime_error("delay exceeds queue length");
 
+  EventCounters::count(EventCounters::Event::delayPush);
+
   uInt8 currentIndex = myIndices[address];
 
-  if (currentIndex < length)
+  if (currentIndex < length) {
     myMembers[currentIndex].remove(address);
 
+    if (myMembers[currentIndex].mySize == 0)
+      myOccupied &= ~(uInt32{1} << currentIndex);
+  }
+
   uInt8 index = smartmod<length>(myIndex + delay);
   myMembers[index].push(address, value);
 
   myIndices[address] = index;
+  myOccupied |= uInt32{1} << index;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -99,6 +125,7 @@ void DelayQueue<length, capacity>::reset()
 
   myIndex = 0;
   myIndices.fill(0xFF);
+  myOccupied = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -114,10 +141,33 @@ void DelayQueue<length, capacity>::execute(T executor)
   }
 
   currentMember.clear();
+  myOccupied &= ~(uInt32{1} << myIndex);
 
   myIndex = smartmod<length>(myIndex + 1);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<unsigned length, unsigned capacity>
+uInt32 DelayQueue<length, capacity>::idleClocks() const
+{
+  if (myOccupied == 0) return ~uInt32{0};
+
+  // Rotate the current slot into bit 0
+  uInt64 occupied = (uInt64{myOccupied} | uInt64{myOccupied} << length) >> myIndex;
+  uInt32 clocks = 0;
+
+  for (; !(occupied & 1); occupied >>= 1) ++clocks;
+
+  return clocks;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<unsigned length, unsigned capacity>
+void DelayQueue<length, capacity>::skip(uInt32 clocks)
+{
+  myIndex = smartmod<length>(uInt8(myIndex + clocks % length));
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 template<unsigned length, unsigned capacity>
 bool DelayQueue<length, capacity>::save(Serializer& out) const
@@ -154,6 +204,10 @@ bool DelayQueue<length, capacity>::load(Serializer& in)
 
     myIndex = in.getByte();
     in.getByteArray(myIndices.data(), myIndices.size());
+
+    myOccupied = 0;
+    for (uInt32 i = 0; i < length; ++i)
+      if (myMembers[i].mySize > 0) myOccupied |= uInt32{1} << i;
   }
   catch(...)
   {
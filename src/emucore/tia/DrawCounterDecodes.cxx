@@ -29,6 +29,18 @@ const uInt8* const* DrawCounterDecodes::missileDecodes() const
   return myMissileDecodes;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const uInt8* const* DrawCounterDecodes::playerIdleClocks() const
+{
+  return myPlayerIdleClocks;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const uInt8* const* DrawCounterDecodes::missileIdleClocks() const
+{
+  return myMissileIdleClocks;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 DrawCounterDecodes& DrawCounterDecodes::DrawCounterDecodes::get()
 {
@@ -52,6 +64,21 @@ DrawCounterDecodes::DrawCounterDecodes()
   myDecodes4[60] = 1;
   myDecodes6[28] = myDecodes6[60] = 1;
 
+  uInt8 *idleTables[] = {myIdleClocks0, myIdleClocks1, myIdleClocks2, myIdleClocks3,
+                         myIdleClocks4, myIdleClocks6};
+
+  // Walk each table backwards twice, so that the distances wrap around
+  for (uInt32 t = 0; t < 6; ++t)
+  {
+    uInt8 clocks = 0;
+
+    for (uInt32 i = 2 * 160; i-- > 0;)
+    {
+      clocks = decodeTables[t][i % 160] ? 0 : clocks + 1;
+      idleTables[t][i % 160] = clocks;
+    }
+  }
+
   myPlayerDecodes[0] = myDecodes0;
   myPlayerDecodes[1] = myDecodes1;
   myPlayerDecodes[2] = myDecodes2;
@@ -69,6 +96,24 @@ DrawCounterDecodes::DrawCounterDecodes()
   myMissileDecodes[5] = myDecodes0;
   myMissileDecodes[6] = myDecodes6;
   myMissileDecodes[7] = myDecodes0;
+
+  myPlayerIdleClocks[0] = myIdleClocks0;
+  myPlayerIdleClocks[1] = myIdleClocks1;
+  myPlayerIdleClocks[2] = myIdleClocks2;
+  myPlayerIdleClocks[3] = myIdleClocks3;
+  myPlayerIdleClocks[4] = myIdleClocks4;
+  myPlayerIdleClocks[5] = myIdleClocks0;
+  myPlayerIdleClocks[6] = myIdleClocks6;
+  myPlayerIdleClocks[7] = myIdleClocks0;
+
+  myMissileIdleClocks[0] = myIdleClocks0;
+  myMissileIdleClocks[1] = myIdleClocks1;
+  myMissileIdleClocks[2] = myIdleClocks2;
+  myMissileIdleClocks[3] = myIdleClocks3;
+  myMissileIdleClocks[4] = myIdleClocks4;
+  myMissileIdleClocks[5] = myIdleClocks0;
+  myMissileIdleClocks[6] = myIdleClocks6;
+  myMissileIdleClocks[7] = myIdleClocks0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -28,6 +28,14 @@ class DrawCounterDecodes
 
     const uInt8* const* missileDecodes() const;
 
+    /**
+      For each decode table, the number of clocks from each counter value
+      until the next decode (0 if the value itself decodes).
+    */
+    const uInt8* const* playerIdleClocks() const;
+
+    const uInt8* const* missileIdleClocks() const;
+
     static DrawCounterDecodes& get();
 
   protected:
@@ -40,9 +48,16 @@ class DrawCounterDecodes
 
     uInt8* myMissileDecodes[8]{nullptr};
 
+    uInt8* myPlayerIdleClocks[8]{nullptr};
+
+    uInt8* myMissileIdleClocks[8]{nullptr};
+
     uInt8 myDecodes0[160], myDecodes1[160], myDecodes2[160], myDecodes3[160],
           myDecodes4[160], myDecodes6[160];
 
+    uInt8 myIdleClocks0[160], myIdleClocks1[160], myIdleClocks2[160],
+          myIdleClocks3[160], myIdleClocks4[160], myIdleClocks6[160];
+
     static DrawCounterDecodes myInstance;
 
   private:
@@ -29,6 +29,7 @@ Missile::Missile(uInt32 collisionMask)
 void Missile::reset()
 {
   myDecodes = DrawCounterDecodes::get().missileDecodes()[myDecodesOffset];
+  myIdleClocks = DrawCounterDecodes::get().missileIdleClocks()[myDecodesOffset];
   myIsEnabled = false;
   myEnam = false;
   myResmp = 0;
@@ -142,6 +143,7 @@ void Missile::nusiz(uInt8 value)
   myDecodesOffset = value & 0x07;
   myWidth = ourWidths[(value & 0x30) >> 4];
   myDecodes = DrawCounterDecodes::get().missileDecodes()[myDecodesOffset];
+  myIdleClocks = DrawCounterDecodes::get().missileIdleClocks()[myDecodesOffset];
 
   if (myIsRendering && myRenderCounter >= myWidth)
     myIsRendering = false;
@@ -310,6 +312,7 @@ bool Missile::load(Serializer& in)
 
     myDecodesOffset = in.getByte();
     myDecodes = DrawCounterDecodes::get().missileDecodes()[myDecodesOffset];
+    myIdleClocks = DrawCounterDecodes::get().missileIdleClocks()[myDecodesOffset];
 
     myColor = in.getByte();
     myObjectColor = in.getByte();  myDebugColor = in.getByte();
@@ -65,6 +65,9 @@ class Missile : public Serializable
     void toggleEnabled(bool enabled);
 
     bool isOn() const { return (collision & 0x8000); }
+    uInt32 collisionMask(bool on) const {
+      return on ? myCollisionMaskEnabled : myCollisionMaskDisabled;
+    }
     uInt8 getColor() const { return myColor; }
 
     uInt8 getPosition() const;
@@ -80,6 +83,26 @@ class Missile : public Serializable
 
     inline void tick(uInt8 hclock, bool isReceivingMclock = true);
 
+    /**
+      The number of upcoming clocks during which tick() would only advance the
+      counter, as the missile neither draws nor starts drawing.
+    */
+    uInt8 idleClocks() const {
+      if (myIsRendering || (myUseInvertedPhaseClock && myInvertedPhaseClock)) return 0;
+
+      // Locked to the player, the missile never starts drawing
+      return myResmp ? TIAConstants::H_PIXEL : myIdleClocks[myCounter];
+    }
+
+    /**
+      Advance by the given number (> 0) of idle clocks, see idleClocks().
+    */
+    void skip(uInt8 clocks) {
+      myIsVisible = false;
+      collision = myCollisionMaskDisabled;
+      myCounter = (myCounter + clocks) % TIAConstants::H_PIXEL;
+    }
+
   public:
 
     uInt32 collision{0};
@@ -117,6 +140,7 @@ class Missile : public Serializable
     Int8 myRenderCounter{0};
 
     const uInt8* myDecodes{nullptr};
+    const uInt8* myIdleClocks{nullptr};
     uInt8 myDecodesOffset{0};  // needed for state saving
 
     uInt8 myColor{0};
@@ -29,6 +29,7 @@ Player::Player(uInt32 collisionMask)
 void Player::reset()
 {
   myDecodes = DrawCounterDecodes::get().playerDecodes()[myDecodesOffset];
+  myIdleClocks = DrawCounterDecodes::get().playerIdleClocks()[myDecodesOffset];
   myHmmClocks = 0;
   myCounter = 0;
   isMoving = false;
@@ -92,6 +93,7 @@ void Player::nusiz(uInt8 value, bool hblank)
   const uInt8* oldDecodes = myDecodes;
 
   myDecodes = DrawCounterDecodes::get().playerDecodes()[myDecodesOffset];
+  myIdleClocks = DrawCounterDecodes::get().playerIdleClocks()[myDecodesOffset];
 
   if (
     myDecodes != oldDecodes &&
@@ -460,6 +462,7 @@ bool Player::load(Serializer& in)
 
     myDecodesOffset = in.getByte();
     myDecodes = DrawCounterDecodes::get().playerDecodes()[myDecodesOffset];
+    myIdleClocks = DrawCounterDecodes::get().playerIdleClocks()[myDecodesOffset];
 
     myPatternOld = in.getByte();
     myPatternNew = in.getByte();
@@ -67,6 +67,9 @@ class Player : public Serializable
     uInt8 getClock() const { return myCounter; }
 
     bool isOn() const { return (collision & 0x8000); }
+    uInt32 collisionMask(bool on) const {
+      return on ? myCollisionMaskEnabled : myCollisionMaskDisabled;
+    }
     uInt8 getColor() const { return myColor; }
 
     void shufflePatterns();
@@ -91,6 +94,23 @@ class Player : public Serializable
 
     inline void tick();
 
+    /**
+      The number of upcoming clocks during which tick() would only advance the
+      counter, as the player neither draws nor starts drawing.
+    */
+    uInt8 idleClocks() const {
+      return myIsRendering || (myUseInvertedPhaseClock && myInvertedPhaseClock)
+        ? 0 : myIdleClocks[myCounter];
+    }
+
+    /**
+      Advance by the given number (> 0) of idle clocks, see idleClocks().
+    */
+    void skip(uInt8 clocks) {
+      collision = myCollisionMaskDisabled;
+      myCounter = (myCounter + clocks) % TIAConstants::H_PIXEL;
+    }
+
   public:
 
     uInt32 collision{0};
@@ -131,6 +151,7 @@ class Player : public Serializable
     Int8 myDividerChangeCounter{-1};
 
     const uInt8* myDecodes{nullptr};
+    const uInt8* myIdleClocks{nullptr};
     uInt8 myDecodesOffset{0};  // needed for state saving
 
     uInt8 myPatternOld{0};
@@ -115,6 +115,13 @@ class Playfield : public Serializable
      */
     bool isOn() const { return (collision & 0x8000); }
 
+    /**
+      The collision mask while the playfield is visible resp. invisible.
+     */
+    uInt32 collisionMask(bool on) const {
+      return on ? myCollisionMaskEnabled : myCollisionMaskDisabled;
+    }
+
     /**
       Get the current color.
      */
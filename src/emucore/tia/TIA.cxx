@@ -26,6 +26,9 @@
 #include "AudioQueue.hxx"
 #include "DispatchResult.hxx"
 #include "Base.hxx"
+#include "FrameProfiler.hxx"
+#include "EventCounters.hxx"
+#include "MemoryUsage.hxx"
 
 enum CollisionMask: uInt32 {
   player0   = 0b0111110000000000,
@@ -63,6 +66,34 @@ enum ResxCounter: uInt8 {
 // 70, the G.I. Joe will show an artifact (hole in roof).
 static constexpr uInt8 resxLateHblankThreshold = TIAConstants::H_CYCLES - 3;
 
+// Object indices used by the span compositor. The first six double as bit
+// positions in the mask of objects that are on at the current pixel.
+enum SpanObject: uInt8 {
+  spanP0, spanM0, spanP1, spanM1, spanPF, spanBL, spanBK
+};
+
+// For any combination of active objects, the object that wins priority
+static constexpr std::array<uInt8, 64> priorityTable(std::array<uInt8, 6> order)
+{
+  std::array<uInt8, 64> table{};
+
+  for (uInt32 mask = 0; mask < 64; ++mask)
+  {
+    table[mask] = spanBK;
+    for (uInt32 i = 6; i-- > 0; )
+      if (mask & (1 << order[i])) table[mask] = order[i];
+  }
+
+  return table;
+}
+
+// Indexed by TIA::Priority; see renderPixel() for the orderings
+static constexpr std::array<std::array<uInt8, 64>, 3> spanPriority = {{
+  priorityTable({spanPF, spanBL, spanP0, spanM0, spanP1, spanM1}),  // pfp
+  priorityTable({spanP0, spanM0, spanPF, spanP1, spanM1, spanBL}),  // score
+  priorityTable({spanP0, spanM0, spanP1, spanM1, spanPF, spanBL})   // normal
+}};
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TIA::TIA(ConsoleIO& console, const ConsoleTimingProvider& timingProvider,
          Settings& settings)
@@ -107,6 +138,14 @@ void TIA::setFrameManager(AbstractFrameManager* frameManager)
   myFrameManager->setJitterFactor(myJitterFactor);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::setFrameManager(FrameManager* frameManager)
+{
+  setFrameManager(static_cast<AbstractFrameManager*>(frameManager));
+
+  myDisplayFrameManager = frameManager;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::setAudioQueue(const shared_ptr<AudioQueue>& queue)
 {
@@ -121,6 +160,7 @@ void TIA::clearFrameManager()
   myFrameManager->clearHandlers();
 
   myFrameManager = nullptr;
+  myDisplayFrameManager = nullptr;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -133,6 +173,7 @@ void TIA::initialize()
   myPriority = Priority::normal;
   myHstate = HState::blank;
   myCollisionMask = 0;
+  myCollisionCombinations = 0;
   myLinesSinceChange = 0;
   myCollisionUpdateRequired = myCollisionUpdateScheduled = false;
   myColorLossEnabled = myColorLossActive = false;
@@ -171,17 +212,18 @@ void TIA::initialize()
   if (myFrameManager)
     myFrameManager->reset();
 
-  myFrontBufferScanlines = myFrameBufferScanlines = 0;
-
   myFramesSinceLastRender = 0;
+  myFramesSinceDraw = 0;
+  myDrawFrame = true;
 
   // Blank the various framebuffers; they may contain graphical garbage
-  myBackBuffer.fill(0);
-  myFrontBuffer.fill(0);
-  myFramebuffer.fill(0);
+  clearFrameBuffer();
 
   applyDeveloperSettings();
 
+  setScheduler(mySettings.getString("tia.scheduler") == "clock"
+    ? Scheduler::clock : Scheduler::event);
+
   // Must be done last, after all other items have reset
   bool devSettings = mySettings.getBool("dev.settings");
   setFixedColorPalette(mySettings.getString("tia.dbgcolors"));
@@ -229,6 +271,16 @@ void TIA::installDelegate(System& system, Device& device)
   );
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::addMemoryUsage(MemoryUsage& usage) const
+{
+  usage.add(MemoryUsage::Category::tiaBuffers, sizeof(myFrontBuffers));
+#ifdef DEBUGGER_SUPPORT
+  usage.add(MemoryUsage::Category::accessArrays,
+            sizeof(myAccessBase) + sizeof(myAccessCounter) + sizeof(myAccessDelay));
+#endif
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool TIA::save(Serializer& out) const
 {
@@ -260,6 +312,7 @@ bool TIA::save(Serializer& out) const
 
     out.putBool(myCollisionUpdateRequired);
     out.putBool(myCollisionUpdateScheduled);
+    resolveCollisions();
     out.putInt(myCollisionMask);
 
     out.putInt(myMovementClock);
@@ -287,8 +340,8 @@ bool TIA::save(Serializer& out) const
     out.putLong(myFrameWsyncCycles);
   #endif
 
-    out.putInt(myFrameBufferScanlines);
-    out.putInt(myFrontBufferScanlines);
+    out.putInt(myFrontBuffers.readBuffer().scanlines);
+    out.putInt(myFrontBuffers.latestBuffer().scanlines);
 
     out.putByte(myPFBitsDelay);
     out.putByte(myPFColorDelay);
@@ -332,10 +385,14 @@ bool TIA::load(Serializer& in)
     myHctr = in.getInt();
     myHctrDelta = in.getInt();
     myXAtRenderingStart = in.getInt();
+    // Not saved, so the back buffer is kept as it is unless the frame is
+    // drawn from here on
+    myDrawnPixels = myUsedPixels;
 
     myCollisionUpdateRequired = in.getBool();
     myCollisionUpdateScheduled = in.getBool();
     myCollisionMask = in.getInt();
+    myCollisionCombinations = 0;
 
     myMovementClock = in.getInt();
     myMovementInProgress = in.getBool();
@@ -362,8 +419,8 @@ bool TIA::load(Serializer& in)
     myFrameWsyncCycles = in.getLong();
   #endif
 
-    myFrameBufferScanlines = in.getInt();
-    myFrontBufferScanlines = in.getInt();
+    myFrontBuffers.readBuffer().scanlines = in.getInt();
+    myFrontBuffers.restoreLatestBuffer().scanlines = in.getInt();
 
     myPFBitsDelay = in.getByte();
     myPFColorDelay = in.getByte();
@@ -513,6 +570,7 @@ bool TIA::poke(uInt16 address, uInt8 value)
   switch (address)
   {
     case WSYNC:
+      EventCounters::count(EventCounters::Event::wsync);
       mySystem->m6502().requestHalt();
       break;
 
@@ -523,6 +581,8 @@ bool TIA::poke(uInt16 address, uInt8 value)
       break;
 
     case VSYNC:
+      // Drawing may stop in the middle of the line
+      updateDrawnPixels();
       myFrameManager->setVsync(value & 0x02);
       myShadowRegisters[address] = value;
       break;
@@ -541,6 +601,7 @@ bool TIA::poke(uInt16 address, uInt8 value)
 
     case AUDV0:
     {
+      myAudio.flush();
       myAudio.channel0().audv(value);
       myShadowRegisters[address] = value;
     #ifdef DEBUGGER_SUPPORT
@@ -553,6 +614,7 @@ bool TIA::poke(uInt16 address, uInt8 value)
 
     case AUDV1:
     {
+      myAudio.flush();
       myAudio.channel1().audv(value);
       myShadowRegisters[address] = value;
     #ifdef DEBUGGER_SUPPORT
@@ -565,6 +627,7 @@ bool TIA::poke(uInt16 address, uInt8 value)
 
     case AUDF0:
     {
+      myAudio.flush();
       myAudio.channel0().audf(value);
       myShadowRegisters[address] = value;
     #ifdef DEBUGGER_SUPPORT
@@ -577,6 +640,7 @@ bool TIA::poke(uInt16 address, uInt8 value)
 
     case AUDF1:
     {
+      myAudio.flush();
       myAudio.channel1().audf(value);
       myShadowRegisters[address] = value;
     #ifdef DEBUGGER_SUPPORT
@@ -589,6 +653,7 @@ bool TIA::poke(uInt16 address, uInt8 value)
 
     case AUDC0:
     {
+      myAudio.flush();
       myAudio.channel0().audc(value);
       myShadowRegisters[address] = value;
     #ifdef DEBUGGER_SUPPORT
@@ -601,6 +666,7 @@ bool TIA::poke(uInt16 address, uInt8 value)
 
     case AUDC1:
     {
+      myAudio.flush();
       myAudio.channel1().audc(value);
       myShadowRegisters[address] = value;
     #ifdef DEBUGGER_SUPPORT
@@ -612,6 +678,7 @@ bool TIA::poke(uInt16 address, uInt8 value)
     }
 
     case HMOVE:
+      EventCounters::count(EventCounters::Event::hmove);
       myDelayQueue.push(HMOVE, value, Delay::hmove);
       break;
 
@@ -866,6 +933,7 @@ bool TIA::poke(uInt16 address, uInt8 value)
     case CXCLR:
       flushLineCache();
       myCollisionMask = 0;
+      myCollisionCombinations = 0;
       myShadowRegisters[address] = value;
       break;
 
@@ -881,9 +949,9 @@ bool TIA::saveDisplay(Serializer& out) const
 {
   try
   {
-    out.putByteArray(myFramebuffer.data(), myFramebuffer.size());
-    out.putByteArray(myBackBuffer.data(), myBackBuffer.size());
-    out.putByteArray(myFrontBuffer.data(), myFrontBuffer.size());
+    out.putByteArray(myFrontBuffers.readBuffer().pixels.data(), frameSize);
+    out.putByteArray(myBackBuffer, frameSize);
+    out.putByteArray(myFrontBuffers.latestBuffer().pixels.data(), frameSize);
     out.putInt(myFramesSinceLastRender);
   }
   catch(...)
@@ -901,10 +969,14 @@ bool TIA::loadDisplay(Serializer& in)
   try
   {
     // Reset frame buffer pointer and data
-    in.getByteArray(myFramebuffer.data(), myFramebuffer.size());
-    in.getByteArray(myBackBuffer.data(), myBackBuffer.size());
-    in.getByteArray(myFrontBuffer.data(), myFrontBuffer.size());
+    in.getByteArray(myFrontBuffers.readBuffer().pixels.data(), frameSize);
+    in.getByteArray(myBackBuffer, frameSize);
+    uInt8* latest = myFrontBuffers.restoreLatestBuffer().pixels.data();
+    in.getByteArray(latest, frameSize);
+    myLastFrame = latest;
     myFramesSinceLastRender = in.getInt();
+    // Any of the loaded pixels may be drawn
+    myUsedPixels = frameSize;
   }
   catch(...)
   {
@@ -970,26 +1042,34 @@ void TIA::update(DispatchResult& result, uInt64 maxCycles)
 {
   mySystem->m6502().execute(maxCycles, result);
 
-  updateEmulation();
+  synchronize();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::renderToFrameBuffer()
 {
-  if (myFramesSinceLastRender == 0) return;
-
-  myFramesSinceLastRender = 0;
-
-  myFramebuffer = myFrontBuffer;
+  if (myFramesSinceLastRender.exchange(0) == 0) return;
 
-  myFrameBufferScanlines = myFrontBufferScanlines;
+  myFrontBuffers.acquire();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::clearFrameBuffer()
 {
-  myFramebuffer.fill(0);
-  myFrontBuffer.fill(0);
+  myFrontBuffers.reset(Frame());
+  myBackBuffer = myFrontBuffers.writeBuffer().pixels.data();
+  myLastFrame = myFrontBuffers.latestBuffer().pixels.data();
+  myDrawnPixels = myUsedPixels = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8* TIA::outputBuffer()
+{
+  // Show the previous frame below the beam
+  updateDrawnPixels();
+  fillUndrawnPixels();
+
+  return myBackBuffer;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1105,6 +1185,8 @@ bool TIA::toggleCollision(TIABit b, uInt8 mode)
       break;
   }
 
+  // The pending combinations are evaluated with the current masks
+  resolveCollisions();
   myCollisionsEnabledBits = (myCollisionsEnabledBits & ~b) | mask;
 
   myMissile0.toggleCollisions(myCollisionsEnabledBits & TIABit::M0Bit);
@@ -1297,6 +1379,8 @@ uInt8 TIA::registerValue(uInt8 reg) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::updateEmulation()
 {
+  FrameProfiler::Scope profilerScope(FrameProfiler::Stage::tia);
+
   const uInt64 systemCycles = mySystem->cycles();
 
   if (mySubClock > TIAConstants::CYCLE_CLOCKS - 1)
@@ -1310,10 +1394,27 @@ void TIA::updateEmulation()
   cycle(cyclesToRun);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::synchronize()
+{
+  updateEmulation();
+  myAudio.flush();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::onFrameStart()
 {
   myXAtRenderingStart = 0;
+  myDrawnPixels = 0;
+
+  // Decide whether this frame is drawn
+  if (myRenderInterval > 0 && ++myFramesSinceDraw >= myRenderInterval)
+  {
+    myDrawFrame = true;
+    myFramesSinceDraw = 0;
+  }
+  else
+    myDrawFrame = false;
 #ifdef DEBUGGER_SUPPORT
   myFrameWsyncCycles = 0;
   mySystem->m6532().resetTimReadCylces();
@@ -1347,17 +1448,28 @@ void TIA::onFrameComplete()
   myCyclesAtFrameStart = mySystem->cycles();
 #endif
 
-  if (myXAtRenderingStart > 0)
-    std::fill_n(myBackBuffer.begin(), myXAtRenderingStart, 0);
+  // Skipped frames leave the front buffer untouched
+  if (myDrawFrame)
+  {
+    fillUndrawnPixels();
 
-  // Blank out any extra lines not drawn this frame
-  const Int32 missingScanlines = myFrameManager->missingScanlines();
-  if (missingScanlines > 0)
-    std::fill_n(myBackBuffer.begin() + TIAConstants::H_PIXEL * myFrameManager->getY(), missingScanlines * TIAConstants::H_PIXEL, 0);
+    if (myXAtRenderingStart > 0)
+      std::fill_n(myBackBuffer, myXAtRenderingStart, 0);
 
-  myFrontBuffer = myBackBuffer;
+    // Blank out any extra lines not drawn this frame
+    const Int32 missingScanlines = myFrameManager->missingScanlines();
+    if (missingScanlines > 0)
+      std::fill_n(myBackBuffer + TIAConstants::H_PIXEL * myFrameManager->getY(), missingScanlines * TIAConstants::H_PIXEL, 0);
 
-  myFrontBufferScanlines = scanlinesLastFrame();
+    myFrontBuffers.writeBuffer().scanlines = scanlinesLastFrame();
+    myFrontBuffers.publish();
+
+    // The published frame is only read by the consumer until the next one
+    // is published
+    myLastFrame = myBackBuffer;
+    myUsedPixels = std::max(myUsedPixels, myDrawnPixels);
+    myBackBuffer = myFrontBuffers.writeBuffer().pixels.data();
+  }
 
   ++myFramesSinceLastRender;
 }
@@ -1376,35 +1488,110 @@ void TIA::onHalt()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::cycle(uInt32 colorClocks)
 {
-  for (uInt32 i = 0; i < colorClocks; ++i)
+  if (myScheduler == Scheduler::clock)
   {
-    myDelayQueue.execute(
-      [this] (uInt8 address, uInt8 value) {delayedWrite(address, value);}
-    );
-
-    myCollisionUpdateRequired = myCollisionUpdateScheduled;
-    myCollisionUpdateScheduled = false;
+    for (; colorClocks > 0; --colorClocks)
+      cycleClock();
 
-    if (myLinesSinceChange < 2) {
-      tickMovement();
+    return;
+  }
 
-      if (myHstate == HState::blank)
-        tickHblank();
-      else
-        tickHframe();
+  while (colorClocks > 0)
+  {
+    const uInt32 clocks = quietClocks(colorClocks);
 
-      if (myCollisionUpdateRequired && !myFrameManager->vblank()) updateCollision();
+    if (clocks > 0)
+    {
+      cycleSpan(clocks);
+      colorClocks -= clocks;
     }
+    else
+    {
+      cycleClock();
+      --colorClocks;
+    }
+  }
+}
 
-    if (++myHctr >= TIAConstants::H_CLOCKS)
-      nextLine();
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::cycleClock()
+{
+  myDelayQueue.execute(
+    [this] (uInt8 address, uInt8 value) {delayedWrite(address, value);}
+  );
 
-    #ifdef SOUND_SUPPORT
-      myAudio.tick();
-    #endif
+  myCollisionUpdateRequired = myCollisionUpdateScheduled;
+  myCollisionUpdateScheduled = false;
+
+  if (myLinesSinceChange < 2) {
+    tickMovement();
+
+    if (myHstate == HState::blank)
+      tickHblank();
+    else
+      tickHframe();
 
-    ++myTimestamp;
+    if (myCollisionUpdateRequired && !myFrameManager->vblank()) updateCollision();
   }
+
+  if (++myHctr >= TIAConstants::H_CLOCKS)
+    nextLine();
+
+  #ifdef SOUND_SUPPORT
+    myAudio.tick();
+  #endif
+
+  ++myTimestamp;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 TIA::quietClocks(uInt32 maxClocks) const
+{
+  // Pending collision updates need the full per-clock treatment
+  if (myCollisionUpdateScheduled) return 0;
+
+  // During HMOVE, the movement logic acts on every fourth clock only
+  const uInt32 movementClocks = myMovementInProgress
+    ? (TIAConstants::H_CLOCKS - myHctr) & 0x03
+    : TIAConstants::H_CLOCKS;
+
+  // Stop at the next delayed write and at the end of the line
+  return std::min({
+    maxClocks,
+    movementClocks,
+    uInt32(TIAConstants::H_CLOCKS - myHctr),
+    myDelayQueue.idleClocks()
+  });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::cycleSpan(uInt32 colorClocks)
+{
+  myDelayQueue.skip(colorClocks);
+
+  // Nothing is scheduled, so only the visible part of the line requires
+  // collision updates
+  myCollisionUpdateRequired = false;
+
+  if (myLinesSinceChange < 2) {
+    uInt32 clocks = colorClocks;
+
+    for (; clocks > 0 && myHstate == HState::blank; --clocks, ++myHctr)
+      tickHblank();
+
+    if (clocks > 0) tickHframeSpan(clocks);
+  }
+  else
+    myHctr += colorClocks;
+
+  if (myHctr >= TIAConstants::H_CLOCKS)
+    nextLine();
+
+  #ifdef SOUND_SUPPORT
+    myAudio.tick(colorClocks);
+  #endif
+
+  myTimestamp += colorClocks;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1455,10 +1642,16 @@ void TIA::tickHblank()
   if (myExtendedHblank && myHctr > TIAConstants::H_BLANK_CLOCKS - 1) myPlayfield.tick(myHctr - TIAConstants::H_BLANK_CLOCKS - myHctrDelta);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline uInt32 TIA::frameY() const
+{
+  return myDisplayFrameManager ? myDisplayFrameManager->getY() : myFrameManager->getY();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::tickHframe()
 {
-  const uInt32 y = myFrameManager->getY();
+  const uInt32 y = frameY();
   const uInt32 x = myHctr - TIAConstants::H_BLANK_CLOCKS - myHctrDelta;
 
   myCollisionUpdateRequired = true;
@@ -1470,18 +1663,93 @@ void TIA::tickHframe()
   myPlayer1.tick();
   myBall.tick();
 
-  if (myFrameManager->isRendering())
+  if (isDrawing())
     renderPixel(x, y);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::tickHframeSpan(uInt32 colorClocks)
+{
+  // Beam row, rendering and vblank state as well as the object colors can
+  // only change with a write or at the end of the line, so they are constant
+  // for the whole span
+  const uInt32 row = frameY() * TIAConstants::H_PIXEL;
+  const bool rendering = isDrawing();
+  const bool vblank = myFrameManager->vblank();
+  const auto& priority = spanPriority[static_cast<uInt32>(myPriority)];
+  const std::array<uInt8, 7> colors = {
+    myPlayer0.getColor(), myMissile0.getColor(),
+    myPlayer1.getColor(), myMissile1.getColor(),
+    0, myBall.getColor(), myBackground.getColor()
+  };
+  uInt32 x = myHctr - TIAConstants::H_BLANK_CLOCKS - myHctrDelta;
+  uInt64 combinations = 0;
+
+  while (colorClocks > 0)
+  {
+    // Objects which neither draw nor start drawing during the next clocks are
+    // advanced in one step, and only the others are ticked on every clock. The
+    // chunk ends with the first idle object starting to draw.
+    const bool activeM0 = myMissile0.idleClocks() == 0;
+    const bool activeM1 = myMissile1.idleClocks() == 0;
+    const bool activeP0 = myPlayer0.idleClocks() == 0;
+    const bool activeP1 = myPlayer1.idleClocks() == 0;
+    const bool activeBL = myBall.idleClocks() == 0;
+    uInt32 chunk = colorClocks;
+
+    if (!activeM0) chunk = std::min<uInt32>(chunk, myMissile0.idleClocks());
+    if (!activeM1) chunk = std::min<uInt32>(chunk, myMissile1.idleClocks());
+    if (!activeP0) chunk = std::min<uInt32>(chunk, myPlayer0.idleClocks());
+    if (!activeP1) chunk = std::min<uInt32>(chunk, myPlayer1.idleClocks());
+    if (!activeBL) chunk = std::min<uInt32>(chunk, myBall.idleClocks());
+
+    if (!activeM0) myMissile0.skip(chunk);
+    if (!activeM1) myMissile1.skip(chunk);
+    if (!activeP0) myPlayer0.skip(chunk);
+    if (!activeP1) myPlayer1.skip(chunk);
+    if (!activeBL) myBall.skip(chunk);
+
+    for (colorClocks -= chunk; chunk > 0; --chunk, ++x, ++myHctr)
+    {
+      myPlayfield.tick(x);
+      if (activeM0) myMissile0.tick(myHctr);
+      if (activeM1) myMissile1.tick(myHctr);
+      if (activeP0) myPlayer0.tick();
+      if (activeP1) myPlayer1.tick();
+      if (activeBL) myBall.tick();
+
+      if (vblank)
+      {
+        if (rendering && x < TIAConstants::H_PIXEL) myBackBuffer[row + x] = 0;
+        continue;
+      }
+
+      // The objects which are on select the color, and their combination
+      // is all the collision latches need
+      const uInt32 objects = objectsOn();
+      combinations |= uInt64(1) << objects;
+
+      if (rendering && x < TIAConstants::H_PIXEL)
+      {
+        const uInt8 object = priority[objects];
+
+        myBackBuffer[row + x] = object == spanPF ? myPlayfield.getColor() : colors[object];
+      }
+    }
+  }
+
+  myCollisionCombinations |= combinations;
+  myCollisionUpdateRequired = true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::applyRsync()
 {
   const uInt32 x = myHctr > TIAConstants::H_BLANK_CLOCKS ? myHctr - TIAConstants::H_BLANK_CLOCKS : 0;
 
   myHctrDelta = TIAConstants::H_CLOCKS - 3 - myHctr;
-  if (myFrameManager->isRendering())
-    std::fill_n(myBackBuffer.begin() + myFrameManager->getY() * TIAConstants::H_PIXEL + x, TIAConstants::H_PIXEL - x, 0);
+  if (isDrawing())
+    std::fill_n(myBackBuffer + myFrameManager->getY() * TIAConstants::H_PIXEL + x, TIAConstants::H_PIXEL - x, 0);
 
   myHctr = TIAConstants::H_CLOCKS - 3;
 }
@@ -1493,6 +1761,10 @@ void TIA::nextLine()
     cloneLastLine();
   }
 
+  // The line is complete
+  if (isDrawing())
+    myDrawnPixels = std::min((frameY() + 1) * TIAConstants::H_PIXEL, frameSize);
+
   myHctr = 0;
 
   if (!myMovementInProgress && myLinesSinceChange < 2) ++myLinesSinceChange;
@@ -1500,7 +1772,10 @@ void TIA::nextLine()
   myHstate = HState::blank;
   myHctrDelta = 0;
 
-  myFrameManager->nextLine();
+  if (myDisplayFrameManager)
+    myDisplayFrameManager->nextLineDirect();
+  else
+    myFrameManager->nextLine();
   myMissile0.nextLine();
   myMissile1.nextLine();
   myPlayer0.nextLine();
@@ -1508,20 +1783,40 @@ void TIA::nextLine()
   myBall.nextLine();
   myPlayfield.nextLine();
 
-  if (myFrameManager->isRendering() && myFrameManager->getY() == 0) flushLineCache();
+  if (myFrameManager->isRendering() && frameY() == 0) flushLineCache();
 
   mySystem->m6502().clearHaltRequest();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::updateDrawnPixels()
+{
+  uInt32 x, y;
+
+  if (myDrawFrame && electronBeamPos(x, y))
+    myDrawnPixels = std::min(y * TIAConstants::H_PIXEL + std::min<uInt32>(x, TIAConstants::H_PIXEL), frameSize);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::fillUndrawnPixels()
+{
+  // The back buffer is recycled from an older frame, so the pixels not drawn
+  // in the current frame are taken from the previous one.  Beyond
+  // myUsedPixels, all frames are blank.
+  if (myDrawnPixels < myUsedPixels)
+    std::copy(myLastFrame + myDrawnPixels, myLastFrame + myUsedPixels,
+              myBackBuffer + myDrawnPixels);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::cloneLastLine()
 {
-  const auto y = myFrameManager->getY();
+  const auto y = frameY();
 
-  if (!myFrameManager->isRendering() || y == 0) return;
+  if (!isDrawing() || y == 0) return;
 
-  std::copy_n(myBackBuffer.begin() + (y-1) * TIAConstants::H_PIXEL, TIAConstants::H_PIXEL,
-      myBackBuffer.begin() + y * TIAConstants::H_PIXEL);
+  std::copy_n(myBackBuffer + (y-1) * TIAConstants::H_PIXEL, TIAConstants::H_PIXEL,
+      myBackBuffer + y * TIAConstants::H_PIXEL);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1533,14 +1828,27 @@ void TIA::scheduleCollisionUpdate()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::updateCollision()
 {
-  myCollisionMask |= (
-    myPlayer0.collision &
-    myPlayer1.collision &
-    myMissile0.collision &
-    myMissile1.collision &
-    myBall.collision &
-    myPlayfield.collision
-  );
+  myCollisionCombinations |= uInt64(1) << objectsOn();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::resolveCollisions() const
+{
+  // Every combination of objects which were on at the same time latches
+  // the collisions among them
+  uInt64 combinations = myCollisionCombinations;
+
+  for (uInt32 objects = 0; combinations; ++objects, combinations >>= 1)
+    if (combinations & 1)
+      myCollisionMask |=
+        myPlayer0.collisionMask(objects & 0x01) &
+        myMissile0.collisionMask(objects & 0x02) &
+        myPlayer1.collisionMask(objects & 0x04) &
+        myMissile1.collisionMask(objects & 0x08) &
+        myPlayfield.collisionMask(objects & 0x10) &
+        myBall.collisionMask(objects & 0x20);
+
+  myCollisionCombinations = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1623,8 +1931,8 @@ void TIA::flushLineCache()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::clearHmoveComb()
 {
-  if (myFrameManager->isRendering() && myHstate == HState::blank)
-    std::fill_n(myBackBuffer.begin() + myFrameManager->getY() * TIAConstants::H_PIXEL, 8, myColorHBlank);
+  if (isDrawing() && myHstate == HState::blank)
+    std::fill_n(myBackBuffer + myFrameManager->getY() * TIAConstants::H_PIXEL, 8, myColorHBlank);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1845,6 +2153,8 @@ uInt8 TIA::resxCounter()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 TIA::collCXM0P() const
 {
+  resolveCollisions();
+
   return (
     ((myCollisionMask & CollisionMask::missile0 & CollisionMask::player0) ? 0x40 : 0) |
     ((myCollisionMask & CollisionMask::missile0 & CollisionMask::player1) ? 0x80 : 0)
@@ -1854,6 +2164,8 @@ uInt8 TIA::collCXM0P() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 TIA::collCXM1P() const
 {
+  resolveCollisions();
+
   return (
     ((myCollisionMask & CollisionMask::missile1 & CollisionMask::player1) ? 0x40 : 0) |
     ((myCollisionMask & CollisionMask::missile1 & CollisionMask::player0) ? 0x80 : 0)
@@ -1863,6 +2175,8 @@ uInt8 TIA::collCXM1P() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 TIA::collCXP0FB() const
 {
+  resolveCollisions();
+
   return (
     ((myCollisionMask & CollisionMask::player0 & CollisionMask::ball) ? 0x40 : 0) |
     ((myCollisionMask & CollisionMask::player0 & CollisionMask::playfield) ? 0x80 : 0)
@@ -1872,6 +2186,8 @@ uInt8 TIA::collCXP0FB() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 TIA::collCXP1FB() const
 {
+  resolveCollisions();
+
   return (
     ((myCollisionMask & CollisionMask::player1 & CollisionMask::ball) ? 0x40 : 0) |
     ((myCollisionMask & CollisionMask::player1 & CollisionMask::playfield) ? 0x80 : 0)
@@ -1881,6 +2197,8 @@ uInt8 TIA::collCXP1FB() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 TIA::collCXM0FB() const
 {
+  resolveCollisions();
+
   return (
     ((myCollisionMask & CollisionMask::missile0 & CollisionMask::ball) ? 0x40 : 0) |
     ((myCollisionMask & CollisionMask::missile0 & CollisionMask::playfield) ? 0x80 : 0)
@@ -1890,6 +2208,8 @@ uInt8 TIA::collCXM0FB() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 TIA::collCXM1FB() const
 {
+  resolveCollisions();
+
   return (
     ((myCollisionMask & CollisionMask::missile1 & CollisionMask::ball) ? 0x40 : 0) |
     ((myCollisionMask & CollisionMask::missile1 & CollisionMask::playfield) ? 0x80 : 0)
@@ -1899,6 +2219,8 @@ uInt8 TIA::collCXM1FB() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 TIA::collCXPPMM() const
 {
+  resolveCollisions();
+
   return (
     ((myCollisionMask & CollisionMask::missile0 & CollisionMask::missile1) ? 0x40 : 0) |
     ((myCollisionMask & CollisionMask::player0 & CollisionMask::player1) ? 0x80 : 0)
@@ -1908,96 +2230,113 @@ uInt8 TIA::collCXPPMM() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 TIA::collCXBLPF() const
 {
+  resolveCollisions();
+
   return (myCollisionMask & CollisionMask::ball & CollisionMask::playfield) ? 0x80 : 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollP0PF()
 {
+  resolveCollisions();
   myCollisionMask ^= (CollisionMask::player0 & CollisionMask::playfield);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollP0BL()
 {
+  resolveCollisions();
   myCollisionMask ^= (CollisionMask::player0 & CollisionMask::ball);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollP0M1()
 {
+  resolveCollisions();
   myCollisionMask ^= (CollisionMask::player0 & CollisionMask::missile1);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollP0M0()
 {
+  resolveCollisions();
   myCollisionMask ^= (CollisionMask::player0 & CollisionMask::missile0);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollP0P1()
 {
+  resolveCollisions();
   myCollisionMask ^= (CollisionMask::player0 & CollisionMask::player1);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollP1PF()
 {
+  resolveCollisions();
   myCollisionMask ^= (CollisionMask::player1 & CollisionMask::playfield);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollP1BL()
 {
+  resolveCollisions();
   myCollisionMask ^= (CollisionMask::player1 & CollisionMask::ball);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollP1M1()
 {
+  resolveCollisions();
   myCollisionMask ^= (CollisionMask::player1 & CollisionMask::missile1);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollP1M0()
 {
+  resolveCollisions();
   myCollisionMask ^= (CollisionMask::player1 & CollisionMask::missile0);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollM0PF()
 {
+  resolveCollisions();
   myCollisionMask ^= (CollisionMask::missile0 & CollisionMask::playfield);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollM0BL()
 {
+  resolveCollisions();
   myCollisionMask ^= (CollisionMask::missile0 & CollisionMask::ball);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollM0M1()
 {
+  resolveCollisions();
   myCollisionMask ^= (CollisionMask::missile0 & CollisionMask::missile1);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollM1PF()
 {
+  resolveCollisions();
   myCollisionMask ^= (CollisionMask::missile1 & CollisionMask::playfield);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollM1BL()
 {
+  resolveCollisions();
   myCollisionMask ^= (CollisionMask::missile1 & CollisionMask::ball);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::toggleCollBLPF()
 {
+  resolveCollisions();
   myCollisionMask ^= (CollisionMask::ball & CollisionMask::playfield);
 }
 
@@ -19,6 +19,7 @@
 #define TIA_TIA
 
 #include <functional>
+#include <atomic>
 
 #include "bspf.hxx"
 #include "ConsoleIO.hxx"
@@ -38,12 +39,15 @@
 #include "Player.hxx"
 #include "Ball.hxx"
 #include "LatchedInput.hxx"
+#include "TripleBuffer.hxx"
 #include "AnalogReadout.hxx"
 #include "DelayQueueIterator.hxx"
 #include "Control.hxx"
 #include "System.hxx"
 
 class AudioQueue;
+class FrameManager;
+class MemoryUsage;
 class DispatchResult;
 
 /**
@@ -125,12 +129,38 @@ class TIA : public Device
      */
     void setFrameManager(AbstractFrameManager* frameManager);
 
+    /**
+      Configure the frame manager used for display.  Scanlines are advanced
+      through it directly, without the virtual dispatch.
+     */
+    void setFrameManager(FrameManager* frameManager);
+
     /**
       Set the audio queue. This needs to be dynamic as the queue is created after
       the timing has been determined.
     */
     void setAudioQueue(const shared_ptr<AudioQueue>& audioQueue);
 
+    /**
+      The audio queue fed by the TIA (if any).
+    */
+    const AudioQueue* audioQueue() const { return myAudio.audioQueue(); }
+
+    /**
+      Set an additional source of samples (see Audio::setAudioSource).
+    */
+    void setAudioSource(AudioSource* source) { myAudio.setAudioSource(source); }
+
+    /**
+      Set a receiver for the audio output (see Audio::setAudioSink).
+    */
+    void setAudioSink(AudioSink* sink) { myAudio.setAudioSink(sink); }
+
+    /**
+      Enable or disable audio output (see Audio::enableOutput).
+    */
+    void enableAudioOutput(bool enabled) { myAudio.enableOutput(enabled); }
+
     /**
       Clear the configured frame manager and deteach the lifecycle callbacks.
      */
@@ -204,6 +234,14 @@ class TIA : public Device
     bool saveDisplay(Serializer& out) const;
     bool loadDisplay(Serializer& in);
 
+    /**
+      Answer the last completed frame (color indices, H_PIXEL wide) within
+      the given data, which must end with the data written by saveDisplay().
+    */
+    static const uInt8* savedFrame(const uInt8* data, size_t size) {
+      return data + size - sizeof(uInt32) - frameSize;
+    }
+
     /**
       This method should be called at an interval corresponding to the
       desired frame rate to update the TIA.  Invoking this method will update
@@ -214,7 +252,9 @@ class TIA : public Device
     void update(uInt64 maxCycles = 50000);
 
     /**
-      Did we generate a new frame?
+      Did we generate a new frame? The pending frame is handed over to the
+      renderer without locking, so this and the methods below may be called
+      while emulation is running on another thread.
      */
     bool newFramePending() { return myFramesSinceLastRender  > 0; }
 
@@ -233,16 +273,39 @@ class TIA : public Device
      */
     void renderToFrameBuffer();
 
+    /**
+      Draw only every nth frame into the framebuffer; an interval of 0 turns
+      drawing off completely. Skipped frames are emulated exactly (beam
+      position, collisions and frame management are unaffected), only the
+      pixel output is dropped. Takes effect with the next frame.
+     */
+    void setRenderInterval(uInt32 interval) { myRenderInterval = interval; }
+    uInt32 renderInterval() const { return myRenderInterval; }
+
+    /**
+      How the color clocks are executed. 'event' jumps from one clock at which
+      some part of the TIA has to act (a delayed write, an object starting to
+      draw, a movement or audio clock, the end of the line) to the next, and
+      draws the pixels in between as a span. 'clock' runs every color clock
+      through the full logic; it is much slower and serves as the reference
+      the event scheduler must match exactly.
+     */
+    enum class Scheduler: uInt8 { clock, event };
+
+    void setScheduler(Scheduler scheduler) { myScheduler = scheduler; }
+    Scheduler scheduler() const { return myScheduler; }
+
     /**
       Return the buffer that holds the currently drawing TIA frame
-      (the TIA output widget needs this).
+      (the TIA output widget needs this).  The part which hasn't been
+      drawn yet holds the previous frame.
      */
-    uInt8* outputBuffer() { return myBackBuffer.data(); }
+    uInt8* outputBuffer();
 
     /**
       Returns a pointer to the internal frame buffer.
     */
-    uInt8* frameBuffer() { return myFramebuffer.data(); }
+    uInt8* frameBuffer() { return myFrontBuffers.readBuffer().pixels.data(); }
 
     void clearFrameBuffer();
 
@@ -315,7 +378,7 @@ class TIA : public Device
     /**
       The same, but for the frame in the frame buffer.
      */
-    uInt32 frameBufferScanlinesLastFrame() const { return myFrameBufferScanlines; }
+    uInt32 frameBufferScanlinesLastFrame() const { return myFrontBuffers.readBuffer().scanlines; }
 
     /**
       Answers the total system cycles from the start of the emulation.
@@ -555,6 +618,19 @@ class TIA : public Device
      */
     void updateEmulation();
 
+    /**
+     * Same as updateEmulation(), but also render all pending audio samples,
+     * which are otherwise only generated on writes to the audio registers.
+     * Any state handed out (samples, save states) requires this.
+     */
+    void synchronize();
+
+    /**
+      Add the memory held by the frame buffers (and the access arrays) to
+      the given usage.
+    */
+    void addMemoryUsage(MemoryUsage& usage) const;
+
   #ifdef DEBUGGER_SUPPORT
     /**
       Query the access counters
@@ -607,10 +683,31 @@ class TIA : public Device
     void onHalt();
 
     /**
-     * Execute colorClocks cycles of TIA simulation.
+     * Execute colorClocks cycles of TIA simulation, using the selected
+     * scheduler.
      */
     void cycle(uInt32 colorClocks);
 
+    /**
+     * Execute a single color clock, processing pending writes, movement and
+     * collision updates.
+     */
+    void cycleClock();
+
+    /**
+     * The number of upcoming color clocks (at most maxClocks) during which no
+     * TIA state changes except for the regular beam, object and audio
+     * progression. Writes, collision updates and the movement clocks of an
+     * HMOVE end a span. These clocks can be processed as a span by cycleSpan().
+     */
+    uInt32 quietClocks(uInt32 maxClocks) const;
+
+    /**
+     * Execute a span of quiet color clocks (see quietClocks()). The span
+     * must not extend past the end of the current scanline.
+     */
+    void cycleSpan(uInt32 colorClocks);
+
     /**
      * Advance the movement logic by a single clock.
      */
@@ -627,10 +724,35 @@ class TIA : public Device
     void tickHframe();
 
     /**
-     * Update the collision bitfield.
+     * Advance several clocks during the visible part of the scanline, with no
+     * writes, movement or line end in between.
+     */
+    void tickHframeSpan(uInt32 colorClocks);
+
+    /**
+     * Record the objects which are currently on for the collision latches.
      */
     void updateCollision();
 
+    /**
+     * The objects which are currently on, one bit per object (in the order
+     * P0, M0, P1, M1, PF, BL).
+     */
+    uInt32 objectsOn() const {
+      return
+        ((myPlayer0.collision  >> 15) & 0x01) |
+        ((myMissile0.collision >> 14) & 0x02) |
+        ((myPlayer1.collision  >> 13) & 0x04) |
+        ((myMissile1.collision >> 12) & 0x08) |
+        ((myPlayfield.collision >> 11) & 0x10) |
+        ((myBall.collision     >> 10) & 0x20);
+    }
+
+    /**
+     * Fold the recorded object combinations into the collision latches.
+     */
+    void resolveCollisions() const;
+
     /**
      * Execute a RSYNC.
      */
@@ -652,11 +774,34 @@ class TIA : public Device
      */
     void nextLine();
 
+    /**
+     * Are we drawing the current line into the back buffer? False if the
+     * frame manager is not rendering or the frame is skipped.
+     */
+    bool isDrawing() const { return myDrawFrame && myFrameManager->isRendering(); }
+
+    /**
+     * Update the part of the back buffer drawn in the current frame to the
+     * beam position, if the frame is being drawn.
+     */
+    void updateDrawnPixels();
+
+    /**
+     * Copy the pixels not drawn in the current frame from the previous one.
+     */
+    void fillUndrawnPixels();
+
     /**
      * Clone the last line. Called in nextLine if TIA state was unchanged.
      */
     void cloneLastLine();
 
+    /**
+     * The current y coordinate of the frame manager, bound statically if it
+     * is the display frame manager.
+     */
+    uInt32 frameY() const;
+
     /**
      * Execute a delayed write. Called when the DelayQueue is pumped.
      */
@@ -780,6 +925,13 @@ class TIA : public Device
      */
     AbstractFrameManager* myFrameManager{nullptr};
 
+    /**
+     * The same frame manager if it was set as a FrameManager (i.e. not the
+     * layout detector). Per scanline calls go through this pointer and avoid
+     * the virtual dispatch.
+     */
+    FrameManager* myDisplayFrameManager{nullptr};
+
     /**
      * The various TIA objects.
      */
@@ -804,20 +956,32 @@ class TIA : public Device
     LatchedInput myInput0;
     LatchedInput myInput1;
 
-    // Pointer to the internal color-index-based frame buffer
-    std::array<uInt8, TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight> myFramebuffer;
+    // The frame is rendered directly into the write buffer of myFrontBuffers,
+    // so completing a frame only swaps buffers
+    uInt8* myBackBuffer{nullptr};
+
+    // The frame published last, which provides the pixels not drawn in the
+    // current frame
+    const uInt8* myLastFrame{nullptr};
 
-    // The frame is rendered to the backbuffer and only copied to the framebuffer
-    // upon completion
-    std::array<uInt8, TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight> myBackBuffer;
-    std::array<uInt8, TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight> myFrontBuffer;
+    // The part of the back buffer drawn in the current frame so far
+    uInt32 myDrawnPixels{0};
 
-    // We snapshot frame statistics when the back buffer is copied to the front buffer
-    // and when the front buffer is copied to the frame buffer
-    uInt32 myFrontBufferScanlines{0}, myFrameBufferScanlines{0};
+    // The part of the frame buffers ever drawn; the rest is blank in all
+    uInt32 myUsedPixels{0};
 
     // Frames since the last time a frame was rendered to the render buffer
-    uInt32 myFramesSinceLastRender{0};
+    std::atomic<uInt32> myFramesSinceLastRender{0};
+
+    /**
+     * Frame skipping, see setRenderInterval(). Whether the current frame is
+     * drawn is decided at frame start.
+     */
+    uInt32 myRenderInterval{1};
+    uInt32 myFramesSinceDraw{0};
+    bool myDrawFrame{true};
+
+    Scheduler myScheduler{Scheduler::event};
 
     /**
      * Setting this to true injects random values into undefined reads.
@@ -858,8 +1022,16 @@ class TIA : public Device
 
     /**
      * The collision latches are represented by 15 bits in a bitfield.
+     * It is only brought up to date by resolveCollisions() when the latches
+     * are read.
+     */
+    mutable uInt32 myCollisionMask{0};
+
+    /**
+     * The combinations of objects (see objectsOn()) which have been on at
+     * the same time since the latches were resolved, one bit each.
      */
-    uInt32 myCollisionMask{0};
+    mutable uInt64 myCollisionCombinations{0};
 
     /**
      * The movement clock counts the extra ticks sent to the objects during
@@ -961,6 +1133,21 @@ class TIA : public Device
     bool myEnableJitter{false};
     uInt8 myJitterFactor{0};
 
+    // A completed frame (color indices) and its scanline count
+    struct Frame {
+      std::array<uInt8, TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight> pixels{};
+      uInt32 scanlines{0};
+    };
+
+    static constexpr uInt32 frameSize =
+      TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight;
+
+    // Completed frames are published by the emulation and picked up by the
+    // renderer; the read buffer is the internal frame buffer.  These are
+    // large, and kept behind the per clock state above, so that state stays
+    // within a few cache lines
+    Common::TripleBuffer<Frame> myFrontBuffers;
+
     static constexpr uInt16
       TIA_SIZE = 0x40, TIA_MASK = TIA_SIZE - 1,
       TIA_READ_SIZE = 0x10, TIA_READ_MASK = TIA_READ_SIZE - 1,
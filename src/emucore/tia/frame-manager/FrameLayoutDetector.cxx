@@ -33,7 +33,11 @@ enum Metrics: uInt32 {
   tvModeDetectionTolerance  = 20,
 
   // these frames will not be considered for detection
-  initialGarbageFrames      = TIAConstants::initialGarbageFrames
+  initialGarbageFrames      = TIAConstants::initialGarbageFrames,
+
+  // number of consecutive frames within a tolerance window after which the
+  // detected layout is considered stable
+  stableFrames              = 10
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -42,6 +46,13 @@ FrameLayout FrameLayoutDetector::detectedLayout() const{
   return myPalFrames > myNtscFrames ? FrameLayout::pal : FrameLayout::ntsc;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FrameLayoutDetector::layoutStable() const
+{
+  // The recent frames must agree with the majority of all frames
+  return myStableFrames >= Metrics::stableFrames && detectedLayout() == layout();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 FrameLayoutDetector::FrameLayoutDetector()
 {
@@ -54,6 +65,7 @@ void FrameLayoutDetector::onReset()
   myState = State::waitForVsyncStart;
   myNtscFrames = myPalFrames = 0;
   myLinesWaitingForVsyncToStart = 0;
+  myStableFrames = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -126,8 +138,11 @@ void FrameLayoutDetector::finalizeFrame()
     deltaNTSC = abs(Int32(myCurrentFrameFinalLines) - Int32(frameLinesNTSC)),
     deltaPAL =  abs(Int32(myCurrentFrameFinalLines) - Int32(frameLinesPAL));
 
+  const bool inWindow = std::min(deltaNTSC, deltaPAL) <= Metrics::tvModeDetectionTolerance;
+  const FrameLayout previousLayout = layout();
+
   // Does the scanline count fall into one of our tolerance windows? -> use it
-  if (std::min(deltaNTSC, deltaPAL) <= Metrics::tvModeDetectionTolerance)
+  if (inWindow)
     layout(deltaNTSC <= deltaPAL ? FrameLayout::ntsc : FrameLayout::pal);
   else if (
   // If scanline count is odd and lies between the PAL and NTSC windows we assume
@@ -141,6 +156,14 @@ void FrameLayoutDetector::finalizeFrame()
   // Take the nearest layout if all else fails
     layout(deltaNTSC <= deltaPAL ? FrameLayout::ntsc : FrameLayout::pal);
 
+  // Count the consecutive frames which clearly match the same layout
+  if (!inWindow)
+    myStableFrames = 0;
+  else if (layout() == previousLayout)
+    ++myStableFrames;
+  else
+    myStableFrames = 1;
+
   switch (layout()) {
     case FrameLayout::ntsc:
       ++myNtscFrames;
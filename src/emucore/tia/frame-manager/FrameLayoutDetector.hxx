@@ -37,6 +37,13 @@ class FrameLayoutDetector: public AbstractFrameManager {
      */
     FrameLayout detectedLayout() const;
 
+    /**
+     * Check whether the detection has become confident about the layout,
+     * i.e. the last frames were all clearly frames of the detected layout.
+     * Detection can be finished early if this is the case.
+     */
+    bool layoutStable() const;
+
   protected:
 
     /**
@@ -98,6 +105,12 @@ class FrameLayoutDetector: public AbstractFrameManager {
      */
     uInt32 myLinesWaitingForVsyncToStart{0};
 
+    /**
+     * The number of consecutive frames whose scanline count fell into the
+     * tolerance window of the current frame layout.
+     */
+    uInt32 myStableFrames{0};
+
   private:
 
     FrameLayoutDetector(const FrameLayoutDetector&) = delete;
@@ -113,6 +113,14 @@ void FrameManager::setAdjustVSize(Int32 adjustVSize)
   recalculateMetrics();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameManager::enableJitter(bool enabled)
+{
+  if (enabled && !myJitterEnabled) myJitterEmulation.reset();
+
+  myJitterEnabled = enabled;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FrameManager::onSetVsync()
 {
@@ -132,7 +140,9 @@ void FrameManager::setState(FrameManager::State state)
     case State::waitForFrameStart:
       notifyFrameComplete();
 
-      if (myTotalFrames > Metrics::initialGarbageFrames)
+      // Jitter is only tracked while enabled; it starts from a stable
+      // picture when it gets enabled
+      if (myJitterEnabled && myTotalFrames > Metrics::initialGarbageFrames)
         myJitterEmulation.frameComplete(myCurrentFrameFinalLines);
 
       notifyFrameStart();
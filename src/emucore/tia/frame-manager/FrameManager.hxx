@@ -23,7 +23,12 @@
 #include "bspf.hxx"
 #include "JitterEmulation.hxx"
 
-class FrameManager: public AbstractFrameManager {
+/**
+ * The frame manager used for display. It is final, so the TIA can drive it
+ * through a FrameManager pointer without any virtual calls per scanline (see
+ * nextLineDirect()).
+ */
+class FrameManager final: public AbstractFrameManager {
   public:
 
     enum Metrics : uInt32 {
@@ -52,12 +57,21 @@ class FrameManager: public AbstractFrameManager {
 
     bool jitterEnabled() const override { return myJitterEnabled; }
 
-    void enableJitter(bool enabled) override { myJitterEnabled = enabled; }
+    void enableJitter(bool enabled) override;
 
     uInt32 height() const override { return myHeight; }
 
     uInt32 getY() const override { return myY; }
 
+    /**
+     * Same as AbstractFrameManager::nextLine, but the line logic is bound
+     * statically and can be inlined.
+     */
+    void nextLineDirect() {
+      ++myCurrentFrameTotalLines;
+      FrameManager::onNextLine();
+    }
+
     uInt32 scanlines() const override { return myCurrentFrameTotalLines; }
 
     Int32 missingScanlines() const override;
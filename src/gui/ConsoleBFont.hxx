@@ -40,7 +40,7 @@
 namespace GUI {
 
 // Font character bitmap data.
-static const uInt16 consoleB_font_bits[] = {  // NOLINT : too complicated to convert
+inline constexpr uInt16 consoleB_font_bits[] = {  // NOLINT : too complicated to convert
 
   /* MODIFIED
   Character 28 (0x1c):
@@ -3415,7 +3415,7 @@ static const uInt16 consoleB_font_bits[] = {  // NOLINT : too complicated to con
 };
 
 /* Exported structure definition. */
-static const FontDesc consoleBDesc = {
+inline constexpr FontData consoleBData = {
   "8x13B-ISO8859-1",
   8,
   13,
@@ -3431,6 +3431,13 @@ static const FontDesc consoleBDesc = {
   sizeof(consoleB_font_bits)/sizeof(uInt16)
 };
 
+// The compressed glyphs; the bitmaps above are only used at compile time
+inline constexpr auto consoleB_font_glyphs =
+  FontPacker::pack<FontPacker::size(consoleBData)>(consoleBData);
+
+inline constexpr FontDesc consoleBDesc =
+  FontPacker::desc(consoleBData, consoleB_font_glyphs.data());
+
 } // End of namespace GUI
 
 #endif
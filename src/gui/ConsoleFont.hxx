@@ -40,7 +40,7 @@
 namespace GUI {
 
 // Font character bitmap data.
-static const uInt16 console_font_bits[] = {  // NOLINT : too complicated to convert
+inline constexpr uInt16 console_font_bits[] = {  // NOLINT : too complicated to convert
 
   /* MODIFIED
   Character 29 (0x1d):
@@ -3379,7 +3379,7 @@ static const uInt16 console_font_bits[] = {  // NOLINT : too complicated to conv
 };
 
 /* Exported structure definition. */
-static const FontDesc consoleDesc = {
+inline constexpr FontData consoleData = {
   "8x13-ISO8859-1",
   8,
   13,
@@ -3395,6 +3395,13 @@ static const FontDesc consoleDesc = {
   sizeof(console_font_bits)/sizeof(uInt16)
 };
 
+// The compressed glyphs; the bitmaps above are only used at compile time
+inline constexpr auto console_font_glyphs =
+  FontPacker::pack<FontPacker::size(consoleData)>(consoleData);
+
+inline constexpr FontDesc consoleDesc =
+  FontPacker::desc(consoleData, console_font_glyphs.data());
+
 } // End of namespace GUI
 
 #endif
@@ -40,7 +40,7 @@
 namespace GUI {
 
 // Font character bitmap data.
-static const uInt16 consoleMediumB_font_bits[] = {  // NOLINT : too complicated to convert
+inline constexpr uInt16 consoleMediumB_font_bits[] = {  // NOLINT : too complicated to convert
 
   /* MODIFIED
   Character 28 (0x1c): ellipsis
@@ -3810,7 +3810,7 @@ static const uInt16 consoleMediumB_font_bits[] = {  // NOLINT : too complicated
 };
 
 /* Exported structure definition. */
-static const FontDesc consoleMediumBDesc = {
+inline constexpr FontData consoleMediumBData = {
   "9x15B-ISO8859-1",
   9,
   15,
@@ -3826,6 +3826,13 @@ static const FontDesc consoleMediumBDesc = {
   sizeof(consoleMediumB_font_bits)/sizeof(uInt16)
 };
 
+// The compressed glyphs; the bitmaps above are only used at compile time
+inline constexpr auto consoleMediumB_font_glyphs =
+  FontPacker::pack<FontPacker::size(consoleMediumBData)>(consoleMediumBData);
+
+inline constexpr FontDesc consoleMediumBDesc =
+  FontPacker::desc(consoleMediumBData, consoleMediumB_font_glyphs.data());
+
 } // End of namespace GUI
 
 #endif
@@ -40,7 +40,7 @@
 namespace GUI {
 
 // Font character bitmap data.
-static const uInt16 consoleMedium_font_bits[] = {  // NOLINT : too complicated to convert
+inline constexpr uInt16 consoleMedium_font_bits[] = {  // NOLINT : too complicated to convert
 
   /* MODIFIED
   Character 29 (0x1d): ellipsis
@@ -3771,7 +3771,7 @@ static const uInt16 consoleMedium_font_bits[] = {  // NOLINT : too complicated t
 };
 
 /* Exported structure definition. */
-static const FontDesc consoleMediumDesc = {
+inline constexpr FontData consoleMediumData = {
   "9x15-ISO8859-1",
   9,
   15,
@@ -3787,6 +3787,13 @@ static const FontDesc consoleMediumDesc = {
   sizeof(consoleMedium_font_bits)/sizeof(uInt16)
 };
 
+// The compressed glyphs; the bitmaps above are only used at compile time
+inline constexpr auto consoleMedium_font_glyphs =
+  FontPacker::pack<FontPacker::size(consoleMediumData)>(consoleMediumData);
+
+inline constexpr FontDesc consoleMediumDesc =
+  FontPacker::desc(consoleMediumData, consoleMedium_font_glyphs.data());
+
 } // End of namespace GUI
 
 #endif
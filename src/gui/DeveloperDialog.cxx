@@ -530,6 +530,25 @@ void DeveloperDialog::addTimeMachineTab(const GUI::Font& font)
   wid.push_back(myUncompressedWidget);
   ypos += lineHeight + VGAP;
 
+  myStateMemoryWidget = new SliderWidget(myTab, font, xpos, ypos - 1, swidth, lineHeight,
+                                         "Memory budget     ", 0, kMemoryChanged, lwidth, " MB");
+  myStateMemoryWidget->setMinValue(0);
+  myStateMemoryWidget->setMaxValue(256);
+  myStateMemoryWidget->setStepValue(8);
+  myStateMemoryWidget->setTickmarkIntervals(4);
+  myStateMemoryWidget->setToolTip("Define the maximum memory used by the states.\n"
+                                  "States will be removed like in a full buffer\n"
+                                  "when the budget is exceeded.");
+  wid.push_back(myStateMemoryWidget);
+  ypos += lineHeight + VGAP;
+
+  myStateArchiveWidget = new CheckboxWidget(myTab, font, xpos, ypos + 1,
+                                            "Archive states exceeding the budget");
+  myStateArchiveWidget->setToolTip("Move states exceeding the memory budget into\n"
+                                   "a file instead of removing them.");
+  wid.push_back(myStateArchiveWidget);
+  ypos += lineHeight + VGAP;
+
   items.clear();
   for(int i = 0; i < NUM_INTERVALS; ++i)
     VarList::push_back(items, INTERVALS[i], INT_SETTINGS[i]);
@@ -707,6 +726,8 @@ void DeveloperDialog::loadSettings(SettingsSet set)
   myTimeMachine[set] = instance().settings().getBool(prefix + "timemachine");
   myStateSize[set] = instance().settings().getInt(prefix + "tm.size");
   myUncompressed[set] = instance().settings().getInt(prefix + "tm.uncompressed");
+  myStateMemory[set] = instance().settings().getInt(prefix + "tm.memory");
+  myStateArchive[set] = instance().settings().getBool(prefix + "tm.archive");
   myStateInterval[set] = instance().settings().getString(prefix + "tm.interval");
   myStateHorizon[set] = instance().settings().getString(prefix + "tm.horizon");
 }
@@ -774,6 +795,8 @@ void DeveloperDialog::saveSettings(SettingsSet set)
   instance().settings().setValue(prefix + "timemachine", myTimeMachine[set]);
   instance().settings().setValue(prefix + "tm.size", myStateSize[set]);
   instance().settings().setValue(prefix + "tm.uncompressed", myUncompressed[set]);
+  instance().settings().setValue(prefix + "tm.memory", myStateMemory[set]);
+  instance().settings().setValue(prefix + "tm.archive", myStateArchive[set]);
   instance().settings().setValue(prefix + "tm.interval", myStateInterval[set]);
   instance().settings().setValue(prefix + "tm.horizon", myStateHorizon[set]);
 }
@@ -829,6 +852,8 @@ void DeveloperDialog::getWidgetStates(SettingsSet set)
   myTimeMachine[set] = myTimeMachineWidget->getState();
   myStateSize[set] = myStateSizeWidget->getValue();
   myUncompressed[set] = myUncompressedWidget->getValue();
+  myStateMemory[set] = myStateMemoryWidget->getValue();
+  myStateArchive[set] = myStateArchiveWidget->getState();
   myStateInterval[set] = myStateIntervalWidget->getSelectedTag().toString();
   myStateHorizon[set] = myStateHorizonWidget->getSelectedTag().toString();
 }
@@ -879,12 +904,15 @@ void DeveloperDialog::setWidgetStates(SettingsSet set)
   myTimeMachineWidget->setState(myTimeMachine[set]);
   myStateSizeWidget->setValue(myStateSize[set]);
   myUncompressedWidget->setValue(myUncompressed[set]);
+  myStateMemoryWidget->setValue(myStateMemory[set]);
+  myStateArchiveWidget->setState(myStateArchive[set]);
   myStateIntervalWidget->setSelected(myStateInterval[set]);
   myStateHorizonWidget->setSelected(myStateHorizon[set]);
 
   handleTimeMachine();
   handleSize();
   handleUncompressed();
+  handleMemory();
   handleInterval();
   handleHorizon();
 }
@@ -1074,6 +1102,8 @@ void DeveloperDialog::setDefaults()
       myTimeMachine[set] = true;
       myStateSize[set] = devSettings ? 1000 : 200;
       myUncompressed[set] = devSettings ? 600 : 60;
+      myStateMemory[set] = devSettings ? 128 : 32;
+      myStateArchive[set] = false;
       myStateInterval[set] = devSettings ? "1f" : "30f";
       myStateHorizon[set] = devSettings ? "30s" : "10m";
 
@@ -1149,6 +1179,10 @@ void DeveloperDialog::handleCommand(CommandSender* sender, int cmd, int data, in
       handleUncompressed();
       break;
 
+    case kMemoryChanged:
+      handleMemory();
+      break;
+
     case kIntervalChanged:
       handleInterval();
       break;
@@ -1307,6 +1341,8 @@ void DeveloperDialog::handleTimeMachine()
 
   myStateSizeWidget->setEnabled(enable);
   myUncompressedWidget->setEnabled(enable);
+  myStateMemoryWidget->setEnabled(enable);
+  myStateArchiveWidget->setEnabled(enable && myStateMemoryWidget->getValue() != 0);
   myStateIntervalWidget->setEnabled(enable);
 
   uInt32 size = myStateSizeWidget->getValue();
@@ -1365,6 +1401,20 @@ void DeveloperDialog::handleUncompressed()
   myStateHorizonWidget->setEnabled(myTimeMachineWidget->getState() && size > uncompressed);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DeveloperDialog::handleMemory()
+{
+  if(myStateMemoryWidget->getValue() == 0)
+  {
+    myStateMemoryWidget->setValueLabel("Off");
+    myStateMemoryWidget->setValueUnit("");
+  }
+  else
+    myStateMemoryWidget->setValueUnit(" MB");
+  myStateArchiveWidget->setEnabled(myTimeMachineWidget->getState() &&
+                                   myStateMemoryWidget->getValue() != 0);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void DeveloperDialog::handleInterval()
 {
@@ -66,6 +66,7 @@ class DeveloperDialog : public Dialog
       kTimeMachine          = 'DTtm',
       kSizeChanged          = 'DTsz',
       kUncompressedChanged  = 'DTuc',
+      kMemoryChanged        = 'DTmb',
       kIntervalChanged      = 'DTin',
       kHorizonChanged       = 'DThz',
       kP0ColourChangedCmd   = 'GOp0',
@@ -136,6 +137,8 @@ class DeveloperDialog : public Dialog
     CheckboxWidget*     myTimeMachineWidget{nullptr};
     SliderWidget*       myStateSizeWidget{nullptr};
     SliderWidget*       myUncompressedWidget{nullptr};
+    SliderWidget*       myStateMemoryWidget{nullptr};
+    CheckboxWidget*     myStateArchiveWidget{nullptr};
     PopUpWidget*        myStateIntervalWidget{nullptr};
     PopUpWidget*        myStateHorizonWidget{nullptr};
 
@@ -181,6 +184,8 @@ class DeveloperDialog : public Dialog
     std::array<bool, 2>   myTimeMachine;
     std::array<int, 2>    myStateSize;
     std::array<int, 2>    myUncompressed;
+    std::array<int, 2>    myStateMemory;
+    std::array<bool, 2>   myStateArchive;
     std::array<string, 2> myStateInterval;
     std::array<string, 2> myStateHorizon;
 
@@ -209,6 +214,7 @@ class DeveloperDialog : public Dialog
     void handleTimeMachine();
     void handleSize();
     void handleUncompressed();
+    void handleMemory();
     void handleInterval();
     void handleHorizon();
     void handleFontSize();
@@ -37,6 +37,8 @@
 #include "Vec.hxx"
 #include "TIA.hxx"
 #include "MediaFactory.hxx"
+#include "FrameProfiler.hxx"
+#include "Logger.hxx"
 
 /*
  * TODO list
@@ -323,7 +325,25 @@ void Dialog::redraw(bool force)
 
   // Draw this dialog
   setPosition();
-  drawDialog();
+
+  // When profiling frames, log the time spent for each redraw (also in
+  // the launcher, where no frames are profiled)
+  if(needsRedraw() && instance().settings().getBool("frameprofile"))
+  {
+    const bool full = isDirty();
+    const auto start = FrameProfiler::Clock::now();
+
+    drawDialog();
+
+    ostringstream buf;
+    buf << "Dialog '" << (_title.empty() ? "(untitled)" : _title) << "' "
+        << (full ? "redrawn" : "updated") << " in " << std::fixed << std::setprecision(3)
+        << std::chrono::duration<double, std::milli>(FrameProfiler::Clock::now() - start).count()
+        << " ms";
+    Logger::debug(buf.str());
+  }
+  else
+    drawDialog();
   // full rendering is caused in dialog container
 }
 
@@ -81,44 +81,137 @@ void FileListWidget::setLocation(const FilesystemNode& node,
 
   _node = node;
 
+  // Display only the relative paths in the tooltips
+  const size_t orgLen = _node.getShortPath().length();
+  const auto relativePath = [orgLen](const FilesystemNode& file) {
+    const string path = file.getShortPath();
+    return path.length() >= orgLen ? path.substr(orgLen) : path;
+  };
+
+  // Show the entries found so far while the file system is still being
+  // read; a single directory arrives in sorted order, while the entries
+  // of all sub-directories are merged into the already sorted ones
+  uInt64 lastUpdate = TimerManager::getTicks();
+  FilesystemNode::BatchReceiver onBatch = [&](FSList& list, size_t first) {
+    if(_includeSubDirs)
+    {
+      // The parent directory always stays on top
+      const size_t top = (!list.empty() && list[0].getName() == " [..]") ? 1 : 0;
+      first = std::max(first, top);
+
+      std::sort(list.begin() + first, list.end(), FilesystemNode::listOrder);
+      if(first > top && FilesystemNode::listOrder(list[first], list[first - 1]))
+        std::inplace_merge(list.begin() + top, list.begin() + first, list.end(),
+                           FilesystemNode::listOrder);
+    }
+
+    const uInt64 now = TimerManager::getTicks();
+    if(now - lastUpdate >= BATCH_UPDATE_INTERVAL)
+    {
+      lastUpdate = now;
+
+      // The list isn't indexed yet
+      _fileList.clear();
+      _dirList.clear();
+      for(const auto& file : list)
+        if(NameIndex::matches(file, _namePattern))
+        {
+          _fileList.push_back(file);
+          _dirList.push_back(relativePath(file));
+        }
+      fillList(EmptyString);
+      progress().refresh();
+    }
+  };
+
   // Read in the data from the file system (start with an empty list)
-  _fileList.clear();
+  _allFiles.clear();
 
   if(_includeSubDirs)
   {
     // Actually this could become HUGE
-    _fileList.reserve(0x2000);
-    _node.getAllChildren(_fileList, _fsmode, _filter, true, isCancelled);
+    _allFiles.reserve(0x2000);
+    if(_fsmode == FilesystemNode::ListMode::All)
+      // Only the directories changed since the last time are read again
+      _libraryIndex.getAllChildren(_node, _allFiles, _filter, true, isCancelled, onBatch);
+    else
+      _node.getAllChildren(_allFiles, _fsmode, _filter, true, isCancelled, onBatch);
   }
   else
   {
-    _fileList.reserve(0x200);
-    _node.getChildren(_fileList, _fsmode, _filter, false, true, isCancelled);
+    _allFiles.reserve(0x200);
+    _node.getChildren(_allFiles, _fsmode, _filter, false, true, isCancelled,
+                      onBatch);
   }
 
+  _allPaths.clear();
+  _allPaths.reserve(_allFiles.size());
+  for(const auto& file : _allFiles)
+    _allPaths.push_back(relativePath(file));
+
+  _nameIndex.build(_allFiles);
+  applyNamePattern();
+
+  // Send command to boss, then revert to target 'this'
+  setTarget(_boss);
+  sendCommand(ListChanged, 0, _id);
+  setTarget(this);
+
   // Now fill the list widget with the names from the file list,
   // even if cancelled
-  StringList l;
-  size_t orgLen = _node.getShortPath().length();
+  fillList(select);
+
+  progress().close();
+}
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FileListWidget::setNamePattern(const string& pattern)
+{
+  if(pattern == _namePattern)
+    return;
+
+  _namePattern = pattern;
+
+  // Keep the selection, if it still matches
+  const string select = _fileList.empty() ? EmptyString : selected().getName();
+  applyNamePattern();
+
+  setTarget(_boss);
+  sendCommand(ListChanged, 0, _id);
+  setTarget(this);
+
+  fillList(select);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FileListWidget::applyNamePattern()
+{
+  const vector<uInt32>& matches = _nameIndex.find(_namePattern);
+
+  _fileList.clear();
   _dirList.clear();
-  for(const auto& file : _fileList)
+  _fileList.reserve(matches.size());
+  _dirList.reserve(matches.size());
+
+  for(const uInt32 i : matches)
   {
-    const string path = file.getShortPath();
+    _fileList.push_back(_allFiles[i]);
+    _dirList.push_back(_allPaths[i]);
+  }
+}
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FileListWidget::fillList(const string& select)
+{
+  StringList l;
+  l.reserve(_fileList.size());
+
+  for(const auto& file : _fileList)
     l.push_back(file.getName());
-    // display only relative path in tooltip
-    if(path.length() >= orgLen)
-      _dirList.push_back(path.substr(orgLen));
-    else
-      _dirList.push_back(path);
-  }
 
-  setList(l);
+  setList(std::move(l));
   setSelected(select);
   ListWidget::recalc();
-
-  progress().close();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
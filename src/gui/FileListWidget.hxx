@@ -22,6 +22,8 @@ class CommandSender;
 class ProgressDialog;
 
 #include "FSNode.hxx"
+#include "LibraryIndex.hxx"
+#include "NameIndex.hxx"
 #include "Stack.hxx"
 #include "StringListWidget.hxx"
 
@@ -32,20 +34,23 @@ class ProgressDialog;
 
   When the signals ItemChanged and ItemActivated are emitted, the caller
   can query the selected() and/or currentDir() methods to determine the
-  current state.
+  current state.  When the signal ListChanged is emitted, fileList()
+  contains the new entries, before any of them is selected.
 
   Note that the ItemActivated signal is not sent when activating a
   directory; instead the selection descends into the directory.
 
   Widgets wishing to enforce their own filename filtering are able
-  to use a 'NameFilter' as described below.
+  to use a 'NameFilter' as described below.  Filtering by a name pattern
+  is done on the entries already read, without reading them again.
 */
 class FileListWidget : public StringListWidget
 {
   public:
     enum {
       ItemChanged   = 'FLic',  // Entry in the list is changed (single-click, etc)
-      ItemActivated = 'FLac'   // Entry in the list is activated (double-click, etc)
+      ItemActivated = 'FLac',  // Entry in the list is activated (double-click, etc)
+      ListChanged   = 'FLlc'   // The list was (re)loaded
     };
 
   public:
@@ -65,6 +70,12 @@ class FileListWidget : public StringListWidget
     // When enabled, all subdirectories will be searched too.
     void setIncludeSubDirs(bool enable) { _includeSubDirs = enable; }
 
+    /**
+      Only show the files whose names match the given pattern (see
+      NameIndex); directories are always shown.  Takes effect immediately.
+    */
+    void setNamePattern(const string& pattern);
+
     /**
       Set initial directory, and optionally select the given item.
 
@@ -89,6 +100,7 @@ class FileListWidget : public StringListWidget
       return _fileList[_selected];
     }
     const FilesystemNode& currentDir() const { return _node; }
+    const FSList& fileList() const { return _fileList; }
 
     static void setQuickSelectDelay(uInt64 time) { _QUICK_SELECT_DELAY = time; }
     uInt64 getQuickSelectDelay() const { return _QUICK_SELECT_DELAY; }
@@ -100,6 +112,12 @@ class FileListWidget : public StringListWidget
     /** Very similar to setDirectory(), but also updates the history */
     void setLocation(const FilesystemNode& node, const string& select);
 
+    /** Show the current file list, and optionally select the given item */
+    void fillList(const string& select);
+
+    /** Set the current file list to the entries matching the name pattern */
+    void applyNamePattern();
+
     bool handleText(char text) override;
     void handleCommand(CommandSender* sender, int cmd, int data, int id) override;
 
@@ -112,6 +130,16 @@ class FileListWidget : public StringListWidget
 
     StringList _dirList;
 
+    // All entries read, before filtering by name pattern, and their
+    // relative paths
+    FSList _allFiles;
+    StringList _allPaths;
+    NameIndex _nameIndex;
+    string _namePattern;
+
+    // The directory trees listed with all subdirectories so far
+    LibraryIndex _libraryIndex;
+
     Common::FixedStack<string> _history;
     uInt32 _selected{0};
     string _selectedFile;
@@ -120,6 +148,9 @@ class FileListWidget : public StringListWidget
     uInt64 _quickSelectTime{0};
     static uInt64 _QUICK_SELECT_DELAY;
 
+    // Minimum time between showing partial listings (in microseconds)
+    static constexpr uInt64 BATCH_UPDATE_INTERVAL = 100000;
+
     unique_ptr<ProgressDialog> myProgressDialog;
 
   private:
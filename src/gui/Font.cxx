@@ -28,10 +28,14 @@ namespace GUI {
 Font::Font(const FontDesc& desc)
   : myFontDesc{desc}
 {
+  for(uInt32 chr = 0; chr < myCharWidths.size(); ++chr)
+    myCharWidths[chr] = charWidth(uInt8(chr));
+
+  rasterize();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-int Font::getCharWidth(uInt8 chr) const
+int Font::charWidth(uInt8 chr) const
 {
   // If no width table is specified, return the maximum width
   if(!myFontDesc.width)
@@ -59,4 +63,83 @@ int Font::getStringWidth(const string& str) const
         [&](int x, char c) { return x + getCharWidth(c); });
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Font::rasterize()
+{
+  const FontDesc& desc = myFontDesc;
+
+  // Locate the compressed bitmap of each glyph
+  vector<const uInt8*> bitmaps(desc.size);
+  const uInt8* data = desc.glyphs;
+  for(int i = 0; i < desc.size; ++i)
+  {
+    bitmaps[i] = data;
+    data += FontPacker::glyphSize(desc.bbx ? desc.bbx[i].w : desc.fbbw, data[1]);  // NOLINT
+  }
+
+  for(uInt32 c = 0; c < myGlyphs.size(); ++c)
+  {
+    Glyph& glyph = myGlyphs[c];
+    int chr = c;
+
+    // If this character is not included in the font, use the default char.
+    if(chr < desc.firstchar || chr >= desc.firstchar + desc.size)
+    {
+      if(chr == ' ')
+        continue;
+      chr = desc.defaultchar;
+    }
+    chr -= desc.firstchar;
+
+    // Get the bounding box of the character
+    int bbx, bby;
+    if(!desc.bbx)
+    {
+      glyph.w = desc.fbbw;
+      glyph.h = desc.fbbh;
+      bbx = desc.fbbx;
+      bby = desc.fbby;
+    }
+    else
+    {
+      glyph.w = desc.bbx[chr].w;  // NOLINT
+      glyph.h = desc.bbx[chr].h;  // NOLINT
+      bbx = desc.bbx[chr].x;  // NOLINT
+      bby = desc.bbx[chr].y;  // NOLINT
+    }
+    glyph.x = bbx;
+    glyph.y = desc.ascent - bby - glyph.h;
+
+    // Only the rows between the first and the last non-blank one are stored
+    const uInt8* bitmap = bitmaps[chr];
+    const int first = bitmap[0], rows = bitmap[1];
+    const uInt8* bits = bitmap + 2;
+    const auto pixel = [&](int x, int y) {
+      const uInt32 bit = y * glyph.w + x;
+      return (bits[bit >> 3] & (0x80 >> (bit & 7))) != 0;
+    };
+
+    glyph.first = uInt32(myRuns.size());
+    for(int y = 0; y < rows; ++y)
+    {
+      int x = 0;
+
+      while(x < glyph.w)
+      {
+        if(!pixel(x, y))
+        {
+          ++x;
+          continue;
+        }
+
+        const int start = x;
+        while(x < glyph.w && pixel(x, y))
+          ++x;
+        myRuns.push_back({uInt8(start), uInt8(first + y), uInt8(x - start)});
+      }
+    }
+    glyph.count = uInt32(myRuns.size()) - glyph.first;
+  }
+}
+
 }  // namespace GUI
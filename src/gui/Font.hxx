@@ -33,7 +33,7 @@ struct BBX
 
 /* builtin C-based proportional/fixed font structure */
 /* based on The Microwindows Project http://microwindows.org */
-struct FontDesc
+struct FontData
 {
   const char* const name;               /* font name */
   int           maxwidth;               /* max width in pixels */
@@ -50,6 +50,110 @@ struct FontDesc
   long          bits_size;              /* # words of bitmap_t bits */
 };
 
+/* the font as linked in, with the glyphs compressed by FontPacker */
+struct FontDesc
+{
+  const char* const name;               /* font name */
+  int           maxwidth;               /* max width in pixels */
+  int           height;                 /* height in pixels */
+  int           fbbw, fbbh, fbbx, fbby;	/* max bounding box */
+  int           ascent;                 /* ascent (baseline) height */
+  int           firstchar;              /* first character in bitmap */
+  int           size;                   /* font size in glyphs */
+  const uInt8*  glyphs;                 /* compressed glyph bitmaps */
+  const uInt8*  width;                  /* character widths or nullptr if fixed */
+  const BBX*    bbx;                    /* character bounding box or nullptr if fixed */
+  int           defaultchar;            /* default char (not glyph index) */
+};
+
+/**
+  Compresses the glyph bitmaps of a FontData at compile time, so that only
+  the compressed glyphs are linked in; they are decoded when a GUI::Font is
+  created from the FontDesc.
+
+  Each glyph is stored as the index of its first non-blank row and the
+  number of rows up to its last non-blank one (one byte each), followed by
+  these rows, packed into 'bounding box width' bits each (MSB first) and
+  padded to a full byte.
+*/
+namespace FontPacker {
+
+  constexpr int glyphWidth(const FontData& font, int glyph) {
+    return font.bbx ? font.bbx[glyph].w : font.fbbw;
+  }
+
+  constexpr int glyphHeight(const FontData& font, int glyph) {
+    return font.bbx ? font.bbx[glyph].h : font.fbbh;
+  }
+
+  constexpr size_t glyphSize(int width, int rows) {
+    return 2 + (rows * width + 7) / 8;
+  }
+
+  // The rows of a glyph, without the blank ones at its top and bottom
+  struct Rows {
+    int first, count;
+  };
+
+  constexpr Rows usedRows(const FontData& font, int glyph) {
+    const uInt16* bits = font.bits +
+        (font.offset ? font.offset[glyph] : glyph * font.fbbh);
+    int first = 0, last = glyphHeight(font, glyph);
+
+    while(first < last && !bits[first])
+      ++first;
+    while(last > first && !bits[last - 1])
+      --last;
+
+    return Rows{first, last - first};
+  }
+
+  constexpr size_t size(const FontData& font) {
+    size_t size = 0;
+    for(int glyph = 0; glyph < font.size; ++glyph)
+      size += glyphSize(glyphWidth(font, glyph), usedRows(font, glyph).count);
+
+    return size;
+  }
+
+  template<size_t N>
+  constexpr std::array<uInt8, N> pack(const FontData& font) {
+    std::array<uInt8, N> glyphs{};
+    size_t pos = 0;
+
+    for(int glyph = 0; glyph < font.size; ++glyph)
+    {
+      const uInt16* bits = font.bits +
+          (font.offset ? font.offset[glyph] : glyph * font.fbbh);
+      const int width = glyphWidth(font, glyph);
+      const Rows rows = usedRows(font, glyph);
+
+      glyphs[pos] = uInt8(rows.first);
+      glyphs[pos + 1] = uInt8(rows.count);
+
+      size_t bit = (pos + 2) * 8;
+      for(int y = rows.first; y < rows.first + rows.count; ++y)
+        for(int x = 0; x < width; ++x, ++bit)
+          if(bits[y] & (0x8000 >> x))
+            glyphs[bit / 8] |= uInt8(0x80 >> (bit % 8));
+
+      pos += glyphSize(width, rows.count);
+    }
+
+    return glyphs;
+  }
+
+  constexpr FontDesc desc(const FontData& font, const uInt8* glyphs) {
+    return FontDesc{
+      font.name, font.maxwidth, font.height,
+      font.fbbw, font.fbbh, font.fbbx, font.fbby,
+      font.ascent, font.firstchar, font.size,
+      glyphs, font.width, font.bbx, font.defaultchar
+    };
+  }
+
+} // namespace FontPacker
+
 namespace GUI {
 
 class Font
@@ -63,13 +167,50 @@ class Font
     int getLineHeight() const { return myFontDesc.height + 2; }
     int getMaxCharWidth() const { return myFontDesc.maxwidth; }
 
-    int getCharWidth(uInt8 chr) const;
+    int getCharWidth(uInt8 chr) const { return myCharWidths[chr]; }
 
     int getStringWidth(const string& str) const;
 
+    /**
+      The memory (in bytes) held by the rasterized glyphs.
+    */
+    size_t memoryUsage() const {
+      return sizeof(myCharWidths) + sizeof(myGlyphs) + myRuns.capacity() * sizeof(Run);
+    }
+
+    // A horizontal run of set pixels of a glyph
+    struct Run {
+      uInt8 x, y, len;
+    };
+
+    // A glyph, pre-rasterized into the runs myRuns[first ... first+count-1]
+    struct Glyph {
+      int x{0}, y{0};       // position of the bounding box, relative to the
+                            // character cell
+      int w{0}, h{0};       // size of the bounding box (0 if not drawn)
+      uInt32 first{0}, count{0};
+    };
+
+    /**
+      The glyph drawn for the given character; characters not included
+      in the font use the glyph of the default char.
+    */
+    const Glyph& glyph(uInt8 chr) const { return myGlyphs[chr]; }
+    const Run* runs(const Glyph& glyph) const { return myRuns.data() + glyph.first; }
+
+  private:
+    int charWidth(uInt8 chr) const;
+    void rasterize();
+
   private:
     FontDesc myFontDesc;
 
+    // The width of each character, resp. its glyph (both are computed
+    // once, as the GUI draws and measures thousands of characters per frame)
+    std::array<int, 256> myCharWidths;
+    std::array<Glyph, 256> myGlyphs;
+    vector<Run> myRuns;
+
   private:
     // Following constructors and assignment operators not supported
     Font() = delete;
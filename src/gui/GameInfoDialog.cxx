@@ -1134,7 +1134,7 @@ void GameInfoDialog::updateControllerStates()
         label = "QuadTari detected"; // remove plugged-in controller names
     }
     else if(autoDetect)
-      label = ControllerDetector::detectName(image, size, type,
+      label = ControllerDetector::detectName(image.get(), size, type,
                                              !swapPorts ? Controller::Jack::Left : Controller::Jack::Right,
                                              instance().settings()) + " detected";
   }
@@ -1153,7 +1153,7 @@ void GameInfoDialog::updateControllerStates()
         label = "QuadTari detected"; // remove plugged-in controller names
     }
     else if(autoDetect)
-      label = ControllerDetector::detectName(image, size, type,
+      label = ControllerDetector::detectName(image.get(), size, type,
                                              !swapPorts ? Controller::Jack::Right : Controller::Jack::Left,
                                              instance().settings()) + " detected";
   }
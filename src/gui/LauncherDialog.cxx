@@ -34,7 +34,6 @@
 #include "ProgressDialog.hxx"
 #include "MessageBox.hxx"
 #include "ToolTip.hxx"
-#include "TimerManager.hxx"
 #include "OSystem.hxx"
 #include "FrameBuffer.hxx"
 #include "FBSurface.hxx"
@@ -42,7 +41,9 @@
 #include "StellaKeys.hxx"
 #include "Props.hxx"
 #include "PropsSet.hxx"
+#include "RomMetadataCache.hxx"
 #include "RomInfoWidget.hxx"
+#include "RomPrefetcher.hxx"
 #include "TIAConstants.hxx"
 #include "Settings.hxx"
 #include "Widget.hxx"
@@ -231,6 +232,9 @@ LauncherDialog::LauncherDialog(OSystem& osystem, DialogContainer& parent,
     setRomInfoFont(fontArea);
     myRomInfoWidget = new RomInfoWidget(this, *myROMInfoFont,
         xpos, ypos, romWidth, myList->getHeight(), imgSize);
+
+    myPrefetcher = make_unique<RomPrefetcher>(instance());
+    myRomInfoWidget->setPrefetcher(myPrefetcher.get());
   }
 
   // Add textfield to show current directory
@@ -326,13 +330,40 @@ const string& LauncherDialog::selectedRomMD5()
     myMD5List.clear();
 
   // Lookup MD5, and if not present, cache it
-  auto iter = myMD5List.find(currentNode().getPath());
-  if(iter == myMD5List.end())
-    myMD5List[currentNode().getPath()] = MD5::hash(currentNode());
+  string md5;
+  if(!knownRomMD5(currentNode(), md5))
+  {
+    RomMetadataCache::Metadata metadata;
+
+    metadata.md5 = MD5::hash(currentNode());
+    if(!metadata.md5.empty())
+      instance().romCache().update(currentNode(), metadata);
+    myMD5List[currentNode().getPath()] = metadata.md5;
+  }
 
   return myMD5List[currentNode().getPath()];
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool LauncherDialog::knownRomMD5(const FilesystemNode& node, string& md5)
+{
+  auto iter = myMD5List.find(node.getPath());
+  if(iter != myMD5List.end())
+  {
+    md5 = iter->second;
+    return true;
+  }
+
+  // Try the persistent cache before reading the file
+  RomMetadataCache::Metadata metadata;
+
+  if(!instance().romCache().get(node, metadata) || metadata.md5.empty())
+    return false;
+
+  md5 = myMD5List[node.getPath()] = metadata.md5;
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 const FilesystemNode& LauncherDialog::currentNode() const
 {
@@ -349,15 +380,23 @@ const FilesystemNode& LauncherDialog::currentDir() const
 void LauncherDialog::reload()
 {
   myMD5List.clear();
+#ifdef PNG_SUPPORT
+  if(myPrefetcher)
+    myPrefetcher->clearSnapshots();
+#endif
   myList->reload();
-  myPendingReload = false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void LauncherDialog::tick()
 {
-  if(myPendingReload && myReloadTime < TimerManager::getTicks() / 1000)
-    reload();
+  if(myPrefetcher && myPrefetcher->changed())
+  {
+    // Show the selected ROM as soon as the prefetcher has read it
+    if(!myPendingRom.empty() && !myPrefetcher->isPending(myPendingRom))
+      loadRomInfo();
+    myRomInfoWidget->updateSnapshot();
+  }
 
   Dialog::tick();
 }
@@ -426,81 +465,13 @@ void LauncherDialog::updateUI()
   buf << (myList->getList().size() - 1) << (myShortCount ? " found" : " items found");
   myRomCount->setLabel(buf.str());
 
+  // Read the selected ROM in the background, so that it starts quickly
+  instance().prepareConsole(currentNode());
+
   // Update ROM info UI item
   loadRomInfo();
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-size_t LauncherDialog::matchWithJoker(const string& str, const string& pattern)
-{
-  if(str.length() >= pattern.length())
-  {
-    // optimize a bit
-    if(pattern.find('?') != string::npos)
-    {
-      for(size_t pos = 0; pos < str.length() - pattern.length() + 1; ++pos)
-      {
-        bool found = true;
-
-        for(size_t i = 0; found && i < pattern.length(); ++i)
-          if(pattern[i] != str[pos + i] && pattern[i] != '?')
-            found = false;
-
-        if(found)
-          return pos;
-      }
-    }
-    else
-      return str.find(pattern);
-  }
-  return string::npos;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool LauncherDialog::matchWithWildcards(const string& str, const string& pattern)
-{
-  string pat = pattern;
-
-  // remove leading and trailing '*'
-  size_t i = 0;
-  while(pat[i++] == '*');
-  pat = pat.substr(i - 1);
-
-  i = pat.length();
-  while(pat[--i] == '*');
-  pat.erase(i + 1);
-
-  // Search for first '*'
-  size_t pos = pat.find('*');
-
-  if(pos != string::npos)
-  {
-    // '*' found, split pattern into left and right part, search recursively
-    const string leftPat = pat.substr(0, pos);
-    const string rightPat = pat.substr(pos + 1);
-    size_t posLeft = matchWithJoker(str, leftPat);
-
-    if(posLeft != string::npos)
-      return matchWithWildcards(str.substr(pos + posLeft), rightPat);
-    else
-      return false;
-  }
-  // no further '*' found
-  return matchWithJoker(str, pat) != string::npos;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool LauncherDialog::matchWithWildcardsIgnoreCase(const string& str, const string& pattern)
-{
-  string in = str;
-  string pat = pattern;
-
-  BSPF::toUpperCase(in);
-  BSPF::toUpperCase(pat);
-
-  return matchWithWildcards(in, pat);
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void LauncherDialog::applyFiltering()
 {
@@ -512,11 +483,6 @@ void LauncherDialog::applyFiltering()
         // Do we want to show only ROMs or all files?
         if(myShowOnlyROMs && !Bankswitch::isValidRomName(node))
           return false;
-
-        // Skip over files that don't match the pattern in the 'pattern' textbox
-        if(myPattern && myPattern->getText() != "" &&
-           !matchWithWildcardsIgnoreCase(node.getName(), myPattern->getText()))
-          return false;
       }
       return true;
     }
@@ -598,11 +564,66 @@ void LauncherDialog::loadRomInfo()
   if(!myRomInfoWidget)
     return;
 
+  if(myPrefetcher)
+  {
+    myPrefetcher->setCursor(myList->getSelected());
+
+    // Unless the ROM was read before, let the prefetcher read it instead of
+    // blocking the UI (if this fails, the ROM is read below after all)
+    const string& path = currentNode().getPath();
+    string md5;
+    if(!knownRomMD5(currentNode(), md5) &&
+       (path == myPendingRom ? myPrefetcher->isPending(path)
+                             : myPrefetcher->requestRom(currentNode())))
+    {
+      myPendingRom = path;
+      myRomInfoWidget->clearProperties();
+      return;
+    }
+    myPendingRom = "";
+  }
+
   const string& md5 = selectedRomMD5();
   if(md5 != EmptyString)
     myRomInfoWidget->setProperties(currentNode(), md5);
   else
     myRomInfoWidget->clearProperties();
+
+  prefetchSnapshots();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void LauncherDialog::prefetchSnapshots()
+{
+#ifdef PNG_SUPPORT
+  if(!myPrefetcher)
+    return;
+
+  const FSList& files = myList->fileList();
+  const int selected = myList->getSelected();
+  StringList filenames;
+
+  // Only the snapshots of ROMs whose properties are known without reading
+  // them can be prefetched
+  for(int distance = 1; distance <= SNAPSHOT_PREFETCH; ++distance)
+  {
+    for(int index : { selected + distance, selected - distance })
+    {
+      string md5;
+      if(index < 0 || index >= int(files.size()) || files[index].isDirectory() ||
+         !knownRomMD5(files[index], md5))
+        continue;
+
+      Properties props;
+      instance().propSet().getMD5(md5, props);
+
+      const string& name = props.get(PropType::Cart_Name);
+      filenames.push_back(instance().snapshotLoadDir().getPath() +
+          (name != EmptyString ? name : files[index].getNameWithExt("")) + ".png");
+    }
+  }
+  myPrefetcher->prefetchSnapshots(filenames);
+#endif
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -815,6 +836,11 @@ void LauncherDialog::handleCommand(CommandSender* sender, int cmd,
       updateUI();
       break;
 
+    case FileListWidget::ListChanged:
+      if(myPrefetcher)
+        myPrefetcher->setList(myList->fileList());
+      break;
+
     case ListWidget::kLongButtonPressCmd:
       if (!currentNode().isDirectory() && Bankswitch::isValidRomName(currentNode()))
         openGlobalProps();
@@ -823,22 +849,10 @@ void LauncherDialog::handleCommand(CommandSender* sender, int cmd,
 
     case EditableWidget::kChangedCmd:
     case EditableWidget::kAcceptCmd:
-    {
-      bool subDirs = mySubDirs->getState();
-
-      myList->setIncludeSubDirs(subDirs);
-      applyFiltering();  // pattern matching taken care of directly in this method
-
-      if(subDirs && cmd == EditableWidget::kChangedCmd)
-      {
-        // delay (potentially slow) subdirectories reloads until user stops typing
-        myReloadTime = TimerManager::getTicks() / 1000 + myList->getQuickSelectDelay();
-        myPendingReload = true;
-      }
-      else
-        reload();
+      // The entries already read are filtered, the file system isn't read again
+      if(myPattern)
+        myList->setNamePattern(myPattern->getText());
       break;
-    }
 
     case kQuitCmd:
       saveConfig();
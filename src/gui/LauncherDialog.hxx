@@ -27,6 +27,7 @@ class Properties;
 class EditTextWidget;
 class FileListWidget;
 class RomInfoWidget;
+class RomPrefetcher;
 class StaticTextWidget;
 namespace Common {
   struct Size;
@@ -97,6 +98,7 @@ class LauncherDialog : public Dialog
     static constexpr int MIN_ROMINFO_CHARS = 30;
     static constexpr int MIN_ROMINFO_ROWS = 7; // full lines
     static constexpr int MIN_ROMINFO_LINES = 4; // extra lines
+    static constexpr int SNAPSHOT_PREFETCH = 2; // snapshots ahead and behind
 
     void setPosition() override { positionAt(0); }
     void handleKeyDown(StellaKey key, StellaMod mod, bool repeated) override;
@@ -110,45 +112,27 @@ class LauncherDialog : public Dialog
     void saveConfig() override;
     void updateUI();
 
-    /**
-      Search if string contains pattern including wildcard '*'
-      and '?' as joker, ignoring case.
+    void applyFiltering();
 
-      @param str      The searched string
-      @param pattern  The pattern to search for
+    float getRomInfoZoom(int listHeight) const;
+    void setRomInfoFont(const Common::Size& area);
 
-      @return True if pattern was found.
-    */
-    bool matchWithWildcardsIgnoreCase(const string& str, const string& pattern);
+    void loadRom();
+    void loadRomInfo();
 
     /**
-      Search if string contains pattern including wildcard '*'
-      and '?' as joker.
-
-      @param str      The searched string
-      @param pattern  The pattern to search for
+      Get MD5sum for the given file, if it is already known (without
+      reading the file).
 
-      @return True if pattern was found.
+      @return True if the MD5 is known
     */
-    bool matchWithWildcards(const string& str, const string& pattern);
+    bool knownRomMD5(const FilesystemNode& node, string& md5);
 
     /**
-      Search if string contains pattern including '?' as joker.
-
-      @param str      The searched string
-      @param pattern  The pattern to search for
-
-      @return Position of pattern in string.
+      Let the prefetcher decode the snapshots of the ROMs around the
+      current selection.
     */
-    size_t matchWithJoker(const string& str, const string& pattern);
-
-    void applyFiltering();
-
-    float getRomInfoZoom(int listHeight) const;
-    void setRomInfoFont(const Common::Size& area);
-
-    void loadRom();
-    void loadRomInfo();
+    void prefetchSnapshots();
     void handleContextMenu();
     void showOnlyROMs(bool state);
     void setDefaultDir();
@@ -185,14 +169,17 @@ class LauncherDialog : public Dialog
     RomInfoWidget*    myRomInfoWidget{nullptr};
     std::unordered_map<string,string> myMD5List;
 
+    // Reads ROMs and snapshots in the background
+    unique_ptr<RomPrefetcher> myPrefetcher;
+    // The selected ROM, while it is being read by the prefetcher
+    string myPendingRom;
+
     int mySelectedItem{0};
 
     bool myShowOnlyROMs{false};
     bool myUseMinimalUI{false};
     bool myEventHandled{false};
     bool myShortCount{false};
-    bool myPendingReload{false};
-    uInt64 myReloadTime{0};
 
     enum {
       kAllfilesCmd   = 'lalf',  // show all files (or ROMs only)
@@ -0,0 +1,116 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include "LibraryIndex.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool LibraryIndex::getAllChildren(const FilesystemNode& node, FSList& fslist,
+                                  const FilesystemNode::NameFilter& filter,
+                                  bool includeParentDirectory,
+                                  const FilesystemNode::CancelCheck& isCancelled,
+                                  const FilesystemNode::BatchReceiver& onBatch)
+{
+  if(!node.isDirectory())
+    return false;
+
+  // Add parent node, if it is valid to do so
+  if(includeParentDirectory && node.hasParent())
+  {
+    FilesystemNode parent = node.getParent();
+    parent.setName(" [..]");
+    fslist.emplace_back(parent);
+  }
+
+  if(!addTree(node, fslist, filter, isCancelled, onBatch))
+    return false;
+
+  std::sort(fslist.begin(), fslist.end(), FilesystemNode::listOrder);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool LibraryIndex::addTree(const FilesystemNode& dir, FSList& fslist,
+                           const FilesystemNode::NameFilter& filter,
+                           const FilesystemNode::CancelCheck& isCancelled,
+                           const FilesystemNode::BatchReceiver& onBatch)
+{
+  const Directory* entries = directory(dir, isCancelled);
+  if(entries == nullptr)
+    return false;
+
+  const size_t first = fslist.size();
+  for(const auto& file : entries->files)
+    if(filter(file))
+      fslist.emplace_back(file);
+
+  if(onBatch && fslist.size() > first)
+    onBatch(fslist, first);
+
+  // Copied, as reading a sub-directory may rehash the index
+  const FSList subDirectories = entries->subDirectories;
+  for(const auto& subDirectory : subDirectories)
+    if(!addTree(subDirectory, fslist, filter, isCancelled, onBatch))
+      return false;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const LibraryIndex::Directory*
+LibraryIndex::directory(const FilesystemNode& dir,
+                        const FilesystemNode::CancelCheck& isCancelled)
+{
+  // The stamp is taken before reading, so that changes made while the
+  // directory is read are detected the next time
+  uInt64 stamp = 0;
+  const bool hasStamp = dir.getDirectoryStamp(stamp);
+
+  const auto it = myDirectories.find(dir.getPath());
+  if(it != myDirectories.end() && hasStamp && it->second.hasStamp &&
+     it->second.stamp == stamp)
+    return &it->second;
+
+  if(isCancelled())
+    return nullptr;
+
+  // This also replaces single file ZIP archives by their contents
+  FSList entries;
+  if(!dir.getChildren(entries, FilesystemNode::ListMode::All,
+                      [](const FilesystemNode&) { return true; },
+                      false, false, isCancelled))
+  {
+    myDirectories.erase(dir.getPath());
+    return isCancelled() ? nullptr : &myDirectories[dir.getPath()];
+  }
+
+  Directory& directory = myDirectories[dir.getPath()];
+  directory.stamp = stamp;
+  directory.hasStamp = hasStamp;
+  directory.files.clear();
+  directory.subDirectories.clear();
+
+  // ZIP archives are listed like files, even if they contain several ROMs
+  for(auto& entry : entries)
+    if(entry.isDirectory() && !BSPF::endsWithIgnoreCase(entry.getPath(), ".zip"))
+      directory.subDirectories.emplace_back(std::move(entry));
+    else
+      directory.files.emplace_back(std::move(entry));
+
+  return &directory;
+}
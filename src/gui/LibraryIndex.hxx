@@ -0,0 +1,102 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef LIBRARY_INDEX_HXX
+#define LIBRARY_INDEX_HXX
+
+#include <unordered_map>
+
+#include "FSNode.hxx"
+#include "bspf.hxx"
+
+/**
+  An index of the directory trees listed recursively (the launcher's
+  'subdirectories' mode), which keeps the entries of each directory
+  read.  Listing a tree again only reads the directories which have
+  changed since; all others are checked by their stamp (see
+  FilesystemNode::getDirectoryStamp()) without being read.
+
+  Directories whose stamp isn't available are always read again.
+
+  @author  Stella Team
+*/
+class LibraryIndex
+{
+  public:
+    LibraryIndex() = default;
+
+    /**
+      List all files in the given directory and its subdirectories, like
+      FilesystemNode::getAllChildren() does in ListMode::All.  The
+      entries are sorted.
+
+      @param node                    The root directory
+      @param fslist                  List to put the files into
+      @param filter                  Filter for the files (which are added)
+      @param includeParentDirectory  Whether to add the parent of the root
+      @param isCancelled             Checked to cancel listing
+      @param onBatch                 Called per directory with new entries
+
+      @return  False if the root isn't a directory or listing was cancelled
+    */
+    bool getAllChildren(const FilesystemNode& node, FSList& fslist,
+                        const FilesystemNode::NameFilter& filter,
+                        bool includeParentDirectory,
+                        const FilesystemNode::CancelCheck& isCancelled,
+                        const FilesystemNode::BatchReceiver& onBatch);
+
+  private:
+    struct Directory {
+      // The stamp of the directory when it was read
+      uInt64 stamp{0};
+      bool hasStamp{false};
+
+      FSList files;
+      FSList subDirectories;
+    };
+
+    /**
+      Add the files of the given directory tree to the list.
+    */
+    bool addTree(const FilesystemNode& dir, FSList& fslist,
+                 const FilesystemNode::NameFilter& filter,
+                 const FilesystemNode::CancelCheck& isCancelled,
+                 const FilesystemNode::BatchReceiver& onBatch);
+
+    /**
+      Answer the entries of the given directory, reading them only if the
+      directory has changed.
+
+      @return  The entries, or nullptr if listing was cancelled
+    */
+    const Directory* directory(const FilesystemNode& dir,
+                               const FilesystemNode::CancelCheck& isCancelled);
+
+  private:
+    // The directories read so far, by path
+    std::unordered_map<string, Directory> myDirectories;
+
+  private:
+    // Following constructors and assignment operators not supported
+    LibraryIndex(const LibraryIndex&) = delete;
+    LibraryIndex(LibraryIndex&&) = delete;
+    LibraryIndex& operator=(const LibraryIndex&) = delete;
+    LibraryIndex& operator=(LibraryIndex&&) = delete;
+};
+
+#endif
@@ -15,6 +15,8 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <iomanip>
+
 #include "bspf.hxx"
 #include "Dialog.hxx"
 #include "FSNode.hxx"
@@ -92,8 +94,16 @@ LoggerDialog::LoggerDialog(OSystem& osystem, DialogContainer& parent,
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void LoggerDialog::loadConfig()
 {
-  StringParser parser(Logger::instance().logMessages());
-  myLogInfo->setList(parser.stringList());
+  // Messages may span several lines
+  StringList lines;
+  for(const auto& entry: Logger::instance().logEntries())
+  {
+    StringParser parser(entry.text);
+    const StringList& entryLines = parser.stringList();
+
+    lines.insert(lines.end(), entryLines.begin(), entryLines.end());
+  }
+  myLogInfo->setList(lines);
   myLogInfo->setSelected(0);
   myLogInfo->scrollToEnd();
 
@@ -119,8 +129,16 @@ void LoggerDialog::saveLogFile(const FilesystemNode& node)
 {
   try
   {
+    // Unlike the dialog, the file records when and at which level each
+    // message was logged
     stringstream out;
-    out << Logger::instance().logMessages();
+    for(const auto& entry: Logger::instance().logEntries())
+    {
+      const std::tm time = BSPF::localTime(entry.time);
+
+      out << std::put_time(&time, "%F %T") << " " << levelName(entry.level)
+          << " " << entry.text << "\n";
+    }
     node.write(out);
     instance().frameBuffer().showTextMessage("System log saved");
   }
@@ -130,6 +148,18 @@ void LoggerDialog::saveLogFile(const FilesystemNode& node)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const char* LoggerDialog::levelName(Logger::Level level)
+{
+  switch(level)
+  {
+    case Logger::Level::ERR:    return "ERROR";
+    case Logger::Level::INFO:   return "INFO ";
+    case Logger::Level::DEBUG:  return "DEBUG";
+    default:                    return "     ";
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void LoggerDialog::handleCommand(CommandSender* sender, int cmd,
                                  int data, int id)
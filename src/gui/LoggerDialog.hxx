@@ -24,6 +24,7 @@ class PopUpWidget;
 class StringListWidget;
 
 #include "Dialog.hxx"
+#include "Logger.hxx"
 #include "bspf.hxx"
 
 class LoggerDialog : public Dialog
@@ -38,6 +39,7 @@ class LoggerDialog : public Dialog
     void loadConfig() override;
     void saveConfig() override;
     void saveLogFile(const FilesystemNode& node);
+    static const char* levelName(Logger::Level level);
 
     void handleCommand(CommandSender* sender, int cmd, int data, int id) override;
 
@@ -0,0 +1,201 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include <algorithm>
+#include <iterator>
+
+#include "NameIndex.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void NameIndex::build(const FSList& list)
+{
+  myNames.clear();
+  myIsDirectory.clear();
+  myAll.clear();
+  myDirectories.clear();
+  myTrigrams.clear();
+
+  myNames.reserve(list.size());
+  myIsDirectory.reserve(list.size());
+  myAll.reserve(list.size());
+
+  for(uInt32 i = 0; i < list.size(); ++i)
+  {
+    const bool isDirectory = list[i].isDirectory();
+    string name = list[i].getName();
+    BSPF::toUpperCase(name);
+
+    myAll.push_back(i);
+    if(isDirectory)
+      myDirectories.push_back(i);
+    else
+      for(size_t pos = 0; pos + 3 <= name.length(); ++pos)
+      {
+        vector<uInt32>& entries = myTrigrams[trigram(&name[pos])];
+        if(entries.empty() || entries.back() != i)
+          entries.push_back(i);
+      }
+
+    myNames.push_back(std::move(name));
+    myIsDirectory.push_back(isDirectory);
+  }
+
+  myPattern.clear();
+  myMatches.clear();
+  myHasMatches = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const vector<uInt32>& NameIndex::find(const string& pattern)
+{
+  string pat = pattern;
+  BSPF::toUpperCase(pat);
+
+  if(pat.find_first_not_of('*') == string::npos)
+  {
+    myMatches = myAll;
+  }
+  else
+  {
+    vector<uInt32> from;
+
+    // Anything matching an extended pattern also matches the pattern itself
+    if(myHasMatches && pat.compare(0, myPattern.length(), myPattern) == 0)
+      from = std::move(myMatches);
+    else
+    {
+      const vector<uInt32>* entries = candidates(pat);
+
+      if(entries == nullptr)
+        from = myAll;
+      else
+        std::set_union(entries->cbegin(), entries->cend(),
+                       myDirectories.cbegin(), myDirectories.cend(),
+                       std::back_inserter(from));
+    }
+
+    myMatches.clear();
+    for(const uInt32 i: from)
+      if(myIsDirectory[i] || matchWithWildcards(myNames[i], pat))
+        myMatches.push_back(i);
+  }
+
+  myPattern = pat;
+  myHasMatches = true;
+
+  return myMatches;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const vector<uInt32>* NameIndex::candidates(const string& pattern) const
+{
+  static const vector<uInt32> NONE;
+  const vector<uInt32>* rarest = nullptr;
+
+  // Only the characters between wildcards have to appear in a name
+  size_t start = 0;
+  while(start < pattern.length())
+  {
+    size_t end = pattern.find_first_of("*?", start);
+    if(end == string::npos)
+      end = pattern.length();
+
+    for(size_t pos = start; pos + 3 <= end; ++pos)
+    {
+      const auto it = myTrigrams.find(trigram(&pattern[pos]));
+      if(it == myTrigrams.end())
+        return &NONE;
+
+      if(rarest == nullptr || it->second.size() < rarest->size())
+        rarest = &it->second;
+    }
+    start = end + 1;
+  }
+
+  return rarest;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool NameIndex::matches(const FilesystemNode& node, const string& pattern)
+{
+  if(pattern.empty() || node.isDirectory())
+    return true;
+
+  string name = node.getName();
+  string pat = pattern;
+
+  BSPF::toUpperCase(name);
+  BSPF::toUpperCase(pat);
+
+  return matchWithWildcards(name, pat);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t NameIndex::matchWithJoker(const string& str, const string& pattern)
+{
+  if(str.length() >= pattern.length())
+  {
+    // optimize a bit
+    if(pattern.find('?') != string::npos)
+    {
+      for(size_t pos = 0; pos < str.length() - pattern.length() + 1; ++pos)
+      {
+        bool found = true;
+
+        for(size_t i = 0; found && i < pattern.length(); ++i)
+          if(pattern[i] != str[pos + i] && pattern[i] != '?')
+            found = false;
+
+        if(found)
+          return pos;
+      }
+    }
+    else
+      return str.find(pattern);
+  }
+  return string::npos;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool NameIndex::matchWithWildcards(const string& str, const string& pattern)
+{
+  // remove leading and trailing '*'
+  const size_t first = pattern.find_first_not_of('*');
+  if(first == string::npos)
+    return true;
+
+  const string pat = pattern.substr(first, pattern.find_last_not_of('*') - first + 1);
+
+  // Search for first '*'
+  size_t pos = pat.find('*');
+
+  if(pos != string::npos)
+  {
+    // '*' found, split pattern into left and right part, search recursively
+    const string leftPat = pat.substr(0, pos);
+    const string rightPat = pat.substr(pos + 1);
+    size_t posLeft = matchWithJoker(str, leftPat);
+
+    if(posLeft != string::npos)
+      return matchWithWildcards(str.substr(pos + posLeft), rightPat);
+    else
+      return false;
+  }
+  // no further '*' found
+  return matchWithJoker(str, pat) != string::npos;
+}
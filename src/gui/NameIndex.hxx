@@ -0,0 +1,125 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef NAME_INDEX_HXX
+#define NAME_INDEX_HXX
+
+#include <unordered_map>
+
+#include "FSNode.hxx"
+#include "bspf.hxx"
+
+/**
+  An index of the names in a file list, which finds the entries matching
+  a filter pattern without reading the file system again.
+
+  Patterns match anywhere in a file name, ignoring case; '?' matches any
+  single character and '*' any number of characters.  Directories always
+  match, so that the list can still be navigated.
+
+  The names are kept in upper case, together with the entries containing
+  each trigram (three consecutive characters).  A pattern containing at
+  least one trigram outside of wildcards then only has to be checked
+  against the entries containing its rarest one.  If a pattern extends
+  the previous one (the usual case while typing), only the previous
+  matches are checked.
+
+  @author  Stella Team
+*/
+class NameIndex
+{
+  public:
+    NameIndex() = default;
+
+    /**
+      Index the entries of the given list, replacing the current ones.
+    */
+    void build(const FSList& list);
+
+    /**
+      Answer the indices (in list order) of the entries matching the
+      given pattern.
+    */
+    const vector<uInt32>& find(const string& pattern);
+
+    /**
+      Check whether the given entry matches the pattern, without using
+      an index.
+    */
+    static bool matches(const FilesystemNode& node, const string& pattern);
+
+  private:
+    using Trigram = uInt32;
+
+    /**
+      Search if string contains pattern including wildcard '*'
+      and '?' as joker; both are expected in upper case.
+
+      @param str      The searched string
+      @param pattern  The pattern to search for
+
+      @return True if pattern was found.
+    */
+    static bool matchWithWildcards(const string& str, const string& pattern);
+
+    /**
+      Search if string contains pattern including '?' as joker.
+
+      @param str      The searched string
+      @param pattern  The pattern to search for
+
+      @return Position of pattern in string.
+    */
+    static size_t matchWithJoker(const string& str, const string& pattern);
+
+    static Trigram trigram(const char* chars) {
+      return uInt8(chars[0]) | uInt8(chars[1]) << 8 | uInt8(chars[2]) << 16;
+    }
+
+    /**
+      Answer the entries which may match the given pattern, based on its
+      rarest trigram; nullptr if the pattern has no trigram.
+    */
+    const vector<uInt32>* candidates(const string& pattern) const;
+
+  private:
+    // Upper case names of all entries
+    StringList myNames;
+    vector<bool> myIsDirectory;
+
+    // The (sorted) indices of all entries, resp. of the directories
+    vector<uInt32> myAll;
+    vector<uInt32> myDirectories;
+
+    // For each trigram, the (sorted) indices of the entries containing it
+    std::unordered_map<Trigram, vector<uInt32>> myTrigrams;
+
+    // The last pattern and its matches
+    string myPattern;
+    vector<uInt32> myMatches;
+    bool myHasMatches{false};
+
+  private:
+    // Following constructors and assignment operators not supported
+    NameIndex(const NameIndex&) = delete;
+    NameIndex(NameIndex&&) = delete;
+    NameIndex& operator=(const NameIndex&) = delete;
+    NameIndex& operator=(NameIndex&&) = delete;
+};
+
+#endif
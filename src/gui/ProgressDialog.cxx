@@ -110,18 +110,23 @@ void ProgressDialog::setProgress(int progress)
   {
     myStepProgress = progress;
     mySlider->setValue(progress % (myFinish - myStart + 1));
-
-    // Since this dialog is usually called in a tight loop that doesn't
-    // yield, we need to manually:
-    // - tell the framebuffer that a redraw is necessary
-    // - poll the events
-    // This isn't really an ideal solution, since all redrawing and
-    // event handling is suspended until the dialog is closed
-    instance().frameBuffer().update();
-    instance().eventHandler().poll(TimerManager::getTicks());
+    refresh();
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ProgressDialog::refresh()
+{
+  // Since this dialog is usually called in a tight loop that doesn't
+  // yield, we need to manually:
+  // - tell the framebuffer that a redraw is necessary
+  // - poll the events
+  // This isn't really an ideal solution, since all redrawing and
+  // event handling is suspended until the dialog is closed
+  instance().frameBuffer().update();
+  instance().eventHandler().poll(TimerManager::getTicks());
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void ProgressDialog::incProgress()
 {
@@ -38,6 +38,10 @@ class ProgressDialog : public Dialog
     void resetProgress();
     void setProgress(int progress);
     void incProgress();
+
+    // Redraw the screen and handle pending events (e.g. 'Cancel'),
+    // without changing the progress
+    void refresh();
     bool isCancelled() const { return myIsCancelled; }
 
   private:
@@ -15,6 +15,9 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <mutex>
+#include <thread>
+
 #include "bspf.hxx"
 #include "Launcher.hxx"
 #include "Bankswitch.hxx"
@@ -24,6 +27,7 @@
 #include "ProgressDialog.hxx"
 #include "FSNode.hxx"
 #include "Font.hxx"
+#include "Logger.hxx"
 #include "MessageBox.hxx"
 #include "OSystem.hxx"
 #include "FrameBuffer.hxx"
@@ -31,6 +35,8 @@
 #include "Props.hxx"
 #include "PropsSet.hxx"
 #include "Settings.hxx"
+#include "ThreadPool.hxx"
+#include "TimerManager.hxx"
 #include "RomAuditDialog.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -127,43 +133,95 @@ void RomAuditDialog::auditRoms()
   progress.setRange(0, int(files.size()) - 1, 5);
   progress.open();
 
+  // Reading and hashing the files is done in parallel, in batches which
+  // are small enough to keep the progress updated.  Looking up the
+  // properties and renaming is done here, since the PropertiesSet is
+  // not thread-safe.
+  const uInt32 systemThreads = std::thread::hardware_concurrency();
+  Common::ThreadPool pool(systemThreads > 1
+                          ? std::min<uInt32>(systemThreads, MAX_THREADS) - 1 : 0);
+  const uInt32 batchSize = pool.threads() * FILES_PER_THREAD;
+
+  // All ZIP archives are accessed through a single shared handler
+  std::mutex zipMutex;
+
+  vector<string> md5s(batchSize), extensions(batchSize);
   Properties props;
-  uInt32 renamed = 0, notfound = 0;
-  for(uInt32 idx = 0; idx < files.size() && !progress.isCancelled(); ++idx)
+  uInt32 renamed = 0, notfound = 0, audited = 0;
+  const uInt64 startTime = TimerManager::getTicks();
+
+  for(uInt32 first = 0; first < files.size() && !progress.isCancelled(); first += batchSize)
   {
-    string extension;
-    if(files[idx].isFile() &&
-       Bankswitch::isValidRomName(files[idx], extension))
+    const uInt32 count = std::min<uInt32>(batchSize, uInt32(files.size()) - first);
+
+    for(uInt32 i = 0; i < count; ++i)
+    {
+      const FilesystemNode& file = files[first + i];
+
+      md5s[i] = "";
+      if(!file.isFile() || !Bankswitch::isValidRomName(file, extensions[i]))
+        extensions[i] = "";
+    }
+
+    // Calculate the MD5 so we can get the rest of the info
+    // from the PropertiesSet (stella.pro)
+    pool.run(count, [&](uInt32 i) {
+      const FilesystemNode& file = files[first + i];
+
+      if(extensions[i].empty())
+        return;
+
+      if(BSPF::containsIgnoreCase(file.getPath(), ".zip"))
+      {
+        std::lock_guard<std::mutex> lock(zipMutex);
+        md5s[i] = MD5::hash(file);
+      }
+      else
+        md5s[i] = MD5::hash(file);
+    });
+
+    for(uInt32 i = 0; i < count && !progress.isCancelled(); ++i)
     {
-      bool renameSucceeded = false;
+      FilesystemNode& file = files[first + i];
 
-      // Calculate the MD5 so we can get the rest of the info
-      // from the PropertiesSet (stella.pro)
-      const string& md5 = MD5::hash(files[idx]);
-      if(instance().propSet().getMD5(md5, props))
+      if(!extensions[i].empty())
       {
-        const string& name = props.get(PropType::Cart_Name);
+        bool renameSucceeded = false;
 
-        // Only rename the file if we found a valid properties entry
-        if(name != "" && name != files[idx].getName())
+        if(instance().propSet().getMD5(md5s[i], props))
         {
-          string newfile = node.getPath();
-          newfile.append(name).append(".").append(extension);
-          if(files[idx].getPath() != newfile && files[idx].rename(newfile))
-            renameSucceeded = true;
+          const string& name = props.get(PropType::Cart_Name);
+
+          // Only rename the file if we found a valid properties entry
+          if(name != "" && name != file.getName())
+          {
+            string newfile = node.getPath();
+            newfile.append(name).append(".").append(extensions[i]);
+            if(file.getPath() != newfile && file.rename(newfile))
+              renameSucceeded = true;
+          }
         }
+        if(renameSucceeded)
+          ++renamed;
+        else
+          ++notfound;
       }
-      if(renameSucceeded)
-        ++renamed;
-      else
-        ++notfound;
-    }
+      ++audited;
 
-    // Update the progress bar, indicating one more ROM has been processed
-    progress.incProgress();
+      // Update the progress bar, indicating one more ROM has been processed
+      progress.incProgress();
+    }
   }
   progress.close();
 
+  const double seconds = (TimerManager::getTicks() - startTime) / 1E6;
+  ostringstream msg;
+  msg << "ROM audit: " << audited << " files in " << std::fixed << std::setprecision(2)
+      << seconds << " seconds";
+  if(seconds > 0)
+    msg << " (" << std::setprecision(0) << (audited / seconds) << " files/sec)";
+  Logger::info(msg.str());
+
   myResults1->setText(std::to_string(renamed));
   myResults2->setText(std::to_string(notfound));
 }
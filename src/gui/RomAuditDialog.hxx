@@ -44,6 +44,12 @@ class RomAuditDialog : public Dialog
     void handleCommand(CommandSender* sender, int cmd, int data, int id) override;
 
   private:
+    // Upper limit for the threads reading and hashing ROMs; beyond this,
+    // the audit is limited by the disk anyway
+    static constexpr uInt32 MAX_THREADS = 8;
+    // The number of files each thread processes between progress updates
+    static constexpr uInt32 FILES_PER_THREAD = 16;
+
     enum {
       kChooseAuditDirCmd = 'RAsl', // audit dir select
       kConfirmAuditCmd   = 'RAcf'  // confirm rom audit
@@ -24,10 +24,13 @@
 #include "ControllerDetector.hxx"
 #include "Bankswitch.hxx"
 #include "CartDetector.hxx"
+#include "RomSignatures.hxx"
 #include "Logger.hxx"
 #include "Props.hxx"
 #include "PNGLibrary.hxx"
 #include "PropsSet.hxx"
+#include "RomMetadataCache.hxx"
+#include "RomPrefetcher.hxx"
 #include "Rect.hxx"
 #include "Widget.hxx"
 #include "RomInfoWidget.hxx"
@@ -79,10 +82,24 @@ void RomInfoWidget::reloadProperties(const FilesystemNode& node)
   // The ROM may have changed since we were last in the browser, either
   // by saving a different image or through a change in video renderer,
   // so we reload the properties
+#ifdef PNG_SUPPORT
+  if(myPrefetcher)
+    myPrefetcher->clearSnapshots();
+#endif
   if(myHaveProperties)
     parseProperties(node);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomInfoWidget::updateSnapshot()
+{
+  if(myHaveProperties && mySnapshotPending)
+  {
+    loadSnapshot();
+    setDirty();
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void RomInfoWidget::parseProperties(const FilesystemNode& node)
 {
@@ -103,29 +120,9 @@ void RomInfoWidget::parseProperties(const FilesystemNode& node)
   }
 
   // Initialize to empty properties entry
-  mySurfaceErrorMsg = "";
-  mySurfaceIsValid = false;
   myRomInfo.clear();
 
-#ifdef PNG_SUPPORT
-  // Get a valid filename representing a snapshot file for this rom
-  const string& filename = instance().snapshotLoadDir().getPath() +
-      myProperties.get(PropType::Cart_Name) + ".png";
-
-  // Read the PNG file
-  mySurfaceIsValid = loadPng(filename);
-
-  // Try to load a default image if not ROM image exists
-  if(!mySurfaceIsValid)
-  {
-    mySurfaceIsValid = loadPng(instance().snapshotLoadDir().getPath() +
-                               "default_snapshot.png");
-  }
-#else
-  mySurfaceErrorMsg = "PNG image loading not supported";
-#endif
-  if(mySurface)
-    mySurface->setVisible(mySurfaceIsValid);
+  loadSnapshot();
 
   myUrl = myProperties.get(PropType::Cart_Url);
 
@@ -150,30 +147,58 @@ void RomInfoWidget::parseProperties(const FilesystemNode& node)
   Controller::Type leftType = Controller::getType(left);
   Controller::Type rightType = Controller::getType(right);
   string bsDetected = myProperties.get(PropType::Cart_Type);
-  try
-  {
-    ByteBuffer image;
-    string md5 = "";  size_t size = 0;
 
-    if(node.exists() && !node.isDirectory() &&
-      (image = instance().openROM(node, md5, size)) != nullptr)
+  // The autodetection results are cached, so the ROM doesn't have to be
+  // read again each time it is selected ('rominfo' always redetects, and
+  // reports inconsistencies with the properties)
+  RomMetadataCache::Metadata metadata;
+  const bool romInfo = instance().settings().getBool("rominfo");
+  const bool cached = instance().romCache().get(node, metadata) &&
+      !metadata.type.empty() && !metadata.leftController.empty() &&
+      !metadata.rightController.empty();
+
+  if(!cached || romInfo)
+  {
+    try
     {
-      Logger::debug(myProperties.get(PropType::Cart_Name) + ":");
-      left = ControllerDetector::detectName(image, size, leftType,
-          !swappedPorts ? Controller::Jack::Left : Controller::Jack::Right,
-          instance().settings());
-      right = ControllerDetector::detectName(image, size, rightType,
-          !swappedPorts ? Controller::Jack::Right : Controller::Jack::Left,
-          instance().settings());
-      if (bsDetected == "AUTO")
-        bsDetected = Bankswitch::typeToName(CartDetector::autodetectType(image, size));
+      ByteBuffer image;
+      string md5 = "";  size_t size = 0;
+
+      if(node.exists() && !node.isDirectory() &&
+        (image = instance().openROM(node, md5, size)) != nullptr)
+      {
+        Logger::debug(myProperties.get(PropType::Cart_Name) + ":");
+        metadata.md5 = md5;
+        // One pass over the image for the controllers and the cart type
+        const RomSignatures signatures(image.get(), size);
+        metadata.leftController = ControllerDetector::detectName(signatures,
+            romInfo ? (!swappedPorts ? leftType : rightType) : Controller::Type::Unknown,
+            Controller::Jack::Left, instance().settings());
+        metadata.rightController = ControllerDetector::detectName(signatures,
+            romInfo ? (!swappedPorts ? rightType : leftType) : Controller::Type::Unknown,
+            Controller::Jack::Right, instance().settings());
+        metadata.type = Bankswitch::typeToName(
+            CartDetector::autodetectType(image, size, signatures));
+        instance().romCache().update(node, metadata);
+      }
+    }
+    catch(const runtime_error&)
+    {
+      // Do nothing; we simply don't update the controllers if openROM
+      // failed for any reason
+      left = right = "";
     }
   }
-  catch(const runtime_error&)
+
+  if(!metadata.type.empty())
   {
-    // Do nothing; we simply don't update the controllers if openROM
-    // failed for any reason
-    left = right = "";
+    // Autodetection only applies to controllers and types not given by the properties
+    if(leftType == Controller::Type::Unknown || romInfo)
+      left = !swappedPorts ? metadata.leftController : metadata.rightController;
+    if(rightType == Controller::Type::Unknown || romInfo)
+      right = !swappedPorts ? metadata.rightController : metadata.leftController;
+    if (bsDetected == "AUTO")
+      bsDetected = metadata.type;
   }
   if(left != "" && right != "")
     myRomInfo.push_back("Controllers: " + (left + " (left), " + right + " (right)"));
@@ -184,13 +209,60 @@ void RomInfoWidget::parseProperties(const FilesystemNode& node)
   setDirty();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomInfoWidget::loadSnapshot()
+{
+  mySurfaceErrorMsg = "";
+  mySurfaceIsValid = mySnapshotPending = false;
+
+#ifdef PNG_SUPPORT
+  // Get a valid filename representing a snapshot file for this rom
+  const string& filename = instance().snapshotLoadDir().getPath() +
+      myProperties.get(PropType::Cart_Name) + ".png";
+
+  // Read the PNG file
+  mySurfaceIsValid = loadPng(filename);
+
+  // Try to load a default image if not ROM image exists
+  if(!mySurfaceIsValid && !mySnapshotPending)
+  {
+    mySurfaceIsValid = loadPng(instance().snapshotLoadDir().getPath() +
+                               "default_snapshot.png");
+  }
+#else
+  mySurfaceErrorMsg = "PNG image loading not supported";
+#endif
+  if(mySurface)
+    mySurface->setVisible(mySurfaceIsValid);
+}
+
 #ifdef PNG_SUPPORT
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool RomInfoWidget::loadPng(const string& filename)
 {
   try
   {
-    instance().png().loadImage(filename, *mySurface);
+    if(myPrefetcher)
+    {
+      RomPrefetcher::Snapshot image;
+
+      switch(myPrefetcher->snapshot(filename, image, mySurfaceErrorMsg))
+      {
+        case RomPrefetcher::SnapshotState::pending:
+          // Shown by updateSnapshot() once decoded
+          mySnapshotPending = true;
+          return false;
+
+        case RomPrefetcher::SnapshotState::failed:
+          return false;
+
+        case RomPrefetcher::SnapshotState::loaded:
+          instance().png().loadImage(*image, *mySurface);
+          break;
+      }
+    }
+    else
+      instance().png().loadImage(filename, *mySurface);
 
     // Scale surface to available image area
     const Common::Rect& src = mySurface->srcRect();
@@ -20,6 +20,7 @@
 
 class FBSurface;
 class Properties;
+class RomPrefetcher;
 namespace Common {
   struct Size;
 }
@@ -44,6 +45,17 @@ class RomInfoWidget : public Widget, public CommandSender
     void clearProperties();
     void reloadProperties(const FilesystemNode& node);
 
+    /**
+      Snapshots are decoded by the given prefetcher (if any) in the
+      background, instead of blocking the UI.
+    */
+    void setPrefetcher(RomPrefetcher* prefetcher) { myPrefetcher = prefetcher; }
+
+    /**
+      Show the snapshot, if it was waiting to be decoded by the prefetcher.
+    */
+    void updateSnapshot();
+
     const string& getUrl() const { return myUrl; }
 
   protected:
@@ -52,6 +64,7 @@ class RomInfoWidget : public Widget, public CommandSender
 
   private:
     void parseProperties(const FilesystemNode& node);
+    void loadSnapshot();
   #ifdef PNG_SUPPORT
     bool loadPng(const string& filename);
   #endif
@@ -81,6 +94,12 @@ class RomInfoWidget : public Widget, public CommandSender
     // How much space available for the PNG image
     Common::Size myAvail;
 
+    // Decodes the PNG images in the background (optional)
+    RomPrefetcher* myPrefetcher{nullptr};
+
+    // Indicates if the PNG image is still being decoded by the prefetcher
+    bool mySnapshotPending{false};
+
   private:
     // Following constructors and assignment operators not supported
     RomInfoWidget() = delete;
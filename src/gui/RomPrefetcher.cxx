@@ -0,0 +1,336 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "Bankswitch.hxx"
+#include "CartDetector.hxx"
+#include "ControllerDetector.hxx"
+#include "RomSignatures.hxx"
+#include "MD5.hxx"
+#include "OSystem.hxx"
+#include "RomMetadataCache.hxx"
+#include "Settings.hxx"
+#include "TraceRecorder.hxx"
+#include "RomPrefetcher.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomPrefetcher::RomPrefetcher(OSystem& osystem)
+  : myCache{osystem.romCache()},
+    mySettings{make_unique<Settings>()}
+{
+  myThread = std::thread(&RomPrefetcher::threadMain, this);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomPrefetcher::~RomPrefetcher()
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myQuit = true;
+  }
+  myWakeupCondition.notify_one();
+
+  myThread.join();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomPrefetcher::setList(const FSList& list)
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    myList.clear();
+    myList.reserve(list.size());
+    for(const auto& node : list)
+      myList.push_back(!node.isDirectory() && Bankswitch::isValidRomName(node) &&
+                       !BSPF::containsIgnoreCase(node.getPath(), ".zip")
+                       ? node.getPath() : EmptyString);
+
+    myAnalyzed.clear();
+
+    // Wait for the cursor before walking the window
+    myCursor = 0;
+    myWindowStep = WINDOW_SIZE * 2 + 1;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomPrefetcher::setCursor(uInt32 index)
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    myCursor = index;
+    myWindowStep = 0;
+  }
+  myWakeupCondition.notify_one();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RomPrefetcher::requestRom(const FilesystemNode& node)
+{
+  if(node.isDirectory() || !Bankswitch::isValidRomName(node) ||
+     BSPF::containsIgnoreCase(node.getPath(), ".zip"))
+    return false;
+
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    myRomRequest = node.getPath();
+  }
+  myWakeupCondition.notify_one();
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RomPrefetcher::isPending(const string& path)
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+
+  return myRomRequest == path || myActiveRom == path;
+}
+
+#ifdef PNG_SUPPORT
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomPrefetcher::SnapshotState RomPrefetcher::snapshot(const string& filename,
+    Snapshot& image, string& error)
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    const auto iter = mySnapshotIndex.find(filename);
+    if(iter != mySnapshotIndex.end())
+    {
+      // Mark as most recently used
+      mySnapshots.splice(mySnapshots.begin(), mySnapshots, iter->second);
+
+      const SnapshotEntry& entry = iter->second->second;
+      image = entry.image;
+      error = entry.error;
+
+      return entry.state;
+    }
+    mySnapshotRequest = filename;
+  }
+  myWakeupCondition.notify_one();
+
+  return SnapshotState::pending;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomPrefetcher::prefetchSnapshots(const StringList& filenames)
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    mySnapshotPrefetch = filenames;
+  }
+  myWakeupCondition.notify_one();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomPrefetcher::clearSnapshots()
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+
+  mySnapshots.clear();
+  mySnapshotIndex.clear();
+  ++mySnapshotGeneration;
+}
+#endif
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RomPrefetcher::changed()
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+
+  const bool changed = myChanged;
+  myChanged = false;
+
+  return changed;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomPrefetcher::threadMain()
+{
+  if(TraceRecorder::enabled()) TraceRecorder::instance().setThreadName("Prefetch");
+
+  std::unique_lock<std::mutex> lock(myMutex);
+
+  for(;;)
+  {
+    myWakeupCondition.wait(lock, [this]() { return myQuit || hasWork(); });
+    if(myQuit)
+      return;
+
+    if(!myRomRequest.empty())
+    {
+      myActiveRom = myRomRequest;
+      myRomRequest.clear();
+      myAnalyzed.insert(myActiveRom);
+
+      lock.unlock();
+      analyzeRom(myActiveRom);
+      lock.lock();
+
+      myActiveRom.clear();
+      myChanged = true;
+      continue;
+    }
+  #ifdef PNG_SUPPORT
+    if(!mySnapshotRequest.empty())
+    {
+      const string filename = mySnapshotRequest;
+      mySnapshotRequest.clear();
+
+      decodeSnapshot(filename, lock);
+      myChanged = true;
+      continue;
+    }
+    if(!mySnapshotPrefetch.empty())
+    {
+      const string filename = mySnapshotPrefetch.front();
+      mySnapshotPrefetch.erase(mySnapshotPrefetch.begin());
+
+      decodeSnapshot(filename, lock);
+      continue;
+    }
+  #endif
+    if(nextWindowEntry(myActiveRom))
+    {
+      lock.unlock();
+      analyzeRom(myActiveRom);
+      lock.lock();
+
+      myActiveRom.clear();
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RomPrefetcher::hasWork() const
+{
+#ifdef PNG_SUPPORT
+  if(!mySnapshotRequest.empty() || !mySnapshotPrefetch.empty())
+    return true;
+#endif
+
+  return !myRomRequest.empty() ||
+         (!myList.empty() && myWindowStep <= WINDOW_SIZE * 2);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RomPrefetcher::nextWindowEntry(string& path)
+{
+  while(myWindowStep <= WINDOW_SIZE * 2)
+  {
+    // Alternate between the entries ahead of and behind the cursor
+    const uInt32 step = myWindowStep++;
+    const uInt32 distance = (step + 1) / 2;
+    const Int64 index = (step & 1) ? Int64(myCursor) + distance
+                                   : Int64(myCursor) - distance;
+
+    if(index < 0 || index >= Int64(myList.size()))
+      continue;
+
+    const string& entry = myList[index];
+    if(!entry.empty() && myAnalyzed.insert(entry).second)
+    {
+      path = entry;
+      return true;
+    }
+  }
+  return false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomPrefetcher::analyzeRom(const string& path)
+{
+  const FilesystemNode node(path);
+  RomMetadataCache::Metadata metadata;
+
+  if(myCache.get(node, metadata) && !metadata.md5.empty() && !metadata.type.empty() &&
+     !metadata.leftController.empty() && !metadata.rightController.empty())
+    return;
+
+  TraceRecorder::Scope traceScope("PrefetchRom", "launcher");
+  try
+  {
+    ByteBuffer image;
+    const size_t size = node.read(image);
+
+    // Same as done by the launcher when the ROM is selected
+    metadata.md5 = MD5::hash(image, size);
+    const RomSignatures signatures(image.get(), size);
+    metadata.leftController = ControllerDetector::detectName(signatures,
+        Controller::Type::Unknown, Controller::Jack::Left, *mySettings);
+    metadata.rightController = ControllerDetector::detectName(signatures,
+        Controller::Type::Unknown, Controller::Jack::Right, *mySettings);
+    metadata.type = Bankswitch::typeToName(
+        CartDetector::autodetectType(image, size, signatures));
+    myCache.update(node, metadata);
+  }
+  catch(const runtime_error&)
+  {
+    // Do nothing; the launcher will read the ROM itself
+  }
+}
+
+#ifdef PNG_SUPPORT
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomPrefetcher::decodeSnapshot(const string& filename,
+                                   std::unique_lock<std::mutex>& lock)
+{
+  if(mySnapshotIndex.find(filename) != mySnapshotIndex.end())
+    return;
+
+  const uInt32 generation = mySnapshotGeneration;
+  SnapshotEntry entry;
+
+  lock.unlock();
+  {
+    TraceRecorder::Scope traceScope("PrefetchSnapshot", "launcher");
+    try
+    {
+      auto image = make_shared<PNGLibrary::ImageData>();
+
+      PNGLibrary::decodeImage(filename, *image);
+      entry.image = image;
+      entry.state = SnapshotState::loaded;
+    }
+    catch(const runtime_error& e)
+    {
+      entry.error = e.what();
+      entry.state = SnapshotState::failed;
+    }
+  }
+  lock.lock();
+
+  // The snapshots may have been cleared in the meantime
+  if(generation != mySnapshotGeneration)
+    return;
+
+  mySnapshots.emplace_front(filename, entry);
+  mySnapshotIndex[filename] = mySnapshots.begin();
+
+  while(mySnapshots.size() > MAX_SNAPSHOTS)
+  {
+    mySnapshotIndex.erase(mySnapshots.back().first);
+    mySnapshots.pop_back();
+  }
+}
+#endif
@@ -0,0 +1,194 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef ROM_PREFETCHER_HXX
+#define ROM_PREFETCHER_HXX
+
+class OSystem;
+class RomMetadataCache;
+class Settings;
+
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "FSNode.hxx"
+#include "PNGLibrary.hxx"
+#include "bspf.hxx"
+
+/**
+  Reads and analyzes the ROMs around the current selection of the launcher
+  in a background thread, and decodes their snapshots.
+
+  ROMs are hashed and autodetected in the same way as when they are
+  selected, and the results are stored in the ROM metadata cache, where
+  the launcher picks them up later.  Explicit requests (the currently
+  selected ROM and its snapshot) always take precedence over walking the
+  entries ahead of and behind the selection.
+
+  ROMs inside ZIP archives are skipped, since all ZIP archives are
+  accessed through a single shared handler.
+
+  @author  Stella Team
+*/
+class RomPrefetcher
+{
+  public:
+  #ifdef PNG_SUPPORT
+    using Snapshot = shared_ptr<const PNGLibrary::ImageData>;
+
+    enum class SnapshotState { pending, loaded, failed };
+  #endif
+
+  public:
+    explicit RomPrefetcher(OSystem& osystem);
+    ~RomPrefetcher();
+
+    /**
+      Set the entries of a new directory listing.  Prefetching starts once
+      the cursor is set.
+
+      @param list  The entries of the listing, in the order displayed
+    */
+    void setList(const FSList& list);
+
+    /**
+      Move the center of the prefetch window.
+
+      @param index  The index of the selected entry in the listing
+    */
+    void setCursor(uInt32 index);
+
+    /**
+      Analyze the given ROM next.  Once this is done, the results are
+      available from the metadata cache, and changed() returns true.
+
+      @return  False if the ROM cannot be handled in the background
+    */
+    bool requestRom(const FilesystemNode& node);
+
+    /**
+      Answer whether the given ROM is still waiting to be analyzed.
+    */
+    bool isPending(const string& path);
+
+  #ifdef PNG_SUPPORT
+    /**
+      Get a decoded snapshot.  If it has not been decoded yet, it is decoded
+      next, and changed() returns true once this is done.
+
+      @param filename  The filename of the PNG image
+      @param image     Receives the image data, if loaded
+      @param error     Receives the error message, if failed
+
+      @return  The state of the snapshot
+    */
+    SnapshotState snapshot(const string& filename, Snapshot& image, string& error);
+
+    /**
+      Decode the given snapshots when idle, in the given order.
+    */
+    void prefetchSnapshots(const StringList& filenames);
+
+    /**
+      Forget all decoded snapshots (e.g. because new ones may have been saved).
+    */
+    void clearSnapshots();
+  #endif
+
+    /**
+      Answer whether any explicit request was finished since the last call.
+    */
+    bool changed();
+
+  private:
+    void threadMain();
+
+    // Whether the worker has anything to do; called with the lock held
+    bool hasWork() const;
+
+    // Get the next entry of the prefetch window; called with the lock held
+    bool nextWindowEntry(string& path);
+
+    // Read, hash and autodetect the given ROM, and update the cache
+    void analyzeRom(const string& path);
+
+  #ifdef PNG_SUPPORT
+    // Decode the given snapshot, unless already done; called with the lock held
+    void decodeSnapshot(const string& filename, std::unique_lock<std::mutex>& lock);
+  #endif
+
+  private:
+    // The number of entries prefetched ahead of and behind the selection
+    static constexpr uInt32 WINDOW_SIZE = 32;
+
+    // The maximum number of decoded snapshots held in memory
+    static constexpr size_t MAX_SNAPSHOTS = 8;
+
+    RomMetadataCache& myCache;
+
+    // Autodetection is done with the default settings, since the shared
+    // settings must not be accessed from the worker
+    unique_ptr<Settings> mySettings;
+
+    std::thread myThread;
+    std::mutex myMutex;
+    std::condition_variable myWakeupCondition;
+    bool myQuit{false};
+
+    // The paths of the entries which can be prefetched (empty otherwise)
+    StringList myList;
+    uInt32 myCursor{0};
+    // The next step of walking the window around the cursor
+    uInt32 myWindowStep{0};
+    // ROMs that were already analyzed for the current listing
+    std::unordered_set<string> myAnalyzed;
+
+    string myRomRequest;
+    // The ROM currently being analyzed; only changed by the worker
+    string myActiveRom;
+    bool myChanged{false};
+
+  #ifdef PNG_SUPPORT
+    struct SnapshotEntry {
+      SnapshotState state{SnapshotState::pending};
+      Snapshot image;
+      string error;
+    };
+    // The decoded snapshots, the most recently used at the front
+    std::list<std::pair<string, SnapshotEntry>> mySnapshots;
+    std::unordered_map<string, decltype(mySnapshots)::iterator> mySnapshotIndex;
+
+    string mySnapshotRequest;
+    StringList mySnapshotPrefetch;
+    // Incremented whenever the decoded snapshots are cleared
+    uInt32 mySnapshotGeneration{0};
+  #endif
+
+  private:
+    // Following constructors and assignment operators not supported
+    RomPrefetcher() = delete;
+    RomPrefetcher(const RomPrefetcher&) = delete;
+    RomPrefetcher(RomPrefetcher&&) = delete;
+    RomPrefetcher& operator=(const RomPrefetcher&) = delete;
+    RomPrefetcher& operator=(RomPrefetcher&&) = delete;
+};
+
+#endif
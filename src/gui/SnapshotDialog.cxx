@@ -43,7 +43,7 @@ SnapshotDialog::SnapshotDialog(OSystem& osystem, DialogContainer& parent,
   ButtonWidget* b;
 
   // Set real dimensions
-  setSize(64 * fontWidth + HBORDER * 2, 9 * (lineHeight + VGAP) + VBORDER + _th, max_w, max_h);
+  setSize(64 * fontWidth + HBORDER * 2, 10 * (lineHeight + VGAP) + VBORDER + _th, max_w, max_h);
 
   xpos = HBORDER;  ypos = VBORDER + _th;
 
@@ -89,6 +89,14 @@ SnapshotDialog::SnapshotDialog(OSystem& osystem, DialogContainer& parent,
       "Create pixel-exact image (no zoom/post-processing)");
   wid.push_back(mySnap1x);
 
+  // Record continuous snapshots as video
+  ypos += lineHeight + VGAP;
+  mySnapVideo = new CheckboxWidget(this, font, xpos, ypos,
+      "Record continuous snapshots as Y4M video");
+  mySnapVideo->setToolTip("Write all continuous snapshots into one\n"
+                          "pixel-exact, uncompressed video file.");
+  wid.push_back(mySnapVideo);
+
   // Add Defaults, OK and Cancel buttons
   addDefaultsOKCancelBGroup(wid, font);
 
@@ -106,6 +114,7 @@ void SnapshotDialog::loadConfig()
   mySnapName->setState(instance().settings().getString("snapname") == "rom");
   mySnapSingle->setState(settings.getBool("sssingle"));
   mySnap1x->setState(settings.getBool("ss1x"));
+  mySnapVideo->setState(settings.getString("ssformat") == "y4m");
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -116,6 +125,7 @@ void SnapshotDialog::saveConfig()
   instance().settings().setValue("snapname", mySnapName->getState() ? "rom" : "int");
   instance().settings().setValue("sssingle", mySnapSingle->getState());
   instance().settings().setValue("ss1x", mySnap1x->getState());
+  instance().settings().setValue("ssformat", mySnapVideo->getState() ? "y4m" : "png");
 
   // Flush changes to disk and inform the OSystem
   instance().saveConfig();
@@ -130,6 +140,7 @@ void SnapshotDialog::setDefaults()
   mySnapName->setState(false);
   mySnapSingle->setState(false);
   mySnap1x->setState(false);
+  mySnapVideo->setState(false);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
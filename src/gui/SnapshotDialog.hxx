@@ -57,6 +57,7 @@ class SnapshotDialog : public Dialog
 
     CheckboxWidget* mySnapSingle{nullptr};
     CheckboxWidget* mySnap1x{nullptr};
+    CheckboxWidget* mySnapVideo{nullptr};
 
   private:
     // Following constructors and assignment operators not supported
@@ -40,7 +40,7 @@
 namespace GUI {
 
 // Font character bitmap data.
-static const uInt16 stella12x24t_font_bits[] = {  // NOLINT : too complicated to convert
+inline constexpr uInt16 stella12x24t_font_bits[] = {  // NOLINT : too complicated to convert
 
 /* Character 28 (0x1c):
    width 12
@@ -5588,7 +5588,7 @@ static const uInt16 stella12x24t_font_bits[] = {  // NOLINT : too complicated to
 };
 
 /* Exported structure definition. */
-static const FontDesc stella12x24tDesc = {
+inline constexpr FontData stella12x24tData = {
   "ter-u24b",
   12,
   24,
@@ -5604,6 +5604,13 @@ static const FontDesc stella12x24tDesc = {
   sizeof(stella12x24t_font_bits)/sizeof(uInt16)
 };
 
+// The compressed glyphs; the bitmaps above are only used at compile time
+inline constexpr auto stella12x24t_font_glyphs =
+  FontPacker::pack<FontPacker::size(stella12x24tData)>(stella12x24tData);
+
+inline constexpr FontDesc stella12x24tDesc =
+  FontPacker::desc(stella12x24tData, stella12x24t_font_glyphs.data());
+
 } // End of namespace GUI
 
 #endif
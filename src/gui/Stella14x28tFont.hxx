@@ -40,7 +40,7 @@
 namespace GUI {
 
 // Font character bitmap data.
-static const uInt16 stella14x28t_font_bits[] = {  // NOLINT : too complicated to convert
+inline constexpr uInt16 stella14x28t_font_bits[] = {  // NOLINT : too complicated to convert
 
 /* Character 28 (0x1c):
    width 14
@@ -6381,7 +6381,7 @@ static const uInt16 stella14x28t_font_bits[] = {  // NOLINT : too complicated to
 };
 
 /* Exported structure definition. */
-static const FontDesc stella14x28tDesc = {
+inline constexpr FontData stella14x28tData = {
   "ter-u28b",
   14,
   28,
@@ -6397,6 +6397,13 @@ static const FontDesc stella14x28tDesc = {
   sizeof(stella14x28t_font_bits)/sizeof(uInt16)
 };
 
+// The compressed glyphs; the bitmaps above are only used at compile time
+inline constexpr auto stella14x28t_font_glyphs =
+  FontPacker::pack<FontPacker::size(stella14x28tData)>(stella14x28tData);
+
+inline constexpr FontDesc stella14x28tDesc =
+  FontPacker::desc(stella14x28tData, stella14x28t_font_glyphs.data());
+
 } // End of namespace GUI
 
 #endif
@@ -40,7 +40,7 @@
 namespace GUI {
 
 // Font character bitmap data.
-static const uInt16 stella16x32t_font_bits[] = {  // NOLINT : too complicated to convert
+inline constexpr uInt16 stella16x32t_font_bits[] = {  // NOLINT : too complicated to convert
 
 /* Character 28 (0x1c):
    width 16
@@ -7172,7 +7172,7 @@ static const uInt16 stella16x32t_font_bits[] = {  // NOLINT : too complicated to
 };
 
 /* Exported structure definition. */
-static const FontDesc stella16x32tDesc = {
+inline constexpr FontData stella16x32tData = {
   "ter-u32b",
   16,
   32,
@@ -7188,6 +7188,13 @@ static const FontDesc stella16x32tDesc = {
   sizeof(stella16x32t_font_bits)/sizeof(uInt16)
 };
 
+// The compressed glyphs; the bitmaps above are only used at compile time
+inline constexpr auto stella16x32t_font_glyphs =
+  FontPacker::pack<FontPacker::size(stella16x32tData)>(stella16x32tData);
+
+inline constexpr FontDesc stella16x32tDesc =
+  FontPacker::desc(stella16x32tData, stella16x32t_font_glyphs.data());
+
 } // End of namespace GUI
 
 #endif
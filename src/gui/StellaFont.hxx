@@ -40,7 +40,7 @@
 namespace GUI {
 
 // Font character bitmap data.
-static const uInt16 stella_font_bits[] = {  // NOLINT : too complicated to convert
+inline constexpr uInt16 stella_font_bits[] = {  // NOLINT : too complicated to convert
 
   /* Character 29 (0x1d):
   width 6
@@ -2788,7 +2788,7 @@ static const uInt16 stella_font_bits[] = {  // NOLINT : too complicated to conve
 };
 
 /* Exported structure definition. */
-static const FontDesc stellaDesc = {
+inline constexpr FontData stellaData = {
   "6x10-ISO8859-1",
   6,
   10,
@@ -2804,6 +2804,13 @@ static const FontDesc stellaDesc = {
   sizeof(stella_font_bits)/sizeof(uInt16)
 };
 
+// The compressed glyphs; the bitmaps above are only used at compile time
+inline constexpr auto stella_font_glyphs =
+  FontPacker::pack<FontPacker::size(stellaData)>(stellaData);
+
+inline constexpr FontDesc stellaDesc =
+  FontPacker::desc(stellaData, stella_font_glyphs.data());
+
 } // End of namespace GUI
 
 #endif
@@ -40,7 +40,7 @@
 namespace GUI {
 
 // Font character bitmap data.
-static const uInt16 stellaLarge_font_bits[] = {  // NOLINT : too complicated to convert
+inline constexpr uInt16 stellaLarge_font_bits[] = {  // NOLINT : too complicated to convert
 
   /* MODIFIED
   Character 28 (0x1c):
@@ -4802,7 +4802,7 @@ static const uInt16 stellaLarge_font_bits[] = {  // NOLINT : too complicated to
 };
 
 /* Exported structure definition. */
-static const FontDesc stellaLargeDesc = {
+inline constexpr FontData stellaLargeData = {
   "10x20-ISO8859-1",
   10,
   20,
@@ -4818,6 +4818,13 @@ static const FontDesc stellaLargeDesc = {
   sizeof(stellaLarge_font_bits)/sizeof(uInt16)
 };
 
+// The compressed glyphs; the bitmaps above are only used at compile time
+inline constexpr auto stellaLarge_font_glyphs =
+  FontPacker::pack<FontPacker::size(stellaLargeData)>(stellaLargeData);
+
+inline constexpr FontDesc stellaLargeDesc =
+  FontPacker::desc(stellaLargeData, stellaLarge_font_glyphs.data());
+
 } // End of namespace GUI
 
 #endif
@@ -40,7 +40,7 @@
 namespace GUI {
 
 // Font character bitmap data.
-static const uInt16 stellaMedium_font_bits[] = {  // NOLINT : too complicated to convert
+inline constexpr uInt16 stellaMedium_font_bits[] = {  // NOLINT : too complicated to convert
 
 
   /* MODIFIED
@@ -4407,7 +4407,7 @@ static const uInt16 stellaMedium_font_bits[] = {  // NOLINT : too complicated to
 };
 
 /* Exported structure definition. */
-static const FontDesc stellaMediumDesc = {
+inline constexpr FontData stellaMediumData = {
   "9x18B-ISO8859-1",
   9,
   18,
@@ -4423,6 +4423,13 @@ static const FontDesc stellaMediumDesc = {
   sizeof(stellaMedium_font_bits)/sizeof(uInt16)
 };
 
+// The compressed glyphs; the bitmaps above are only used at compile time
+inline constexpr auto stellaMedium_font_glyphs =
+  FontPacker::pack<FontPacker::size(stellaMediumData)>(stellaMediumData);
+
+inline constexpr FontDesc stellaMediumDesc =
+  FontPacker::desc(stellaMediumData, stellaMedium_font_glyphs.data());
+
 } // End of namespace GUI
 
 #endif
@@ -541,7 +541,7 @@ void StellaSettingsDialog::updateControllerStates()
     if(instance().hasConsole())
       label = (instance().console().leftController().name()) + " detected";
     else if(autoDetect)
-      label = ControllerDetector::detectName(image, size, type,
+      label = ControllerDetector::detectName(image.get(), size, type,
                                              Controller::Jack::Left,
                                              instance().settings()) + " detected";
   }
@@ -555,7 +555,7 @@ void StellaSettingsDialog::updateControllerStates()
     if(instance().hasConsole())
       label = (instance().console().rightController().name()) + " detected";
     else if(autoDetect)
-      label = ControllerDetector::detectName(image, size, type,
+      label = ControllerDetector::detectName(image.get(), size, type,
                                              Controller::Jack::Right,
                                              instance().settings()) + " detected";
   }
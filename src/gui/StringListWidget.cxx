@@ -50,6 +50,14 @@ void StringListWidget::setList(const StringList& list)
   ListWidget::recalc();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StringListWidget::setList(StringList&& list)
+{
+  _list = std::move(list);
+
+  ListWidget::recalc();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int StringListWidget::getToolTipIndex(const Common::Point& pos) const
 {
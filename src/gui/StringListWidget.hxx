@@ -30,6 +30,7 @@ class StringListWidget : public ListWidget
     ~StringListWidget() override = default;
 
     void setList(const StringList& list);
+    void setList(StringList&& list);
     bool wantsFocus() const override { return true; }
 
     string getToolTip(const Common::Point& pos) const override;
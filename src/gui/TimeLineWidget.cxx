@@ -27,6 +27,8 @@
 
 const int HANDLE_W = 3;
 const int HANDLE_H = 3; // size above/below the slider
+const int THUMB_ZOOM = 2; // horizontal zoom of the thumbnails (pixel aspect)
+const int THUMB_GAP = 2;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TimeLineWidget::TimeLineWidget(GuiObject* boss, const GUI::Font& font,
@@ -58,7 +60,9 @@ void TimeLineWidget::setValue(uInt32 value)
   {
     _value = value;
     setDirty();
-    sendCommand(_cmd, _value, _id);
+    // When scrubbing through thumbnails, the value is only applied on release
+    if(!(_isDragging && _thumbnails))
+      sendCommand(_cmd, _value, _id);
   }
 }
 
@@ -100,6 +104,16 @@ void TimeLineWidget::setStepValues(const IntArray& steps)
     _stepValue.push_back(0);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TimeLineWidget::setThumbnails(const ThumbnailProvider& provider,
+                                   uInt32 width, uInt32 height)
+{
+  _thumbnails = provider;
+  _thumbW = width;
+  _thumbH = height;
+  _stripH = thumbnailStripHeight(height);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TimeLineWidget::handleMouseMoved(int x, int y)
 {
@@ -142,32 +156,53 @@ void TimeLineWidget::handleMouseWheel(int x, int y, int direction)
 void TimeLineWidget::drawWidget(bool hilite)
 {
   FBSurface& s = _boss->dialog().surface();
+  // The slider is drawn below the thumbnails
+  const int y = _y + _stripH, h = _h - _stripH;
 
   // Draw the label, if any
   if(_labelWidth > 0)
-    s.drawString(_font, _label, _x, _y + 2, _labelWidth,
+    s.drawString(_font, _label, _x, y + 2, _labelWidth,
                  isEnabled() ? kTextColor : kColor, TextAlign::Left);
 
-  // Frame the handle
   const int HANDLE_W2 = (HANDLE_W + 1) / 2;
   int p = valueToPos(_value),
     x = _x + _labelWidth + HANDLE_W2,
     w = _w - _labelWidth - HANDLE_W;
-  s.hLine(x + p - HANDLE_W2, _y + 0, x + p - HANDLE_W2 + HANDLE_W, kColorInfo);
-  s.vLine(x + p - HANDLE_W2, _y + 1, _y + _h - 2, kColorInfo);
-  s.hLine(x + p - HANDLE_W2 + 1, _y + _h - 1, x + p - HANDLE_W2 + 1 + HANDLE_W, kBGColor);
-  s.vLine(x + p - HANDLE_W2 + 1 + HANDLE_W, _y + 1, _y + _h - 2, kBGColor);
+
+  // Draw the filmstrip; each thumbnail shows the state closest to its
+  // center, except for the one at the handle, which shows the value itself
+  if(_thumbnails)
+  {
+    const int tw = _thumbW * THUMB_ZOOM + 2;
+    const int numThumbs = std::max(1, (w + THUMB_GAP) / (tw + THUMB_GAP));
+
+    for(int i = 0; i < numThumbs; ++i)
+    {
+      const int tx = i * (tw + THUMB_GAP);
+      const bool selected = p >= tx && (p < tx + tw + THUMB_GAP || i == numThumbs - 1);
+      const uInt32 value = selected ? _value
+        : posToValue(std::min<uInt32>(tx + tw / 2, _stepValue.back()));
+
+      drawThumbnail(s, value, x + tx, _y + 1, selected);
+    }
+  }
+
+  // Frame the handle
+  s.hLine(x + p - HANDLE_W2, y + 0, x + p - HANDLE_W2 + HANDLE_W, kColorInfo);
+  s.vLine(x + p - HANDLE_W2, y + 1, y + h - 2, kColorInfo);
+  s.hLine(x + p - HANDLE_W2 + 1, y + h - 1, x + p - HANDLE_W2 + 1 + HANDLE_W, kBGColor);
+  s.vLine(x + p - HANDLE_W2 + 1 + HANDLE_W, y + 1, y + h - 2, kBGColor);
   // Frame the box
-  s.hLine(x, _y + HANDLE_H, x + w - 2, kColorInfo);
-  s.vLine(x, _y + HANDLE_H, _y + _h - 2 - HANDLE_H, kColorInfo);
-  s.hLine(x + 1, _y + _h - 1 - HANDLE_H, x + w - 1, kBGColor);
-  s.vLine(x + w - 1, _y + 1 + HANDLE_H, _y + _h - 2 - HANDLE_H, kBGColor);
+  s.hLine(x, y + HANDLE_H, x + w - 2, kColorInfo);
+  s.vLine(x, y + HANDLE_H, y + h - 2 - HANDLE_H, kColorInfo);
+  s.hLine(x + 1, y + h - 1 - HANDLE_H, x + w - 1, kBGColor);
+  s.vLine(x + w - 1, y + 1 + HANDLE_H, y + h - 2 - HANDLE_H, kBGColor);
 
   // Fill the box
-  s.fillRect(x + 1, _y + 1 + HANDLE_H, w - 2, _h - 2 - HANDLE_H * 2,
+  s.fillRect(x + 1, y + 1 + HANDLE_H, w - 2, h - 2 - HANDLE_H * 2,
              !isEnabled() ? kSliderBGColorLo : hilite ? kSliderBGColorHi : kSliderBGColor);
   // Draw the 'bar'
-  s.fillRect(x + 1, _y + 1 + HANDLE_H, p, _h - 2 - HANDLE_H * 2,
+  s.fillRect(x + 1, y + 1 + HANDLE_H, p, h - 2 - HANDLE_H * 2,
              !isEnabled() ? kColor : hilite ? kSliderColorHi : kSliderColor);
 
   // Add 4 tickmarks for 5 intervals
@@ -194,11 +229,11 @@ void TimeLineWidget::drawWidget(bool hilite)
         else
           color = kSliderBGColorLo;
       }
-      s.vLine(xt, _y + _h / 2, _y + _h - 2 - HANDLE_H, color);
+      s.vLine(xt, y + h / 2, y + h - 2 - HANDLE_H, color);
     }
   }
   // Draw the handle
-  s.fillRect(x + p + 1 - HANDLE_W2, _y + 1, HANDLE_W, _h - 2,
+  s.fillRect(x + p + 1 - HANDLE_W2, y + 1, HANDLE_W, h - 2,
              !isEnabled() ? kColor : hilite ? kSliderColorHi : kSliderColor);
 }
 
@@ -211,11 +246,37 @@ uInt32 TimeLineWidget::valueToPos(uInt32 value) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 TimeLineWidget::posToValue(uInt32 pos) const
 {
-  // Find the interval in which 'pos' falls, and then the endpoint which
-  // it is closest to
-  for(uInt32 i = 0; i < _stepValue.size() - 1; ++i)
-    if(pos >= _stepValue[i] && pos <= _stepValue[i+1])
-      return (_stepValue[i+1] - pos) < (pos - _stepValue[i]) ? i+1 : i;
+  // Find the interval in which 'pos' falls (the steps are sorted by their
+  // cycles), and then the endpoint which it is closest to
+  const auto it = std::lower_bound(_stepValue.begin() + 1, _stepValue.end(), pos);
+  if(it == _stepValue.end() || pos < *(it - 1))
+    return _valueMax;
+
+  const uInt32 i = uInt32(it - _stepValue.begin()) - 1;
+  return (_stepValue[i+1] - pos) < (pos - _stepValue[i]) ? i+1 : i;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TimeLineWidget::drawThumbnail(FBSurface& s, uInt32 value, int x, int y,
+                                   bool selected) const
+{
+  uInt32 height = 0;
+  const ByteArray& runs = _thumbnails(value, height);
+
+  s.frameRect(x, y, _thumbW * THUMB_ZOOM + 2, _thumbH + 2,
+              selected ? kColorInfo : kColor);
+  s.fillRect(x + 1, y + 1, _thumbW * THUMB_ZOOM, _thumbH, kBGColor);
 
-  return _valueMax;
+  // Crop the rows exceeding the height equally at the top and bottom
+  const uInt32 skip = height > _thumbH ? (height - _thumbH) / 2 : 0;
+  size_t i = 0;
+
+  for(uInt32 row = 0; row < height && row < skip + _thumbH; ++row)
+    for(uInt32 col = 0; col < _thumbW && i + 1 < runs.size(); i += 2)
+    {
+      if(row >= skip)
+        s.fillRect(x + 1 + col * THUMB_ZOOM, y + 1 + row - skip,
+                   runs[i] * THUMB_ZOOM, 1, ColorId(runs[i + 1]));
+      col += runs[i];
+    }
 }
@@ -18,6 +18,10 @@
 #ifndef TIMELINE_WIDGET_HXX
 #define TIMELINE_WIDGET_HXX
 
+class FBSurface;
+
+#include <functional>
+
 #include "Widget.hxx"
 
 class TimeLineWidget : public ButtonWidget
@@ -41,6 +45,25 @@ class TimeLineWidget : public ButtonWidget
     */
     void setStepValues(const IntArray& steps);
 
+    /**
+      Provides the thumbnail for a value, as rows of run-length encoded
+      (count, color) pairs (see RewindManager::getThumbnail()).
+    */
+    using ThumbnailProvider = std::function<const ByteArray&(uInt32 value, uInt32& height)>;
+
+    /**
+      Show a filmstrip of thumbnails above the timeline, which must be
+      included in the widget's height (see thumbnailStripHeight()).  While
+      the handle is dragged, only the thumbnails are updated; the command
+      is sent when it is released.
+
+      @param provider  Provides the thumbnails
+      @param width     The width of a thumbnail in pixels
+      @param height    The height shown of a thumbnail
+    */
+    void setThumbnails(const ThumbnailProvider& provider, uInt32 width, uInt32 height);
+    static uInt32 thumbnailStripHeight(uInt32 height) { return height + 4; }
+
   protected:
     void handleMouseMoved(int x, int y) override;
     void handleMouseDown(int x, int y, MouseButton b, int clickCount) override;
@@ -52,6 +75,8 @@ class TimeLineWidget : public ButtonWidget
     uInt32 valueToPos(uInt32 value) const;
     uInt32 posToValue(uInt32 pos) const;
 
+    void drawThumbnail(FBSurface& s, uInt32 value, int x, int y, bool selected) const;
+
   protected:
     uInt32  _value{0};
     uInt32  _valueMin{0}, _valueMax{0};
@@ -60,6 +85,10 @@ class TimeLineWidget : public ButtonWidget
 
     uIntArray _stepValue;
 
+    ThumbnailProvider _thumbnails;
+    uInt32  _thumbW{0}, _thumbH{0};
+    uInt32  _stripH{0};
+
   private:
     // Following constructors and assignment operators not supported
     TimeLineWidget() = delete;
@@ -209,19 +209,22 @@ TimeMachineDialog::TimeMachineDialog(OSystem& osystem, DialogContainer& parent,
   const int buttonWidth = BUTTON_W + 10,
             buttonHeight = BUTTON_H + 10,
             rowHeight = font.getLineHeight();
+  // Thumbnails cover about 200 scanlines
+  const uInt32 thumbHeight = 200 / RewindManager::THUMBNAIL_SCALE,
+               stripHeight = TimeLineWidget::thumbnailStripHeight(thumbHeight);
 
   int xpos, ypos;
 
   // Set real dimensions
   _w = width;  // Parent determines our width (based on window size)
-  _h = V_BORDER * 2 + rowHeight + std::max(buttonHeight + 2, rowHeight);
+  _h = V_BORDER * 2 + stripHeight + rowHeight + std::max(buttonHeight + 2, rowHeight);
 
   this->clearFlags(Widget::FLAG_CLEARBG); // does only work combined with blending (0..100)!
   this->clearFlags(Widget::FLAG_BORDER);
   this->setFlags(Widget::FLAG_NOBG);
 
   xpos = H_BORDER;
-  ypos = V_BORDER;
+  ypos = V_BORDER + stripHeight;
 
   // Add index info
   myCurrentIdxWidget = new StaticTextWidget(this, font, xpos, ypos, "1000", TextAlign::Left, kBGColor);
@@ -237,8 +240,12 @@ TimeMachineDialog::TimeMachineDialog(OSystem& osystem, DialogContainer& parent,
     tl_x = xpos + myCurrentIdxWidget->getWidth() + 8,
     tl_y = ypos + (myCurrentIdxWidget->getHeight() - tl_h) / 2 - 1,
     tl_w = myLastIdxWidget->getAbsX() - tl_x - 8;
-  myTimeline = new TimeLineWidget(this, font, tl_x, tl_y, tl_w, tl_h, "", 0, kTimeline);
+  myTimeline = new TimeLineWidget(this, font, tl_x, tl_y - stripHeight, tl_w,
+                                  tl_h + stripHeight, "", 0, kTimeline);
   myTimeline->setMinValue(0);
+  myTimeline->setThumbnails([this](uInt32 value, uInt32& height) -> const ByteArray& {
+      return instance().state().rewindManager().getThumbnail(value, height);
+    }, RewindManager::THUMBNAIL_W, thumbHeight);
   ypos += rowHeight;
 
   // Add time info
@@ -550,6 +557,15 @@ void TimeMachineDialog::handleWinds(Int32 numWinds)
   // Update index
   myCurrentIdxWidget->setValue(r.getCurrentIdx());
   myLastIdxWidget->setValue(r.getLastIdx());
+  // Update memory usage
+  ostringstream memory;
+  memory << std::fixed << std::setprecision(1)
+         << "Memory used: " << r.getMemoryUsed() / 1048576.0 << " MB";
+  if(r.getMemoryBudget() != 0)
+    memory << " of " << (r.getMemoryBudget() >> 20) << " MB";
+  if(r.isArchiving())
+    memory << "\nArchived: " << r.getArchiveSize() / 1048576.0 << " MB";
+  myTimeline->setToolTip(memory.str());
   // Enable/disable buttons
   myRewindAllWidget->setEnabled(!r.atFirst());
   myRewind1Widget->setEnabled(!r.atFirst());
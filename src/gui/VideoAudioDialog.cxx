@@ -493,6 +493,7 @@ void VideoAudioDialog::addAudioTab()
   VarList::push_back(items, "Low", static_cast<int>(AudioSettings::ResamplingQuality::nearestNeightbour));
   VarList::push_back(items, "High", static_cast<int>(AudioSettings::ResamplingQuality::lanczos_2));
   VarList::push_back(items, "Ultra", static_cast<int>(AudioSettings::ResamplingQuality::lanczos_3));
+  VarList::push_back(items, "Band-limited", static_cast<int>(AudioSettings::ResamplingQuality::blep));
   myResamplingPopup = new PopUpWidget(myTab, _font, xpos, ypos,
                                       pwidth, lineHeight,
                                       items, "Resampling quality ", lwidth);
@@ -28,6 +28,7 @@ MODULE_OBJS := \
 	src/gui/JoystickDialog.o \
 	src/gui/LauncherDialog.o \
 	src/gui/Launcher.o \
+	src/gui/LibraryIndex.o \
 	src/gui/ListWidget.o \
 	src/gui/LoggerDialog.o \
 	src/gui/Menu.o \
@@ -35,6 +36,7 @@ MODULE_OBJS := \
 	src/gui/MessageDialog.o \
 	src/gui/MessageMenu.o \
 	src/gui/MinUICommandDialog.o\
+	src/gui/NameIndex.o \
 	src/gui/OptionsDialog.o \
 	src/gui/PopUpWidget.o \
 	src/gui/ProgressDialog.o \
@@ -43,6 +45,7 @@ MODULE_OBJS := \
 	src/gui/RadioButtonWidget.o \
 	src/gui/RomAuditDialog.o \
 	src/gui/RomInfoWidget.o \
+	src/gui/RomPrefetcher.o \
 	src/gui/ScrollBarWidget.o \
 	src/gui/SnapshotDialog.o \
 	src/gui/StellaSettingsDialog.o \
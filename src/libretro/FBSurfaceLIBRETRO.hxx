@@ -59,6 +59,18 @@ class FBSurfaceLIBRETRO : public FBSurface
     void resize(uInt32 width, uInt32 height) override { }
     void setScalingInterpolation(ScalingInterpolation) override { }
 
+    /**
+      Render into an external buffer (e.g. frontend video memory) instead of
+      the surface's own pixel data, until reset by passing nullptr.
+
+      @param pixels  The external buffer (or nullptr for the own buffer)
+      @param pitch   The pitch of the external buffer, in pixels
+    */
+    void setPixelBuffer(uInt32* pixels, uInt32 pitch) {
+      myPixels = pixels ? pixels : myPixelData.get();
+      myPitch = pixels ? pitch : myWidth;
+    }
+
   protected:
     void applyAttributes() override { }
 
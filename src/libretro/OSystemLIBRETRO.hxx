@@ -55,6 +55,8 @@ class OSystemLIBRETRO : public OSystem
 
     shared_ptr<CompositeKeyValueRepositoryAtomic> getHighscoreRepository() override;
 
+    shared_ptr<KeyValueRepositoryAtomic> getRomCacheRepository() override;
+
   protected:
 
     void initPersistence(FilesystemNode& basedir) override;
@@ -78,40 +78,35 @@ void SoundLIBRETRO::close()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void SoundLIBRETRO::dequeue(Int16* stream, uInt32* samples)
+void SoundLIBRETRO::dequeue(Int16* stream, uInt32* samples, uInt32 maxSamples)
 {
-  uInt32 outIndex = 0;
+  const uInt32 fragmentSize = myAudioQueue->fragmentSize();
+  const bool isStereo = myAudioQueue->isStereo();
+  uInt32 outSamples = 0;
 
-  while (myAudioQueue->size())
+  while (myAudioQueue->size() && outSamples + fragmentSize <= maxSamples)
   {
     Int16* nextFragment = myAudioQueue->dequeue(myCurrentFragment);
 
     if (!nextFragment)
-    {
-      *samples = outIndex / 2;
-      return;
-    }
+      break;
 
     myCurrentFragment = nextFragment;
 
-    for (uInt32 i = 0; i < myAudioQueue->fragmentSize(); ++i)
-    {
-      Int16 sampleL, sampleR;
-
-      if (myAudioQueue->isStereo())
+    Int16* out = stream + outSamples * 2;
+    if (isStereo)
+      std::copy_n(myCurrentFragment, fragmentSize * 2, out);
+    else
+      for (uInt32 i = 0; i < fragmentSize; ++i)
       {
-        sampleL = static_cast<Int16>(myCurrentFragment[2*i + 0]);
-        sampleR = static_cast<Int16>(myCurrentFragment[2*i + 1]);
+        *out++ = myCurrentFragment[i];
+        *out++ = myCurrentFragment[i];
       }
-      else
-        sampleL = sampleR = static_cast<Int16>(myCurrentFragment[i]);
 
-      stream[outIndex++] = sampleL;
-      stream[outIndex++] = sampleR;
-    }
+    outSamples += fragmentSize;
   }
 
-  *samples = outIndex / 2;
+  *samples = outSamples;
 }
 
 #endif  // SOUND_SUPPORT
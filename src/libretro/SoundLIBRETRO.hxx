@@ -58,12 +58,14 @@ class SoundLIBRETRO : public Sound
     void close() override;
 
     /**
-      Empties the playback buffer.
+      Empties the playback buffer, as far as the output buffer allows.
+      Fragments which don't fit stay queued.
 
-      @param stream   Output audio buffer
-      @param samples  Number of audio samples read
+      @param stream      Output audio buffer (interleaved stereo)
+      @param samples     Number of (stereo) audio samples read
+      @param maxSamples  Size of the output buffer in stereo samples
     */
-    void dequeue(Int16* stream, uInt32* samples);
+    void dequeue(Int16* stream, uInt32* samples, uInt32 maxSamples);
 
   protected:
     //////////////////////////////////////////////////////////////////////
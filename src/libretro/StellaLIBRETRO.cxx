@@ -15,6 +15,8 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <cmath>
+
 #include "bspf.hxx"
 #include "StellaLIBRETRO.hxx"
 #include "SoundLIBRETRO.hxx"
@@ -28,11 +30,11 @@
 #include "Switches.hxx"
 #include "TIA.hxx"
 #include "TIASurface.hxx"
+#include "TimerManager.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 StellaLIBRETRO::StellaLIBRETRO()
-  : rom_image{make_unique<uInt8[]>(getROMMax())},
-    audio_buffer{make_unique<Int16[]>(audio_buffer_max)}
+  : rom_image{make_unique<uInt8[]>(getROMMax())}
 {
 }
 
@@ -109,6 +111,30 @@ bool StellaLIBRETRO::create(bool logging)
   video_ready = false;
   audio_samples = 0;
 
+  // The samples are passed to the frontend at the native TIA rate, so the
+  // buffer size only depends on the console timing
+  const uInt32 size = uInt32(std::ceil(getAudioRate() / (getConsoleNTSC() ? 60 : 50)))
+      * AUDIO_BUFFER_FRAMES;
+  if(size != audio_buffer_size)
+  {
+    audio_buffer = make_unique<Int16[]>(size * 2);
+    audio_buffer_size = size;
+  }
+
+  // Frontends (netplay, run-ahead) expect a constant state size, and query
+  // it often; so determine an upper bound once per cart
+  state_size = 0;
+  {
+    Serializer state;
+
+    if(myOSystem->state().saveState(state))
+    {
+      // Leave some headroom for states which grow while running
+      state_size = state.size() + state.size() / 4;
+      state_size = (state_size + STATE_SIZE_ALIGN - 1) & ~(STATE_SIZE_ALIGN - 1);
+    }
+  }
+
   system_ready = true;
   return true;
 }
@@ -120,6 +146,7 @@ void StellaLIBRETRO::destroy()
 
   video_ready = false;
   audio_samples = 0;
+  state_size = 0;
 
   myOSystem.reset();
 }
@@ -127,10 +154,6 @@ void StellaLIBRETRO::destroy()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StellaLIBRETRO::runFrame()
 {
-  // write ram updates
-  for(int lcv = 0; lcv <= 127; lcv++)
-    myOSystem->console().system().m6532().poke(lcv | 0x80, system_ram[lcv]);
-
   // poll input right at vsync
   updateInput();
 
@@ -140,8 +163,8 @@ void StellaLIBRETRO::runFrame()
   // drain generated audio
   updateAudio();
 
-  // refresh ram copy
-  memcpy(system_ram, myOSystem->console().system().m6532().getRAM(), 128);
+  // fire expired timers
+  myOSystem->timer().update();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -168,60 +191,84 @@ void StellaLIBRETRO::updateVideo()
   }
 
   video_ready = tia.newFramePending();
+  video_direct = false;
 
   if (video_ready)
   {
     FrameBuffer& frame = myOSystem->frameBuffer();
 
     tia.renderToFrameBuffer();
-    frame.updateInEmulationMode(0);
+
+    // The frontend expects a complete frame every time, and the target
+    // buffer may change, so even identical frames are rendered
+    frame.tiaSurface().invalidateFrame();
+
+    // Render straight into the frontend's framebuffer if its geometry
+    // matches the frame exactly, saving a full frame copy
+    if(video_target && video_target_width == getVideoWidth() &&
+       video_target_height == getVideoHeight())
+    {
+      FBSurfaceLIBRETRO& surface = static_cast<FBSurfaceLIBRETRO&>(
+          frame.tiaSurface().tiaSurface());
+
+      surface.setPixelBuffer(video_target, uInt32(video_target_pitch >> 2));
+      frame.updateInEmulationMode(0);
+      surface.setPixelBuffer(nullptr, 0);
+
+      video_direct = true;
+    }
+    else
+      frame.updateInEmulationMode(0);
   }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StellaLIBRETRO::updateAudio()
 {
-  static_cast<SoundLIBRETRO&>(myOSystem->sound()).dequeue(audio_buffer.get(), &audio_samples);
+  static_cast<SoundLIBRETRO&>(myOSystem->sound()).dequeue(audio_buffer.get(), &audio_samples, audio_buffer_size);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool StellaLIBRETRO::loadState(const void* data, size_t size)
 {
-  Serializer state;
-
-  state.putByteArray(reinterpret_cast<const uInt8*>(data), static_cast<uInt32>(size));
-
-  if(!myOSystem->state().loadState(state))
-    return false;
+  Serializer state(static_cast<const uInt8*>(data), size);
 
-  memcpy(system_ram, myOSystem->console().system().m6532().getRAM(), 128);
-  return true;
+  return myOSystem->state().loadState(state);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool StellaLIBRETRO::saveState(void* data, size_t size) const
 {
-  Serializer state;
-
-  if (!myOSystem->state().saveState(state))
-    return false;
+  // Serialize directly into the frontend's buffer; this fails if the
+  // buffer is too small
+  Serializer state(static_cast<uInt8*>(data), size);
 
-  if (state.size() > size)
+  if(!myOSystem->state().saveState(state))
     return false;
 
-  state.getByteArray(reinterpret_cast<uInt8*>(data), static_cast<uInt32>(state.size()));
+  // Clear the unused rest of the buffer, so identical machine states
+  // always result in identical data (netplay compares checksums)
+  std::fill_n(static_cast<uInt8*>(data) + state.size(), size - state.size(), 0);
   return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-size_t StellaLIBRETRO::getStateSize() const
+uInt8* StellaLIBRETRO::getRAM() const
 {
-  Serializer state;
+  if(!myOSystem || !myOSystem->hasConsole())
+    return nullptr;
+
+  return myOSystem->console().system().m6532().getRAM();
+}
 
-  if (!myOSystem->state().saveState(state))
-    return 0;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8* StellaLIBRETRO::getCartRAM(size_t& size) const
+{
+  size = 0;
+  if(!myOSystem || !myOSystem->hasConsole())
+    return nullptr;
 
-  return state.size();
+  return myOSystem->console().cartridge().getRAM(size);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -281,6 +328,9 @@ float StellaLIBRETRO::getVideoAspect() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void* StellaLIBRETRO::getVideoBuffer() const
 {
+  if(video_direct)
+    return video_target;
+
   if (!render_surface)
   {
     const FBSurface& surface =
@@ -293,6 +343,20 @@ void* StellaLIBRETRO::getVideoBuffer() const
   return render_surface;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StellaLIBRETRO::setVideoTarget(void* data, uInt32 width, uInt32 height,
+                                    size_t pitch)
+{
+  // The buffer is only valid during the current retro_run() call, so it
+  // must be set (or cleared) before each runFrame()
+  video_target = (pitch & 3) == 0 && pitch >= width * 4
+      ? static_cast<uInt32*>(data) : nullptr;
+  video_target_width = width;
+  video_target_height = height;
+  video_target_pitch = pitch;
+  video_direct = false;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool StellaLIBRETRO::getVideoNTSC() const
 {
@@ -62,10 +62,13 @@ class StellaLIBRETRO
     uInt32 getROMSize() const { return rom_size; }
     constexpr uInt32 getROMMax() const { return Cartridge::maxSize(); }
 
-    uInt8* getRAM() { return system_ram; }
+    // Direct access to the live RIOT and cart RAM; writes take effect
+    // immediately, so no per-frame synchronization is needed
+    uInt8* getRAM() const;
     constexpr uInt32 getRAMSize() const { return 128; }
+    uInt8* getCartRAM(size_t& size) const;
 
-    size_t getStateSize() const;
+    size_t getStateSize() const { return state_size; }
 
     bool   getConsoleNTSC() const { return console_timing == ConsoleTiming::ntsc; }
 
@@ -81,13 +84,16 @@ class StellaLIBRETRO
     bool   getVideoResize();
 
     void*  getVideoBuffer() const;
+    void   setVideoTarget(void* data, uInt32 width, uInt32 height, size_t pitch);
     uInt32 getVideoWidth() const {
       return getVideoZoom() == 1 ? myOSystem->console().tia().width() : getVideoWidthMax();
     }
     uInt32 getVideoHeight() const {
       return myOSystem->console().tia().height();
     }
-    constexpr uInt32 getVideoPitch() const { return getVideoWidthMax() * 4; }
+    size_t getVideoPitch() const {
+      return video_direct ? video_target_pitch : getVideoWidthMax() * 4;
+    }
 
     constexpr uInt32 getVideoWidthMax() const  { return AtariNTSC::outWidth(160); }
     constexpr uInt32 getVideoHeightMax() const { return 312; }
@@ -168,13 +174,25 @@ class StellaLIBRETRO
 
     bool video_ready{false};
 
+    // Frontend framebuffer offered for the next frame (see setVideoTarget),
+    // and whether the last frame was rendered into it
+    uInt32* video_target{nullptr};
+    uInt32 video_target_width{0}, video_target_height{0};
+    size_t video_target_pitch{0};
+    bool video_direct{false};
+
+    // Interleaved stereo samples of the current frame
     unique_ptr<Int16[]> audio_buffer;
+    uInt32 audio_buffer_size{0};  // in stereo samples
     uInt32 audio_samples{0};
 
-    uInt8 system_ram[128];
+    // Upper bound of the state size for the current cart
+    size_t state_size{0};
+    static constexpr size_t STATE_SIZE_ALIGN = 1024;
 
-    // (31440 rate / 50 Hz) * 16-bit stereo * 1.25x padding
-    static constexpr uInt32 audio_buffer_max = (31440 / 50 * 4 * 5) / 4;
+    // Audio buffer size in frames; samples which don't fit stay queued for
+    // the next frame
+    static constexpr uInt32 AUDIO_BUFFER_FRAMES = 2;
 
   private:
     string video_palette{PaletteHandler::SETTING_STANDARD};
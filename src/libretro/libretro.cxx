@@ -391,6 +391,64 @@ static void update_variables(bool init = false)
 #undef RETRO_GET
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static void update_video_target()
+{
+  struct retro_framebuffer fb = { };
+
+  // Frames with cropped overscan are passed at an offset into the core's
+  // buffer, which the frontend's framebuffer does not allow
+  if(!crop_left)
+  {
+    fb.width = stella.getVideoWidth();
+    fb.height = stella.getVideoHeight();
+    fb.access_flags = RETRO_MEMORY_ACCESS_WRITE | RETRO_MEMORY_ACCESS_READ;
+
+    // The renderers read back the frame, which is slow for uncached memory
+    if(environ_cb(RETRO_ENVIRONMENT_GET_CURRENT_SOFTWARE_FRAMEBUFFER, &fb) &&
+       fb.format == RETRO_PIXEL_FORMAT_XRGB8888 &&
+       (fb.memory_flags & RETRO_MEMORY_TYPE_CACHED))
+    {
+      stella.setVideoTarget(fb.data, fb.width, fb.height, fb.pitch);
+      return;
+    }
+  }
+
+  stella.setVideoTarget(nullptr, 0, 0, 0);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static void update_memory_maps()
+{
+  // The frontend accesses the live RIOT RAM and the extended cart RAM (if
+  // any) directly; the latter is mapped into the cart address space at
+  // $1000, independent of the cart's actual read and write ports
+  static struct retro_memory_descriptor descs[2];
+  static struct retro_memory_map mmaps;
+  unsigned count = 0;
+
+  descs[count] = { };
+  descs[count].ptr = stella.getRAM();
+  descs[count].start = 0x0080;
+  descs[count].len = stella.getRAMSize();
+  ++count;
+
+  size_t cartRamSize = 0;
+  uInt8* cartRam = stella.getCartRAM(cartRamSize);
+  if(cartRam && cartRamSize)
+  {
+    descs[count] = { };
+    descs[count].ptr = cartRam;
+    descs[count].start = 0x1000;
+    descs[count].len = cartRamSize;
+    ++count;
+  }
+
+  mmaps.descriptors = descs;
+  mmaps.num_descriptors = count;
+  environ_cb(RETRO_ENVIRONMENT_SET_MEMORY_MAPS, &mmaps);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 static bool reset_system()
 {
@@ -410,6 +468,9 @@ static bool reset_system()
 
   system_reset = false;
 
+  // the RAM is owned by the new console, publish its location
+  update_memory_maps();
+
   // reset libretro window, apply post-boot settings
   update_variables(false);
 
@@ -623,6 +684,7 @@ void retro_run()
 
   update_input();
 
+  update_video_target();
 
   stella.runFrame();
 
@@ -696,7 +758,7 @@ size_t retro_get_memory_size(unsigned id)
   switch (id)
   {
     case RETRO_MEMORY_SYSTEM_RAM:
-      return stella.getRAMSize();
+      return stella.getRAM() ? stella.getRAMSize() : 0;
 
     default:
       return 0;
@@ -170,19 +170,26 @@ sub num_prop_types {
   return keys( %prop_type );
 }
 
-# Convert a properties set into a C++ compatible string
-sub build_prop_string {
+# Get the values of a properties set, with defaults replaced by empty strings
+sub build_prop_values {
   my @array = @_;
-  my $result = "  { ";
   my @items = ();
   for (my $i = 0; $i < @array; $i++) {
     if($prop_defaults[$i] ne $array[$i]) {
-      push(@items, "\"$array[$i]\"");
+      push(@items, $array[$i]);
     } else {
-      push(@items, "\"\"");
+      push(@items, "");
     }
   }
 
+  return @items;
+}
+
+# Convert a properties set into a C++ compatible string
+sub build_prop_string {
+  my @items = map { "\"$_\"" } build_prop_values(@_);
+  my $result = "  { ";
+
   $result .= join(", ", @items);
   $result .= " }";
 
@@ -799,7 +799,7 @@ int gen_c_source(struct font* pf, char *path)
     "namespace GUI {\n"
     "\n"
     "// Font character bitmap data.\n"
-    "static const uInt16 %s_font_bits[] = {  // NOLINT : too complicated to convert\n"
+    "inline constexpr uInt16 %s_font_bits[] = {  // NOLINT : too complicated to convert\n"
   };
 
   ofp = fopen(path, "w");
@@ -902,7 +902,7 @@ int gen_c_source(struct font* pf, char *path)
   if (pf->offset) {
     /* output offset table*/
     fprintf(ofp, "/* Character->glyph mapping. */\n"
-        "static const uInt32 %s_sysfont_offset[] = {\n", fontname);
+        "inline constexpr uInt32 %s_sysfont_offset[] = {\n", fontname);
 
     for (i = 0; i < pf->size; ++i)
       fprintf(ofp, "  %ld,\t/* (0x%02x) */\n",
@@ -913,7 +913,7 @@ int gen_c_source(struct font* pf, char *path)
   /* output width table for proportional fonts*/
   if (pf->width) {
     fprintf(ofp, "/* Character width data. */\n"
-        "static const unsigned char %s_sysfont_width[] = {\n", fontname);
+        "inline constexpr uInt8 %s_sysfont_width[] = {\n", fontname);
 
     for (i = 0; i < pf->size; ++i)
       fprintf(ofp, "  %d,\t/* (0x%02x) */\n",
@@ -924,7 +924,7 @@ int gen_c_source(struct font* pf, char *path)
   /* output bbox table */
   if (pf->bbx) {
     fprintf(ofp, "/* Bounding box data. */\n"
-        "static const BBX %s_sysfont_bbx[] = {\n", fontname);
+        "inline constexpr BBX %s_sysfont_bbx[] = {\n", fontname);
 
     for (i = 0; i < pf->size; ++i)
       fprintf(ofp, "\t{ %d, %d, %d, %d },\t/* (0x%02x) */\n",
@@ -950,7 +950,7 @@ int gen_c_source(struct font* pf, char *path)
 
   fprintf(ofp,
       "/* Exported structure definition. */\n"
-      "static const FontDesc %sDesc = {\n"
+      "inline constexpr FontData %sData = {\n"
       "  \"%s\",\n"
       "  %d,\n"
       "  %d,\n"
@@ -964,7 +964,14 @@ int gen_c_source(struct font* pf, char *path)
       "  %s\n"
       "  %d,\n"
       "  sizeof(%s_font_bits)/sizeof(uInt16)\n"
-      "};\n",
+      "};\n"
+      "\n"
+      "// The compressed glyphs; the bitmaps above are only used at compile time\n"
+      "inline constexpr auto %s_font_glyphs =\n"
+      "  FontPacker::pack<FontPacker::size(%sData)>(%sData);\n"
+      "\n"
+      "inline constexpr FontDesc %sDesc =\n"
+      "  FontPacker::desc(%sData, %s_font_glyphs.data());\n",
       fontname,
       pf->name,
       pf->maxwidth, pf->height,
@@ -977,7 +984,9 @@ int gen_c_source(struct font* pf, char *path)
       buf,
       bbuf,
       pf->defaultchar,
-      fontname);
+      fontname,
+      fontname, fontname, fontname,
+      fontname, fontname, fontname);
 
   fprintf(ofp, "\n} // End of namespace GUI\n\n#endif\n");
   fclose(ofp);
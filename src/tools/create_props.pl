@@ -38,6 +38,40 @@ my $typesize = PropSet::num_prop_types();
 
 printf "Valid properties found: $setsize\n";
 
+# Collect the property values of each item in order of md5sum, storing
+# every distinct string only once (index 0 is always the empty string)
+my @strings = ( "" );
+my %stringidx = ( "" => 0 );
+my @keys = ();
+my @rows = ();
+for my $key ( sort { lc($a) cmp lc($b) } keys %propset )
+{
+  my $md5 = lc($key);
+  if ($md5 !~ /^[0-9a-f]{32}$/) {
+    die "Invalid md5 = \'$key\'\n";
+  }
+  if (@keys && $keys[-1] eq $md5) {
+    die "Duplicate md5 = \'$key\'\n";
+  }
+  push(@keys, $md5);
+
+  my @values = PropSet::build_prop_values(@{ $propset{$key} });
+  shift @values;  # the md5 itself is stored in binary form
+  my @row = ();
+  foreach my $value (@values) {
+    if (!defined $stringidx{$value}) {
+      $stringidx{$value} = @strings;
+      push(@strings, $value);
+    }
+    push(@row, $stringidx{$value});
+  }
+  push(@rows, [ @row ]);
+}
+my $numstrings = @strings;
+if ($numstrings > 65536) {
+  die "Too many distinct property values: $numstrings\n";
+}
+
 # Construct the output file in C++ format
 open(OUTFILE, ">$outfile");
 print OUTFILE "//============================================================================\n";
@@ -67,20 +101,64 @@ print OUTFILE "  should be made in stella.pro, and then this file should be\n";
 print OUTFILE "  regenerated and the application recompiled.\n";
 print OUTFILE "*/\n";
 print OUTFILE "\nstatic constexpr uInt32 DEF_PROPS_SIZE = " . $setsize . ";";
+print OUTFILE "\nstatic constexpr uInt32 DEF_PROPS_STRINGS = " . $numstrings . ";";
 print OUTFILE "\n\n";
-print OUTFILE "static const BSPF::array2D<const char*, DEF_PROPS_SIZE, " . $typesize . "> DefProps = {{\n";
+print OUTFILE "// An md5sum in binary form, most significant part first\n";
+print OUTFILE "struct DefPropsKey {\n";
+print OUTFILE "  uInt64 hi{0}, lo{0};\n";
+print OUTFILE "};\n";
+print OUTFILE "\n";
+print OUTFILE "// All distinct property values\n";
+print OUTFILE "static const std::array<const char*, DEF_PROPS_STRINGS> DefPropsStrings = {{\n";
+for (my $i = 0; $i < $numstrings; $i++) {
+  print OUTFILE "  \"$strings[$i]\"";
+  print OUTFILE "," if ($i+1 < $numstrings);
+  print OUTFILE "\n";
+}
+print OUTFILE "}};\n";
+print OUTFILE "\n";
+print OUTFILE "// The md5sums of all items, in sorted order\n";
+print OUTFILE "static constexpr std::array<DefPropsKey, DEF_PROPS_SIZE> DefPropsMD5 = {{\n";
+for (my $i = 0; $i < $setsize; $i++) {
+  print OUTFILE "  { 0x" . substr($keys[$i], 0, 16) . "ULL, 0x" . substr($keys[$i], 16) . "ULL }";
+  print OUTFILE "," if ($i+1 < $setsize);
+  print OUTFILE "\n";
+}
+print OUTFILE "}};\n";
+print OUTFILE "\n";
+print OUTFILE "// For each value of the first md5sum byte, the index of the first item\n";
+print OUTFILE "// starting with that (or a larger) value; the last entry is the item count\n";
+print OUTFILE "static constexpr std::array<uInt16, 257> DefPropsBucket = {{\n";
+my @bucket = ();
+my $item = 0;
+for (my $b = 0; $b < 256; $b++) {
+  while ($item < $setsize && hex(substr($keys[$item], 0, 2)) < $b) {
+    $item++;
+  }
+  push(@bucket, $item);
+}
+push(@bucket, $setsize);
+for (my $b = 0; $b < 257; $b += 16) {
+  my $end = $b + 15 < 256 ? $b + 15 : 256;
+  print OUTFILE "  " . join(", ", @bucket[$b .. $end]);
+  print OUTFILE "," if ($end < 256);
+  print OUTFILE "\n";
+}
+print OUTFILE "}};\n";
+print OUTFILE "\n";
+print OUTFILE "// The property values of all items (except the md5sum), as indices\n";
+print OUTFILE "// into DefPropsStrings\n";
+print OUTFILE "static constexpr BSPF::array2D<uInt16, DEF_PROPS_SIZE, " . ($typesize - 1) . "> DefProps = {{\n";
 
-# Walk the hash map and print each item in order of md5sum
-my $idx = 0;
-for my $key ( sort keys %propset )
+# Walk the items and print each row in order of md5sum
+for (my $i = 0; $i < $setsize; $i++)
 {
-  print OUTFILE PropSet::build_prop_string(@{ $propset{$key} });
+  print OUTFILE "  { " . join(", ", @{ $rows[$i] }) . " }";
 
-  if ($idx+1 < $setsize) {
+  if ($i+1 < $setsize) {
     print OUTFILE ",";
   }
   print OUTFILE "\n";
-  $idx++;
 }
 
 print OUTFILE "}};\n";
@@ -96,6 +96,39 @@ bool FilesystemNodePOSIX::hasParent() const
   return _path != "" && _path != ROOT_DIR;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FilesystemNodePOSIX::statEntry(DIR* dirp, const char* name,
+                                    bool& isDirectory, bool& isFile)
+{
+  // The entry is looked up relative to the open directory, so the kernel
+  // doesn't have to resolve the full path again for every entry.
+#if defined(__linux__) && defined(STATX_TYPE)
+  // Only the type is requested, and network file systems (NFS, CIFS) may
+  // answer from their attribute cache instead of asking the server.
+  struct statx stx;
+  if (statx(dirfd(dirp), name, AT_STATX_DONT_SYNC, STATX_TYPE, &stx) == 0)
+  {
+    isDirectory = S_ISDIR(stx.stx_mode);
+    isFile = S_ISREG(stx.stx_mode);
+    return true;
+  }
+  else if (errno != ENOSYS)  // kernels before 4.11 don't know statx
+  {
+    isDirectory = isFile = false;
+    return false;
+  }
+#endif
+  struct stat st;
+  if (fstatat(dirfd(dirp), name, &st, 0) == 0)
+  {
+    isDirectory = S_ISDIR(st.st_mode);
+    isFile = S_ISREG(st.st_mode);
+    return true;
+  }
+  isDirectory = isFile = false;
+  return false;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool FilesystemNodePOSIX::getChildren(AbstractFSList& myList, ListMode mode) const
 {
@@ -128,39 +161,32 @@ bool FilesystemNodePOSIX::getChildren(AbstractFSList& myList, ListMode mode) con
      * The d_type method is used to avoid costly recurrent stat() calls in big
      * directories.
      */
-    entry.setFlags();
+    entry._isValid = statEntry(dirp, dp->d_name, entry._isDirectory, entry._isFile);
 #else
     if (dp->d_type == DT_UNKNOWN)
     {
       // Fall back to stat()
-      entry.setFlags();
+      entry._isValid = statEntry(dirp, dp->d_name, entry._isDirectory, entry._isFile);
     }
     else
     {
       if (dp->d_type == DT_LNK)
       {
-        struct stat st;
-        if (stat(entry._path.c_str(), &st) == 0)
-        {
-          entry._isDirectory = S_ISDIR(st.st_mode);
-          entry._isFile = S_ISREG(st.st_mode);
-        }
-        else
-          entry._isDirectory = entry._isFile = false;
+        // Links are listed like their target
+        statEntry(dirp, dp->d_name, entry._isDirectory, entry._isFile);
       }
       else
       {
         entry._isDirectory = (dp->d_type == DT_DIR);
         entry._isFile = (dp->d_type == DT_REG);
       }
-
-      if (entry._isDirectory)
-        entry._path += "/";
-
       entry._isValid = true;
     }
 #endif
 
+    if (entry._isDirectory)
+      entry._path += "/";
+
     // Skip files that are invalid for some reason (e.g. because we couldn't
     // properly stat them).
     if (!entry._isValid)
@@ -201,6 +227,37 @@ bool FilesystemNodePOSIX::makeDir()
     return false;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FilesystemNodePOSIX::getFileInfo(uInt64& size, uInt64& mtime) const
+{
+  struct stat st;
+
+  if(stat(_path.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+    return false;
+
+  size  = static_cast<uInt64>(st.st_size);
+  mtime = static_cast<uInt64>(st.st_mtime);
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FilesystemNodePOSIX::getDirectoryStamp(uInt64& stamp) const
+{
+  struct stat st;
+
+  if(stat(_path.c_str(), &st) != 0 || !S_ISDIR(st.st_mode))
+    return false;
+
+#if defined(BSPF_MACOS)
+  const struct timespec& mtime = st.st_mtimespec;
+#else
+  const struct timespec& mtime = st.st_mtim;
+#endif
+  stamp = static_cast<uInt64>(mtime.tv_sec) * 1000000000 +
+          static_cast<uInt64>(mtime.tv_nsec);
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool FilesystemNodePOSIX::rename(const string& newfile)
 {
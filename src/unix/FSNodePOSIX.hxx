@@ -27,8 +27,10 @@
 #include <sys/param.h>
 #include <sys/stat.h>
 #include <dirent.h>
+#include <fcntl.h>
 
 #include <cassert>
+#include <cerrno>
 #include <cstdio>
 #include <cstring>
 #include <cstdlib>
@@ -70,6 +72,8 @@ class FilesystemNodePOSIX : public AbstractFSNode
     bool isFile() const override      { return _isFile;      }
     bool isReadable() const override  { return access(_path.c_str(), R_OK) == 0; }
     bool isWritable() const override  { return access(_path.c_str(), W_OK) == 0; }
+    bool getFileInfo(uInt64& size, uInt64& mtime) const override;
+    bool getDirectoryStamp(uInt64& stamp) const override;
     bool makeDir() override;
     bool rename(const string& newfile) override;
 
@@ -89,6 +93,15 @@ class FilesystemNodePOSIX : public AbstractFSNode
      * using the stat() function.
      */
     void setFlags();
+
+    /**
+     * Determines the type of the entry 'name' in the open directory 'dirp'
+     * (following links), for when readdir() doesn't tell.
+     *
+     * @return  False if the entry couldn't be examined
+     */
+    static bool statEntry(DIR* dirp, const char* name,
+                          bool& isDirectory, bool& isFile);
 };
 
 #endif
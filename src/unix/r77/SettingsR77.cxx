@@ -62,6 +62,7 @@ SettingsR77::SettingsR77()
   setPermanent("plr.timemachine", true);
   setPermanent("plr.tm.size", 60);
   setPermanent("plr.tm.uncompressed", 60);
+  setPermanent("plr.tm.memory", 8);
   setPermanent("plr.tm.interval", "1s");
 
   setPermanent("threads", "1");
@@ -67,6 +67,8 @@ class FilesystemNodeWINDOWS : public AbstractFSNode
     bool isFile() const override      { return _isFile;      }
     bool isReadable() const override;
     bool isWritable() const override;
+    bool getFileInfo(uInt64& size, uInt64& mtime) const override;
+    bool getDirectoryStamp(uInt64& stamp) const override;
     bool makeDir() override;
     bool rename(const string& newfile) override;
 